@@ -0,0 +1,343 @@
+/**
+ * @file asc_adcScan.c
+ *   Interrupt driven scan of a list of ADC channels. The results are accumulated into
+ * frames and a task is resumed only once per completed frame rather than once per
+ * conversion.\n
+ *   The ADC runs in auto trigger mode, either free running or triggered by a timer, see
+ * #ASC_ADC_TRIGGER_SOURCE. The interrupt "conversion complete" adds the result to the sum
+ * of its channel and programs the input multiplexer for the next channel of the list.
+ * After #ASC_NO_AVERAGED_SAMPLES rounds through the list, a frame is complete. There are
+ * two frames, which are used in turn: While the interrupt fills the one, the tasks read
+ * the other one. A completed frame is published by swapping the two and by posting an
+ * event. A reading task, which has been resumed by the event, can safely access the
+ * frame as long as the next frame has not been completed, i.e. for the time of
+ * #ASC_NO_AVERAGED_SAMPLES rounds through the scan list.\n
+ *   Prior to posting the event, the interrupt calls the hook asc_onFrameCompleteFromISR.
+ * The application can overload it to evaluate a completed frame still in the interrupt,
+ * e.g. to debounce buttons without resuming a task for each frame, see dbc_debounce.c.\n
+ *   The module is compiled only if #RTOS_USE_ADC_SCAN is set. The interrupt posts its
+ * event by rtos_sendEventFromISR, which needs to be enabled by
+ * #RTOS_USE_SEND_EVENT_FROM_ISR. All conversions but the last one of a frame are handled
+ * without involving the kernel at all.
+ *   @remark
+ * In free running mode, the next conversion is already running with the previous input
+ * when the interrupt changes the multiplexer. The configured input becomes effective with
+ * the next but one conversion. The module considers this. The very first result is
+ * discarded and from then on the multiplexer is always programmed one channel ahead.
+ *   @remark
+ * The module defines the interrupt service routine of the ADC, which must not be used by
+ * the application as an application interrupt, too. The interrupt can switch to another
+ * task. rtos_enterCriticalSection should inhibit it by resetting bit ADIE in register
+ * ADCSRA.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   asc_initAfterPowerUp
+ *   asc_startScan
+ *   asc_setChannel
+ *   asc_getFrame
+ *   asc_onFrameCompleteFromISR
+ *   ISR(ADC_vect)
+ * Local functions
+ *   selectAdcInput
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "asc_adcScan.h"
+
+#if RTOS_USE_ADC_SCAN == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR != RTOS_FEATURE_ON
+# error The ADC scan requires RTOS_USE_SEND_EVENT_FROM_ISR to be set to RTOS_FEATURE_ON
+#endif
+
+#if ASC_NO_AVERAGED_SAMPLES < 1  ||  ASC_NO_AVERAGED_SAMPLES > 64
+# error The number of averaged samples needs to be in the range 1..64
+#endif
+#if ASC_MAX_NO_CHANNELS < 1  ||  ASC_MAX_NO_CHANNELS > 16
+# error The maximum number of channels needs to be in the range 1..16
+#endif
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The list of scanned channels as values of MUX5:0. */
+static volatile uint8_t _channelAry[ASC_MAX_NO_CHANNELS];
+
+/** The number of channels in the scan list. */
+static uint8_t _noChannels = 0;
+
+/** The two frames, which are filled and read in turn. */
+static asc_frame_t _frameAry[2];
+
+/** The frame, which is being filled by the interrupt. */
+static asc_frame_t *_pFrameFill = &_frameAry[0];
+
+/** The latest completed frame, which can be read by the tasks. */
+static asc_frame_t * volatile _pFrameComplete = &_frameAry[1];
+
+/** The index into the scan list of the channel of the next result. */
+static uint8_t _idxChannelResult = 0;
+
+/** The index into the scan list of the channel, which is programmed into the
+    multiplexer. */
+static uint8_t _idxChannelMux = 0;
+
+/** The number of complete rounds through the scan list in the filled frame. */
+static uint8_t _noRounds = 0;
+
+/** In free running mode, the first result is discarded to get the multiplexer one
+    channel ahead. */
+static boolean _isFirstResult = true;
+
+/** The event, which is posted on completion of a frame. */
+static uintEventVec_t _evtFrameComplete = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Reprogram the ADC so that a coming conversion will use another input.
+ *   @param mux
+ * The input to select as ADC register value MUX5:0.
+ */
+
+static inline void selectAdcInput(uint8_t mux)
+{
+    /* Two registers contain bits of the register value MUX5:0, which selects the input.
+       Both are written in a read/modify/write operation as they also contain other
+       configuration information, which must not be changed. */
+    ADMUX  = (ADMUX  & ~0x1f) | (mux & 0x1f);
+#ifdef MUX5
+    ADCSRB = (ADCSRB & ~_BV(MUX5)) | ((mux & 0x20) >> (5-MUX5));
+#endif
+
+} /* End of selectAdcInput */
+
+
+
+
+/**
+ * Configure the ADC and the scan list. The conversions are started but the interrupt is
+ * not yet released; this is done by asc_startScan, when the kernel is running.
+ *   @param channelAry
+ * The list of channels to scan. Each channel is given as value of the ADC register
+ * MUX5:0. The same channel may appear several times in the list, e.g. to sample it at a
+ * higher rate. The list is copied.
+ *   @param noChannels
+ * The number of channels in \a channelAry, 1..#ASC_MAX_NO_CHANNELS.
+ *   @param evtFrameComplete
+ * The event, which is posted when a frame has been completed. It needs to be a normal,
+ * broadcasted event, neither a semaphore, nor a mutex, nor a timer event.
+ *   @remark
+ * The function must be called before the kernel is started, e.g. from setup().
+ */
+
+void asc_initAfterPowerUp( const uint8_t channelAry[]
+                         , uint8_t noChannels
+                         , uintEventVec_t evtFrameComplete
+                         )
+{
+    ASSERT(noChannels >= 1  &&  noChannels <= ASC_MAX_NO_CHANNELS);
+    ASSERT(evtFrameComplete != 0
+           &&  (evtFrameComplete & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+
+    uint8_t u;
+    for(u=0; u<noChannels; ++u)
+        _channelAry[u] = channelAry[u];
+    _noChannels = noChannels;
+    _evtFrameComplete = evtFrameComplete;
+
+    memset(&_frameAry[0], 0, sizeof(_frameAry));
+    _pFrameFill = &_frameAry[0];
+    _pFrameComplete = &_frameAry[1];
+    _idxChannelResult = 0;
+    _idxChannelMux = 0;
+    _noRounds = 0;
+    _isFirstResult = ASC_ADC_TRIGGER_SOURCE == 0;
+
+    /* ADMUX: Reference voltage, right aligned result, first channel. */
+    ADMUX = (ASC_ADC_REFS << REFS0);
+    ADCSRB = (ASC_ADC_TRIGGER_SOURCE << ADTS0);
+    selectAdcInput(_channelAry[0]);
+
+    /* ADCSRA: Turn the ADC on and start the series of auto triggered conversions. The
+       interrupt is still disabled. */
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | (ASC_ADC_PRESCALER << ADPS0);
+
+} /* End of asc_initAfterPowerUp */
+
+
+
+
+/**
+ * Release the interrupt of the ADC. The pending result of the running conversion is the
+ * first one, which is entered into a frame.
+ *   @remark
+ * The function must be called once, when the kernel has been started, e.g. at the
+ * beginning of the task, which processes the frames.
+ */
+
+void asc_startScan(void)
+{
+    cli();
+    {
+        /* Writing a one to ADIF resets a probably pending interrupt. */
+        ADCSRA |= _BV(ADIF) | _BV(ADIE);
+    }
+    sei();
+
+} /* End of asc_startScan */
+
+
+
+
+/**
+ * Replace a channel of the scan list. The new input is selected when the scan reaches
+ * the list position the next time. The frame, which is currently being filled, may
+ * contain some results of the former input.
+ *   @param idxChannel
+ * The position in the scan list.
+ *   @param mux
+ * The new input as value of the ADC register MUX5:0.
+ */
+
+void asc_setChannel(uint8_t idxChannel, uint8_t mux)
+{
+    ASSERT(idxChannel < _noChannels);
+
+    /* The interrupt reads the list without a critical section; a single byte is written
+       atomically. */
+    _channelAry[idxChannel] = mux;
+
+} /* End of asc_setChannel */
+
+
+
+
+/**
+ * Get the latest completed frame.
+ *   @return
+ * Get the pointer to the frame. The contents are valid until the next frame is
+ * completed. A task, which reads the frame after it has been resumed by the event, has
+ * the period of a complete frame to do so. The field noFrame can be compared before and
+ * after reading the sums to detect that the frame has been overwritten meanwhile.
+ */
+
+const asc_frame_t *asc_getFrame(void)
+{
+    return _pFrameComplete;
+
+} /* End of asc_getFrame */
+
+
+
+
+/**
+ * Hook, which is called by the interrupt on completion of a frame, before the event is
+ * posted to the tasks.\n
+ *   This is the default implementation, which does nothing. It can be overloaded by the
+ * application code to process the frame in the interrupt context.
+ *   @param pFrame
+ * The frame, which has just been completed and published.
+ *   @remark
+ * The function is called from the interrupt of the ADC. It needs to be short and it may
+ * only use the ISR variants of the kernel functions, like rtos_sendEventFromISR. The
+ * interrupt ends with rtos_leaveISR after the hook has returned.
+ */
+
+RTOS_DEFAULT_FCT void asc_onFrameCompleteFromISR(const asc_frame_t * /* pFrame */)
+{
+} /* End of asc_onFrameCompleteFromISR */
+
+
+
+
+/**
+ * The interrupt "conversion complete" of the ADC. It accumulates the result and programs
+ * the input for a coming conversion. On completion of a frame, the frames are swapped and
+ * the waiting tasks are resumed.
+ */
+
+ISR(ADC_vect)
+{
+    /* Read the result first; the register pair is locked until ADCH has been read. */
+    const uint16_t result = ADCW;
+
+    /* Program the input for the next (triggered) or next but one (free running)
+       conversion. */
+    if(++_idxChannelMux >= _noChannels)
+        _idxChannelMux = 0;
+    selectAdcInput(_channelAry[_idxChannelMux]);
+
+    if(_isFirstResult)
+    {
+        _isFirstResult = false;
+        return;
+    }
+
+    _pFrameFill->sumAry[_idxChannelResult] += result;
+    if(++_idxChannelResult >= _noChannels)
+    {
+        _idxChannelResult = 0;
+        if(++_noRounds >= ASC_NO_AVERAGED_SAMPLES)
+        {
+            /* Publish the frame and continue with the other one. */
+            _noRounds = 0;
+            asc_frame_t * const pFrameComplete = _pFrameFill;
+            _pFrameFill = _pFrameComplete;
+            pFrameComplete->noFrame = _pFrameFill->noFrame + 1;
+            _pFrameComplete = pFrameComplete;
+            memset(&_pFrameFill->sumAry[0], 0, sizeof(_pFrameFill->sumAry));
+
+            asc_onFrameCompleteFromISR(pFrameComplete);
+            rtos_sendEventFromISR(_evtFrameComplete);
+
+            /* If a task of higher priority has been resumed, then the kernel switches to
+               it now. */
+            rtos_leaveISR();
+        }
+    }
+} /* End of ISR(ADC_vect) */
+
+#endif /* RTOS_USE_ADC_SCAN == RTOS_FEATURE_ON */
@@ -0,0 +1,116 @@
+#ifndef ASC_ADC_SCAN_INCLUDED
+#define ASC_ADC_SCAN_INCLUDED
+/**
+ * @file asc_adcScan.h
+ * Definition of global interface of module asc_adcScan.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The maximum number of channels in the scan list. It determines the size of the frames.
+    The application may override the default in its rtos.config.h. */
+#ifndef ASC_MAX_NO_CHANNELS
+# define ASC_MAX_NO_CHANNELS    8
+#endif
+
+/** The number of conversion results per channel, which are accumulated in a frame. The
+    values 1..64 are possible; the sum of 64 10 Bit results still fits into 16 Bit. The
+    application may override the default in its rtos.config.h. */
+#ifndef ASC_NO_AVERAGED_SAMPLES
+# define ASC_NO_AVERAGED_SAMPLES    32
+#endif
+
+/** Value of ADC register ADMUX/REFS1:0, which selects the reference voltage. 1 means the
+    supply voltage AVcc. The application may override the default in its rtos.config.h. */
+#ifndef ASC_ADC_REFS
+# define ASC_ADC_REFS   1
+#endif
+
+/** Value of ADC register ADCSRB/ADTS2:0, which selects the trigger of the conversions. 0
+    means free running, the next conversion starts as soon as the previous one completes.
+    Other values select a hardware trigger, e.g. 4 for the overflow of timer 0. The
+    trigger is jitter free, unlike any software triggered conversion. The application may
+    override the default in its rtos.config.h. */
+#ifndef ASC_ADC_TRIGGER_SOURCE
+# define ASC_ADC_TRIGGER_SOURCE 0
+#endif
+
+/** Value of ADC register ADCSRA/ADPS2:0, the prescaler of the ADC clock. The ADC clock
+    must not exceed 200 kHz for full resolution; 7 divides the CPU clock by 128. A
+    conversion takes 13 ADC clock cycles. The application may override the default in its
+    rtos.config.h. */
+#ifndef ASC_ADC_PRESCALER
+# define ASC_ADC_PRESCALER  7
+#endif
+
+
+/*
+ * Global type definitions
+ */
+
+/** A frame of ADC results. It holds the sums of #ASC_NO_AVERAGED_SAMPLES results of each
+    channel of the scan list. */
+typedef struct asc_frame_t
+{
+    /** The sums of results per channel, in the order of the scan list. */
+    uint16_t sumAry[ASC_MAX_NO_CHANNELS];
+
+    /** The number of the frame. It is cyclically incremented with each completed frame. */
+    uint16_t noFrame;
+
+} asc_frame_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Configure the ADC and the list of scanned channels prior to the start of the kernel. */
+void asc_initAfterPowerUp( const uint8_t channelAry[]
+                         , uint8_t noChannels
+                         , uintEventVec_t evtFrameComplete
+                         );
+
+/** Release the interrupt of the ADC; the filling of frames begins. */
+void asc_startScan(void);
+
+/** Replace a channel of the scan list. */
+void asc_setChannel(uint8_t idxChannel, uint8_t mux);
+
+/** Get the latest completed frame. */
+const asc_frame_t *asc_getFrame(void);
+
+/** Hook, which is called by the interrupt on completion of a frame. */
+void asc_onFrameCompleteFromISR(const asc_frame_t *pFrame);
+
+
+#endif  /* ASC_ADC_SCAN_INCLUDED */
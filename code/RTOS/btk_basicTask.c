@@ -0,0 +1,130 @@
+/**
+ * @file btk_basicTask.c
+ *   Run-to-completion basic tasks, which share a single stack. A normal RTuinOS task needs
+ * its own stack area, which is sized for the worst case. Many tasks are however simple
+ * event handlers, which never suspend in the middle of their work. Such handlers can be
+ * implemented as basic tasks: a function, which is called when one of its trigger events
+ * is posted and which returns when its job is done.\n
+ *   A set of basic tasks is hosted by an ordinary RTuinOS task. Its task function consists
+ * of a single call of btk_runBasicTasks, which never returns. The host waits for the
+ * union of the trigger events of all its basic tasks and calls the functions of those
+ * basic tasks, which are triggered by the posted events. All of them run on the stack of
+ * the host, whose size needs to fit only the most demanding basic task.\n
+ *   The host task is scheduled like any other task. Its priority is the priority of all
+ * its basic tasks. A basic task is preempted by tasks of higher priority but never by
+ * another basic task of the same host. If several basic tasks are triggered at a time,
+ * they are called in the order of the table; this is their priority among each other.
+ * An application can have several host tasks of different priority.
+ *   @remark
+ * A basic task must not suspend, neither explicitly, e.g. by rtos_delay, nor implicitly
+ * inside a service like mbx_fetchWait. It would stall all other basic tasks of its host.
+ *   @remark
+ * Events are not queued. If a trigger event is posted while the host is busy with
+ * another basic task, then the event is lost - like for any other task, which doesn't
+ * currently wait for the posted event. A semaphore as trigger event doesn't have this
+ * drawback; each counted value triggers the basic task once. A mutex as trigger event
+ * must be released by the basic task before it returns.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   btk_runBasicTasks
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "btk_basicTask.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * The body of a host task. The function dispatches the basic tasks of a table as their
+ * trigger events are posted. It never returns.
+ *   @param basicTaskAry
+ * The table of basic tasks, which share the stack of the calling host task. The order of
+ * entries is the priority of the basic tasks, the first one has the highest priority. The
+ * table needs to stay valid all the RTOS runtime.
+ *   @param noBasicTasks
+ * The number of entries in \a basicTaskAry.
+ *   @remark
+ * The function must be called only from the task function of the host task. The host
+ * task can be started by any event, e.g. RTOS_EVT_DELAY_TIMER with delay zero.
+ */
+
+void btk_runBasicTasks(const btk_basicTask_t basicTaskAry[], uint8_t noBasicTasks)
+{
+    /* The host waits for any of the trigger events. */
+    uintEventVec_t triggerEventMask = 0;
+    uint8_t u;
+    for(u=0; u<noBasicTasks; ++u)
+    {
+        ASSERT(basicTaskAry[u].basicTaskFunction != NULL
+               &&  basicTaskAry[u].triggerEventMask != 0
+               &&  (basicTaskAry[u].triggerEventMask
+                    & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)
+                   ) == 0
+              );
+        triggerEventMask |= basicTaskAry[u].triggerEventMask;
+    }
+
+    while(true)
+    {
+        const uintEventVec_t postedEventVec = rtos_waitForEvent( triggerEventMask
+                                                               , /* all */ false
+                                                               , /* timeout */ 0
+                                                               );
+
+        /* Several events may have been posted at a time. All triggered basic tasks are
+           run, one after another in the order of the table. */
+        const btk_basicTask_t *pBasicTask = &basicTaskAry[0];
+        for(u=0; u<noBasicTasks; ++u, ++pBasicTask)
+        {
+            const uintEventVec_t triggerEventVec = postedEventVec
+                                                   & pBasicTask->triggerEventMask;
+            if(triggerEventVec != 0)
+                pBasicTask->basicTaskFunction(triggerEventVec);
+        }
+    }
+} /* End of btk_runBasicTasks */
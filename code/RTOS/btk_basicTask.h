@@ -0,0 +1,69 @@
+#ifndef BTK_BASIC_TASK_INCLUDED
+#define BTK_BASIC_TASK_INCLUDED
+/**
+ * @file btk_basicTask.h
+ * Definition of global interface of module btk_basicTask.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+/** The function of a basic task. It is called with the triggering events and it needs to
+    return after having done its job. */
+typedef void (*btk_basicTaskFunction_t)(uintEventVec_t triggerEventVec);
+
+/** The description of a basic task. The application defines a constant table of these
+    objects, one per basic task, which share the same host task. */
+typedef struct btk_basicTask_t
+{
+    /** The function, which implements the basic task. */
+    btk_basicTaskFunction_t basicTaskFunction;
+
+    /** The events, which trigger the basic task. Timer events are not permitted. */
+    uintEventVec_t triggerEventMask;
+
+} btk_basicTask_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Implement the body of a host task, which dispatches a table of basic tasks. */
+void btk_runBasicTasks(const btk_basicTask_t basicTaskAry[], uint8_t noBasicTasks);
+
+
+#endif  /* BTK_BASIC_TASK_INCLUDED */
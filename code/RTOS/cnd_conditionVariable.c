@@ -0,0 +1,220 @@
+/**
+ * @file cnd_conditionVariable.c
+ *   Implementation of condition variables. A condition variable lets a task wait for a
+ * condition of some shared data, which is protected by a mutex of the kernel, e.g. "the
+ * configuration has been updated". The task owns the mutex and checks the condition. If
+ * it is not fulfilled, then the task releases the mutex and waits in one step. Another
+ * task, which owns the mutex and changes the data, signals the condition. The resumed task
+ * acquires the mutex again before it returns and re-checks the condition.\n
+ *   The condition variable is built on a semaphore of the kernel. Signalling the condition
+ * releases the semaphore; the kernel passes it to the waiting task of highest priority.
+ * The release of the mutex and the suspension of the waiting task are two kernel calls,
+ * but no signal can be lost in between: The semaphore counts a signal, which is given
+ * before the task is suspended, and the task takes it without waiting.\n
+ *   The number of waiting tasks is protected by the mutex. A signal is given only if a
+ * task is waiting, so that the semaphore doesn't collect signals nobody has waited for.
+ * Only a task, which has timed out while being signalled, may leave a signal behind. It
+ * causes a spurious return of the next waiting task; as usual with condition variables,
+ * the condition needs to be re-checked in a loop anyway.
+ *   @remark
+ * The module is available only if the application configures at least one semaphore and
+ * one mutex, see #RTOS_NO_SEMAPHORE_EVENTS and #RTOS_NO_MUTEX_EVENTS.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine or by
+ * the idle task.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   cnd_initConditionVariable
+ *   cnd_wait
+ *   cnd_signal
+ *   cnd_broadcast
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "cnd_conditionVariable.h"
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  &&  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a condition variable. No task is waiting for the condition.
+ *   @param pCond
+ * The condition variable object to initialize.
+ *   @param evtSemaphore
+ * The semaphore event, which is used to resume the waiting tasks. One of
+ * #RTOS_EVT_SEMAPHORE_00, #RTOS_EVT_SEMAPHORE_01, etc. The semaphore must not be used for
+ * other purposes.
+ *   @remark
+ * The function modifies the counter of the semaphore. It must be called in setup(),
+ * before the kernel uses this counter.
+ */
+
+void cnd_initConditionVariable( cnd_conditionVariable_t * const pCond
+                              , uintEventVec_t evtSemaphore
+                              )
+{
+    uint8_t idxSemaphore;
+
+    /* The semaphores are the least significant bits of the event vector. */
+    for(idxSemaphore=0; idxSemaphore<RTOS_NO_SEMAPHORE_EVENTS; ++idxSemaphore)
+        if(evtSemaphore == (RTOS_EVT_LSB << idxSemaphore))
+            break;
+    ASSERT(idxSemaphore < RTOS_NO_SEMAPHORE_EVENTS);
+
+    pCond->noWaiters = 0;
+    pCond->evtSemaphore = evtSemaphore;
+    rtos_semaphoreAry[idxSemaphore] = 0;
+
+} /* End of cnd_initConditionVariable */
+
+
+
+
+/**
+ * Wait for a condition. The calling task owns the mutex, which protects the data the
+ * condition refers to. The mutex is released and the task is suspended until another task
+ * signals the condition or until the timeout elapses. In either case, the mutex is
+ * acquired again before the function returns.\n
+ *   The caller needs to re-check the condition after return. Another task may have got
+ * the mutex first and changed the data again and a return without signal is possible,
+ * see module description.
+ *   @return
+ * Get true if the task has been resumed by a signal or false in case of a timeout.
+ *   @param pCond
+ * The condition variable object.
+ *   @param evtMutex
+ * The mutex event, which is owned by the calling task. All tasks, which wait for or
+ * signal the condition, need to use the same mutex.
+ *   @param timeout
+ * The maximum time to wait for the signal in system timer tics. See rtos_waitForEvent
+ * for the meaning of the delay timer. Acquiring the mutex again is not limited in time.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean cnd_wait( cnd_conditionVariable_t * const pCond
+                , uintEventVec_t evtMutex
+                , uintTime_t timeout
+                )
+{
+    /* The registration as waiting task is protected by the mutex. */
+    ++ pCond->noWaiters;
+
+    /* Release the mutex and wait for the signal. A signal, which is given in between, is
+       counted by the semaphore. */
+    rtos_sendEvent(evtMutex);
+    const uintEventVec_t eventVec = rtos_waitForEvent( pCond->evtSemaphore
+                                                       | RTOS_EVT_DELAY_TIMER
+                                                     , /* all */ false
+                                                     , timeout
+                                                     );
+    const boolean isSignalled = (eventVec & pCond->evtSemaphore) != 0;
+
+    /* The caller owns the mutex again on return. */
+    rtos_waitForEvent(evtMutex, /* all */ false, /* timeout */ 0);
+
+    /* Timeout: Withdraw the registration unless a signal has already been given. */
+    if(!isSignalled  &&  pCond->noWaiters > 0)
+        -- pCond->noWaiters;
+
+    return isSignalled;
+
+} /* End of cnd_wait */
+
+
+
+
+/**
+ * Signal a condition. The waiting task of highest priority is resumed. It doesn't become
+ * active before the calling task releases the mutex. Nothing happens if no task is
+ * waiting.
+ *   @param pCond
+ * The condition variable object.
+ *   @remark
+ * The calling task needs to own the mutex, which the waiting tasks use in cnd_wait.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void cnd_signal(cnd_conditionVariable_t * const pCond)
+{
+    if(pCond->noWaiters > 0)
+    {
+        -- pCond->noWaiters;
+        rtos_sendEvent(pCond->evtSemaphore);
+    }
+} /* End of cnd_signal */
+
+
+
+
+/**
+ * Signal a condition to all waiting tasks. They don't become active before the calling
+ * task releases the mutex; then they get the mutex in the order of their priority.
+ *   @param pCond
+ * The condition variable object.
+ *   @remark
+ * The calling task needs to own the mutex, which the waiting tasks use in cnd_wait.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void cnd_broadcast(cnd_conditionVariable_t * const pCond)
+{
+    /* Each release of the semaphore resumes another task. */
+    while(pCond->noWaiters > 0)
+    {
+        -- pCond->noWaiters;
+        rtos_sendEvent(pCond->evtSemaphore);
+    }
+} /* End of cnd_broadcast */
+
+#endif /* RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  &&  RTOS_USE_MUTEX == RTOS_FEATURE_ON */
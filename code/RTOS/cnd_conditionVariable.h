@@ -0,0 +1,81 @@
+#ifndef CND_CONDITIONVARIABLE_INCLUDED
+#define CND_CONDITIONVARIABLE_INCLUDED
+/**
+ * @file cnd_conditionVariable.h
+ * Definition of global interface of module cnd_conditionVariable.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  &&  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+/** A condition variable. Tasks, which own a mutex, wait for a condition of the data, which
+    is protected by the mutex. The object is owned by the application but it must be
+    accessed only through the functions of this module. */
+typedef struct cnd_conditionVariable_t
+{
+    /** The number of tasks, which wait for the condition and which have not been
+        signalled yet. The element is protected by the mutex of the condition. */
+    uint8_t noWaiters;
+
+    /** The semaphore, which is passed to a waiting task when the condition is
+        signalled. */
+    uintEventVec_t evtSemaphore;
+
+} cnd_conditionVariable_t;
+#endif
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  &&  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+/** Initialize a condition variable prior to its first use. To be called in setup(). */
+void cnd_initConditionVariable(cnd_conditionVariable_t *pCond, uintEventVec_t evtSemaphore);
+
+/** Release the mutex, wait for the condition and acquire the mutex again. */
+boolean cnd_wait(cnd_conditionVariable_t *pCond, uintEventVec_t evtMutex, uintTime_t timeout);
+
+/** Resume the waiting task of highest priority. */
+void cnd_signal(cnd_conditionVariable_t *pCond);
+
+/** Resume all waiting tasks. */
+void cnd_broadcast(cnd_conditionVariable_t *pCond);
+#endif
+
+
+#endif  /* CND_CONDITIONVARIABLE_INCLUDED */
@@ -0,0 +1,347 @@
+/**
+ * @file crr_crashRecord.c
+ *   A post-mortem record of a failing assertion. By default, ASSERT writes a message to
+ * the serial port and resets the CPU. If nobody listens at the port, then all context of
+ * the failure is lost and a reset in the field can hardly be diagnosed.\n
+ *   With this module, ASSERT first saves a crash record by calling crr_saveCrashRecord:
+ * The source file and line of the assertion, the index of the active task, the stack
+ * pointer, the system time and the newest #CRR_NO_TRACE_ENTRIES entries of the binary
+ * trace, if #RTOS_USE_TRACE is set. The record is located in the RAM section .noinit,
+ * which is not cleared by the C runtime at startup; it survives the reset. It is
+ * protected by a magic value and a checksum, so that the random contents of the RAM after
+ * power-up are not taken for a record.\n
+ *   After the reset, rtos_initRTOS calls crr_reportCrashRecord when setup() has returned.
+ * The serial port has been opened by then. A valid record is written to the port and
+ * deleted. Alternatively, the application can inspect the record in setup() by
+ * crr_getCrashRecord, e.g. to log it elsewhere; if it deletes the record by
+ * crr_deleteCrashRecord, then the kernel doesn't report it.\n
+ *   The module is compiled only if #RTOS_USE_CRASH_RECORD is set. ASSERT is enabled only
+ * in DEBUG compilation.
+ *   @remark
+ * The name of the source file is saved as a pointer into the flash ROM. It stays valid
+ * as long as the same software is running after the reset.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   crr_saveCrashRecord
+ *   crr_getCrashRecord
+ *   crr_deleteCrashRecord
+ *   crr_reportCrashRecord
+ * Local functions
+ *   getChecksum
+ *   writeChar
+ *   writeFlashStr
+ *   writeDec
+ *   writeHex
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "crr_crashRecord.h"
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+# include "ser_serial.h"
+#endif
+
+#if RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+/** The value of the magic field of a valid record. */
+#define MAGIC_CRASH_RECORD  0x4352u
+
+
+/*
+ * Local type definitions
+ */
+
+/** The crash record as stored in RAM. */
+typedef struct crashRecordStorage_t
+{
+    /** #MAGIC_CRASH_RECORD if the record is valid. */
+    uint16_t magic;
+
+    /** The saved state of the system. */
+    crr_crashRecord_t record;
+
+    /** The checksum of \a record, see getChecksum. */
+    uint16_t checksum;
+
+} crashRecordStorage_t;
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The crash record. It is not initialized by the C runtime. */
+static crashRecordStorage_t _crashRecordStorage __attribute__((section(".noinit")));
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Compute the checksum of a crash record.
+ *   @return
+ * Get the checksum. It is the sum of all bytes of the record, where the sum is rotated by
+ * one bit before each addition; this makes swapped bytes detectable.
+ *   @param pCrashRecord
+ * The record.
+ */
+
+static uint16_t getChecksum(const crr_crashRecord_t *pCrashRecord)
+{
+    const uint8_t *pByte = (const uint8_t*)pCrashRecord;
+    uint16_t checksum = MAGIC_CRASH_RECORD;
+    uint16_t u = sizeof(*pCrashRecord);
+    do
+    {
+        checksum = ((checksum << 1) | (checksum >> 15)) + *pByte++;
+    }
+    while(--u > 0);
+
+    return checksum;
+
+} /* End of getChecksum */
+
+
+
+
+/**
+ * Save the crash record. The function is called by ASSERT when the assertion fails,
+ * before the message is written and the CPU is reset.
+ *   @param fileName
+ * The name of the source file of the assertion as a string in flash ROM.
+ *   @param line
+ * The line of the assertion in the source file.
+ *   @remark
+ * The function can be called from any context, including interrupt service routines and
+ * code, which has globally disabled the interrupts. It returns with globally disabled
+ * interrupts.
+ *   @remark
+ * A previously saved record is overwritten. This can only be a record, which has not been
+ * reported or deleted after the last reset.
+ */
+
+void crr_saveCrashRecord(const char *fileName, uint16_t line)
+{
+#ifdef RTOS_HOST_SIMULATION
+    const uint16_t sp = 0;
+#else
+    const uint16_t sp = SP;
+#endif
+
+    /* rtos_getTime enables the interrupts, which is of no harm; ASSERT enables them
+       anyway to write the message. */
+    const uintTime_t time = rtos_getTime();
+    cli();
+
+    crr_crashRecord_t * const pRecord = &_crashRecordStorage.record;
+    pRecord->fileName = fileName;
+    pRecord->line = line;
+    pRecord->idxTask = rtos_getIdxActiveTask();
+    pRecord->sp = sp;
+    pRecord->time = time;
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+    pRecord->noTraceEntries = trc_getNewestEntries( pRecord->traceEntryAry
+                                                  , CRR_NO_TRACE_ENTRIES
+                                                  );
+#endif
+    _crashRecordStorage.checksum = getChecksum(pRecord);
+    _crashRecordStorage.magic = MAGIC_CRASH_RECORD;
+
+} /* End of crr_saveCrashRecord */
+
+
+
+
+/**
+ * Get the crash record, which has been saved before the last reset. The record is not
+ * deleted.
+ *   @return
+ * Get true if a valid record has been found.
+ *   @param pCrashRecord
+ * If the function returns true, then the record is copied into * \a pCrashRecord.
+ * Otherwise the variable is not touched.
+ *   @remark
+ * The function is intended to be called from setup(). It must not be called from an
+ * interrupt service routine.
+ */
+
+boolean crr_getCrashRecord(crr_crashRecord_t *pCrashRecord)
+{
+    boolean isValid = false;
+
+    cli();
+    if(_crashRecordStorage.magic == MAGIC_CRASH_RECORD
+       &&  _crashRecordStorage.checksum == getChecksum(&_crashRecordStorage.record)
+      )
+    {
+        *pCrashRecord = _crashRecordStorage.record;
+        isValid = true;
+    }
+    sei();
+
+    return isValid;
+
+} /* End of crr_getCrashRecord */
+
+
+
+
+/**
+ * Delete the crash record. crr_getCrashRecord will return false and the kernel won't
+ * report the record.
+ */
+
+void crr_deleteCrashRecord(void)
+{
+    _crashRecordStorage.magic = 0;
+
+} /* End of crr_deleteCrashRecord */
+
+
+
+
+/**
+ * Write a character to the serial port. This is the same channel as used by ASSERT.
+ *   @param c
+ * The character.
+ */
+
+static void writeChar(char c)
+{
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+    ser_putchar(c);
+#else
+    Serial.write(c);
+#endif
+} /* End of writeChar */
+
+
+
+
+/**
+ * Write a string to the serial port.
+ *   @param flashStr
+ * The string, which is located in flash ROM.
+ */
+
+static void writeFlashStr(const char *flashStr)
+{
+    char c;
+    while((c = pgm_read_byte(flashStr++)) != '\0')
+        writeChar(c);
+
+} /* End of writeFlashStr */
+
+
+
+
+/**
+ * Write a number as decimal digits to the serial port.
+ *   @param number
+ * The number to write.
+ */
+
+static void writeDec(uint32_t number)
+{
+    char digitAry[10];
+    uint8_t noDigits = 0;
+    do
+    {
+        digitAry[noDigits++] = '0' + (char)(number % 10);
+        number /= 10;
+    }
+    while(number > 0);
+
+    while(noDigits > 0)
+        writeChar(digitAry[--noDigits]);
+
+} /* End of writeDec */
+
+
+
+
+/**
+ * Write a 16 Bit number as four hexadecimal digits to the serial port.
+ *   @param number
+ * The number to write.
+ */
+
+static void writeHex(uint16_t number)
+{
+    uint8_t noDigits = 4;
+    while(noDigits-- > 0)
+    {
+        const uint8_t nibble = (uint8_t)(number >> (4*noDigits)) & 0xf;
+        writeChar(nibble < 10? '0'+nibble: 'a'-10+nibble);
+    }
+} /* End of writeHex */
+
+
+
+
+/**
+ * Write the crash record, which has been saved before the last reset, to the serial port
+ * and delete it. If there is no valid record, then nothing is written.\n
+ *   The function is called by rtos_initRTOS after return from setup(), where the
+ * application has initialized the serial port. The saved trace entries are written in
+ * the format of trc_dump.
+ */
+
+void crr_reportCrashRecord(void)
+{
+    crr_crashRecord_t record;
+    if(!crr_getCrashRecord(&record))
+        return;
+    crr_deleteCrashRecord();
+
+    writeFlashStr(RTOS_FLASH_STR("Crash record: Assertion failed in file "));
+    writeFlashStr(record.fileName);
+    writeFlashStr(RTOS_FLASH_STR(", line "));
+    writeDec(record.line);
+    writeFlashStr(RTOS_FLASH_STR(", task "));
+    writeDec(record.idxTask);
+    writeFlashStr(RTOS_FLASH_STR(", SP 0x"));
+    writeHex(record.sp);
+    writeFlashStr(RTOS_FLASH_STR(", time "));
+    writeDec(record.time);
+    writeChar('\r');
+    writeChar('\n');
+
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+    uint8_t u;
+    for(u=0; u<record.noTraceEntries; ++u)
+        trc_writeEntry(&record.traceEntryAry[u]);
+#endif
+} /* End of crr_reportCrashRecord */
+
+#endif /* RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON */
@@ -0,0 +1,102 @@
+#ifndef CRR_CRASH_RECORD_INCLUDED
+#define CRR_CRASH_RECORD_INCLUDED
+/**
+ * @file crr_crashRecord.h
+ * Definition of global interface of module crr_crashRecord.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+# include "trc_trace.h"
+#endif
+
+
+/*
+ * Defines
+ */
+
+/** The number of the newest entries of the binary trace, which are saved in the crash
+    record. Each entry takes five Byte of RAM. The setting is used only if #RTOS_USE_TRACE
+    is set. The application may override the default in its rtos.config.h. */
+#ifndef CRR_NO_TRACE_ENTRIES
+# define CRR_NO_TRACE_ENTRIES   4
+#endif
+
+
+/*
+ * Global type definitions
+ */
+
+/** The state of the system at the time an assertion failed. */
+typedef struct crr_crashRecord_t
+{
+    /** The name of the source file of the failing assertion. The string is located in
+        flash ROM, it needs to be read with the pgm_read functions. */
+    const char *fileName;
+
+    /** The line of the failing assertion in the source file. */
+    uint16_t line;
+
+    /** The index of the active task. The idle task has the index #RTOS_NO_TASKS. The
+        assertion may have failed in an interrupt service routine, which interrupted this
+        task. */
+    uint8_t idxTask;
+
+    /** The stack pointer at the time the assertion failed. */
+    uint16_t sp;
+
+    /** The system time at the time the assertion failed. */
+    uintTime_t time;
+
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+    /** The number of saved trace entries. */
+    uint8_t noTraceEntries;
+
+    /** The newest entries of the binary trace, from the eldest to the newest one. */
+    trc_entry_t traceEntryAry[CRR_NO_TRACE_ENTRIES];
+#endif
+} crr_crashRecord_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Save the crash record of a failing assertion. Called by ASSERT. */
+void crr_saveCrashRecord(const char *fileName, uint16_t line);
+
+/** Get the crash record, which has been saved before the last reset. */
+boolean crr_getCrashRecord(crr_crashRecord_t *pCrashRecord);
+
+/** Delete the crash record. */
+void crr_deleteCrashRecord(void);
+
+/** Write the crash record to the serial port and delete it. Called by rtos_initRTOS. */
+void crr_reportCrashRecord(void);
+
+
+#endif  /* CRR_CRASH_RECORD_INCLUDED */
@@ -0,0 +1,285 @@
+/**
+ * @file dbc_debounce.c
+ *   Debouncing of inputs in the sampling interrupt. An input is sampled regularly, e.g. by
+ * the ADC scan, see asc_adcScan.c, and each sample is classified by a table of integer
+ * thresholds; the result is the input state. Several buttons, which shortcut a voltage
+ * divider at different resistors, have an input state for each button and one for none.
+ * A digital input has two states.\n
+ *   An input state is confirmed if a configurable number of subsequent samples are
+ * classified the same. Intermediate voltages, which are seen while a button is pressed or
+ * released, are filtered out this way. Only a change of the confirmed state - a press or a
+ * release of a button - or a long press is reported to the application. A release
+ * always is the return to the idle state; if the input changes between two non idle
+ * states, e.g. when a second button is pressed, then only the press of the new state is
+ * reported. These input
+ * events are queued and an event is posted to the client task.\n
+ *   The classification and debouncing is done in the interrupt, which acquires the
+ * samples. The client task is resumed a few times per user action, not once per sample.
+ * Once resumed, it reads all queued input events with dbc_readInputEvent.\n
+ *   The module is compiled only if #RTOS_USE_SEND_EVENT_FROM_ISR is set. The calling
+ * interrupt service routine needs to end with rtos_leaveISR.
+ *   @remark
+ * A debouncer supports a single interrupt, which feeds it, and a single client task.
+ * Several debouncer objects can be used for different inputs.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   dbc_initDebouncer
+ *   dbc_processSampleFromISR
+ *   dbc_readInputEvent
+ * Local functions
+ *   classifySample
+ *   queueInputEvent
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "dbc_debounce.h"
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if DBC_SIZE_OF_QUEUE < 1  ||  DBC_SIZE_OF_QUEUE > 128 \
+    ||  (DBC_SIZE_OF_QUEUE & (DBC_SIZE_OF_QUEUE-1)) != 0
+# error The size of the queue needs to be a power of two in the range 1..128
+#endif
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a debouncer object. The input is considered to be in the idle state.
+ *   @param pDebouncer
+ * The debouncer object to initialize.
+ *   @param thresholdAry
+ * The thresholds of the classification in strictly ascending order. A sample, which is
+ * greater than n of the thresholds, has input state n. The array is not copied, it needs
+ * to exist as long as the debouncer is in use.
+ *   @param noThresholds
+ * The number of thresholds, 1..63. The number of input states is one more.
+ *   @param idleState
+ * The input state, which means no button pressed or released respectively.
+ *   @param noSamplesDebounce
+ * The number of subsequent samples with the same classification, which confirm an input
+ * state, 1..255.
+ *   @param noSamplesLongPress
+ * A long press is reported if a non idle state is held for this number of samples after
+ * its confirmation. 0 disables the long press events.
+ *   @param evtInput
+ * The event, which is posted if an input event has been queued. It needs to be a normal,
+ * broadcasted event, neither a semaphore, nor a mutex, nor a timer event.
+ *   @remark
+ * The function must be called before the sampling interrupt is enabled.
+ */
+
+void dbc_initDebouncer( dbc_debouncer_t * const pDebouncer
+                      , const uint16_t thresholdAry[]
+                      , uint8_t noThresholds
+                      , uint8_t idleState
+                      , uint8_t noSamplesDebounce
+                      , uint8_t noSamplesLongPress
+                      , uintEventVec_t evtInput
+                      )
+{
+    ASSERT(noThresholds >= 1  &&  noThresholds <= 63  &&  idleState <= noThresholds);
+    ASSERT(noSamplesDebounce >= 1);
+    ASSERT(evtInput != 0
+           &&  (evtInput & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+#ifdef DEBUG
+    uint8_t u;
+    for(u=1; u<noThresholds; ++u)
+        ASSERT(thresholdAry[u-1] < thresholdAry[u]);
+#endif
+
+    pDebouncer->thresholdAry = thresholdAry;
+    pDebouncer->noThresholds = noThresholds;
+    pDebouncer->idleState = idleState;
+    pDebouncer->noSamplesDebounce = noSamplesDebounce;
+    pDebouncer->noSamplesLongPress = noSamplesLongPress;
+    pDebouncer->evtInput = evtInput;
+    pDebouncer->candidateState = idleState;
+    pDebouncer->cntCandidate = noSamplesDebounce;
+    pDebouncer->stableState = idleState;
+    pDebouncer->cntStable = 0;
+    pDebouncer->idxWrite = 0;
+    pDebouncer->idxRead = 0;
+
+} /* End of dbc_initDebouncer */
+
+
+
+
+/**
+ * Get the input state of a sample.
+ *   @return
+ * The number of thresholds, which are less than the sample.
+ *   @param pDebouncer
+ * The debouncer, which holds the thresholds.
+ *   @param sample
+ * The sample to classify.
+ */
+
+static inline uint8_t classifySample(const dbc_debouncer_t * const pDebouncer, uint16_t sample)
+{
+    uint8_t state = 0;
+    while(state < pDebouncer->noThresholds  &&  sample > pDebouncer->thresholdAry[state])
+        ++ state;
+
+    return state;
+
+} /* End of classifySample */
+
+
+
+
+/**
+ * Append an input event to the queue and post the event to the client task. If the queue
+ * is full, the input event is lost.
+ *   @param pDebouncer
+ * The debouncer object.
+ *   @param kind
+ * The kind of input event, one out of DBC_EVT_KIND_xxx.
+ *   @param state
+ * The input state, which is reported.
+ */
+
+static void queueInputEvent(dbc_debouncer_t * const pDebouncer, uint8_t kind, uint8_t state)
+{
+    const uint8_t idxWrite = pDebouncer->idxWrite;
+    if((uint8_t)(idxWrite - pDebouncer->idxRead) < DBC_SIZE_OF_QUEUE)
+    {
+        pDebouncer->queueAry[idxWrite & (DBC_SIZE_OF_QUEUE-1)] = kind | state;
+        pDebouncer->idxWrite = idxWrite + 1;
+    }
+
+    /* Even if the input event is lost, the client is triggered to read the queue. */
+    rtos_sendEventFromISR(pDebouncer->evtInput);
+
+} /* End of queueInputEvent */
+
+
+
+
+/**
+ * Feed the next sample of the input into a debouncer. The sample is classified and
+ * debounced. A change of the confirmed input state and a long press are queued as input
+ * events and the event of the debouncer is posted.
+ *   @param pDebouncer
+ * The debouncer object.
+ *   @param sample
+ * The next sample of the input.
+ *   @remark
+ * The function must be called from an interrupt service routine, which ends with
+ * rtos_leaveISR. The interrupt needs to be inhibited by rtos_enterCriticalSection.
+ */
+
+void dbc_processSampleFromISR(dbc_debouncer_t * const pDebouncer, uint16_t sample)
+{
+    const uint8_t state = classifySample(pDebouncer, sample);
+
+    if(state != pDebouncer->candidateState)
+    {
+        pDebouncer->candidateState = state;
+        pDebouncer->cntCandidate = 1;
+    }
+    else if(pDebouncer->cntCandidate < pDebouncer->noSamplesDebounce)
+        ++ pDebouncer->cntCandidate;
+
+    if(pDebouncer->cntCandidate >= pDebouncer->noSamplesDebounce
+       &&  state != pDebouncer->stableState
+      )
+    {
+        /* The new input state is confirmed. A release always means the return to the idle
+           state; the change from one non idle state to another one is reported as press
+           of the new state only. */
+        const uint8_t formerState = pDebouncer->stableState;
+        pDebouncer->stableState = state;
+        pDebouncer->cntStable = 0;
+
+        if(state == pDebouncer->idleState)
+            queueInputEvent(pDebouncer, DBC_EVT_KIND_RELEASE, formerState);
+        else
+            queueInputEvent(pDebouncer, DBC_EVT_KIND_PRESS, state);
+    }
+    else if(pDebouncer->stableState != pDebouncer->idleState
+            &&  pDebouncer->cntStable < pDebouncer->noSamplesLongPress
+           )
+    {
+        if(++pDebouncer->cntStable == pDebouncer->noSamplesLongPress)
+            queueInputEvent(pDebouncer, DBC_EVT_KIND_LONG_PRESS, pDebouncer->stableState);
+    }
+} /* End of dbc_processSampleFromISR */
+
+
+
+
+/**
+ * Read the next queued input event of a debouncer.
+ *   @return
+ * Get true if an input event has been read, false if the queue is empty.
+ *   @param pDebouncer
+ * The debouncer object.
+ *   @param pEvt
+ * The input event is returned in * \a pEvt. Use #DBC_GET_EVT_KIND and #DBC_GET_EVT_STATE
+ * to decode it.
+ *   @remark
+ * The function is called by the single client task of the debouncer, typically after it
+ * has been resumed by the event of the debouncer. It should read until the function
+ * returns false. No critical section is required; the position indexes are written by
+ * either the interrupt or the task.
+ */
+
+boolean dbc_readInputEvent(dbc_debouncer_t * const pDebouncer, dbc_inputEvent_t *pEvt)
+{
+    const uint8_t idxRead = pDebouncer->idxRead;
+    if(idxRead == pDebouncer->idxWrite)
+        return false;
+
+    *pEvt = pDebouncer->queueAry[idxRead & (DBC_SIZE_OF_QUEUE-1)];
+    pDebouncer->idxRead = idxRead + 1;
+
+    return true;
+
+} /* End of dbc_readInputEvent */
+
+#endif /* RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON */
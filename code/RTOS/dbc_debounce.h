@@ -0,0 +1,145 @@
+#ifndef DBC_DEBOUNCE_INCLUDED
+#define DBC_DEBOUNCE_INCLUDED
+/**
+ * @file dbc_debounce.h
+ * Definition of global interface of module dbc_debounce.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of input events, which can be queued by a debouncer until the task reads
+    them. It needs to be a power of two in the range 1..128. The application may override
+    the default in its rtos.config.h. */
+#ifndef DBC_SIZE_OF_QUEUE
+# define DBC_SIZE_OF_QUEUE  4
+#endif
+
+/** The kind of an input event: A state other than the idle state has been entered. */
+#define DBC_EVT_KIND_PRESS      0x00
+
+/** The kind of an input event: The idle state has been entered (again). */
+#define DBC_EVT_KIND_RELEASE    0x40
+
+/** The kind of an input event: A state other than the idle state has been held for the
+    configured long press time. */
+#define DBC_EVT_KIND_LONG_PRESS 0x80
+
+/** Get the kind of an input event, one out of DBC_EVT_KIND_xxx. */
+#define DBC_GET_EVT_KIND(evt)   ((evt) & 0xc0)
+
+/** Get the input state of an input event. For a press or long press event, this is the
+    state, which has been entered or held; for a release, it is the state, which has been
+    left. */
+#define DBC_GET_EVT_STATE(evt)  ((evt) & 0x3f)
+
+
+/*
+ * Global type definitions
+ */
+
+/** An input event as found in the queue of a debouncer. Kind and input state are got with
+    #DBC_GET_EVT_KIND and #DBC_GET_EVT_STATE. */
+typedef uint8_t dbc_inputEvent_t;
+
+/** A debouncer. The object is owned by the application but it must be accessed only
+    through the functions of this module. */
+typedef struct dbc_debouncer_t
+{
+    /** The thresholds, which classify a sample, in strictly ascending order. A sample,
+        which is greater than n thresholds, has the input state n. */
+    const uint16_t *thresholdAry;
+
+    /** The number of thresholds, i.e. the number of input states minus one. */
+    uint8_t noThresholds;
+
+    /** The input state, which means released. */
+    uint8_t idleState;
+
+    /** The number of subsequent samples with the same input state, which confirm the
+        state. */
+    uint8_t noSamplesDebounce;
+
+    /** The number of samples after the confirmation of a non idle state, after which a
+        long press is reported. 0 if not used. */
+    uint8_t noSamplesLongPress;
+
+    /** The event, which is posted, when an input event has been queued. */
+    uintEventVec_t evtInput;
+
+    /** The classification of the recent samples. */
+    uint8_t candidateState;
+
+    /** The number of subsequent samples without change of \a candidateState. */
+    uint8_t cntCandidate;
+
+    /** The confirmed input state. */
+    uint8_t stableState;
+
+    /** The number of samples since confirmation of \a stableState, saturated at \a
+        noSamplesLongPress. */
+    uint8_t cntStable;
+
+    /** The queue of input events. */
+    dbc_inputEvent_t queueAry[DBC_SIZE_OF_QUEUE];
+
+    /** The position of the next write into the queue, modified by the interrupt only. */
+    volatile uint8_t idxWrite;
+
+    /** The position of the next read from the queue, modified by the task only. */
+    volatile uint8_t idxRead;
+
+} dbc_debouncer_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+/** Initialize a debouncer object prior to its first use. */
+void dbc_initDebouncer( dbc_debouncer_t * const pDebouncer
+                      , const uint16_t thresholdAry[]
+                      , uint8_t noThresholds
+                      , uint8_t idleState
+                      , uint8_t noSamplesDebounce
+                      , uint8_t noSamplesLongPress
+                      , uintEventVec_t evtInput
+                      );
+
+/** Feed the next sample into a debouncer. To be called from the sampling interrupt. */
+void dbc_processSampleFromISR(dbc_debouncer_t * const pDebouncer, uint16_t sample);
+
+/** Get the next queued input event from a debouncer. */
+boolean dbc_readInputEvent(dbc_debouncer_t * const pDebouncer, dbc_inputEvent_t *pEvt);
+#endif
+
+#endif  /* DBC_DEBOUNCE_INCLUDED */
@@ -0,0 +1,255 @@
+/**
+ * @file dpc_deferredProcedureCall.c
+ *   Deferred procedure calls, the bottom halves of interrupt service routines. An
+ * interrupt, which has more to do than fits into the interrupt context, normally posts an
+ * event to a task of its own. Each such interrupt source costs a task object, a stack
+ * area, which is sized for the worst case of the task and the interrupts, and a context
+ * switch per interrupt. With this module, the interrupts queue the calls of procedures
+ * instead and all the procedures are run by a single task, the DPC worker, on its own
+ * stack.\n
+ *   An interrupt service routine queues a call by dpc_callFromISR. A call is a pair of a
+ * function pointer and a 16 Bit argument; it is copied into a ring buffer of
+ * #DPC_SIZE_OF_QUEUE elements. The DPC worker is an ordinary RTuinOS task. Its task
+ * function consists of a single call of dpc_runWorkerTask, which never returns. The worker
+ * takes the queued calls out of the buffer and runs them in the order, in which they had
+ * been queued. If the queue is empty, the worker suspends. The next interrupt, which
+ * queues a call, resumes it by rtos_sendEventFromISR. All further calls, which are queued
+ * while the worker is busy, are run without involving the kernel at all. A burst of
+ * interrupts costs a single context switch rather than one per interrupt.\n
+ *   The worker is scheduled like any other task. Its priority is the priority of all
+ * deferred procedures; normally it is the task of highest priority. A procedure is
+ * preempted by tasks of higher priority and by interrupts but never by another deferred
+ * procedure.\n
+ *   The module is compiled only if #RTOS_USE_DPC_QUEUE is set. The interrupts post the
+ * event of the worker by rtos_sendEventFromISR, which needs to be enabled by
+ * #RTOS_USE_SEND_EVENT_FROM_ISR.
+ *   @remark
+ * The queue is lock-free. The interrupts are the producers; they run with globally
+ * disabled interrupts and can't interfere with each other. The worker is the only
+ * consumer and it modifies the read position only. Except for the check of the empty
+ * queue before suspending, the worker doesn't lock the interrupts.
+ *   @remark
+ * A deferred procedure must not suspend, neither explicitly, e.g. by rtos_delay, nor
+ * implicitly inside a service like mbx_fetchWait. It would delay all other procedures.
+ *   @remark
+ * Each interrupt service routine, which calls dpc_callFromISR, needs to end with a call
+ * of rtos_leaveISR and it needs to be inhibited by rtos_enterCriticalSection, see
+ * rtos_sendEventFromISR. The worker needs an event of its own, which must not be used by
+ * any other task.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   dpc_callFromISR
+ *   dpc_getNoLostCalls
+ *   dpc_runWorkerTask
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "dpc_deferredProcedureCall.h"
+
+#if RTOS_USE_DPC_QUEUE == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR != RTOS_FEATURE_ON
+# error The DPC queue requires RTOS_USE_SEND_EVENT_FROM_ISR to be set to RTOS_FEATURE_ON
+#endif
+
+#if DPC_SIZE_OF_QUEUE < 2  ||  DPC_SIZE_OF_QUEUE > 128 \
+    ||  (DPC_SIZE_OF_QUEUE & (DPC_SIZE_OF_QUEUE-1)) != 0
+# error The size of the DPC queue needs to be a power of two in the range 2..128
+#endif
+
+
+/*
+ * Local type definitions
+ */
+
+/** A queued call of a deferred procedure. */
+typedef struct dpcCall_t
+{
+    /** The procedure to call. */
+    dpc_procedure_t procedure;
+
+    /** The argument of the procedure. */
+    uint16_t argument;
+
+} dpcCall_t;
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The ring buffer of queued calls. */
+static dpcCall_t _queueAry[DPC_SIZE_OF_QUEUE];
+
+/** The position of the next call to queue. Modified by the interrupts only. The position
+    indexes are cyclically incremented and never wrapped explicitly. The number of queued
+    calls is their difference. */
+static volatile uint8_t _idxWrite = 0;
+
+/** The position of the next call to run. Modified by the worker only. */
+static volatile uint8_t _idxRead = 0;
+
+/** The event, which is posted by the interrupts to resume the waiting worker. */
+static uintEventVec_t _evtCallQueued = 0;
+
+/** Flag, which is set by the worker before it suspends itself to wait for a queued call.
+    The interrupt, which queues the next call, resets it and posts \a _evtCallQueued. */
+static volatile boolean _isWorkerWaiting = false;
+
+/** The number of calls, which couldn't be queued because the queue was full. */
+static volatile uint16_t _noLostCalls = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Queue the call of a procedure. The procedure is called from the DPC worker task after
+ * all calls, which have been queued before.\n
+ *   If the worker is suspended, then it is resumed by rtos_sendEventFromISR. The
+ * interrupt service routine needs to end with a call of rtos_leaveISR, where the kernel
+ * switches to the worker if it has a higher priority than the interrupted task.
+ *   @return
+ * Get true if the call has been queued. If the queue is full, the call is lost. The
+ * function returns false and counts the loss, see dpc_getNoLostCalls.
+ *   @param procedure
+ * The function to call.
+ *   @param argument
+ * The argument of the call.
+ *   @remark
+ * The function must be called only from an interrupt service routine and with the global
+ * interrupt enable flag reset.
+ */
+
+boolean dpc_callFromISR(dpc_procedure_t procedure, uint16_t argument)
+{
+    const uint8_t idxWrite = _idxWrite;
+    if((uint8_t)(idxWrite - _idxRead) >= DPC_SIZE_OF_QUEUE)
+    {
+        ++ _noLostCalls;
+        return false;
+    }
+
+    dpcCall_t * const pCall = &_queueAry[idxWrite & (DPC_SIZE_OF_QUEUE-1)];
+    pCall->procedure = procedure;
+    pCall->argument = argument;
+    _idxWrite = idxWrite + 1;
+
+    /* Only the first call after the queue ran empty needs to resume the worker. */
+    if(_isWorkerWaiting)
+    {
+        _isWorkerWaiting = false;
+        rtos_sendEventFromISR(_evtCallQueued);
+    }
+
+    return true;
+
+} /* End of dpc_callFromISR */
+
+
+
+
+/**
+ * Get the number of calls, which were lost since the queue was full. A loss means that
+ * the DPC worker can't keep up with the interrupts; either its priority is too low or
+ * #DPC_SIZE_OF_QUEUE is too little for the burst size of the interrupts.
+ *   @return
+ * Get the number of lost calls since start of the system. The counter wraps around.
+ *   @remark
+ * The function must be called from a task.
+ */
+
+uint16_t dpc_getNoLostCalls(void)
+{
+    cli();
+    const uint16_t noLostCalls = _noLostCalls;
+    sei();
+
+    return noLostCalls;
+
+} /* End of dpc_getNoLostCalls */
+
+
+
+
+/**
+ * The body of the DPC worker task. The function runs the queued calls one after another.
+ * It never returns.
+ *   @param evtCallQueued
+ * The event, which is posted by dpc_callFromISR if the worker waits for a queued call.
+ * It must not be a timer event and it must not be used by any other task.
+ *   @remark
+ * The function must be called only from the task function of the worker task. The worker
+ * can be started by any event, e.g. RTOS_EVT_DELAY_TIMER with delay zero. Calls, which
+ * are queued before the worker has been started, are not lost as long as they fit into
+ * the queue.
+ */
+
+void dpc_runWorkerTask(uintEventVec_t evtCallQueued)
+{
+    ASSERT(evtCallQueued != 0
+           &&  (evtCallQueued & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+    _evtCallQueued = evtCallQueued;
+
+    while(true)
+    {
+        /* The queue is inspected with the interrupts disabled. They stay disabled till the
+           worker is suspended, if the queue is empty: The notification can't get lost.
+           The suspend function reenables the interrupts. */
+        cli();
+        const uint8_t idxRead = _idxRead;
+        if(idxRead == _idxWrite)
+        {
+            _isWorkerWaiting = true;
+            rtos_waitForEvent(evtCallQueued, /* all */ false, /* timeout */ 0);
+        }
+        else
+        {
+            sei();
+
+            /* The element is released before the call; the interrupts can queue the
+               next call already while the procedure is running. */
+            const dpcCall_t * const pCall = &_queueAry[idxRead & (DPC_SIZE_OF_QUEUE-1)];
+            const dpc_procedure_t procedure = pCall->procedure;
+            const uint16_t argument = pCall->argument;
+            _idxRead = idxRead + 1;
+
+            procedure(argument);
+        }
+    }
+} /* End of dpc_runWorkerTask */
+
+#endif /* RTOS_USE_DPC_QUEUE == RTOS_FEATURE_ON */
@@ -0,0 +1,71 @@
+#ifndef DPC_DEFERRED_PROCEDURE_CALL_INCLUDED
+#define DPC_DEFERRED_PROCEDURE_CALL_INCLUDED
+/**
+ * @file dpc_deferredProcedureCall.h
+ * Definition of global interface of module dpc_deferredProcedureCall.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of deferred procedure calls, which can be queued at a time. It needs to be
+    a power of two in the range 2..128. The application may override the default in its
+    rtos.config.h. */
+#ifndef DPC_SIZE_OF_QUEUE
+# define DPC_SIZE_OF_QUEUE  8
+#endif
+
+
+/*
+ * Global type definitions
+ */
+
+/** A deferred procedure. It is called from the DPC worker task and it needs to return
+    after having done its job. It gets the argument, which has been queued by the
+    interrupt. */
+typedef void (*dpc_procedure_t)(uint16_t argument);
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Queue the call of a procedure from an interrupt service routine. */
+boolean dpc_callFromISR(dpc_procedure_t procedure, uint16_t argument);
+
+/** Get the number of calls, which were lost since the queue was full. */
+uint16_t dpc_getNoLostCalls(void);
+
+/** Implement the body of the DPC worker task, which runs the queued procedures. */
+void dpc_runWorkerTask(uintEventVec_t evtCallQueued);
+
+
+#endif  /* DPC_DEFERRED_PROCEDURE_CALL_INCLUDED */
@@ -0,0 +1,573 @@
+/**
+ * @file ebs_eventBus.c
+ *   Distribution of RTuinOS events across several boards. A set of events can be mapped to
+ * a remote node. A task, which posts events by ebs_sendEvent, resumes the tasks on the
+ * remote node, which wait for the mapped events, in the same way as rtos_sendEvent does
+ * with the tasks of the own node. An application can be partitioned across several
+ * controllers without rewriting its synchronization logic; only the calls of
+ * rtos_sendEvent, which post mapped events, are replaced by ebs_sendEvent.\n
+ *   The events are sent in compact frames over the serial port USART1: A synchronization
+ * byte, the source and destination node IDs, the event vector and a checksum. The nodes
+ * form a ring: The transmitter of each node is connected to the receiver of the next one.
+ * Two nodes, which are cross-wired, are the smallest ring. A node posts the events of a
+ * received frame, which is addressed to it or which is a broadcast, and it forwards all
+ * other frames to the next node. A frame, which returns to its source, is discarded.
+ * Looping the transmitter of a single node back to its receiver makes it a ring of one
+ * node, which is useful for testing.\n
+ *   Transmission and reception are interrupt driven. The receive interrupt posts the
+ * events by rtos_sendEventFromISR, which needs to be enabled by
+ * #RTOS_USE_SEND_EVENT_FROM_ISR. A task, which finds the transmit buffer full, is
+ * suspended until there's space for the frame. The module is compiled only if
+ * #RTOS_USE_EVENT_BUS is set.
+ *   @remark
+ * The events are posted on the remote node only if they belong to its set of accepted
+ * events, see ebs_initAfterPowerUp. Only ordinary, broadcasted events should be
+ * distributed; the transmission is not synchronous with the sender and the semantics of
+ * a semaphore or mutex can't be kept.
+ *   @remark
+ * The idle task must never suspend. If it finds the transmit buffer full, it busy-waits
+ * until there's space for the frame.
+ *   @remark
+ * The module defines the interrupt service routines "receive complete" and "data register
+ * empty" of USART1, which must not be used by the application, too; Arduino's Serial1 must
+ * not be used. Both interrupts can switch to another task. rtos_enterCriticalSection
+ * should inhibit them by resetting the bits RXCIE1 and UDRIE1 in register UCSR1B. Both
+ * bits may be set again by rtos_leaveCriticalSection regardless whether there's pending
+ * output. The receiver buffers two bytes in hardware, the lock time of a critical section
+ * must not exceed the transmission time of a byte.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   ebs_initAfterPowerUp
+ *   ebs_mapEvents
+ *   ebs_sendEvent
+ *   ebs_getDiagnosis
+ *   ISR(USART1_RX_vect)
+ *   ISR(USART1_UDRE_vect)
+ * Local functions
+ *   getNoFreeBytes
+ *   computeChecksum
+ *   writeFrame
+ *   sendFrame
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "ebs_eventBus.h"
+
+#if RTOS_USE_EVENT_BUS == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR != RTOS_FEATURE_ON
+# error The event bus requires RTOS_USE_SEND_EVENT_FROM_ISR to be set to RTOS_FEATURE_ON
+#endif
+
+#ifndef UDR1
+# error The event bus requires a CPU with USART1, e.g. the ATmega2560 or ATmega1284P
+#endif
+
+#if EBS_SIZE_OF_TX_BUFFER < 8  ||  EBS_SIZE_OF_TX_BUFFER > 128 \
+    ||  (EBS_SIZE_OF_TX_BUFFER & (EBS_SIZE_OF_TX_BUFFER-1)) != 0
+# error The size of the transmit buffer needs to be a power of two in the range 8..128
+#endif
+#if EBS_MAX_NO_ROUTES < 1  ||  EBS_MAX_NO_ROUTES > 16
+# error The maximum number of routes needs to be in the range 1..16
+#endif
+
+/** The first byte of each frame. The receiver synchronizes with the frames by waiting
+    for this byte. */
+#define FRAME_SYNC          0xa5
+
+/** The number of bytes of the event vector in a frame. */
+#define NO_EVENT_BYTES      (RTOS_EVENT_VECTOR_BITS/8)
+
+/** The number of bytes of a frame: Synchronization, address, event vector and checksum. */
+#define SIZE_OF_FRAME       (2+NO_EVENT_BYTES+1)
+
+/** The address byte of a frame holds the source node ID in the high and the destination
+    node ID in the low nibble. */
+#define MAKE_ADDRESS(srcNodeId, dstNodeId) ((uint8_t)((srcNodeId)<<4 | (dstNodeId)))
+
+/** Increment a diagnostic counter, which saturates at its maximum. */
+#define INC_SATURATED(cnt)  {if(++(cnt) == 0) --(cnt);}
+
+
+/*
+ * Local type definitions
+ */
+
+/** A route maps a set of events to a remote node. */
+typedef struct route_t
+{
+    /** The events, which are sent to the node. */
+    uintEventVec_t eventMask;
+
+    /** The ID of the destination node or #EBS_NODE_BROADCAST. */
+    uint8_t dstNodeId;
+
+} route_t;
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The ID of this node. */
+static uint8_t _ownNodeId = 0;
+
+/** The events, which may be posted by received frames. */
+static uintEventVec_t _evtAcceptMask = 0;
+
+/** The table of routes. */
+static route_t _routeAry[EBS_MAX_NO_ROUTES];
+
+/** The number of entries in the table of routes. */
+static uint8_t _noRoutes = 0;
+
+/** The ring buffer of bytes, which are waiting for transmission. */
+static uint8_t _txBufAry[EBS_SIZE_OF_TX_BUFFER];
+
+/** The position of the next write into the buffer. The position indexes are cyclically
+    incremented and never wrapped explicitly. The number of pending bytes is their
+    difference. */
+static volatile uint8_t _idxWrite = 0;
+
+/** The position of the next byte to send. Modified by the interrupt only. */
+static volatile uint8_t _idxRead = 0;
+
+/** The event, which is posted by the interrupt to resume the waiting writers. */
+static uintEventVec_t _evtTxSpace = 0;
+
+/** Flag, which is set by a writer before it suspends itself to wait for space in the
+    buffer. The interrupt resets it and posts \a _evtTxSpace. */
+static volatile boolean _isWriterWaiting = false;
+
+/** The frame, which is being received. */
+static uint8_t _rxFrameAry[SIZE_OF_FRAME];
+
+/** The number of bytes of the frame, which have been received so far. */
+static uint8_t _noRxBytes = 0;
+
+/** The diagnostic counters. */
+static ebs_diagnosis_t _diagnosis;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the number of bytes, which can be written into the transmit buffer.
+ *   @return
+ * Get the number of free bytes.
+ */
+
+static inline uint8_t getNoFreeBytes(void)
+{
+    return EBS_SIZE_OF_TX_BUFFER - (uint8_t)(_idxWrite - _idxRead);
+
+} /* End of getNoFreeBytes */
+
+
+
+
+/**
+ * Compute the checksum of a frame.
+ *   @return
+ * Get the inverted sum of all bytes but the last one of the frame, which is the checksum
+ * itself. Inverting the sum rejects a frame of zeros.
+ *   @param frameAry
+ * The frame.
+ */
+
+static uint8_t computeChecksum(const uint8_t frameAry[])
+{
+    uint8_t sum = 0
+          , u;
+    for(u=0; u<SIZE_OF_FRAME-1; ++u)
+        sum += frameAry[u];
+
+    return ~sum;
+
+} /* End of computeChecksum */
+
+
+
+
+/**
+ * Copy a frame into the transmit buffer and start the transmission.
+ *   @param frameAry
+ * The frame.
+ *   @remark
+ * The function must be called with globally locked interrupts and only if there's space
+ * for the frame.
+ */
+
+static void writeFrame(const uint8_t frameAry[])
+{
+    ASSERT(getNoFreeBytes() >= SIZE_OF_FRAME);
+
+    uint8_t idxWrite = _idxWrite
+          , u;
+    for(u=0; u<SIZE_OF_FRAME; ++u)
+    {
+        _txBufAry[idxWrite & (EBS_SIZE_OF_TX_BUFFER-1)] = frameAry[u];
+        ++ idxWrite;
+    }
+    _idxWrite = idxWrite;
+
+    /* Start the transmission. If it is already running, this doesn't do any harm. */
+    UCSR1B |= _BV(UDRIE1);
+
+} /* End of writeFrame */
+
+
+
+
+/**
+ * Send a set of events to a remote node. If the transmit buffer is full, the calling task
+ * is suspended until there's space for the frame.
+ *   @param dstNodeId
+ * The ID of the destination node or #EBS_NODE_BROADCAST.
+ *   @param eventVec
+ * The events to post on the remote node.
+ */
+
+static void sendFrame(uint8_t dstNodeId, uintEventVec_t eventVec)
+{
+    uint8_t frameAry[SIZE_OF_FRAME]
+          , u;
+    frameAry[0] = FRAME_SYNC;
+    frameAry[1] = MAKE_ADDRESS(_ownNodeId, dstNodeId);
+    for(u=0; u<NO_EVENT_BYTES; ++u)
+    {
+        frameAry[2+u] = (uint8_t)eventVec;
+        eventVec >>= 8;
+    }
+    frameAry[SIZE_OF_FRAME-1] = computeChecksum(frameAry);
+
+    while(true)
+    {
+        /* The check of free space and setting the flag need to be atomic with respect to
+           the interrupt. The global interrupt lock is released by the kernel when the task
+           is suspended. */
+        cli();
+        if(getNoFreeBytes() >= SIZE_OF_FRAME)
+            break;
+
+        if(rtos_getIdxActiveTask() == RTOS_NO_TASKS)
+        {
+            /* The idle task must not suspend; it busy-waits for the interrupt. */
+            sei();
+        }
+        else
+        {
+            _isWriterWaiting = true;
+            rtos_waitForEvent(_evtTxSpace, /* all */ false, /* timeout */ 0);
+        }
+    }
+
+    writeFrame(frameAry);
+    sei();
+
+} /* End of sendFrame */
+
+
+
+
+/**
+ * Initialize the event bus. This needs to be done once prior to the start of the kernel,
+ * e.g. in setup(). The serial port USART1 is configured for 8 data bits, no parity and
+ * one stop bit; receiver and transmitter are enabled.
+ *   @param ownNodeId
+ * The ID of this node in the range 0..#EBS_MAX_NODE_ID. The IDs of all nodes of a ring
+ * need to be different.
+ *   @param baudRate
+ * The Baud rate, e.g. 115200. All nodes of a ring need to use the same Baud rate.
+ *   @param evtAcceptMask
+ * The set of events, which may be posted on this node by received frames. Other events
+ * of a received frame are ignored. Only normal, broadcasted events should be accepted;
+ * neither timer events nor mutexes are permitted.
+ *   @param evtTxSpace
+ * The event, which is used to resume the tasks, which wait for space in the transmit
+ * buffer. It needs to be a normal, broadcasted event, neither a semaphore, nor a mutex,
+ * nor a timer event. The tasks must not use it for other purposes.
+ */
+
+void ebs_initAfterPowerUp( uint8_t ownNodeId
+                         , uint32_t baudRate
+                         , uintEventVec_t evtAcceptMask
+                         , uintEventVec_t evtTxSpace
+                         )
+{
+    ASSERT(ownNodeId <= EBS_MAX_NODE_ID  &&  baudRate > 0);
+    ASSERT((evtAcceptMask & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0);
+    ASSERT(evtTxSpace != 0
+           &&  (evtTxSpace & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+           &&  (evtTxSpace & evtAcceptMask) == 0
+          );
+
+    _ownNodeId = ownNodeId;
+    _evtAcceptMask = evtAcceptMask;
+    _noRoutes = 0;
+    _idxWrite = 0;
+    _idxRead = 0;
+    _evtTxSpace = evtTxSpace;
+    _isWriterWaiting = false;
+    _noRxBytes = 0;
+    memset(&_diagnosis, 0, sizeof(_diagnosis));
+
+    /* Double speed mode. The divider is rounded to the nearest integer. */
+    UCSR1A = _BV(U2X1);
+    UBRR1 = (uint16_t)(((F_CPU / 4 / baudRate) - 1) / 2);
+
+    /* 8 data bits, no parity, one stop bit. The receive interrupt is enabled at once, the
+       transmit interrupt as soon as there's something to send. */
+    UCSR1C = _BV(UCSZ11) | _BV(UCSZ10);
+    UCSR1B = _BV(RXCIE1) | _BV(RXEN1) | _BV(TXEN1);
+
+} /* End of ebs_initAfterPowerUp */
+
+
+
+
+/**
+ * Map a set of events to a remote node. ebs_sendEvent will send these events to the node
+ * instead of posting them on this node. If the same node is mapped several times, then
+ * the sets of events are merged.
+ *   @param eventMask
+ * The set of events. They should be ordinary, broadcasted events of the remote node,
+ * which is configured to accept them; see ebs_initAfterPowerUp. An event can't be mapped
+ * to more than one node; map it to the pseudo node #EBS_NODE_BROADCAST instead.
+ *   @param dstNodeId
+ * The ID of the remote node or #EBS_NODE_BROADCAST to address all other nodes of the
+ * ring. Specifying the own node ID is possible; the events go once around the ring and
+ * hence test the ring.
+ *   @remark
+ * The routes must be configured after ebs_initAfterPowerUp and prior to the start of the
+ * kernel.
+ */
+
+void ebs_mapEvents(uintEventVec_t eventMask, uint8_t dstNodeId)
+{
+    ASSERT(dstNodeId <= EBS_MAX_NODE_ID  ||  dstNodeId == EBS_NODE_BROADCAST);
+    ASSERT(eventMask != 0
+           &&  (eventMask & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+
+    uint8_t idxRoute;
+    for(idxRoute=0; idxRoute<_noRoutes; ++idxRoute)
+    {
+        ASSERT(_routeAry[idxRoute].dstNodeId == dstNodeId
+               ||  (_routeAry[idxRoute].eventMask & eventMask) == 0
+              );
+        if(_routeAry[idxRoute].dstNodeId == dstNodeId)
+        {
+            _routeAry[idxRoute].eventMask |= eventMask;
+            return;
+        }
+    }
+
+    ASSERT(_noRoutes < EBS_MAX_NO_ROUTES);
+    _routeAry[_noRoutes].eventMask = eventMask;
+    _routeAry[_noRoutes].dstNodeId = dstNodeId;
+    ++ _noRoutes;
+
+} /* End of ebs_mapEvents */
+
+
+
+
+/**
+ * Post a set of events. The events, which are mapped to a remote node, are sent to this
+ * node, see ebs_mapEvents. All other events are posted on this node by rtos_sendEvent.
+ *   @param eventVec
+ * The set of events to post.
+ *   @remark
+ * The function returns after the frames have been written into the transmit buffer. The
+ * remote tasks are resumed a few bytes times later. If the transmit buffer is full, the
+ * calling task is suspended until there's space. If the events, which are posted on this
+ * node, resume a task of higher priority, then this task is suspended, too.
+ *   @remark
+ * The function is called from a task or the idle task. It globally enables the
+ * interrupts; it must not be called inside a critical section or from an interrupt
+ * service routine.
+ */
+
+void ebs_sendEvent(uintEventVec_t eventVec)
+{
+    uint8_t idxRoute;
+    for(idxRoute=0; idxRoute<_noRoutes; ++idxRoute)
+    {
+        const uintEventVec_t remoteEventVec = eventVec & _routeAry[idxRoute].eventMask;
+        if(remoteEventVec != 0)
+        {
+            sendFrame(_routeAry[idxRoute].dstNodeId, remoteEventVec);
+            eventVec &= ~remoteEventVec;
+        }
+    }
+
+    if(eventVec != 0)
+        rtos_sendEvent(eventVec);
+
+} /* End of ebs_sendEvent */
+
+
+
+
+/**
+ * Get the diagnostic counters of the event bus.
+ *   @param pDiagnosis
+ * The counters are copied into * \a pDiagnosis.
+ */
+
+void ebs_getDiagnosis(ebs_diagnosis_t *pDiagnosis)
+{
+    cli();
+    *pDiagnosis = _diagnosis;
+    sei();
+
+} /* End of ebs_getDiagnosis */
+
+
+
+
+/**
+ * The interrupt "receive complete" of USART1. It collects the bytes of a frame. The
+ * events of a complete frame, which is addressed to this node, are posted and all other
+ * frames are forwarded to the next node of the ring.
+ */
+
+ISR(USART1_RX_vect)
+{
+    /* The status needs to be read before the data register. */
+    const uint8_t status = UCSR1A;
+    const uint8_t byte = UDR1;
+
+    if((status & (_BV(FE1) | _BV(DOR1) | _BV(UPE1))) != 0)
+    {
+        /* A framing error or a lost byte: Discard the frame and synchronize with the next
+           one. */
+        if(_noRxBytes > 0)
+            INC_SATURATED(_diagnosis.noFramesCorrupted);
+        _noRxBytes = 0;
+        return;
+    }
+
+    if(_noRxBytes == 0  &&  byte != FRAME_SYNC)
+        return;
+
+    _rxFrameAry[_noRxBytes] = byte;
+    if(++_noRxBytes < SIZE_OF_FRAME)
+        return;
+    _noRxBytes = 0;
+
+    if(computeChecksum(_rxFrameAry) != _rxFrameAry[SIZE_OF_FRAME-1])
+    {
+        INC_SATURATED(_diagnosis.noFramesCorrupted);
+        return;
+    }
+
+    const uint8_t srcNodeId = _rxFrameAry[1] >> 4
+                , dstNodeId = _rxFrameAry[1] & 0x0f;
+
+    /* A frame, which has travelled the complete ring, is discarded. Only a frame, which
+       the node has sent to itself, is expected back. */
+    if(srcNodeId == _ownNodeId  &&  dstNodeId != _ownNodeId)
+        return;
+
+    if(dstNodeId == _ownNodeId  ||  dstNodeId == EBS_NODE_BROADCAST)
+    {
+        uintEventVec_t eventVec = 0;
+        int8_t u;
+        for(u=NO_EVENT_BYTES-1; u>=0; --u)
+            eventVec = eventVec << 8 | _rxFrameAry[2+u];
+
+        INC_SATURATED(_diagnosis.noFramesRx);
+        eventVec &= _evtAcceptMask;
+        if(eventVec != 0)
+            rtos_sendEventFromISR(eventVec);
+    }
+
+    if(dstNodeId != _ownNodeId)
+    {
+        /* The interrupt can't wait for space in the transmit buffer. */
+        if(getNoFreeBytes() >= SIZE_OF_FRAME)
+        {
+            writeFrame(_rxFrameAry);
+            INC_SATURATED(_diagnosis.noFramesForwarded);
+        }
+        else
+            INC_SATURATED(_diagnosis.noFramesLost);
+    }
+
+    /* If a task of higher priority has been resumed, then the kernel switches to it
+       now. */
+    rtos_leaveISR();
+
+} /* End of ISR(USART1_RX_vect) */
+
+
+
+
+/**
+ * The interrupt "data register empty" of USART1. It transmits the next byte from the
+ * buffer or disables itself if the buffer is empty. When there's space for another frame,
+ * the waiting writers are resumed.
+ */
+
+ISR(USART1_UDRE_vect)
+{
+    const uint8_t idxRead = _idxRead;
+    if(idxRead == _idxWrite)
+    {
+        /* Buffer is empty, stop the interrupt till the next write. */
+        UCSR1B &= ~_BV(UDRIE1);
+    }
+    else
+    {
+        UDR1 = _txBufAry[idxRead & (EBS_SIZE_OF_TX_BUFFER-1)];
+        _idxRead = idxRead + 1;
+    }
+
+    if(_isWriterWaiting  &&  getNoFreeBytes() >= SIZE_OF_FRAME)
+    {
+        _isWriterWaiting = false;
+        rtos_sendEventFromISR(_evtTxSpace);
+    }
+
+    /* If a writer of higher priority has been resumed, then the kernel switches to it
+       now. */
+    rtos_leaveISR();
+
+} /* End of ISR(USART1_UDRE_vect) */
+
+#endif /* RTOS_USE_EVENT_BUS == RTOS_FEATURE_ON */
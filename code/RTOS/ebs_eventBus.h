@@ -0,0 +1,104 @@
+#ifndef EBS_EVENT_BUS_INCLUDED
+#define EBS_EVENT_BUS_INCLUDED
+/**
+ * @file ebs_eventBus.h
+ * Definition of global interface of module ebs_eventBus.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The size of the transmit buffer in Byte. It needs to be a power of two in the range
+    8..128. A frame has 5 Byte or 7 Byte with a 32 Bit event vector. The application may
+    override the default in its rtos.config.h. */
+#ifndef EBS_SIZE_OF_TX_BUFFER
+# define EBS_SIZE_OF_TX_BUFFER  32
+#endif
+
+/** The maximum number of routes, which map a set of events to a remote node, see
+    ebs_mapEvents. The application may override the default in its rtos.config.h. */
+#ifndef EBS_MAX_NO_ROUTES
+# define EBS_MAX_NO_ROUTES  4
+#endif
+
+/** The highest node ID. The nodes of the bus are numbered 0..#EBS_MAX_NODE_ID. */
+#define EBS_MAX_NODE_ID     14
+
+/** The pseudo node ID, which addresses all other nodes of the bus. */
+#define EBS_NODE_BROADCAST  15
+
+
+/*
+ * Global type definitions
+ */
+
+/** The diagnostic counters of the event bus. All counters saturate at their maximum. */
+typedef struct ebs_diagnosis_t
+{
+    /** The number of received frames, whose events have been posted on this node. */
+    uint16_t noFramesRx;
+
+    /** The number of received frames, which have been forwarded to the next node. */
+    uint16_t noFramesForwarded;
+
+    /** The number of received frames, which have been discarded because of a bad checksum
+        or a UART error. */
+    uint8_t noFramesCorrupted;
+
+    /** The number of frames to forward, which have been lost because the transmit buffer
+        was full. */
+    uint8_t noFramesLost;
+
+} ebs_diagnosis_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize the event bus and its UART prior to the start of the kernel. */
+void ebs_initAfterPowerUp( uint8_t ownNodeId
+                         , uint32_t baudRate
+                         , uintEventVec_t evtAcceptMask
+                         , uintEventVec_t evtTxSpace
+                         );
+
+/** Map a set of events to a remote node. */
+void ebs_mapEvents(uintEventVec_t eventMask, uint8_t dstNodeId);
+
+/** Post a set of events, mapped events are sent to their remote node. */
+void ebs_sendEvent(uintEventVec_t eventVec);
+
+/** Get the diagnostic counters of the event bus. */
+void ebs_getDiagnosis(ebs_diagnosis_t *pDiagnosis);
+
+
+#endif  /* EBS_EVENT_BUS_INCLUDED */
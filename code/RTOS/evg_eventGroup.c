@@ -0,0 +1,263 @@
+/**
+ * @file evg_eventGroup.c
+ *   Implementation of event groups. An event group is a set of 16 flags. Any task can set
+ * or clear flags and a single task can wait until all or any of a subset of the flags are
+ * set. The flags are independent of the events of the kernel; an application can have as
+ * many event groups as it likes, e.g., one per barrier of a multi-producer
+ * synchronization. Each group needs a single kernel event to resume its waiting task.\n
+ *   The condition of the waiting task is not re-evaluated by the kernel on every posted
+ * event. The group keeps the vector of flags, which the waiter still expects. Each setting
+ * of flags clears the related bits and a single compare with zero tells whether the
+ * condition is fulfilled. Only then the waiting task is resumed, by one kernel call. Any
+ * number of tasks may contribute flags while the waiter stays suspended without
+ * consuming CPU time.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   evg_initEventGroup
+ *   evg_setFlags
+ *   evg_clearFlags
+ *   evg_getFlags
+ *   evg_waitForFlags
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "evg_eventGroup.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize an event group object. This needs to be done once before the group is used,
+ * e.g. in setup(). All flags are initially cleared.
+ *   @param pEventGroup
+ * The event group object to initialize.
+ *   @param evtFlags
+ * The event used to resume the waiting task when its condition is fulfilled. It needs to
+ * be a normal, broadcasted event, neither a semaphore, nor a mutex, nor a timer event.
+ * The waiting task must not use it for other purposes.
+ */
+
+void evg_initEventGroup(evg_eventGroup_t * const pEventGroup, uintEventVec_t evtFlags)
+{
+    ASSERT(evtFlags != 0  &&  (evtFlags & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0);
+
+    pEventGroup->flagVec = 0;
+    pEventGroup->remainingFlagVec = 0;
+    pEventGroup->evtFlags = evtFlags;
+    pEventGroup->waitForAllFlags = false;
+    pEventGroup->isWaiterWaiting = false;
+
+} /* End of evg_initEventGroup */
+
+
+
+
+/**
+ * Set some flags of an event group. If this fulfills the condition of the waiting task,
+ * it's resumed. If it has a higher priority than the calling task, it becomes active
+ * immediately.
+ *   @param pEventGroup
+ * The event group object.
+ *   @param flagVec
+ * The flags to set. Flags, which are already set, remain set.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void evg_setFlags(evg_eventGroup_t * const pEventGroup, evg_flagVec_t flagVec)
+{
+    cli();
+    pEventGroup->flagVec |= flagVec;
+    if(pEventGroup->isWaiterWaiting)
+    {
+        const evg_flagVec_t remainingFlagVec = pEventGroup->remainingFlagVec
+                          , newRemainingFlagVec = remainingFlagVec & ~flagVec;
+        pEventGroup->remainingFlagVec = newRemainingFlagVec;
+
+        if(newRemainingFlagVec == 0
+           ||  (!pEventGroup->waitForAllFlags  &&  newRemainingFlagVec != remainingFlagVec)
+          )
+        {
+            /* The kernel call releases the global interrupt lock; the waiting task can't
+               see the event without seeing the flags. */
+            pEventGroup->isWaiterWaiting = false;
+            rtos_sendEvent(pEventGroup->evtFlags);
+            return;
+        }
+    }
+    sei();
+
+} /* End of evg_setFlags */
+
+
+
+
+/**
+ * Clear some flags of an event group.
+ *   @param pEventGroup
+ * The event group object.
+ *   @param flagVec
+ * The flags to clear.
+ *   @remark
+ * The flags, which the waiting task still expects, are not affected: A flag, which has
+ * been set and cleared again while the task is waiting, counts as received and may resume
+ * the task. evg_waitForFlags however evaluates the flags, which are set when the task is
+ * resumed, and it may then return 0 as for a timeout.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void evg_clearFlags(evg_eventGroup_t * const pEventGroup, evg_flagVec_t flagVec)
+{
+    cli();
+    pEventGroup->flagVec &= ~flagVec;
+    sei();
+
+} /* End of evg_clearFlags */
+
+
+
+
+/**
+ * Get the currently set flags of an event group. The function doesn't block.
+ *   @return
+ * The vector of set flags.
+ *   @param pEventGroup
+ * The event group object.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+evg_flagVec_t evg_getFlags(const evg_eventGroup_t * const pEventGroup)
+{
+    /* Reading a 16 Bit word is not atomic on the AVR. */
+    cli();
+    const evg_flagVec_t flagVec = pEventGroup->flagVec;
+    sei();
+
+    return flagVec;
+
+} /* End of evg_getFlags */
+
+
+
+
+/**
+ * Wait until all or any of a set of flags of an event group are set. If the condition is
+ * not fulfilled yet, then the calling task is suspended until it is fulfilled or until
+ * the timeout elapses.\n
+ *   The function must be called only by one task per event group. It must not be called
+ * by the idle task.
+ *   @return
+ * The flags out of \a flagMask, which are set, or 0 in case of a timeout.
+ *   @param pEventGroup
+ * The event group object.
+ *   @param flagMask
+ * The flags to wait for. At least one flag needs to be specified.
+ *   @param all
+ * If true, the task waits until all flags of \a flagMask are set. Otherwise it waits for
+ * the first of them.
+ *   @param clearOnExit
+ * If true and if the condition is fulfilled, then the returned flags are cleared before
+ * the function returns. This is the typical behavior of a barrier, which is passed
+ * repeatedly.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+evg_flagVec_t evg_waitForFlags( evg_eventGroup_t * const pEventGroup
+                              , evg_flagVec_t flagMask
+                              , boolean all
+                              , boolean clearOnExit
+                              , uintTime_t timeout
+                              )
+{
+    ASSERT(flagMask != 0);
+
+    /* The check of the condition and setting the flags need to be atomic with respect to
+       the setting tasks. The global interrupt lock is released by the kernel when the task
+       is suspended. */
+    cli();
+    const evg_flagVec_t remainingFlagVec = flagMask & ~pEventGroup->flagVec;
+    if(remainingFlagVec == flagMask  ||  (all  &&  remainingFlagVec != 0))
+    {
+        pEventGroup->remainingFlagVec = remainingFlagVec;
+        pEventGroup->waitForAllFlags = all;
+        pEventGroup->isWaiterWaiting = true;
+        if((rtos_waitForEvent(pEventGroup->evtFlags | RTOS_EVT_DELAY_TIMER, /* all */ false, timeout)
+            & pEventGroup->evtFlags
+           ) == 0
+          )
+        {
+            /* Timeout. A task may have set the last flag in the same tic. */
+            pEventGroup->isWaiterWaiting = false;
+        }
+        cli();
+    }
+
+    const evg_flagVec_t setFlagVec = pEventGroup->flagVec & flagMask;
+    boolean isFulfilled;
+    if(all)
+        isFulfilled = setFlagVec == flagMask;
+    else
+        isFulfilled = setFlagVec != 0;
+    if(isFulfilled  &&  clearOnExit)
+        pEventGroup->flagVec &= ~setFlagVec;
+    sei();
+
+    return isFulfilled? setFlagVec: 0;
+
+} /* End of evg_waitForFlags */
@@ -0,0 +1,100 @@
+#ifndef EVG_EVENT_GROUP_INCLUDED
+#define EVG_EVENT_GROUP_INCLUDED
+/**
+ * @file evg_eventGroup.h
+ * Definition of global interface of module evg_eventGroup.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+/** A vector of the flags of an event group. */
+typedef uint16_t evg_flagVec_t;
+
+/** An event group is a set of 16 flags, which are set by any number of tasks and which a
+    single task can wait for, either for all or for any of a subset. The flags are not
+    related to the kernel's events, an application can have any number of event groups.
+    The object is owned by the application but it must be accessed only through the
+    functions of this module. */
+typedef struct evg_eventGroup_t
+{
+    /** The currently set flags. */
+    volatile evg_flagVec_t flagVec;
+
+    /** The flags, which the waiting task still expects. Bits are cleared as the flags are
+        set. Is only valid if \a isWaiterWaiting is true. */
+    volatile evg_flagVec_t remainingFlagVec;
+
+    /** The kernel event, which is posted to the waiting task when its condition is
+        fulfilled. */
+    uintEventVec_t evtFlags;
+
+    /** The waiting task waits for all of the flags it had once put into \a
+        remainingFlagVec. Otherwise it waits for the first of them. */
+    boolean waitForAllFlags;
+
+    /** Flag, which is set by the waiting task before it suspends itself. */
+    volatile boolean isWaiterWaiting;
+
+} evg_eventGroup_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize an event group object prior to its first use. */
+void evg_initEventGroup(evg_eventGroup_t *pEventGroup, uintEventVec_t evtFlags);
+
+/** Set some flags and resume the waiting task if its condition is fulfilled. */
+void evg_setFlags(evg_eventGroup_t *pEventGroup, evg_flagVec_t flagVec);
+
+/** Clear some flags. */
+void evg_clearFlags(evg_eventGroup_t *pEventGroup, evg_flagVec_t flagVec);
+
+/** Get the currently set flags. */
+evg_flagVec_t evg_getFlags(const evg_eventGroup_t *pEventGroup);
+
+/** Wait for all or any of a set of flags. */
+evg_flagVec_t evg_waitForFlags( evg_eventGroup_t *pEventGroup
+                              , evg_flagVec_t flagMask
+                              , boolean all
+                              , boolean clearOnExit
+                              , uintTime_t timeout
+                              );
+
+
+#endif  /* EVG_EVENT_GROUP_INCLUDED */
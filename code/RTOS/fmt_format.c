@@ -0,0 +1,435 @@
+/**
+ * @file fmt_format.c
+ *   A set of small, type specific formatters, which replace printf & co for the typical
+ * output of an embedded application: integers, fixed-point numbers and padded strings.\n
+ *   The avr-libc implementation of printf is a format interpreter, vfprintf. It is linked
+ * completely, regardless which format characters an application actually uses; it costs a
+ * few kByte of flash ROM and about 100 Byte of stack in each task, which does formatted
+ * output. The formatters of this module are chosen by the caller at compile time instead.
+ * Each of them only links what it needs, uses a few Byte of stack and takes some ten
+ * microseconds, mainly for the divisions by ten.\n
+ *   All functions write into a buffer, which is owned by the caller, e.g. a line of the
+ * display or a chunk for the serial output. They terminate the string and return the
+ * pointer to the terminating zero so that calls can be chained to compose a line:\n
+ *   char line[17], *p = line;\n
+ *   p = fmt_uint16(p, hour, 2, '0');\n
+ *   *p++ = ':';\n
+ *   p = fmt_uint16(p, min, 2, '0');\n
+ * The functions don't have a static state; they are reentrant and can be used by several
+ * tasks at a time.
+ *   @remark
+ * The functions don't know the size of the buffer. The caller needs to ensure that the
+ * buffer can hold the maximum number of characters plus the terminating zero. An integer
+ * requires at most #FMT_MAX_NO_DIGITS characters plus padding.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   fmt_uint16
+ *   fmt_uint32
+ *   fmt_int16
+ *   fmt_int32
+ *   fmt_hex
+ *   fmt_fixPoint
+ *   fmt_string
+ * Local functions
+ *   emitDigits
+ *   collectDigits
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos_assert.h"
+#include "fmt_format.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Write the digits of a number, which have been collected in reverse order, to the output
+ * buffer, with leading padding characters and optional sign.
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer.
+ *   @param pDigitsEnd
+ * The digits have been collected in reverse order, the least significant digit first. The
+ * pointer points behind the most significant digit.
+ *   @param noDigits
+ * The number of digits in the reversed buffer.
+ *   @param isNegative
+ * If true, a minus sign is put in front of the digits.
+ *   @param minWidth
+ * The minimum number of characters, including the sign.
+ *   @param padChar
+ * The padding character. If it is '0', the padding is put between sign and digits,
+ * otherwise in front of the sign.
+ */
+
+static char *emitDigits( char *pBuf
+                       , const char *pDigitsEnd
+                       , uint8_t noDigits
+                       , boolean isNegative
+                       , uint8_t minWidth
+                       , char padChar
+                       )
+{
+    uint8_t noChars = noDigits + (isNegative? 1: 0);
+
+    if(isNegative  &&  padChar == '0')
+        *pBuf++ = '-';
+    for(; noChars < minWidth; ++noChars)
+        *pBuf++ = padChar;
+    if(isNegative  &&  padChar != '0')
+        *pBuf++ = '-';
+
+    while(noDigits-- > 0)
+        *pBuf++ = *--pDigitsEnd;
+    *pBuf = '\0';
+
+    return pBuf;
+
+} /* End of emitDigits */
+
+
+
+
+/**
+ * Collect the decimal digits of a 32 Bit number in reverse order.
+ *   @return
+ * Get the number of digits, 1..10.
+ *   @param digitAry
+ * The digits are written into this array, the least significant digit first. It needs to
+ * have room for 10 characters.
+ *   @param value
+ * The number to convert.
+ */
+
+static uint8_t collectDigits(char digitAry[], uint32_t value)
+{
+    uint8_t noDigits = 0;
+
+    /* The expensive 32 Bit division is only used as long as the remaining value doesn't
+       fit into 16 Bit. */
+    while(value > 0xffffu)
+    {
+        digitAry[noDigits++] = '0' + (char)(value % 10u);
+        value /= 10u;
+    }
+    uint16_t value16 = (uint16_t)value;
+    do
+    {
+        digitAry[noDigits++] = '0' + (char)(value16 % 10u);
+        value16 /= 10u;
+    }
+    while(value16 != 0);
+
+    return noDigits;
+
+} /* End of collectDigits */
+
+
+
+
+/**
+ * Format an unsigned 16 Bit integer as decimal number. The function behaves like
+ * sprintf(pBuf, "%*u", minWidth, value) or, if \a padChar is '0', like "%0*u".
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(5, \a minWidth) characters plus the
+ * terminating zero.
+ *   @param value
+ * The number to print.
+ *   @param minWidth
+ * The minimum number of characters. Shorter numbers are padded at the left.
+ *   @param padChar
+ * The padding character, typically a blank or '0'.
+ */
+
+char *fmt_uint16(char *pBuf, uint16_t value, uint8_t minWidth, char padChar)
+{
+    /* 16 Bit arithmetics is significantly faster on the AVR. */
+    char digitAry[5];
+    uint8_t noDigits = 0;
+    do
+    {
+        digitAry[noDigits++] = '0' + (char)(value % 10u);
+        value /= 10u;
+    }
+    while(value != 0);
+
+    return emitDigits( pBuf
+                     , &digitAry[noDigits]
+                     , noDigits
+                     , /* isNegative */ false
+                     , minWidth
+                     , padChar
+                     );
+} /* End of fmt_uint16 */
+
+
+
+
+/**
+ * Format an unsigned 32 Bit integer as decimal number. The function behaves like
+ * sprintf(pBuf, "%*lu", minWidth, value) or, if \a padChar is '0', like "%0*lu".
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(10, \a minWidth) characters plus the
+ * terminating zero.
+ *   @param value
+ * The number to print.
+ *   @param minWidth
+ * The minimum number of characters. Shorter numbers are padded at the left.
+ *   @param padChar
+ * The padding character, typically a blank or '0'.
+ */
+
+char *fmt_uint32(char *pBuf, uint32_t value, uint8_t minWidth, char padChar)
+{
+    char digitAry[10];
+    const uint8_t noDigits = collectDigits(digitAry, value);
+
+    return emitDigits( pBuf
+                     , &digitAry[noDigits]
+                     , noDigits
+                     , /* isNegative */ false
+                     , minWidth
+                     , padChar
+                     );
+} /* End of fmt_uint32 */
+
+
+
+
+/**
+ * Format a signed 16 Bit integer as decimal number. The function behaves like
+ * sprintf(pBuf, "%*d", minWidth, value).
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(6, \a minWidth) characters plus the
+ * terminating zero.
+ *   @param value
+ * The number to print.
+ *   @param minWidth
+ * The minimum number of characters including the sign. Shorter numbers are padded with
+ * blanks at the left.
+ */
+
+char *fmt_int16(char *pBuf, int16_t value, uint8_t minWidth)
+{
+    char digitAry[5];
+    uint8_t noDigits = 0;
+
+    /* The negation is done in unsigned arithmetics to handle INT16_MIN, too. */
+    uint16_t absValue = value < 0? 0u - (uint16_t)value: (uint16_t)value;
+    do
+    {
+        digitAry[noDigits++] = '0' + (char)(absValue % 10u);
+        absValue /= 10u;
+    }
+    while(absValue != 0);
+
+    return emitDigits( pBuf
+                     , &digitAry[noDigits]
+                     , noDigits
+                     , /* isNegative */ value < 0
+                     , minWidth
+                     , /* padChar */ ' '
+                     );
+} /* End of fmt_int16 */
+
+
+
+
+/**
+ * Format a signed 32 Bit integer as decimal number. The function behaves like
+ * sprintf(pBuf, "%*ld", minWidth, value).
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(#FMT_MAX_NO_DIGITS, \a minWidth)
+ * characters plus the terminating zero.
+ *   @param value
+ * The number to print.
+ *   @param minWidth
+ * The minimum number of characters including the sign. Shorter numbers are padded with
+ * blanks at the left.
+ */
+
+char *fmt_int32(char *pBuf, int32_t value, uint8_t minWidth)
+{
+    /* The negation is done in unsigned arithmetics to handle INT32_MIN, too. */
+    char digitAry[10];
+    const uint8_t noDigits = collectDigits( digitAry
+                                          , value < 0? 0u - (uint32_t)value: (uint32_t)value
+                                          );
+    return emitDigits( pBuf
+                     , &digitAry[noDigits]
+                     , noDigits
+                     , /* isNegative */ value < 0
+                     , minWidth
+                     , /* padChar */ ' '
+                     );
+} /* End of fmt_int32 */
+
+
+
+
+/**
+ * Format an unsigned integer as hexadecimal number with a fixed number of digits. The
+ * function behaves like sprintf(pBuf, "%0*lx", noDigits, value), except that higher
+ * digits are truncated if the value doesn't fit.
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for \a noDigits characters plus the
+ * terminating zero.
+ *   @param value
+ * The number to print.
+ *   @param noDigits
+ * The number of hexadecimal digits, 1..8.
+ */
+
+char *fmt_hex(char *pBuf, uint32_t value, uint8_t noDigits)
+{
+    ASSERT(noDigits >= 1  &&  noDigits <= 8);
+
+    char *pDigit = pBuf + noDigits;
+    *pDigit = '\0';
+    do
+    {
+        const uint8_t nibble = (uint8_t)value & 0x0f;
+        *--pDigit = nibble < 10? '0' + nibble: 'a' - 10 + nibble;
+        value >>= 4;
+    }
+    while(pDigit != pBuf);
+
+    return pBuf + noDigits;
+
+} /* End of fmt_hex */
+
+
+
+
+/**
+ * Format a fixed-point number. The binary value is the represented number multiplied with
+ * a power of ten, e.g. a voltage in mV is a fixed-point number with three fractional
+ * digits if it is to be printed in Volt. No floating point operations are involved.
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(11, \a minWidth) characters plus the
+ * terminating zero.
+ *   @param value
+ * The number to print as integer, which is 10^\a noFractionalDigits times the represented
+ * value.
+ *   @param noFractionalDigits
+ * The number of decimal digits behind the decimal point, 0..4. If 0, the number is printed
+ * as an integer without decimal point.
+ *   @param minWidth
+ * The minimum number of characters including the decimal point. Shorter numbers are padded
+ * with blanks at the left.
+ */
+
+char *fmt_fixPoint( char *pBuf
+                  , uint32_t value
+                  , uint8_t noFractionalDigits
+                  , uint8_t minWidth
+                  )
+{
+    ASSERT(noFractionalDigits <= 4);
+
+    uint16_t scale = 1;
+    uint8_t u;
+    for(u=0; u<noFractionalDigits; ++u)
+        scale *= 10u;
+
+    /* Reserve the room for the fractional part in the width of the integer part. */
+    const uint8_t widthFraction = noFractionalDigits > 0? noFractionalDigits+1: 0;
+    const uint8_t widthInt = minWidth > widthFraction? minWidth - widthFraction: 1;
+
+    pBuf = fmt_uint32(pBuf, value / scale, widthInt, /* padChar */ ' ');
+    if(noFractionalDigits > 0)
+    {
+        *pBuf++ = '.';
+        pBuf = fmt_uint16(pBuf, (uint16_t)(value % scale), noFractionalDigits, '0');
+    }
+
+    return pBuf;
+
+} /* End of fmt_fixPoint */
+
+
+
+
+/**
+ * Copy a string to the output buffer and pad it with blanks at the right. The function
+ * behaves like sprintf(pBuf, "%-*s", minWidth, str).
+ *   @return
+ * Get the pointer to the terminating zero of the output.
+ *   @param pBuf
+ * The output buffer. It needs to have room for max(strlen(\a str), \a minWidth)
+ * characters plus the terminating zero.
+ *   @param str
+ * The zero terminated string to copy.
+ *   @param minWidth
+ * The minimum number of characters.
+ */
+
+char *fmt_string(char *pBuf, const char *str, uint8_t minWidth)
+{
+    uint8_t noChars = 0;
+    while(*str != '\0')
+    {
+        *pBuf++ = *str++;
+        ++ noChars;
+    }
+    for(; noChars < minWidth; ++noChars)
+        *pBuf++ = ' ';
+    *pBuf = '\0';
+
+    return pBuf;
+
+} /* End of fmt_string */
@@ -0,0 +1,79 @@
+#ifndef FMT_FORMAT_INCLUDED
+#define FMT_FORMAT_INCLUDED
+/**
+ * @file fmt_format.h
+ * Definition of global interface of module fmt_format.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include <stdint.h>
+
+
+/*
+ * Defines
+ */
+
+/** The maximum number of characters, which are written by fmt_uint32 or fmt_int32
+    including sign but without padding and terminating zero. */
+#define FMT_MAX_NO_DIGITS   11
+
+
+/*
+ * Global type definitions
+ */
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Format an unsigned 16 Bit integer as decimal number, like %<width>u or %0<width>u. */
+char *fmt_uint16(char *pBuf, uint16_t value, uint8_t minWidth, char padChar);
+
+/** Format an unsigned 32 Bit integer as decimal number, like %<width>lu or %0<width>lu. */
+char *fmt_uint32(char *pBuf, uint32_t value, uint8_t minWidth, char padChar);
+
+/** Format a signed 16 Bit integer as decimal number, like %<width>d. */
+char *fmt_int16(char *pBuf, int16_t value, uint8_t minWidth);
+
+/** Format a signed 32 Bit integer as decimal number, like %<width>ld. */
+char *fmt_int32(char *pBuf, int32_t value, uint8_t minWidth);
+
+/** Format an unsigned integer as hexadecimal number with a fixed number of digits, like
+    %0<noDigits>x. */
+char *fmt_hex(char *pBuf, uint32_t value, uint8_t noDigits);
+
+/** Format a fixed-point number, e.g. a voltage in mV as Volt. */
+char *fmt_fixPoint( char *pBuf
+                  , uint32_t value
+                  , uint8_t noFractionalDigits
+                  , uint8_t minWidth
+                  );
+
+/** Copy a string and pad it with blanks, like %-<width>s. */
+char *fmt_string(char *pBuf, const char *str, uint8_t minWidth);
+
+#endif  /* FMT_FORMAT_INCLUDED */
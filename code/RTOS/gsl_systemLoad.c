@@ -30,6 +30,7 @@
 
 #include <Arduino.h>
 #include "rtos_assert.h"
+#include "rtos.h"
 #include "gsl_systemLoad.h"
 
 
@@ -86,10 +87,46 @@
  * The function will never return if the CPU load is 100% and it might take an arbitrary
  * long time to return if it is close to 100%. The calling code must anticipate this, e.g.
  * by presetting the result variable with 100% prior to calling this function.
+ *   @remark
+ * If the kernel is configured with #RTOS_USE_IDLE_SLEEP, the function doesn't execute test
+ * code but sends the CPU to sleep for the time window. The load is all the time, which
+ * the CPU did not sleep. The execution time of the function is about 1 second regardless
+ * of the system load and the resolution of the result is better.
+ *   @remark
+ * If the kernel is configured with #RTOS_USE_CPU_LOAD_ACCOUNTING, the function returns
+ * immediately. It returns the load since its previous call, see rtos_getCpuLoad. It may
+ * then be called from any task.
  */
 
 uint8_t gsl_getSystemLoad()
 {
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    /* The kernel continuously measures the load. The time since the previous call is the
+       averaging window. */
+    return rtos_getCpuLoad(/* doReset */ true);
+
+#elif RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+    uint32_t tiStart, tiElapsed, tiSleep;
+
+    /* Reset the accumulated sleep time and sleep until the time window has elapsed. */
+    rtos_getIdleSleepTime(/* doReset */ true);
+    tiStart = micros();
+    do
+    {
+        rtos_idleSleep();
+        tiElapsed = micros() - tiStart;
+    }
+    while(tiElapsed < 1000ul*TI_WINDOW_LEN);
+    tiSleep = rtos_getIdleSleepTime(/* doReset */ false);
+
+    /* The sleep time is measured with a limited accuracy; it could become slightly greater
+       than the elapsed time. The multiplication by 200 can't overflow since the elapsed
+       time is limited to a few seconds. */
+    if(tiSleep >= tiElapsed)
+        return 0;
+    else
+        return 200 - (uint8_t)(200*tiSleep/tiElapsed);
+#else
 #define TI_STEP         16u     /* Should be a power of 2, need to <= 65 */
 
     uint32_t tiStart, tiEnd, tiEndMin;
@@ -153,8 +190,9 @@ uint8_t gsl_getSystemLoad()
            a uint8_t. */
         return 200 - (uint8_t)(200*tiStart/tiEnd);
     }
-#undef TI_WINDOW_LEN
 #undef TI_STEP      
+#endif
+#undef TI_WINDOW_LEN
 } /* End of gsl_getSystemLoad */
 
 
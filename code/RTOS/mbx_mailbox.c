@@ -0,0 +1,219 @@
+/**
+ * @file mbx_mailbox.c
+ *   Implementation of a mailbox for passing messages from one task to another one without
+ * copying them. A message is a pointer to a buffer, which is allocated by the application,
+ * e.g. statically or from a pool of memory blocks, see mpl_memoryPool.h. Posting a
+ * message passes the ownership of the buffer to the receiver; the sender must not touch
+ * it any longer. After processing, the receiver may return the buffer, e.g. through
+ * another mailbox or by freeing it in the pool.\n
+ *   The mailbox can hold a single message. The critical sections only handle the pointer
+ * to the message and are a few CPU clock cycles long regardless of the size of the
+ * message. If the receiver is waiting for a message, it is resumed in the same kernel
+ * call, which delivers the message.\n
+ *   Any task may post to a mailbox, including the idle task, but there needs to be a
+ * single receiving task per mailbox. If more than one message needs to be buffered then
+ * consider using a queue of pointers, see que_queue.h.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   mbx_initMailbox
+ *   mbx_post
+ *   mbx_fetch
+ *   mbx_fetchWait
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "mbx_mailbox.h"
+
+
+/*
+ * Defines
+ */
+ 
+ 
+/*
+ * Local type definitions
+ */
+ 
+ 
+/*
+ * Local prototypes
+ */
+ 
+ 
+/*
+ * Data definitions
+ */
+ 
+ 
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a mailbox object. This needs to be done once before the mailbox is used,
+ * e.g. in setup(). The mailbox is initially empty.
+ *   @param pMailbox
+ * The mailbox object to initialize.
+ *   @param evtMsg
+ * The event used to resume the receiver when a message is posted. It needs to be a
+ * normal, broadcasted event, neither a semaphore, nor a mutex, nor a timer event. The
+ * receiver must not use it for other purposes.
+ */
+
+void mbx_initMailbox(mbx_mailbox_t * const pMailbox, uintEventVec_t evtMsg)
+{
+    ASSERT(evtMsg != 0  &&  (evtMsg & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0);
+
+    pMailbox->pMsg = NULL;
+    pMailbox->evtMsg = evtMsg;
+    pMailbox->isReceiverWaiting = false;
+
+} /* End of mbx_initMailbox */
+
+
+
+
+/**
+ * Post a message to the mailbox. If the receiver is waiting for a message, it's resumed.
+ * Storing the message and resuming the receiver is a single, atomic operation. If the
+ * receiver has a higher priority than the calling task, it becomes active immediately.
+ *   @return
+ * The function returns false if the mailbox still holds a message, which has not been
+ * fetched by the receiver. The message is not posted in this case and the caller keeps
+ * the ownership of the message buffer.
+ *   @param pMailbox
+ * The mailbox object.
+ *   @param pMsg
+ * The message to post. NULL is not a valid message.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean mbx_post(mbx_mailbox_t * const pMailbox, void * const pMsg)
+{
+    ASSERT(pMsg != NULL);
+
+    cli();
+    if(pMailbox->pMsg != NULL)
+    {
+        sei();
+        return false;
+    }
+
+    pMailbox->pMsg = pMsg;
+    if(pMailbox->isReceiverWaiting)
+    {
+        /* The kernel call releases the global interrupt lock; the receiver can't see the
+           event without seeing the message. */
+        pMailbox->isReceiverWaiting = false;
+        rtos_sendEvent(pMailbox->evtMsg);
+    }
+    else
+        sei();
+
+    return true;
+
+} /* End of mbx_post */
+
+
+
+
+/**
+ * Take the message from the mailbox if there is any. The function doesn't block.\n
+ *   The function must be called only by the receiver of the mailbox.
+ *   @return
+ * The fetched message or NULL if the mailbox is empty. The calling task becomes the owner
+ * of the message buffer.
+ *   @param pMailbox
+ * The mailbox object.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void *mbx_fetch(mbx_mailbox_t * const pMailbox)
+{
+    void *pMsg;
+
+    /* Reading a pointer is not atomic on the AVR. */
+    cli();
+    {
+        pMsg = pMailbox->pMsg;
+        pMailbox->pMsg = NULL;
+    }
+    sei();
+
+    return pMsg;
+
+} /* End of mbx_fetch */
+
+
+
+
+/**
+ * Take the message from the mailbox. If the mailbox is empty, the calling task is
+ * suspended until a message is posted or until the timeout elapses.\n
+ *   The function must be called only by the receiver of the mailbox. It must not be
+ * called by the idle task.
+ *   @return
+ * The fetched message or NULL in case of a timeout. The calling task becomes the owner of
+ * the message buffer.
+ *   @param pMailbox
+ * The mailbox object.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void *mbx_fetchWait(mbx_mailbox_t * const pMailbox, uintTime_t timeout)
+{
+    /* The check for an empty mailbox and setting the flag need to be atomic with respect
+       to the senders. The global interrupt lock is released by the kernel when the task is
+       suspended. */
+    cli();
+    if(pMailbox->pMsg == NULL)
+    {
+        pMailbox->isReceiverWaiting = true;
+        if((rtos_waitForEvent(pMailbox->evtMsg | RTOS_EVT_DELAY_TIMER, /* all */ false, timeout)
+            & pMailbox->evtMsg
+           ) == 0
+          )
+        {
+            /* Timeout. A sender may have posted a message in the same tic. */
+            pMailbox->isReceiverWaiting = false;
+        }
+    }
+    else
+        sei();
+
+    return mbx_fetch(pMailbox);
+
+} /* End of mbx_fetchWait */
@@ -0,0 +1,80 @@
+#ifndef MBX_MAILBOX_INCLUDED
+#define MBX_MAILBOX_INCLUDED
+/**
+ * @file mbx_mailbox.h
+ * Definition of global interface of module mbx_mailbox.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+/** A mailbox, which passes the ownership of a message buffer from the sending tasks to a
+    single receiving task. The object is owned by the application but it must be accessed
+    only through the functions of this module. */
+typedef struct mbx_mailbox_t
+{
+    /** The posted message, which has not been fetched yet, or NULL if the mailbox is
+        empty. */
+    void * volatile pMsg;
+
+    /** The event, which is posted to the receiver if it waits for a message. */
+    uintEventVec_t evtMsg;
+
+    /** Flag, which is set by the receiver before it suspends itself to wait for a
+        message. */
+    volatile boolean isReceiverWaiting;
+
+} mbx_mailbox_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize a mailbox object prior to its first use. */
+void mbx_initMailbox(mbx_mailbox_t *pMailbox, uintEventVec_t evtMsg);
+
+/** Pass a message to the receiver and resume it if it waits for the message. */
+boolean mbx_post(mbx_mailbox_t *pMailbox, void *pMsg);
+
+/** Take the message from the mailbox if there is any. */
+void *mbx_fetch(mbx_mailbox_t *pMailbox);
+
+/** Take the message from the mailbox, wait for it if the mailbox is empty. */
+void *mbx_fetchWait(mbx_mailbox_t *pMailbox, uintTime_t timeout);
+
+
+#endif  /* MBX_MAILBOX_INCLUDED */
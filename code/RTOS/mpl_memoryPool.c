@@ -0,0 +1,207 @@
+/**
+ * @file mpl_memoryPool.c
+ *   Implementation of a pool of memory blocks of fixed size. The pool is a replacement of
+ * malloc and free in tasks: The allocation and release of a block requires constant time
+ * and there's no fragmentation of the memory.\n
+ *   The pool is built on a semaphore of the kernel, which counts the free blocks. If all
+ * blocks are in use, the allocating task can wait for a block with timeout. It is resumed
+ * when another task frees a block - the kernel passes the semaphore to the waiting task
+ * of highest priority.\n
+ *   The blocks can be passed between the tasks without copying their contents, e.g. by
+ * mailbox, see mbx_mailbox.h, or by a queue of pointers, see que_queue.h. Any task can
+ * free a block, not only the one, which allocated it.
+ *   @remark
+ * The module is available only if the application configures at least one semaphore, see
+ * #RTOS_NO_SEMAPHORE_EVENTS.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine. The
+ * idle task can free blocks but it can't allocate them.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   mpl_initPool
+ *   mpl_alloc
+ *   mpl_free
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "mpl_memoryPool.h"
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+ 
+ 
+/*
+ * Local type definitions
+ */
+ 
+ 
+/*
+ * Local prototypes
+ */
+ 
+ 
+/*
+ * Data definitions
+ */
+ 
+ 
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a memory pool. The memory area is split into blocks, which are linked into
+ * the list of free blocks, and the semaphore of the pool is set to the number of blocks.
+ *   @param pPool
+ * The pool object to initialize.
+ *   @param pMemoryArea
+ * The memory, which is managed by the pool. It has room for \a noBlocks blocks of \a
+ * sizeOfBlock Byte each; typically an array of the block type.
+ *   @param sizeOfBlock
+ * The size of a single block in Byte. The minimum size is the size of a pointer.
+ *   @param noBlocks
+ * The number of blocks in the pool.
+ *   @param evtSemaphore
+ * The semaphore event, which is used by the pool to count the free blocks. One of
+ * #RTOS_EVT_SEMAPHORE_00, #RTOS_EVT_SEMAPHORE_01, etc. The semaphore must not be used for
+ * other purposes.
+ *   @remark
+ * The function modifies the counter of the semaphore. It must be called in setup(),
+ * before the kernel uses this counter.
+ */
+
+void mpl_initPool( mpl_memoryPool_t * const pPool
+                 , void * const pMemoryArea
+                 , uint16_t sizeOfBlock
+                 , uintSemaphore_t noBlocks
+                 , uintEventVec_t evtSemaphore
+                 )
+{
+    uint8_t idxSemaphore;
+    uintSemaphore_t u;
+    uint8_t *pBlock;
+
+    ASSERT(sizeOfBlock >= sizeof(void*)  &&  noBlocks > 0);
+
+    /* The semaphores are the least significant bits of the event vector. */
+    for(idxSemaphore=0; idxSemaphore<RTOS_NO_SEMAPHORE_EVENTS; ++idxSemaphore)
+        if(evtSemaphore == (RTOS_EVT_LSB << idxSemaphore))
+            break;
+    ASSERT(idxSemaphore < RTOS_NO_SEMAPHORE_EVENTS);
+
+    /* Link all blocks into the list of free blocks. The last one terminates the list. */
+    pBlock = (uint8_t*)pMemoryArea;
+    for(u=0; u<noBlocks-1; ++u)
+    {
+        *(void**)pBlock = pBlock + sizeOfBlock;
+        pBlock += sizeOfBlock;
+    }
+    *(void**)pBlock = NULL;
+
+    pPool->pFreeList = pMemoryArea;
+    pPool->evtSemaphore = evtSemaphore;
+    rtos_semaphoreAry[idxSemaphore] = noBlocks;
+
+} /* End of mpl_initPool */
+
+
+
+
+/**
+ * Allocate a memory block from the pool. If all blocks are in use then the calling task
+ * is suspended until another task frees a block or until the timeout elapses.\n
+ *   The function must not be called by the idle task.
+ *   @return
+ * The allocated block or NULL in case of a timeout. The contents of the block are
+ * undefined.
+ *   @param pPool
+ * The pool object.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer. If a block is available the function returns immediately.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void *mpl_alloc(mpl_memoryPool_t * const pPool, uintTime_t timeout)
+{
+    void *pBlock;
+
+    /* Acquire the semaphore. If we get it, there's surely a block in the list. */
+    if((rtos_waitForEvent(pPool->evtSemaphore | RTOS_EVT_DELAY_TIMER, /* all */ false, timeout)
+        & pPool->evtSemaphore
+       ) == 0
+      )
+    {
+        return NULL;
+    }
+
+    cli();
+    {
+        pBlock = pPool->pFreeList;
+        ASSERT(pBlock != NULL);
+        pPool->pFreeList = *(void**)pBlock;
+    }
+    sei();
+
+    return pBlock;
+
+} /* End of mpl_alloc */
+
+
+
+
+/**
+ * Return a memory block to the pool. If a task is waiting for a block, it is resumed. If
+ * this task has a higher priority than the calling task, it becomes active immediately.
+ *   @param pPool
+ * The pool object.
+ *   @param pBlock
+ * The block to return. It needs to be a block, which has been allocated from the same
+ * pool. The block must not be used any more after return.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void mpl_free(mpl_memoryPool_t * const pPool, void * const pBlock)
+{
+    ASSERT(pBlock != NULL);
+
+    /* The kernel call, which releases the semaphore, also releases the global interrupt
+       lock. Linking the block and resuming a waiting task are a single atomic
+       operation. */
+    cli();
+    *(void**)pBlock = pPool->pFreeList;
+    pPool->pFreeList = pBlock;
+    rtos_sendEvent(pPool->evtSemaphore);
+
+} /* End of mpl_free */
+
+#endif /* RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON */
@@ -0,0 +1,81 @@
+#ifndef MPL_MEMORYPOOL_INCLUDED
+#define MPL_MEMORYPOOL_INCLUDED
+/**
+ * @file mpl_memoryPool.h
+ * Definition of global interface of module mpl_memoryPool.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+/** A pool of memory blocks of fixed size. The object is owned by the application but it
+    must be accessed only through the functions of this module. */
+typedef struct mpl_memoryPool_t
+{
+    /** The first free block. Each free block holds the pointer to the next one in its
+        first bytes. NULL if all blocks are allocated. */
+    void *pFreeList;
+
+    /** The semaphore, which counts the free blocks. */
+    uintEventVec_t evtSemaphore;
+
+} mpl_memoryPool_t;
+#endif
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+/** Initialize a memory pool prior to its first use. To be called in setup(). */
+void mpl_initPool( mpl_memoryPool_t *pPool
+                 , void *pMemoryArea
+                 , uint16_t sizeOfBlock
+                 , uintSemaphore_t noBlocks
+                 , uintEventVec_t evtSemaphore
+                 );
+
+/** Allocate a memory block, wait for it if all blocks are in use. */
+void *mpl_alloc(mpl_memoryPool_t *pPool, uintTime_t timeout);
+
+/** Return a memory block to the pool. */
+void mpl_free(mpl_memoryPool_t *pPool, void *pBlock);
+#endif
+
+
+#endif  /* MPL_MEMORYPOOL_INCLUDED */
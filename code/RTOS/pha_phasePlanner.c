@@ -0,0 +1,330 @@
+/**
+ * @file pha_phasePlanner.c
+ *   Planning of the phase offsets of regular tasks. If several regular tasks become due in
+ * the same system timer tic, then their execution times add up and the task of lowest
+ * priority is delayed by all others. The RTuinOS documentation recommends to distribute
+ * the tasks on the time grid by different start timeouts. This module chooses the start
+ * timeouts automatically.\n
+ *   The input is the period and the estimated execution time of each task. The planner
+ * models the work, which becomes due in each tic of the hyperperiod, the least common
+ * multiple of all periods. The tasks are placed one after another, the one with the
+ * longest execution time first. Each task is given the phase, which leads to the least
+ * peak work in any tic of its activations. The greedy search doesn't guarantee the optimum
+ * but it finds a good distribution in a single pass.\n
+ *   The planner is run at initialization time, typically in setup() before the tasks are
+ * initialized. It reports the resulting worst case work per tic, which an application may
+ * e.g. compare with the tic period or check by assertion.
+ *   @remark
+ * The planner considers only the tic, in which a task becomes due; it doesn't model that
+ * an activation, which takes longer than a tic, spills over into the next tic.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   pha_planPhases
+ *   pha_getPeakLoad
+ * Local functions
+ *   getHyperperiod
+ *   addTaskToProfile
+ *   getPeakOfTask
+ *   getPeakOfProfile
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "pha_phasePlanner.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the length of the modelled window of tics. It is the least common multiple of all
+ * periods but not more than #PHA_MAX_HYPERPERIOD.
+ *   @return
+ * The number of tics of the window.
+ *   @param taskTimingAry
+ * The timing of the tasks.
+ *   @param noTasks
+ * The number of entries in \a taskTimingAry.
+ */
+
+static uint8_t getHyperperiod(const pha_taskTiming_t taskTimingAry[], uint8_t noTasks)
+{
+    uint16_t hyperperiod = 1;
+    uint8_t u;
+
+    for(u=0; u<noTasks; ++u)
+    {
+        const uint16_t period = taskTimingAry[u].period;
+        ASSERT(period >= 1  &&  period <= PHA_MAX_HYPERPERIOD);
+
+        /* lcm(a, b) = a*b/gcd(a, b). The greatest common divisor is found by Euclid's
+           algorithm. */
+        uint16_t a = hyperperiod
+               , b = period;
+        while(b != 0)
+        {
+            const uint16_t r = a % b;
+            a = b;
+            b = r;
+        }
+        hyperperiod = hyperperiod / a * period;
+
+        /* A longer window is approximated by the maximum window. */
+        if(hyperperiod > PHA_MAX_HYPERPERIOD)
+            return PHA_MAX_HYPERPERIOD;
+    }
+
+    return (uint8_t)hyperperiod;
+
+} /* End of getHyperperiod */
+
+
+
+
+/**
+ * Add the work of all activations of a task to the profile of work per tic.
+ *   @param profileAry
+ * The work per tic in microseconds for all tics of the window.
+ *   @param hyperperiod
+ * The number of tics of the window.
+ *   @param pTaskTiming
+ * The timing of the task, including its phase.
+ */
+
+static void addTaskToProfile( uint16_t profileAry[]
+                            , uint8_t hyperperiod
+                            , const pha_taskTiming_t * const pTaskTiming
+                            )
+{
+    uint16_t tic;
+
+    for(tic=pTaskTiming->phase; tic<hyperperiod; tic+=pTaskTiming->period)
+    {
+        /* The work saturates rather than wraps around. */
+        const uint16_t work = profileAry[tic] + pTaskTiming->tiExecution;
+        profileAry[tic] = work < profileAry[tic]? 0xffff: work;
+    }
+} /* End of addTaskToProfile */
+
+
+
+
+/**
+ * Get the peak work in all tics, in which a task would become due, if it were added to the
+ * profile with a given phase.
+ *   @return
+ * The peak work in microseconds.
+ *   @param profileAry
+ * The work per tic in microseconds for all tics of the window.
+ *   @param hyperperiod
+ * The number of tics of the window.
+ *   @param period
+ * The period of the task.
+ *   @param phase
+ * The phase under consideration.
+ *   @param tiExecution
+ * The execution time of the task.
+ */
+
+static uint16_t getPeakOfTask( const uint16_t profileAry[]
+                             , uint8_t hyperperiod
+                             , uint8_t period
+                             , uint8_t phase
+                             , uint16_t tiExecution
+                             )
+{
+    uint16_t peak = 0
+           , tic;
+
+    for(tic=phase; tic<hyperperiod; tic+=period)
+        if(profileAry[tic] > peak)
+            peak = profileAry[tic];
+
+    return peak + tiExecution < peak? 0xffff: peak + tiExecution;
+
+} /* End of getPeakOfTask */
+
+
+
+
+/**
+ * Get the peak work of all tics of the profile.
+ *   @return
+ * The peak work in microseconds.
+ *   @param profileAry
+ * The work per tic in microseconds for all tics of the window.
+ *   @param hyperperiod
+ * The number of tics of the window.
+ */
+
+static uint16_t getPeakOfProfile(const uint16_t profileAry[], uint8_t hyperperiod)
+{
+    uint16_t peak = 0;
+    uint8_t tic;
+
+    for(tic=0; tic<hyperperiod; ++tic)
+        if(profileAry[tic] > peak)
+            peak = profileAry[tic];
+
+    return peak;
+
+} /* End of getPeakOfProfile */
+
+
+
+
+/**
+ * Choose the phases of a set of regular tasks such that the peak work, which becomes due
+ * in a single system timer tic, is minimal. The phases are written into the task timing
+ * objects.
+ *   @return
+ * Get the resulting worst case work per tic in microseconds. The value saturates at
+ * 0xffff.
+ *   @param taskTimingAry
+ * The timing of the tasks. Period and execution time need to be set on entry. The
+ * phases are set on return.
+ *   @param noTasks
+ * The number of entries in \a taskTimingAry.
+ *   @remark
+ * The function is meant to be called at initialization time, e.g. in setup(). Its
+ * computation time is proportional to the number of tasks squared plus the sum of all
+ * periods times the hyperperiod. It needs about 2*#PHA_MAX_HYPERPERIOD Byte of stack.
+ */
+
+uint16_t pha_planPhases(pha_taskTiming_t taskTimingAry[], uint8_t noTasks)
+{
+    const uint8_t hyperperiod = getHyperperiod(taskTimingAry, noTasks);
+    uint16_t profileAry[PHA_MAX_HYPERPERIOD];
+    uint8_t idxTask
+          , idxPrevTask = 0;
+
+    /* The previous execution time is initially above all possible values. */
+    uint32_t tiPrevExecution = 0x10000ul;
+
+    memset(profileAry, 0, sizeof(profileAry));
+
+    /* The tasks are placed in the order of decreasing execution time; the ones with the
+       most work are distributed first. The next task is the one with the longest
+       execution time behind the previous one, tasks of same execution time are taken in
+       the order of the array. */
+    for(idxTask=0; idxTask<noTasks; ++idxTask)
+    {
+        uint8_t idxNext = 0xff
+              , u;
+        for(u=0; u<noTasks; ++u)
+        {
+            const uint16_t tiExecution = taskTimingAry[u].tiExecution;
+            if((tiExecution < tiPrevExecution
+                ||  (tiExecution == tiPrevExecution  &&  u > idxPrevTask)
+               )
+               &&  (idxNext == 0xff
+                    ||  tiExecution > taskTimingAry[idxNext].tiExecution
+                   )
+              )
+            {
+                idxNext = u;
+            }
+        }
+        ASSERT(idxNext != 0xff);
+        pha_taskTiming_t * const pTaskTiming = &taskTimingAry[idxNext];
+
+        /* Try all phases and take the first one with the least peak work. */
+        uint16_t minPeak = 0xffff;
+        uint8_t phase;
+        pTaskTiming->phase = 0;
+        for(phase=0; phase<pTaskTiming->period  &&  phase<hyperperiod; ++phase)
+        {
+            const uint16_t peak = getPeakOfTask( profileAry
+                                               , hyperperiod
+                                               , pTaskTiming->period
+                                               , phase
+                                               , pTaskTiming->tiExecution
+                                               );
+            if(peak < minPeak)
+            {
+                minPeak = peak;
+                pTaskTiming->phase = phase;
+            }
+        }
+        addTaskToProfile(profileAry, hyperperiod, pTaskTiming);
+
+        idxPrevTask = idxNext;
+        tiPrevExecution = pTaskTiming->tiExecution;
+    }
+
+    return getPeakOfProfile(profileAry, hyperperiod);
+
+} /* End of pha_planPhases */
+
+
+
+
+/**
+ * Get the peak work, which becomes due in a single system timer tic, for a set of regular
+ * tasks with given periods and phases. The function can be used to assess a manual choice
+ * of the phases.
+ *   @return
+ * Get the worst case work per tic in microseconds. The value saturates at 0xffff.
+ *   @param taskTimingAry
+ * The timing of the tasks, including their phases.
+ *   @param noTasks
+ * The number of entries in \a taskTimingAry.
+ */
+
+uint16_t pha_getPeakLoad(const pha_taskTiming_t taskTimingAry[], uint8_t noTasks)
+{
+    const uint8_t hyperperiod = getHyperperiod(taskTimingAry, noTasks);
+    uint16_t profileAry[PHA_MAX_HYPERPERIOD];
+    uint8_t u;
+
+    memset(profileAry, 0, sizeof(profileAry));
+    for(u=0; u<noTasks; ++u)
+    {
+        ASSERT(taskTimingAry[u].phase < taskTimingAry[u].period);
+        addTaskToProfile(profileAry, hyperperiod, &taskTimingAry[u]);
+    }
+
+    return getPeakOfProfile(profileAry, hyperperiod);
+
+} /* End of pha_getPeakLoad */
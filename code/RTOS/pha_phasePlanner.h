@@ -0,0 +1,83 @@
+#ifndef PHA_PHASE_PLANNER_INCLUDED
+#define PHA_PHASE_PLANNER_INCLUDED
+/**
+ * @file pha_phasePlanner.h
+ * Definition of global interface of module pha_phasePlanner.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The planner computes the work per tic in a window of tics, which is the least common
+    multiple of all periods, the hyperperiod. The window is limited to this number of tics
+    to bound the stack consumption of the planner, which is two Byte per tic. If the
+    hyperperiod is longer, then the result is an approximation. The value can be
+    overridden in rtos.config.h. */
+#ifndef PHA_MAX_HYPERPERIOD
+# define PHA_MAX_HYPERPERIOD    120
+#endif
+
+
+/*
+ * Global type definitions
+ */
+
+/** The timing of a regular task, which is the input and output of the phase planner. */
+typedef struct pha_taskTiming_t
+{
+    /** The period of the task in system timer tics. The range is 1..#PHA_MAX_HYPERPERIOD. */
+    uintTime_t period;
+
+    /** The estimated worst case execution time of an activation of the task in
+        microseconds. */
+    uint16_t tiExecution;
+
+    /** The phase of the task, i.e. the tic of its first activation in the range
+        0..period-1. It is the result of pha_planPhases. Use it as start timeout of the
+        task together with the start event #RTOS_EVT_ABSOLUTE_TIMER or as phase offset of
+        rtos_setTaskPeriod. */
+    uintTime_t phase;
+
+} pha_taskTiming_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Choose the phases of regular tasks such that the peak work per tic is minimal. */
+uint16_t pha_planPhases(pha_taskTiming_t taskTimingAry[], uint8_t noTasks);
+
+/** Get the peak work per tic for given periods and phases. */
+uint16_t pha_getPeakLoad(const pha_taskTiming_t taskTimingAry[], uint8_t noTasks);
+
+
+#endif  /* PHA_PHASE_PLANNER_INCLUDED */
@@ -0,0 +1,494 @@
+/**
+ * @file que_queue.c
+ *   Implementation of a queue for passing data elements from one task to another one. The
+ * size of the elements and the capacity of the queue are configured by the application
+ * for each queue object.\n
+ *   The queue supports a single producer and a single consumer. Under this condition no
+ * lock is required to access the data: The write position is modified only by the producer
+ * and the read position only by the consumer. Both are 8 Bit values, which are read and
+ * written atomically by the CPU.\n
+ *   The consumer can wait for data with timeout. Before suspending, it sets a flag in the
+ * queue object. The producer posts the queue's event only if this flag is set; as long as
+ * the consumer is busy, writing to the queue doesn't involve the kernel at all.\n
+ *   Elements can be written and read in blocks. The consumer can wait for a fill level of
+ * the queue, so that it is resumed once for a block of elements rather than for each
+ * single element.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine. The
+ * producer may be the idle task, the consumer can't.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   que_initQueue
+ *   que_write
+ *   que_signal
+ *   que_writeAndSignal
+ *   que_writeN
+ *   que_read
+ *   que_readWait
+ *   que_readN
+ *   que_waitForFillLevel
+ *   que_readNWait
+ *   que_getNoElems
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <string.h>
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "que_queue.h"
+
+
+/*
+ * Defines
+ */
+ 
+ 
+/*
+ * Local type definitions
+ */
+ 
+ 
+/*
+ * Local prototypes
+ */
+ 
+ 
+/*
+ * Data definitions
+ */
+ 
+ 
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a queue object. This needs to be done once before the queue is used, e.g.
+ * in setup().
+ *   @param pQueue
+ * The queue object to initialize.
+ *   @param pRingBuf
+ * The memory area, which holds the queued elements. It has room for \a maxNoElems
+ * elements of \a sizeOfElem Byte each. In most cases an array of the element type is
+ * passed.
+ *   @param sizeOfElem
+ * The size of a single element in Byte.
+ *   @param maxNoElems
+ * The capacity of the queue. Needs to be a power of two in the range
+ * 1..#QUE_MAX_NO_ELEMENTS.
+ *   @param evtData
+ * The event used to resume the consumer when data is written. It needs to be a normal,
+ * broadcasted event, neither a semaphore, nor a mutex, nor a timer event. The consumer
+ * must not use it for other purposes.
+ */
+
+void que_initQueue( que_queue_t * const pQueue
+                  , void * const pRingBuf
+                  , uint8_t sizeOfElem
+                  , uint8_t maxNoElems
+                  , uintEventVec_t evtData
+                  )
+{
+    ASSERT(maxNoElems >= 1  &&  maxNoElems <= QUE_MAX_NO_ELEMENTS
+           &&  (maxNoElems & (maxNoElems-1)) == 0
+          );
+    ASSERT(sizeOfElem > 0);
+    ASSERT(evtData != 0
+           &&  (evtData & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+
+    pQueue->pRingBuf = (uint8_t*)pRingBuf;
+    pQueue->sizeOfElem = sizeOfElem;
+    pQueue->maxNoElems = maxNoElems;
+    pQueue->idxWrite = 0;
+    pQueue->idxRead = 0;
+    pQueue->evtData = evtData;
+    pQueue->isConsumerWaiting = false;
+    pQueue->wakeFillLevel = 1;
+
+} /* End of que_initQueue */
+
+
+
+
+/**
+ * Append an element to the queue. The consumer is not notified; if it is currently
+ * waiting for data it'll stay suspended. Use this function for writing a sequence of
+ * elements and call que_signal after the last one.\n
+ *   The function must be called only by the producer of the queue.
+ *   @return
+ * The function returns false if the queue is full. The element is not written in this
+ * case.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElem
+ * The element to append. The number of copied bytes is the element size configured in
+ * que_initQueue.
+ */
+
+boolean que_write(que_queue_t * const pQueue, const void * const pElem)
+{
+    const uint8_t idxWrite = pQueue->idxWrite;
+    if((uint8_t)(idxWrite - pQueue->idxRead) >= pQueue->maxNoElems)
+        return false;
+
+    memcpy( pQueue->pRingBuf
+            + (uint16_t)(idxWrite & (pQueue->maxNoElems-1)) * pQueue->sizeOfElem
+          , pElem
+          , pQueue->sizeOfElem
+          );
+
+    /* The element is completely written before the consumer can see it. The index is
+       volatile, the compiler must not reorder this assignment with the copy operation. */
+    asm volatile ("" ::: "memory");
+    pQueue->idxWrite = idxWrite + 1;
+
+    return true;
+
+} /* End of que_write */
+
+
+
+
+/**
+ * Resume the consumer if it is currently waiting for data and if the queue contains the
+ * number of elements the consumer waits for. The function involves the kernel only if the
+ * consumer is resumed. If the consumer has a higher priority than the calling task, it
+ * becomes active immediately.\n
+ *   The function must be called only by the producer of the queue.
+ *   @param pQueue
+ * The queue object.
+ */
+
+void que_signal(que_queue_t * const pQueue)
+{
+    /* The test of the flag follows the update of the write position. If the consumer had
+       found the queue empty then it had set the flag before - it checks and sets under
+       global lock of the interrupts. The event can't get lost. */
+    if(pQueue->isConsumerWaiting  &&  que_getNoElems(pQueue) >= pQueue->wakeFillLevel)
+    {
+        pQueue->isConsumerWaiting = false;
+        rtos_sendEvent(pQueue->evtData);
+    }
+} /* End of que_signal */
+
+
+
+
+/**
+ * Append an element to the queue and resume the consumer if it is waiting for data. This
+ * is the combination of que_write and que_signal.\n
+ *   The function must be called only by the producer of the queue.
+ *   @return
+ * The function returns false if the queue is full. The element is not written in this
+ * case.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElem
+ * The element to append.
+ */
+
+boolean que_writeAndSignal(que_queue_t * const pQueue, const void * const pElem)
+{
+    if(que_write(pQueue, pElem))
+    {
+        que_signal(pQueue);
+        return true;
+    }
+    else
+        return false;
+
+} /* End of que_writeAndSignal */
+
+
+
+
+/**
+ * Append a sequence of elements to the queue. The elements are written as far as the
+ * queue has room for them. The consumer is not notified, call que_signal after writing.\n
+ *   The function must be called only by the producer of the queue.
+ *   @return
+ * The number of actually written elements. It is less than \a noElems if the queue became
+ * full.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElemAry
+ * The elements to append. They are contiguous in memory, typically an array of the
+ * element type.
+ *   @param noElems
+ * The number of elements in \a pElemAry.
+ */
+
+uint8_t que_writeN( que_queue_t * const pQueue
+                  , const void * const pElemAry
+                  , uint8_t noElems
+                  )
+{
+    const uint8_t idxWrite = pQueue->idxWrite
+                , maxNoElems = pQueue->maxNoElems
+                , noFreeElems = maxNoElems - (uint8_t)(idxWrite - pQueue->idxRead);
+    if(noElems > noFreeElems)
+        noElems = noFreeElems;
+
+    /* The elements are copied in at most two chunks, the second one starts at the
+       beginning of the ring buffer. */
+    const uint8_t idxSlot = idxWrite & (maxNoElems-1)
+                , noElemsTillEnd = maxNoElems - idxSlot
+                , noElemsChunk1 = noElems < noElemsTillEnd? noElems: noElemsTillEnd;
+    const uint16_t sizeOfChunk1 = (uint16_t)noElemsChunk1 * pQueue->sizeOfElem;
+    memcpy(pQueue->pRingBuf + (uint16_t)idxSlot*pQueue->sizeOfElem, pElemAry, sizeOfChunk1);
+    memcpy( pQueue->pRingBuf
+          , (const uint8_t*)pElemAry + sizeOfChunk1
+          , (uint16_t)(noElems - noElemsChunk1) * pQueue->sizeOfElem
+          );
+
+    /* All elements are completely written before the consumer can see them. */
+    asm volatile ("" ::: "memory");
+    pQueue->idxWrite = idxWrite + noElems;
+
+    return noElems;
+
+} /* End of que_writeN */
+
+
+
+
+/**
+ * Take the next element from the queue if there is any. The function doesn't block.\n
+ *   The function must be called only by the consumer of the queue.
+ *   @return
+ * The function returns false if the queue is empty.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElem
+ * The element is copied into * \a pElem.
+ */
+
+boolean que_read(que_queue_t * const pQueue, void * const pElem)
+{
+    const uint8_t idxRead = pQueue->idxRead;
+    if(idxRead == pQueue->idxWrite)
+        return false;
+
+    memcpy( pElem
+          , pQueue->pRingBuf
+            + (uint16_t)(idxRead & (pQueue->maxNoElems-1)) * pQueue->sizeOfElem
+          , pQueue->sizeOfElem
+          );
+
+    /* The element is completely read before the producer may overwrite it. */
+    asm volatile ("" ::: "memory");
+    pQueue->idxRead = idxRead + 1;
+
+    return true;
+
+} /* End of que_read */
+
+
+
+
+/**
+ * Take the next element from the queue. If the queue is empty, the calling task is
+ * suspended until the producer writes an element or until the timeout elapses.\n
+ *   The function must be called only by the consumer of the queue. It must not be called
+ * by the idle task.
+ *   @return
+ * The function returns false if the timeout elapsed and the queue is still empty.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElem
+ * The element is copied into * \a pElem.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean que_readWait(que_queue_t * const pQueue, void * const pElem, uintTime_t timeout)
+{
+    return que_waitForFillLevel(pQueue, /* fillLevel */ 1, timeout)
+           &&  que_read(pQueue, pElem);
+
+} /* End of que_readWait */
+
+
+
+
+/**
+ * Take up to a given number of elements from the queue. The function doesn't block, it
+ * takes as many elements as are available.\n
+ *   The function must be called only by the consumer of the queue.
+ *   @return
+ * The number of actually read elements. Zero if the queue is empty.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElemAry
+ * The elements are copied into this memory area, which has room for \a maxNoElems
+ * elements; typically an array of the element type.
+ *   @param maxNoElems
+ * The maximum number of elements to read.
+ */
+
+uint8_t que_readN(que_queue_t * const pQueue, void * const pElemAry, uint8_t maxNoElems)
+{
+    const uint8_t idxRead = pQueue->idxRead
+                , noQueuedElems = (uint8_t)(pQueue->idxWrite - idxRead);
+    if(maxNoElems > noQueuedElems)
+        maxNoElems = noQueuedElems;
+
+    /* The elements are copied in at most two chunks, see que_writeN. */
+    const uint8_t idxSlot = idxRead & (pQueue->maxNoElems-1)
+                , noElemsTillEnd = pQueue->maxNoElems - idxSlot
+                , noElemsChunk1 = maxNoElems < noElemsTillEnd? maxNoElems: noElemsTillEnd;
+    const uint16_t sizeOfChunk1 = (uint16_t)noElemsChunk1 * pQueue->sizeOfElem;
+    memcpy(pElemAry, pQueue->pRingBuf + (uint16_t)idxSlot*pQueue->sizeOfElem, sizeOfChunk1);
+    memcpy( (uint8_t*)pElemAry + sizeOfChunk1
+          , pQueue->pRingBuf
+          , (uint16_t)(maxNoElems - noElemsChunk1) * pQueue->sizeOfElem
+          );
+
+    /* All elements are completely read before the producer may overwrite them. */
+    asm volatile ("" ::: "memory");
+    pQueue->idxRead = idxRead + maxNoElems;
+
+    return maxNoElems;
+
+} /* End of que_readN */
+
+
+
+
+/**
+ * Wait until the queue contains at least a given number of elements or until a timeout
+ * elapses. The calling task is suspended and it is not resumed before the producer has
+ * filled the queue up to the desired level (high watermark). A consumer, which processes
+ * the data in blocks, is resumed only once per block.\n
+ *   The function must be called only by the consumer of the queue. It must not be called
+ * by the idle task.
+ *   @return
+ * The function returns true if the fill level is reached and false in case of a
+ * timeout.
+ *   @param pQueue
+ * The queue object.
+ *   @param fillLevel
+ * The number of elements to wait for. The range is 1..capacity of the queue.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer.
+ *   @remark
+ * The producer needs to call que_signal or que_writeAndSignal. Otherwise the consumer
+ * resumes only at the timeout.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean que_waitForFillLevel( que_queue_t * const pQueue
+                            , uint8_t fillLevel
+                            , uintTime_t timeout
+                            )
+{
+    ASSERT(fillLevel >= 1  &&  fillLevel <= pQueue->maxNoElems);
+
+    /* The check of the fill level and setting the flag need to be atomic with respect to
+       the producer. The global interrupt lock is released by the kernel when the task is
+       suspended. */
+    cli();
+    if(que_getNoElems(pQueue) >= fillLevel)
+    {
+        sei();
+        return true;
+    }
+
+    pQueue->wakeFillLevel = fillLevel;
+    pQueue->isConsumerWaiting = true;
+    if((rtos_waitForEvent(pQueue->evtData | RTOS_EVT_DELAY_TIMER, /* all */ false, timeout)
+        & pQueue->evtData
+       ) == 0
+      )
+    {
+        /* Timeout. The producer may have filled the queue in the same tic. */
+        pQueue->isConsumerWaiting = false;
+        return que_getNoElems(pQueue) >= fillLevel;
+    }
+    else
+    {
+        /* The producer resets the flag when posting the event and only if the fill level
+           is reached. */
+        return true;
+    }
+} /* End of que_waitForFillLevel */
+
+
+
+
+/**
+ * Wait until the queue contains a given number of elements and take them from the
+ * queue. This is the combination of que_waitForFillLevel and que_readN.\n
+ *   The function must be called only by the consumer of the queue. It must not be called
+ * by the idle task.
+ *   @return
+ * The number of read elements. It is less than \a noElems in case of a timeout.
+ *   @param pQueue
+ * The queue object.
+ *   @param pElemAry
+ * The elements are copied into this memory area, which has room for \a noElems elements.
+ *   @param noElems
+ * The number of elements to wait for and to read. The range is 1..capacity of the queue.
+ *   @param timeout
+ * The maximum time to wait in system timer tics.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+uint8_t que_readNWait( que_queue_t * const pQueue
+                     , void * const pElemAry
+                     , uint8_t noElems
+                     , uintTime_t timeout
+                     )
+{
+    que_waitForFillLevel(pQueue, /* fillLevel */ noElems, timeout);
+    return que_readN(pQueue, pElemAry, noElems);
+
+} /* End of que_readNWait */
+
+
+
+
+/**
+ * Get the number of elements currently contained in the queue. The value is a snapshot;
+ * the producer may append and the consumer may take elements at any time.
+ *   @return
+ * The number of elements in the queue.
+ *   @param pQueue
+ * The queue object.
+ */
+
+uint8_t que_getNoElems(const que_queue_t * const pQueue)
+{
+    return (uint8_t)(pQueue->idxWrite - pQueue->idxRead);
+
+} /* End of que_getNoElems */
@@ -0,0 +1,132 @@
+#ifndef QUE_QUEUE_INCLUDED
+#define QUE_QUEUE_INCLUDED
+/**
+ * @file que_queue.h
+ * Definition of global interface of module que_queue.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The maximum number of elements a queue can hold. The capacity of a queue needs to be a
+    power of two in the range 1..#QUE_MAX_NO_ELEMENTS. */
+#define QUE_MAX_NO_ELEMENTS     128
+
+
+/*
+ * Global type definitions
+ */
+
+/** A queue for passing elements of fixed size from one producer task to one consumer
+    task. The object is owned by the application but it must be accessed only through the
+    functions of this module.\n
+      The position indexes are cyclically incremented and never wrapped explicitly. The
+    number of queued elements is their difference. */
+typedef struct que_queue_t
+{
+    /** The memory area, which holds the elements; it has room for \a maxNoElems elements
+        of \a sizeOfElem Byte each. */
+    uint8_t *pRingBuf;
+
+    /** The size of a single element in Byte. */
+    uint8_t sizeOfElem;
+
+    /** The number of elements the queue can hold, a power of two. */
+    uint8_t maxNoElems;
+
+    /** The position for the next write. Modified by the producer only. */
+    volatile uint8_t idxWrite;
+
+    /** The position for the next read. Modified by the consumer only. */
+    volatile uint8_t idxRead;
+
+    /** The event, which is posted to the consumer if it waits for data. */
+    uintEventVec_t evtData;
+
+    /** Flag, which is set by the consumer before it suspends itself to wait for data. The
+        producer resets it and posts \a evtData. */
+    volatile boolean isConsumerWaiting;
+
+    /** The number of queued elements the waiting consumer needs to see in order to be
+        resumed. Only valid if \a isConsumerWaiting is set. */
+    uint8_t wakeFillLevel;
+
+} que_queue_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize a queue object prior to its first use. */
+void que_initQueue( que_queue_t *pQueue
+                  , void *pRingBuf
+                  , uint8_t sizeOfElem
+                  , uint8_t maxNoElems
+                  , uintEventVec_t evtData
+                  );
+
+/** Append an element to the queue but don't notify the consumer. */
+boolean que_write(que_queue_t *pQueue, const void *pElem);
+
+/** Resume the consumer if it waits for data. */
+void que_signal(que_queue_t *pQueue);
+
+/** Append an element to the queue and resume the consumer if it waits for data. */
+boolean que_writeAndSignal(que_queue_t *pQueue, const void *pElem);
+
+/** Append a sequence of elements to the queue but don't notify the consumer. */
+uint8_t que_writeN(que_queue_t *pQueue, const void *pElemAry, uint8_t noElems);
+
+/** Take the next element from the queue if there is any. */
+boolean que_read(que_queue_t *pQueue, void *pElem);
+
+/** Take the next element from the queue, wait for it if the queue is empty. */
+boolean que_readWait(que_queue_t *pQueue, void *pElem, uintTime_t timeout);
+
+/** Take up to a given number of elements from the queue. */
+uint8_t que_readN(que_queue_t *pQueue, void *pElemAry, uint8_t maxNoElems);
+
+/** Wait until the queue contains a given number of elements. */
+boolean que_waitForFillLevel(que_queue_t *pQueue, uint8_t fillLevel, uintTime_t timeout);
+
+/** Wait for a given number of elements and take them from the queue. */
+uint8_t que_readNWait( que_queue_t *pQueue
+                     , void *pElemAry
+                     , uint8_t noElems
+                     , uintTime_t timeout
+                     );
+
+/** Get the number of elements currently contained in the queue. */
+uint8_t que_getNoElems(const que_queue_t *pQueue);
+
+
+#endif  /* QUE_QUEUE_INCLUDED */
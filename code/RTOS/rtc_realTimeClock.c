@@ -0,0 +1,258 @@
+/**
+ * @file rtc_realTimeClock.c
+ *   A real time clock, which is derived on demand from the timestamp of the kernel. No
+ * task needs to be regularly resumed to count the time: The clock is defined by a
+ * reference point, a pair of clock time and kernel timestamp, which is stored when the
+ * clock is set. Reading the clock means to take the current timestamp and to add the time
+ * elapsed since the reference point to the clock time of the reference point.\n
+ *   The timestamp, see rtos_getTimestamp, combines the count of system timer tics with the
+ * count of the hardware timer. The clock has the resolution of the timestamp, 4 or 8 us,
+ * and, other than a clock, which adds up #RTOS_TIC per tic, it doesn't accumulate a
+ * rounding error: The tic period of the kernel is represented exactly in the timestamp.\n
+ *   The remaining error of the clock is the deviation of the CPU clock from its nominal
+ * frequency. It is corrected by rtc_setDriftCorrection. The correction needs to be figured
+ * out by long term observation for an individual board.\n
+ *   The module is compiled only if #RTOS_USE_TIMESTAMP is set.
+ *   @remark
+ * The computation uses 64 Bit arithmetics; on the AVR, a call of the read functions
+ * takes some ten microseconds. The functions should not be used from an interrupt.
+ *   @remark
+ * The clock is reentrant. It can be read and set from any task and from the idle task.
+ * The functions contain a critical section and enable the interrupts globally.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   rtc_setTime
+ *   rtc_setDriftCorrection
+ *   rtc_getTime
+ *   rtc_getTimeOfDay
+ * Local functions
+ *   getTime
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "rtc_realTimeClock.h"
+
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+/** The number of microseconds of a second. */
+#define US_PER_SEC  1000000ul
+
+
+/*
+ * Local type definitions
+ */
+
+/** The reference point of the clock. */
+typedef struct refPoint_t
+{
+    /** The kernel timestamp at the reference point in us. */
+    uint64_t timestamp;
+
+    /** The time of the clock at the reference point, full seconds part. */
+    uint32_t noSec;
+
+    /** The time of the clock at the reference point, fractional part in us. */
+    uint32_t noMicroSec;
+
+    /** The correction of the clock rate in ppm. */
+    int16_t driftInPpm;
+
+} refPoint_t;
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The reference point of the clock. It is written by the set functions and read by the
+    get functions under a critical section. */
+static refPoint_t _refPoint = {0, 0, 0, 0};
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Compute the time of the clock for a given timestamp.
+ *   @return
+ * Get the full seconds.
+ *   @param pNoMicroSec
+ * The fractional part of the time in us is returned in * \a pNoMicroSec.
+ *   @param pRefPoint
+ * The reference point of the clock.
+ *   @param timestamp
+ * The kernel timestamp in us. It must not be before the timestamp of the reference point.
+ */
+
+static uint32_t getTime( uint32_t * const pNoMicroSec
+                       , const refPoint_t * const pRefPoint
+                       , uint64_t timestamp
+                       )
+{
+    ASSERT(timestamp >= pRefPoint->timestamp);
+    uint64_t tiElapsed = timestamp - pRefPoint->timestamp;
+
+    /* The drift correction is applied to the elapsed time. The product can't overflow in
+       practice: The elapsed time would need to exceed 69 years. */
+    const int64_t correction = (int64_t)tiElapsed * pRefPoint->driftInPpm
+                               / (int64_t)US_PER_SEC;
+    tiElapsed = (uint64_t)((int64_t)tiElapsed + correction) + pRefPoint->noMicroSec;
+
+    *pNoMicroSec = (uint32_t)(tiElapsed % US_PER_SEC);
+    return pRefPoint->noSec + (uint32_t)(tiElapsed / US_PER_SEC);
+
+} /* End of getTime */
+
+
+
+
+/**
+ * Set the clock.
+ *   @param noSec
+ * The new time in seconds. The origin is defined by the application, e.g. midnight.
+ *   @param noMicroSec
+ * The fractional part of the new time in us, 0..999999.
+ *   @remark
+ * The time starts from zero at kernel start if this function is never called.
+ */
+
+void rtc_setTime(uint32_t noSec, uint32_t noMicroSec)
+{
+    ASSERT(noMicroSec < US_PER_SEC);
+
+    const uint64_t timestamp = rtos_getTimestamp();
+    cli();
+    {
+        _refPoint.timestamp = timestamp;
+        _refPoint.noSec = noSec;
+        _refPoint.noMicroSec = noMicroSec;
+    }
+    sei();
+
+} /* End of rtc_setTime */
+
+
+
+
+/**
+ * Set the correction of the drift of the CPU clock. The clock is not affected until now,
+ * only its rate is changed from now on.
+ *   @param driftInPpm
+ * The correction in ppm. A positive value advances the clock. If the clock is e.g. late by
+ * 1 s per day, then the correction is 1/86400*1e6, about 12 ppm.
+ */
+
+void rtc_setDriftCorrection(int16_t driftInPpm)
+{
+    /* The current time becomes the new reference point so that the changed correction
+       doesn't apply to the past. The expensive computation of the time is done outside
+       the critical section. */
+    cli();
+    const refPoint_t refPoint = _refPoint;
+    sei();
+
+    const uint64_t timestamp = rtos_getTimestamp();
+    uint32_t noMicroSec;
+    const uint32_t noSec = getTime(&noMicroSec, &refPoint, timestamp);
+
+    cli();
+    {
+        _refPoint.timestamp = timestamp;
+        _refPoint.noSec = noSec;
+        _refPoint.noMicroSec = noMicroSec;
+        _refPoint.driftInPpm = driftInPpm;
+    }
+    sei();
+
+} /* End of rtc_setDriftCorrection */
+
+
+
+
+/**
+ * Get the current time of the clock.
+ *   @return
+ * Get the full seconds.
+ *   @param pNoMicroSec
+ * If not NULL, the fractional part of the time in us is returned in * \a pNoMicroSec.
+ */
+
+uint32_t rtc_getTime(uint32_t *pNoMicroSec)
+{
+    /* The reference point is copied before the timestamp is taken. A concurrent setting of
+       the clock can't make the timestamp earlier than the reference point. */
+    cli();
+    const refPoint_t refPoint = _refPoint;
+    sei();
+
+    uint32_t noMicroSec;
+    const uint32_t noSec = getTime(&noMicroSec, &refPoint, rtos_getTimestamp());
+    if(pNoMicroSec != NULL)
+        *pNoMicroSec = noMicroSec;
+
+    return noSec;
+
+} /* End of rtc_getTime */
+
+
+
+
+/**
+ * Get the current time of the clock as time of day. The time in seconds is interpreted as
+ * seconds since midnight.
+ *   @return
+ * Get the current time in seconds modulo a day.
+ *   @param pHour
+ * The hour, 0..23, is returned in * \a pHour.
+ *   @param pMin
+ * The minute, 0..59, is returned in * \a pMin.
+ *   @param pSec
+ * The second, 0..59, is returned in * \a pSec.
+ */
+
+uint32_t rtc_getTimeOfDay(uint8_t *pHour, uint8_t *pMin, uint8_t *pSec)
+{
+    const uint32_t noSecOfDay = rtc_getTime(/* pNoMicroSec */ NULL) % RTC_NO_SEC_PER_DAY;
+
+    /* The remaining computations are done in 16 Bit. */
+    const uint16_t noMinOfDay = (uint16_t)(noSecOfDay / 60u);
+    *pSec  = (uint8_t)(noSecOfDay - 60ul*noMinOfDay);
+    *pMin  = (uint8_t)(noMinOfDay % 60u);
+    *pHour = (uint8_t)(noMinOfDay / 60u);
+
+    return noSecOfDay;
+
+} /* End of rtc_getTimeOfDay */
+
+#endif /* RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON */
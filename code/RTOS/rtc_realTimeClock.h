@@ -0,0 +1,66 @@
+#ifndef RTC_REAL_TIME_CLOCK_INCLUDED
+#define RTC_REAL_TIME_CLOCK_INCLUDED
+/**
+ * @file rtc_realTimeClock.h
+ * Definition of global interface of module rtc_realTimeClock.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of seconds of a day. */
+#define RTC_NO_SEC_PER_DAY  86400ul
+
+
+/*
+ * Global type definitions
+ */
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+/** Set the clock. */
+void rtc_setTime(uint32_t noSec, uint32_t noMicroSec);
+
+/** Set the correction of the drift of the CPU clock in ppm. */
+void rtc_setDriftCorrection(int16_t driftInPpm);
+
+/** Get the current time of the clock in seconds and microseconds. */
+uint32_t rtc_getTime(uint32_t *pNoMicroSec);
+
+/** Get the current time of the clock as time of day. */
+uint32_t rtc_getTimeOfDay(uint8_t *pHour, uint8_t *pMin, uint8_t *pSec);
+#endif
+
+#endif  /* RTC_REAL_TIME_CLOCK_INCLUDED */
@@ -4,7 +4,11 @@
  * Arduino environment 1.0.5.\n
  *   The implementation is dependent on the board (the controller) and the GNU C++ compiler
  * (thus the release of the Arduino environment) but should be easily portable to other
- * boards and Arduino releases. See manual for details.
+ * boards and Arduino releases. See manual for details.\n
+ *   If RTOS_HOST_SIMULATION is defined, the kernel is compiled for a Linux host instead
+ * of the AVR. The tasks are switched with the ucontext functions of the host and the
+ * system timer tic is emulated by a periodic signal, see code/host/hst_arduino.c. The
+ * scheduling code is the same as on the target.
  *
  * Copyright (C) 2012-2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
  *
@@ -22,7 +26,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 /* Module interface
- *   rtos_initializeTask
+ *   rtos_initializeTask (only if RTOS_TASK_TABLE is not defined)
  *   rtos_initRTOS (internally called only)
  *   rtos_enableIRQTimerTic (callback with local default implementation)
  *   rtos_enableIRQUser00 (callback without default implementation)
@@ -30,19 +34,103 @@
  *   ISR(RTOS_ISR_SYSTEM_TIMER_TIC)
  *   ISR(RTOS_ISR_USER_00)
  *   ISR(RTOS_ISR_USER_01)
+ *   ISR(vector) (for all rows of RTOS_APPL_INTERRUPT_TABLE)
  *   rtos_sendEvent
+ *   rtos_yield
+ *   rtos_sendEventFromISR
+ *   rtos_leaveISR
  *   rtos_waitForEvent
+ *   rtos_sendEventAndWait
+ *   rtos_getTime
+ *   rtos_waitForEventTillDeadline
  *   rtos_getTaskOverrunCounter
  *   rtos_getStackReserve
+ *   rtos_getStackLowWaterMark
+ *   rtos_onStackOverflow (callback with local default implementation)
+ *   rtos_checkInTask
+ *   rtos_getLivenessFailure
+ *   rtos_onLivenessFailure (callback with local default implementation)
+ *   rtos_getIdxActiveTask
+ *   rtos_idleSleep
+ *   rtos_getIdleSleepTime
+ *   rtos_getTaskRuntime
+ *   rtos_getCpuLoad
+ *   rtos_getTaskTimingStatistics
+ *   rtos_getIsrLatencyHistogram
+ *   rtos_getTimestamp
+ *   rtos_setTaskPeriod
+ *   rtos_setTaskBudget
+ *   rtos_setTaskLivenessPeriod
+ *   rtos_notifyTask
+ *   rtos_notifyTaskFromISR
+ *   rtos_waitForNotification
+ *   rtos_setTaskPriority
+ *   rtos_suspendTask
+ *   rtos_resumeTask
  * Local functions
+ *   getIdxTask
  *   prepareTaskStack
+ *   setPrioClassDue
+ *   clearPrioClassDue
+ *   getHighestDuePrioClass
+ *   getIdxDueTask
+ *   insertDueTaskByDeadline
+ *   insertDueTask
+ *   unlinkDueTask
+ *   linkTimeout
+ *   unlinkTimeout
+ *   linkSuspendedTask
+ *   unlinkSuspendedTask
+ *   linkWaitingTask
+ *   unlinkWaitingTask
  *   checkTaskForActivation
+ *   setMutexOwner
+ *   changePrioClass
+ *   inheritPrioClass
+ *   getInheritedPrioClass
+ *   restoreInheritedPrioClasses
+ *   checkTaskBudgets
+ *   accountTaskRuntime
+ *   addTimingSample
+ *   getTimingStatistics
+ *   onTaskStart
+ *   onApplInterruptEntry
+ *   accountIsrLatency
+ *   traceTaskSwitch
  *   lookForActiveTask
+ *   getNoTicsTillNextTimerEvent
+ *   skipTics
+ *   enterTicklessPeriod
+ *   leaveTicklessPeriod
+ *   endIdleSleep
+ *   sampleStackPointer
+ *   checkStackCanaries
+ *   checkTaskLiveness
+ *   disableWatchdogAfterReset
+ *   fillTaskStacks
+ *   traceTimeout
  *   onTimerTic
+ *   onTimerTicNested
+ *   traceSyncObjHandOver
+ *   postEvent
  *   sendEvent
+ *   sendEventNested
+ *   applInterruptTail
+ *   lookForActiveTaskOnYield
+ *   lookForActiveTaskOnLeaveISR
+ *   postNotification
+ *   notifyTask
+ *   lookForActiveTaskOnReschedule
+ *   reschedule
  *   acquireFreeSyncObjs
+ *   setNextPeriodicRelease
  *   storeResumeCondition
  *   waitForEvent
+ *   sendEventAndWait
+ *   initializeTaskObject
+ *   hostTaskEntry
+ *   prepareHostContext
+ *   switchContext
  */
 
 
@@ -53,6 +141,22 @@
 #include <Arduino.h>
 #include "rtos_assert.h"
 #include "rtos.h"
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+# include <avr/sleep.h>
+#endif
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+# include <avr/wdt.h>
+#endif
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+# include "trc_trace.h"
+#endif
+#if RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON
+# include "crr_crashRecord.h"
+#endif
+#ifdef RTOS_HOST_SIMULATION
+# include <signal.h>
+# include <ucontext.h>
+#endif
 
 
 /*
@@ -63,18 +167,235 @@
     array. */
 #define IDLE_TASK_ID    (RTOS_NO_TASKS)
 
-/** A bit mask, which selects all the mutex events in an event vector. */
-#define MASK_EVT_IS_SEMAPHORE ((0x01<<(RTOS_NO_SEMAPHORE_EVENTS))-1)
+/** The CPU dependent properties of the supported controllers. The context switches are
+    the same for all of them, only the size of the program counter differs, which is
+    pushed by a call or an interrupt: The ATmega2560 (Arduino Mega 2560) has a 3 Byte PC,
+    the ATmega328P (Arduino Uno) and ATmega1284P have a 2 Byte PC, so that their context
+    frames are one Byte smaller and each switch saves a push and a pop. The system timer,
+    timer 2, is available on all of them with identical registers.\n
+      RAMPZ and EIND are not part of the context on any of these controllers. The
+    compiler doesn't change them in the kind of code RTuinOS applications are made of.
+    Porting to another AVR controller mainly means adding it to this list.\n
+      In the host simulation, the CPU context is not saved on the task stack at all. */
+#if defined(RTOS_HOST_SIMULATION)
+# define SIZE_OF_PROGRAM_COUNTER    0
+#elif defined(__AVR_ATmega2560__)
+# define SIZE_OF_PROGRAM_COUNTER    3
+#elif defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)
+# define SIZE_OF_PROGRAM_COUNTER    2
+#else
+# error Modification of code for other AVR CPU required
+#endif
+
+#ifdef RTOS_HOST_SIMULATION
+/** The size in Byte of the stack of a task in the host simulation. The task code runs with
+    the C library of the host, which needs much more stack than avr-libc. The stack area,
+    which is configured by the application, is still prepared but not used. */
+# define SIZE_OF_HOST_STACK     (64u*1024u)
+
+/* The simulation emulates only the system timer tic and the serial output. Features,
+   which access other hardware, are not available. */
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON                                      \
+     ||  RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON                                  \
+     ||  defined(RTOS_APPL_INTERRUPT_TABLE)                                             \
+     ||  RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON                                      \
+     ||  RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON                                         \
+     ||  RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON                                          \
+     ||  RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON                               \
+     ||  RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON                                      \
+     ||  RTOS_USE_ADC_SCAN == RTOS_FEATURE_ON                                           \
+     ||  RTOS_USE_TRACE == RTOS_FEATURE_ON
+#  error The configuration of RTuinOS is not supported by the host simulation
+# endif
+#endif
+
+/** A bit mask, which selects all the semaphore events in an event vector. */
+#define MASK_EVT_IS_SEMAPHORE ((RTOS_EVT_LSB<<(RTOS_NO_SEMAPHORE_EVENTS))-1u)
 
 /** A bit mask, which selects all the mutex events in an event vector. */
-#define MASK_EVT_IS_MUTEX                                                   \
-        (((0x0001u<<(RTOS_NO_MUTEX_EVENTS+RTOS_NO_SEMAPHORE_EVENTS))-1u)    \
-         - (uint16_t)MASK_EVT_IS_SEMAPHORE                                  \
+#define MASK_EVT_IS_MUTEX                                                       \
+        (((RTOS_EVT_LSB<<(RTOS_NO_MUTEX_EVENTS+RTOS_NO_SEMAPHORE_EVENTS))-1u)   \
+         - (uintEventVec_t)MASK_EVT_IS_SEMAPHORE                                \
         )
 
 /** A bit mask, which selects all timer events in a vector of events. */
 #define MASK_EVT_IS_TIMER (RTOS_EVT_ABSOLUTE_TIMER | RTOS_EVT_DELAY_TIMER)
 
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+# if RTOS_USE_TRACE != RTOS_FEATURE_ON
+#  error The kernel trace requires RTOS_USE_TRACE to be set to RTOS_FEATURE_ON
+# endif
+/** The scheduler writes its events into the binary trace, see trc_trace.c. If the kernel
+    trace is not configured, the macro expands to nothing and the kernel is unchanged. */
+# define KERNEL_TRACE(idEvent, arg)     trc_trace(idEvent, (uint16_t)(arg))
+#else
+# define KERNEL_TRACE(idEvent, arg)
+#endif
+
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+/** The park state of a task, see rtos_suspendTask: The task is not parked. */
+# define PARK_STATE_NONE        0
+
+/** The park state of a task: The task has been parked while it was waiting. It stays in
+    the list of suspended tasks and is parked when its resume condition is fulfilled. */
+# define PARK_STATE_PENDING     1
+
+/** The park state of a task: The task is in none of the lists of the scheduler. It doesn't
+    become due before it is resumed by rtos_resumeTask. */
+# define PARK_STATE_PARKED      2
+#endif
+
+/** The scheduling code, which is called by the system timer tic and by rtos_sendEvent. If
+    #RTOS_USE_NESTED_INTERRUPTS is set, the calls are redirected to wrappers, which open
+    the interrupts for all but the kernel aware ones. The host simulation has no nested
+    interrupts. */
+#if RTOS_USE_NESTED_INTERRUPTS == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+# define CALL_ON_TIMER_TIC()                onTimerTicNested()
+# define CALL_SEND_EVENT(eventVec)          sendEventNested(eventVec)
+#else
+# define CALL_ON_TIMER_TIC()                onTimerTic()
+# define CALL_SEND_EVENT(eventVec)          sendEvent(eventVec)
+#endif
+
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+/** The number of bytes of the bit vector, which has a set bit for each priority class with
+    at least one due task. */
+# define NO_BYTES_PRIO_CLASS_VEC    ((RTOS_NO_PRIO_CLASSES+7)/8)
+# if NO_BYTES_PRIO_CLASS_VEC > 8
+#  error The priority class bitmap supports no more than 64 priority classes
+# endif
+#endif
+
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+# if RTOS_EDF_PRIO_CLASS >= RTOS_NO_PRIO_CLASSES
+#  error The priority class, which is scheduled earliest deadline first, does not exist
+# endif
+#endif
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+# if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+#  error The CPU budget of tasks cannot be combined with mutex priority inheritance
+# endif
+# if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+#  error The CPU budget of tasks cannot be combined with tickless idle
+# endif
+# if RTOS_BUDGET_DEMOTION_PRIO_CLASS >= RTOS_NO_PRIO_CLASSES
+#  error The priority class of tasks, which exhausted their budget, does not exist
+# endif
+# if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON                                        \
+     &&  RTOS_BUDGET_DEMOTION_PRIO_CLASS == RTOS_EDF_PRIO_CLASS
+#  error The priority class of tasks, which exhausted their budget, must not be the EDF class
+# endif
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/* The watchdog is serviced in the system timer tic, which must not be stopped. */
+# if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+#  error The liveness monitor cannot be combined with tickless idle
+# endif
+#endif
+
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/* In cooperative mode, no interrupt must save the context or change the position of the
+   active task in the due lists. */
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON                                      \
+     ||  RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON                                  \
+     ||  defined(RTOS_APPL_INTERRUPT_TABLE)
+#  error Cooperative scheduling requires rtos_sendEventFromISR instead of application interrupts
+# endif
+# if RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON                                      \
+     ||  RTOS_USE_NESTED_INTERRUPTS == RTOS_FEATURE_ON
+#  error Cooperative scheduling cannot be combined with the lazy context save or nested interrupts
+# endif
+# if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON                                 \
+     ||  RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON                                        \
+     ||  RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+#  error Cooperative scheduling cannot be combined with round robin, task budgets or EDF
+# endif
+/** In cooperative mode, the interrupts only make tasks due. The decision about the active
+    task is deferred till the next kernel call of a task, which can switch the task. */
+# define IS_RESCHEDULE_PENDING()    (_isReschedulePending)
+#else
+/** In preemptive mode, the decision about the active task is taken in the interrupt,
+    which makes a task due. */
+# define IS_RESCHEDULE_PENDING()    false
+#endif
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_OFF                                     \
+     &&  RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_OFF
+#  error The latency histogram requires at least one application interrupt
+# endif
+# if RTOS_ISR_LATENCY_NO_BUCKETS < 2  ||  RTOS_ISR_LATENCY_NO_BUCKETS > 17
+#  error The number of buckets of the latency histogram is out of range 2..17
+# endif
+/** The events of the two application interrupts; 0 for a disabled interrupt. */
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+#  define EVT_ISR_LATENCY_00    RTOS_EVT_ISR_USER_00
+# else
+#  define EVT_ISR_LATENCY_00    0
+# endif
+# if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
+#  define EVT_ISR_LATENCY_01    RTOS_EVT_ISR_USER_01
+# else
+#  define EVT_ISR_LATENCY_01    0
+# endif
+#endif
+
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+# if (RTOS_TIMER_WHEEL_SIZE & (RTOS_TIMER_WHEEL_SIZE-1)) != 0 || RTOS_TIMER_WHEEL_SIZE < 2
+#  error The size of the timer wheel needs to be a power of two
+# endif
+/** The mask, which maps a point in time onto the related bucket of the timer wheel. */
+# define MASK_TIMER_WHEEL_IDX   ((uintTime_t)(RTOS_TIMER_WHEEL_SIZE-1))
+#endif
+
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+/** The number of system timer tics, which make up one period of timer 2 while the system
+    is in a tickless period. The setting of the timer prescaler is changed from 128 to
+    1024. */
+# define TICKLESS_NO_TICS_PER_PERIOD    8
+
+/** The value of TCCR2B, which selects the clock of timer 2 in normal operation: CPU clock
+    divided by 128, CS2 = %101. */
+# define TCCR2B_NORMAL_TICS     (_BV(CS22) | _BV(CS20))
+
+/** The value of TCCR2B, which selects the clock of timer 2 in a tickless period: CPU
+    clock divided by 1024, CS2 = %111. */
+# define TCCR2B_TICKLESS        (_BV(CS22) | _BV(CS21) | _BV(CS20))
+#endif
+
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+/** The duration of a system timer tic in microseconds as it results from the configuration
+    of timer 2 in rtos_enableIRQTimerTic. */
+# if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+#  define TIMESTAMP_US_PER_TIC  2048ul
+# else
+#  define TIMESTAMP_US_PER_TIC  2040ul
+# endif
+#endif
+
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON  &&  RTOS_USE_MUTEX == RTOS_FEATURE_OFF
+/* Priority inheritance is meaningless if the application doesn't use mutexes. */
+# undef RTOS_USE_MUTEX_PRIO_INHERITANCE
+# define RTOS_USE_MUTEX_PRIO_INHERITANCE RTOS_FEATURE_OFF
+#endif
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+/** The number of events, which have a list of waiting tasks. These are all events but the
+    two timer events; the timers are handled by the system timer tic. */
+# define NO_INDEXED_EVENTS      (RTOS_EVENT_VECTOR_BITS-2)
+#endif
+
+/** The size of an element of the array of task objects, given the size of the task
+    object. If #RTOS_ALIGN_TASK_OBJECTS is set, this is the next power of two. */
+#if RTOS_ALIGN_TASK_OBJECTS == RTOS_FEATURE_ON
+# define SIZE_OF_TASK_SLOT(sizeOfTask)                                              \
+            ((sizeOfTask) <= 8? 8: (sizeOfTask) <= 16? 16: (sizeOfTask) <= 32? 32: 64)
+#else
+# define SIZE_OF_TASK_SLOT(sizeOfTask)  (sizeOfTask)
+#endif
+
 /** A pattern byte, which is used as prefill byte of any task stack area. A simple and
     inexpensive stack usage check at runtime can be implemented by looking for up to where
     this pattern has been destroyed. Any value which is not the null and which is
@@ -82,6 +403,66 @@
     be. */
 #define UNUSED_STACK_PATTERN 0x29
 
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+/** The number of bytes at the bottom of each task stack, which are checked for the
+    pattern byte #UNUSED_STACK_PATTERN in every system timer tic. */
+# define SIZE_OF_STACK_CANARY   2
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/** The value of \a livenessFailureRecord_t::magic, which marks a valid record. */
+# define MAGIC_LIVENESS_FAILURE_RECORD  0x4c46u
+#endif
+
+#if RTOS_USE_LAZY_STACK_FILL == RTOS_FEATURE_ON
+/** The number of pattern bytes, which are written by the idle task in a single critical
+    section. The value determines the additional interrupt latency. */
+# define NO_BYTES_STACK_FILL_CHUNK  16
+
+/** The attribute of the stack areas, which are allocated by the kernel. They are not
+    cleared by the C runtime at startup. */
+# define ATTRIB_TASK_STACK          __attribute__((section(".noinit")))
+#else
+# define ATTRIB_TASK_STACK
+#endif
+
+#if defined(RTOS_TASK_TABLE)  &&  !defined(RTOS_HOST_SIMULATION)
+/** Get the begin of the stack area of a task. If the tasks are configured by table
+    #RTOS_TASK_TABLE, then the task descriptors are located in flash ROM. */
+# define STACK_AREA_OF_TASK(idxTask)                                                        \
+            ((uint8_t*)pgm_read_word(&_taskDescriptorAry[idxTask].pStackArea))
+#else
+# define STACK_AREA_OF_TASK(idxTask)    (_taskDescriptorAry[idxTask].pStackArea)
+#endif
+
+/** A check of a constant expression at compile time. If \a cond is false, then the
+    compilation fails with an error message about the negative size of the array \a
+    nameOfCheck. The name should therefore describe the failing condition. */
+#define STATIC_ASSERT(cond, nameOfCheck)    typedef char nameOfCheck[(cond)? 1: -1]
+
+#if RTOS_EVENT_VECTOR_BITS == 16
+/** The return value of a suspend command, the event vector, is returned in the register
+    pair r24/r25. r22/r23 are ordinary registers of the saved context. */
+# define ASM_PUSH_R22R23_OF_CONTEXT     "push r22 \n\t" "push r23 \n\t"
+/** Counterpart of #ASM_PUSH_R22R23_OF_CONTEXT. */
+# define ASM_POP_R23R22_OF_CONTEXT      "pop r23 \n\t" "pop r22 \n\t"
+/** r22/r23 don't belong to the return value of a suspend command. */
+# define ASM_PUSH_R22R23_OF_RET_VAL
+/** Counterpart of #ASM_PUSH_R22R23_OF_RET_VAL. */
+# define ASM_POP_R23R22_OF_RET_VAL
+#else
+/** A 32 Bit event vector is returned by a suspend command in the registers r22..r25. r22
+    and r23 are handled like r24/r25: They are saved last and they are not saved by the
+    suspend commands. */
+# define ASM_PUSH_R22R23_OF_CONTEXT
+/** Counterpart of #ASM_PUSH_R22R23_OF_CONTEXT. */
+# define ASM_POP_R23R22_OF_CONTEXT
+/** r22/r23 hold the lower half of the return value of a suspend command. */
+# define ASM_PUSH_R22R23_OF_RET_VAL     "push r22 \n\t" "push r23 \n\t"
+/** Counterpart of #ASM_PUSH_R22R23_OF_RET_VAL. */
+# define ASM_POP_R23R22_OF_RET_VAL      "pop r23 \n\t" "pop r22 \n\t"
+#endif
+
 /** An important code pattern, which is used in every interrupt routine, which can result
     in a context switch. The CPU context except for the program counter is saved by pushing
     it onto the stack of the given context. The program counter is not explicitly saved:
@@ -96,7 +477,8 @@
 #define PUSH_CONTEXT_ONTO_STACK                     \
     PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK;         \
     asm volatile                                    \
-    ( "push r24 \n\t"                               \
+    ( ASM_PUSH_R22R23_OF_RET_VAL                    \
+      "push r24 \n\t"                               \
       "push r25 \n\t"                               \
     );
 /* End of macro PUSH_CONTEXT_ONTO_STACK */
@@ -109,13 +491,41 @@
     commands, the restore context should still be done with the other macro
     #POP_CONTEXT_FROM_STACK. However, before using this macro, the return code of the
     suspend command needs to be pushed onto the stack so that it is loaded into the CPU's
-    register pair r24/r25 as part of macro #POP_CONTEXT_FROM_STACK.
+    register pair r24/r25 as part of macro #POP_CONTEXT_FROM_STACK.\n
+      If the event vector has 32 Bit then the return value and the registers, which are
+    not saved by this macro, are r22..r25.
       @remark The function which uses this pattern must not be inlined, otherwise the PC
     would not be part of the saved context and the system would crash when trying to return
     to this context the next time!
       @remark This pattern needs to be changed only in strict accordance with the
     counterpart pattern, which pops the context from a stack back into the CPU. */
-#define PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK         \
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/* In cooperative mode, the context is saved only by kernel functions, which are called
+   from task code. The call clobbered registers, the status register and the zero register
+   don't need to be saved; only r2..r17, r28 and r29 belong to the context. */
+# define PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK        \
+    asm volatile                                       \
+    ( "push r2 \n\t"                                   \
+      "push r3 \n\t"                                   \
+      "push r4 \n\t"                                   \
+      "push r5 \n\t"                                   \
+      "push r6 \n\t"                                   \
+      "push r7 \n\t"                                   \
+      "push r8 \n\t"                                   \
+      "push r9 \n\t"                                   \
+      "push r10 \n\t"                                  \
+      "push r11 \n\t"                                  \
+      "push r12 \n\t"                                  \
+      "push r13 \n\t"                                  \
+      "push r14 \n\t"                                  \
+      "push r15 \n\t"                                  \
+      "push r16 \n\t"                                  \
+      "push r17 \n\t"                                  \
+      "push r28 \n\t"                                  \
+      "push r29 \n\t"                                  \
+    );
+#else
+# define PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK        \
     asm volatile                                       \
     ( "push r0 \n\t"                                   \
       "in r0, __SREG__\n\t"                            \
@@ -141,8 +551,7 @@
       "push r19 \n\t"                                  \
       "push r20 \n\t"                                  \
       "push r21 \n\t"                                  \
-      "push r22 \n\t"                                  \
-      "push r23 \n\t"                                  \
+      ASM_PUSH_R22R23_OF_CONTEXT                       \
       "push r26 \n\t"                                  \
       "push r27 \n\t"                                  \
       "push r28 \n\t"                                  \
@@ -150,9 +559,67 @@
       "push r30 \n\t"                                  \
       "push r31 \n\t"                                  \
     );
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
 /* End of macro PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK */
 
 
+#if RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON
+/** A code pattern, which is used at the beginning of the system timer interrupt if the
+    lazy context save is configured. Only those registers are saved onto the stack, which
+    may be altered by a call of a C function (plus the status register and the zero
+    register). The other registers are saved by the called C function itself if it uses
+    them.\n
+      If the interrupt results in a task switch, these registers are popped again by
+    #POP_CALL_CLOBBERED_REGISTERS_FROM_STACK and the complete context is saved by
+    #PUSH_CONTEXT_ONTO_STACK.
+      @remark This pattern needs to be changed only in strict accordance with the
+    counterpart pattern #POP_CALL_CLOBBERED_REGISTERS_FROM_STACK. */
+# define PUSH_CALL_CLOBBERED_REGISTERS_ONTO_STACK    \
+    asm volatile                                    \
+    ( "push r0 \n\t"                                \
+      "in r0, __SREG__\n\t"                         \
+      "push r0 \n\t"                                \
+      "push r1 \n\t"                                \
+      "push r18 \n\t"                               \
+      "push r19 \n\t"                               \
+      "push r20 \n\t"                               \
+      "push r21 \n\t"                               \
+      "push r22 \n\t"                               \
+      "push r23 \n\t"                               \
+      "push r24 \n\t"                               \
+      "push r25 \n\t"                               \
+      "push r26 \n\t"                               \
+      "push r27 \n\t"                               \
+      "push r30 \n\t"                               \
+      "push r31 \n\t"                               \
+    );
+/* End of macro PUSH_CALL_CLOBBERED_REGISTERS_ONTO_STACK */
+
+
+/** The counterpart of #PUSH_CALL_CLOBBERED_REGISTERS_ONTO_STACK. */
+# define POP_CALL_CLOBBERED_REGISTERS_FROM_STACK     \
+    asm volatile                                    \
+    ( "pop r31 \n\t"                                \
+      "pop r30 \n\t"                                \
+      "pop r27 \n\t"                                \
+      "pop r26 \n\t"                                \
+      "pop r25 \n\t"                                \
+      "pop r24 \n\t"                                \
+      "pop r23 \n\t"                                \
+      "pop r22 \n\t"                                \
+      "pop r21 \n\t"                                \
+      "pop r20 \n\t"                                \
+      "pop r19 \n\t"                                \
+      "pop r18 \n\t"                                \
+      "pop r1 \n\t"                                 \
+      "pop r0 \n\t"                                 \
+      "out __SREG__, r0 \n\t"                       \
+      "pop r0 \n\t"                                 \
+    );
+/* End of macro POP_CALL_CLOBBERED_REGISTERS_FROM_STACK */
+#endif /* RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON */
+
+
 /** An important code pattern, which is used in every interrupt routine (including the
     suspend commands, which can be considered pseudo-software interrupts). The CPU context
     except for the program counter is restored by popping it from the stack of the given
@@ -164,18 +631,46 @@
       @remark This pattern needs to be changed only in strict accordance with the
     counterpart patterns, which push the context onto the stack. The pattern need to be
     the inverse of each other. */
-#define POP_CONTEXT_FROM_STACK          \
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/* The cooperative context consists of the call saved registers only, see
+   #PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK. */
+# define POP_CONTEXT_FROM_STACK         \
+    asm volatile                        \
+    ( "pop r25 \n\t"                    \
+      "pop r24 \n\t"                    \
+      ASM_POP_R23R22_OF_RET_VAL         \
+      "pop r29 \n\t"                    \
+      "pop r28 \n\t"                    \
+      "pop r17 \n\t"                    \
+      "pop r16 \n\t"                    \
+      "pop r15 \n\t"                    \
+      "pop r14 \n\t"                    \
+      "pop r13 \n\t"                    \
+      "pop r12 \n\t"                    \
+      "pop r11 \n\t"                    \
+      "pop r10 \n\t"                    \
+      "pop r9 \n\t"                     \
+      "pop r8 \n\t"                     \
+      "pop r7 \n\t"                     \
+      "pop r6 \n\t"                     \
+      "pop r5 \n\t"                     \
+      "pop r4 \n\t"                     \
+      "pop r3 \n\t"                     \
+      "pop r2 \n\t"                     \
+    );
+#else
+# define POP_CONTEXT_FROM_STACK         \
     asm volatile                        \
     ( "pop r25 \n\t"                    \
       "pop r24 \n\t"                    \
+      ASM_POP_R23R22_OF_RET_VAL         \
       "pop r31 \n\t"                    \
       "pop r30 \n\t"                    \
       "pop r29 \n\t"                    \
       "pop r28 \n\t"                    \
       "pop r27 \n\t"                    \
       "pop r26 \n\t"                    \
-      "pop r23 \n\t"                    \
-      "pop r22 \n\t"                    \
+      ASM_POP_R23R22_OF_CONTEXT         \
       "pop r21 \n\t"                    \
       "pop r20 \n\t"                    \
       "pop r19 \n\t"                    \
@@ -201,6 +696,7 @@
       "out __SREG__, r0 \n\t"           \
       "pop r0 \n\t"                     \
     );
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
 /* End of macro POP_CONTEXT_FROM_STACK */
 
 
@@ -217,7 +713,27 @@
       The routine depends on a reset global interrupt flag.\n
       The implementation must be compatible with a naked function. In particular, it must
     not define any local data! */
-#define SWITCH_CONTEXT                                                                      \
+#if RTOS_USE_REGISTER_CONTEXT_SWITCH == RTOS_FEATURE_ON
+# define SWITCH_CONTEXT                                                                     \
+{                                                                                           \
+    /* The current stack pointer is stored directly into the task object of the left task. \
+       The stack pointer of the new active task is loaded into a register pair by the       \
+       compiler. No intermediate variables in RAM are involved. */                          \
+    asm volatile                                                                            \
+    ( "in r0, __SP_L__ \n\t"                                                                \
+      "st %a0, r0 /* Save l-byte of current stack pointer in the left task */ \n\t"         \
+      "in r0, __SP_H__ \n\t"                                                                \
+      "std %a0+1, r0 \n\t"                                                                  \
+      "out __SP_L__, %A1 /* Write l-byte of new stack pointer content */ \n\t"              \
+      "out __SP_H__, %B1 /* Write h-byte of new stack pointer content */ \n\t"              \
+      : /* Output operands */                                                               \
+      : /* Input operands */ "b" (&_pSuspendedTask->stackPointer)                           \
+                           , "r" (_pActiveTask->stackPointer)                               \
+      : /* Clobbered */ "memory"                                                            \
+    );                                                                                      \
+} /* End of macro SWITCH_CONTEXT */
+#else
+# define SWITCH_CONTEXT                                                                     \
 {                                                                                           \
     /* Switch the stack pointer to the (saved) stack pointer of the new active task. */     \
     _tmpVarCToAsm_u16 = _pActiveTask->stackPointer;                                         \
@@ -234,6 +750,76 @@
     _pSuspendedTask->stackPointer = _tmpVarAsmToC_u16;                                      \
                                                                                             \
 } /* End of macro SWITCH_CONTEXT */
+#endif
+
+
+
+#if RTOS_USE_REGISTER_CONTEXT_SWITCH == RTOS_FEATURE_ON
+# if RTOS_EVENT_VECTOR_BITS == 16
+/** The assembly code, which pushes the return value of a suspend command, operand 0, at
+    the context positions of the return value registers. */
+#  define ASM_PUSH_RET_CODE                                                                 \
+          "push %A0 \n\t"                       /* Push low byte at context position r24. */ \
+          "push %B0 \n\t"                       /* Push high byte at context position r25. */
+# else
+/** The assembly code, which pushes the return value of a suspend command, operand 0, at
+    the context positions of the return value registers. */
+#  define ASM_PUSH_RET_CODE                                                                 \
+          "push %A0 \n\t"                       /* Push byte 0 at context position r22. */  \
+          "push %B0 \n\t"                       /* Push byte 1 at context position r23. */  \
+          "push %C0 \n\t"                       /* Push byte 2 at context position r24. */  \
+          "push %D0 \n\t"                       /* Push byte 3 at context position r25. */
+# endif
+
+/** Push the return value of a suspend command onto the stack of the new active task. The
+    value is passed to the assembly code in registers, which are loaded by the compiler. */
+# define PUSH_RET_CODE(retCode)                                                             \
+        asm volatile                                                                        \
+        ( ASM_PUSH_RET_CODE                                                                 \
+          : /* Output operands */                                                           \
+          : /* Input operands */ "r" (retCode)                                              \
+        )
+#else
+# if RTOS_EVENT_VECTOR_BITS == 16
+/** The global variable, which passes the return value of a suspend command to the
+    assembly code. */
+#  define TMP_VAR_C_TO_ASM_RET_CODE  _tmpVarCToAsm_u16
+
+/** The assembly code, which pushes the return value of a suspend command at the context
+    positions of the return value registers. */
+#  define ASM_PUSH_RET_CODE                                                                  \
+          "lds r0, _tmpVarCToAsm_u16 \n\t"      /* Read low byte of return code. */         \
+          "push r0 \n\t"                        /* Push it at context position r24. */      \
+          "lds r0, _tmpVarCToAsm_u16+1 \n\t"    /* Read high byte of return code. */        \
+          "push r0 \n\t"                        /* Push it at context position r25. */
+# else
+/** The global variable, which passes the return value of a suspend command to the
+    assembly code. */
+#  define TMP_VAR_C_TO_ASM_RET_CODE  _tmpVarCToAsm_u32
+
+/** The assembly code, which pushes the return value of a suspend command at the context
+    positions of the return value registers. */
+#  define ASM_PUSH_RET_CODE                                                                  \
+          "lds r0, _tmpVarCToAsm_u32 \n\t"      /* Read byte 0 of return code. */           \
+          "push r0 \n\t"                        /* Push it at context position r22. */      \
+          "lds r0, _tmpVarCToAsm_u32+1 \n\t"    /* Read byte 1 of return code. */           \
+          "push r0 \n\t"                        /* Push it at context position r23. */      \
+          "lds r0, _tmpVarCToAsm_u32+2 \n\t"    /* Read byte 2 of return code. */           \
+          "push r0 \n\t"                        /* Push it at context position r24. */      \
+          "lds r0, _tmpVarCToAsm_u32+3 \n\t"    /* Read byte 3 of return code. */           \
+          "push r0 \n\t"                        /* Push it at context position r25. */
+# endif
+
+/** Push the return value of a suspend command onto the stack of the new active task. The
+    value is passed to the assembly code in a global variable. */
+# define PUSH_RET_CODE(retCode)                                                             \
+    {                                                                                       \
+        TMP_VAR_C_TO_ASM_RET_CODE = (retCode);                                              \
+        asm volatile                                                                        \
+        ( ASM_PUSH_RET_CODE                                                                 \
+        );                                                                                  \
+    }
+#endif
 
 
 
@@ -260,24 +846,17 @@
        a task is suspended it always pauses inside the suspend command. */                  \
     if(_pActiveTask->postedEventVec > 0)                                                    \
     {                                                                                       \
-        _tmpVarCToAsm_u16 = _pActiveTask->postedEventVec;                                   \
+        /* Yes, the new context was suspended before, i.e. it currently pauses inside a     \
+           suspend command, waiting for its completion and expecting its return value.      \
+           Place this value onto the new stack and let it be loaded by the restore          \
+           context operation below. */                                                      \
+        PUSH_RET_CODE(_pActiveTask->postedEventVec);                                        \
                                                                                             \
         /* Neither at state changes active -> ready, and nor at changes ready ->            \
            active, the event vector is touched. It'll be set only at state changes          \
            suspended -> ready. If we reset it now, we will surely not run into this if      \
            clause again after later changes active -> ready -> active. */                   \
         _pActiveTask->postedEventVec = 0;                                                   \
-                                                                                            \
-        /* Yes, the new context was suspended before, i.e. it currently pauses inside a     \
-           suspend command, waiting for its completion and expecting its return value.      \
-           Place this value onto the new stack and let it be loaded by the restore          \
-           context operation below. */                                                      \
-        asm volatile                                                                        \
-        ( "lds r0, _tmpVarCToAsm_u16 \n\t"      /* Read low byte of return code. */         \
-          "push r0 \n\t"                        /* Push it at context position r24. */      \
-          "lds r0, _tmpVarCToAsm_u16+1 \n\t"    /* Read high byte of return code. */        \
-          "push r0 \n\t"                        /* Push it at context position r25. */      \
-        );                                                                                  \
     } /* if(Do we need to place a suspend command's return code onto the new stack?) */     \
                                                                                             \
 } /* End of macro PUSH_RET_CODE_OF_CONTEXT_SWITCH */
@@ -297,35 +876,112 @@
  * Local type definitions
  */
 
-/** The descriptor of any task. Contains static information like task priority class and
-    dynamic information like received events, timer values etc. This type is invisible to
-    the RTuinOS application code.
-      @remark Some members of the struct are not used by the kernel at runtime, e.g. the
-    pointer to the task function or the definition of the stack area. These elements or
-    parts of them could be placed into a second array such that the remaining data
-    structure had a size which is a power of 2. (Maybe with a few padding bytes.) This
-    would speed-up - and maybe significantly - the address computations the kernel often has
-    to do when accessing the task information. */
-typedef struct
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+/** The statistics of a measured duration. The average is computed on demand from the sum
+    of all samples and their number. */
+typedef struct timingStatistics_t
+{
+    /** The minimum of all samples in microseconds. */
+    uint32_t tiMin;
+
+    /** The maximum of all samples in microseconds. */
+    uint32_t tiMax;
+
+    /** The sum of all samples in microseconds. */
+    uint32_t tiSum;
+
+    /** The number of samples in \a tiSum. */
+    uint16_t noSamples;
+
+} timingStatistics_t;
+#endif
+
+
+/** The runtime data of any task. Contains the information like task priority class,
+    received events, timer values etc., which is permanently used by the scheduler. This
+    type is invisible to the RTuinOS application code.
+      @remark The struct has a tag name, which permits the struct to reference objects of
+    its own type.
+      @remark The data, which is used only at initialization time, like the pointer to the
+    task function or the definition of the stack area, is held in a separate object of type
+    taskDescriptor_t. Optionally, the size of the task objects is extended to the next
+    power of two, see #RTOS_ALIGN_TASK_OBJECTS and type taskSlot_t. */
+typedef struct task_t
 {
     /** The saved stack pointer of this task whenever it is not active.\n
           For optimization reasons, this element should come first. It's most often used in
         the core routines and can be addressed with less machine code if it has offset 0
         inside the struct. */
-    uint16_t stackPointer;
+    uintptr_t stackPointer;
 
     /** The priority class this task belongs to. Priority class 255 has the highest
         possible priority and the lower the value the lower the priority. */
     uint8_t prioClass;
 
-    /** The task function as a function pointer. It is used once and only once: The task
-        function is invoked the first time the task becomes active and must never end. A
-        return statement would cause an immediate reset of the controller. */
-    rtos_taskFunction_t taskFunction;
-
     /** The timer value triggering the task local absolute-timer event. */
     uintTime_t timeDueAt;
 
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    /** The absolute deadline of the current activation of the task. The due list of
+        priority class #RTOS_EDF_PRIO_CLASS is sorted by this value. For a regular task it
+        is the next point in time the task will be due at, i.e. \a timeDueAt plus the
+        period, for all other tasks it is the time they became due. */
+    uintTime_t timeDeadline;
+#endif
+
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+    /** The period of a periodic task in system timer tics or 0 if the task is not
+        periodic, see rtos_setTaskPeriod. */
+    uintTime_t period;
+
+    /** The nominal release time of the current activation of a periodic task. It is on
+        the grid of the period, whereas \a timeDueAt may deviate from the grid after an
+        overrun. */
+    uintTime_t timeRelease;
+
+    /** The reaction on an overrun of a periodic task, one out of
+        #RTOS_OVERRUN_POLICY_IMMEDIATE, #RTOS_OVERRUN_POLICY_SKIP and
+        #RTOS_OVERRUN_POLICY_CATCH_UP. */
+    uint8_t overrunPolicy;
+#endif
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+    /** The CPU budget of the task in system timer tics per replenishment period or 0 if
+        the task has no budget, see rtos_setTaskBudget. */
+    uintTime_t budget;
+
+    /** The replenishment period of the budget in system timer tics. */
+    uintTime_t periodReplenish;
+
+    /** The budget, which is left in the current replenishment period. The task has
+        exhausted its budget and is demoted if the counter is 0 while \a budget is not. */
+    uintTime_t cntBudget;
+
+    /** The timer tic decremented counter till the next replenishment of the budget. */
+    uintTime_t cntReplenish;
+
+    /** The priority class of the task as long as it has budget left. */
+    uint8_t prioClassBudget;
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+    /** The maximum time between two check-ins of the task in system timer tics or 0 if
+        the task is not monitored, see rtos_setTaskLivenessPeriod. */
+    uintTime_t periodLiveness;
+
+    /** The timer tic decremented counter till the next check-in of the task is due. It is
+        reloaded by rtos_checkInTask. The task has missed its check-in if it becomes 0. */
+    uintTime_t cntLiveness;
+#endif
+
+    /** The next task in the list of suspended tasks or NULL if this is the last one. The
+        element is valid only while the task is suspended. */
+    struct task_t *pNextSuspendedTask;
+
+    /** The preceding task in the list of suspended tasks or NULL if this is the first
+        one. The element is valid only while the task is suspended. */
+    struct task_t *pPrevSuspendedTask;
+
 #if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
     /** The maximum time a task may be activated if it is operated in round-robin mode. The
         range is 1..max_value(uintTime_t).\n
@@ -337,16 +993,16 @@ typedef struct
     uintTime_t timeRoundRobin;
 #endif
 
-    /** The pointer to the preallocated stack area of the task. The area needs to be
-        available all the RTOS runtime. Therefore dynamic allocation won't pay off. Consider
-        to use the address of any statically defined array. There's no alignment
-        constraint. */
-    uint8_t *pStackArea;
-
-    /** The size in Byte of the memory area \a *pStackArea, which is reserved as stack for
-        the task. Each task may have an individual stack size. */
-    uint16_t stackSize;
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+    /** The point in time, when the timer event of the task is due. The same element is
+        used for both kinds of timer: For the absolute timer it is identical to \a
+        timeDueAt, for the delay timer it is the time at suspension plus the delay.\n
+          The element is valid only while the task is linked into the timer wheel. */
+    uintTime_t timeTimeout;
 
+    /** The next task, which is linked into the same bucket of the timer wheel. */
+    struct task_t *pNextTimeout;
+#else
     /** The timer tic decremented counter triggering the task local delay-timer event.\n
           The initial value determines at which system timer tic the task becomes due the
         very first time. This may always by 1 (task becomes due immediately). In the use
@@ -354,6 +1010,13 @@ typedef struct
         grid in order to avoid too many due tasks regularly at specific points in time. See
         documentation for more. */
     uintTime_t cntDelay;
+#endif
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+    /** The index of the task in the array of all tasks. Needed to find the task from an
+        entry in the lists of waiting tasks. */
+    uint8_t idxTask;
+#endif
 
 #if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
     /** The timer tic decremented counter triggering a task switch in round-robin mode. */
@@ -361,14 +1024,24 @@ typedef struct
 #endif
 
     /** The events posted to this task. */
-    uint16_t postedEventVec;
+    uintEventVec_t postedEventVec;
 
     /** The mask of events which will make this task due. */
-    uint16_t eventMask;
+    uintEventVec_t eventMask;
 
     /** Do we need to wait for the first posted event or for all events? */
     boolean waitForAnyEvent;
 
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+    /** The notifications, which have been posted to this task but which have not been
+        taken by rtos_waitForNotification yet. */
+    uintNotificationVec_t notificationVec;
+
+    /** The notifications, which resume the task. The mask is not zero only while the task
+        is suspended in rtos_waitForNotification. */
+    uintNotificationVec_t notificationMask;
+#endif
+
     /** All recognized overruns of the timing of this task are recorded in this variable.
         The access to this variable is considered atomic by the implementation, therefore
         no other type than 8 Bit must be used.\n
@@ -379,96 +1052,546 @@ typedef struct
         discussion in the documentation of type uintTime_t. */
     uint8_t cntOverrun;
 
-} task_t;
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    /** The lowest value of the stack pointer, which has been seen while the task was
+        active. The stack pointer is sampled on every entry into the kernel. */
+    uint16_t minStackPointer;
+#endif
 
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    /** The priority class the task has been configured for. \a prioClass differs from
+        this value while the task owns a mutex, which a task of higher priority waits for;
+        the owner has inherited the priority of the waiting task. */
+    uint8_t prioClassBase;
+#endif
 
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+    /** The park state of the task, one out of #PARK_STATE_NONE, #PARK_STATE_PENDING and
+        #PARK_STATE_PARKED. */
+    uint8_t parkState;
+#endif
 
-/*
- * Local prototypes
- */
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    /** The accumulated time in microseconds, which the task has been the active task. The
+        time, which is spent in interrupts, is accounted to the interrupted task. */
+    uint32_t tiRuntime;
+#endif
 
-RTOS_DEFAULT_FCT void rtos_enableIRQTimerTic(void);
-static RTOS_TRUE_FCT boolean onTimerTic(void);
-static RTOS_TRUE_FCT boolean sendEvent(uint16_t eventVec);
-RTOS_NAKED_FCT void rtos_sendEvent(uint16_t eventVec);
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+    /** The world time in microseconds, when the task was released, i.e. when the task
+        became due after having been suspended. */
+    uint32_t tiRelease;
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-static RTOS_TRUE_FCT boolean waitForEvent( uint16_t eventMask
-                                           , boolean all
-                                           , uintTime_t timeout
-                                           );
-#else
-static RTOS_TRUE_FCT void waitForEvent(uint16_t eventMask, boolean all, uintTime_t timeout);
+    /** The world time in microseconds, when the task became active the first time after
+        its release. */
+    uint32_t tiStart;
+
+    /** The statistics of the time from release of the task till it becomes active. */
+    timingStatistics_t statStartLatency;
+
+    /** The statistics of the time from the first activation of the task after its release
+        till it suspends again. The time of preemption by other tasks and interrupts is
+        included. */
+    timingStatistics_t statExecutionTime;
 #endif
 
-RTOS_NAKED_FCT uint16_t rtos_waitForEvent( uint16_t eventMask
-                                         , boolean all
-                                         , uintTime_t timeout
-                                         );
+} task_t;
 
 
-/*
- * Data definitions
- */
+/** The array of task objects is indexed by the task ID. The AVR has no efficient
+    multiplication for the offset computation unless the size of the array elements is a
+    power of two. Therefore, the task object is embedded in a union whose size can be
+    extended to the next power of two at the expense of some padding bytes. */
+typedef union taskSlot_t
+{
+    /** The task object. */
+    task_t task;
 
-/** The RTuinOS startup message is placed in the flash ROM. Here, memory is not expensive.
-    Consider to use \a Serial.println or \a puts_progmem to print such a string in the
-    Arduino console window. Or Please refer to tc12/stdout.c, test case tc12, for more.\n
-      See http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734 why not using PROGMEM for the
-    declaration and #RTOS_PROGMEM_SECTION for a valid substitute.
-      @see int puts_progmem(const char *) */
-RTOS_PROGMEM_SECTION const char rtos_rtuinosStartupMsg[] = "\r" RTOS_RTUINOS_STARTUP_MSG;
+    /** Padding space, which determines the size of the union. */
+    uint8_t alignToPowerOfTwo[SIZE_OF_TASK_SLOT(sizeof(task_t))];
 
-/** The system time. A cyclic counter of the timer tics. The counter is interrupt driven.
-    The unit of the time is defined only by the it triggering source and doesn't matter at
-    all for the kernel. The time even don't need to be regular.\n
-      The initial value is such that the time is 0 during the execution of the very first
-    system timer interrupt service. This is important for getting a task startup behavior,
-    which is transparent and predictable for the application. */
-static uintTime_t _time = (uintTime_t)-1;
+} taskSlot_t;
 
-/** Array of all the task objects. The array has one additional element to store the
+
+/** The static part of the description of a task. This data is set by the application and
+    used only once, at initialization time of the RTOS. It's kept apart from the runtime
+    data the scheduler works on. */
+typedef struct taskDescriptor_t
+{
+    /** The task function as a function pointer. It is used once and only once: The task
+        function is invoked the first time the task becomes active and must never end. A
+        return statement would cause an immediate reset of the controller. */
+    rtos_taskFunction_t taskFunction;
+
+    /** The pointer to the preallocated stack area of the task. The area needs to be
+        available all the RTOS runtime. Therefore dynamic allocation won't pay off. Consider
+        to use the address of any statically defined array. There's no alignment
+        constraint. */
+    uint8_t *pStackArea;
+
+    /** The size in Byte of the memory area \a *pStackArea, which is reserved as stack for
+        the task. Each task may have an individual stack size. */
+    uint16_t stackSize;
+
+#ifdef RTOS_TASK_TABLE
+    /** The remaining arguments of rtos_initializeTask are taken from the table
+        #RTOS_TASK_TABLE, too. See there for their meaning. */
+    uint8_t prioClass;
+
+    /** See rtos_initializeTask. The value is ignored if round robin is not supported. */
+    uintTime_t timeRoundRobin;
+
+    /** See rtos_initializeTask. */
+    uintEventVec_t startEventMask;
+
+    /** See rtos_initializeTask. */
+    boolean startByAllEvents;
+
+    /** See rtos_initializeTask. */
+    uintTime_t startTimeout;
+#endif
+} taskDescriptor_t;
+
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/** The record of a liveness failure, which survives the reset by the watchdog. The task
+    index is stored twice, the second time inverted; a record, which is found after power
+    up, is not taken for valid by accident. */
+typedef struct livenessFailureRecord_t
+{
+    /** #MAGIC_LIVENESS_FAILURE_RECORD if the record is valid. */
+    uint16_t magic;
+
+    /** The index of the task, which missed its check-in. */
+    uint8_t idxTask;
+
+    /** The inverted value of \a idxTask. */
+    uint8_t idxTaskInv;
+
+} livenessFailureRecord_t;
+#endif
+
+
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+/** The entry of the enumeration of application interrupts for one row of the table
+    #RTOS_APPL_INTERRUPT_TABLE. */
+# define ENUM_APPL_INTERRUPT(vector, eventVec, enableIRQ)   idxApplInterrupt_##vector,
+
+/** The application interrupts, which are configured in table #RTOS_APPL_INTERRUPT_TABLE,
+    are numbered in the order of the table. */
+enum
+{
+    RTOS_APPL_INTERRUPT_TABLE(ENUM_APPL_INTERRUPT)
+    noApplInterrupts
+};
+#endif
+
+
+
+/*
+ * Local prototypes
+ */
+
+RTOS_DEFAULT_FCT void rtos_enableIRQTimerTic(void);
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+RTOS_DEFAULT_FCT void rtos_onStackOverflow(uint8_t idxTask);
+#endif
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+RTOS_DEFAULT_FCT void rtos_onLivenessFailure(uint8_t idxTask);
+# ifndef RTOS_HOST_SIMULATION
+static void disableWatchdogAfterReset(void) __attribute__((naked, used, section(".init3")));
+# endif
+#endif
+static RTOS_TRUE_FCT boolean onTimerTic(void);
+static RTOS_TRUE_FCT boolean sendEvent(uintEventVec_t eventVec);
+#if RTOS_USE_NESTED_INTERRUPTS == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+static RTOS_TRUE_FCT boolean onTimerTicNested(void);
+static RTOS_TRUE_FCT boolean sendEventNested(uintEventVec_t eventVec);
+#endif
+RTOS_NAKED_FCT void rtos_sendEvent(uintEventVec_t eventVec);
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnYield(void);
+RTOS_NAKED_FCT void rtos_yield(void);
+#endif
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+RTOS_NAKED_FCT void applInterruptTail(void);
+#endif
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnLeaveISR(void);
+RTOS_NAKED_FCT void rtos_leaveISR(void);
+#endif
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean notifyTask(uint8_t idxTask, uintNotificationVec_t notificationVec);
+RTOS_NAKED_FCT void rtos_notifyTask(uint8_t idxTask, uintNotificationVec_t notificationVec);
+#endif
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnReschedule(void);
+RTOS_NAKED_FCT void reschedule(void);
+#endif
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean waitForEvent( uintEventVec_t eventMask
+                                         , boolean all
+                                         , uintTime_t timeout
+                                         );
+#else
+static RTOS_TRUE_FCT void waitForEvent( uintEventVec_t eventMask
+                                      , boolean all
+                                      , uintTime_t timeout
+                                      );
+#endif
+
+RTOS_NAKED_FCT uintEventVec_t rtos_waitForEvent( uintEventVec_t eventMask
+                                               , boolean all
+                                               , uintTime_t timeout
+                                               );
+
+#if RTOS_USE_SEND_EVENT_AND_WAIT == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean sendEventAndWait( uintEventVec_t postedEventVec
+                                             , uintEventVec_t eventMask
+                                             , boolean all
+                                             , uintTime_t timeout
+                                             );
+RTOS_NAKED_FCT uintEventVec_t rtos_sendEventAndWait( uintEventVec_t postedEventVec
+                                                   , uintEventVec_t eventMask
+                                                   , boolean all
+                                                   , uintTime_t timeout
+                                                   );
+#endif
+
+
+/*
+ * Data definitions
+ */
+
+/** The RTuinOS startup message is placed in the flash ROM. Here, memory is not expensive.
+    Consider to use \a Serial.println or \a puts_progmem to print such a string in the
+    Arduino console window. Or Please refer to tc12/stdout.c, test case tc12, for more.\n
+      See http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734 why not using PROGMEM for the
+    declaration and #RTOS_PROGMEM_SECTION for a valid substitute.
+      @see int puts_progmem(const char *) */
+RTOS_PROGMEM_SECTION const char rtos_rtuinosStartupMsg[] = "\r" RTOS_RTUINOS_STARTUP_MSG;
+
+/** The system time. A cyclic counter of the timer tics. The counter is interrupt driven.
+    The unit of the time is defined only by the it triggering source and doesn't matter at
+    all for the kernel. The time even don't need to be regular.\n
+      The initial value is such that the time is 0 during the execution of the very first
+    system timer interrupt service. This is important for getting a task startup behavior,
+    which is transparent and predictable for the application. */
+static uintTime_t _time = (uintTime_t)-1;
+
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+/** The number of system timer tics since start of the kernel. Other than \a _time, the
+    counter is not used for scheduling; it's the coarse part of the timestamp, see
+    rtos_getTimestamp. It wraps around after about 101 days. */
+static uint32_t _noTicsTimestamp = 0;
+#endif
+
+/** Array of all the task objects. The array has one additional element to store the
     information about the implicitly defined idle task. (Although most fields of the task
     object are irrelevant for the idle task. Here is potential to save memory space.)\n
       The array is partly initialized by the application repeatedly calling \a
     rtos_initializeTask. The rest of the initialization and the initialization of the idle
     task element is done in \a rtos_initRTOS. */
-static task_t _taskAry[RTOS_NO_TASKS+1];
+static taskSlot_t _taskAry[RTOS_NO_TASKS+1];
+
+#ifdef RTOS_TASK_TABLE
+/** The definition of the stack area of a task for one row of the table #RTOS_TASK_TABLE.
+    The stack areas are allocated by the kernel. */
+# define DEFINE_TASK_STACK( taskFunction, prioClass, timeRoundRobin, stackSize              \
+                          , startEventMask, startByAllEvents, startTimeout                  \
+                          )                                                                 \
+    static uint8_t _taskStack_##taskFunction[stackSize] ATTRIB_TASK_STACK;
+RTOS_TASK_TABLE(DEFINE_TASK_STACK)
+
+/** The descriptor of a task for one row of the table #RTOS_TASK_TABLE. */
+# define TASK_DESCRIPTOR( taskFunction, prioClass, timeRoundRobin, stackSize                \
+                        , startEventMask, startByAllEvents, startTimeout                    \
+                        )                                                                   \
+    { taskFunction, &_taskStack_##taskFunction[0], stackSize                                \
+    , prioClass, timeRoundRobin, startEventMask, startByAllEvents, startTimeout             \
+    },
+
+/** Array of the static descriptions of all tasks but the idle task, which is not
+    described by the application. The index is the same as for \a _taskAry.\n
+      The array is built at compile time from the table #RTOS_TASK_TABLE and located in
+    flash ROM. It is read only by \a rtos_initRTOS and by the diagnostic functions of the
+    stack usage. */
+static const taskDescriptor_t _taskDescriptorAry[RTOS_NO_TASKS] PROGMEM =
+{
+    RTOS_TASK_TABLE(TASK_DESCRIPTOR)
+};
+
+/* The table of tasks needs to match the configured sizes of the kernel's data structures.
+   The checks are done by the compiler, no runtime check is required. */
+STATIC_ASSERT(rtos_noTasksInTaskTable == RTOS_NO_TASKS, RTOS_NO_TASKS_mismatches_RTOS_TASK_TABLE);
+
+/** The number of tasks in table #RTOS_TASK_TABLE, which belong to a given priority class.
+    The count is a compile time constant. (This module is compiled as C++.) */
+template<uint8_t prioClass> struct noTasksInPrioClass_t
+{
+# define COUNT_TASK_IN_PRIO_CLASS( taskFunction, prioClassOfTask, timeRoundRobin, stackSize \
+                                 , startEventMask, startByAllEvents, startTimeout           \
+                                 )                                                          \
+    + ((prioClassOfTask) == prioClass)
+
+    enum { noTasks = 0 RTOS_TASK_TABLE(COUNT_TASK_IN_PRIO_CLASS) };
+};
+
+/** The compile time checks of the settings for one row of the table #RTOS_TASK_TABLE. */
+# define CHECK_TASK( taskFunction, prioClass, timeRoundRobin, stackSize                     \
+                   , startEventMask, startByAllEvents, startTimeout                         \
+                   )                                                                        \
+    STATIC_ASSERT( (prioClass) < RTOS_NO_PRIO_CLASSES                                       \
+                 , prioClass_of_##taskFunction##_exceeds_RTOS_NO_PRIO_CLASSES               \
+                 );                                                                         \
+    STATIC_ASSERT( noTasksInPrioClass_t<(prioClass)>::noTasks                               \
+                   <= RTOS_MAX_NO_TASKS_IN_PRIO_CLASS                                       \
+                 , prioClass_of_##taskFunction##_exceeds_RTOS_MAX_NO_TASKS_IN_PRIO_CLASS    \
+                 );                                                                         \
+    STATIC_ASSERT(stackSize >= 50, stack_of_##taskFunction##_is_too_small);                 \
+    STATIC_ASSERT((startEventMask) != 0, no_start_event_of_##taskFunction);
+RTOS_TASK_TABLE(CHECK_TASK)
+
+#else
+/** Array of the static descriptions of all tasks but the idle task, which is not
+    described by the application. The index is the same as for \a _taskAry. */
+static taskDescriptor_t _taskDescriptorAry[RTOS_NO_TASKS];
+#endif
 
 /** Pointer to the idle task object. */
-static task_t * const _pIdleTask = &_taskAry[IDLE_TASK_ID];
+static task_t * const _pIdleTask = &_taskAry[IDLE_TASK_ID].task;
 
 /** The one and only active task. This may be the only internally seen idle task which does
     nothing. Implemented as pointer to the task object. */
-static task_t *_pActiveTask = &_taskAry[IDLE_TASK_ID];
+static task_t *_pActiveTask = &_taskAry[IDLE_TASK_ID].task;
 
 /** The task which is to be suspended because of a newly activated one. Only temporarily
     used in the instance of a task switch. */
 static task_t *_pSuspendedTask = NULL;
 
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/** Set by rtos_sendEventFromISR if a posted event has made a task due, which may be of
+    higher priority than the active task. The decision which task is active is deferred
+    till rtos_leaveISR. In cooperative mode, the flag is set by all interrupts, which make a
+    task due, and the decision is deferred till the next kernel call of a task. The flag is
+    reset whenever the kernel looks for the active task. */
+static volatile boolean _isReschedulePending = false;
+#endif
+
 /** Array holding all due (but not active) tasks. Ordered according to their priority
-    class. */
+    class. The due list of a class is a circular buffer; it starts at index \a
+    _idxFirstDueTaskAry[prio] and wraps around at the end of the array. */
 static task_t *_pDueTaskAryAry[RTOS_NO_PRIO_CLASSES][RTOS_MAX_NO_TASKS_IN_PRIO_CLASS];
 
 /** Number of due tasks in the different priority classes. */
 static uint8_t _noDueTasksAry[RTOS_NO_PRIO_CLASSES];
 
-/** Array holding all currently suspended tasks. */
-static task_t *_pSuspendedTaskAry[RTOS_NO_TASKS];
+/** The index of the first due task in the circular due list of each priority class. */
+static uint8_t _idxFirstDueTaskAry[RTOS_NO_PRIO_CLASSES];
+
+/** The head of the list of all currently suspended tasks. The list is linked through the
+    task objects, see \a pNextSuspendedTask and \a pPrevSuspendedTask. It is sorted in
+    order of decreasing priority and, inside a priority class, in order of the time of
+    suspension. NULL if no task is suspended. */
+static task_t *_pFirstSuspendedTask = NULL;
+
+/** The last suspended task of each priority class in the list of suspended tasks or NULL
+    if no task of the class is suspended. A newly suspended task is inserted behind this
+    task. */
+#if RTOS_NO_PRIO_CLASSES > 0
+static task_t *_pLastSuspendedTaskAry[RTOS_NO_PRIO_CLASSES];
+#endif
+
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+/** Bit vector of the non empty due lists. Bit i of byte j is set if and only if priority
+    class 8*j+i has at least one due task, i.e. if _noDueTasksAry[8*j+i] > 0. */
+static uint8_t _dueClassVecAry[NO_BYTES_PRIO_CLASS_VEC];
+
+# if NO_BYTES_PRIO_CLASS_VEC > 1
+/** Second level of the bit vector of non empty due lists: Bit j is set if and only if at
+    least one bit is set in _dueClassVecAry[j]. */
+static uint8_t _dueClassGroupVec;
+# endif
+
+/** Masks to select a single bit in a byte. The table replaces the shift operation by a
+    variable number of bits, which is a loop on the AVR CPU. */
+static const uint8_t _bitMaskAry[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+
+/** Lookup table for the index of the most significant set bit in a byte. The entry for
+    the null byte is a don't care. The table is placed in the flash ROM. */
+RTOS_PROGMEM_SECTION static const uint8_t _idxMsbAry[256] =
+{
+    0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+#endif
+
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+/** The timer wheel. Each bucket is a single linked list of all suspended tasks, whose
+    timeout elapses at a point in time t with (t & #MASK_TIMER_WHEEL_IDX) being the index
+    of the bucket. */
+static task_t *_pTimerWheelAry[RTOS_TIMER_WHEEL_SIZE];
+
+/* The wheel must not exceed the cycle of the system time; the mask would be truncated and
+   only a part of the buckets would be used. The size of uintTime_t is unknown to the
+   preprocessor, so the check is done by the compiler. */
+STATIC_ASSERT( RTOS_TIMER_WHEEL_SIZE-1ul <= (uintTime_t)~(uintTime_t)0
+             , RTOS_TIMER_WHEEL_SIZE_exceeds_cycle_of_system_time
+             );
+#endif
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+/** The lists of waiting tasks, one per event. A list holds the indexes of all suspended
+    tasks, which have the event in their mask. The order is by decreasing priority and
+    within a priority class by the time of suspension; the first entry is the task, which
+    gets a posted mutex or semaphore. */
+static uint8_t _idxWaitingTaskAryAry[NO_INDEXED_EVENTS][RTOS_NO_TASKS];
+
+/** The number of entries in each of the lists of waiting tasks. */
+static uint8_t _noWaitingTasksAry[NO_INDEXED_EVENTS];
+
+/** The tasks, which received at least one event in the currently executed call of
+    sendEvent. The array is global only to save stack space on every task stack; it's used
+    in sendEvent only. */
+static task_t *_pTouchedTaskAry[RTOS_NO_TASKS];
+#endif
+
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+/** Flag, which indicates that the system timer is in a tickless period. Timer 2 runs with
+    the reduced clock and the system time is not updated. */
+static boolean _isTicklessPeriod = false;
+
+/** The counts of timer 2 in normal operation, which were truncated when entering the
+    tickless period. They are restored when leaving it. */
+static uint8_t _ticklessPhaseRemainder;
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/** The record of the task, which missed its check-in. It's located in the section
+    .noinit, which is not cleared by the C runtime; it survives the reset by the
+    watchdog. */
+static livenessFailureRecord_t _livenessFailureRecord __attribute__((section(".noinit")));
+
+/** Flag, which is set when a task missed its check-in. The watchdog is no longer
+    serviced. */
+static boolean _isLivenessFailure = false;
+#endif
+
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+/** Flag, which indicates that the idle task has sent the CPU to sleep and that this sleep
+    period has not been accounted yet. */
+static volatile boolean _isIdleSleeping = false;
+
+/** The world time in microseconds, when the idle task sent the CPU to sleep the last
+    time. */
+static uint32_t _tiStartIdleSleep;
+
+/** The accumulated time in microseconds, which the CPU spent in sleep mode. */
+static uint32_t _tiIdleSleep = 0;
+#endif
+
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+/** The world time in microseconds of the last task switch. The time since then is
+    accounted to the active task at the next task switch. */
+static uint32_t _tiLastTaskSwitch;
+
+/** The world time in microseconds at the beginning of the current measurement window of
+    rtos_getCpuLoad. */
+static uint32_t _tiStartCpuLoadWindow;
+
+/** The runtime of the idle task at the beginning of the current measurement window of
+    rtos_getCpuLoad. */
+static uint32_t _tiIdleAtStartCpuLoadWindow;
+#endif
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/** The time stamps of the latest measured entries into the application interrupts 00 and
+    01. */
+static uint16_t _tiApplIsrEntryAry[2];
 
-/** Number of currently suspended tasks. */
-static uint8_t _noSuspendedTasks;
+/** An entry into application interrupt 00 or 01 has been measured and no task has been
+    resumed by it yet. */
+static boolean _isApplIsrLatencyPendingAry[2] = {false, false};
+
+/** The histograms of the latencies of application interrupts 00 and 01. */
+static rtos_isrLatencyHistogram_t _isrLatencyHistogramAry[2];
+#endif
 
 #if RTOS_USE_MUTEX == RTOS_FEATURE_ON
 /** All of the mutex events are combined in a bit vector. The mutexes are initially
     released, all according bits are set. All remaining bits are don't care bits. */
-static uint16_t _mutexVec = MASK_EVT_IS_MUTEX;
+static uintEventVec_t _mutexVec = MASK_EVT_IS_MUTEX;
+#endif
+
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+/** The current owner of each mutex. An entry is valid only as long as the related bit in
+    \a _mutexVec is reset, i.e. as long as the mutex is locked. */
+static task_t *_pMutexOwnerAry[RTOS_NO_MUTEX_EVENTS];
+
+/** The highest priority class, which the owner of a mutex has inherited through this
+    mutex from the tasks waiting for it. The entry is reset when the mutex is released; 0
+    means no inheritance, since no owner can be below class 0. */
+static uint8_t _prioClassInheritedAry[RTOS_NO_MUTEX_EVENTS];
 #endif
 
+#if RTOS_USE_REGISTER_CONTEXT_SWITCH == RTOS_FEATURE_OFF
 /** Temporary data, internally used to pass information between assembly and C code. */
 volatile uint16_t _tmpVarAsmToC_u16;
 /** Temporary data, internally used to pass information between C and assembly code. */
 volatile uint16_t _tmpVarCToAsm_u16;
+# if RTOS_EVENT_VECTOR_BITS == 32
+/** Temporary data, internally used to pass the 32 Bit return value of a suspend command
+    from C to assembly code. */
+volatile uint32_t _tmpVarCToAsm_u32;
+# endif
+#endif
+
+#ifdef RTOS_HOST_SIMULATION
+/** The saved CPU contexts of all tasks in the host simulation, including the idle task
+    in the last entry. They take the role of the context, which is pushed onto the task
+    stack on the AVR. */
+static ucontext_t _hostContextAry[RTOS_NO_TASKS+1];
+
+/** The stacks of the tasks in the host simulation. The idle task runs on the stack of
+    main. */
+static uint8_t _hostStackAryAry[RTOS_NO_TASKS][SIZE_OF_HOST_STACK];
+#endif
+
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+/** Temporary data, internally used to pass the index of the application interrupt from
+    its service routine to the common code \a applInterruptTail. */
+volatile uint8_t _tmpVarIdxApplInterrupt;
+
+/** The entry of the table of event vectors for one row of the table
+    #RTOS_APPL_INTERRUPT_TABLE. */
+# define EVENT_VEC_OF_APPL_INTERRUPT(vector, eventVec, enableIRQ)   (eventVec),
+
+/** The events to post for each of the application interrupts from table
+    #RTOS_APPL_INTERRUPT_TABLE. The table is located in flash ROM; it is read by the
+    assembly code of \a applInterruptTail. (The extern declaration makes the name visible
+    to the assembler.) */
+extern const uintEventVec_t _applInterruptEventVecAry[noApplInterrupts] PROGMEM;
+const uintEventVec_t _applInterruptEventVecAry[noApplInterrupts] PROGMEM =
+{
+    RTOS_APPL_INTERRUPT_TABLE(EVENT_VEC_OF_APPL_INTERRUPT)
+};
+#endif
 
 
 /*
@@ -476,6 +1599,26 @@ volatile uint16_t _tmpVarCToAsm_u16;
  */
 
 
+/**
+ * Get the index of a task. The index of a task is its ID; the idle task has the index
+ * #RTOS_NO_TASKS.
+ *   @return
+ * Get the index of the task.
+ *   @param pT
+ * The task object.
+ */
+
+static inline uint8_t getIdxTask(const task_t * const pT)
+{
+    /* The task objects are elements of an array of task slots. The task object is the
+       first member of the slot. */
+    return (uint8_t)((const taskSlot_t*)pT - &_taskAry[0]);
+
+} /* End of getIdxTask */
+
+
+
+
 /**
  * Prepare the still unused stack area of a new task in a way that the normal context
  * switching code will load the desired initial context into the CPU. Context switches are
@@ -505,36 +1648,49 @@ static uint8_t *prepareTaskStack( uint8_t * const pEmptyTaskStack
                                 , rtos_taskFunction_t taskEntryPoint
                                 )
 {
-    uint8_t r;
-
     /* -1: We handle the stack pointer variable in the same way like the CPU does, with
        post-decrement. */
     uint8_t *sp = pEmptyTaskStack + stackSize - 1
           , *retCode;
 
-    /* Push 3 Bytes of guard program counter, which is the reset address, 0x00000. If
+#ifdef RTOS_HOST_SIMULATION
+    /* The task runs on a stack of the host, which is prepared by prepareHostContext. The
+       stack area of the task only receives the pattern, so that the stack diagnosis
+       functions work as usual; they report an unused stack. Its bottom byte is set to 0
+       like the guard program counter on the AVR; the search for the pattern ends here. */
+    * sp-- = 0x00;
+#else
+    uint8_t r;
+
+    /* Push 2 or 3 Bytes of guard program counter, which is the reset address, 0x00000. If
        someone returns from a task, this will cause a reset of the controller (instead of
        an undetermined kind of crash).
          CAUTION: The distinction between 2 and 3 byte PC is the most relevant modification
        of the code when porting to another AVR CPU. Many types use a 16 Bit PC. */
     * sp-- = 0x00;
     * sp-- = 0x00;
-#ifdef __AVR_ATmega2560__
+#if SIZE_OF_PROGRAM_COUNTER == 3
     * sp-- = 0x00;
-#else
-# error Modification of code for other AVR CPU required
 #endif
 
-    /* Push 3 Byte program counter of task start address onto the still empty stack of the
+    /* Push the program counter of task start address onto the still empty stack of the
        new task. The order is LSB, MidSB, MSB from bottom to top of stack (where the
        stack's bottom is the highest memory address). */
     * sp-- = (uint8_t)((uint32_t)taskEntryPoint & 0x000000ff);
     * sp-- = (uint8_t)(((uint32_t)taskEntryPoint & 0x0000ff00) >> 8);
-#ifdef __AVR_ATmega2560__
+#if SIZE_OF_PROGRAM_COUNTER == 3
     * sp-- = (uint8_t)(((uint32_t)taskEntryPoint & 0x00ff0000) >> 16);
-#else
-# error Modification of code for other AVR CPU required
 #endif
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    /* In cooperative mode, the context consists of the call saved registers r2..r17, r28
+       and r29. Their initial values don't matter, we set them to 0. The registers, which
+       hold the return value of a suspend command, are not part of the context of a
+       suspended task, see below. */
+    for(r=2; r<=17; ++r)
+        * sp-- = 0;
+    * sp-- = 0;
+    * sp-- = 0;
+#else
     /* Now we have to push the initial value of r0, which is the __tmp_reg__ of the
        compiler. The value actually doesn't matter, we set it to 0. */
     * sp-- = 0;
@@ -558,21 +1714,38 @@ static uint8_t *prepareTaskStack( uint8_t * const pEmptyTaskStack
        r25/r25 are not part of the context: The values of these registers will be loaded
        explicitly with the result of the suspend command immediately before the return to
        the task. */
+#if RTOS_EVENT_VECTOR_BITS == 16
     for(r=2; r<=23; ++r)
         * sp-- = 0;
+#else
+    /* A 32 Bit event vector is passed in r22..r25. These registers are not part of the
+       context of a suspended task either. */
+    for(r=2; r<=21; ++r)
+        * sp-- = 0;
+#endif
     for(r=26; r<=31; ++r)
         * sp-- = 0;
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
+#endif /* RTOS_HOST_SIMULATION */
 
     /* The stack is prepared. The value the stack pointer has now needs to be returned to
        the caller. It has to be stored in the context save area of the new task as current
        stack pointer. */
     retCode = sp;
 
+#if RTOS_USE_LAZY_STACK_FILL == RTOS_FEATURE_ON
+    /* The rest of the stack area is filled with the pattern later by the idle task, see
+       fillTaskStacks. Only the canary needs to be valid right from the start. */
+# if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+    memset(pEmptyTaskStack, UNUSED_STACK_PATTERN, SIZE_OF_STACK_CANARY);
+# endif
+#else
     /* The rest of the stack area doesn't matter. Nonetheless, we fill it with a specific
        pattern, which will permit to run a (a bit guessing) stack usage routine later on:
        We can look up to where the pattern has been destroyed. */
     while(sp >= pEmptyTaskStack)
         * sp-- = UNUSED_STACK_PATTERN;
+#endif
 
     return retCode;
 
@@ -581,6 +1754,84 @@ static uint8_t *prepareTaskStack( uint8_t * const pEmptyTaskStack
 
 
 
+#ifdef RTOS_HOST_SIMULATION
+/**
+ * The entry point of all tasks in the host simulation. The function takes the role of the
+ * initial context, which prepareTaskStack pushes onto the task stack on the AVR: It is
+ * entered by the first switch to the task, passes the events, which made the task due, to
+ * the task function and enables the interrupts.
+ *   @param idxTask
+ * The index of the started task.
+ */
+
+static void hostTaskEntry(int idxTask)
+{
+    /* This is the same as PUSH_RET_CODE_OF_CONTEXT_SWITCH does for a new task. */
+    const uintEventVec_t initCondition = _pActiveTask->postedEventVec;
+    _pActiveTask->postedEventVec = 0;
+    sei();
+
+    _taskDescriptorAry[idxTask].taskFunction(initCondition);
+
+    /* A task function must never return. On the AVR, the guard program counter on the
+       stack causes a reset. The simulation ends with failure. */
+    ASSERT(false);
+    exit(EXIT_FAILURE);
+
+} /* End of hostTaskEntry */
+
+
+
+
+/**
+ * Prepare the context of a task in the host simulation. The first switch to the task will
+ * enter function hostTaskEntry on the host stack of the task.
+ *   @param idxTask
+ * The index of the task.
+ */
+
+static void prepareHostContext(uint8_t idxTask)
+{
+    ucontext_t * const pContext = &_hostContextAry[idxTask];
+
+    getcontext(pContext);
+    pContext->uc_stack.ss_sp = &_hostStackAryAry[idxTask][0];
+    pContext->uc_stack.ss_size = SIZE_OF_HOST_STACK;
+    pContext->uc_link = NULL;
+
+    /* The task is entered from the kernel with interrupts disabled. */
+    sigemptyset(&pContext->uc_sigmask);
+    sigaddset(&pContext->uc_sigmask, SIGALRM);
+
+    makecontext(pContext, (void (*)(void))hostTaskEntry, 1, (int)idxTask);
+
+} /* End of prepareHostContext */
+
+
+
+
+/**
+ * The task switch in the host simulation. The function replaces the code patterns
+ * SWITCH_CONTEXT and POP_CONTEXT_FROM_STACK: The CPU context of the left task is saved
+ * and the context of the new active task is loaded. The function returns not before the
+ * left task has become the active task again.\n
+ *   Side effects: The left task and the new task are read from the global variables
+ * _pSuspendedTask and _pActiveTask.
+ *   @remark
+ * The function needs to be called with interrupts disabled.
+ */
+
+static void switchContext(void)
+{
+    swapcontext( &_hostContextAry[getIdxTask(_pSuspendedTask)]
+               , &_hostContextAry[getIdxTask(_pActiveTask)]
+               );
+} /* End of switchContext */
+#endif /* RTOS_HOST_SIMULATION */
+
+
+
+
 
 /**
  * Start the interrupt which clocks the system time. Timer 2 is used as interrupt source
@@ -592,7 +1843,18 @@ static uint8_t *prepareTaskStack( uint8_t * const pEmptyTaskStack
 RTOS_DEFAULT_FCT void rtos_enableIRQTimerTic(void)
 
 {
-#ifdef __AVR_ATmega2560__
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+    /* The tickless operation needs a timer, which counts in one direction, so that the
+       phase of the system timer tic can be determined from the counter value. Timer 2 is
+       put into normal mode, WGM2 = %000, with prescaler 128. The overflow frequency is
+       16e6Hz/128/256 = 488.28125 Hz, i.e. 2.048 ms period time. The PWM outputs of
+       timer 2 are disconnected. */
+    TCCR2A = 0;
+    TCCR2B = TCCR2B_NORMAL_TICS;
+    TCNT2  = 0;
+    TIFR2  = _BV(TOV2);
+    TIMSK2 |= _BV(TOIE2);
+#else
     /* Initialization of the system timer: Arduino (wiring.c, init()) has initialized
        timer2 to count up and down (phase correct PWM mode) with prescaler 64 and no TOP
        value (i.e. it counts from 0 till MAX=255). This leads to a call frequency of
@@ -603,8 +1865,6 @@ RTOS_DEFAULT_FCT void rtos_enableIRQTimerTic(void)
         here and to enable the related interrupt. In which case you have to alter the name
         of the interrupt vector in use. Modify #RTOS_ISR_SYSTEM_TIMER_TIC to do so. */
     TIMSK2 |= _BV(TOIE2);
-#else
-# error Modification of code for other AVR CPU required
 #endif
 
 } /* End of rtos_enableIRQTimerTic */
@@ -612,1227 +1872,4932 @@ RTOS_DEFAULT_FCT void rtos_enableIRQTimerTic(void)
 
 
 
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
 /**
- * When an event has been posted to a currently suspended task, it might easily be that
- * this task is resumed and becomes due. This routine checks a suspended task for resume
- * and moves it into the due task lists if it is resumed.
- *   @return
- * The Boolean information whether the task is resumed and becomes due is returned.
- *   @param idxSuspTask
- * The index of the investigated task. It is the index in the global list
- * \a _pSuspendedTaskAry of suspended tasks.
+ * Record in the bit vector of non empty due lists that a priority class has at least one
+ * due task.
+ *   @param prioClass
+ * The priority class a task has been put into the due list of.
  */
 
-static inline boolean checkTaskForActivation(uint8_t idxSuspTask)
+static inline void setPrioClassDue(uint8_t prioClass)
 {
-    task_t * const pT = _pSuspendedTaskAry[idxSuspTask];
-    uint16_t eventVec;
-    boolean taskBecomesDue;
-
-    /* Check if the task becomes due because of the events posted prior to calling this
-       function. The optimally supported case is the more probable OR combination of
-       events.
-         The AND operation is less straight forward as the timeout character of the
-       timer events needs to be retained: AND only refers to the postable events but
-       does not include the timer events. All postable events need to be set in both
-       the mask and the vector of posted events OR any of the timer events in the mask
-       are set in the vector of posted events. */
-    eventVec = pT->postedEventVec;
-    if((pT->waitForAnyEvent &&  eventVec != 0)
-       ||  (!pT->waitForAnyEvent
-            &&  (((eventVec ^ pT->eventMask) & ~MASK_EVT_IS_TIMER) == 0
-                 ||  (eventVec & pT->eventMask & MASK_EVT_IS_TIMER) != 0
-                )
-           )
-      )
-    {
-        uint8_t u
-              , prio = pT->prioClass;
-
-        /* This task becomes due. */
-
-#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
-        /* If a round robin task voluntarily suspends it gets the right for a complete
-           new time slice. Reload the counter. */
-        pT->cntRoundRobin = pT->timeRoundRobin;
-#endif
-        /* Move the task from the list of suspended tasks to the list of due tasks of
-           its priority class. */
-        _pDueTaskAryAry[prio][_noDueTasksAry[prio]++] = pT;
-        -- _noSuspendedTasks;
-        for(u=idxSuspTask; u<_noSuspendedTasks; ++u)
-            _pSuspendedTaskAry[u] = _pSuspendedTaskAry[u+1];
-
-        /* Since a task became due there might be a change of the active task. */
-        taskBecomesDue = true;
-    }
-    else
-        taskBecomesDue = false;
-    
-    return taskBecomesDue;
-    
-} /* End of checkTaskForActivation */
+# if NO_BYTES_PRIO_CLASS_VEC > 1
+    const uint8_t idxByte = prioClass >> 3;
+    _dueClassVecAry[idxByte] |= _bitMaskAry[prioClass & 0x07];
+    _dueClassGroupVec |= _bitMaskAry[idxByte];
+# else
+    _dueClassVecAry[0] |= _bitMaskAry[prioClass];
+# endif
+} /* End of setPrioClassDue */
 
 
 
 
 /**
- * After posting an event to one or more currently suspended tasks, it might easily be that
- * one such task is resumed and becomes due - active because of its higher priority. To
- * find out, this function needs to be called after posting the events. It determines which
- * task is now the active task.
+ * Record in the bit vector of non empty due lists that a priority class has no due task
+ * any more.
+ *   @param prioClass
+ * The priority class, whose due list has become empty.
+ */
+
+static inline void clearPrioClassDue(uint8_t prioClass)
+{
+# if NO_BYTES_PRIO_CLASS_VEC > 1
+    const uint8_t idxByte = prioClass >> 3;
+    if((_dueClassVecAry[idxByte] &= ~_bitMaskAry[prioClass & 0x07]) == 0)
+        _dueClassGroupVec &= ~_bitMaskAry[idxByte];
+# else
+    _dueClassVecAry[0] &= ~_bitMaskAry[prioClass];
+# endif
+} /* End of clearPrioClassDue */
+#endif /* RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON */
+
+
+
+
+/**
+ * Find the highest priority class, which has at least one due task.\n
+ *   If #RTOS_USE_PRIO_CLASS_BITMAP is set the result is looked up in constant time.
+ * Otherwise the due lists are searched from the highest priority class downwards.
  *   @return
- * The Boolean information wheather the active task now is another task is returned.\n
- *   If the function returns true, references to the old and the new active task are
- * reported by side effect: They are written into the global variables \a _pSuspendedTask and
- * \a _pActiveTask.
+ * The index of the priority class or -1 if there's no due task at all.
  */
- 
-static inline boolean lookForActiveTask()
+
+static inline int8_t getHighestDuePrioClass(void)
 {
-    /* The calling interrupt service routine will do a context switch only if we return
-       true. Otherwise it'll simply do a "reti" to the interrupted context and continue
-       it. */
-       
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+# if NO_BYTES_PRIO_CLASS_VEC > 1
+    if(_dueClassGroupVec == 0)
+        return -1;
+
+    const uint8_t idxByte = pgm_read_byte(&_idxMsbAry[_dueClassGroupVec]);
+    return (int8_t)((idxByte << 3) + pgm_read_byte(&_idxMsbAry[_dueClassVecAry[idxByte]]));
+# else
+    if(_dueClassVecAry[0] == 0)
+        return -1;
+
+    return (int8_t)pgm_read_byte(&_idxMsbAry[_dueClassVecAry[0]]);
+# endif
+#else
     int8_t idxPrio;
 
-    /* Look for the task we will return to. It's the first entry in the highest
-       non-empty priority class. The loop requires a signed index. */
+    /* The loop requires a signed index. It ends with -1 if no due task is found. */
     for(idxPrio=RTOS_NO_PRIO_CLASSES-1; idxPrio>=0; --idxPrio)
-    {
         if(_noDueTasksAry[idxPrio] > 0)
-        {
-            _pSuspendedTask = _pActiveTask;
-            _pActiveTask    = _pDueTaskAryAry[idxPrio][0];
-
-            /* If we only entered the outermost if clause we made at least one task
-               due; these statements are thus surely reached. As the due becoming task
-               might however be of lower priority it can easily be that we nonetheless
-               don't have a task switch. */
-            return _pActiveTask != _pSuspendedTask;
-        }
-    }
-
-    /* We never get here. This function is called under the precondition that a task was
-       put into a due list, so the search above will surely have found one. */
-    ASSERT(false);
-    return false;
+            break;
 
-} /* End of lookForActiveTask */
+    return idxPrio;
+#endif
+} /* End of getHighestDuePrioClass */
 
 
 
 
 /**
- * This function is called from the system interrupt triggered by the main clock. The
- * timers of all due tasks are served and - in case they elapse - timer events are
- * generated. These events may then resume some of the tasks. If so, they are placed in
- * the appropriate list of due tasks. Finally, the longest due task in the highest none
- * empty priority class is activated.
+ * Get the position of a task in the circular due list of a priority class.
  *   @return
- * The Boolean information is returned whether we have or not have a task switch. In most
- * invocations we won't have and therefore it's worth to optimize the code for this case:
- * Don't do the expensive switch of the stack pointers.\n
- *   The most important result of the function, the reference to the active task after
- * leaving the function, is returned by side effect: The global variable _pActiveTask is
- * updated.
+ * The index into \a _pDueTaskAryAry[prio].
+ *   @param prio
+ * The priority class.
+ *   @param offs
+ * The position of the task relative to the first due task of the class. The range is
+ * 0..#RTOS_MAX_NO_TASKS_IN_PRIO_CLASS.
  */
 
-static RTOS_TRUE_FCT boolean onTimerTic(void)
+static inline uint8_t getIdxDueTask(uint8_t prio, uint8_t offs)
 {
-    /* Clock the system time. Cyclic overrun is intended. */
-    ++ _time;
+#if RTOS_NO_PRIO_CLASSES > 0
+    uint8_t idx = _idxFirstDueTaskAry[prio] + offs;
+    if(idx >= RTOS_MAX_NO_TASKS_IN_PRIO_CLASS)
+        idx -= RTOS_MAX_NO_TASKS_IN_PRIO_CLASS;
+    return idx;
+#else
+    /* Without priority classes, there are no tasks and the function is never called. */
+    return offs;
+#endif
+} /* End of getIdxDueTask */
 
-    boolean activeTaskMayChange = false;
 
-    /* Check for all suspended tasks if a timer event has to be posted. */
-    uint8_t idxSuspTask = 0;
-    while(idxSuspTask<_noSuspendedTasks)
-    {
-        task_t * const pT = _pSuspendedTaskAry[idxSuspTask];
-        
-        /* Remember the received events before (possibly) getting some more in this
-           timer tic: Only if this set changes it is necessary to check for a state
-           transition of the task. */
-        const uint16_t postedEventVecBefore = pT->postedEventVec;
-        
-        /* Check for absolute timer event. */
-        if(_time == pT->timeDueAt)
-        {
-            /* Setting the absolute timer event when it already is set looks like a task
-               overrun indication. It isn't for the following reason. The absolute timer
-               event can't be AND combined with other events, so the event will immediately
-               change the status to due (see checkForTaskActivation), so that setting it a
-               second time will never occur. */
-            pT->postedEventVec |= (RTOS_EVT_ABSOLUTE_TIMER & pT->eventMask);
-        }
 
-        /* Check for delay timer event. The code here should optimally support the standard
-           situation that the counter is constantly 0. */
-        if(pT->cntDelay != 0)
-        {
-            if(-- pT->cntDelay == 0)
-                pT->postedEventVec |= (RTOS_EVT_DELAY_TIMER & pT->eventMask);
-        }
 
-        /* Check if this suspended task becomes due because of a timer event, which was
-           posted to it. */
-        if(postedEventVecBefore != pT->postedEventVec  && checkTaskForActivation(idxSuspTask))
-        {
-            /* The task becomes due, which may cause a task switch. */
-            activeTaskMayChange = true;
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+/**
+ * Put a task, which becomes due, into the due list of the priority class, which is
+ * scheduled earliest deadline first. The list is kept sorted by deadline; the first task is
+ * the one with the earliest deadline. A task is inserted behind all tasks of same deadline,
+ * so that these are served first come, first served and the active task is not preempted
+ * by a task of same deadline.
+ *   @param pT
+ * The task object. It belongs to priority class #RTOS_EDF_PRIO_CLASS and it is not yet
+ * in the due list.
+ *   @remark
+ * The deadlines are compared in the cyclic system time. The comparison is correct as long
+ * as all deadlines of the due tasks are less than half the range of uintTime_t apart.
+ */
 
-            /* Check next suspended task, which is in this case found in the array
-               element with same index: The task which became due has been removed into the
-               due list of its priority class. */
-        }
-        else
-        {
-            /* The task remains suspended. */
+static inline void insertDueTaskByDeadline(task_t * const pT)
+{
+    task_t ** const pDueList = &_pDueTaskAryAry[RTOS_EDF_PRIO_CLASS][0];
+    uint8_t u = _noDueTasksAry[RTOS_EDF_PRIO_CLASS]++;
+
+    /* A task, which is not regularly activated by the absolute timer, has no defined
+       period. Its deadline is the time when it becomes due; it should run as soon as
+       possible. */
+    if((pT->eventMask & RTOS_EVT_ABSOLUTE_TIMER) == 0)
+        pT->timeDeadline = _time;
+
+    /* Move all tasks with a later deadline one position towards the end of the list. The
+       list has room for another task. */
+    while(u > 0)
+    {
+        task_t * const pPredecessor = pDueList[getIdxDueTask(RTOS_EDF_PRIO_CLASS, u-1)];
+        if((intTime_t)(pPredecessor->timeDeadline - pT->timeDeadline) <= 0)
+            break;
+        pDueList[getIdxDueTask(RTOS_EDF_PRIO_CLASS, u)] = pPredecessor;
+        -- u;
+    }
+    pDueList[getIdxDueTask(RTOS_EDF_PRIO_CLASS, u)] = pT;
 
-            /* Check next suspended task, which is in this case found in the next array
-               element. */
-            ++ idxSuspTask;
+} /* End of insertDueTaskByDeadline */
+#endif
 
-        } /* End if(Did this suspended task become due?) */
 
-    } /* End while(All suspended tasks) */
 
 
-#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
-    /* Round-robin: Applies only to the active task. It can become inactive, however not
-       undue, or suspended respectively. If its time slice is elapsed it is put at the end
-       of the due list in its priority class. */
-    if(_pActiveTask->cntRoundRobin != 0)
-    {
-        if(--_pActiveTask->cntRoundRobin == 0)
-        {
-            /* Time slice of active task has elapsed. Reload the counter. */
-            _pActiveTask->cntRoundRobin = _pActiveTask->timeRoundRobin;
+/**
+ * Put a task, which becomes due, into the due list of its priority class. It becomes the
+ * last one in the list - unless the class is scheduled earliest deadline first.
+ *   @param pT
+ * The task object. It is not yet in the due list.
+ */
 
-            uint8_t prio = _pActiveTask->prioClass
-                  , noTasks = _noDueTasksAry[prio];
+static inline void insertDueTask(task_t * const pT)
+{
+#if RTOS_NO_PRIO_CLASSES == 0
+    /* Without priority classes, there are no tasks and the function is never called. */
+#elif RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON  &&  RTOS_NO_PRIO_CLASSES == 1
+    /* The only priority class is scheduled earliest deadline first. (The code for other
+       classes would not only be useless but it would address the arrays out of bounds.) */
+    insertDueTaskByDeadline(pT);
+#else
+    const uint8_t prio = pT->prioClass;
 
-            /* If there are more due tasks in the same class the next one will be made the
-               active one by a cyclic move of the positions in the list. */
-            if(noTasks-- > 1)
-            {
-                uint8_t idxTask;
+# if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    if(prio == RTOS_EDF_PRIO_CLASS)
+        insertDueTaskByDeadline(pT);
+    else
+# endif
+        _pDueTaskAryAry[prio][getIdxDueTask(prio, _noDueTasksAry[prio]++)] = pT;
+#endif
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON  &&  RTOS_NO_PRIO_CLASSES > 0
+    setPrioClassDue(pT->prioClass);
+#endif
+} /* End of insertDueTask */
 
-                /* The list of due tasks in the active priority class is rolled by one task.
-                   The next due task will become active.
-                     Note: noTasks has been decremented before in the if. */
-                for(idxTask=0; idxTask<noTasks; ++idxTask)
-                    _pDueTaskAryAry[prio][idxTask] = _pDueTaskAryAry[prio][idxTask+1];
-                _pDueTaskAryAry[prio][idxTask] = _pActiveTask;
 
-                /* Force check for new active task - even if no suspended task should have been
-                   resumed. */
-                activeTaskMayChange = true;
 
-            } /* if(Did the task loose against another due one?) */
 
-        } /* if(Did the round robin time of the task elapse?) */
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/**
+ * Take a task out of the due list of its priority class if it is due.
+ *   @return
+ * Get true if the task has been due and false if it is not in the due list.
+ *   @param pT
+ * The task object.
+ */
 
-    } /* if(Do we have a round robin task?) */
-#endif
+static boolean unlinkDueTask(task_t * const pT)
+{
+    const uint8_t prio = pT->prioClass;
+    task_t ** const pDueList = &_pDueTaskAryAry[prio][0];
+    uint8_t noDue = _noDueTasksAry[prio]
+          , u;
 
-    /* Check if another task becomes active because of the possibly occurred timer events.
-         activeTaskMayChange: We do the search for the new active task only if at least one
-       suspended task was resumed. If round robin is compiled it depends. Always look for a
-       new active task if the round robin time has elapsed.
-         The function has side effects: If there's a task which was suspended before and
-       which is resumed because of the timer events and which is of higher priority than
-       the one being active so far, the refernces to the old and newly active task are
-       written into global variables _pSuspendedTask and _pActiveTask. */
-    return activeTaskMayChange && lookForActiveTask();
+    for(u=0; u<noDue; ++u)
+        if(pDueList[getIdxDueTask(prio, u)] == pT)
+            break;
+    if(u == noDue)
+        return false;
 
-} /* End of onTimerTic. */
+    _noDueTasksAry[prio] = --noDue;
+    for(; u<noDue; ++u)
+        pDueList[getIdxDueTask(prio, u)] = pDueList[getIdxDueTask(prio, u+1)];
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+    if(noDue == 0)
+        clearPrioClassDue(prio);
+#endif
 
+    return true;
 
+} /* End of unlinkDueTask */
+#endif
 
 
 
 
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
 /**
- * Each call of this function cyclically increments the system time of the kernel by one.\n
- *   Incrementing the system timer is an important system event. The routine will always
- * include an inspection of all suspended tasks, whether they could become due again.
- *   The cycle time of the system time is low (typically implemented as 0..255) and
- * determines the maximum delay time or timeout for a task which suspends itself and the
- * ratio of the task periods of the fastest and the slowest regular task. Furthermore it
- * determines the reliability of task overrun recognition. Task overrun events in the
- * magnitude of half the cycle time won't be recognized as such.\n
- *   The unit of the time is defined only by the it triggering source and doesn't matter at
- * all for the kernel. The time even don't need to be regular.\n
- *   @remark
- * The function needs to be called by an interrupt and can easily end with a context change,
- * i.e. the interrupt will return to another task as the one it had interrupted.
- *   @remark
- * The connected interrupt is defined by macro #RTOS_ISR_SYSTEM_TIMER_TIC. This interrupt
- * needs to be disabled/enabled by the implementation of \a enterCriticalSection and \a
- * leaveCriticalSection.
- *   @remark
- * The cycle time of the system time can be influenced by the typedef of uintTime_t. Find a
- * discussion of pros and cons at the location of this typedef.
- *   @see boolean onTimerTic(void)
- *   @see #rtos_enterCriticalSection
+ * Put a task into the bucket of the timer wheel, which is related to the point in time
+ * its timeout elapses.
+ *   @param pT
+ * The task object. Its element \a timeTimeout needs to be set.
  */
 
-ISR(RTOS_ISR_SYSTEM_TIMER_TIC, ISR_NAKED)
+static inline void linkTimeout(task_t * const pT)
 {
-    /* An ISR must not occur while we're updating the global data and checking for a
-       possible task switch. To be more precise: The call of onTimerTic would just require
-       to inhibit all those interrupts which might initiate a task switch. As long as no
-       user defined interrupts are configured to set an RTOS event, this is only the single
-       timer interrupt driving the system time. However, at latest when a task switch
-       really is initiated we would need to lock all interrupts globally (as we modify the
-       stack pointer in non-atomic operation). It doesn't matter to have locked all
-       interrupts globally already here. */
+    task_t ** const ppBucket = &_pTimerWheelAry[pT->timeTimeout & MASK_TIMER_WHEEL_IDX];
+    pT->pNextTimeout = *ppBucket;
+    *ppBucket = pT;
 
-    /* Save context onto the stack of the interrupted active task. */
-    PUSH_CONTEXT_ONTO_STACK
-
-	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
-       interrupted code. To make the local code here running, we need to anticipate this
-       situation and clear the register. */
-    asm volatile
-    ("clr __zero_reg__ \n\t"
-    );
+} /* End of linkTimeout */
 
-    /* Check for all suspended tasks if this change in time is an event for them. */
-    if(onTimerTic())
-    {
-        /* Yes, another task becomes active with this timer tic. Switch the stack pointer
-           to the (saved) stack pointer of that task. */
-        SWITCH_CONTEXT
-        PUSH_RET_CODE_OF_CONTEXT_SWITCH
-    }
 
-    /* The highly critical operation of modifying the stack pointer is done. From now on,
-       all interrupts could safely operate on the new stack, the stack of the new task. This
-       includes such an interrupt which would cause another task switch. However, early
-       releasing the global interrupts here could lead to higher use of stack area if many
-       task switches appear one after another. Therefore we will reenable the interrupts
-       only with the final reti command. The disadvantage is probably minor (some clock
-       tics less of responsiveness of the system). */
 
-    /* The stack pointer points to the now active task (which will often be still the same
-       as at function entry). The CPU context to continue with is popped from this stack. If
-       there's no change in active task the entire routine call is just like any ordinary
-       interrupt. */
-    POP_CONTEXT_FROM_STACK
 
-    /* The global interrupt enable flag is not saved across task switches, but always set
-       on entry into the new or same context by using a reti rather than a ret.
-         If we return to the same context, this will not mean that we harmfully change the
-       state of a running context without the context knowing or willing it: If the context
-       had reset the bit we would never have got here, as this is an ISR controlled by the
-       bit. */
-    asm volatile
-    ( "reti \n\t"
-    );
+/**
+ * Remove a task from the timer wheel. This is required if a task, which had been suspended
+ * with timeout, is resumed by another event than its timer.
+ *   @param pT
+ * The task object. It needs to be linked into the bucket of the timer wheel, which is
+ * related to its element \a timeTimeout.
+ */
 
-} /* End of ISR to increment the system time by one tic. */
+static inline void unlinkTimeout(task_t * const pT)
+{
+    task_t **ppT = &_pTimerWheelAry[pT->timeTimeout & MASK_TIMER_WHEEL_IDX];
 
+    /* The buckets are short lists; a linear search for the predecessor is acceptable. */
+    while(*ppT != pT)
+    {
+        ASSERT(*ppT != NULL);
+        ppT = &(*ppT)->pNextTimeout;
+    }
+    *ppT = pT->pNextTimeout;
 
+} /* End of unlinkTimeout */
+#endif /* RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON */
 
 
 
 
 /**
- * Actual implementation of routine \a rtos_sendEvent. The task posts a set of events and the
- * scheduler is asked which task is the one to be activated now.\n
- *   The action of this SW interrupt is placed into an own function in order to let the
- * compiler generate the stack frame required for all local data. (The stack frame
- * generation of the SW interrupt entry point needs to be inhibited in order to permit the
- * implementation of saving/restoring the task context).
- *   @return
- * The function determines which task is to be activated and records which task is left
- * (i.e. the task calling this routine) in the global variables _pActiveTask and
- * _pSuspendedTask.\n
- *   If there is a task switch the function reports this by a return value true. If there
- * is no task switch it returns false and the global variables _pActiveTask and
- * _pSuspendedTask are not touched.
- *   @param postedEventVec
- * See software interrupt \a rtos_sendEvent.
- *   @see
- * void rtos_sendEvent(uint16_t)
- *   @remark
- * This function and particularly passing the return codes via a global variable will
- * operate only if all interrupts are disabled.
+ * Insert a task into the list of suspended tasks. It is placed behind all tasks of same or
+ * higher priority: The other tasks of same priority are waiting longer and will receive a
+ * later posted mutex or semaphore with priority.\n
+ *   The cost is independent of the number of suspended tasks; the position is found by
+ * looking at the last suspended task of the own and the higher priority classes.
+ *   @param pT
+ * The task object. Its element \a prioClass needs to be set.
  */
 
-static RTOS_TRUE_FCT boolean sendEvent(uint16_t postedEventVec)
+static inline void linkSuspendedTask(task_t * const pT)
 {
-    /* Avoid inlining under all circumstances. See attributes also. */
-    asm("");
+#if RTOS_NO_PRIO_CLASSES > 0
+    const uint8_t prio = pT->prioClass;
+    task_t *pPred = NULL;
+    uint8_t idxPrio;
 
-    boolean activeTaskMayChange = false;
-    
-    /* The timer events must not be set manually. */
-    ASSERT((postedEventVec & MASK_EVT_IS_TIMER) == 0);
+    for(idxPrio=prio; idxPrio<RTOS_NO_PRIO_CLASSES; ++idxPrio)
+        if((pPred = _pLastSuspendedTaskAry[idxPrio]) != NULL)
+            break;
 
-    /* We keep track of all semaphores and mutexes, which have to be posted (released)
-       exactly once - to the first task, which is waiting for them. This task is done,
-       when the related mask, semaphoreToReleaseVec or mutexToReleaseVec becomes null. */
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-    uint8_t semaphoreToReleaseVec = postedEventVec & MASK_EVT_IS_SEMAPHORE;
-#endif
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    uint16_t mutexToReleaseVec = postedEventVec & MASK_EVT_IS_MUTEX;
-# ifdef DEBUG
-    uint16_t dbg_allMutexesToReleaseVec = mutexToReleaseVec;
-# endif
+    pT->pPrevSuspendedTask = pPred;
+    if(pPred != NULL)
+    {
+        pT->pNextSuspendedTask = pPred->pNextSuspendedTask;
+        pPred->pNextSuspendedTask = pT;
+    }
+    else
+    {
+        pT->pNextSuspendedTask = _pFirstSuspendedTask;
+        _pFirstSuspendedTask = pT;
+    }
+    if(pT->pNextSuspendedTask != NULL)
+        pT->pNextSuspendedTask->pPrevSuspendedTask = pT;
+
+    _pLastSuspendedTaskAry[prio] = pT;
+#else
+    /* Without priority classes, there are no tasks and the function is never called. */
 #endif
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON  ||  RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-    /* The implementation makes a distinction between synchronization objects (mutex and
-       semaphores) and ordinary, broadcasted events. */
-    postedEventVec &= ~(MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE);
+} /* End of linkSuspendedTask */
+
+
+
+
+/**
+ * Remove a task from the list of suspended tasks.
+ *   @param pT
+ * The task object. It needs to be in the list of suspended tasks and its element \a
+ * prioClass must not have been changed since it was inserted.
+ */
+
+static inline void unlinkSuspendedTask(task_t * const pT)
+{
+#if RTOS_NO_PRIO_CLASSES > 0
+    task_t * const pPrev = pT->pPrevSuspendedTask
+         , * const pNext = pT->pNextSuspendedTask;
+    const uint8_t prio = pT->prioClass;
+
+    if(pPrev != NULL)
+        pPrev->pNextSuspendedTask = pNext;
+    else
+    {
+        ASSERT(_pFirstSuspendedTask == pT);
+        _pFirstSuspendedTask = pNext;
+    }
+    if(pNext != NULL)
+        pNext->pPrevSuspendedTask = pPrev;
+
+    /* If the task is the last one of its class then its predecessor takes this role - if
+       it belongs to the same class. */
+    if(_pLastSuspendedTaskAry[prio] == pT)
+    {
+        if(pPrev != NULL  &&  pPrev->prioClass == prio)
+            _pLastSuspendedTaskAry[prio] = pPrev;
+        else
+            _pLastSuspendedTaskAry[prio] = NULL;
+    }
+#else
+    /* Without priority classes, there are no tasks and the function is never called. */
 #endif
+} /* End of unlinkSuspendedTask */
 
-    /* Post ordinary events to all suspended tasks which are waiting for it.
-         Pass mutexes and semaphores to a single task each, those task, which is of highest
-       priority and waits the longest for it. This loop is the reason, why we need to have
-       the list of suspended tasks always sorted, when at least one semaphore or mutex is in
-       use. */
-    uint8_t idxSuspTask = 0;
-    while(idxSuspTask<_noSuspendedTasks)
+
+
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+/**
+ * Enter a task, which is being suspended, into the lists of waiting tasks of all events
+ * it waits for. In each list the task is placed behind all tasks of same or higher
+ * priority.\n
+ *   A task, which already got a semaphore, doesn't wait for it any more and is not
+ * entered into the list of this semaphore. This way, the head of the list is always the
+ * task to receive the next release of the semaphore.
+ *   @param pT
+ * The task object. Its elements \a eventMask and \a postedEventVec need to be set.
+ */
+
+static inline void linkWaitingTask(const task_t * const pT)
+{
+    const uint8_t prio = pT->prioClass;
+    uintEventVec_t eventMask = pT->eventMask & ~MASK_EVT_IS_TIMER
+# if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+                               & ~(pT->postedEventVec & MASK_EVT_IS_SEMAPHORE)
+# endif
+                               ;
+    uint8_t idxEvt;
+
+    for(idxEvt=0; eventMask!=0; ++idxEvt, eventMask>>=1)
     {
-        task_t * const pT = _pSuspendedTaskAry[idxSuspTask];
-        
-        /* Remember the received events before (possibly) getting some more by this
-           sendEvent: Only if this set changes it is necessary to check for a state
-           transition of the task. */
-        const uint16_t postedEventVecBefore = pT->postedEventVec;
+        if((eventMask & 0x0001) != 0)
+        {
+            uint8_t * const pList = &_idxWaitingTaskAryAry[idxEvt][0];
+            uint8_t idxPos = _noWaitingTasksAry[idxEvt]++;
 
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
-        /* Mutexes are Boolean and can't be posted twice to a task. This is easily possible
-           but an application error. This assertion fires if the application doesn't
-           properly keep track of who owns which mutex. */
-        ASSERT((pT->postedEventVec & dbg_allMutexesToReleaseVec) == 0);
+            /* Shift all tasks of lower priority one position to the end. */
+            while(idxPos > 0  &&  _taskAry[pList[idxPos-1]].task.prioClass < prio)
+            {
+                pList[idxPos] = pList[idxPos-1];
+                -- idxPos;
+            }
+            pList[idxPos] = pT->idxTask;
+        }
+    }
+} /* End of linkWaitingTask */
 
-        /* The vector of all events this task will receive. */
-        uint16_t gotEvtVec = (postedEventVec | mutexToReleaseVec) & pT->eventMask;
 
-        /* Collect the events in the task object. */
-        pT->postedEventVec |= gotEvtVec;
 
-        /* Subtract the given mutexes from the vector of all, which are to release in this
-           call. It doesn't matter that the mask also contains ordinary events - all these
-           bits can do is to reset already reset bits. */
-        mutexToReleaseVec &= ~gotEvtVec;
-#else
-        pT->postedEventVec |= (postedEventVec & pT->eventMask);
 
-#endif /* RTOS_USE_MUTEX == RTOS_FEATURE_ON */
+/**
+ * Remove a task, which becomes due, from the lists of waiting tasks of all events it had
+ * waited for. The lists of the semaphores, which the task got meanwhile, are not touched;
+ * the task has already left them when it got the semaphore.
+ *   @param pT
+ * The task object. Its element \a eventMask still needs to be the mask, which had been
+ * used for linking the task.
+ */
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-        /* Now pass all released semaphores to tasks waiting for them. This can't be done
-           all at once as semaphores are not simply a bit. We need a second loop to do so.
-             Remark: The implementation of the loops here and down below is the reason why
-           we (arbitrarily) restrict the maximum number to eight: We can use native CPU
-           machine codes for most operations instead of much more expensive 16 Bit
-           operations. */
-        uint8_t semMask = 0x01;
-        while(semaphoreToReleaseVec != 0  &&  (semMask & MASK_EVT_IS_SEMAPHORE) != 0)
+static inline void unlinkWaitingTask(const task_t * const pT)
+{
+    uintEventVec_t eventMask = pT->eventMask & ~MASK_EVT_IS_TIMER
+# if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+                               & ~(pT->postedEventVec & MASK_EVT_IS_SEMAPHORE)
+# endif
+                               ;
+    uint8_t idxEvt;
+
+    for(idxEvt=0; eventMask!=0; ++idxEvt, eventMask>>=1)
+    {
+        if((eventMask & 0x0001) != 0)
         {
-            /* Check if this task is waiting for this semaphore but didn't get it yet (i.e.
-               in an earlier call of this routine). */
-            if((semaphoreToReleaseVec & semMask & pT->eventMask & ~pT->postedEventVec) != 0)
+            uint8_t * const pList = &_idxWaitingTaskAryAry[idxEvt][0];
+            const uint8_t noWaitingTasks = -- _noWaitingTasksAry[idxEvt];
+            uint8_t u = 0;
+
+            while(pList[u] != pT->idxTask)
             {
-                /* The semaphore release operation is handled by passing the semaphore to
-                   the task. */
-                pT->postedEventVec    |= semMask;
-                semaphoreToReleaseVec &= ~semMask;
+                ++ u;
+                ASSERT(u <= noWaitingTasks);
             }
+            for(; u<noWaitingTasks; ++u)
+                pList[u] = pList[u+1];
+        }
+    }
+} /* End of unlinkWaitingTask */
+#endif /* RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON */
+
+
+
+
+/**
+ * When an event has been posted to a currently suspended task, it might easily be that
+ * this task is resumed and becomes due. This routine checks a suspended task for resume
+ * and moves it into the due task lists if it is resumed.
+ *   @return
+ * The Boolean information whether the task is resumed and becomes due is returned.
+ *   @param pT
+ * The investigated task. It needs to be in the list of suspended tasks.
+ */
+
+static inline boolean checkTaskForActivation(task_t * const pT)
+{
+    uintEventVec_t eventVec;
+    boolean taskBecomesDue;
+
+    /* Check if the task becomes due because of the events posted prior to calling this
+       function. The optimally supported case is the more probable OR combination of
+       events.
+         The AND operation is less straight forward as the timeout character of the
+       timer events needs to be retained: AND only refers to the postable events but
+       does not include the timer events. All postable events need to be set in both
+       the mask and the vector of posted events OR any of the timer events in the mask
+       are set in the vector of posted events. */
+    eventVec = pT->postedEventVec;
+    if((pT->waitForAnyEvent &&  eventVec != 0)
+       ||  (!pT->waitForAnyEvent
+            &&  (((eventVec ^ pT->eventMask) & ~MASK_EVT_IS_TIMER) == 0
+                 ||  (eventVec & pT->eventMask & MASK_EVT_IS_TIMER) != 0
+                )
+           )
+      )
+    {
+        /* This task becomes due. */
+
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+        pT->tiRelease = micros();
+#endif
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+        /* If a round robin task voluntarily suspends it gets the right for a complete
+           new time slice. Reload the counter. */
+        pT->cntRoundRobin = pT->timeRoundRobin;
+#endif
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+        /* The task doesn't wait for notifications any longer, regardless whether it is
+           resumed by a notification or by its timeout. */
+        pT->notificationMask = 0;
+#endif
+        /* Move the task from the list of suspended tasks to the list of due tasks of
+           its priority class. A task, which has been parked by rtos_suspendTask while it
+           was waiting, leaves the list of suspended tasks but it doesn't become due. It
+           keeps its posted events until it is resumed by rtos_resumeTask. */
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+        if(pT->parkState == PARK_STATE_PENDING)
+            pT->parkState = PARK_STATE_PARKED;
+        else
+#endif
+            insertDueTask(pT);
+        unlinkSuspendedTask(pT);
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+        unlinkWaitingTask(pT);
+#endif
+
+        /* Since a task became due there might be a change of the active task. */
+        taskBecomesDue = true;
+    }
+    else
+        taskBecomesDue = false;
+    
+    return taskBecomesDue;
+    
+} /* End of checkTaskForActivation */
+
+
+
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+/**
+ * Record the new owner of some mutexes.
+ *   @param mutexVec
+ * The mutexes, which are acquired by the task, as a vector of events. All bits, which
+ * don't designate a mutex, need to be zero.
+ *   @param pT
+ * The task object of the new owner.
+ */
+
+static inline void setMutexOwner(uintEventVec_t mutexVec, task_t * const pT)
+{
+    uint8_t idxMutex;
+
+    mutexVec >>= RTOS_NO_SEMAPHORE_EVENTS;
+    for(idxMutex=0; mutexVec!=0; ++idxMutex, mutexVec>>=1)
+        if((mutexVec & 0x0001) != 0)
+            _pMutexOwnerAry[idxMutex] = pT;
+
+} /* End of setMutexOwner */
+#endif /* RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/**
+ * Move a task into another priority class. A due task is taken out of the due list of its
+ * current class and becomes the first or the last one in the due list of the new class. A
+ * suspended task is moved to the position in the list of suspended tasks and in the lists
+ * of waiting tasks, which corresponds to its new priority. A parked task, which is in
+ * none of the lists, only gets the new class.
+ *   @return
+ * Get true if the task is due and false if it is suspended or parked.
+ *   @param pT
+ * The task object. It must not be the idle task.
+ *   @param prio
+ * The new priority class of the task.
+ *   @param isLastDueTask
+ * If true, then a due task is appended to the due list of the new class: It is served
+ * after all other due tasks of that class. This is the penalty for a task, which exhausted
+ * its CPU budget. Otherwise, it becomes the first one in the list.
+ *   @remark
+ * The due list of the new class needs to have room for another task. Consider when
+ * setting #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS that the owner of a mutex may temporarily join
+ * the class of a task, which waits for the mutex and that a task, which exhausted its CPU
+ * budget, joins the class #RTOS_BUDGET_DEMOTION_PRIO_CLASS.
+ */
 
-            /* Shift mask one Bit to the left to test next semaphore in next cycle. */
-            semMask <<= 1;
+static boolean changePrioClass(task_t * const pT, uint8_t prio, boolean isLastDueTask)
+{
+    /* A due task is taken out of the due list of its current class. */
+    if(unlinkDueTask(pT))
+    {
+        uint8_t u;
+
+        ASSERT(_noDueTasksAry[prio] < RTOS_MAX_NO_TASKS_IN_PRIO_CLASS);
+        if(isLastDueTask)
+        {
+            pT->prioClass = prio;
+            insertDueTask(pT);
+            return true;
         }
+
+        /* The task becomes the first one in the new class: If it has inherited the
+           priority it runs in place of the waiting task before all others of that class.
+           If it falls back it was active in the higher class and this way it continues if
+           nothing else of higher priority is due. */
+        u = _idxFirstDueTaskAry[prio];
+        u = (u == 0? RTOS_MAX_NO_TASKS_IN_PRIO_CLASS: u) - 1;
+        _idxFirstDueTaskAry[prio] = u;
+        _pDueTaskAryAry[prio][u] = pT;
+        ++ _noDueTasksAry[prio];
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+        setPrioClassDue(prio);
 #endif
+        pT->prioClass = prio;
 
-        /* Check if this suspended task becomes due because of an event, which was posted
-           to it. */
-        if(postedEventVecBefore != pT->postedEventVec  && checkTaskForActivation(idxSuspTask))
+        return true;
+    }
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+    else if(pT->parkState == PARK_STATE_PARKED)
+    {
+        /* The parked task is in none of the lists. */
+        pT->prioClass = prio;
+        return false;
+    }
+#endif
+    else
+    {
+        /* The task is suspended. The list of suspended tasks is sorted by priority and
+           the task needs to be moved to another position. */
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+        unlinkWaitingTask(pT);
+#endif
+        unlinkSuspendedTask(pT);
+        pT->prioClass = prio;
+        linkSuspendedTask(pT);
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+        linkWaitingTask(pT);
+#endif
+
+        return false;
+    }
+} /* End of changePrioClass */
+#endif /* RTOS_USE_TASK_CONTROL, RTOS_USE_MUTEX_PRIO_INHERITANCE or RTOS_USE_TASK_BUDGET */
+
+
+
+
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+/**
+ * A task is suspended and waits for mutexes, which are currently owned by other tasks.
+ * The owners of lower priority are raised to the priority class of the waiting task. If
+ * such an owner is suspended itself and waits for another mutex, then the priority is
+ * passed on to the owner of that mutex and so on. The inherited class is recorded with
+ * each mutex for the later restoration, see restoreInheritedPrioClasses.
+ *   @param pWaiter
+ * The task object of the suspended task. Its resume condition needs to be set.
+ *   @remark
+ * The function is recursive. The depth of recursion is limited by the number of tasks,
+ * since a task, which has already inherited the priority, is not visited again.
+ */
+
+static void inheritPrioClass(const task_t * const pWaiter)
+{
+    uintEventVec_t mutexVec = pWaiter->eventMask & ~pWaiter->postedEventVec & ~_mutexVec
+                              & MASK_EVT_IS_MUTEX;
+    uint8_t idxMutex;
+
+    mutexVec >>= RTOS_NO_SEMAPHORE_EVENTS;
+    for(idxMutex=0; mutexVec!=0; ++idxMutex, mutexVec>>=1)
+    {
+        if((mutexVec & 0x0001) != 0)
         {
-            /* The task becomes due. */
-            activeTaskMayChange = true;
+            task_t * const pOwner = _pMutexOwnerAry[idxMutex];
+            if(_prioClassInheritedAry[idxMutex] < pWaiter->prioClass)
+                _prioClassInheritedAry[idxMutex] = pWaiter->prioClass;
+            if(pOwner->prioClass < pWaiter->prioClass)
+            {
+                if(!changePrioClass(pOwner, pWaiter->prioClass, /* isLastDueTask */ false))
+                    inheritPrioClass(pOwner);
+            }
+        }
+    }
+} /* End of inheritPrioClass */
 
-            /* Check next suspended task, which is in this case found in the array
-               element with same index: The task which became due has been removed into the
-               due list of its priority class. */
+
+
+
+/**
+ * Determine the priority class a task is entitled to: This is the higher one of its
+ * configured class and of the classes, which it has inherited through the mutexes it
+ * still owns.
+ *   @return
+ * Get the priority class.
+ *   @param pT
+ * The task object.
+ */
+
+static uint8_t getInheritedPrioClass(const task_t * const pT)
+{
+    uint8_t prio = pT->prioClassBase
+          , idxMutex;
+    uintEventVec_t mutexMask = 0x0001u << RTOS_NO_SEMAPHORE_EVENTS;
+
+    for(idxMutex=0; idxMutex<RTOS_NO_MUTEX_EVENTS; ++idxMutex, mutexMask<<=1)
+    {
+        if((_mutexVec & mutexMask) == 0
+           &&  _pMutexOwnerAry[idxMutex] == pT
+           &&  _prioClassInheritedAry[idxMutex] > prio
+          )
+        {
+            prio = _prioClassInheritedAry[idxMutex];
         }
-        else
+    }
+
+    return prio;
+
+} /* End of getInheritedPrioClass */
+
+
+
+
+/**
+ * Some mutexes are released. Their owners lose the priority classes, which they have
+ * inherited through these mutexes, and they are set back to the class they are still
+ * entitled to. Only the owners of the released mutexes are visited; the cost depends on
+ * the number of mutexes but not on the number of tasks.
+ *   @return
+ * Get true if at least one task has been moved into another priority class. A change of
+ * the active task is then possible.
+ *   @param mutexVec
+ * The released mutexes as a vector of events. All bits, which don't designate a mutex,
+ * need to be zero. The mutexes are still locked and \a _pMutexOwnerAry still holds their
+ * owners.
+ */
+
+static boolean restoreInheritedPrioClasses(uintEventVec_t mutexVec)
+{
+    boolean isChanged = false;
+    uintEventVec_t mutexMask;
+    uint8_t idxMutex;
+
+    /* Forget the inheritance through the released mutexes first; an owner may release
+       several of them at once. */
+    mutexVec >>= RTOS_NO_SEMAPHORE_EVENTS;
+    for(idxMutex=0, mutexMask=mutexVec; mutexMask!=0; ++idxMutex, mutexMask>>=1)
+        if((mutexMask & 0x0001) != 0)
+            _prioClassInheritedAry[idxMutex] = 0;
+
+    for(idxMutex=0, mutexMask=mutexVec; mutexMask!=0; ++idxMutex, mutexMask>>=1)
+    {
+        /* A mutex, which is released but not locked, is an application error, which is
+           caught later. Its owner is undefined. */
+        if((mutexMask & 0x0001) != 0
+           &&  (_mutexVec & (0x0001u << (idxMutex+RTOS_NO_SEMAPHORE_EVENTS))) == 0
+          )
         {
-            /* The task remains suspended. */
+            task_t * const pT = _pMutexOwnerAry[idxMutex];
+            if(pT->prioClass != pT->prioClassBase)
+            {
+                const uint8_t prio = getInheritedPrioClass(pT);
+                if(prio != pT->prioClass)
+                {
+                    changePrioClass(pT, prio, /* isLastDueTask */ false);
+                    isChanged = true;
+                }
+            }
+        }
+    }
 
-            /* Check next suspended task, which is in this case found in the next array
-               element. */
-            ++ idxSuspTask;
+    return isChanged;
 
-        } /* End if(Did this suspended task become due?) */
+} /* End of restoreInheritedPrioClasses */
+#endif /* RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON */
 
-    } /* End while(All suspended tasks) */
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-    /* The remaining semaphores (more precise: semaphore counter values) are accumulated in
-       the global semaphore storage for later acquisition. */
-    uint8_t idxSem = 0;
-    while(semaphoreToReleaseVec)
+
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/**
+ * Account the current system timer tic to the budget of the active task and replenish
+ * the budgets of all tasks, whose replenishment period elapses. A task, which exhausts its
+ * budget, is demoted to the priority class #RTOS_BUDGET_DEMOTION_PRIO_CLASS; it is set
+ * back to its own class when its budget is replenished.
+ *   @return
+ * Get true if at least one task has been moved into another priority class. A change of
+ * the active task is then possible.
+ *   @remark
+ * The function is called from the system timer interrupt.
+ */
+
+static inline boolean checkTaskBudgets(void)
+{
+    boolean isChanged = false;
+    task_t *pT = _pActiveTask;
+
+    /* The tic is accounted to the task, which was interrupted by it. The idle task has no
+       budget. */
+    if(pT->cntBudget != 0)
     {
-        if((semaphoreToReleaseVec & 0x01) != 0)
+        if(--pT->cntBudget == 0
+           &&  pT->prioClassBudget > RTOS_BUDGET_DEMOTION_PRIO_CLASS
+          )
         {
-            ++ rtos_semaphoreAry[idxSem];
+            /* The task is served after all due tasks of the demotion class, which didn't
+               overrun their budget. */
+            changePrioClass(pT, RTOS_BUDGET_DEMOTION_PRIO_CLASS, /* isLastDueTask */ true);
+            isChanged = true;
+        }
+    }
 
-            /* The assertion validates the application code. It fires if the application
-               releases/produces more semaphore counter values as fit into the data type of
-               the semphore. This is harmless with respect to the stability of the RTOS but
-               probably a design error in the application. */
-            ASSERT(rtos_semaphoreAry[idxSem] != 0);
+    uint8_t idxTask;
+    for(idxTask=0, pT=&_taskAry[0].task; idxTask<RTOS_NO_TASKS; ++idxTask, ++pT)
+    {
+        if(pT->budget != 0  &&  --pT->cntReplenish == 0)
+        {
+            pT->cntReplenish = pT->periodReplenish;
+            if(pT->cntBudget == 0  &&  pT->prioClass != pT->prioClassBudget)
+            {
+                changePrioClass(pT, pT->prioClassBudget, /* isLastDueTask */ false);
+                isChanged = true;
+            }
+            pT->cntBudget = pT->budget;
         }
+    }
 
-        /* Test next semaphore in next cycle. */
-        semaphoreToReleaseVec >>= 1;
+    return isChanged;
 
-        /* The next event/semaphore bit is related to the next array entry. */
-        ++ idxSem;
+} /* End of checkTaskBudgets */
+#endif /* RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+/**
+ * Account the time since the last task switch to the active task. The function is called
+ * whenever the active task is going to be left and when the runtime counters are read.
+ *   @param pT
+ * The task object the time is accounted to. This is the active task until now.
+ *   @remark
+ * The function is called with the interrupts disabled.
+ */
+
+static inline void accountTaskRuntime(task_t * const pT)
+{
+    const uint32_t tiNow = micros();
+    pT->tiRuntime += tiNow - _tiLastTaskSwitch;
+    _tiLastTaskSwitch = tiNow;
+
+} /* End of accountTaskRuntime */
+#endif
+
+
+
+
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+/**
+ * Add a new sample to the timing statistics of a task.
+ *   @param pStat
+ * The statistics to update.
+ *   @param tiSample
+ * The new sample in microseconds.
+ *   @remark
+ * If the sum of samples would overflow, the sum and the number of samples are halved.
+ * The average remains nearly unchanged but the elder samples get less weight.
+ */
+
+static void addTimingSample(timingStatistics_t * const pStat, uint32_t tiSample)
+{
+    if(pStat->noSamples == 0)
+    {
+        pStat->tiMin = tiSample;
+        pStat->tiMax = tiSample;
+    }
+    else
+    {
+        if(tiSample < pStat->tiMin)
+            pStat->tiMin = tiSample;
+        if(tiSample > pStat->tiMax)
+            pStat->tiMax = tiSample;
+    }
+
+    if(pStat->noSamples == UINT16_MAX  ||  pStat->tiSum + tiSample < pStat->tiSum)
+    {
+        pStat->tiSum >>= 1;
+        pStat->noSamples >>= 1;
+    }
+    pStat->tiSum += tiSample;
+    ++ pStat->noSamples;
+
+} /* End of addTimingSample */
+
+
+
+
+/**
+ * Copy the statistics of a measured duration into the representation of the API.
+ *   @param pResult
+ * The API object, which receives the statistics. May be NULL if the information is not
+ * needed.
+ *   @param pStat
+ * The kernel internal statistics.
+ *   @param doReset
+ * If true, the kernel internal statistics are reset to no samples.
+ */
+
+static void getTimingStatistics( rtos_timingStatistics_t * const pResult
+                               , timingStatistics_t * const pStat
+                               , boolean doReset
+                               )
+{
+    if(pResult != NULL)
+    {
+        pResult->noSamples = pStat->noSamples;
+        if(pStat->noSamples > 0)
+        {
+            pResult->tiMin = pStat->tiMin;
+            pResult->tiAvg = pStat->tiSum / pStat->noSamples;
+            pResult->tiMax = pStat->tiMax;
+        }
+        else
+        {
+            pResult->tiMin =
+            pResult->tiAvg =
+            pResult->tiMax = 0;
+        }
+    }
+
+    if(doReset)
+    {
+        pStat->tiSum = 0;
+        pStat->noSamples = 0;
+    }
+} /* End of getTimingStatistics */
+
+
+
+
+/**
+ * A task becomes the active task. If this is the first activation after its release then
+ * the start latency is recorded.
+ *   @param pT
+ * The new active task.
+ *   @remark
+ * The function is called with the interrupts disabled.
+ */
+
+static inline void onTaskStart(task_t * const pT)
+{
+    /* A task, which is resumed after preemption, has no posted events. Its event vector is
+       set only when being released and it is reset at its first activation. The idle task
+       never has posted events. */
+    if(pT->postedEventVec != 0)
+    {
+        pT->tiStart = micros();
+        addTimingSample(&pT->statStartLatency, pT->tiStart - pT->tiRelease);
+    }
+} /* End of onTaskStart */
+#endif
+
+
+
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/**
+ * An application interrupt is entered. The entry is time stamped if a task is waiting for
+ * the event the interrupt posts and if no measurement of this interrupt is pending.
+ *   @param idxInterrupt
+ * The index of the application interrupt, 0 or 1.
+ *   @remark
+ * The function is called from the naked service routines of the application interrupts,
+ * after they saved the context of the interrupted task. It must not be inlined.
+ */
+
+static RTOS_TRUE_FCT void onApplInterruptEntry(uint8_t idxInterrupt)
+{
+    /* A repeated interrupt doesn't shorten the latency of the first one. */
+    if(_isApplIsrLatencyPendingAry[idxInterrupt])
+        return;
+
+    const uint16_t tiEntry = RTOS_ISR_LATENCY_TIMESTAMP();
+    const uintEventVec_t evt = idxInterrupt == 0? EVT_ISR_LATENCY_00: EVT_ISR_LATENCY_01;
+    const task_t *pT;
+    for(pT=_pFirstSuspendedTask; pT!=NULL; pT=pT->pNextSuspendedTask)
+    {
+        if((pT->eventMask & evt) != 0)
+        {
+            _tiApplIsrEntryAry[idxInterrupt] = tiEntry;
+            _isApplIsrLatencyPendingAry[idxInterrupt] = true;
+            break;
+        }
+    }
+} /* End of onApplInterruptEntry */
+
+
+
+
+/**
+ * A task becomes the active task. If it has been resumed by an application interrupt, then
+ * the latency of the interrupt is entered into the histogram.
+ *   @param pT
+ * The new active task.
+ *   @remark
+ * The function is called with the interrupts disabled.
+ */
+
+static inline void accountIsrLatency(const task_t * const pT)
+{
+    uint8_t idxInterrupt;
+    for(idxInterrupt=0; idxInterrupt<2; ++idxInterrupt)
+    {
+        /* The posted events of the task are the events, which resumed it - as long as it
+           has not been active since. */
+        const uintEventVec_t evt = idxInterrupt == 0? EVT_ISR_LATENCY_00
+                                                    : EVT_ISR_LATENCY_01;
+        if(_isApplIsrLatencyPendingAry[idxInterrupt]  &&  (pT->postedEventVec & evt) != 0)
+        {
+            const uint16_t tiLatency = RTOS_ISR_LATENCY_TIMESTAMP()
+                                       - _tiApplIsrEntryAry[idxInterrupt];
+            rtos_isrLatencyHistogram_t * const pH = &_isrLatencyHistogramAry[idxInterrupt];
+
+            /* The bucket is the number of significant bits of the latency. */
+            uint8_t idxBucket = 0;
+            uint16_t tiRemaining = tiLatency;
+            while(tiRemaining != 0  &&  idxBucket < RTOS_ISR_LATENCY_NO_BUCKETS-1)
+            {
+                ++ idxBucket;
+                tiRemaining >>= 1;
+            }
+            if(pH->noSamplesAry[idxBucket] < UINT16_MAX)
+                ++ pH->noSamplesAry[idxBucket];
+            if(tiLatency > pH->tiMax)
+                pH->tiMax = tiLatency;
+
+            _isApplIsrLatencyPendingAry[idxInterrupt] = false;
+        }
+    }
+} /* End of accountIsrLatency */
+#endif /* RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+/**
+ * Write a task switch into the binary trace. The argument of the entry holds the index of
+ * the left task in the high byte and the index of the new active task in the low byte.
+ */
+
+static inline void traceTaskSwitch(void)
+{
+    KERNEL_TRACE( TRC_ID_TASK_SWITCH
+                , ((uint16_t)getIdxTask(_pSuspendedTask) << 8) | getIdxTask(_pActiveTask)
+                );
+} /* End of traceTaskSwitch */
+#endif
+
+
+
+
+/**
+ * After posting an event to one or more currently suspended tasks, it might easily be that
+ * one such task is resumed and becomes due - active because of its higher priority. To
+ * find out, this function needs to be called after posting the events. It determines which
+ * task is now the active task.
+ *   @return
+ * The Boolean information wheather the active task now is another task is returned.\n
+ *   If the function returns true, references to the old and the new active task are
+ * reported by side effect: They are written into the global variables \a _pSuspendedTask and
+ * \a _pActiveTask.
+ */
+ 
+static inline boolean lookForActiveTask()
+{
+    /* The calling interrupt service routine will do a context switch only if we return
+       true. Otherwise it'll simply do a "reti" to the interrupted context and continue
+       it. */
+       
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    /* A pending decision about the active task is taken now. */
+    _isReschedulePending = false;
+#endif
+
+    /* Look for the task we will return to. It's the first entry in the highest
+       non-empty priority class. */
+    const int8_t idxPrio = getHighestDuePrioClass();
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_OFF
+    if(idxPrio >= 0)
+#endif
+    {
+        _pSuspendedTask = _pActiveTask;
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+        /* All due lists can be empty after the active task has parked itself by
+           rtos_suspendTask. The idle task is the fallback in this case. */
+        if(idxPrio < 0)
+            _pActiveTask = _pIdleTask;
+        else
+#endif
+            _pActiveTask = _pDueTaskAryAry[idxPrio][_idxFirstDueTaskAry[idxPrio]];
+
+        /* If we only entered the outermost if clause we made at least one task due; these
+           statements are thus surely reached. As the due becoming task might however be of
+           lower priority it can easily be that we nonetheless don't have a task switch. */
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON \
+    ||  RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON \
+    ||  RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON \
+    ||  RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+        if(_pActiveTask != _pSuspendedTask)
+        {
+# if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+            traceTaskSwitch();
+# endif
+# if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+            accountTaskRuntime(_pSuspendedTask);
+# endif
+# if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+            onTaskStart(_pActiveTask);
+# endif
+# if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+            accountIsrLatency(_pActiveTask);
+# endif
+            return true;
+        }
+        else
+            return false;
+#else
+        return _pActiveTask != _pSuspendedTask;
+#endif
+    }
+
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_OFF
+    /* We never get here. This function is called under the precondition that a task was
+       put into a due list, so the search above will surely have found one. */
+    ASSERT(false);
+    return false;
+#endif
+
+} /* End of lookForActiveTask */
+
+
+
+
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+/**
+ * Determine the number of system timer tics until the next tic, which posts a timer event
+ * to a suspended task.
+ *   @return
+ * Get the number of tics. 1 means the very next tic. The maximum value of uintTime_t is
+ * returned if no suspended task waits for a timer event in the foreseeable future.
+ */
+
+static inline uintTime_t getNoTicsTillNextTimerEvent(void)
+{
+    uintTime_t noTicsMin = (uintTime_t)-1;
+    const task_t *pT;
+
+    for(pT=_pFirstSuspendedTask; pT!=NULL; pT=pT->pNextSuspendedTask)
+    {
+        uintTime_t noTics;
+
+        /* A difference of null in time means a complete cycle of the system time. */
+# if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+        if((pT->eventMask & MASK_EVT_IS_TIMER) != 0)
+        {
+            noTics = pT->timeTimeout - _time;
+            if(noTics != 0  &&  noTics < noTicsMin)
+                noTicsMin = noTics;
+        }
+# else
+        if((pT->eventMask & RTOS_EVT_ABSOLUTE_TIMER) != 0)
+        {
+            noTics = pT->timeDueAt - _time;
+            if(noTics != 0  &&  noTics < noTicsMin)
+                noTicsMin = noTics;
+        }
+        if((pT->eventMask & RTOS_EVT_DELAY_TIMER) != 0)
+        {
+            noTics = pT->cntDelay;
+            if(noTics != 0  &&  noTics < noTicsMin)
+                noTicsMin = noTics;
+        }
+# endif
+    }
+
+    return noTicsMin;
+
+} /* End of getNoTicsTillNextTimerEvent */
+
+
+
+
+/**
+ * Advance the system time by a number of tics, without the normal processing of these
+ * tics. This is used to catch up with the time, which has elapsed in a tickless period.
+ *   @param noTics
+ * The number of skipped tics. It needs to be less than the value of
+ * getNoTicsTillNextTimerEvent() at the beginning of the tickless period: The skipped tics
+ * must not post any timer event.
+ */
+
+static inline void skipTics(uint8_t noTics)
+{
+    _time += noTics;
+# if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+    _noTicsTimestamp += noTics;
+# endif
+
+# if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_OFF
+    /* The delay counters count the elapsed tics. No counter will reach null for a task,
+       which waits for the delay timer. */
+    task_t *pT;
+    for(pT=_pFirstSuspendedTask; pT!=NULL; pT=pT->pNextSuspendedTask)
+    {
+        if(pT->cntDelay > noTics)
+            pT->cntDelay -= noTics;
+        else
+        {
+            ASSERT((pT->eventMask & RTOS_EVT_DELAY_TIMER) == 0);
+            pT->cntDelay = 0;
+        }
+    }
+# endif
+} /* End of skipTics */
+
+
+
+
+/**
+ * Called from the idle task: If no suspended task waits for a timer event in the next tics
+ * then the clock of timer 2 is reduced such that the next interrupt only appears after
+ * #TICKLESS_NO_TICS_PER_PERIOD tics.
+ *   @remark
+ * The function must be called by the idle task only. Only then, no task is due.
+ */
+
+static void enterTicklessPeriod(void)
+{
+    cli();
+    if(!_isTicklessPeriod)
+    {
+        /* The current position in the tic period is required to not loose the phase of
+           the system timer. If the tic has just elapsed, i.e. the interrupt is pending,
+           or is about to elapse we don't enter the tickless period now. */
+        const uint8_t cnt = TCNT2;
+        if((TIFR2 & _BV(TOV2)) == 0  &&  cnt != 255
+           &&  getNoTicsTillNextTimerEvent() >= TICKLESS_NO_TICS_PER_PERIOD
+          )
+        {
+            /* The counter is continued with the eight times slower clock. The overflow
+               occurs at the end of the tic, which is #TICKLESS_NO_TICS_PER_PERIOD tics
+               after the last processed one. */
+            TCCR2B = TCCR2B_TICKLESS;
+            TCNT2  = cnt >> 3;
+            _ticklessPhaseRemainder = cnt & 0x07;
+            _isTicklessPeriod = true;
+        }
+    }
+    sei();
+
+} /* End of enterTicklessPeriod */
+
+
+
+
+/**
+ * A tickless period ends either with the interrupt of timer 2 or if the kernel is entered
+ * by another interrupt or by the idle task. The normal clock of timer 2 is restored and
+ * the elapsed tics are added to the system time.
+ *   @param isTicIsr
+ * true, if the function is called from the system timer interrupt. The tickless period is
+ * complete and this interrupt will process its last tic.
+ *   @remark
+ * This function needs to be called with all interrupts disabled.
+ */
+
+static void leaveTicklessPeriod(boolean isTicIsr)
+{
+    uint8_t cnt = TCNT2
+          , noTics;
+
+    if(isTicIsr  ||  (TIFR2 & _BV(TOV2)) != 0)
+    {
+        /* The period is complete; the last tic of it is processed by the running or the
+           pending interrupt. The counter value is the time elapsed in the next tic. */
+        noTics = TICKLESS_NO_TICS_PER_PERIOD-1;
+        if(cnt > 31)
+            cnt = 31;
+    }
+    else
+    {
+        /* One tic takes 32 counts with the reduced clock. */
+        noTics = cnt >> 5;
+        cnt &= 0x1f;
+    }
+
+    /* Continue the counter with the normal clock and the same phase. */
+    TCCR2B = TCCR2B_NORMAL_TICS;
+    TCNT2  = (cnt << 3) + _ticklessPhaseRemainder;
+    _isTicklessPeriod = false;
+
+    skipTics(noTics);
+
+} /* End of leaveTicklessPeriod */
+#endif /* RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+/**
+ * Account the elapsed sleep time if the CPU has been sent to sleep by the idle task and
+ * has not been woken up yet. The function is called by the idle task after the sleep
+ * instruction and by the kernel interrupts. A kernel interrupt can switch to another task
+ * and the idle task would then account the execution time of this task as sleep time.
+ *   @remark
+ * The function is called with the interrupts disabled.
+ */
+
+static inline void endIdleSleep(void)
+{
+    if(_isIdleSleeping)
+    {
+        _tiIdleSleep += micros() - _tiStartIdleSleep;
+        _isIdleSleeping = false;
+    }
+} /* End of endIdleSleep */
+#endif /* RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+/**
+ * Sample the stack pointer of the active task and update its low-water mark. The function
+ * is called on entry into the kernel, when the stack of the active task holds its complete
+ * context.
+ */
+
+static inline void sampleStackPointer(void)
+{
+    const uint16_t sp = SP;
+    if(sp < _pActiveTask->minStackPointer)
+        _pActiveTask->minStackPointer = sp;
+
+} /* End of sampleStackPointer */
+#endif
+
+
+
+
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+/**
+ * Check the bottom bytes of all task stacks. They still hold the initial pattern unless
+ * the stack has overflown. On failure, the application is notified by the callback \a
+ * rtos_onStackOverflow.
+ */
+
+static inline void checkStackCanaries(void)
+{
+    uint8_t idxTask;
+    for(idxTask=0; idxTask<RTOS_NO_TASKS; ++idxTask)
+    {
+        const uint8_t * const pCanary = STACK_AREA_OF_TASK(idxTask);
+        uint8_t u;
+        for(u=0; u<SIZE_OF_STACK_CANARY; ++u)
+        {
+            if(pCanary[u] != UNUSED_STACK_PATTERN)
+            {
+                rtos_onStackOverflow(idxTask);
+                break;
+            }
+        }
+    }
+} /* End of checkStackCanaries */
+#endif
+
+
+
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/**
+ * Count down the check-in periods of all monitored tasks and service the watchdog if all
+ * of them are live. If a task has missed its check-in, then the failure is recorded for
+ * rtos_getLivenessFailure and the application is notified by the callback \a
+ * rtos_onLivenessFailure. From then on, the watchdog is no longer serviced and it'll
+ * reset the CPU.
+ *   @remark
+ * The function is called from the system timer interrupt.
+ */
+
+static inline void checkTaskLiveness(void)
+{
+    /* The failure is final, we wait for the reset. */
+    if(_isLivenessFailure)
+        return;
+
+    uint8_t idxTask;
+    task_t *pT;
+    for(idxTask=0, pT=&_taskAry[0].task; idxTask<RTOS_NO_TASKS; ++idxTask, ++pT)
+    {
+        if(pT->periodLiveness != 0  &&  --pT->cntLiveness == 0)
+        {
+            _livenessFailureRecord.idxTask = idxTask;
+            _livenessFailureRecord.idxTaskInv = ~idxTask;
+            _livenessFailureRecord.magic = MAGIC_LIVENESS_FAILURE_RECORD;
+            _isLivenessFailure = true;
+            rtos_onLivenessFailure(idxTask);
+            return;
+        }
+    }
+
+#ifndef RTOS_HOST_SIMULATION
+    wdt_reset();
+#endif
+} /* End of checkTaskLiveness */
+
+
+
+
+# ifndef RTOS_HOST_SIMULATION
+/**
+ * Disable the watchdog at startup. After a watchdog reset, the watchdog stays enabled
+ * with its shortest timeout and it would reset the CPU again long before the kernel
+ * services it. The function is placed into section .init3; it's executed by the C
+ * runtime before the initialization of data and before main().
+ */
+
+static void disableWatchdogAfterReset(void)
+{
+    MCUSR &= ~_BV(WDRF);
+    wdt_disable();
+
+} /* End of disableWatchdogAfterReset */
+# endif
+#endif /* RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_LAZY_STACK_FILL == RTOS_FEATURE_ON
+/**
+ * Fill the unused part of all task stacks with the pattern byte #UNUSED_STACK_PATTERN.
+ * The function is called by the idle task, once after start of the kernel. The pattern
+ * is written from the bottom of a stack upwards, up to the saved stack pointer of the
+ * task. The work is done in small portions; any task can preempt the idle task in between
+ * and the latency of interrupts is increased by a few microseconds only.
+ *   @remark
+ * The bytes below the saved stack pointer of a suspended task are not in use. A task,
+ * which had used some of them before they were filled, isn't seen by
+ * rtos_getStackReserve.
+ */
+
+static void fillTaskStacks(void)
+{
+    uint8_t idxTask;
+    for(idxTask=0; idxTask<RTOS_NO_TASKS; ++idxTask)
+    {
+        uint8_t *pFill = STACK_AREA_OF_TASK(idxTask);
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+        /* The canary has been written at startup. It must not be repainted as it could
+           hide an overflow. */
+        pFill += SIZE_OF_STACK_CANARY;
+#endif
+        boolean isFilled;
+        do
+        {
+            uint8_t noBytes = NO_BYTES_STACK_FILL_CHUNK;
+
+            /* The idle task is the active task. All other tasks are suspended and their
+               stack pointer is saved in the task object. The stack pointer points to the
+               next free byte; it's changed by a context switch only. */
+            cli();
+            const uint8_t * const pEnd = (const uint8_t*)_taskAry[idxTask].task.stackPointer;
+            while(noBytes-- > 0  &&  pFill <= pEnd)
+                * pFill++ = UNUSED_STACK_PATTERN;
+            isFilled = pFill > pEnd;
+            sei();
+        }
+        while(!isFilled);
+    }
+} /* End of fillTaskStacks */
+#endif
+
+
+
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+/**
+ * Write the timeout of a task into the binary trace.
+ *   @param pT
+ * The task, which is resumed by a timer event. Its index is the argument of the entry.
+ */
+
+static inline void traceTimeout(const task_t * const pT)
+{
+    KERNEL_TRACE(TRC_ID_TIMEOUT, getIdxTask(pT));
+
+} /* End of traceTimeout */
+#endif
+
+
+
+
+/**
+ * This function is called from the system interrupt triggered by the main clock. The
+ * timers of all due tasks are served and - in case they elapse - timer events are
+ * generated. These events may then resume some of the tasks. If so, they are placed in
+ * the appropriate list of due tasks. Finally, the longest due task in the highest none
+ * empty priority class is activated.
+ *   @return
+ * The Boolean information is returned whether we have or not have a task switch. In most
+ * invocations we won't have and therefore it's worth to optimize the code for this case:
+ * Don't do the expensive switch of the stack pointers.\n
+ *   The most important result of the function, the reference to the active task after
+ * leaving the function, is returned by side effect: The global variable _pActiveTask is
+ * updated.
+ */
+
+static RTOS_TRUE_FCT boolean onTimerTic(void)
+{
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    /* The interrupted task is still the active one. */
+    sampleStackPointer();
+#endif
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+    checkStackCanaries();
+#endif
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+    checkTaskLiveness();
+#endif
+
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+    /* The tic may have woken up the CPU. */
+    endIdleSleep();
+#endif
+
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+    /* This interrupt may end a tickless period. The tics in this period but the last one
+       are skipped. */
+    if(_isTicklessPeriod)
+        leaveTicklessPeriod(/* isTicIsr */ true);
+#endif
+
+    /* Clock the system time. Cyclic overrun is intended. */
+    ++ _time;
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+    ++ _noTicsTimestamp;
+#endif
+
+    boolean activeTaskMayChange = false;
+
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+    /* Only the tasks in the bucket of the timer wheel, which belongs to the current time,
+       can see a timer event. */
+    task_t **ppT = &_pTimerWheelAry[_time & MASK_TIMER_WHEEL_IDX];
+    task_t *pT;
+    while((pT = *ppT) != NULL)
+    {
+        if(pT->timeTimeout == _time)
+        {
+            /* The timeout of this task elapses. Take it out of the timer wheel and post
+               the timer event it is waiting for. A task can't wait for both timers at a
+               time. */
+            *ppT = pT->pNextTimeout;
+            pT->postedEventVec |= (pT->eventMask & MASK_EVT_IS_TIMER);
+# if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+            traceTimeout(pT);
+# endif
+
+            /* A timer event always resumes a task, regardless of the AND or OR
+               combination of the events it waits for. */
+# ifdef DEBUG
+            ASSERT(checkTaskForActivation(pT));
+# else
+            checkTaskForActivation(pT);
+# endif
+            activeTaskMayChange = true;
+        }
+        else
+        {
+            /* The timeout of this task elapses in a later cycle of the timer wheel. */
+            ppT = &pT->pNextTimeout;
+        }
+    } /* End while(All tasks in the bucket of the timer wheel) */
+#else
+    /* Check for all suspended tasks if a timer event has to be posted. */
+    task_t *pNextT = _pFirstSuspendedTask;
+    while(pNextT != NULL)
+    {
+        task_t * const pT = pNextT;
+
+        /* Get the successor before the task (possibly) leaves the list. */
+        pNextT = pT->pNextSuspendedTask;
+        
+        /* Remember the received events before (possibly) getting some more in this
+           timer tic: Only if this set changes it is necessary to check for a state
+           transition of the task. */
+        const uintEventVec_t postedEventVecBefore = pT->postedEventVec;
+        
+        /* Check for absolute timer event. */
+        if(_time == pT->timeDueAt)
+        {
+            /* Setting the absolute timer event when it already is set looks like a task
+               overrun indication. It isn't for the following reason. The absolute timer
+               event can't be AND combined with other events, so the event will immediately
+               change the status to due (see checkForTaskActivation), so that setting it a
+               second time will never occur. */
+            pT->postedEventVec |= (RTOS_EVT_ABSOLUTE_TIMER & pT->eventMask);
+        }
+
+        /* Check for delay timer event. The code here should optimally support the standard
+           situation that the counter is constantly 0. */
+        if(pT->cntDelay != 0)
+        {
+            if(-- pT->cntDelay == 0)
+                pT->postedEventVec |= (RTOS_EVT_DELAY_TIMER & pT->eventMask);
+        }
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+        if(((pT->postedEventVec ^ postedEventVecBefore) & MASK_EVT_IS_TIMER) != 0)
+            traceTimeout(pT);
+#endif
+
+        /* Check if this suspended task becomes due because of a timer event, which was
+           posted to it. */
+        if(postedEventVecBefore != pT->postedEventVec  && checkTaskForActivation(pT))
+        {
+            /* The task becomes due, which may cause a task switch. */
+            activeTaskMayChange = true;
+        }
+
+    } /* End while(All suspended tasks) */
+#endif /* RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON */
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+    /* Account the tic to the budget of the active task. A task, which exhausted its
+       budget, leaves its priority class and one, whose budget is replenished, returns. */
+    if(checkTaskBudgets())
+        activeTaskMayChange = true;
+#endif
+
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+    /* Round-robin: Applies only to the active task. It can become inactive, however not
+       undue, or suspended respectively. If its time slice is elapsed it is put at the end
+       of the due list in its priority class. */
+    if(_pActiveTask->cntRoundRobin != 0)
+    {
+        if(--_pActiveTask->cntRoundRobin == 0)
+        {
+            /* Time slice of active task has elapsed. Reload the counter. */
+            _pActiveTask->cntRoundRobin = _pActiveTask->timeRoundRobin;
+
+            const uint8_t prio = _pActiveTask->prioClass
+                        , noTasks = _noDueTasksAry[prio];
+
+            /* If there are more due tasks in the same class the next one will be made the
+               active one by a cyclic move of the positions in the list. */
+            if(noTasks > 1)
+            {
+                /* The circular list of due tasks in the active priority class is rolled by
+                   one task: The active task, which is the first one, is appended at the
+                   end and the start of the list is advanced. The next due task will become
+                   active. If the list is full, then the end of the list is the position of
+                   the active task and the assignment has no effect. */
+                _pDueTaskAryAry[prio][getIdxDueTask(prio, noTasks)] = _pActiveTask;
+                _idxFirstDueTaskAry[prio] = getIdxDueTask(prio, 1);
+
+                /* Force check for new active task - even if no suspended task should have been
+                   resumed. */
+                activeTaskMayChange = true;
+
+            } /* if(Did the task loose against another due one?) */
+
+        } /* if(Did the round robin time of the task elapse?) */
+
+    } /* if(Do we have a round robin task?) */
+#endif
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+    /* An application interrupt may have posted events by rtos_sendEventFromISR without
+       calling rtos_leaveISR. The task switch is not lost but delayed till now. */
+    if(_isReschedulePending)
+        activeTaskMayChange = true;
+#endif
+
+    /* Check if another task becomes active because of the possibly occurred timer events.
+         activeTaskMayChange: We do the search for the new active task only if at least one
+       suspended task was resumed. If round robin is compiled it depends. Always look for a
+       new active task if the round robin time has elapsed.
+         The function has side effects: If there's a task which was suspended before and
+       which is resumed because of the timer events and which is of higher priority than
+       the one being active so far, the refernces to the old and newly active task are
+       written into global variables _pSuspendedTask and _pActiveTask. */
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    /* In cooperative mode, the interrupt never switches the task. The decision is taken
+       when the active task calls the kernel the next time, e.g. by rtos_yield. */
+    if(activeTaskMayChange)
+        _isReschedulePending = true;
+    return false;
+#else
+    return activeTaskMayChange && lookForActiveTask();
+#endif
+
+} /* End of onTimerTic. */
+
+
+
+
+#if RTOS_USE_NESTED_INTERRUPTS == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+/**
+ * Call onTimerTic with open interrupts. All kernel aware interrupts, including the system
+ * timer tic itself, are masked, so that only interrupts, which don't access the data of the
+ * kernel, can nest into the scheduling code. On return, the interrupts are globally
+ * disabled again and the kernel aware interrupts are unmasked; the following switch of the
+ * stack pointer is atomic.
+ *   @return
+ * Get the return value of onTimerTic, whether the active task changes.
+ *   @remark
+ * The function is called from the naked system timer ISR, after the context has been
+ * saved. The naked ISR must not have local data; this function provides the stack frame
+ * for the result.
+ */
+
+static RTOS_TRUE_FCT boolean onTimerTicNested(void)
+{
+    RTOS_MASK_KERNEL_INTERRUPTS();
+    sei();
+
+    const boolean isTaskSwitch = onTimerTic();
+
+    cli();
+    RTOS_UNMASK_KERNEL_INTERRUPTS();
+    return isTaskSwitch;
+
+} /* End of onTimerTicNested */
+#endif
+
+
+
+
+
+
+/**
+ * Each call of this function cyclically increments the system time of the kernel by one.\n
+ *   Incrementing the system timer is an important system event. The routine will always
+ * include an inspection of all suspended tasks, whether they could become due again.
+ *   The cycle time of the system time is low (typically implemented as 0..255) and
+ * determines the maximum delay time or timeout for a task which suspends itself and the
+ * ratio of the task periods of the fastest and the slowest regular task. Furthermore it
+ * determines the reliability of task overrun recognition. Task overrun events in the
+ * magnitude of half the cycle time won't be recognized as such.\n
+ *   The unit of the time is defined only by the it triggering source and doesn't matter at
+ * all for the kernel. The time even don't need to be regular.\n
+ *   @remark
+ * The function needs to be called by an interrupt and can easily end with a context change,
+ * i.e. the interrupt will return to another task as the one it had interrupted.
+ *   @remark
+ * The connected interrupt is defined by macro #RTOS_ISR_SYSTEM_TIMER_TIC. This interrupt
+ * needs to be disabled/enabled by the implementation of \a enterCriticalSection and \a
+ * leaveCriticalSection.
+ *   @remark
+ * The cycle time of the system time can be influenced by the typedef of uintTime_t. Find a
+ * discussion of pros and cons at the location of this typedef.
+ *   @see boolean onTimerTic(void)
+ *   @see #rtos_enterCriticalSection
+ */
+
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+ISR(RTOS_ISR_SYSTEM_TIMER_TIC)
+{
+    /* In cooperative mode, the interrupt never switches the task. It is an ordinary
+       interrupt service routine and the compiler saves only those registers, which are
+       used. The tasks, which are made due, are activated at the next kernel call of the
+       active task. */
+    onTimerTic();
+
+} /* End of ISR to increment the system time by one tic. */
+#else
+ISR(RTOS_ISR_SYSTEM_TIMER_TIC, ISR_NAKED)
+{
+    /* An ISR must not occur while we're updating the global data and checking for a
+       possible task switch. To be more precise: The call of onTimerTic would just require
+       to inhibit all those interrupts which might initiate a task switch. As long as no
+       user defined interrupts are configured to set an RTOS event, this is only the single
+       timer interrupt driving the system time. However, at latest when a task switch
+       really is initiated we would need to lock all interrupts globally (as we modify the
+       stack pointer in non-atomic operation). It doesn't matter to have locked all
+       interrupts globally already here. */
+
+#ifdef RTOS_HOST_SIMULATION
+    /* The routine is called from the handler of the timer signal, which is blocked
+       meanwhile. The context of the interrupted task is saved by switchContext. If the
+       task is left, then it continues here when it becomes active again and the return
+       from the signal handler restores the interrupt state of the task. */
+    if(onTimerTic())
+        switchContext();
+#else
+# if RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON
+    /* Most timer tics don't switch the task. It's sufficient to save those registers,
+       which the call of onTimerTic can alter. */
+    PUSH_CALL_CLOBBERED_REGISTERS_ONTO_STACK
+
+    /* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
+       interrupted code. To make the local code here running, we need to anticipate this
+       situation and clear the register. */
+    asm volatile
+    ("clr __zero_reg__ \n\t"
+    );
+
+    /* Check for all suspended tasks if this change in time is an event for them. */
+    if(CALL_ON_TIMER_TIC())
+    {
+        /* Another task becomes active with this timer tic. The registers of the
+           interrupted task are restored to what they were at entry into this ISR; all
+           other registers still have this state as onTimerTic preserves them. Now the
+           complete context can be saved in the normal way. */
+        POP_CALL_CLOBBERED_REGISTERS_FROM_STACK
+        PUSH_CONTEXT_ONTO_STACK
+        asm volatile
+        ("clr __zero_reg__ \n\t"
+        );
+
+        /* Switch the stack pointer to the (saved) stack pointer of the new task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+
+        /* The CPU context of the new active task is popped from its stack. See below for
+           the normal, not lazy implementation. */
+        POP_CONTEXT_FROM_STACK
+    }
+    else
+    {
+        /* No task switch, return to the interrupted task. */
+        POP_CALL_CLOBBERED_REGISTERS_FROM_STACK
+    }
+# else
+    /* Save context onto the stack of the interrupted active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
+       interrupted code. To make the local code here running, we need to anticipate this
+       situation and clear the register. */
+    asm volatile
+    ("clr __zero_reg__ \n\t"
+    );
+
+    /* Check for all suspended tasks if this change in time is an event for them. */
+    if(CALL_ON_TIMER_TIC())
+    {
+        /* Yes, another task becomes active with this timer tic. Switch the stack pointer
+           to the (saved) stack pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The highly critical operation of modifying the stack pointer is done. From now on,
+       all interrupts could safely operate on the new stack, the stack of the new task. This
+       includes such an interrupt which would cause another task switch. However, early
+       releasing the global interrupts here could lead to higher use of stack area if many
+       task switches appear one after another. Therefore we will reenable the interrupts
+       only with the final reti command. The disadvantage is probably minor (some clock
+       tics less of responsiveness of the system). The by far longer part of the ISR, the
+       call of onTimerTic, can be opened for other interrupts, see
+       #RTOS_USE_NESTED_INTERRUPTS. */
+
+    /* The stack pointer points to the now active task (which will often be still the same
+       as at function entry). The CPU context to continue with is popped from this stack. If
+       there's no change in active task the entire routine call is just like any ordinary
+       interrupt. */
+    POP_CONTEXT_FROM_STACK
+# endif /* RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON */
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret.
+         If we return to the same context, this will not mean that we harmfully change the
+       state of a running context without the context knowing or willing it: If the context
+       had reset the bit we would never have got here, as this is an ISR controlled by the
+       bit. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of ISR to increment the system time by one tic. */
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON  \
+    &&  (RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON)
+/**
+ * Write the hand-over of mutexes and semaphores to a task into the binary trace. One entry
+ * is written per synchronization object. Its argument holds the index of the receiving
+ * task in the high byte and the index of the event, which implements the object, in the
+ * low byte.
+ *   @param pT
+ * The task, which gets the mutexes and semaphores.
+ *   @param syncObjVec
+ * The vector of events of the mutexes and semaphores.
+ */
+
+static void traceSyncObjHandOver(const task_t * const pT, uintEventVec_t syncObjVec)
+{
+    const uint16_t idxTaskHByte = (uint16_t)getIdxTask(pT) << 8;
+    uint8_t idxEvt = 0;
+    while(syncObjVec != 0)
+    {
+        if((syncObjVec & RTOS_EVT_LSB) != 0)
+            KERNEL_TRACE(TRC_ID_SYNC_OBJ_HAND_OVER, idxTaskHByte | idxEvt);
+
+        syncObjVec >>= 1;
+        ++ idxEvt;
+    }
+} /* End of traceSyncObjHandOver */
+#endif
+
+
+
+
+/**
+ * Post a set of events to all suspended tasks, which wait for them. This is the common
+ * part of \a rtos_sendEvent and \a rtos_sendEventFromISR; it doesn't decide, which task
+ * is active.
+ *   @return
+ * Get true if at least one task has been made due. Only then the active task may change
+ * and it's worth looking for the new active task.
+ *   @param postedEventVec
+ * See software interrupt \a rtos_sendEvent.
+ *   @remark
+ * This function must be called only if all interrupts are disabled.
+ */
+
+static boolean postEvent(uintEventVec_t postedEventVec)
+{
+    boolean activeTaskMayChange = false;
+    
+    /* The timer events must not be set manually. */
+    ASSERT((postedEventVec & MASK_EVT_IS_TIMER) == 0);
+
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    /* The function is executed on the stack of the posting task or of the interrupted
+       task. */
+    sampleStackPointer();
+#endif
+
+    /* The trace entry holds the lower 16 bits of the posted events. */
+    KERNEL_TRACE(TRC_ID_SEND_EVENT, postedEventVec);
+
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+    /* An application interrupt may have woken up the CPU. */
+    endIdleSleep();
+#endif
+
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+    /* An event may resume a task, which needs the correct system time and the normal
+       system timer tics. */
+    if(_isTicklessPeriod)
+        leaveTicklessPeriod(/* isTicIsr */ false);
+#endif
+
+    /* We keep track of all semaphores and mutexes, which have to be posted (released)
+       exactly once - to the first task, which is waiting for them. This task is done,
+       when the related mask, semaphoreToReleaseVec or mutexToReleaseVec becomes null. */
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+    uintEventVec_t semaphoreToReleaseVec = postedEventVec & MASK_EVT_IS_SEMAPHORE;
+#endif
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    uintEventVec_t mutexToReleaseVec = postedEventVec & MASK_EVT_IS_MUTEX;
+# if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    /* The releasing task loses the priority it has inherited from the tasks, which wait
+       for the released mutexes. It may still keep a raised priority because of other
+       mutexes it owns. This is done before the mutexes are handed over to the waiting
+       tasks, while their current owners are still known. */
+    const boolean isPrioRestored = mutexToReleaseVec != 0
+                                   &&  restoreInheritedPrioClasses(mutexToReleaseVec);
+# endif
+# ifdef DEBUG
+    uintEventVec_t dbg_allMutexesToReleaseVec = mutexToReleaseVec;
+# endif
+#endif
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON  ||  RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+    /* The implementation makes a distinction between synchronization objects (mutex and
+       semaphores) and ordinary, broadcasted events. */
+    postedEventVec &= ~(MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE);
+#endif
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+    /* Only the tasks, which wait for at least one of the posted events, are visited. The
+       events are distributed first and the touched tasks are checked for activation only
+       afterwards; a task, which waits for several of the posted events, needs to receive
+       all of them before it is (possibly) taken out of the lists of waiting tasks. */
+    uint8_t noTouchedTasks = 0
+          , idxEvt
+          , u;
+    uintEventVec_t evtMask;
+    for(idxEvt=0, evtMask=RTOS_EVT_LSB; idxEvt<NO_INDEXED_EVENTS; ++idxEvt, evtMask<<=1)
+    {
+        uint8_t * const pList = &_idxWaitingTaskAryAry[idxEvt][0];
+        const uint8_t noWaitingTasks = _noWaitingTasksAry[idxEvt];
+        uint8_t idxWaitingTask = 0
+              , noReceivers;
+
+        /* Ordinary events are broadcasted to all waiting tasks, a mutex or semaphore is
+           given to the first waiting task only, which doesn't own it yet. */
+        if((postedEventVec & evtMask) != 0)
+            noReceivers = noWaitingTasks;
+# if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+        else if((semaphoreToReleaseVec & evtMask) != 0  &&  noWaitingTasks > 0)
+        {
+            /* The list of a semaphore only holds tasks, which didn't get it yet. The head
+               of the list is the task of highest priority, which waits the longest. It
+               gets the semaphore without any search, see below. */
+            noReceivers = 1;
+            semaphoreToReleaseVec &= ~evtMask;
+        }
+# endif
+# if RTOS_USE_MUTEX == RTOS_FEATURE_ON
+        else if((mutexToReleaseVec & evtMask) != 0  &&  noWaitingTasks > 0)
+        {
+            /* Mutexes are Boolean and can't be posted twice to a task. This is easily
+               possible but an application error. This assertion fires if the application
+               doesn't properly keep track of who owns which mutex. */
+            ASSERT((_taskAry[pList[0]].task.postedEventVec & evtMask) == 0);
+            noReceivers = 1;
+            mutexToReleaseVec &= ~evtMask;
+#  if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+            _pMutexOwnerAry[idxEvt-RTOS_NO_SEMAPHORE_EVENTS] = &_taskAry[pList[0]].task;
+#  endif
+        }
+# endif
+        else
+            noReceivers = 0;
+
+        for(; noReceivers>0; --noReceivers, ++idxWaitingTask)
+        {
+            task_t * const pT = &_taskAry[pList[idxWaitingTask]].task;
+
+            /* Record the task for the check for activation below. */
+            for(u=0; u<noTouchedTasks; ++u)
+                if(_pTouchedTaskAry[u] == pT)
+                    break;
+            if(u == noTouchedTasks)
+                _pTouchedTaskAry[noTouchedTasks++] = pT;
+
+            pT->postedEventVec |= evtMask;
+# if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON \
+     &&  (RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON)
+            if((postedEventVec & evtMask) == 0)
+                KERNEL_TRACE(TRC_ID_SYNC_OBJ_HAND_OVER, ((uint16_t)getIdxTask(pT) << 8) | idxEvt);
+# endif
+        }
+
+# if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+        /* A task, which got a semaphore, doesn't wait for it any longer. It leaves the
+           list of the semaphore. (idxWaitingTask is the number of receivers here.) */
+        if((evtMask & MASK_EVT_IS_SEMAPHORE) != 0  &&  idxWaitingTask > 0)
+        {
+            const uint8_t noStillWaitingTasks = -- _noWaitingTasksAry[idxEvt];
+            for(u=0; u<noStillWaitingTasks; ++u)
+                pList[u] = pList[u+1];
+        }
+# endif
+    } /* End for(All events, which have a list of waiting tasks) */
+
+    /* Check if the suspended tasks, which got an event, become due. */
+    for(u=0; u<noTouchedTasks; ++u)
+    {
+        task_t * const pT = _pTouchedTaskAry[u];
+        if(checkTaskForActivation(pT))
+        {
+            /* The task becomes due. */
+            activeTaskMayChange = true;
+
+# if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+            /* The task has been resumed by an event, not by its timer. A pending timeout
+               is cancelled. */
+            if((pT->eventMask & MASK_EVT_IS_TIMER) != 0)
+                unlinkTimeout(pT);
+# endif
+        }
+    }
+#else
+    /* Post ordinary events to all suspended tasks which are waiting for it.
+         Pass mutexes and semaphores to a single task each, those task, which is of highest
+       priority and waits the longest for it. This loop is the reason, why we need to have
+       the list of suspended tasks always sorted. */
+    task_t *pNextT = _pFirstSuspendedTask;
+    while(pNextT != NULL)
+    {
+        task_t * const pT = pNextT;
+
+        /* Get the successor before the task (possibly) leaves the list. */
+        pNextT = pT->pNextSuspendedTask;
+        
+        /* Remember the received events before (possibly) getting some more by this
+           sendEvent: Only if this set changes it is necessary to check for a state
+           transition of the task. */
+        const uintEventVec_t postedEventVecBefore = pT->postedEventVec;
+
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
+        /* Mutexes are Boolean and can't be posted twice to a task. This is easily possible
+           but an application error. This assertion fires if the application doesn't
+           properly keep track of who owns which mutex. */
+        ASSERT((pT->postedEventVec & dbg_allMutexesToReleaseVec) == 0);
+
+        /* The vector of all events this task will receive. */
+        uintEventVec_t gotEvtVec = (postedEventVec | mutexToReleaseVec) & pT->eventMask;
+
+        /* Collect the events in the task object. */
+        pT->postedEventVec |= gotEvtVec;
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+        setMutexOwner(gotEvtVec & MASK_EVT_IS_MUTEX, pT);
+#endif
+
+        /* Subtract the given mutexes from the vector of all, which are to release in this
+           call. It doesn't matter that the mask also contains ordinary events - all these
+           bits can do is to reset already reset bits. */
+        mutexToReleaseVec &= ~gotEvtVec;
+#else
+        pT->postedEventVec |= (postedEventVec & pT->eventMask);
+
+#endif /* RTOS_USE_MUTEX == RTOS_FEATURE_ON */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+        /* Now pass all released semaphores to the task if it is waiting for them but
+           didn't get them yet (i.e. in an earlier call of this routine). Each released
+           semaphore is passed to a single task only; this is the first one in the sorted
+           list, which waits for it. All semaphores are handled at once by bit
+           operations. */
+        const uintEventVec_t gotSemVec = semaphoreToReleaseVec
+                                         & pT->eventMask
+                                         & ~pT->postedEventVec;
+        pT->postedEventVec    |= gotSemVec;
+        semaphoreToReleaseVec &= ~gotSemVec;
+#endif
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON  \
+    &&  (RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON)
+        traceSyncObjHandOver( pT
+                            , (pT->postedEventVec ^ postedEventVecBefore)
+                              & (MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE)
+                            );
+#endif
+
+        /* Check if this suspended task becomes due because of an event, which was posted
+           to it. */
+        if(postedEventVecBefore != pT->postedEventVec  && checkTaskForActivation(pT))
+        {
+            /* The task becomes due. */
+            activeTaskMayChange = true;
+
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+            /* The task has been resumed by an event, not by its timer. A pending timeout
+               is cancelled. */
+            if((pT->eventMask & MASK_EVT_IS_TIMER) != 0)
+                unlinkTimeout(pT);
+#endif
+        }
+
+    } /* End while(All suspended tasks) */
+#endif /* RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+    /* The remaining semaphores (more precise: semaphore counter values) are accumulated in
+       the global semaphore storage for later acquisition. */
+    uint8_t idxSem = 0;
+    while(semaphoreToReleaseVec)
+    {
+        if((semaphoreToReleaseVec & RTOS_EVT_LSB) != 0)
+        {
+            ++ rtos_semaphoreAry[idxSem];
+
+            /* The assertion validates the application code. It fires if the application
+               releases/produces more semaphore counter values as fit into the data type of
+               the semphore. This is harmless with respect to the stability of the RTOS but
+               probably a design error in the application. */
+            ASSERT(rtos_semaphoreAry[idxSem] != 0);
+        }
+
+        /* Test next semaphore in next cycle. */
+        semaphoreToReleaseVec >>= 1;
+
+        /* The next event/semaphore bit is related to the next array entry. */
+        ++ idxSem;
+    }
+#endif
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    /* The remaining mutexes are returned to the global storage for later acquisition.
+         The assertion validates application code. It fires if the application releases
+       a mutex, which was not acquired. This is harmless with respect to the stability of
+       the RTOS but probably a design error in the application. Maybe, you have to
+       consider using a semaphore. */
+    ASSERT((_mutexVec & dbg_allMutexesToReleaseVec) == 0);
+    _mutexVec |= mutexToReleaseVec;
+
+# if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    if(isPrioRestored)
+        activeTaskMayChange = true;
+# endif
+#endif /* RTOS_USE_MUTEX == RTOS_FEATURE_ON */
+
+
+    return activeTaskMayChange;
+
+} /* End of postEvent */
+
+
+
+
+/**
+ * Actual implementation of routine \a rtos_sendEvent. The task posts a set of events and the
+ * scheduler is asked which task is the one to be activated now.\n
+ *   The action of this SW interrupt is placed into an own function in order to let the
+ * compiler generate the stack frame required for all local data. (The stack frame
+ * generation of the SW interrupt entry point needs to be inhibited in order to permit the
+ * implementation of saving/restoring the task context).
+ *   @return
+ * The function determines which task is to be activated and records which task is left
+ * (i.e. the task calling this routine) in the global variables _pActiveTask and
+ * _pSuspendedTask.\n
+ *   If there is a task switch the function reports this by a return value true. If there
+ * is no task switch it returns false and the global variables _pActiveTask and
+ * _pSuspendedTask are not touched.
+ *   @param postedEventVec
+ * See software interrupt \a rtos_sendEvent.
+ *   @see
+ * void rtos_sendEvent(uintEventVec_t)
+ *   @remark
+ * This function and particularly passing the return codes via a global variable will
+ * operate only if all interrupts are disabled.
+ */
+
+static RTOS_TRUE_FCT boolean sendEvent(uintEventVec_t postedEventVec)
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    /* Check if another task becomes active because of the posted events.
+         We do the search for the new active task only if at least one suspended task was
+       resumed.
+         The function has side effects: If there's a task which was suspended before and
+       which is resumed because of an event and which is of higher priority than the one
+       being active so far, the refernces to the old and newly active task are written into
+       global variables _pSuspendedTask and _pActiveTask. */
+    return (postEvent(postedEventVec)  ||  IS_RESCHEDULE_PENDING())  &&  lookForActiveTask();
+
+} /* End of sendEvent */
+
+
+
+
+#if RTOS_USE_NESTED_INTERRUPTS == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+/**
+ * Call sendEvent with open interrupts. See onTimerTicNested for details.
+ *   @return
+ * Get the return value of sendEvent, whether the active task changes.
+ *   @param postedEventVec
+ * See software interrupt \a rtos_sendEvent.
+ *   @remark
+ * The function is called from the naked function rtos_sendEvent and from the naked
+ * application ISRs, which jump into rtos_sendEvent. They load the parameter register(s)
+ * with the posted events; the signature of this function needs to be the same as of \a
+ * sendEvent.
+ */
+
+static RTOS_TRUE_FCT boolean sendEventNested(uintEventVec_t postedEventVec)
+{
+    RTOS_MASK_KERNEL_INTERRUPTS();
+    sei();
+
+    const boolean isTaskSwitch = sendEvent(postedEventVec);
+
+    cli();
+    RTOS_UNMASK_KERNEL_INTERRUPTS();
+    return isTaskSwitch;
+
+} /* End of sendEventNested */
+#endif
+
+
+
+
+
+#if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+/**
+ * A conditionally compiled interrupt function. If #RTOS_USE_APPL_INTERRUPT_00 is set to
+ * #RTOS_FEATURE_ON, this function implements an interrupt service routine, which posts
+ * event #RTOS_EVT_ISR_USER_00 every time the interrupt occurs.\n
+ *   The use case is to have a task (of high priority) which implements an infinite loop.
+ * At the beginning of each loop cycle the task will suspend itself waiting for this event
+ * (or maybe a timeout). The body of the loop will then handle the interrupt.\n
+ *   In the AVR environment, an ISR can't be compiled independently of the actual interrupt
+ * source it might be connected to. Therefore, to make this code compilable, the name of
+ * the interrupt vector to be used has to be specified. Please set #RTOS_ISR_USER_00 to the
+ * desired vector's name, like TIMER3_COMPA_vect. The supported vector names can be derived
+ * from table 14-1 on page 105 in the CPU manual, doc2549.pdf (see http://www.atmel.com)\n
+ *   CAUTION: There's only one ISR for each interrupt source. If you'd e.g. use
+ * TIMER0_OVF_vect, you'd disable the time measurement routines of Arduino. Functions like
+ * \a millis() or \a delay() would no longer work. Due to their global sphere of influence
+ * interrupts must be chosen very carefully.
+ *   @remark
+ * The implementation of this ISR makes use of the code of the task called routine \a
+ * rtos_sendEvent. Both routines need to be maintained in strict accordance.
+ *   @see
+ * void rtos_sendEvent(uintEventVec_t)
+ */
+
+ISR(RTOS_ISR_USER_00, ISR_NAKED)
+{
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the interrupted
+       active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
+       interrupted code. To make the local code here running, we need to anticipate this
+       situation and clear the register. */
+    asm volatile
+    ("clr __zero_reg__ \n\t"
+    );
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+    /* The complete context is saved; a function may be called. */
+    onApplInterruptEntry(/* idxInterrupt */ 0);
+#endif
+
+    /* The implementation of this ISR makes use of the code of the task called routine
+       rtos_sendEvent. (Both routines need to be maintained in strict accordance.) That
+       function is executed with a constant parameter (r24/25) - the event mask just
+       containing the event which is posted by this interrupt. */
+#if RTOS_EVENT_VECTOR_BITS == 16
+    asm volatile
+    ( "ldi r24,lo8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "ldi r25,hi8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "rjmp LabelEntrySetEventForISR \n\t"
+    );
+#else
+    /* A 32 Bit event vector is passed in r22..r25. */
+    asm volatile
+    ( "ldi r22,lo8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "ldi r23,hi8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "ldi r24,hlo8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "ldi r25,hhi8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
+      "rjmp LabelEntrySetEventForISR \n\t"
+    );
+#endif
+} /* End of ISR(RTOS_ISR_USER_00) */
+
+#endif /* RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
+/**
+ * A conditionally compiled interrupt function. If #RTOS_USE_APPL_INTERRUPT_01 is set to
+ * #RTOS_FEATURE_ON, this function implements an interrupt service routine, which posts
+ * event #RTOS_EVT_ISR_USER_01 every time the interrupt occurs.\n
+ *   See documentation of ISR for application interrupt 0 for more details.
+ */
+
+ISR(RTOS_ISR_USER_01, ISR_NAKED)
+{
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the interrupted
+       active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
+       interrupted code. To make the local code here running, we need to anticipate this
+       situation and clear the register. */
+    asm volatile
+    ("clr __zero_reg__ \n\t"
+    );
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+    /* The complete context is saved; a function may be called. */
+    onApplInterruptEntry(/* idxInterrupt */ 1);
+#endif
+
+    /* The implementation of this ISR makes use of the code of the task called routine
+       rtos_sendEvent. (Both routines need to be maintained in strict accordance.) That
+       function is executed with a constant parameter (r24/25) - the event mask just
+       containing the event which is posted by this interrupt. */
+#if RTOS_EVENT_VECTOR_BITS == 16
+    asm volatile
+    ( "ldi r24,lo8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "ldi r25,hi8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "rjmp LabelEntrySetEventForISR \n\t"
+    );
+#else
+    /* A 32 Bit event vector is passed in r22..r25. */
+    asm volatile
+    ( "ldi r22,lo8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "ldi r23,hi8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "ldi r24,hlo8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "ldi r25,hhi8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
+      "rjmp LabelEntrySetEventForISR \n\t"
+    );
+#endif
+} /* End of ISR(RTOS_ISR_USER_01) */
+
+#endif /* RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON */
+
+
+
+
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+/**
+ * The common code of all application interrupts from table #RTOS_APPL_INTERRUPT_TABLE.
+ * The interrupt service routine of an application interrupt has stored its index in \a
+ * _tmpVarIdxApplInterrupt and jumps here, without having altered any register. This
+ * code saves the context of the interrupted task, fetches the events to post from table
+ * \a _applInterruptEventVecAry and continues with the code of \a rtos_sendEvent.\n
+ *   The function is never called; it is entered by jump to the label
+ * LabelEntryApplInterrupt.
+ *   @see void rtos_sendEvent(uintEventVec_t)
+ *   @remark
+ * The implementation of this function makes use of the code of the task called routine \a
+ * rtos_sendEvent. Both routines need to be maintained in strict accordance.
+ */
+
+RTOS_NAKED_FCT void applInterruptTail(void)
+{
+    asm volatile
+    ( "LabelEntryApplInterrupt: \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       the interrupt). Save rest of context onto the stack of the interrupted active
+       task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
+       interrupted code. To make the local code here running, we need to anticipate this
+       situation and clear the register. */
+    asm volatile
+    ("clr __zero_reg__ \n\t"
+    );
+
+    /* Load the event vector of the interrupt into the parameter registers of
+       rtos_sendEvent, r24/25 or r22..r25 with a 32 Bit event vector, and jump into that
+       function. The Z register pair has already been saved. */
+    asm volatile
+    ( "lds r30, _tmpVarIdxApplInterrupt \n\t"
+      "clr r31 \n\t"
+      "lsl r30 \n\t"
+      "rol r31 \n\t"
+#if RTOS_EVENT_VECTOR_BITS == 32
+      "lsl r30 \n\t"
+      "rol r31 \n\t"
+#endif
+      "subi r30, lo8(-(_applInterruptEventVecAry)) \n\t"
+      "sbci r31, hi8(-(_applInterruptEventVecAry)) \n\t"
+#if RTOS_EVENT_VECTOR_BITS == 32
+      "lpm r22, Z+ \n\t"
+      "lpm r23, Z+ \n\t"
+#endif
+      "lpm r24, Z+ \n\t"
+      "lpm r25, Z \n\t"
+      "rjmp LabelEntrySetEventForISR \n\t"
+    );
+} /* End of applInterruptTail */
+
+
+
+
+/** The interrupt service routine for one row of the table #RTOS_APPL_INTERRUPT_TABLE. It
+    only stores the index of the interrupt and jumps to the common code, \a
+    applInterruptTail. The stored register and SREG stay untouched, so that the common code
+    can save the complete context of the interrupted task. */
+# define DEFINE_APPL_INTERRUPT(vector, eventVec, enableIRQ)                     \
+ISR(vector, ISR_NAKED)                                                          \
+{                                                                               \
+    asm volatile                                                                \
+    ( "push r24 \n\t"                                                           \
+      "ldi r24, %0 \n\t"                                                        \
+      "sts _tmpVarIdxApplInterrupt, r24 \n\t"                                   \
+      "pop r24 \n\t"                                                            \
+      "rjmp LabelEntryApplInterrupt \n\t"                                       \
+      :: "M" (idxApplInterrupt_##vector)                                        \
+    );                                                                          \
+}
+
+/* Generate the interrupt service routines of all configured application interrupts. */
+RTOS_APPL_INTERRUPT_TABLE(DEFINE_APPL_INTERRUPT)
+
+#endif /* RTOS_APPL_INTERRUPT_TABLE */
+
+
+
+
+/**
+ * A task (including the idle task) may post an event. The event is broadcasted to all
+ * suspended tasks which are waiting for it. An event is not saved beyond that. If a task
+ * suspends and starts waiting for an event which has been posted by another task just
+ * before, it'll wait forever and never be resumed.\n
+ *   The posted event may resume another task, which may be of higher priority as the
+ * event posting task. In this case \a sendEvent will cause a task switch. The calling task
+ * stays due but stops to be the active task. It does not become suspended (this is why
+ * even the idle task may call this function). The activated task will resume by coming out
+ * of the suspend command it had been invoked to wait for this event. The return value of
+ * this suspend command will then tell about the event set here.\n
+ *   If no task of higher priority is resumed by the posted event the calling task will be
+ * continued immediately after execution of this method. In this case \a sendEvent behaves
+ * like any ordinary sub-routine.
+ *   @param eventVec
+ * A bit vector of posted events. Known events are defined in rtos.h. The timer events
+ * RTOS_EVT_ABSOLUTE_TIMER and RTOS_EVT_DELAY_TIMER cannot be posted.
+ *   @see
+ * uintEventVec_t rtos_waitForEvent(uintEventVec_t, boolean, uintTime_t)
+ *   @remark
+ * It is absolutely essential that this routine is implemented as naked and noinline. See
+ * http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html for details
+ *   @remark
+ * In optimization level 0 GCC has a problem with code generation for naked functions. See
+ * function #rtos_suspendTaskTillTime for details.
+ *   @remark
+ * The implementation of this function is reused on machine code level by the
+ * implementation of the application interrupt service routines \a ISR(RTOS_ISR_USER_nn).
+ * This function needs to be maintained in strict accordance with the implementation of the
+ * ISRs.
+ */
+#ifndef __OPTIMIZE__
+# error This code must not be compiled with optimization off. See source code comments for more
+#endif
+
+RTOS_NAKED_FCT void rtos_sendEvent(uintEventVec_t eventVec)
+{
+#ifdef RTOS_HOST_SIMULATION
+    /* The host simulation saves the context only if the task is left. The calling task
+       continues here when it becomes active again. */
+    cli();
+    if(sendEvent(eventVec))
+        switchContext();
+    sei();
+#else
+    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
+       interrupt enable flag, we inhibit any interrupts now. */
+    asm volatile
+    ( "cli \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the interrupted
+       active task. sendEvent does not return anything; we push register pair r24/25 and
+       this will be restored on function exit. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* The next assembler statement has no direct impact but permits to jump on machine
+       code level into the middle of this function. The application ISRs make use of this:
+       They push the interrupted context, load the parameter register pair r24/25 with the
+       event they are assigned to and jump here to reuse the code for posting an event and
+       probably initiate a task switch. */
+    asm volatile
+    ( "LabelEntrySetEventForISR: \n\t"
+    );
+
+    /* Check for all suspended tasks if the posted events will resume them.
+         The actual implementation of the function's logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). */
+    if(CALL_SEND_EVENT(eventVec))
+    {
+        /* Yes, another task becomes active because of the posted events. Switch the stack
+           pointer to the (saved) stack pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The stack pointer points to the now active task (which will often be still the same
+       as at function entry). The CPU context to continue with is popped from this stack. If
+       there's no change in active task the entire routine call is just like any ordinary
+       interrupt. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of rtos_sendEvent */
+
+
+
+
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/**
+ * Determine the new active task, after an interrupt has made a task due. The function is
+ * placed into an own sub-routine in order to let the compiler generate the stack frame
+ * for the naked function \a rtos_yield.
+ *   @return
+ * Get true if another task becomes the active task. The global variables _pActiveTask and
+ * _pSuspendedTask have been updated in this case. See \a lookForActiveTask.
+ */
+
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnYield(void)
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    return lookForActiveTask();
+
+} /* End of lookForActiveTaskOnYield */
+
+
+
+
+/**
+ * Give a task of higher priority the chance to become active. In cooperative mode, the
+ * interrupts, including the system timer tic, make tasks due but they don't switch the
+ * task. The active task continues until it calls a kernel function, which can switch the
+ * task, e.g. rtos_waitForEvent, rtos_sendEvent or this function.\n
+ *   If no interrupt has made a task due since the last decision about the active task,
+ * then the function returns at once; there's no context save at all. Otherwise, the
+ * calling task is left if a due task of higher priority exists. It stays due and
+ * continues when it becomes the active task again.\n
+ *   A task, which does a long computation, should call the function now and then. The
+ * kernel calls it after each return from loop(); the idle task doesn't need to do so.
+ *   @remark
+ * The function must be called from a task or from the idle task, never from an interrupt
+ * service routine. It globally enables the interrupts.
+ *   @remark
+ * It is absolutely essential that this routine is implemented as naked and noinline. See
+ * rtos_sendEvent for details.
+ */
+
+RTOS_NAKED_FCT void rtos_yield(void)
+{
+#ifdef RTOS_HOST_SIMULATION
+    cli();
+    if(_isReschedulePending  &&  lookForActiveTaskOnYield())
+        switchContext();
+    sei();
+#else
+    /* Fast path: No task has been made due, we return to the calling task. Being called
+       like a normal sub-routine, this code may alter the call clobbered registers and the
+       status register. */
+    if(!_isReschedulePending)
+    {
+        asm volatile
+        ( "ret \n\t"
+        );
+    }
+
+    /* This function is a pseudo-software interrupt. We inhibit any interrupts now. */
+    asm volatile
+    ( "cli \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* The actual implementation of the function's logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). */
+    if(lookForActiveTaskOnYield())
+    {
+        /* A task of higher priority has been made due. Switch the stack pointer to the
+           (saved) stack pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The stack pointer points to the now active task. The CPU context to continue with is
+       popped from this stack. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of rtos_yield */
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+/**
+ * Post a set of events from an application interrupt service routine. Other than \a
+ * rtos_sendEvent, the function doesn't save the context of the interrupted task and it
+ * never switches to another task. It only updates the state of the suspended tasks. If a
+ * task has been made due, which may be of higher priority than the interrupted one, then
+ * the decision about the active task is deferred till the call of \a rtos_leaveISR at the
+ * end of the interrupt service routine.\n
+ *   The function can be called several times in one interrupt service routine, the
+ * related task switch will still happen at most once.
+ *   @param eventVec
+ * A bit vector of posted events. Known events are defined in rtos.h. The timer events
+ * RTOS_EVT_ABSOLUTE_TIMER and RTOS_EVT_DELAY_TIMER cannot be posted.
+ *   @see
+ * void rtos_leaveISR(void)
+ *   @remark
+ * The function must be called only from an interrupt service routine and with the global
+ * interrupt enable flag reset. Like the RTuinOS ISRs, the interrupt must be inhibited by
+ * rtos_enterCriticalSection; otherwise the kernel data could be corrupted.
+ */
+
+void rtos_sendEventFromISR(uintEventVec_t eventVec)
+{
+    if(postEvent(eventVec))
+        _isReschedulePending = true;
+
+} /* End of rtos_sendEventFromISR */
+
+
+
+
+/**
+ * Determine the new active task after one or more calls of \a rtos_sendEventFromISR. The
+ * function is placed into an own sub-routine in order to let the compiler generate the
+ * stack frame for the naked function \a rtos_leaveISR.
+ *   @return
+ * Get true if another task becomes the active task. The global variables _pActiveTask and
+ * _pSuspendedTask have been updated in this case. See \a lookForActiveTask.
+ */
+
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnLeaveISR(void)
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    return lookForActiveTask();
+
+} /* End of lookForActiveTaskOnLeaveISR */
+
+
+
+
+/**
+ * Complete the posting of events from an application interrupt service routine. The
+ * function needs to be called once as last statement of an interrupt service routine,
+ * which has called \a rtos_sendEventFromISR.\n
+ *   If none of the posted events has made a task due, then the function returns at once
+ * and the interrupt service routine ends like any ordinary one. This is the fast path;
+ * there's no context save at all. Otherwise, the context of the interrupted task is saved
+ * and the kernel decides, which task is the active task. If this is another task, then the
+ * interrupted task is left inside of the interrupt service routine. It'll complete the
+ * epilogue of the service routine as soon as it becomes the active task again.
+ *   @see
+ * void rtos_sendEventFromISR(uintEventVec_t)
+ *   @remark
+ * If the call of this function is forgotten, then the due task is not activated before
+ * the next system timer tic.
+ *   @remark
+ * If #RTOS_USE_COOPERATIVE_SCHEDULING is set, then the function returns at once. The due
+ * task is activated at the next kernel call of the interrupted task.
+ *   @remark
+ * If the context is saved, then the function returns with reti. The remaining epilogue of
+ * the interrupt service routine is executed with the global interrupt enable flag set.
+ *   @remark
+ * It is absolutely essential that this routine is implemented as naked and noinline. See
+ * http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html for details
+ */
+
+RTOS_NAKED_FCT void rtos_leaveISR(void)
+{
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    /* In cooperative mode, an interrupt never switches the task. The pending decision
+       about the active task is taken at the next kernel call of the active task. */
+# ifndef RTOS_HOST_SIMULATION
+    asm volatile
+    ( "ret \n\t"
+    );
+# endif
+#elif defined(RTOS_HOST_SIMULATION)
+    if(_isReschedulePending  &&  lookForActiveTaskOnLeaveISR())
+        switchContext();
+#else
+    /* Fast path: No task has been made due, we return to the interrupt service routine.
+       Being a normal sub-routine of the service routine, this code may alter the call
+       clobbered registers and the status register. */
+    if(!_isReschedulePending)
+    {
+        asm volatile
+        ( "ret \n\t"
+        );
+    }
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the interrupted
+       active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* The actual implementation of the function's logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). */
+    if(lookForActiveTaskOnLeaveISR())
+    {
+        /* Yes, another task becomes active because of the posted events. Switch the stack
+           pointer to the (saved) stack pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The stack pointer points to the now active task. The CPU context to continue with is
+       popped from this stack. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON */
+
+} /* End of rtos_leaveISR */
+#endif /* RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+/**
+ * Post a set of notifications to a single task. This is the common part of \a
+ * rtos_notifyTask and \a rtos_notifyTaskFromISR; it doesn't decide, which task is active.\n
+ *   Other than \a postEvent, the function doesn't visit the suspended tasks. It only
+ * touches the notified task and, if this task is now resumed, the due list of its
+ * priority class.
+ *   @return
+ * Get true if the notified task has been made due. Only then the active task may change
+ * and it's worth looking for the new active task.
+ *   @param idxTask
+ * The index of the notified task.
+ *   @param notificationVec
+ * See \a rtos_notifyTask.
+ *   @remark
+ * This function must be called only if all interrupts are disabled.
+ */
+
+static boolean postNotification(uint8_t idxTask, uintNotificationVec_t notificationVec)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS);
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    /* The notifications are latched until the task takes them. */
+    pT->notificationVec |= notificationVec;
+
+    /* The mask is not zero only while the task is suspended in rtos_waitForNotification. */
+    if((pT->notificationVec & pT->notificationMask) == 0)
+        return false;
+
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    sampleStackPointer();
+#endif
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+    /* An application interrupt may have woken up the CPU. */
+    endIdleSleep();
+#endif
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+    /* The resumed task needs the correct system time and the normal system timer tics. */
+    if(_isTicklessPeriod)
+        leaveTicklessPeriod(/* isTicIsr */ false);
+#endif
+
+    /* The task waits for its timeout only. A resumed task needs a non empty vector of
+       posted events, which is returned by its suspend command, see
+       PUSH_RET_CODE_OF_CONTEXT_SWITCH. The timer event is used for this purpose; the
+       notification wait evaluates the notifications, not the events. */
+    pT->postedEventVec |= pT->eventMask & MASK_EVT_IS_TIMER;
+#ifdef DEBUG
+    ASSERT(checkTaskForActivation(pT));
+#else
+    checkTaskForActivation(pT);
+#endif
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+    /* The task has been resumed by a notification, the timeout is cancelled. */
+    unlinkTimeout(pT);
+#endif
+
+    return true;
+
+} /* End of postNotification */
+
+
+
+
+/**
+ * Actual implementation of \a rtos_notifyTask. The function is placed into an own
+ * sub-routine in order to let the compiler generate the stack frame for the naked
+ * function \a rtos_notifyTask.
+ *   @return
+ * Get true if another task becomes the active task. The global variables _pActiveTask and
+ * _pSuspendedTask have been updated in this case. See \a lookForActiveTask.
+ *   @param idxTask
+ * See \a rtos_notifyTask.
+ *   @param notificationVec
+ * See \a rtos_notifyTask.
+ *   @remark
+ * This function will operate only if all interrupts are disabled.
+ */
+
+static RTOS_TRUE_FCT boolean notifyTask(uint8_t idxTask, uintNotificationVec_t notificationVec)
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    return (postNotification(idxTask, notificationVec)  ||  IS_RESCHEDULE_PENDING())
+           &&  lookForActiveTask();
+
+} /* End of notifyTask */
+
+
+
+
+/**
+ * A task (including the idle task) may post a set of notifications to another task. The
+ * notifications are latched in the notified task until it takes them with \a
+ * rtos_waitForNotification. If the task is currently suspended in this function and
+ * waits for at least one of the notifications, then it becomes due.\n
+ *   Unlike rtos_sendEvent, no global event is required and no other task is inspected.
+ * This is the cheapest way to resume a single, known task, e.g. a consumer task, which
+ * is served by a single producer.\n
+ *   If the notified task is of higher priority than the calling task, then the function
+ * will cause a task switch. The calling task stays due and continues when it becomes the
+ * active task again; like rtos_sendEvent, the function can be called from the idle task.
+ *   @param idxTask
+ * The index of the notified task. The idle task can't be notified.
+ *   @param notificationVec
+ * The set of posted notifications. The meaning of the bits is defined by the application
+ * for each task individually.
+ *   @see
+ * uintNotificationVec_t rtos_waitForNotification(uintNotificationVec_t, uintTime_t)
+ *   @remark
+ * It is absolutely essential that this routine is implemented as naked and noinline. See
+ * rtos_sendEvent for details.
+ */
+
+RTOS_NAKED_FCT void rtos_notifyTask(uint8_t idxTask, uintNotificationVec_t notificationVec)
+{
+#ifdef RTOS_HOST_SIMULATION
+    cli();
+    if(notifyTask(idxTask, notificationVec))
+        switchContext();
+    sei();
+#else
+    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
+       interrupt enable flag, we inhibit any interrupts now. */
+    asm volatile
+    ( "cli \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* The actual implementation of the function's logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). */
+    if(notifyTask(idxTask, notificationVec))
+    {
+        /* The notified task becomes active. Switch the stack pointer to the (saved) stack
+           pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The stack pointer points to the now active task. The CPU context to continue with is
+       popped from this stack. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of rtos_notifyTask */
+
+
+
+
+# if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+/**
+ * Post a set of notifications to a single task from an application interrupt service
+ * routine. The function relates to rtos_notifyTask like rtos_sendEventFromISR relates to
+ * rtos_sendEvent: It never switches the task, a required task switch is done by \a
+ * rtos_leaveISR at the end of the interrupt service routine.
+ *   @param idxTask
+ * See \a rtos_notifyTask.
+ *   @param notificationVec
+ * See \a rtos_notifyTask.
+ *   @see
+ * void rtos_leaveISR(void)
+ *   @remark
+ * The function must be called only from an interrupt service routine and with the global
+ * interrupt enable flag reset. Like the RTuinOS ISRs, the interrupt must be inhibited by
+ * rtos_enterCriticalSection; otherwise the kernel data could be corrupted.
+ */
+
+void rtos_notifyTaskFromISR(uint8_t idxTask, uintNotificationVec_t notificationVec)
+{
+    if(postNotification(idxTask, notificationVec))
+        _isReschedulePending = true;
+
+} /* End of rtos_notifyTaskFromISR */
+# endif /* RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON */
+#endif /* RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+/**
+ * Determine the new active task after a change of the due lists by  rtos_setTaskPriority,
+ *  rtos_suspendTask or  rtos_resumeTask. The function is placed into an own
+ * sub-routine in order to let the compiler generate the stack frame for the naked
+ * function  reschedule.
+ *   @return
+ * Get true if another task becomes the active task. The global variables _pActiveTask and
+ * _pSuspendedTask have been updated in this case. See  lookForActiveTask.
+ */
+
+static RTOS_TRUE_FCT boolean lookForActiveTaskOnReschedule(void)
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    return lookForActiveTask();
+
+} /* End of lookForActiveTaskOnReschedule */
+
+
+
+
+/**
+ * Switch to the task, which is the active task after a change of the due lists. The
+ * calling task stays due and continues when it becomes the active task again - unless it
+ * has just parked itself.
+ *   @remark
+ * The function needs to be called with the global interrupt enable flag reset. It returns
+ * with reti, the interrupts are enabled on return.
+ *   @remark
+ * It is absolutely essential that this routine is implemented as naked and noinline. See
+ * rtos_sendEvent for details.
+ */
+
+RTOS_NAKED_FCT void reschedule(void)
+{
+#ifdef RTOS_HOST_SIMULATION
+    if(lookForActiveTaskOnReschedule())
+        switchContext();
+    sei();
+#else
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the active task. */
+    PUSH_CONTEXT_ONTO_STACK
+
+    /* The actual implementation of the function's logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). */
+    if(lookForActiveTaskOnReschedule())
+    {
+        /* Another task becomes active. Switch the stack pointer to the (saved) stack
+           pointer of that task. */
+        SWITCH_CONTEXT
+        PUSH_RET_CODE_OF_CONTEXT_SWITCH
+    }
+
+    /* The stack pointer points to the now active task. The CPU context to continue with is
+       popped from this stack. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of reschedule */
+
+
+
+
+/**
+ * Move a task into another priority class at runtime. A typical use case is load
+ * shedding: A supervisor task demotes a task of minor importance, when the CPU load is
+ * too high, and raises it again later.
+
+ *   A due task becomes the first one in the due list of its new class. A suspended task
+ * is moved to the position in the list of suspended tasks, which belongs to its new
+ * class. If the new class is higher than the class of the calling task, then the
+ * function will cause a task switch; the calling task stays due.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1. The own index, see 
+ * rtos_getIdxActiveTask, is permitted.
+ *   @param prioClass
+ * The new priority class of the task in the range 0..RTOS_NO_PRIO_CLASSES-1. Neither the
+ * old nor the new class must be the one, which is scheduled earliest deadline first, see
+ * #RTOS_EDF_PRIO_CLASS.
+ *   @remark
+ * If #RTOS_USE_MUTEX_PRIO_INHERITANCE is set, then the function sets the configured class
+ * of the task. A task, which owns a mutex, keeps the higher class of a waiting task until
+ * it releases the mutex. If #RTOS_USE_TASK_BUDGET is set, then a task, which has
+ * exhausted its budget, stays in class #RTOS_BUDGET_DEMOTION_PRIO_CLASS until its budget
+ * is replenished.
+ *   @remark
+ * The due list of the new class needs to have room for the task, see
+ * #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS.
+ *   @remark
+ * The function must not be called from an interrupt service routine or from setup().
+ */
+
+void rtos_setTaskPriority(uint8_t idxTask, uint8_t prioClass)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS  &&  prioClass < RTOS_NO_PRIO_CLASSES);
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    cli();
+
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    ASSERT(pT->prioClass != RTOS_EDF_PRIO_CLASS  &&  prioClass != RTOS_EDF_PRIO_CLASS);
+#endif
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    /* An owner of a mutex keeps the class of the waiting tasks if this is higher. */
+    pT->prioClassBase = prioClass;
+    prioClass = getInheritedPrioClass(pT);
+#endif
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+    /* A task, which has exhausted its budget, stays demoted till the replenishment. */
+    pT->prioClassBudget = prioClass;
+    if(pT->budget != 0  &&  pT->cntBudget == 0  &&  prioClass > RTOS_BUDGET_DEMOTION_PRIO_CLASS)
+        prioClass = RTOS_BUDGET_DEMOTION_PRIO_CLASS;
+#endif
+
+    if(prioClass != pT->prioClass)
+    {
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+        /* If a suspended task waits for mutexes then their owners may inherit the new
+           class. A lower class is given back by the owners only when they release the
+           mutex. */
+        if(!changePrioClass(pT, prioClass, /* isLastDueTask */ false)
+           &&  pT->parkState != PARK_STATE_PARKED
+          )
+        {
+            inheritPrioClass(pT);
+        }
+#else
+        changePrioClass(pT, prioClass, /* isLastDueTask */ false);
+#endif
+        reschedule();
+    }
+    else
+        sei();
+
+} /* End of rtos_setTaskPriority */
+
+
+
+
+/**
+ * Park a task. A parked task doesn't become the active task before it is resumed by 
+ * rtos_resumeTask, regardless of its priority and of the events posted to it.
+
+ *   Please note, that the RTuinOS documentation uses the term "suspended" for a task,
+ * which waits for events. To avoid confusion, the state of a task, which has been
+ * suspended by this function, is called "parked".
+
+ *   A due task is parked at once. If it is the calling task itself, then the function
+ * switches to another task and returns not before the task has been resumed. A task,
+ * which is currently waiting for events, continues waiting. It is parked at the moment
+ * its resume condition is fulfilled; the events and sync objects, which have resumed the
+ * task, are returned by its suspend command after rtos_resumeTask.
+
+ *   Parking a task, which is already parked, has no effect.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1. The own index, see 
+ * rtos_getIdxActiveTask, is permitted. The idle task can't be parked.
+ *   @remark
+ * A task should not be parked while it owns a mutex; the waiting tasks would be blocked
+ * until the task is resumed.
+ *   @remark
+ * The function must not be called from an interrupt service routine or from setup().
+ */
+
+void rtos_suspendTask(uint8_t idxTask)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS);
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    cli();
+
+    if(pT->parkState == PARK_STATE_NONE)
+    {
+        if(unlinkDueTask(pT))
+        {
+            pT->parkState = PARK_STATE_PARKED;
+
+            /* A task, which parks itself, is left now. */
+            if(pT == _pActiveTask)
+            {
+                reschedule();
+                return;
+            }
+        }
+        else
+        {
+            /* The task is waiting and will be parked when it is resumed. */
+            pT->parkState = PARK_STATE_PENDING;
+        }
+    }
+
+    sei();
+
+} /* End of rtos_suspendTask */
+
+
+
+
+/**
+ * Resume a task, which has been parked by  rtos_suspendTask. A task, which had been
+ * parked while it was due or which has been resumed from waiting meanwhile, becomes due.
+ * If it is of higher priority than the calling task, then the function will cause a task
+ * switch; the calling task stays due. A task, which is still waiting, simply continues
+ * waiting.
+
+ *   Resuming a task, which is not parked, has no effect.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1.
+ *   @remark
+ * The due list of the class of the task needs to have room for the task, see
+ * #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS.
+ *   @remark
+ * The function must not be called from an interrupt service routine or from setup().
+ */
+
+void rtos_resumeTask(uint8_t idxTask)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS);
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    cli();
+
+    if(pT->parkState == PARK_STATE_PARKED)
+    {
+        pT->parkState = PARK_STATE_NONE;
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+        /* The start latency is measured from the end of the parked state. */
+        pT->tiRelease = micros();
+#endif
+        insertDueTask(pT);
+        reschedule();
+    }
+    else
+    {
+        pT->parkState = PARK_STATE_NONE;
+        sei();
+    }
+} /* End of rtos_resumeTask */
+#endif /* RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+/**
+ * Determine the next release of a periodic task, which suspends itself until its next
+ * period. The release time is advanced by one period on the grid of the task. If this
+ * point in time is already over, then the task has an overrun and the overrun policy of
+ * the task decides when it becomes due.
+ *   @param pT
+ * Pointer to the task object of the suspending task. Its period is not zero.
+ */
+
+static inline void setNextPeriodicRelease(task_t * const pT)
+{
+    uintTime_t timeRelease = pT->timeRelease + pT->period;
+
+    /* The overrun is recognized by the signed comparison of the cyclic time, see
+       storeResumeCondition. */
+    if((intTime_t)(timeRelease - _time) <= 0)
+    {
+        if(pT->cntOverrun < 0xff)
+            ++ pT->cntOverrun;
+
+        switch(pT->overrunPolicy)
+        {
+        case RTOS_OVERRUN_POLICY_SKIP:
+            /* The missed activations are dropped. The task is released at the next point
+               in time on its grid, which is still ahead. */
+            do
+            {
+                timeRelease += pT->period;
+            }
+            while((intTime_t)(timeRelease - _time) <= 0);
+            pT->timeDueAt = timeRelease;
+            break;
+
+        case RTOS_OVERRUN_POLICY_CATCH_UP:
+            /* No activation is lost. The task becomes due in the next tic but the grid is
+               kept: It is released in every tic until it has caught up with its grid. */
+            pT->timeDueAt = _time+1;
+            break;
+
+        default:
+            /* The task becomes due in the next tic and the grid is shifted to this point in
+               time. This is the behavior of rtos_suspendTaskTillTime. */
+            ASSERT(pT->overrunPolicy == RTOS_OVERRUN_POLICY_IMMEDIATE);
+            timeRelease = _time+1;
+            pT->timeDueAt = timeRelease;
+        }
+    }
+    else
+        pT->timeDueAt = timeRelease;
+
+    pT->timeRelease = timeRelease;
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    /* The deadline is the end of the nominal period. */
+    pT->timeDeadline = timeRelease + pT->period;
+#endif
+} /* End of setNextPeriodicRelease */
+#endif /* RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON */
+
+
+
+
+/**
+ * This is a code pattern (inline function) which saves the resume condition of a task,
+ * which is going to be suspended into its task object. This pattern is mainly used in the
+ * suspend function rtos_waitForEvent but also at task initialization time, when the
+ * initial task start condition is specified by the application code.
+ *   @param pT
+ * Pointer to the task object of the suspend task.
+ *   @param eventMask
+ * See function \a rtos_waitForEvent for details.
+ *   @param all
+ * See function \a rtos_waitForEvent for details.
+ *   @param timeout
+ * See function \a rtos_waitForEvent for details.
+ *   @see
+ * void rtos_waitForEvent(uintEventVec_t, boolean, uintTime_t)
+ *   @remark
+ * For performance reasons this function needs to be inlined. A macro would be an
+ * alternative.
+ */
+
+static inline void storeResumeCondition( task_t * const pT
+                                       , uintEventVec_t eventMask
+                                       , boolean all
+                                       , uintTime_t timeout
+                                       )
+{
+    /* Check event condition: It must not be empty. The two timers can't be used at the
+       same time (which is a rather harmless application design error) and at least one
+       other event needs to be required for a resume in case of the AND condition.
+         The latter bad situation leads to a crash. If all is set then RTuinOS interprets
+       the empty event mask as the always fulfilled resume condition. The task became due
+       without any bit set in the task's postedEventVec - which leads to a wrong state
+       transition in the kernel. (Please refer to the manual for a detail explanation of
+       the task state meaning of postedEventVec.) */
+    ASSERT(eventMask != 0
+           &&  (eventMask & MASK_EVT_IS_TIMER) != MASK_EVT_IS_TIMER
+           &&  (!all || (eventMask & ~MASK_EVT_IS_TIMER) != 0)
+          );
+
+    /* The timing parameter may refer to different timers. Depending on the event mask we
+       either load the one or the other timer. Default is the less expensive delay
+       counter. */
+    if((eventMask & RTOS_EVT_ABSOLUTE_TIMER) != 0)
+    {
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+        /* A periodic task is released on the grid of its period; the timeout is ignored. */
+        if(pT->period != 0)
+            setNextPeriodicRelease(pT);
+        else
+#endif
+        /* This suspend command wants a reactivation at a certain time. The new time is
+           assigned by the += in the conditional expression.
+             Task overrun detection: The new time must be no more than half a cycle in the
+           future. The test uses a signed comparison. The unsigned comparison >= 0x80 would be
+           equivalent but probably less performant (TBC). */
+        if((intTime_t)((pT->timeDueAt+=timeout) - _time) <= 0)
+        {
+            if(pT->cntOverrun < 0xff)
+                ++ pT->cntOverrun;
+
+            /* The wanted point in time is over. We do the best recovery which is possible: Let
+               the task become due in the very next timer tic.
+                 In specific situations, this can be counter productive - the application
+               may turn off this corrective action. See documentation: If the eight Bit
+               system timer and very slow, regular tasks are used there's a high risk of
+               seeing false overrun recognitions. Now making the task due immediately would
+               introduce a true error. */
+#if RTOS_OVERRUN_TASK_IS_IMMEDIATELY_DUE == RTOS_FEATURE_ON
+            pT->timeDueAt = _time+1;
+#endif
+        }
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+        /* The deadline of a regular task is the end of its period: The activation, which
+           is now awaited, needs to be completed before the task is due the next time. */
+# if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+        if(pT->period == 0)
+# endif
+            pT->timeDeadline = pT->timeDueAt + timeout;
+#endif
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+        pT->timeTimeout = pT->timeDueAt;
+        linkTimeout(pT);
+#endif
+    }
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+    else if((eventMask & RTOS_EVT_DELAY_TIMER) != 0)
+    {
+        /* The delay is converted into the point in time when it elapses. The uncertainty
+           of the unsynchronized call is handled as in the counter based implementation:
+           The delay is a minimum and the timeout is at the end of the tic after the
+           specified number of tics. */
+        if((uintTime_t)(timeout+1) != 0)
+            ++ timeout;
+        pT->timeTimeout = _time + timeout;
+        linkTimeout(pT);
+    }
+#else
+    else
+    {
+        /* The timeout counter is reloaded. We could do this conditionally if the bit is
+           set, but in all normal use cases it'll and if not it doesn't harm. We will
+           just decrement the delay counter in onTimerTic once but not set the event.
+             ++ timeout: The call of the suspend function is in no way synchronized with the
+           system clock. We define the delay to be a minimum and implement the resolution
+           caused uncertainty as an additional delay. */
+        if((uintTime_t)(timeout+1) != 0)
+            ++ timeout;
+        pT->cntDelay = timeout;
+
+    } /* if(Which timer is addressed for the timeout condition?) */
+#endif
+
+    pT->eventMask = eventMask;
+    pT->waitForAnyEvent = !all;
+
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+    /* Subscribe the task to all the events it waits for. */
+    linkWaitingTask(pT);
+#endif
+
+} /* End of storeResumeCondition */
+
+
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+/**
+ * Waiting for events doesn't necessarily mean waiting: If the wait condition includes
+ * mutexes and semaphores these may already be available on entry in the wait function.
+ * This routine checks all demanded sync objects and locks and allocates all those objects
+ * to the calling task, which are currently free.
+ *   @return
+ * Finally the routine checks if the wait condition of the suspend command is already
+ * fulfilled with the found sync objects. If and only if so it returns true and the suspend
+ * command won't actually block the calling task.
+ *   @param eventMask
+ * See function \a rtos_waitForEvent for details.
+ *   @param all
+ * See function \a rtos_waitForEvent for details.
+ *   @see
+ * void rtos_waitForEvent(uintEventVec_t, boolean, uintTime_t)
+ *   @remark
+ * This function is inlined for performance reasons.
+ */
+
+static inline boolean acquireFreeSyncObjs(uintEventVec_t eventMask, boolean all)
+{
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    /* Check for immediate availability of all/any mutex. These mutexes are locked now and
+       entered in the calling task's postedEventVec. */
+    _pActiveTask->postedEventVec = eventMask & _mutexVec;
+# if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    setMutexOwner(_pActiveTask->postedEventVec & MASK_EVT_IS_MUTEX, _pActiveTask);
+# endif
+
+    /* Lock the demanded mutexes. Bits in eventMask which do not correspond to mutex events
+       don't need to be masked. They may reset some anyway reset don't-care bits in
+       _mutexVec. */
+    _mutexVec &= ~eventMask;
+#endif
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+    /* Check for immediate availability of all/any semaphores. The counters of none zero
+       semaphores are decremented now and the related acquired-bit is set in the calling
+       task's postedEventVec. */
+    uint8_t idxSem = 0;
+    uintEventVec_t maskSem = RTOS_EVT_LSB
+                 , semaphoreToAcquireVec = eventMask & MASK_EVT_IS_SEMAPHORE;
+    while(semaphoreToAcquireVec)
+    {
+        if((semaphoreToAcquireVec & RTOS_EVT_LSB) != 0)
+        {
+            if(rtos_semaphoreAry[idxSem] > 0)
+            {
+                -- rtos_semaphoreAry[idxSem];
+                _pActiveTask->postedEventVec |= maskSem;
+            }
+        }
+
+        /* Test next event bit and increment related index of semaphore in array. */
+        ++ idxSem;
+        maskSem <<= 1;
+        semaphoreToAcquireVec >>= 1;
+    }
+#endif
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+    traceSyncObjHandOver( _pActiveTask
+                        , _pActiveTask->postedEventVec & (MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE)
+                        );
+#endif
+
+    /* postedEventVec now contains all requested mutexes, which were currently available.
+       If these were all demanded events, we don't need to suspend the task but can
+       immediately and successfully return. The timer bits (events 14 and 15) don't matter
+       as they are always OR terms. We definitely don't need to wait for them. */
+    return (!all &&  _pActiveTask->postedEventVec != 0)
+           || (all &&  ((_pActiveTask->postedEventVec ^ eventMask) & ~MASK_EVT_IS_TIMER) == 0);
+
+} /* End of acquireFreeSyncObjs */
+
+#endif /* RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON */
+
+
+
+/**
+ * Actual implementation of task suspension routine \a rtos_waitForEvent. The task is
+ * suspended until a specified event occurs.\n
+ *   The action of this SW interrupt is placed into an own function in order to let the
+ * compiler generate the stack frame required for all local data. (The stack frame
+ * generation of the SW interrupt entry point needs to be inhibited in order to permit the
+ * implementation of saving/restoring the task context).
+ *   @return
+ * If mutex or semaphores are in use the function returns the Boolean information whether
+ * the calling task has to be suspended. This is not the case if all demanded sync objects
+ * are currently available. If RTuinOS is compiled without support of mutexes and
+ * sempahores than the calling task is always suspended.\n
+ *   By means of side effects, the function returns which task is to be activated and records
+ * which task is left (i.e. the task calling this routine) in the global variables \a
+ * _pActiveTask and \a _pSuspendedTask.
+ *   @param eventMask
+ * See software interrupt \a rtos_waitForEvent.
+ *   @param all
+ * See software interrupt \a rtos_waitForEvent.
+ *   @param timeout
+ * See software interrupt \a rtos_waitForEvent.
+ *   @see
+ * uintEventVec_t rtos_waitForEvent(uintEventVec_t, boolean, uintTime_t)
+ *   @remark
+ * This function and particularly passing the return codes via a global variable will
+ * operate only if all interrupts are disabled.
+ */
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+static RTOS_TRUE_FCT boolean waitForEvent( uintEventVec_t eventMask
+                                         , boolean all
+                                         , uintTime_t timeout
+                                         )
+#else
+static RTOS_TRUE_FCT void waitForEvent( uintEventVec_t eventMask
+                                      , boolean all
+                                      , uintTime_t timeout
+                                      )
+#endif
+
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    /* Here, we could double-check _pActiveTask for the idle task and return without
+       context switch if it is active. (The idle task has illicitly called a suspend
+       command.) However, all implementation rates performance higher than failure
+       tolerance, and so do we here. */
+    ASSERT(_pActiveTask != _pIdleTask);
+
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    sampleStackPointer();
+#endif
+
+    /* The trace entry holds the lower 16 bits of the awaited events. */
+    KERNEL_TRACE(TRC_ID_WAIT_FOR_EVENT, eventMask);
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    if(acquireFreeSyncObjs(eventMask, all))
+        return false;
+#endif
+
+    int8_t idxPrio;
+
+    /* Take the active task out of the list of due tasks. It is the first one in the
+       circular list of its priority class. */
+    task_t * const pT = _pActiveTask;
+#if RTOS_NO_PRIO_CLASSES > 0
+    uint8_t prio = pT->prioClass;
+    -- _noDueTasksAry[prio];
+    _idxFirstDueTaskAry[prio] = getIdxDueTask(prio, 1);
+# if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+    if(_noDueTasksAry[prio] == 0)
+        clearPrioClassDue(prio);
+# endif
+#else
+    /* Without priority classes, there are no tasks and the function is never called. */
+#endif
+
+    /* This suspend command wants a reactivation by a combination of events (which may
+       include the timeout event). Save the resume condition in the task object. The
+       operation is implemented as inline function to be able to reuse the code in the
+       task initialization routine. */
+    storeResumeCondition(pT, eventMask, all, timeout);
+
+    /* Put the task in the list of suspended tasks. This list is sorted with decreasing
+       priority; the now suspended task becomes the last one in its prio class. */
+    linkSuspendedTask(pT);
+
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    /* The owners of the mutexes, which the task has to wait for, inherit its priority. This
+       way, a task of medium priority can't delay the release of the mutexes. */
+    inheritPrioClass(pT);
+#endif
+
+    /* Record which task suspends itself for the assembly code in the calling function
+       which actually switches the context. */
+    _pSuspendedTask = _pActiveTask;
+
+    /* Look for the task we will return to. It's the first entry in the highest non-empty
+       priority class.
+         It's not guaranteed that there is any due task. Idle is the fallback. */
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON  \
+    ||  RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    _isReschedulePending = false;
+#endif
+    idxPrio = getHighestDuePrioClass();
+    if(idxPrio >= 0)
+        _pActiveTask = _pDueTaskAryAry[idxPrio][_idxFirstDueTaskAry[idxPrio]];
+    else
+        _pActiveTask = _pIdleTask;
+
+#if RTOS_USE_KERNEL_TRACE == RTOS_FEATURE_ON
+    /* The suspending task is left in any case. */
+    traceTaskSwitch();
+#endif
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    /* The suspending task is left in any case. */
+    accountTaskRuntime(_pSuspendedTask);
+#endif
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+    /* The suspending task has completed its job. */
+    addTimingSample(&_pSuspendedTask->statExecutionTime, micros() - _pSuspendedTask->tiStart);
+    onTaskStart(_pActiveTask);
+#endif
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+    accountIsrLatency(_pActiveTask);
+#endif
+
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    return true;
+#endif
+} /* End of waitForEvent */
+
+
+
+
+/**
+ * Suspend the current task (i.e. the one which invokes this method) until a specified
+ * combination of events occur. In the special case, that the specified combination of
+ * events can be satisfied with currently available synchronization objects (mutexes and
+ * semaphores) the function will return immediately without suspending the calling task.\n
+ *   A task is suspended in the instance of calling this method. It specifies a list of
+ * events. The task becomes due again, when either the first one or all of the specified
+ * events have been posted by other tasks.\n
+ *   The idle task can't be suspended. If it calls this function a crash would be the
+ * immediate result.
+ *   @return
+ * The set of actually resuming events is returned as a bit vector which corresponds
+ * bitwise to eventMask. See \a rtos.h for a list of known events.
+ *   @param eventMask
+ * The bit vector of events to wait for. Needs to include either the delay timer event
+ * #RTOS_EVT_DELAY_TIMER or #RTOS_EVT_ABSOLUTE_TIMER, if a timeout is required, but not both
+ * of them.\n
+ *   The normal use case will probably be the delay timer. However, a regular task may also
+ * specify the absolute timer with the next regular task time as parameter so that it
+ * surely becomes due outermost at its usual task time.
+ *   @param all
+ *   If false, the task is made due as soon as the first event mentioned in \a eventMask is
+ * seen.\n
+ *   If true, the task is made due only when all events are posted to the suspending task -
+ * except for the timer events, which are still OR combined. If you say "all" but the event
+ * mask contains either #RTOS_EVT_DELAY_TIMER or #RTOS_EVT_ABSOLUTE_TIMER, the task will
+ * resume when either the timer elapsed or when all other events in the mask were seen.\n
+ *   Caution: If all is true, there need to be at least one event bit set in \a eventMask
+ * besides a timer bit; RTuinOS crashes otherwise. Saying: "No particular event, just a
+ * timer condition" needs to be implemented by \a all set to false and \a eventMask set to
+ * only a timer event bit.
+ *   @param timeout
+ * If \a eventMask contains #RTOS_EVT_DELAY_TIMER:\n
+ *   The number of system timer tics from now on until the timeout elapses. One should be
+ * aware of the resolution of any timing being the tic of the system timer. A timeout of \a
+ * n may actually mean any delay in the range \a n .. \a n+1 tics.\n
+ *   Even specifying 0 will suspend the task a short time and give others the chance to
+ * become active - particularly other tasks belonging to the same priority class.\n
+ *   If \a eventMask contains #RTOS_EVT_ABSOLUTE_TIMER:\n
+ *   The absolute time the task becomes due again at latest. The time designation is
+ * relative; it refers to the last recent absolute time at which this task had been
+ * resumed. See #rtos_suspendTaskTillTime for details.\n
+ *   Now the range of the parameter is 1 till the half the range of the data type which is
+ * configured for the system time, e.g. 127 in case of uint8_t. Otherwise proper task
+ * timing can't be guaranteed.\n
+ *   If neither #RTOS_EVT_DELAY_TIMER nor #RTOS_EVT_ABSOLUTE_TIMER is set in the event mask,
+ * this parameter should be zero.
+ */
+ 
+RTOS_NAKED_FCT uintEventVec_t rtos_waitForEvent( uintEventVec_t eventMask
+                                               , boolean all
+                                               , uintTime_t timeout
+                                               )
+{
+    /* It is absolutely essential that this routine is implemented as naked and noinline.
+       See http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html for details.
+         GCC doesn't create a stack frame for naked functions. For normal functions, the
+       calling parameter of the function is stored in such a stack frame. In the
+       combination naked and having local function parameters, GCC has a problem when
+       generating code without optimization: It doesn't generate a stack frame but still
+       does save the local parameter into the (not existing) stack frame as very first
+       assembly operation of the function code. There's absolutely no work around; when the
+       earliest code, we can write inside the function is executed, the stack is already
+       corrupted in a hazardous way. A crash is unavoidable.
+         A discussion of the issue can be found at
+       http://lists.gnu.org/archive/html/avr-gcc-list/2012-08/msg00014.html.
+         To avoid this problem we forbid to compile the code with optimization off.
+       Nonetheless, who will ever know or understand under which circumstances, e.g. which
+       combination of optimization flags, GCC will again generate this crash-code. This
+       issue remains a severe risk! Consequently, at any change of a compiler setting you
+       will need to inspect the assembly listing file and double-check that it is proper
+       with respect of using (better not using) the stack frame for this function (and
+       rtos_sendEvent).
+         Another idea would be the implementation of this function completely in assembly
+       code. Doing so, we have the new problem of calling assembly code as C functions.
+       Find an example of how to do in
+       file:///M:/SVNMainRepository/Arduino/RTuinOS/trunk/RTuinOS/code/RTOS/rtos.c,
+       revision 215. */
+#ifndef __OPTIMIZE__
+# error This code must not be compiled with optimization off. See source code comments for more
+#endif
+
+#ifdef RTOS_HOST_SIMULATION
+    cli();
+# if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    if(waitForEvent(eventMask, all, timeout))
+# else
+    waitForEvent(eventMask, all, timeout);
+# endif
+    {
+        /* The task is suspended. It continues here when it is resumed. */
+        switchContext();
+    }
+
+    /* The return value is taken from the task object like PUSH_RET_CODE_OF_CONTEXT_SWITCH
+       does. */
+    const uintEventVec_t postedEventVec = _pActiveTask->postedEventVec;
+    _pActiveTask->postedEventVec = 0;
+    sei();
+
+    return postedEventVec;
+#else
+    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
+       interrupt enable flag, we inhibit any interrupts now. */
+    asm volatile
+    ( "cli \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the interrupted
+       active task. */
+    PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK
+
+    /* The actual implementation of the task switch logic is placed into a sub-routine in
+       order to benefit from the compiler generated stack frame for local variables (in
+       this naked function we must not have declared any). The call of the function is
+       immediately followed by some assembly code which computes the return value of the
+       function and places it in register pair r24/25. */
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    if(waitForEvent(eventMask, all, timeout))
+#else
+    waitForEvent(eventMask, all, timeout);
+#endif
+    {
+        /* The wait condition couldn't be fulfilled immediately, we need to suspend the
+           task. Switch the stack pointer to the (saved) stack pointer of the new active
+           task. */
+        SWITCH_CONTEXT
+    }
+
+     /* Regardless whether we had switched the task the suspend command ends with returning
+        the information about the task releasing events. Push this function result onto the
+        (maybe new) stack - from where it is loaded into r24/r25 by the subsequent pop-context
+        command. */
+    PUSH_RET_CODE_OF_CONTEXT_SWITCH
+
+    /* The stack pointer points to the now active task (which may be still the same as at
+       function entry). The CPU context to continue with is popped from this stack. If
+       there's no change in active task the entire routine call is just like any ordinary
+       interrupt. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+
+    /* This statement is never reached. Just to avoid the warning. */
+    return 0;
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of rtos_waitForEvent */
+
+
+
+
+#if RTOS_USE_SEND_EVENT_AND_WAIT == RTOS_FEATURE_ON
+/**
+ * Actual implementation of routine \a rtos_sendEventAndWait. The events are posted and the
+ * calling task is suspended until a specified event occurs. The scheduler decides only
+ * once, which task is to be activated.
+ *   @return
+ * The function returns the Boolean information whether the active task changes. This is
+ * always the case if the calling task is suspended. If all demanded sync objects are
+ * currently available, then the calling task is not suspended but it may still be
+ * superseded by a task of higher priority, which is resumed by the posted events.\n
+ *   By means of side effects, the function returns which task is to be activated and records
+ * which task is left (i.e. the task calling this routine) in the global variables \a
+ * _pActiveTask and \a _pSuspendedTask.
+ *   @param postedEventVec
+ * See software interrupt \a rtos_sendEventAndWait.
+ *   @param eventMask
+ * See software interrupt \a rtos_sendEventAndWait.
+ *   @param all
+ * See software interrupt \a rtos_sendEventAndWait.
+ *   @param timeout
+ * See software interrupt \a rtos_sendEventAndWait.
+ *   @see
+ * uintEventVec_t rtos_sendEventAndWait(uintEventVec_t, uintEventVec_t, boolean, uintTime_t)
+ *   @remark
+ * This function and particularly passing the return codes via a global variable will
+ * operate only if all interrupts are disabled.
+ */
+
+static RTOS_TRUE_FCT boolean sendEventAndWait( uintEventVec_t postedEventVec
+                                             , uintEventVec_t eventMask
+                                             , boolean all
+                                             , uintTime_t timeout
+                                             )
+{
+    /* Avoid inlining under all circumstances. See attributes also. */
+    asm("");
+
+    /* Post the events to the suspended tasks. The calling task is still active and not
+       affected by its own events. The resumed tasks are only made due; the decision,
+       which task to continue with, is taken below. */
+    const boolean activeTaskMayChange = postEvent(postedEventVec);
+
+    /* Suspend the calling task. waitForEvent looks for the task to continue with among
+       all due tasks, which includes the tasks just resumed by the posted events. */
+#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
+    if(!waitForEvent(eventMask, all, timeout))
+    {
+        /* The calling task got all demanded sync objects and stays due. It is superseded
+           only if a task of higher priority has been resumed by the posted events. If so,
+           the calling task is left inside the suspend command with a non zero event
+           vector; at its next activation it'll return from the suspend command like any
+           resumed task. */
+        return (activeTaskMayChange  ||  IS_RESCHEDULE_PENDING())  &&  lookForActiveTask();
     }
+#else
+    (void)activeTaskMayChange;
+    waitForEvent(eventMask, all, timeout);
 #endif
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    /* The remaining mutexes are returned to the global storage for later acquisition.
-         The assertion validates application code. It fires if the application releases
-       a mutex, which was not acquired. This is harmless with respect to the stability of
-       the RTOS but probably a design error in the application. Maybe, you have to
-       consider using a semaphore. */
-    ASSERT((_mutexVec & dbg_allMutexesToReleaseVec) == 0);
-    _mutexVec |= mutexToReleaseVec;
-#endif /* RTOS_USE_MUTEX == RTOS_FEATURE_ON */
+
+    return true;
+
+} /* End of sendEventAndWait */
+
+
+
+
+/**
+ * Post a set of events to all suspended tasks and suspend the current task until a
+ * specified combination of events occurs. The function does the same as calling
+ * #rtos_sendEvent and #rtos_waitForEvent, but in a single kernel call:\n
+ *   The context of the calling task is saved and restored only once and the scheduler
+ * decides only once, which task is to be activated. If the posted events resume a task
+ * of higher priority, then this task is not activated before the calling task is
+ * suspended; its response to the posted events can't be missed by the calling task.
+ * This makes the function the natural choice for request/response and producer/consumer
+ * hand shakes between tasks.\n
+ *   The idle task can't be suspended. It must not call this function.
+ *   @return
+ * The set of actually resuming events is returned as a bit vector which corresponds
+ * bitwise to \a eventMask. See rtos_waitForEvent.
+ *   @param postedEventVec
+ * A bit vector of posted events, see rtos_sendEvent. The events are posted before the
+ * calling task starts waiting; the calling task doesn't receive any of its own events.
+ *   @param eventMask
+ * The bit vector of events to wait for, see rtos_waitForEvent.
+ *   @param all
+ * See rtos_waitForEvent.
+ *   @param timeout
+ * See rtos_waitForEvent.
+ *   @remark
+ * In optimization level 0 GCC has a problem with code generation for naked functions. See
+ * function #rtos_waitForEvent for details.
+ */
+
+RTOS_NAKED_FCT uintEventVec_t rtos_sendEventAndWait( uintEventVec_t postedEventVec
+                                                   , uintEventVec_t eventMask
+                                                   , boolean all
+                                                   , uintTime_t timeout
+                                                   )
+{
+#ifndef __OPTIMIZE__
+# error This code must not be compiled with optimization off. See source code comments for more
+#endif
+
+#ifdef RTOS_HOST_SIMULATION
+    cli();
+    if(sendEventAndWait(postedEventVec, eventMask, all, timeout))
+    {
+        /* The task is suspended or superseded. It continues here when it becomes active
+           again. */
+        switchContext();
+    }
+
+    /* The return value is taken from the task object like PUSH_RET_CODE_OF_CONTEXT_SWITCH
+       does. */
+    const uintEventVec_t resumingEventVec = _pActiveTask->postedEventVec;
+    _pActiveTask->postedEventVec = 0;
+    sei();
+
+    return resumingEventVec;
+#else
+    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
+       interrupt enable flag, we inhibit any interrupts now. */
+    asm volatile
+    ( "cli \n\t"
+    );
+
+    /* The program counter as first element of the context is already on the stack (by
+       calling this function). Save rest of context onto the stack of the active task. The
+       return value of the function will be pushed in place of register pair r24/25, see
+       rtos_waitForEvent. */
+    PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK
+
+    /* The actual implementation of the logic is placed into a sub-routine in order to
+       benefit from the compiler generated stack frame for local variables (in this naked
+       function we must not have declared any). */
+    if(sendEventAndWait(postedEventVec, eventMask, all, timeout))
+    {
+        /* Switch the stack pointer to the (saved) stack pointer of the new active task. */
+        SWITCH_CONTEXT
+    }
+
+    /* Push the return code of the suspend command onto the (maybe new) stack. If the
+       calling task didn't need to wait then these are the acquired sync objects. */
+    PUSH_RET_CODE_OF_CONTEXT_SWITCH
+
+    /* The CPU context to continue with is popped from the stack of the now active task. */
+    POP_CONTEXT_FROM_STACK
+
+    /* The global interrupt enable flag is not saved across task switches, but always set
+       on entry into the new or same context by using a reti rather than a ret. */
+    asm volatile
+    ( "reti \n\t"
+    );
+
+    /* This statement is never reached. Just to avoid the warning. */
+    return 0;
+#endif /* RTOS_HOST_SIMULATION */
+
+} /* End of rtos_sendEventAndWait */
+#endif /* RTOS_USE_SEND_EVENT_AND_WAIT == RTOS_FEATURE_ON */
+
+
+
+
+/**
+ * Get the current system time. The time is counted in system timer tics and cycles
+ * around in the range of the data type uintTime_t. It is the reference for the deadline of
+ * rtos_waitForEventTillDeadline.
+ *   @return
+ * Get the system time in tics.
+ *   @remark
+ * The function may be called from a task or from the idle task. It must not be called
+ * from an interrupt service routine, as it reenables the interrupts.
+ */
+
+uintTime_t rtos_getTime(void)
+{
+    /* Reading the system time is atomic only for the eight Bit type. */
+    cli();
+    const uintTime_t time = _time;
+    sei();
+
+    return time;
+
+} /* End of rtos_getTime */
+
+
+
+
+/**
+ * Suspend the current task until a specified combination of events occurs or an absolute
+ * deadline is reached. Other than rtos_waitForEvent, the timeout is not stated relative to
+ * the time of the call but as a point in time. A task, which needs to wait several times
+ * for partial results or for the stages of a protocol, can wait again and again against
+ * the same deadline; the total timeout doesn't drift and the task doesn't need to do the
+ * bookkeeping of the time already spent.\n
+ *   The idle task can't be suspended. If it calls this function a crash would be the
+ * immediate result.
+ *   @return
+ * The set of actually resuming events is returned as a bit vector, see rtos_waitForEvent.
+ * #RTOS_EVT_DELAY_TIMER is set if the deadline is reached. If the deadline is already
+ * reached at the time of the call, then the function returns #RTOS_EVT_DELAY_TIMER
+ * immediately; the task is not suspended and doesn't acquire any sync objects.
+ *   @param eventMask
+ * The bit vector of events to wait for, see rtos_waitForEvent. It must not contain any of
+ * the timer events, the delay timer is added by the function.
+ *   @param all
+ * See rtos_waitForEvent.
+ *   @param timeDeadline
+ * The absolute deadline as system time, see rtos_getTime. The task is resumed at latest in
+ * the system timer tic, in which the system time reaches the deadline. For example,
+ * rtos_getTime()+n designates a timeout of n-1 .. n tics from now on. The deadline needs
+ * to be less than half the range of uintTime_t ahead.
+ *   @param pRemainingTime
+ * The number of tics from the return of the function till the deadline is placed in *\a
+ * pRemainingTime. It is 0 if the deadline has been reached. The pointer may be NULL if
+ * the information is not required.
+ */
+
+uintEventVec_t rtos_waitForEventTillDeadline( uintEventVec_t eventMask
+                                            , boolean all
+                                            , uintTime_t timeDeadline
+                                            , uintTime_t *pRemainingTime
+                                            )
+{
+    uintEventVec_t postedEventVec;
+    intTime_t remainingTime;
+
+    ASSERT((eventMask & MASK_EVT_IS_TIMER) == 0);
+
+    /* The timeout is computed with the interrupts disabled, no tic must occur before the
+       suspend function has stored it. The suspend function always reenables the
+       interrupts. */
+    cli();
+    remainingTime = (intTime_t)(timeDeadline - _time);
+    if(remainingTime > 0)
+    {
+        /* The delay timer elapses in the tic after the specified number of tics, which is
+           the tic the deadline is reached in. */
+        postedEventVec = rtos_waitForEvent( eventMask | RTOS_EVT_DELAY_TIMER
+                                          , all
+                                          , /* timeout */ (uintTime_t)(remainingTime-1)
+                                          );
+        cli();
+        remainingTime = (intTime_t)(timeDeadline - _time);
+        sei();
+    }
+    else
+    {
+        sei();
+        postedEventVec = RTOS_EVT_DELAY_TIMER;
+    }
+
+    if(pRemainingTime != NULL)
+        *pRemainingTime = remainingTime > 0? (uintTime_t)remainingTime: 0;
+
+    return postedEventVec;
+
+} /* End of rtos_waitForEventTillDeadline */
+
+
+
+
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+/**
+ * Suspend the current task until it is notified by rtos_notifyTask or
+ * rtos_notifyTaskFromISR or until a timeout elapses. If one of the awaited notifications
+ * has already been posted, then the function returns immediately without suspending the
+ * task.\n
+ *   The taken notifications are reset; other posted notifications stay latched until
+ * they are awaited.\n
+ *   The idle task can't be suspended. If it calls this function a crash would be the
+ * immediate result.
+ *   @return
+ * Get the awaited notifications, which have been posted to the task. The return value is
+ * zero if the timeout elapsed.
+ *   @param notificationMask
+ * The notifications to wait for. Any of them resumes the task. The mask must not be zero.
+ *   @param timeout
+ * The number of system timer tics from now on until the timeout elapses, see the delay
+ * timer of rtos_waitForEvent. The wait is always limited by the timeout; a task, which
+ * waits for a notification only, will call the function in a loop.
+ */
+
+uintNotificationVec_t rtos_waitForNotification( uintNotificationVec_t notificationMask
+                                              , uintTime_t timeout
+                                              )
+{
+    ASSERT(notificationMask != 0);
+
+    /* The check of the latched notifications and the suspension need to be atomic. The
+       suspend function is entered with the interrupts disabled; it always reenables the
+       interrupts. */
+    cli();
+    if((_pActiveTask->notificationVec & notificationMask) == 0)
+    {
+        /* The mask marks the task as waiting for notifications. The kernel resets it when
+           the task is resumed. The return value of the suspend function doesn't matter,
+           it is the timer event in either case, see postNotification. */
+        _pActiveTask->notificationMask = notificationMask;
+        rtos_waitForEvent(RTOS_EVT_DELAY_TIMER, /* all */ false, timeout);
+        cli();
+    }
+
+    const uintNotificationVec_t gotNotificationVec = _pActiveTask->notificationVec
+                                                     & notificationMask;
+    _pActiveTask->notificationVec &= ~gotNotificationVec;
+    sei();
+
+    return gotNotificationVec;
+
+} /* End of rtos_waitForNotification */
+#endif
+
+
+
+
+
+
+
+/**
+ * Get the current value of the overrun counter of a given task.\n
+ *   The value is a limited 8 Bit counter (i.e. it won't cycle around). This is considered
+ * satisfying as any task overrun is a kind of error and should not happen in a real
+ * application (with other words: even a Boolean information could be enough). Furthermore,
+ * if a larger range is required, one can regularly ask for this information, accumulate it
+ * and reset the value here to zero at the same time.\n
+ *   The function may be called from a task or from the idle task.
+ *   @return
+ * Get the current value of the overrun counter.
+ *   @param idxTask
+ * The index of the task the overrun counter of which is to be returned. The index is the
+ * same as used when initializing the tasks (see rtos_initializeTask).
+ *   @param doReset
+ * Boolean flag, which tells whether to reset the value.\n
+ *   Caution, when setting this to true, reading and resetting the value needs to become an
+ * atomic operation, which requires a critical section. This is significantly more
+ * expensive than just reading the value and it globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
+ *   @remark
+ * This function has some limitations and weaknesses: First of all, the concept of task
+ * overruns is defined only for regular tasks. Secondary, and particularly when using the 8
+ * Bit system timer, there's a significant probability of not recognizing huge task
+ * overruns. Finally there's a significant probability of false recognitions of (not
+ * happening) task overruns if the task period time is greater than half the system timer's
+ * cycle time (i.e. greater than 127 for the 8 Bit system timer). Please, refer to the
+ * RTuinOS manual for details.
+ *   @see
+ * void rtos_initializeTask()
+ */
+
+uint8_t rtos_getTaskOverrunCounter(uint8_t idxTask, boolean doReset)
+{
+    if(doReset)
+    {
+        uint8_t retCode
+              , * const pCntOverrun = &_taskAry[idxTask].task.cntOverrun;
+
+        /* Read and reset should be atomic for data consistency if the application wants to
+           accumulate the counter values in order to extend the counter's range. */
+        cli();
+        {
+            retCode = *pCntOverrun;
+            *pCntOverrun = 0;
+        }
+        sei();
+
+        return retCode;
+    }
+    else
+    {
+        /* Reading an 8 Bit word is an atomic operation as such, no additional lock
+           operation needed. */
+        return _taskAry[idxTask].task.cntOverrun;
+    }
+} /* End of rtos_getTaskOverrunCounter */
+
+
+
+
+/**
+ * Compute how many bytes of the stack area of a task are still unused. If the value is
+ * requested after an application has been run a long while and has been forced to run
+ * through all its paths many times, it may be used to optimize the static stack allocation
+ * of the task. The function is useful only for diagnosis purpose as there's no chance to
+ * dynamically increase or decrease the stack area at runtime.\n
+ *   The function may be called from a task or from the idle task.\n
+ *   The algorithm is as follows: The unused part of the stack is initialized with a
+ * specific pattern byte. This routine counts the number of subsequent pattern bytes down
+ * from the top of the stack area. This number is returned.\n
+ *   The returned result must not be trusted too much: It could of course be that a pattern
+ * byte is found not because of the initialization but because it has been pushed onto the
+ * stack - in which case the return value is too great (too optimistic) by one. The
+ * probability that this happens is significantly greater than zero. The chance that two
+ * pattern bytes had been pushed is however much less and the probability of three, four,
+ * five such bytes in sequence is negligible. (Except the irrelevant case you initialize
+ * an automatic array variable with all pattern bytes.) Any stack size optimization based
+ * on this routine should therefore subtract e.g. five bytes from the returned reserve and
+ * diminish the stack outermost by this modified value.\n
+ *   Be careful with stack size optimization based on this routine: Even if the application
+ * ran a long time there's a non-zero probability that there has not yet been a system
+ * timer interrupt in the very instance that the code of the task of interest was busy in
+ * the deepest nested sub-routine, i.e. when having the largest stack consumption. A good
+ * suggestion is to have another 36 Byte of reserve - this is the stack consumption if an
+ * interrupt occurs.\n
+ *   Recipe: Run your application a long time, ensure that it ran through all paths, get
+ * the stack reserve from this routine, subtract 5+36 Byte and diminish the stack by this
+ * value.
+ *   @return
+ * The number of still unused stack bytes. See function description for details.
+ *   @param idxTask
+ * The index of the task the stack usage has to be investigated for. The index is the
+ * same as used when initializing the tasks (see rtos_initializeTask).
+ *   @remark
+ * The computation is a linear search for the first non-pattern byte and thus relatively
+ * expensive. It's suggested to call it only in some specific diagnosis compilation or
+ * occasionally from the idle task.
+ *   @remark
+ * If #RTOS_USE_LAZY_STACK_FILL is set, then the pattern is written by the idle task after
+ * start of the kernel. The result is meaningful only once the idle task has been entered
+ * the first time.
+ *   @see
+ * void rtos_initializeTask()
+ */
+
+uint16_t rtos_getStackReserve(uint8_t idxTask)
+{
+#if RTOS_NO_TASKS > 0
+    uint8_t * const pStackArea = STACK_AREA_OF_TASK(idxTask);
+    uint8_t *sp = pStackArea;
+
+    /* The bottom of the stack is always initialized with 0, which must not be the pattern
+       byte. Therefore we don't need a limitation of the search loop - it'll always find a
+       non-pattern byte in the stack area. */
+    while(*sp == UNUSED_STACK_PATTERN)
+        ++ sp;
+
+    return sp - pStackArea;
+#else
+    /* There's no task, which the index could designate. */
+    ASSERT(false);
+    return 0;
+#endif
+} /* End of rtos_getStackReserve */
 
 
-    /* Check if another task becomes active because of the posted events.
-         activeTaskMayChange: We do the search for the new active task only if at least one
-       suspended task was resumed.
-         The function has side effects: If there's a task which was suspended before and
-       which is resumed because of an event and which is of higher priority than the one
-       being active so far, the refernces to the old and newly active task are written into
-       global variables _pSuspendedTask and _pActiveTask. */
-    return activeTaskMayChange && lookForActiveTask();
-    
-} /* End of sendEvent */
 
 
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+/**
+ * Get the stack reserve of a task from the low-water mark of its stack pointer. Different
+ * to \a rtos_getStackReserve, the function doesn't scan the stack area and can be called
+ * regularly, e.g. to monitor the stack usage in production code.\n
+ *   The stack pointer of the active task is sampled on every entry into the kernel: in
+ * every system timer tic and whenever the task posts or waits for events. The sampled
+ * values don't necessarily catch the deepest nesting of the task code; the returned
+ * reserve is an upper bound of the true reserve. The longer the application runs the
+ * better is the estimate. The result is never less than the result of \a
+ * rtos_getStackReserve.
+ *   @return
+ * The number of stack bytes, which have not been used at any of the sampling points.
+ *   @param idxTask
+ * The index of the task the stack usage has to be investigated for. The index is the
+ * same as used when initializing the tasks (see rtos_initializeTask). The idle task is not
+ * supported.
+ */
+
+uint16_t rtos_getStackLowWaterMark(uint8_t idxTask)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS);
+
+    /* The stack pointer is read and written by the kernel interrupts. */
+    cli();
+    const uint16_t minStackPointer = _taskAry[idxTask].task.minStackPointer;
+    sei();
 
+    /* The stack pointer points to the next free byte. All bytes from the bottom of the
+       stack area till this one are unused. */
+    return minStackPointer + 1 - (uint16_t)STACK_AREA_OF_TASK(idxTask);
 
+} /* End of rtos_getStackLowWaterMark */
+#endif
 
-#if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+
+
+
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
 /**
- * A conditionally compiled interrupt function. If #RTOS_USE_APPL_INTERRUPT_00 is set to
- * #RTOS_FEATURE_ON, this function implements an interrupt service routine, which posts
- * event #RTOS_EVT_ISR_USER_00 every time the interrupt occurs.\n
- *   The use case is to have a task (of high priority) which implements an infinite loop.
- * At the beginning of each loop cycle the task will suspend itself waiting for this event
- * (or maybe a timeout). The body of the loop will then handle the interrupt.\n
- *   In the AVR environment, an ISR can't be compiled independently of the actual interrupt
- * source it might be connected to. Therefore, to make this code compilable, the name of
- * the interrupt vector to be used has to be specified. Please set #RTOS_ISR_USER_00 to the
- * desired vector's name, like TIMER3_COMPA_vect. The supported vector names can be derived
- * from table 14-1 on page 105 in the CPU manual, doc2549.pdf (see http://www.atmel.com)\n
- *   CAUTION: There's only one ISR for each interrupt source. If you'd e.g. use
- * TIMER0_OVF_vect, you'd disable the time measurement routines of Arduino. Functions like
- * \a millis() or \a delay() would no longer work. Due to their global sphere of influence
- * interrupts must be chosen very carefully.
+ * Callback, which is invoked by the system timer tic if a task stack has overflown. The
+ * bottom bytes of the stack area of the task don't hold the initial pattern any more.\n
+ *   This is the default implementation of the routine, which can be overloaded by the
+ * application code, e.g. to save an error record before a reset. The default
+ * implementation makes a reset; in DEBUG compilation it fires an assertion first.
+ *   @param idxTask
+ * The index of the task, whose stack has overflown.
  *   @remark
- * The implementation of this ISR makes use of the code of the task called routine \a
- * rtos_sendEvent. Both routines need to be maintained in strict accordance.
- *   @see
- * void rtos_sendEvent(uint16_t)
+ * The function is called from the system timer interrupt. The memory beyond the stack
+ * area of the task is possibly corrupted; the function should not rely on any data and
+ * must not return.
  */
 
-ISR(RTOS_ISR_USER_00, ISR_NAKED)
+RTOS_DEFAULT_FCT void rtos_onStackOverflow(uint8_t idxTask)
 {
-    /* The program counter as first element of the context is already on the stack (by
-       calling this function). Save rest of context onto the stack of the interrupted
-       active task. */
-    PUSH_CONTEXT_ONTO_STACK
-
-	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
-       interrupted code. To make the local code here running, we need to anticipate this
-       situation and clear the register. */
+    ASSERT(false);
+#ifdef RTOS_HOST_SIMULATION
+    exit(EXIT_FAILURE);
+#else
     asm volatile
-    ("clr __zero_reg__ \n\t"
+    (
+        "jmp 0 \n\t"
     );
+#endif
+} /* End of rtos_onStackOverflow */
+#endif
 
-    /* The implementation of this ISR makes use of the code of the task called routine
-       rtos_sendEvent. (Both routines need to be maintained in strict accordance.) That
-       function is executed with a constant parameter (r24/25) - the event mask just
-       containing the event which is posted by this interrupt. */
-    asm volatile
-    ( "ldi r24,lo8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
-      "ldi r25,hi8(" STR(RTOS_EVT_ISR_USER_00) ") \n\t"
-      "rjmp LabelEntrySetEventForISR \n\t"
-    );
-} /* End of ISR(RTOS_ISR_USER_00) */
 
-#endif /* RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON */
+
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/**
+ * Report that the active task is alive. The next check-in of the task is due within the
+ * period, which has been configured by rtos_setTaskLivenessPeriod. A task, which is not
+ * monitored, may call the function, too; the call has no effect.\n
+ *   Normally, a task checks in once per cycle, e.g. before it suspends till its next
+ * activation. A task, which blocks for long in a kernel call, e.g. while waiting for
+ * an event without timeout, needs a liveness period, which includes the blocking time.
+ *   @remark
+ * The function must be called from a task, not from an interrupt service routine.
+ */
+
+void rtos_checkInTask(void)
+{
+    /* The counter is decremented by the system timer interrupt. It has more than a single
+       byte if the system time has. */
+    cli();
+    _pActiveTask->cntLiveness = _pActiveTask->periodLiveness;
+    sei();
+
+} /* End of rtos_checkInTask */
 
 
 
 
-#if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
 /**
- * A conditionally compiled interrupt function. If #RTOS_USE_APPL_INTERRUPT_01 is set to
- * #RTOS_FEATURE_ON, this function implements an interrupt service routine, which posts
- * event #RTOS_EVT_ISR_USER_01 every time the interrupt occurs.\n
- *   See documentation of ISR for application interrupt 0 for more details.
+ * Check if the last reset was caused by a task, which missed its check-in. The record of
+ * the failure survives the reset in a RAM section, which is not initialized by the C
+ * runtime. Normally, the function is called from setup(), to report the failure or to
+ * start the system in a safe state.
+ *   @return
+ * Get true if the record of a liveness failure has been found. The record is deleted; the
+ * next call will return false.
+ *   @param pIdxTask
+ * If the function returns true, then the index of the failed task is returned in * \a
+ * pIdxTask. Otherwise the variable is not touched.
+ *   @remark
+ * The record is overwritten when the next liveness failure is recognized. The function
+ * can be called at any time, but normally it makes sense only prior to the start of the
+ * kernel.
  */
 
-ISR(RTOS_ISR_USER_01, ISR_NAKED)
+boolean rtos_getLivenessFailure(uint8_t *pIdxTask)
 {
-    /* The program counter as first element of the context is already on the stack (by
-       calling this function). Save rest of context onto the stack of the interrupted
-       active task. */
-    PUSH_CONTEXT_ONTO_STACK
+    boolean isFailure = false;
 
-	/* We must not exclude that the zero_reg is temporarily altered in the arbitrarily
-       interrupted code. To make the local code here running, we need to anticipate this
-       situation and clear the register. */
-    asm volatile
-    ("clr __zero_reg__ \n\t"
-    );
+    cli();
+    if(_livenessFailureRecord.magic == MAGIC_LIVENESS_FAILURE_RECORD
+       &&  _livenessFailureRecord.idxTask == (uint8_t)~_livenessFailureRecord.idxTaskInv
+       &&  _livenessFailureRecord.idxTask < RTOS_NO_TASKS
+      )
+    {
+        *pIdxTask = _livenessFailureRecord.idxTask;
+        isFailure = true;
+    }
+    _livenessFailureRecord.magic = 0;
+    sei();
 
-    /* The implementation of this ISR makes use of the code of the task called routine
-       rtos_sendEvent. (Both routines need to be maintained in strict accordance.) That
-       function is executed with a constant parameter (r24/25) - the event mask just
-       containing the event which is posted by this interrupt. */
-    asm volatile
-    ( "ldi r24,lo8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
-      "ldi r25,hi8(" STR(RTOS_EVT_ISR_USER_01) ") \n\t"
-      "rjmp LabelEntrySetEventForISR \n\t"
-    );
-} /* End of ISR(RTOS_ISR_USER_01) */
+    return isFailure;
 
-#endif /* RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON */
+} /* End of rtos_getLivenessFailure */
 
 
 
 
 /**
- * A task (including the idle task) may post an event. The event is broadcasted to all
- * suspended tasks which are waiting for it. An event is not saved beyond that. If a task
- * suspends and starts waiting for an event which has been posted by another task just
- * before, it'll wait forever and never be resumed.\n
- *   The posted event may resume another task, which may be of higher priority as the
- * event posting task. In this case \a sendEvent will cause a task switch. The calling task
- * stays due but stops to be the active task. It does not become suspended (this is why
- * even the idle task may call this function). The activated task will resume by coming out
- * of the suspend command it had been invoked to wait for this event. The return value of
- * this suspend command will then tell about the event set here.\n
- *   If no task of higher priority is resumed by the posted event the calling task will be
- * continued immediately after execution of this method. In this case \a sendEvent behaves
- * like any ordinary sub-routine.
- *   @param eventVec
- * A bit vector of posted events. Known events are defined in rtos.h. The timer events
- * RTOS_EVT_ABSOLUTE_TIMER and RTOS_EVT_DELAY_TIMER cannot be posted.
- *   @see
- * uint16_t rtos_waitForEvent(uint16_t, boolean, uintTime_t)
- *   @remark
- * It is absolutely essential that this routine is implemented as naked and noinline. See
- * http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html for details
- *   @remark
- * In optimization level 0 GCC has a problem with code generation for naked functions. See
- * function #rtos_suspendTaskTillTime for details.
+ * Callback, which is invoked by the system timer tic if a task missed its check-in.\n
+ *   This is the default implementation of the routine, which can be overloaded by the
+ * application code, e.g. to bring its outputs into a safe state before the reset. The
+ * failure has already been recorded for rtos_getLivenessFailure. The watchdog is no
+ * longer serviced and it resets the CPU after #RTOS_WATCHDOG_TIMEOUT; the default
+ * implementation does nothing. In the host simulation, which has no watchdog, it ends
+ * the process.
+ *   @param idxTask
+ * The index of the task, which missed its check-in.
  *   @remark
- * The implementation of this function is reused on machine code level by the
- * implementation of the application interrupt service routines \a ISR(RTOS_ISR_USER_nn).
- * This function needs to be maintained in strict accordance with the implementation of the
- * ISRs.
+ * The function is called from the system timer interrupt. The callback is invoked only
+ * once, for the first task, which has been found failing.
  */
-#ifndef __OPTIMIZE__
-# error This code must not be compiled with optimization off. See source code comments for more
-#endif
 
-RTOS_NAKED_FCT void rtos_sendEvent(uint16_t eventVec)
+RTOS_DEFAULT_FCT void rtos_onLivenessFailure(uint8_t idxTask)
 {
-    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
-       interrupt enable flag, we inhibit any interrupts now. */
-    asm volatile
-    ( "cli \n\t"
-    );
+#ifdef RTOS_HOST_SIMULATION
+    exit(EXIT_FAILURE);
+#endif
+} /* End of rtos_onLivenessFailure */
+#endif /* RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON */
 
-    /* The program counter as first element of the context is already on the stack (by
-       calling this function). Save rest of context onto the stack of the interrupted
-       active task. sendEvent does not return anything; we push register pair r24/25 and
-       this will be restored on function exit. */
-    PUSH_CONTEXT_ONTO_STACK
 
-    /* The next assembler statement has no direct impact but permits to jump on machine
-       code level into the middle of this function. The application ISRs make use of this:
-       They push the interrupted context, load the parameter register pair r24/25 with the
-       event they are assigned to and jump here to reuse the code for posting an event and
-       probably initiate a task switch. */
-    asm volatile
-    ( "LabelEntrySetEventForISR: \n\t"
-    );
 
-    /* Check for all suspended tasks if the posted events will resume them.
-         The actual implementation of the function's logic is placed into a sub-routine in
-       order to benefit from the compiler generated stack frame for local variables (in
-       this naked function we must not have declared any). */
-    if(sendEvent(eventVec))
-    {
-        /* Yes, another task becomes active because of the posted events. Switch the stack
-           pointer to the (saved) stack pointer of that task. */
-        SWITCH_CONTEXT
-        PUSH_RET_CODE_OF_CONTEXT_SWITCH
-    }
 
-    /* The stack pointer points to the now active task (which will often be still the same
-       as at function entry). The CPU context to continue with is popped from this stack. If
-       there's no change in active task the entire routine call is just like any ordinary
-       interrupt. */
-    POP_CONTEXT_FROM_STACK
+/**
+ * Get the index of the active task, i.e. of the calling task, if the function is called
+ * from task code.
+ *   @return
+ * The index of the task as used when initializing it, see rtos_initializeTask. The idle
+ * task has the index #RTOS_NO_TASKS.
+ *   @remark
+ * Some services need to know whether they are called by the idle task, which must never
+ * suspend.
+ */
 
-    /* The global interrupt enable flag is not saved across task switches, but always set
-       on entry into the new or same context by using a reti rather than a ret. */
-    asm volatile
-    ( "reti \n\t"
-    );
+uint8_t rtos_getIdxActiveTask(void)
+{
+    return getIdxTask(_pActiveTask);
 
-} /* End of rtos_sendEvent */
+} /* End of rtos_getIdxActiveTask */
 
 
 
 
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
 /**
- * This is a code pattern (inline function) which saves the resume condition of a task,
- * which is going to be suspended into its task object. This pattern is mainly used in the
- * suspend function rtos_waitForEvent but also at task initialization time, when the
- * initial task start condition is specified by the application code.
- *   @param pT
- * Pointer to the task object of the suspend task.
- *   @param eventMask
- * See function \a rtos_waitForEvent for details.
- *   @param all
- * See function \a rtos_waitForEvent for details.
- *   @param timeout
- * See function \a rtos_waitForEvent for details.
- *   @see
- * void rtos_waitForEvent(uint16_t, boolean, uintTime_t)
+ * Send the CPU to sleep until the next interrupt occurs. The sleep mode is configured by
+ * #RTOS_IDLE_SLEEP_MODE. The time spent in sleep mode is accumulated, see
+ * rtos_getIdleSleepTime.\n
+ *   The function is called by the kernel after each return from loop(). It may be called
+ * by the application code in loop() too, e.g. in a loop, which waits for a condition
+ * that is set by a task.
  *   @remark
- * For performance reasons this function needs to be inlined. A macro would be an
- * alternative.
+ * The function must be called from the idle task only. It is left with the interrupts
+ * enabled.
  */
 
-static inline void storeResumeCondition( task_t * const pT
-                                       , uint16_t eventMask
-                                       , boolean all
-                                       , uintTime_t timeout
-                                       )
+void rtos_idleSleep(void)
 {
-    /* Check event condition: It must not be empty. The two timers can't be used at the
-       same time (which is a rather harmless application design error) and at least one
-       other event needs to be required for a resume in case of the AND condition.
-         The latter bad situation leads to a crash. If all is set then RTuinOS interprets
-       the empty event mask as the always fulfilled resume condition. The task became due
-       without any bit set in the task's postedEventVec - which leads to a wrong state
-       transition in the kernel. (Please refer to the manual for a detail explanation of
-       the task state meaning of postedEventVec.) */
-    ASSERT(eventMask != 0
-           &&  (eventMask & MASK_EVT_IS_TIMER) != MASK_EVT_IS_TIMER
-           &&  (!all || (eventMask & ~MASK_EVT_IS_TIMER) != 0)
-          );
+    ASSERT(_pActiveTask == _pIdleTask);
 
-    /* The timing parameter may refer to different timers. Depending on the event mask we
-       either load the one or the other timer. Default is the less expensive delay
-       counter. */
-    if((eventMask & RTOS_EVT_ABSOLUTE_TIMER) != 0)
-    {
-        /* This suspend command wants a reactivation at a certain time. The new time is
-           assigned by the += in the conditional expression.
-             Task overrun detection: The new time must be no more than half a cycle in the
-           future. The test uses a signed comparison. The unsigned comparison >= 0x80 would be
-           equivalent but probably less performant (TBC). */
-        if((intTime_t)((pT->timeDueAt+=timeout) - _time) <= 0)
-        {
-            if(pT->cntOverrun < 0xff)
-                ++ pT->cntOverrun;
+    set_sleep_mode(RTOS_IDLE_SLEEP_MODE);
 
-            /* The wanted point in time is over. We do the best recovery which is possible: Let
-               the task become due in the very next timer tic.
-                 In specific situations, this can be counter productive - the application
-               may turn off this corrective action. See documentation: If the eight Bit
-               system timer and very slow, regular tasks are used there's a high risk of
-               seeing false overrun recognitions. Now making the task due immediately would
-               introduce a true error. */
-#if RTOS_OVERRUN_TASK_IS_IMMEDIATELY_DUE == RTOS_FEATURE_ON
-            pT->timeDueAt = _time+1;
-#endif
-        }
-    }
-    else
+    cli();
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+    /* A task, which has been made due by an interrupt, is activated by the next call of
+       rtos_yield. The CPU must not sleep till the next interrupt. */
+    if(_isReschedulePending)
     {
-        /* The timeout counter is reloaded. We could do this conditionally if the bit is
-           set, but in all normal use cases it'll and if not it doesn't harm. We will
-           just decrement the delay counter in onTimerTic once but not set the event.
-             ++ timeout: The call of the suspend function is in no way synchronized with the
-           system clock. We define the delay to be a minimum and implement the resolution
-           caused uncertainty as an additional delay. */
-        if((uintTime_t)(timeout+1) != 0)
-            ++ timeout;
-        pT->cntDelay = timeout;
+        sei();
+        return;
+    }
+#endif
+    {
+        _tiStartIdleSleep = micros();
+        _isIdleSleeping = true;
+        sleep_enable();
+    }
 
-    } /* if(Which timer is addressed for the timeout condition?) */
+    /* The instruction following sei is executed before any pending interrupt. An interrupt,
+       which occurs just now, will therefore wake up the CPU from sleep_cpu and can't get
+       lost. */
+    sei();
+    sleep_cpu();
 
-    pT->eventMask = eventMask;
-    pT->waitForAnyEvent = !all;
+    /* If a kernel interrupt had woken up the CPU then it has already done the accounting.
+       Otherwise it's done here. */
+    cli();
+    {
+        sleep_disable();
+        endIdleSleep();
+    }
+    sei();
+
+} /* End of rtos_idleSleep */
 
-} /* End of storeResumeCondition */
 
 
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
 /**
- * Waiting for events doesn't necessarily mean waiting: If the wait condition includes
- * mutexes and semaphores these may already be available on entry in the wait function.
- * This routine checks all demanded sync objects and locks and allocates all those objects
- * to the calling task, which are currently free.
+ * Get the time, which the CPU spent in sleep mode in rtos_idleSleep. The value is the sum
+ * of all sleep periods since reset or since the last call of this function with \a
+ * doReset set to true.\n
+ *   The function may be called from a task or from the idle task.
  *   @return
- * Finally the routine checks if the wait condition of the suspend command is already
- * fulfilled with the found sync objects. If and only if so it returns true and the suspend
- * command won't actually block the calling task.
- *   @param eventMask
- * See function \a rtos_waitForEvent for details.
- *   @param all
- * See function \a rtos_waitForEvent for details.
- *   @see
- * void rtos_waitForEvent(uint16_t, boolean, uintTime_t)
+ * Get the accumulated sleep time in microseconds. The counter wraps around after about
+ * 71 minutes. An application, which queries the time regularly and computes the
+ * difference to the previous value, is not affected by the wrap-around.
+ *   @param doReset
+ * Boolean flag, which tells whether to reset the value. Reading and resetting is an atomic
+ * operation.
  *   @remark
- * This function is inlined for performance reasons.
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
  */
 
-static inline boolean acquireFreeSyncObjs(uint16_t eventMask, boolean all)
+uint32_t rtos_getIdleSleepTime(boolean doReset)
 {
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    /* Check for immediate availability of all/any mutex. These mutexes are locked now and
-       entered in the calling task's postedEventVec. */
-    _pActiveTask->postedEventVec = eventMask & _mutexVec;
-
-    /* Lock the demanded mutexes. Bits in eventMask which do not correspond to mutex events
-       don't need to be masked. They may reset some anyway reset don't-care bits in
-       _mutexVec. */
-    _mutexVec &= ~eventMask;
-#endif
+    uint32_t tiIdleSleep;
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-    /* Check for immediate availability of all/any semaphores. The counters of none zero
-       semaphores are decremented now and the related acquired-bit is set in the calling
-       task's postedEventVec. */
-    uint8_t idxSem = 0
-          , maskSem = 0x01
-          , semaphoreToAcquireVec = eventMask & MASK_EVT_IS_SEMAPHORE;
-    while(semaphoreToAcquireVec)
+    cli();
     {
-        if((semaphoreToAcquireVec & 0x01) != 0)
-        {
-            if(rtos_semaphoreAry[idxSem] > 0)
-            {
-                -- rtos_semaphoreAry[idxSem];
-                _pActiveTask->postedEventVec |= maskSem;
-            }
-        }
-
-        /* Test next event bit and increment related index of semaphore in array. */
-        ++ idxSem;
-        maskSem <<= 1;
-        semaphoreToAcquireVec >>= 1;
+        tiIdleSleep = _tiIdleSleep;
+        if(doReset)
+            _tiIdleSleep = 0;
     }
-#endif
+    sei();
 
-    /* postedEventVec now contains all requested mutexes, which were currently available.
-       If these were all demanded events, we don't need to suspend the task but can
-       immediately and successfully return. The timer bits (events 14 and 15) don't matter
-       as they are always OR terms. We definitely don't need to wait for them. */
-    return (!all &&  _pActiveTask->postedEventVec != 0)
-           || (all &&  ((_pActiveTask->postedEventVec ^ eventMask) & ~MASK_EVT_IS_TIMER) == 0);
+    return tiIdleSleep;
 
-} /* End of acquireFreeSyncObjs */
+} /* End of rtos_getIdleSleepTime */
+#endif /* RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON */
 
-#endif /* RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON */
 
 
 
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
 /**
- * Actual implementation of task suspension routine \a rtos_waitForEvent. The task is
- * suspended until a specified event occurs.\n
- *   The action of this SW interrupt is placed into an own function in order to let the
- * compiler generate the stack frame required for all local data. (The stack frame
- * generation of the SW interrupt entry point needs to be inhibited in order to permit the
- * implementation of saving/restoring the task context).
+ * Get the time, which a task has been the active task. The kernel accumulates the time
+ * between the task switches, the value is updated at every task switch and when calling
+ * this function.\n
+ *   The function may be called from a task or from the idle task.
  *   @return
- * If mutex or semaphores are in use the function returns the Boolean information whether
- * the calling task has to be suspended. This is not the case if all demanded sync objects
- * are currently available. If RTuinOS is compiled without support of mutexes and
- * sempahores than the calling task is always suspended.\n
- *   By means of side effects, the function returns which task is to be activated and records
- * which task is left (i.e. the task calling this routine) in the global variables \a
- * _pActiveTask and \a _pSuspendedTask.
- *   @param eventMask
- * See software interrupt \a rtos_waitForEvent.
- *   @param all
- * See software interrupt \a rtos_waitForEvent.
- *   @param timeout
- * See software interrupt \a rtos_waitForEvent.
- *   @see
- * uint16_t rtos_waitForEvent(uint16_t, boolean, uintTime_t)
+ * Get the accumulated runtime of the task in microseconds. The counter wraps around after
+ * about 71 minutes. An application, which queries the time regularly and computes the
+ * difference to the previous value, is not affected by the wrap-around.
+ *   @param idxTask
+ * The index of the task the runtime of which is to be returned. The index is the same as
+ * used when initializing the tasks (see rtos_initializeTask). Pass #RTOS_NO_TASKS to get
+ * the runtime of the idle task.
+ *   @param doReset
+ * Boolean flag, which tells whether to reset the value. Reading and resetting is an atomic
+ * operation.
  *   @remark
- * This function and particularly passing the return codes via a global variable will
- * operate only if all interrupts are disabled.
+ * The time spent in interrupt service routines is accounted to the task, which is
+ * interrupted.
+ *   @remark
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
  */
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-static RTOS_TRUE_FCT boolean waitForEvent( uint16_t eventMask
-                                           , boolean all
-                                           , uintTime_t timeout
-                                           )
-#else
-static RTOS_TRUE_FCT void waitForEvent(uint16_t eventMask, boolean all, uintTime_t timeout)
-#endif
-
+uint32_t rtos_getTaskRuntime(uint8_t idxTask, boolean doReset)
 {
-    /* Avoid inlining under all circumstances. See attributes also. */
-    asm("");
+    ASSERT(idxTask <= RTOS_NO_TASKS);
+    task_t * const pT = &_taskAry[idxTask].task;
+    uint32_t tiRuntime;
 
-    /* Here, we could double-check _pActiveTask for the idle task and return without
-       context switch if it is active. (The idle task has illicitly called a suspend
-       command.) However, all implementation rates performance higher than failure
-       tolerance, and so do we here. */
-    ASSERT(_pActiveTask != _pIdleTask);
+    cli();
+    {
+        /* Let the result include the time since the last task switch if the queried task is
+           the active one. */
+        if(pT == _pActiveTask)
+            accountTaskRuntime(pT);
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    if(acquireFreeSyncObjs(eventMask, all))
-        return false;
-#endif
+        tiRuntime = pT->tiRuntime;
+        if(doReset)
+        {
+            pT->tiRuntime = 0;
 
-    int8_t idxPrio;
-    int8_t idxTask;
+            /* The load window of rtos_getCpuLoad refers to the idle task's runtime. */
+            if(pT == _pIdleTask)
+                _tiIdleAtStartCpuLoadWindow = 0;
+        }
+    }
+    sei();
 
-    /* Take the active task out of the list of due tasks. */
-    task_t * const pT = _pActiveTask;
-    uint8_t prio = pT->prioClass;
-    uint8_t noDueNow = -- _noDueTasksAry[prio];
-    for(idxTask=0; idxTask<noDueNow; ++idxTask)
-        _pDueTaskAryAry[prio][idxTask] = _pDueTaskAryAry[prio][idxTask+1];
+    return tiRuntime;
 
-    /* This suspend command wants a reactivation by a combination of events (which may
-       include the timeout event). Save the resume condition in the task object. The
-       operation is implemented as inline function to be able to reuse the code in the
-       task initialization routine. */
-    storeResumeCondition(pT, eventMask, all, timeout);
+} /* End of rtos_getTaskRuntime */
 
-    /* Put the task in the list of suspended tasks. If mutexes or semaphores are in use
-       this list is sorted with decreasing priority. */
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    /* < rather than <=: The now suspended task becomes the last one in its prio class. The
-       others of same priority are waiting longer and will receive a later posted event
-       with priority. */
-    int8_t idxPos;
-    for(idxPos=0; idxPos<_noSuspendedTasks; ++idxPos)
-        if(_pSuspendedTaskAry[idxPos]->prioClass < prio)
-            break;
 
-    /* Shift rest of the list one to the end. This loop requires a signed index. */
-    for(idxTask=_noSuspendedTasks++ - 1; idxTask>=idxPos; --idxTask)
-        _pSuspendedTaskAry[idxTask+1] = _pSuspendedTaskAry[idxTask];
 
-    /* Insert the suspended task at the priority determined right position. */
-    _pSuspendedTaskAry[idxPos] = pT;
-#else
-    _pSuspendedTaskAry[_noSuspendedTasks++] = pT;
-#endif
 
-    /* Record which task suspends itself for the assembly code in the calling function
-       which actually switches the context. */
-    _pSuspendedTask = _pActiveTask;
+/**
+ * Get the CPU load. The load is the portion of world time, which the CPU did not spend in
+ * the idle task. It is computed from the runtime counters, which are continuously
+ * maintained by the kernel, so the function is cheap and may be called at any time.
+ * Averaging is done in the time window since the last reset of the measurement, see
+ * parameter \a doReset.\n
+ *   The function may be called from a task or from the idle task.
+ *   @return
+ * The system load is returned with a resolution 0.5%, i.e. as an integer number in the
+ * range 0..200.
+ *   @param doReset
+ * If true, a new measurement window starts after reading the value. An application will
+ * typically call the function regularly, e.g. once a second, with \a doReset = true. The
+ * window must not be longer than about 35 minutes.
+ *   @remark
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
+ */
 
-    /* Look for the task we will return to. It's the first entry in the highest non-empty
-       priority class. The loop requires a signed index.
-         It's not guaranteed that there is any due task. Idle is the fallback. */
-    _pActiveTask = _pIdleTask;
-    for(idxPrio=RTOS_NO_PRIO_CLASSES-1; idxPrio>=0; --idxPrio)
+uint8_t rtos_getCpuLoad(boolean doReset)
+{
+    uint32_t tiElapsed, tiIdle;
+
+    cli();
     {
-        if(_noDueTasksAry[idxPrio] > 0)
+        if(_pActiveTask == _pIdleTask)
+            accountTaskRuntime(_pIdleTask);
+
+        const uint32_t tiNow = micros();
+        tiElapsed = tiNow - _tiStartCpuLoadWindow;
+        tiIdle = _pIdleTask->tiRuntime - _tiIdleAtStartCpuLoadWindow;
+        if(doReset)
         {
-            _pActiveTask = _pDueTaskAryAry[idxPrio][0];
-            break;
+            _tiStartCpuLoadWindow = tiNow;
+            _tiIdleAtStartCpuLoadWindow = _pIdleTask->tiRuntime;
         }
     }
+    sei();
 
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    return true;
-#endif
-} /* End of waitForEvent */
+    /* The multiplication by 200 must not overflow. Reduce the resolution of the time
+       values as far as necessary. */
+    while(tiElapsed > 0xffffffff/200)
+    {
+        tiElapsed >>= 1;
+        tiIdle >>= 1;
+    }
 
+    if(tiIdle >= tiElapsed)
+        return 0;
+    else
+        return 200 - (uint8_t)(200*tiIdle/tiElapsed);
+
+} /* End of rtos_getCpuLoad */
+#endif /* RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON */
 
 
 
+
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
 /**
- * Suspend the current task (i.e. the one which invokes this method) until a specified
- * combination of events occur. In the special case, that the specified combination of
- * events can be satisfied with currently available synchronization objects (mutexes and
- * semaphores) the function will return immediately without suspending the calling task.\n
- *   A task is suspended in the instance of calling this method. It specifies a list of
- * events. The task becomes due again, when either the first one or all of the specified
- * events have been posted by other tasks.\n
- *   The idle task can't be suspended. If it calls this function a crash would be the
- * immediate result.
- *   @return
- * The set of actually resuming events is returned as a bit vector which corresponds
- * bitwise to eventMask. See \a rtos.h for a list of known events.
- *   @param eventMask
- * The bit vector of events to wait for. Needs to include either the delay timer event
- * #RTOS_EVT_DELAY_TIMER or #RTOS_EVT_ABSOLUTE_TIMER, if a timeout is required, but not both
- * of them.\n
- *   The normal use case will probably be the delay timer. However, a regular task may also
- * specify the absolute timer with the next regular task time as parameter so that it
- * surely becomes due outermost at its usual task time.
- *   @param all
- *   If false, the task is made due as soon as the first event mentioned in \a eventMask is
- * seen.\n
- *   If true, the task is made due only when all events are posted to the suspending task -
- * except for the timer events, which are still OR combined. If you say "all" but the event
- * mask contains either #RTOS_EVT_DELAY_TIMER or #RTOS_EVT_ABSOLUTE_TIMER, the task will
- * resume when either the timer elapsed or when all other events in the mask were seen.\n
- *   Caution: If all is true, there need to be at least one event bit set in \a eventMask
- * besides a timer bit; RTuinOS crashes otherwise. Saying: "No particular event, just a
- * timer condition" needs to be implemented by \a all set to false and \a eventMask set to
- * only a timer event bit.
- *   @param timeout
- * If \a eventMask contains #RTOS_EVT_DELAY_TIMER:\n
- *   The number of system timer tics from now on until the timeout elapses. One should be
- * aware of the resolution of any timing being the tic of the system timer. A timeout of \a
- * n may actually mean any delay in the range \a n .. \a n+1 tics.\n
- *   Even specifying 0 will suspend the task a short time and give others the chance to
- * become active - particularly other tasks belonging to the same priority class.\n
- *   If \a eventMask contains #RTOS_EVT_ABSOLUTE_TIMER:\n
- *   The absolute time the task becomes due again at latest. The time designation is
- * relative; it refers to the last recent absolute time at which this task had been
- * resumed. See #rtos_suspendTaskTillTime for details.\n
- *   Now the range of the parameter is 1 till the half the range of the data type which is
- * configured for the system time, e.g. 127 in case of uint8_t. Otherwise proper task
- * timing can't be guaranteed.\n
- *   If neither #RTOS_EVT_DELAY_TIMER nor #RTOS_EVT_ABSOLUTE_TIMER is set in the event mask,
- * this parameter should be zero.
+ * Get the timing statistics of a task. The kernel takes the world time when the task is
+ * released, i.e. when it becomes due after suspension, when it becomes active the first
+ * time after the release and when it suspends again. Two durations are derived:\n
+ *   The start latency is the time from release till the first activation. It is mainly
+ * determined by the tasks of higher priority and by the interrupts.\n
+ *   The execution time is the time from the first activation till the task suspends
+ * again. It includes the time of preemption by tasks of higher priority and by
+ * interrupts. For a regular task, the sum of start latency and execution time needs to be
+ * less than the task period; the maxima tell the margin.\n
+ *   The function may be called from a task or from the idle task.
+ *   @param idxTask
+ * The index of the task the statistics of which are to be returned. The index is the same
+ * as used when initializing the tasks (see rtos_initializeTask).
+ *   @param pStartLatency
+ * The statistics of the start latency are returned in * \a pStartLatency. Pass NULL if
+ * not needed.
+ *   @param pExecutionTime
+ * The statistics of the execution time are returned in * \a pExecutionTime. Pass NULL if
+ * not needed.
+ *   @param doReset
+ * Boolean flag, which tells whether to reset the statistics. Reading and resetting is an
+ * atomic operation.
+ *   @remark
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
+ *   @see
+ * uint8_t rtos_getTaskOverrunCounter(uint8_t, boolean)
  */
- 
-RTOS_NAKED_FCT uint16_t rtos_waitForEvent( uint16_t eventMask
-                                         , boolean all
-                                         , uintTime_t timeout
-                                         )
-{
-    /* It is absolutely essential that this routine is implemented as naked and noinline.
-       See http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html for details.
-         GCC doesn't create a stack frame for naked functions. For normal functions, the
-       calling parameter of the function is stored in such a stack frame. In the
-       combination naked and having local function parameters, GCC has a problem when
-       generating code without optimization: It doesn't generate a stack frame but still
-       does save the local parameter into the (not existing) stack frame as very first
-       assembly operation of the function code. There's absolutely no work around; when the
-       earliest code, we can write inside the function is executed, the stack is already
-       corrupted in a hazardous way. A crash is unavoidable.
-         A discussion of the issue can be found at
-       http://lists.gnu.org/archive/html/avr-gcc-list/2012-08/msg00014.html.
-         To avoid this problem we forbid to compile the code with optimization off.
-       Nonetheless, who will ever know or understand under which circumstances, e.g. which
-       combination of optimization flags, GCC will again generate this crash-code. This
-       issue remains a severe risk! Consequently, at any change of a compiler setting you
-       will need to inspect the assembly listing file and double-check that it is proper
-       with respect of using (better not using) the stack frame for this function (and
-       rtos_sendEvent).
-         Another idea would be the implementation of this function completely in assembly
-       code. Doing so, we have the new problem of calling assembly code as C functions.
-       Find an example of how to do in
-       file:///M:/SVNMainRepository/Arduino/RTuinOS/trunk/RTuinOS/code/RTOS/rtos.c,
-       revision 215. */
-#ifndef __OPTIMIZE__
-# error This code must not be compiled with optimization off. See source code comments for more
-#endif
-
-    /* This function is a pseudo-software interrupt. A true interrupt had reset the global
-       interrupt enable flag, we inhibit any interrupts now. */
-    asm volatile
-    ( "cli \n\t"
-    );
 
-    /* The program counter as first element of the context is already on the stack (by
-       calling this function). Save rest of context onto the stack of the interrupted
-       active task. */
-    PUSH_CONTEXT_WITHOUT_R24R25_ONTO_STACK
+void rtos_getTaskTimingStatistics( uint8_t idxTask
+                                 , rtos_timingStatistics_t *pStartLatency
+                                 , rtos_timingStatistics_t *pExecutionTime
+                                 , boolean doReset
+                                 )
+{
+    ASSERT(idxTask < RTOS_NO_TASKS);
+    task_t * const pT = &_taskAry[idxTask].task;
 
-    /* The actual implementation of the task switch logic is placed into a sub-routine in
-       order to benefit from the compiler generated stack frame for local variables (in
-       this naked function we must not have declared any). The call of the function is
-       immediately followed by some assembly code which computes the return value of the
-       function and places it in register pair r24/25. */
-#if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON  ||  RTOS_USE_MUTEX == RTOS_FEATURE_ON
-    if(waitForEvent(eventMask, all, timeout))
-#else
-    waitForEvent(eventMask, all, timeout);
-#endif
+    cli();
     {
-        /* The wait condition couldn't be fulfilled immediately, we need to suspend the
-           task. Switch the stack pointer to the (saved) stack pointer of the new active
-           task. */
-        SWITCH_CONTEXT
+        getTimingStatistics(pStartLatency, &pT->statStartLatency, doReset);
+        getTimingStatistics(pExecutionTime, &pT->statExecutionTime, doReset);
     }
+    sei();
 
-     /* Regardless whether we had switched the task the suspend command ends with returning
-        the information about the task releasing events. Push this function result onto the
-        (maybe new) stack - from where it is loaded into r24/r25 by the subsequent pop-context
-        command. */
-    PUSH_RET_CODE_OF_CONTEXT_SWITCH
+} /* End of rtos_getTaskTimingStatistics */
+#endif /* RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON */
 
-    /* The stack pointer points to the now active task (which may be still the same as at
-       function entry). The CPU context to continue with is popped from this stack. If
-       there's no change in active task the entire routine call is just like any ordinary
-       interrupt. */
-    POP_CONTEXT_FROM_STACK
 
-    /* The global interrupt enable flag is not saved across task switches, but always set
-       on entry into the new or same context by using a reti rather than a ret. */
-    asm volatile
-    ( "reti \n\t"
-    );
 
-    /* This statement is never reached. Just to avoid the warning. */
-    return 0;
 
-} /* End of rtos_waitForEvent */
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/**
+ * Get the histogram of the latencies of an application interrupt. The latency is the time
+ * from the entry into the interrupt service routine till the task, which is resumed by
+ * the posted event #RTOS_EVT_ISR_USER_00 or #RTOS_EVT_ISR_USER_01, becomes active. The
+ * entry is time stamped after saving the context of the interrupted task and the end is
+ * time stamped before the context of the resumed task is restored. The time, which the
+ * CPU needs to react on the interrupt request and to save and restore the contexts, is not
+ * included: some 10 CPU clock cycles in total.\n
+ *   The function may be called from a task or from the idle task.
+ *   @param idxInterrupt
+ * The index of the application interrupt, 0 for #RTOS_ISR_USER_00 or 1 for
+ * #RTOS_ISR_USER_01.
+ *   @param pHistogram
+ * The histogram is returned in * \a pHistogram.
+ *   @param doReset
+ * Boolean flag, which tells whether to reset the histogram. Reading and resetting is an
+ * atomic operation.
+ *   @remark
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
+ */
 
+void rtos_getIsrLatencyHistogram( uint8_t idxInterrupt
+                                , rtos_isrLatencyHistogram_t *pHistogram
+                                , boolean doReset
+                                )
+{
+    ASSERT(idxInterrupt < 2);
+    rtos_isrLatencyHistogram_t * const pH = &_isrLatencyHistogramAry[idxInterrupt];
 
+    cli();
+    {
+        *pHistogram = *pH;
+        if(doReset)
+            memset(pH, 0, sizeof(*pH));
+    }
+    sei();
 
+} /* End of rtos_getIsrLatencyHistogram */
+#endif /* RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON */
 
 
 
 
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
 /**
- * Get the current value of the overrun counter of a given task.\n
- *   The value is a limited 8 Bit counter (i.e. it won't cycle around). This is considered
- * satisfying as any task overrun is a kind of error and should not happen in a real
- * application (with other words: even a Boolean information could be enough). Furthermore,
- * if a larger range is required, one can regularly ask for this information, accumulate it
- * and reset the value here to zero at the same time.\n
- *   The function may be called from a task or from the idle task.
+ * Get a timestamp with microsecond resolution. The timestamp combines the count of system
+ * timer tics with the current count of timer 2, which clocks the system timer.\n
+ *   The narrow, cyclic system time, which is used for scheduling, is not affected. The
+ * function may be called from any task, the idle task and from interrupts.
  *   @return
- * Get the current value of the overrun counter.
- *   @param idxTask
- * The index of the task the overrun counter of which is to be returned. The index is the
- * same as used when initializing the tasks (see rtos_initializeTask).
- *   @param doReset
- * Boolean flag, which tells whether to reset the value.\n
- *   Caution, when setting this to true, reading and resetting the value needs to become an
- * atomic operation, which requires a critical section. This is significantly more
- * expensive than just reading the value and it globally enables the interrupts finally.
- * Therefore this call may destroy a surrounding critical section.
+ * Get the time since start of the kernel in microseconds. The resolution is 4 us in the
+ * standard configuration and 8 us if #RTOS_USE_TICKLESS_IDLE is set. The value doesn't
+ * wrap around in practice; only the counter of tics wraps around after about 101 days.
  *   @remark
- * This function has some limitations and weaknesses: First of all, the concept of task
- * overruns is defined only for regular tasks. Secondary, and particularly when using the 8
- * Bit system timer, there's a significant probability of not recognizing huge task
- * overruns. Finally there's a significant probability of false recognitions of (not
- * happening) task overruns if the task period time is greater than half the system timer's
- * cycle time (i.e. greater than 127 for the 8 Bit system timer). Please, refer to the
- * RTuinOS manual for details.
- *   @see
- * void rtos_initializeTask()
+ * The function requires the default configuration of the system timer, see
+ * rtos_enableIRQTimerTic. An application, which uses another interrupt source, must not
+ * use this function.
+ *   @remark
+ * In the standard configuration, timer 2 counts up and down. The direction can't be seen
+ * from a single counter value and the function waits for the next count. This takes up to
+ * 64 CPU clock cycles.
+ *   @remark
+ * The function contains a critical section and globally enables the interrupts finally.
+ * Therefore this call may destroy a surrounding critical section.
  */
 
-uint8_t rtos_getTaskOverrunCounter(uint8_t idxTask, boolean doReset)
+uint64_t rtos_getTimestamp(void)
 {
-    if(doReset)
+    uint32_t noTics;
+    uint16_t tiSinceTic;
+
+    cli();
     {
-        uint8_t retCode
-              , * const pCntOverrun = &_taskAry[idxTask].cntOverrun;
+        noTics = _noTicsTimestamp;
 
-        /* Read and reset should be atomic for data consistency if the application wants to
-           accumulate the counter values in order to extend the counter's range. */
-        cli();
+# if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+        /* Timer 2 counts up in normal mode. The overflow is the end of the tic. If the
+           overflow flag is set and the counter is still low then the interrupt of this
+           overflow is pending and the tic has not been counted yet. */
+        const uint8_t cnt = TCNT2;
+        const boolean isTicPending = (TIFR2 & _BV(TOV2)) != 0  &&  cnt < 128;
+
+        if(_isTicklessPeriod)
         {
-            retCode = *pCntOverrun;
-            *pCntOverrun = 0;
+            /* One count of the reduced clock means eight counts of the normal clock. The
+               counts, which were truncated at the beginning of the tickless period, are
+               added. The pending interrupt completes all tics of the period. */
+            tiSinceTic = (((uint16_t)cnt << 3) + _ticklessPhaseRemainder) << 3;
+            if(isTicPending)
+                noTics += TICKLESS_NO_TICS_PER_PERIOD;
         }
-        sei();
+        else
+        {
+            /* One count is 8 us. */
+            tiSinceTic = (uint16_t)cnt << 3;
+            if(isTicPending)
+                ++ noTics;
+        }
+# else
+        /* Timer 2 counts from 0 till 255 and back to 0 in phase correct PWM mode. The tic
+           interrupt is triggered at the bottom. We wait for the next count in order to
+           see the direction. One count is 4 us. */
+        const uint8_t cntBefore = TCNT2;
+        uint8_t cnt;
+        while((cnt = TCNT2) == cntBefore)
+            ;
+        if(cnt > cntBefore)
+        {
+            tiSinceTic = (uint16_t)cnt << 2;
 
-        return retCode;
-    }
-    else
-    {
-        /* Reading an 8 Bit word is an atomic operation as such, no additional lock
-           operation needed. */
-        return _taskAry[idxTask].cntOverrun;
+            /* If the overflow flag is set while counting up then the interrupt of this
+               overflow is pending and the tic has not been counted yet. */
+            if((TIFR2 & _BV(TOV2)) != 0)
+                ++ noTics;
+        }
+        else
+            tiSinceTic = (510u - cnt) << 2;
+# endif
     }
-} /* End of rtos_getTaskOverrunCounter */
+    sei();
+
+    return (uint64_t)noTics * TIMESTAMP_US_PER_TIC + tiSinceTic;
+
+} /* End of rtos_getTimestamp */
+#endif /* RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON */
 
 
 
 
 /**
- * Compute how many bytes of the stack area of a task are still unused. If the value is
- * requested after an application has been run a long while and has been forced to run
- * through all its paths many times, it may be used to optimize the static stack allocation
- * of the task. The function is useful only for diagnosis purpose as there's no chance to
- * dynamically increase or decrease the stack area at runtime.\n
- *   The function may be called from a task or from the idle task.\n
- *   The algorithm is as follows: The unused part of the stack is initialized with a
- * specific pattern byte. This routine counts the number of subsequent pattern bytes down
- * from the top of the stack area. This number is returned.\n
- *   The returned result must not be trusted too much: It could of course be that a pattern
- * byte is found not because of the initialization but because it has been pushed onto the
- * stack - in which case the return value is too great (too optimistic) by one. The
- * probability that this happens is significantly greater than zero. The chance that two
- * pattern bytes had been pushed is however much less and the probability of three, four,
- * five such bytes in sequence is negligible. (Except the irrelevant case you initialize
- * an automatic array variable with all pattern bytes.) Any stack size optimization based
- * on this routine should therefore subtract e.g. five bytes from the returned reserve and
- * diminish the stack outermost by this modified value.\n
- *   Be careful with stack size optimization based on this routine: Even if the application
- * ran a long time there's a non-zero probability that there has not yet been a system
- * timer interrupt in the very instance that the code of the task of interest was busy in
- * the deepest nested sub-routine, i.e. when having the largest stack consumption. A good
- * suggestion is to have another 36 Byte of reserve - this is the stack consumption if an
- * interrupt occurs.\n
- *   Recipe: Run your application a long time, ensure that it ran through all paths, get
- * the stack reserve from this routine, subtract 5+36 Byte and diminish the stack by this
- * value.
- *   @return
- * The number of still unused stack bytes. See function description for details.
+ * Initialize the runtime data of a single task object from the settings of the
+ * application.
  *   @param idxTask
- * The index of the task the stack usage has to be investigated for. The index is the
- * same as used when initializing the tasks (see rtos_initializeTask).
- *   @remark
- * The computation is a linear search for the first non-pattern byte and thus relatively
- * expensive. It's suggested to call it only in some specific diagnosis compilation or
- * occasionally from the idle task.
- *   @see
- * void rtos_initializeTask()
+ * The index of the task in the range 0..RTOS_NO_TASKS-1.
+ *   @param prioClass
+ * The priority class, see rtos_initializeTask.
+ *   @param timeRoundRobin
+ * The maximum time slice in round robin mode, see rtos_initializeTask. This parameter is
+ * available only if #RTOS_ROUND_ROBIN_MODE_SUPPORTED is set to #RTOS_FEATURE_ON.
+ *   @param startEventMask
+ * The start condition, see rtos_initializeTask.
+ *   @param startByAllEvents
+ * The start condition, see rtos_initializeTask.
+ *   @param startTimeout
+ * The start condition, see rtos_initializeTask.
  */
 
-uint16_t rtos_getStackReserve(uint8_t idxTask)
+static void initializeTaskObject( uint8_t idxTask
+                                , uint8_t prioClass
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                                , uintTime_t timeRoundRobin
+#endif
+                                , uintEventVec_t startEventMask
+                                , boolean startByAllEvents
+                                , uintTime_t startTimeout
+                                )
 {
-    uint8_t *sp = _taskAry[idxTask].pStackArea;
+    task_t * const pT = &_taskAry[idxTask].task;
 
-    /* The bottom of the stack is always initialized with 0, which must not be the pattern
-       byte. Therefore we don't need a limitation of the search loop - it'll always find a
-       non-pattern byte in the stack area. */
-    while(*sp == UNUSED_STACK_PATTERN)
-        ++ sp;
+    /* To which priority class does the task belong? */
+    pT->prioClass = prioClass;
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+    pT->prioClassBase = prioClass;
+#endif
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+    pT->idxTask = idxTask;
+#endif
 
-    return sp - _taskAry[idxTask].pStackArea;
+    /* Set the start condition. */
+    ASSERT(startEventMask != 0);
 
-} /* End of rtos_getStackReserve */
+    /* Start condition "wait for sync object" is not implemented. */
+#if RTOS_USE_MUTEX == RTOS_FEATURE_ON  ||  RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
+    ASSERT((startEventMask & (MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE)) == 0);
+#endif
+
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_OFF
+    pT->cntDelay = 0;
+#endif
+    pT->timeDueAt = 0;
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+    /* A task is not periodic until rtos_setTaskPeriod is called. */
+    pT->period = 0;
+#endif
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+    /* A task has no CPU budget until rtos_setTaskBudget is called. */
+    pT->budget = 0;
+    pT->cntBudget = 0;
+    pT->prioClassBudget = prioClass;
+#endif
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+    /* A task is not monitored until rtos_setTaskLivenessPeriod is called. */
+    pT->periodLiveness = 0;
+    pT->cntLiveness = 0;
+#endif
+    storeResumeCondition(pT, startEventMask, startByAllEvents, startTimeout);
+
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+    /* Notifications, which are posted before the task waits for them, are latched. */
+    pT->notificationVec = 0;
+    pT->notificationMask = 0;
+#endif
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+    pT->parkState = PARK_STATE_NONE;
+#endif
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    pT->tiRuntime = 0;
+#endif
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+    pT->statStartLatency.noSamples = 0;
+    pT->statStartLatency.tiSum = 0;
+    pT->statExecutionTime.noSamples = 0;
+    pT->statExecutionTime.tiSum = 0;
+#endif
+
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+    /* The maximum execution time in round robin mode. Round robin would destroy the order
+       of the due list of the class, which is scheduled earliest deadline first. */
+# if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    ASSERT(prioClass != RTOS_EDF_PRIO_CLASS  ||  timeRoundRobin == 0);
+# endif
+    pT->timeRoundRobin = timeRoundRobin;
+#endif
 
+} /* End of initializeTaskObject */
 
 
 
+
+#ifndef RTOS_TASK_TABLE
 /**
  * Initialize the contents of a single task object.\n
  *   This routine needs to be called from within setup() once for each task. The number of
@@ -1889,7 +6854,7 @@ uint16_t rtos_getStackReserve(uint8_t idxTask)
  * the task will not be activated by a time condition. Do not set both timer events at
  * once! See rtos_waitForEvent for details.
  *   @see void rtos_initRTOS(void)
- *   @see uint16_t rtos_waitForEvent(uint16_t, boolean, uintTime_t)
+ *   @see uintEventVec_t rtos_waitForEvent(uintEventVec_t, boolean, uintTime_t)
  *   @remark
  * The restriction that the initial resume condition must not comprise the request for mutex
  * or semaphore kind of events has been made just for simplicity. No additional code is
@@ -1909,39 +6874,181 @@ void rtos_initializeTask( uint8_t idxTask
 #endif
                         , uint8_t * const pStackArea
                         , uint16_t stackSize
-                        , uint16_t startEventMask
+                        , uintEventVec_t startEventMask
                         , boolean startByAllEvents
                         , uintTime_t startTimeout
                         )
 {
-    task_t * const pT = &_taskAry[idxTask];
+#if RTOS_NO_TASKS > 0
+    taskDescriptor_t * const pTD = &_taskDescriptorAry[idxTask];
 
     /* Remember task function and stack allocation. */
-    pT->taskFunction = taskFunction;
-    pT->pStackArea   = pStackArea;
-    pT->stackSize    = stackSize;
+    pTD->taskFunction = taskFunction;
+    pTD->pStackArea   = pStackArea;
+    pTD->stackSize    = stackSize;
+#else
+    /* There's no task, which the index could designate. */
+    ASSERT(false);
+#endif
 
-    /* To which priority class does the task belong? */
-    pT->prioClass = prioClass;
+    initializeTaskObject( idxTask
+                        , prioClass
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                        , timeRoundRobin
+#endif
+                        , startEventMask
+                        , startByAllEvents
+                        , startTimeout
+                        );
+} /* End of rtos_initializeTask */
+#endif /* RTOS_TASK_TABLE */
 
-    /* Set the start condition. */
-    ASSERT(startEventMask != 0);
 
-    /* Start condition "wait for sync object" is not implemented. */
-#if RTOS_USE_MUTEX == RTOS_FEATURE_ON  ||  RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
-    ASSERT((startEventMask & (MASK_EVT_IS_MUTEX | MASK_EVT_IS_SEMAPHORE)) == 0);
-#endif
 
+
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+/**
+ * Declare a task a periodic task. The kernel releases the task on a fixed grid: at the
+ * phase offset and then once per period. The task waits for its next release with
+ * rtos_waitForNextPeriod (or any call of rtos_waitForEvent with #RTOS_EVT_ABSOLUTE_TIMER,
+ * whose timeout is ignored); it doesn't need to state its timing in each cycle and the
+ * release times don't drift.\n
+ *   This function needs to be called from within setup(), after the task has been
+ * initialized by rtos_initializeTask or by the task table #RTOS_TASK_TABLE. The start
+ * condition of the task is replaced by the release at the phase offset.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1.
+ *   @param period
+ * The period in system timer tics. The range is 1..max(intTime_t), i.e. less than half
+ * the range of the system time.
+ *   @param phase
+ * The point in time of the first release in system timer tics after start of the kernel,
+ * 0 is the very first tic. Different phase offsets of tasks with same or harmonic periods
+ * avoid that they become due in the same tic.
+ *   @param overrunPolicy
+ * If a task completes an activation only after the next release, then the overrun
+ * counter of the task is incremented (see rtos_getTaskOverrunCounter) and the policy
+ * decides when the task is resumed:\n
+ *   #RTOS_OVERRUN_POLICY_IMMEDIATE: The task is resumed in the next tic and the grid is
+ * shifted to this point in time. This is what rtos_suspendTaskTillTime does.\n
+ *   #RTOS_OVERRUN_POLICY_SKIP: The missed activations are dropped. The task is resumed at
+ * the next point in time on its grid, which is still ahead.\n
+ *   #RTOS_OVERRUN_POLICY_CATCH_UP: No activation is lost. The task is resumed in the next
+ * tic and then in every tic until it has caught up with its grid. It needs to be faster
+ * than its period on average.
+ */
+
+void rtos_setTaskPeriod( uint8_t idxTask
+                       , uintTime_t period
+                       , uintTime_t phase
+                       , uint8_t overrunPolicy
+                       )
+{
+    ASSERT(idxTask < RTOS_NO_TASKS  &&  (intTime_t)period > 0
+           &&  overrunPolicy <= RTOS_OVERRUN_POLICY_CATCH_UP
+          );
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    /* Withdraw the start condition of the task. */
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+    if((pT->eventMask & MASK_EVT_IS_TIMER) != 0)
+        unlinkTimeout(pT);
+#endif
+#if RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+    unlinkWaitingTask(pT);
+#endif
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_OFF
     pT->cntDelay = 0;
-    pT->timeDueAt = 0;
-    storeResumeCondition(pT, startEventMask, startByAllEvents, startTimeout);
+#endif
 
-#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
-    /* The maximum execution time in round robin mode. */
-    pT->timeRoundRobin = timeRoundRobin;
+    /* The first release is one period before the phase offset; the start condition is
+       then stored in the same way as the resume condition at the end of each cycle. */
+    pT->period = period;
+    pT->overrunPolicy = overrunPolicy;
+    pT->timeRelease = phase - period;
+    storeResumeCondition( pT
+                        , /* eventMask */ RTOS_EVT_ABSOLUTE_TIMER
+                        , /* all */       false
+                        , /* timeout */   0
+                        );
+} /* End of rtos_setTaskPeriod */
+#endif /* RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/**
+ * Limit the CPU time of a task. The task may consume not more than \a budget system timer
+ * tics per replenishment period. If it exhausts its budget, then it is demoted to the
+ * priority class #RTOS_BUDGET_DEMOTION_PRIO_CLASS, where it can continue only if no other
+ * task of this or a higher class is due. It returns to its own class, when the next
+ * replenishment period begins. This way, a task of high priority, which is meant to serve
+ * sporadic work, can't starve the tasks of lower priority if it's flooded with
+ * requests.\n
+ *   The budget is accounted in whole system timer tics: A tic is accounted to the task,
+ * which is interrupted by it. A task, which is always suspended before the next tic, is
+ * not charged at all.\n
+ *   This function needs to be called from within setup(), after the task has been
+ * initialized by rtos_initializeTask or by the task table #RTOS_TASK_TABLE.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1. The task must not belong to the
+ * class, which is scheduled earliest deadline first, see #RTOS_EDF_PRIO_CLASS.
+ *   @param budget
+ * The budget in system timer tics. The range is 1..\a periodReplenish.
+ *   @param periodReplenish
+ * The replenishment period in system timer tics. The budget is refilled at the end of
+ * every period, the first period begins with the start of the kernel.
+ *   @remark
+ * The due list of class #RTOS_BUDGET_DEMOTION_PRIO_CLASS needs to have room for the
+ * demoted tasks, see #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS.
+ */
+
+void rtos_setTaskBudget(uint8_t idxTask, uintTime_t budget, uintTime_t periodReplenish)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS  &&  budget > 0  &&  budget <= periodReplenish);
+    task_t * const pT = &_taskAry[idxTask].task;
+#if RTOS_USE_EDF_PRIO_CLASS == RTOS_FEATURE_ON
+    ASSERT(pT->prioClass != RTOS_EDF_PRIO_CLASS);
 #endif
 
-} /* End of rtos_initializeTask */
+    pT->budget = budget;
+    pT->periodReplenish = periodReplenish;
+    pT->cntBudget = budget;
+    pT->cntReplenish = periodReplenish;
+
+} /* End of rtos_setTaskBudget */
+#endif /* RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON */
+
+
+
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/**
+ * Let the liveness monitor supervise a task. The task needs to call rtos_checkInTask at
+ * least once per \a periodLiveness system timer tics. If it misses its check-in, then the
+ * watchdog is no longer serviced and it'll reset the CPU, see #RTOS_USE_LIVENESS_MONITOR.\n
+ *   This function needs to be called from within setup(), after the task has been
+ * initialized by rtos_initializeTask or by the task table #RTOS_TASK_TABLE.
+ *   @param idxTask
+ * The index of the task in the range 0..RTOS_NO_TASKS-1.
+ *   @param periodLiveness
+ * The maximum time between two check-ins in system timer tics. The first period begins
+ * with the start of the kernel. The check-in can be one tic late because of the
+ * resolution of the system time. The range is 1..max(intTime_t); 0 ends the supervision
+ * of the task.
+ */
+
+void rtos_setTaskLivenessPeriod(uint8_t idxTask, uintTime_t periodLiveness)
+{
+    ASSERT(idxTask < RTOS_NO_TASKS  &&  (intTime_t)periodLiveness >= 0);
+    task_t * const pT = &_taskAry[idxTask].task;
+
+    pT->periodLiveness = periodLiveness;
+    pT->cntLiveness = periodLiveness;
+
+} /* End of rtos_setTaskLivenessPeriod */
+#endif /* RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON */
 
 
 
@@ -1950,13 +7057,12 @@ void rtos_initializeTask( uint8_t idxTask
  * Application called initialization of RTOS.\n
  *   Most important is the application handled task information. A task is characterized by
  * several static settings which need to be preset by the application. To save resources,
- * a standard situation will be the specification of all relevant settings at compile time
- * in the initializer expression of the array definition. The array is declared extern to
- * enable this mode.\n
+ * all relevant settings can be specified at compile time in the table #RTOS_TASK_TABLE.
+ * The task descriptions are then located in flash ROM.\n
  *   The application however also has the chance to provide this information at runtime.
  * Early in the execution of this function a callback \a setup into the application is
- * invoked. If the application has setup everything as a compile time expression, the
- * callback may simply contain a return.\n
+ * invoked, which calls rtos_initializeTask for each task. If the application has setup
+ * everything as a compile time expression, the callback needn't care about the tasks.\n
  *   The callback \a setup is invoked before any RTOS related interrupts have been
  * initialized, the routine is executed in the same context as and as a substitute of the
  * normal Arduino setup routine. The implementation can be made without bothering with
@@ -1993,6 +7099,29 @@ void rtos_initRTOS(void)
     /* We add some code to double-check that rtos_initializeTask has been invoked for each
        of the tasks. */
     memset(/* dest */ _taskAry, /* val */ 0x00, /* len */ sizeof(_taskAry));
+# if !defined(RTOS_TASK_TABLE)  &&  RTOS_NO_TASKS > 0
+    memset(/* dest */ _taskDescriptorAry, /* val */ 0x00, /* len */ sizeof(_taskDescriptorAry));
+# endif
+#endif
+
+#ifdef RTOS_TASK_TABLE
+    /* The task objects are initialized from the table, which is read from flash ROM, in
+       the same way as rtos_initializeTask does. This is done prior to setup(), which may
+       refine the configuration, e.g. by rtos_setTaskPeriod. */
+    for(idxTask=0; idxTask<RTOS_NO_TASKS; ++idxTask)
+    {
+        taskDescriptor_t taskDescriptor;
+        memcpy_P(&taskDescriptor, &_taskDescriptorAry[idxTask], sizeof(taskDescriptor));
+        initializeTaskObject( idxTask
+                            , taskDescriptor.prioClass
+# if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                            , taskDescriptor.timeRoundRobin
+# endif
+                            , taskDescriptor.startEventMask
+                            , taskDescriptor.startByAllEvents
+                            , taskDescriptor.startTimeout
+                            );
+    }
 #endif
 
     /* Give the application the chance to do all its initialization - regardless of RTOS
@@ -2000,20 +7129,40 @@ void rtos_initRTOS(void)
        filled. */
     setup();
 
+#if RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON
+    /* If an assertion failed before the last reset, then the record of the failure is
+       written to the serial port, which has been opened by setup(). */
+    crr_reportCrashRecord();
+#endif
+
     /* Handle all tasks. */
     for(idxTask=0; idxTask<RTOS_NO_TASKS; ++idxTask)
     {
-        pT = &_taskAry[idxTask];
+        pT = &_taskAry[idxTask].task;
+#ifdef RTOS_TASK_TABLE
+        /* The task descriptor is read from flash ROM. */
+        taskDescriptor_t taskDescriptor;
+        memcpy_P(&taskDescriptor, &_taskDescriptorAry[idxTask], sizeof(taskDescriptor));
+        const taskDescriptor_t * const pTD = &taskDescriptor;
+#else
+        const taskDescriptor_t * const pTD = &_taskDescriptorAry[idxTask];
+#endif
 
         /* Anticipate typical application errors with respect to the initialization of task
            objects. */
-        ASSERT(pT->taskFunction != NULL  &&  pT->pStackArea != NULL  &&  pT->stackSize >= 50);
+        ASSERT(pTD->taskFunction != NULL  &&  pTD->pStackArea != NULL  &&  pTD->stackSize >= 50);
 
         /* Prepare the stack of the task and store the initial stack pointer value. */
-        pT->stackPointer = (uint16_t)prepareTaskStack( pT->pStackArea
-                                                     , pT->stackSize
-                                                     , pT->taskFunction
-                                                     );
+        pT->stackPointer = (uintptr_t)prepareTaskStack( pTD->pStackArea
+                                                      , pTD->stackSize
+                                                      , pTD->taskFunction
+                                                      );
+#ifdef RTOS_HOST_SIMULATION
+        prepareHostContext(idxTask);
+#endif
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+        pT->minStackPointer = pT->stackPointer;
+#endif
 #ifdef DEBUG
 # if false
         {
@@ -2023,17 +7172,17 @@ void rtos_initRTOS(void)
             Serial.print(idxTask);
             Serial.print(":\nStack pointer: 0x");
             Serial.println(pT->stackPointer, HEX);
-            for(u=0; u<pT->stackSize; ++u)
+            for(u=0; u<pTD->stackSize; ++u)
             {
                 if(u%8 == 0)
                 {
                     Serial.println("");
                     Serial.print(u, HEX);
                     Serial.print(", 0x");
-                    Serial.print((uint16_t)(pT->pStackArea+u), HEX);
+                    Serial.print((uint16_t)(pTD->pStackArea+u), HEX);
                     Serial.print(":\t");
                 }
-                Serial.print(pT->pStackArea[u], HEX);
+                Serial.print(pTD->pStackArea[u], HEX);
                 Serial.print("\t");
             }
             Serial.println("");
@@ -2052,38 +7201,31 @@ void rtos_initRTOS(void)
         /* Initialize overrun counter. */
         pT->cntOverrun = 0;
 
-        /* Any task is suspended at the beginning. No task is active, see before. If
-           mutexes or semaphores are in use this list is sorted with decreasing priority. */
-#if RTOS_USE_MUTEX == RTOS_FEATURE_OFF
-        _pSuspendedTaskAry[idxTask] = pT;
-#else
-        int8_t idxPos;
-        for(idxPos=0; idxPos<idxTask; ++idxPos)
-            if(_pSuspendedTaskAry[idxPos]->prioClass < pT->prioClass)
-                break;
-
-        /* Shift rest of the list one to the end. This loop requires a signed index. */
-        int8_t i;
-        for(i=idxTask-1; i>=idxPos; --i)
-            _pSuspendedTaskAry[i+1] = _pSuspendedTaskAry[i];
+        /* Any task is suspended at the beginning. No task is active, see before. The list
+           of suspended tasks is sorted with decreasing priority. */
+        linkSuspendedTask(pT);
 
-        /* Insert the suspended task at the priority determined right position. */
-        _pSuspendedTaskAry[idxPos] = pT;
-#endif
     } /* for(All tasks to initialize) */
 
-    /* Number of currently suspended tasks: All. */
-    _noSuspendedTasks = RTOS_NO_TASKS;
-
     /* The idle task is stored in the last array entry. It differs, there's e.g. no task
        function defined. We mainly need the storage location for the stack pointer. */
     pT = _pIdleTask;
     pT->stackPointer = 0;           /* Used only at de-activation. */
     pT->timeDueAt = 0;              /* Not used at all. */
+#if RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_OFF
     pT->cntDelay = 0;               /* Not used at all. */
+#endif
 #if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
     pT->cntRoundRobin = 0;          /* Not used at all. */
 #endif
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+    pT->budget = 0;                 /* Not used at all. */
+    pT->cntBudget = 0;              /* The idle task is never demoted. */
+#endif
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+    pT->periodLiveness = 0;         /* The idle task is not monitored. */
+    pT->cntLiveness = 0;
+#endif
 
     /* The next element always needs to be 0. Otherwise any interrupt or a call of
        sendEvent would corrupt the stack assuming that a suspend command would require a
@@ -2093,12 +7235,41 @@ void rtos_initRTOS(void)
     pT->eventMask = 0;              /* Not used at all. */
     pT->waitForAnyEvent = true;     /* Not used at all. */
     pT->cntOverrun = 0;             /* Not used at all. */
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    pT->tiRuntime = 0;
+#endif
 
     /* Any task is suspended at the beginning. No task is active, see before. */
     for(idxClass=0; idxClass<RTOS_NO_PRIO_CLASSES; ++idxClass)
+    {
         _noDueTasksAry[idxClass] = 0;
+        _idxFirstDueTaskAry[idxClass] = 0;
+    }
+#if RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+    for(idxClass=0; idxClass<NO_BYTES_PRIO_CLASS_VEC; ++idxClass)
+        _dueClassVecAry[idxClass] = 0;
+# if NO_BYTES_PRIO_CLASS_VEC > 1
+    _dueClassGroupVec = 0;
+# endif
+#endif
     _pActiveTask    = _pIdleTask;
     _pSuspendedTask = _pIdleTask;
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+    /* The idle task runs on the stack of main(), which starts at the end of RAM. */
+    _pIdleTask->minStackPointer = RAMEND;
+#endif
+
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+    /* The accounting of runtime starts with the idle task. */
+    _tiLastTaskSwitch = micros();
+    _tiStartCpuLoadWindow = _tiLastTaskSwitch;
+    _tiIdleAtStartCpuLoadWindow = 0;
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON  &&  !defined(RTOS_HOST_SIMULATION)
+    /* The watchdog is serviced by the system timer tic from now on. */
+    wdt_enable(RTOS_WATCHDOG_TIMEOUT);
+#endif
 
     /* All data is prepared. Let's start the IRQ which clocks the system time. */
     rtos_enableIRQTimerTic();
@@ -2110,9 +7281,32 @@ void rtos_initRTOS(void)
 #if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
     rtos_enableIRQUser01();
 #endif
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+# define CALL_ENABLE_IRQ(vector, eventVec, enableIRQ)   enableIRQ();
+    RTOS_APPL_INTERRUPT_TABLE(CALL_ENABLE_IRQ)
+#endif
 
     /* From here, all further code implicitly becomes the idle task. */
+#if RTOS_USE_LAZY_STACK_FILL == RTOS_FEATURE_ON
+    /* Complete the preparation of the task stacks while the tasks are already running. */
+    fillTaskStacks();
+#endif
     while(true)
+    {
+#if RTOS_USE_TICKLESS_IDLE == RTOS_FEATURE_ON
+        /* Stop the system timer tics as long as no task needs them. */
+        enterTicklessPeriod();
+#endif
         loop();
 
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+        /* Activate the tasks, which have been made due by the interrupts. */
+        rtos_yield();
+#endif
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+        /* Halt the CPU until the next interrupt. */
+        rtos_idleSleep();
+#endif
+    }
+
 } /* End of rtos_initRTOS */
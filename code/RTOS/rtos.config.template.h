@@ -60,6 +60,81 @@
 #define RTOS_MAX_NO_TASKS_IN_PRIO_CLASS 2
 
 
+/** The tasks can be configured in a table, which is evaluated at compile time. Each row of
+    the table is an invocation of the macro argument \a entry with the arguments of
+    rtos_initializeTask - less the task index, which is the position in the table, and less
+    the stack area, which is allocated by the kernel: The name of the task function, the
+    priority class, the maximum time slice in round robin mode (ignored if
+    #RTOS_ROUND_ROBIN_MODE_SUPPORTED is off), the stack size in Byte and the start
+    condition.\n
+      The task descriptions are placed in flash ROM, the application doesn't call
+    rtos_initializeTask in setup() and the RAM for the task descriptors is saved.
+    Moreover, the consistency of the table with #RTOS_NO_TASKS, #RTOS_NO_PRIO_CLASSES and
+    #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS is checked by the compiler. A bad setting leads to a
+    compilation error with a message, which names the offending check.\n
+      The task functions are declared by rtos.h; they need to be global functions of the
+    application. The task indexes are enumerated in the order of the table, the index of
+    a task is named rtos_idxTask_<taskFunction>.\n
+      The table is optional; if the macro is not defined, the tasks are configured at
+    runtime by rtos_initializeTask. Example:
+      \code
+      #define RTOS_TASK_TABLE(entry)                                                  \
+          entry(taskT0C0, 0, 0, 200, RTOS_EVT_ABSOLUTE_TIMER, false, 10)              \
+          entry(taskT0C1, 1, 0, 100, RTOS_EVT_EVENT_00, false, 0)
+      \endcode */
+#undef RTOS_TASK_TABLE
+
+
+/** The scheduler needs to find the highest priority class, which has at least one due
+    task. By default this is a linear search from the highest class downwards; its cost
+    is proportional to #RTOS_NO_PRIO_CLASSES and it is paid inside the system timer
+    interrupt with interrupts globally locked.\n
+      If this switch is set to #RTOS_FEATURE_ON, the kernel maintains a bit vector of all
+    non empty priority classes and looks up the highest set bit in a table. The search
+    takes constant time regardless of the number of priority classes. The maintenance of
+    the bit vector slightly increases the cost of all other task state transitions. The
+    feature pays off for more than about four priority classes. Up to 64 priority classes
+    are supported in this mode.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_PRIO_CLASS_BITMAP  RTOS_FEATURE_OFF
+
+
+/** The tasks of a priority class are normally served first come, first served (or round
+    robin). If this switch is set to #RTOS_FEATURE_ON, the tasks of the one priority class
+    #RTOS_EDF_PRIO_CLASS are instead scheduled earliest deadline first: The due task with
+    the earliest deadline is the active one of the class and a task, which becomes due
+    with an earlier deadline, preempts it. All other classes keep the strict fixed
+    priority scheduling; the EDF class is served when no task of higher class is due.\n
+      The deadline of a regular task, which is resumed by the absolute timer, is the end of
+    its period; this is the point in time, which it awaits with rtos_suspendTaskTillTime
+    plus the same period once again. The kernel learns the period from the last suspension;
+    the very first activation after start has the start timeout as period. Other tasks
+    are considered to have their deadline when they become due. With EDF, the tasks of the
+    class meet all deadlines up to a CPU load of 100% (less the load of the higher
+    classes), whereas fixed priorities are guaranteed only up to about 69% in general.\n
+      The deadlines are compared in the cyclic system time; they need to be less than half
+    the range of uintTime_t apart. Round robin must not be enabled for the tasks of the
+    class. An owner of a mutex, which temporarily inherits a priority, is not ordered by
+    its deadline.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_EDF_PRIO_CLASS     RTOS_FEATURE_OFF
+
+
+/** The priority class, which is scheduled earliest deadline first if
+    #RTOS_USE_EDF_PRIO_CLASS is set to #RTOS_FEATURE_ON. The range is
+    0..#RTOS_NO_PRIO_CLASSES-1. The due list of the class needs to have room for all of
+    its tasks, see #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS. */
+#define RTOS_EDF_PRIO_CLASS         0
+
+
+/** The kernel addresses the task objects by index in several places. If this switch is
+    set to #RTOS_FEATURE_ON, the size of the task objects is extended to the next power of
+    two, so that the address computation doesn't need a multiplication. The cost is a few
+    padding bytes of RAM per task.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_ALIGN_TASK_OBJECTS     RTOS_FEATURE_OFF
+
+
 /** The number of events, which behave like semaphores. When posted, they are not
     broadcasted like ordinary events but posted to only one task, which is the one of
     highest priority, which is currently waiting for this event. If no such task exists,
@@ -70,8 +145,11 @@
     In particular, one should not use semaphores where mutexes are possible. Mutexes are a
     sub-set of semaphores; it are semaphores with start value one and they can be
     implemented much more efficient by bit operations.
-      @remark To reduce the cost of the implementation of semaphores RTuinOS restricts the
-    number of semaphores to eight out of the 16 events.\n
+      @remark Semaphores and mutexes share the events, which are not reserved for timers
+    and application interrupts. With a 16 Bit event vector up to 14 semaphores are
+    possible, see #RTOS_EVENT_VECTOR_BITS for more. A released semaphore is passed on by
+    bit operations on the suspended tasks; with #RTOS_USE_EVENT_WAITER_INDEX it is directly
+    given to the head of the list of tasks waiting for it.\n
       @remark Two additional things have to be configured, when using at least one
     semaphore in your application:\n
       All semaphores are implemented as unsigned integers of a given type. The type
@@ -93,6 +171,18 @@
 #define RTOS_NO_MUTEX_EVENTS    0
 
 
+/** By default, posting an event inspects all suspended tasks, regardless whether they
+    wait for this event or not.\n
+      If this switch is set to #RTOS_FEATURE_ON, the kernel keeps a list of waiting tasks
+    for each event but the timers. Now, posting an event only visits the tasks in the
+    lists of the posted events. The lists are kept in order of priority and time of
+    suspension; mutexes and semaphores are passed to the same task as without the index.
+    The cost is (14+1)*RTOS_NO_TASKS Byte of RAM and some more effort when suspending a
+    task.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_EVENT_WAITER_INDEX RTOS_FEATURE_OFF
+
+
 /** Select the interrupt which clocks the system time. Side effects to consider: This
     interrupt (like all others which possibly result in a context switch) need to be
     inhibited by rtos_enterCriticalSection.\n
@@ -102,7 +192,9 @@
     rtos_enableIRQTimerTic(void), which is an overridable default implementation.\n
       If an application redefines the interrupt source, the new source will probably
     produce another system clock frequency. If so, the macro #RTOS_TIC needs to be redefined
-    also. */
+    also. And the pair of macros #RTOS_MASK_IRQ_TIMER_TIC and #RTOS_UNMASK_IRQ_TIMER_TIC,
+    which inhibit the interrupt in rtos_enterCriticalSection, need to be defined; the
+    default masks the overflow interrupt of timer 2. */
 #define RTOS_ISR_SYSTEM_TIMER_TIC TIMER2_OVF_vect
 
 
@@ -111,6 +203,380 @@
 #define RTOS_TIC (2.04e-3)
 
 
+/** By default, the system timer interrupt inspects the timers of all suspended tasks in
+    each tic. The cost of the interrupt is proportional to the number of suspended tasks,
+    even if no timeout elapses in this tic.\n
+      If this switch is set to #RTOS_FEATURE_ON, the timeouts of the suspended tasks are
+    kept in a hashed timer wheel, which is indexed by the system time. A tic only
+    inspects the tasks in the one bucket of the wheel, which belongs to the current time.
+    These are the tasks, whose timeout elapses in this tic, plus those, whose timeout
+    elapses in a later cycle of the wheel. Suspending and resuming a task having a timeout
+    become slightly more expensive.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TIMER_WHEEL    RTOS_FEATURE_OFF
+
+
+/** The number of buckets of the timer wheel if #RTOS_USE_TIMER_WHEEL is set. The number
+    needs to be a power of two and it must not exceed the cycle of the system time. The
+    greater the number the less likely is a bucket shared by tasks with different timeout
+    cycles. The cost is a pointer per bucket in RAM. */
+#define RTOS_TIMER_WHEEL_SIZE   16
+
+
+/** By default, the system timer interrupt saves the complete CPU context of the
+    interrupted task at entry, although most tics don't result in a task switch.\n
+      If this switch is set to #RTOS_FEATURE_ON, the interrupt first saves only the
+    registers, which may be altered by the call of the kernel's C code. The complete
+    context is saved only if the tic actually switches the task. A tic without task switch
+    becomes significantly cheaper and shortens the latency of other interrupts, a tic with
+    task switch becomes a bit more expensive.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_LAZY_CONTEXT_SAVE  RTOS_FEATURE_OFF
+
+
+/** By default, RTuinOS is a preemptive kernel: An interrupt, which makes a task of higher
+    priority due, switches to this task at once. Therefore, every task switch saves the
+    complete CPU context.\n
+      If this switch is set to #RTOS_FEATURE_ON, the kernel is cooperative. A task switch
+    happens only inside the kernel functions, which are called by the tasks, like
+    rtos_waitForEvent, rtos_sendEvent or rtos_yield. The interrupts, including the system
+    timer tic, only make tasks due. The active task continues until it calls one of these
+    functions; a task, which computes for a longer time, should call rtos_yield now and
+    then. The idle task calls rtos_yield after each return from loop(). Only the call saved
+    registers r2..r17, r28 and r29 belong to the context; a task switch is about twice as
+    fast and the context on the stack of a suspended task shrinks from 33 to 20 Byte.\n
+      Application interrupts, the lazy context save, nested interrupts, round robin, task
+    budgets and the EDF class can't be used in cooperative mode. An interrupt can post
+    events by rtos_sendEventFromISR.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_COOPERATIVE_SCHEDULING RTOS_FEATURE_OFF
+
+
+/** By default, the assembly code of a task switch exchanges the stack pointers and the
+    return value of a suspend command with the C code through global variables in RAM.\n
+      If this switch is set to #RTOS_FEATURE_ON, these values are passed as register
+    operands of the inline assembly statements instead. The stack pointer of the left task
+    is stored directly into its task object and the stack pointer and the return value of
+    the new task are taken from registers, which are loaded by the compiler. This saves
+    eight to twelve memory accesses and some Byte of RAM per task switch.\n
+      The switch affects the code, which the compiler generates for the naked functions of
+    the kernel. After changing compiler version or settings, the assembly listing should be
+    inspected as for the default implementation, see rtos_waitForEvent.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_REGISTER_CONTEXT_SWITCH    RTOS_FEATURE_OFF
+
+
+/** By default, the system timer interrupt and the posting of an event by rtos_sendEvent or
+    an application interrupt run with all interrupts globally disabled until the final
+    reti. The latency of all other interrupts is the execution time of the kernel's
+    scheduling code.\n
+      If this switch is set to #RTOS_FEATURE_ON, the kernel only masks the kernel aware
+    interrupts by #RTOS_MASK_KERNEL_INTERRUPTS and reenables the interrupts globally, while
+    it looks for the task to activate. All other interrupts can nest into this code. Only
+    saving the context and switching the stack pointer remain globally atomic. The AVR has
+    no interrupt priority levels; the higher priority of the other interrupts is emulated
+    by masking the kernel aware ones.\n
+      Each interrupt service routine, which calls a function of RTuinOS, e.g.
+    rtos_sendEventFromISR, needs to be masked by #RTOS_MASK_APPL_INTERRUPTS. The nested
+    interrupts are executed on the stack of the interrupted task; each task stack needs to
+    have a reserve for the kernel's stack frame plus the stack frame of the deepest nested
+    interrupt. rtos_sendEvent must not be called inside a critical section, as the kernel
+    unmasks the kernel aware interrupts when it's done.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_NESTED_INTERRUPTS  RTOS_FEATURE_OFF
+
+
+/** By default, the system timer interrupt occurs every tic, even if all tasks are
+    suspended for a long time.\n
+      If this switch is set to #RTOS_FEATURE_ON, the idle task slows down the system timer
+    whenever no suspended task waits for a timer event in the next eight tics. The next
+    interrupt occurs only after eight tics; the skipped tics are added to the system time.
+    If another interrupt or the idle task posts an event before, the system timer returns
+    to normal operation and the system time is corrected.\n
+      The tickless operation requires the default system timer, timer 2, which is
+    reconfigured to normal mode with prescaler 128. The tic becomes 2.048 ms, so set
+    #RTOS_TIC to (2.048e-3). The PWM outputs of timer 2 can't be used any longer. While the
+    system timer is slowed down, the idle task sees a system time, which is not updated.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TICKLESS_IDLE      RTOS_FEATURE_OFF
+
+
+/** By default, the idle task permanently executes the application's function loop() and
+    the CPU is never halted.\n
+      If this switch is set to #RTOS_FEATURE_ON, the idle task sends the CPU to sleep after
+    each return from loop(). The CPU wakes up at the next interrupt, at latest at the next
+    system timer tic. The time spent in sleep mode is accumulated and can be queried with
+    rtos_getIdleSleepTime. gsl_getSystemLoad uses this time instead of a busy wait loop.
+    The application can call rtos_idleSleep from within loop(), too.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_IDLE_SLEEP         RTOS_FEATURE_OFF
+
+/** The sleep mode, which is entered by the idle task if #RTOS_USE_IDLE_SLEEP is set to
+    #RTOS_FEATURE_ON. The names of the modes are defined in avr/sleep.h.\n
+      The sleep time is measured with micros(), which is based on timer 0. This is correct
+    only in #SLEEP_MODE_IDLE, which halts the CPU but not the timers. #SLEEP_MODE_PWR_SAVE
+    stops timer 0; the measured sleep time is wrong and gsl_getSystemLoad must not be used.
+    Moreover, this mode keeps timer 2 and thus the system timer tic running only if timer
+    2 is clocked asynchronously from an external clock crystal. */
+#define RTOS_IDLE_SLEEP_MODE        SLEEP_MODE_IDLE
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel takes the world time at each task
+    switch and accumulates the time, which each task and the idle task have been active.
+    The runtimes can be read at any time with rtos_getTaskRuntime and the CPU load with
+    rtos_getCpuLoad. gsl_getSystemLoad then returns immediately with the load since its
+    previous call.\n
+      The time is taken with micros(), which is based on timer 0. The required CPU time at
+    a task switch is a few microseconds.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_CPU_LOAD_ACCOUNTING RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel takes the world time when a task
+    is released, when it becomes active after the release and when it suspends again. The
+    minimum, average and maximum start latency and execution time of each task can be
+    read with rtos_getTaskTimingStatistics. This data helps to choose #RTOS_TIC and the
+    task periods with a known margin.\n
+      The time is taken with micros(). The switch costs 36 Byte of RAM per task and some
+    microseconds of CPU time at each task switch.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TASK_TIMING_STATISTICS RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel measures the latency of the
+    application interrupts #RTOS_USE_APPL_INTERRUPT_00 and #RTOS_USE_APPL_INTERRUPT_01:
+    The time from the entry into the interrupt service routine till the task, which is
+    resumed by the posted event, becomes active. The latencies are collected in a histogram
+    per interrupt, which can be read with rtos_getIsrLatencyHistogram. The histogram shows
+    the distribution and particularly the rare worst cases, which an average hides.\n
+      If an interrupt occurs again before the resumed task becomes active, then the
+    latency of the first interrupt is measured. An interrupt, which no task is waiting for,
+    is not measured.\n
+      The costs are a scan of the suspended tasks in each application interrupt and a few
+    microseconds at each task switch.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_ISR_LATENCY_HISTOGRAM RTOS_FEATURE_OFF
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/** The time stamp of the latency measurement. The expression reads a free-running clock
+    and yields a 16 Bit value. The unit of the histogram is the unit of this clock.
+    \a micros() is the default; it has a resolution of 4 us and the measured latencies
+    must not exceed 65 ms. The counter of a hardware timer, like TCNT1, which is configured
+    by the application to count CPU clock cycles, yields a much finer resolution. */
+# define RTOS_ISR_LATENCY_TIMESTAMP() ((uint16_t)micros())
+
+/** The number of buckets of a latency histogram. Bucket 0 counts the latency 0, bucket i
+    counts latencies in the range 2^(i-1) .. 2^i-1 and the last bucket counts all greater
+    latencies, too. The range is 2..17. */
+# define RTOS_ISR_LATENCY_NO_BUCKETS 12
+#endif
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the mutexes implement the priority
+    inheritance protocol: If a task has to wait for a mutex, then the owner of the mutex is
+    raised to the priority class of the waiting task until it releases the mutex. A task
+    of medium priority can no longer preempt the owner and delay the task of high priority
+    for an unbounded time.\n
+      The inherited priority is withdrawn when the owner releases the mutex but not if the
+    waiting task is resumed by its timeout. The due list of a priority class needs to have
+    room for the owners of mutexes, which temporarily join the class, see
+    #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS.\n
+      The switch is ignored if #RTOS_NO_MUTEX_EVENTS is zero.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_MUTEX_PRIO_INHERITANCE RTOS_FEATURE_OFF
+
+
+/** The width in Bit of an event vector, see type uintEventVec_t. The two most significant
+    bits are the timer events and the application interrupts use the next lower bits. All
+    other bits are general purpose events, semaphores and mutexes. With 16 Bit, at maximum
+    14 semaphores and mutexes can be configured, with 32 Bit up to 30.\n
+      A 32 Bit event vector makes all event related operations of the kernel more
+    expensive; don't use it unless the events don't suffice. An application, which has been
+    written for 16 Bit, will need to change the type of the parameter of its task functions
+    and of the return value of rtos_waitForEvent to uintEventVec_t.\n
+      Select either 16 or 32. */
+#define RTOS_EVENT_VECTOR_BITS      16
+
+
+/** The system time is a narrow, cyclic counter of tics, see uintTime_t. It is cheap for
+    the scheduler but unsuitable for measuring longer durations.\n
+      If this switch is set to #RTOS_FEATURE_ON, the kernel additionally counts the tics
+    with 32 Bit and rtos_getTimestamp returns the time since start of the kernel in
+    microseconds. The counter of tics is combined with the counter of timer 2, the
+    resolution is 4 us or 8 us with #RTOS_USE_TICKLESS_IDLE. The cost is a 32 Bit increment
+    in the system timer interrupt.\n
+      The timestamp requires the default system timer, timer 2, see
+    rtos_enableIRQTimerTic.\n
+      The real time clock rtc_realTimeClock.c is derived from the timestamp; it is
+    available only if this switch is set.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TIMESTAMP  RTOS_FEATURE_OFF
+
+
+/** An application interrupt, which posts events by rtos_sendEvent, always saves the
+    complete context of the interrupted task, regardless whether a task is resumed or not.
+    If this switch is set to #RTOS_FEATURE_ON, an ordinary interrupt service routine can
+    instead use rtos_sendEventFromISR, which only updates the state of the suspended tasks.
+    The routine ends with a call of rtos_leaveISR, which saves the context and switches
+    to another task only if a task has been made due. Several events posted in one
+    interrupt cost one task switch at most.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_SEND_EVENT_FROM_ISR    RTOS_FEATURE_OFF
+
+
+/** A task, which posts an event to another task and then waits for the answer, calls
+    rtos_sendEvent and rtos_waitForEvent. These are two kernel calls, each saving and
+    restoring the complete context, and a task of higher priority, which is resumed by the
+    posted event, becomes active in between. If this switch is set to #RTOS_FEATURE_ON,
+    the task can use rtos_sendEventAndWait instead, which posts the events and suspends
+    the task in a single kernel call. The scheduler decides only once, which task to
+    continue with; the response can't be posted before the task has started waiting for
+    it.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_SEND_EVENT_AND_WAIT    RTOS_FEATURE_OFF
+
+
+/** An event is broadcasted to all suspended tasks, which wait for it, and it occupies a
+    bit of the event vector, which is shared by the whole application. If this switch is
+    set to #RTOS_FEATURE_ON, a task can instead be notified directly by rtos_notifyTask.
+    Each task has its own vector of notification bits. The notifications are latched until
+    the task takes them with rtos_waitForNotification. Posting a notification only touches
+    the notified task; it's the cheapest way to resume a single, known task. If
+    #RTOS_USE_SEND_EVENT_FROM_ISR is set, an interrupt can notify a task by
+    rtos_notifyTaskFromISR.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TASK_NOTIFICATION  RTOS_FEATURE_OFF
+
+
+/** The priority class of a task is normally fixed after setup() and a task is only
+    suspended by itself, when it waits for events. If this switch is set to
+    #RTOS_FEATURE_ON, a task can change the priority class of any task at runtime by
+    rtos_setTaskPriority. Furthermore, it can park any task by rtos_suspendTask and resume
+    it by rtos_resumeTask; a parked task doesn't become active, whatever events are posted
+    to it. The functions support load shedding: A supervisor task demotes or parks tasks
+    of minor importance, when the system is overloaded.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TASK_CONTROL   RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the interrupt driven serial driver
+    ser_serial.c is compiled. It replaces the write functions of Arduino's Serial; tasks,
+    which find the transmit buffer full, are suspended instead of busy-waiting. The driver
+    requires #RTOS_USE_SEND_EVENT_FROM_ISR. Arduino's Serial must not be used by the
+    application if the driver is enabled.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_SERIAL_DRIVER  RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the ADC scan asc_adcScan.c is compiled. Its
+    interrupt converts a list of channels in turn and accumulates the results into double
+    buffered frames. A task is resumed once per completed frame, not once per conversion.
+    The scan requires #RTOS_USE_SEND_EVENT_FROM_ISR. The ADC interrupt must not be used as
+    application interrupt if the scan is enabled. The scan is configured by
+    #ASC_MAX_NO_CHANNELS, #ASC_NO_AVERAGED_SAMPLES, #ASC_ADC_REFS, #ASC_ADC_TRIGGER_SOURCE
+    and #ASC_ADC_PRESCALER, see asc_adcScan.h.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_ADC_SCAN   RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the event bus ebs_eventBus.c is compiled. It
+    maps sets of events to other boards, which are connected in a ring through their
+    USART1. A task, which posts mapped events by ebs_sendEvent, resumes the waiting tasks
+    on the remote board. The bus requires #RTOS_USE_SEND_EVENT_FROM_ISR and a CPU with
+    USART1; Arduino's Serial1 must not be used by the application if the bus is enabled.
+    The bus is configured by #EBS_SIZE_OF_TX_BUFFER and #EBS_MAX_NO_ROUTES, see
+    ebs_eventBus.h.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_EVENT_BUS  RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the queue of deferred procedure calls
+    dpc_deferredProcedureCall.c is compiled. Interrupt service routines queue the calls
+    of procedures by dpc_callFromISR and a single worker task runs them in order. Many
+    interrupt sources share the stack of this task and a burst of interrupts costs a
+    single task switch. The queue requires #RTOS_USE_SEND_EVENT_FROM_ISR. Its size is set
+    by #DPC_SIZE_OF_QUEUE, see dpc_deferredProcedureCall.h.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_DPC_QUEUE  RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel samples the stack pointer of the
+    active task on every entry into the kernel and keeps a low-water mark per task. The
+    stack reserve can then be queried at low cost by rtos_getStackLowWaterMark, e.g.
+    regularly in production code.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_STACK_LOW_WATER_MARK   RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the system timer tic checks the bottom bytes
+    of all task stacks. If one of them has been overwritten, the callback
+    rtos_onStackOverflow is invoked. Its default implementation makes a reset.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_STACK_CANARY   RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel monitors the liveness of the
+    tasks and it services the hardware watchdog. A task is monitored after
+    rtos_setTaskLivenessPeriod has been called for it; it then needs to report by
+    rtos_checkInTask at least once per configured period. The system timer tic counts down
+    the periods and it resets the watchdog as long as all monitored tasks are live. When a
+    task misses its check-in, then the kernel saves the index of the task in a record,
+    which survives the reset, invokes the callback rtos_onLivenessFailure and stops
+    servicing the watchdog. After the reset, rtos_getLivenessFailure reports the failed
+    task. The switch cannot be combined with #RTOS_USE_TICKLESS_IDLE.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_LIVENESS_MONITOR   RTOS_FEATURE_OFF
+
+/** The timeout of the hardware watchdog if #RTOS_USE_LIVENESS_MONITOR is set to
+    #RTOS_FEATURE_ON. The names of the timeouts are defined in avr/wdt.h. The watchdog is
+    enabled after return from setup() and then reset in every system timer tic; the
+    timeout needs to be longer than the longest critical section of the application. */
+#define RTOS_WATCHDOG_TIMEOUT       WDTO_250MS
+
+
+/** At startup, the kernel fills all task stacks with a pattern byte, which is needed by
+    rtos_getStackReserve. With large stacks this noticeably delays the start of the first
+    task. If this switch is set to #RTOS_FEATURE_ON, only the initial context of the tasks
+    is prepared at startup and the pattern is written later by the idle task, in small
+    portions under interrupt lock. Until the idle task has completed this,
+    rtos_getStackReserve reports too little reserve.\n
+      The stacks of a task table #RTOS_TASK_TABLE are then located in the section .noinit,
+    which is not cleared by the C runtime either. A reset - e.g. a watchdog reset or the
+    default reaction on a stack overflow - restarts the tasks without painting or clearing
+    the stack RAM. Application defined stack areas can be put into .noinit with
+    __attribute__((section(".noinit"))) to benefit in the same way.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_LAZY_STACK_FILL    RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the binary trace trc_trace.c is compiled.
+    Tasks and interrupts can log events into a ring buffer in RAM at very low cost. The
+    buffer is drained to the serial port by the idle task and dumped by ASSERT. The size
+    of the buffer is set by #TRC_NO_ENTRIES.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TRACE  RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, the kernel writes its scheduling decisions
+    into the binary trace: task switches, posted and awaited events, timeouts and the
+    hand-over of mutexes and semaphores. The host tool trcDecode can convert the trace
+    into a timeline with a lane per task. The switch requires #RTOS_USE_TRACE. If it is
+    off, the kernel code is not affected at all.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_KERNEL_TRACE   RTOS_FEATURE_OFF
+
+
+/** If this switch is set to #RTOS_FEATURE_ON, a failing ASSERT saves a crash record before
+    it resets the CPU: the source file and line of the assertion, the active task, the
+    stack pointer, the system time and, if #RTOS_USE_TRACE is set, the newest
+    #CRR_NO_TRACE_ENTRIES entries of the binary trace. The record is kept in the section
+    .noinit, which is not cleared by the C runtime. After the reset, rtos_initRTOS writes
+    it to the serial port when setup() returns, see crr_crashRecord.c. The record is
+    written only in DEBUG compilation, where ASSERT is enabled.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_CRASH_RECORD   RTOS_FEATURE_OFF
+
+
 /** Enable the application defined interrupt 0. (Two such interrupts are pre-configured in
     the code and more can be implemented by taking these two as a code template.)\n
       To install an application interrupt, this define is set to #RTOS_FEATURE_ON.\n
@@ -128,6 +594,14 @@
     doc2549.pdf (see http://www.atmel.com). */
 #define RTOS_ISR_USER_00    xxx_vect
 
+/** The pair of operations, which mask and unmask application interrupt 0 by resetting and
+    setting its enable bit, e.g. {TIMSK4 &= ~_BV(TOIE4);}. They are used by
+    rtos_enterCriticalSection and rtos_leaveCriticalSection, see
+    #RTOS_MASK_KERNEL_INTERRUPTS. The definition is required if the interrupt is enabled.
+    The operations are called with globally locked interrupts. */
+#define RTOS_MASK_IRQ_USER_00()     {xxx &= ~_BV(xxx);}
+#define RTOS_UNMASK_IRQ_USER_00()   {xxx |= _BV(xxx);}
+
 
 /** Enable the application defined interrupt 1. See #RTOS_USE_APPL_INTERRUPT_00 for
     details. */
@@ -137,6 +611,44 @@
     #RTOS_ISR_USER_00 for details. */
 #define RTOS_ISR_USER_01    xxx_vect
 
+/** The pair of operations, which mask and unmask application interrupt 1. See
+    #RTOS_MASK_IRQ_USER_00 for details. */
+#define RTOS_MASK_IRQ_USER_01()     {xxx &= ~_BV(xxx);}
+#define RTOS_UNMASK_IRQ_USER_01()   {xxx |= _BV(xxx);}
+
+
+/** Any number of further application interrupts can be configured in a table. Each row
+    of the table is an invocation of the macro argument \a entry with three arguments: The
+    name of the interrupt vector, the events to post if the interrupt occurs and the name of
+    the application supplied callback, which enables the interrupt. The callbacks are
+    invoked by the kernel at the same time as \a rtos_enableIRQUser00.\n
+      The posted events are any set of general purpose events; the timer events must not
+    be used. Unlike #RTOS_EVT_ISR_USER_00, the events can be taken from the general
+    purpose events and they needn't be distinct between different interrupts.\n
+      The kernel generates a tiny interrupt service routine for each row. All of them share
+    the code, which saves the context of the interrupted task, posts the events and
+    possibly switches to another task.\n
+      The table is optional; if the macro is not defined, no such application interrupt is
+    generated. Example:
+      \code
+      #define RTOS_APPL_INTERRUPT_TABLE(entry)                              \
+          entry(USART1_RX_vect, RTOS_EVT_EVENT_00, enableIRQUart1Rx)        \
+          entry(PCINT0_vect, RTOS_EVT_EVENT_01, enableIRQPinChange)
+      \endcode
+      @remark The interrupts need to be inhibited by rtos_enterCriticalSection, too, see
+    #RTOS_MASK_APPL_INTERRUPTS. */
+#undef RTOS_APPL_INTERRUPT_TABLE
+
+
+/** The pair of operations, which mask and unmask all further interrupts of the
+    application, which can switch tasks: The rows of #RTOS_APPL_INTERRUPT_TABLE and the
+    interrupt service routines, which post events by rtos_sendEventFromISR. They are used
+    by rtos_enterCriticalSection and rtos_leaveCriticalSection, see
+    #RTOS_MASK_KERNEL_INTERRUPTS. If they are not defined, they default to an empty
+    operation. The operations are called with globally locked interrupts. */
+#undef RTOS_MASK_APPL_INTERRUPTS
+#undef RTOS_UNMASK_APPL_INTERRUPTS
+
 
 /** A macro which expands to the code which defines all types which are related to the
     system timer. We need the unsigned and the related signed type. The macro is applied
@@ -146,7 +658,8 @@
     typedef int##noBits##_t intTime_t;
 
 
-#ifdef __AVR_ATmega2560__
+#if defined(__AVR_ATmega2560__)  ||  defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)  \
+    ||  defined(RTOS_HOST_SIMULATION)
 /**
  * This routine in cooperation with rtos_leaveCriticalSection makes the code sequence
  * located between the two functions atomic with respect to operations of the RTuinOS task
@@ -155,15 +668,17 @@
  * functions in order to avoid data inconsistencies due to task switches during the access
  * time. A exception are trivial access operations which are atomic as such, e.g. read or
  * write of a single byte.\n
- *   The function implementation disables the interrupt source for the system timer, which
- * is the only unforeseen, random cause of a task switch in the default configuration of
- * RTuinOS. The implementation of this pair of functions need to be changed if this
- * standard configuration is changed also. Examples of a changed configuration are:\n
- *   The system timer is bound to another interrupt source.\n
- *   External interrupts are enabled and implemented.\n
- * In any case, the functions need to disable all interrupts, which could lead to a task
- * switch. It is not the intention - although it would work - to simply lock all
- * interrupts globally. The responsiveness of the system would be degraded without need.\n
+ *   The function implementation disables the interrupt sources, which could lead to a task
+ * switch, by resetting their individual enable bits, see #RTOS_MASK_KERNEL_INTERRUPTS.
+ * This is the system timer in the default configuration of RTuinOS. The kernel adds the
+ * interrupts of the enabled RTuinOS modules, like the serial driver, and the configured
+ * application interrupts, which are masked by #RTOS_MASK_IRQ_USER_00,
+ * #RTOS_MASK_IRQ_USER_01 and #RTOS_MASK_APPL_INTERRUPTS. All other interrupts, e.g. a
+ * UART receiver or an encoder capture, which don't interact with the kernel, are served
+ * without additional latency. The implementation of this pair of functions doesn't need
+ * to be changed if the configuration is changed. It is not the intention - although it
+ * would work - to simply lock all interrupts globally. The responsiveness of the system
+ * would be degraded without need.\n
  *   The use of the function pair cli() and sei() is an alternative to
  * rtos_enter/leaveCriticalSection. Globally locking the interrupts is less expensive than
  * inhibiting a specific set but degrades the responsiveness of the system. cli/sei should
@@ -185,7 +700,7 @@
 # define rtos_enterCriticalSection()                                        \
 {                                                                           \
     cli();                                                                  \
-    TIMSK2 &= ~_BV(TOIE2);                                                  \
+    RTOS_MASK_KERNEL_INTERRUPTS();                                          \
     sei();                                                                  \
                                                                             \
 } /* End of macro rtos_enterCriticalSection */
@@ -197,14 +712,17 @@
 
 
 
-#ifdef __AVR_ATmega2560__
+#if defined(__AVR_ATmega2560__)  ||  defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)  \
+    ||  defined(RTOS_HOST_SIMULATION)
 /**
  * This macro is the counterpart of #rtos_enterCriticalSection. Please refer to
  * #rtos_enterCriticalSection for deatils.
  */
 # define rtos_leaveCriticalSection()                                        \
 {                                                                           \
-    TIMSK2 |= _BV(TOIE2);                                                   \
+    cli();                                                                  \
+    RTOS_UNMASK_KERNEL_INTERRUPTS();                                        \
+    sei();                                                                  \
                                                                             \
 } /* End of macro rtos_leaveCriticalSection */
 #else
@@ -292,6 +810,43 @@ RTOS_DEFINE_TYPE_OF_SYSTEM_TIME(8)
 #define RTOS_OVERRUN_TASK_IS_IMMEDIATELY_DUE  RTOS_FEATURE_ON
 
 
+/** A regular task normally states its timing in each cycle by the call of
+    rtos_suspendTaskTillTime and the reaction on an overrun is the global setting
+    #RTOS_OVERRUN_TASK_IS_IMMEDIATELY_DUE. If this switch is set to #RTOS_FEATURE_ON, a
+    task can be declared a periodic task by rtos_setTaskPeriod in setup(): The kernel
+    knows period and phase offset of the task and releases it on a fixed grid. The task
+    waits for its next release with rtos_waitForNextPeriod. The reaction on an overrun is
+    an individual policy of the task: immediate resume, skipping the missed activations or
+    catching up with them.\n
+      The task objects grow by the period, the nominal release time and the policy.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_PERIODIC_TASKS     RTOS_FEATURE_OFF
+
+
+/** A task of high priority, which serves sporadic requests, starves all tasks of lower
+    priority if it is flooded with requests. If this switch is set to #RTOS_FEATURE_ON, a
+    task can be given a CPU budget by rtos_setTaskBudget in setup(): The task may consume a
+    number of system timer tics per replenishment period. If it exhausts its budget it is
+    demoted to the priority class #RTOS_BUDGET_DEMOTION_PRIO_CLASS and it returns to its
+    own class when the budget is replenished. The settings of
+    #RTOS_MAX_NO_TASKS_IN_PRIO_CLASS need to consider the demoted tasks.\n
+      The budget is checked in each system timer tic for the active task and the
+    replenishment periods of all tasks with budget are clocked. The task objects grow by
+    the budget, the replenishment period and their counters.\n
+      The feature can't be combined with #RTOS_USE_MUTEX_PRIO_INHERITANCE, which moves tasks
+    between the priority classes, too, nor with #RTOS_USE_TICKLESS_IDLE, which doesn't
+    clock the replenishment periods.\n
+      Select either RTOS_FEATURE_OFF or RTOS_FEATURE_ON. */
+#define RTOS_USE_TASK_BUDGET        RTOS_FEATURE_OFF
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/** The priority class of the tasks, which have exhausted their CPU budget. An exhausted
+    task can continue only if no other task of this or a higher class is due. Normally,
+    this is the lowest class, 0. */
+# define RTOS_BUDGET_DEMOTION_PRIO_CLASS 0
+#endif
+
+
 #if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
 /** The implementation of a semaphore is a simple unsigned integer. The value means the
     number of resources managed by the semaphore. In a resource management system it may be
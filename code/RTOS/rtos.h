@@ -64,158 +64,510 @@
 #endif
 
 
+/* Optional configuration switches. The application owned configuration files, which have
+   been written for elder revisions of RTuinOS, don't know about these switches. If a switch
+   is not set, it gets the default here, which is always the behavior of those elder
+   revisions. Please refer to rtos.config.template.h for the meaning of the switches. */
+#ifndef RTOS_USE_PRIO_CLASS_BITMAP
+# define RTOS_USE_PRIO_CLASS_BITMAP RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_PERIODIC_TASKS
+# define RTOS_USE_PERIODIC_TASKS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TASK_BUDGET
+# define RTOS_USE_TASK_BUDGET RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_BUDGET_DEMOTION_PRIO_CLASS
+# define RTOS_BUDGET_DEMOTION_PRIO_CLASS 0
+#endif
+#ifndef RTOS_USE_EDF_PRIO_CLASS
+# define RTOS_USE_EDF_PRIO_CLASS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_EDF_PRIO_CLASS
+# define RTOS_EDF_PRIO_CLASS 0
+#endif
+#ifndef RTOS_USE_TIMER_WHEEL
+# define RTOS_USE_TIMER_WHEEL RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_TIMER_WHEEL_SIZE
+# define RTOS_TIMER_WHEEL_SIZE 16
+#endif
+#ifndef RTOS_USE_EVENT_WAITER_INDEX
+# define RTOS_USE_EVENT_WAITER_INDEX RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_ALIGN_TASK_OBJECTS
+# define RTOS_ALIGN_TASK_OBJECTS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_LAZY_CONTEXT_SAVE
+# define RTOS_USE_LAZY_CONTEXT_SAVE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_COOPERATIVE_SCHEDULING
+# define RTOS_USE_COOPERATIVE_SCHEDULING RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_REGISTER_CONTEXT_SWITCH
+# define RTOS_USE_REGISTER_CONTEXT_SWITCH RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_NESTED_INTERRUPTS
+# define RTOS_USE_NESTED_INTERRUPTS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TICKLESS_IDLE
+# define RTOS_USE_TICKLESS_IDLE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_IDLE_SLEEP
+# define RTOS_USE_IDLE_SLEEP RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_IDLE_SLEEP_MODE
+# define RTOS_IDLE_SLEEP_MODE SLEEP_MODE_IDLE
+#endif
+#ifndef RTOS_USE_CPU_LOAD_ACCOUNTING
+# define RTOS_USE_CPU_LOAD_ACCOUNTING RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TASK_TIMING_STATISTICS
+# define RTOS_USE_TASK_TIMING_STATISTICS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_ISR_LATENCY_HISTOGRAM
+# define RTOS_USE_ISR_LATENCY_HISTOGRAM RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_ISR_LATENCY_TIMESTAMP
+# define RTOS_ISR_LATENCY_TIMESTAMP() ((uint16_t)micros())
+#endif
+#ifndef RTOS_ISR_LATENCY_NO_BUCKETS
+# define RTOS_ISR_LATENCY_NO_BUCKETS 12
+#endif
+#ifndef RTOS_USE_MUTEX_PRIO_INHERITANCE
+# define RTOS_USE_MUTEX_PRIO_INHERITANCE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_EVENT_VECTOR_BITS
+# define RTOS_EVENT_VECTOR_BITS 16
+#endif
+#ifndef RTOS_USE_TIMESTAMP
+# define RTOS_USE_TIMESTAMP RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_SEND_EVENT_FROM_ISR
+# define RTOS_USE_SEND_EVENT_FROM_ISR RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_SEND_EVENT_AND_WAIT
+# define RTOS_USE_SEND_EVENT_AND_WAIT RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TASK_NOTIFICATION
+# define RTOS_USE_TASK_NOTIFICATION RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TASK_CONTROL
+# define RTOS_USE_TASK_CONTROL RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_SERIAL_DRIVER
+# define RTOS_USE_SERIAL_DRIVER RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_ADC_SCAN
+# define RTOS_USE_ADC_SCAN RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_EVENT_BUS
+# define RTOS_USE_EVENT_BUS RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_DPC_QUEUE
+# define RTOS_USE_DPC_QUEUE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_STACK_LOW_WATER_MARK
+# define RTOS_USE_STACK_LOW_WATER_MARK RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_STACK_CANARY
+# define RTOS_USE_STACK_CANARY RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_LIVENESS_MONITOR
+# define RTOS_USE_LIVENESS_MONITOR RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_WATCHDOG_TIMEOUT
+# define RTOS_WATCHDOG_TIMEOUT WDTO_250MS
+#endif
+#ifndef RTOS_USE_LAZY_STACK_FILL
+# define RTOS_USE_LAZY_STACK_FILL RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_TRACE
+# define RTOS_USE_TRACE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_KERNEL_TRACE
+# define RTOS_USE_KERNEL_TRACE RTOS_FEATURE_OFF
+#endif
+#ifndef RTOS_USE_CRASH_RECORD
+# define RTOS_USE_CRASH_RECORD RTOS_FEATURE_OFF
+#endif
+
+
+/** The literal 1 in the type of an event vector, see uintEventVec_t. All event masks are
+    derived from this constant so that they have the complete width of an event vector,
+    also after bitwise inversion. */
+#if RTOS_EVENT_VECTOR_BITS == 16
+# define RTOS_EVT_LSB   0x0001u
+#elif RTOS_EVENT_VECTOR_BITS == 32
+# define RTOS_EVT_LSB   0x00000001ul
+#else
+# error The event vector can have either 16 or 32 Bit, see RTOS_EVENT_VECTOR_BITS
+#endif
+
+
 /* Some global, general purpose events and the two timer events. Used to specify the
    resume condition when suspending a task.
      Conditional definition: If the application defines an interrupt which triggers an
    event, the same event gets a deviating name. */
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 0
-# define RTOS_EVT_SEMAPHORE_00      (0x0001u<<0)
+# define RTOS_EVT_SEMAPHORE_00      (RTOS_EVT_LSB<<0)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 0
-# define RTOS_EVT_MUTEX_00          (0x0001u<<0)
+# define RTOS_EVT_MUTEX_00          (RTOS_EVT_LSB<<0)
 #else
-# define RTOS_EVT_EVENT_00          (0x0001u<<0)
+# define RTOS_EVT_EVENT_00          (RTOS_EVT_LSB<<0)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 1
-# define RTOS_EVT_SEMAPHORE_01      (0x0001u<<1)
+# define RTOS_EVT_SEMAPHORE_01      (RTOS_EVT_LSB<<1)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 1
-# define RTOS_EVT_MUTEX_01          (0x0001u<<1)
+# define RTOS_EVT_MUTEX_01          (RTOS_EVT_LSB<<1)
 #else
-# define RTOS_EVT_EVENT_01          (0x0001u<<1)
+# define RTOS_EVT_EVENT_01          (RTOS_EVT_LSB<<1)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 2
-# define RTOS_EVT_SEMAPHORE_02      (0x0001u<<2)
+# define RTOS_EVT_SEMAPHORE_02      (RTOS_EVT_LSB<<2)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 2
-# define RTOS_EVT_MUTEX_02          (0x0001u<<2)
+# define RTOS_EVT_MUTEX_02          (RTOS_EVT_LSB<<2)
 #else
-# define RTOS_EVT_EVENT_02          (0x0001u<<2)
+# define RTOS_EVT_EVENT_02          (RTOS_EVT_LSB<<2)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 3
-# define RTOS_EVT_SEMAPHORE_03      (0x0001u<<3)
+# define RTOS_EVT_SEMAPHORE_03      (RTOS_EVT_LSB<<3)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 3
-# define RTOS_EVT_MUTEX_03          (0x0001u<<3)
+# define RTOS_EVT_MUTEX_03          (RTOS_EVT_LSB<<3)
 #else
-# define RTOS_EVT_EVENT_03          (0x0001u<<3)
+# define RTOS_EVT_EVENT_03          (RTOS_EVT_LSB<<3)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 4
-# define RTOS_EVT_SEMAPHORE_04      (0x0001u<<4)
+# define RTOS_EVT_SEMAPHORE_04      (RTOS_EVT_LSB<<4)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 4
-# define RTOS_EVT_MUTEX_04          (0x0001u<<4)
+# define RTOS_EVT_MUTEX_04          (RTOS_EVT_LSB<<4)
 #else
-# define RTOS_EVT_EVENT_04          (0x0001u<<4)
+# define RTOS_EVT_EVENT_04          (RTOS_EVT_LSB<<4)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 5
-# define RTOS_EVT_SEMAPHORE_05      (0x0001u<<5)
+# define RTOS_EVT_SEMAPHORE_05      (RTOS_EVT_LSB<<5)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 5
-# define RTOS_EVT_MUTEX_05          (0x0001u<<5)
+# define RTOS_EVT_MUTEX_05          (RTOS_EVT_LSB<<5)
 #else
-# define RTOS_EVT_EVENT_05          (0x0001u<<5)
+# define RTOS_EVT_EVENT_05          (RTOS_EVT_LSB<<5)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 6
-# define RTOS_EVT_SEMAPHORE_06      (0x0001u<<6)
+# define RTOS_EVT_SEMAPHORE_06      (RTOS_EVT_LSB<<6)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 6
-# define RTOS_EVT_MUTEX_06          (0x0001u<<6)
+# define RTOS_EVT_MUTEX_06          (RTOS_EVT_LSB<<6)
 #else
-# define RTOS_EVT_EVENT_06          (0x0001u<<6)
+# define RTOS_EVT_EVENT_06          (RTOS_EVT_LSB<<6)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 7
-# define RTOS_EVT_SEMAPHORE_07      (0x0001u<<7)
+# define RTOS_EVT_SEMAPHORE_07      (RTOS_EVT_LSB<<7)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 7
-# define RTOS_EVT_MUTEX_07          (0x0001u<<7)
+# define RTOS_EVT_MUTEX_07          (RTOS_EVT_LSB<<7)
 #else
-# define RTOS_EVT_EVENT_07          (0x0001u<<7)
+# define RTOS_EVT_EVENT_07          (RTOS_EVT_LSB<<7)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
 #if RTOS_NO_SEMAPHORE_EVENTS > 8
-# error No more than eight semaphores are permitted
+# define RTOS_EVT_SEMAPHORE_08      (RTOS_EVT_LSB<<8)
 #elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 8
-# define RTOS_EVT_MUTEX_08          (0x0001u<<8)
+# define RTOS_EVT_MUTEX_08          (RTOS_EVT_LSB<<8)
 #else
-# define RTOS_EVT_EVENT_08          (0x0001u<<8)
+# define RTOS_EVT_EVENT_08          (RTOS_EVT_LSB<<8)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
-#if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 9
-# define RTOS_EVT_MUTEX_09          (0x0001u<<9)
+#if RTOS_NO_SEMAPHORE_EVENTS > 9
+# define RTOS_EVT_SEMAPHORE_09      (RTOS_EVT_LSB<<9)
+#elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 9
+# define RTOS_EVT_MUTEX_09          (RTOS_EVT_LSB<<9)
 #else
-# define RTOS_EVT_EVENT_09          (0x0001u<<9)
+# define RTOS_EVT_EVENT_09          (RTOS_EVT_LSB<<9)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
-#if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 10
-# define RTOS_EVT_MUTEX_10          (0x0001u<<10)
+#if RTOS_NO_SEMAPHORE_EVENTS > 10
+# define RTOS_EVT_SEMAPHORE_10      (RTOS_EVT_LSB<<10)
+#elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 10
+# define RTOS_EVT_MUTEX_10          (RTOS_EVT_LSB<<10)
 #else
-# define RTOS_EVT_EVENT_10          (0x0001u<<10)
+# define RTOS_EVT_EVENT_10          (RTOS_EVT_LSB<<10)
 #endif
 
 /** General purpose event, posted explicitly by rtos_sendEvent. */
-#if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 11
-# define RTOS_EVT_MUTEX_11          (0x0001u<<11)
+#if RTOS_NO_SEMAPHORE_EVENTS > 11
+# define RTOS_EVT_SEMAPHORE_11      (RTOS_EVT_LSB<<11)
+#elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 11
+# define RTOS_EVT_MUTEX_11          (RTOS_EVT_LSB<<11)
 #else
-# define RTOS_EVT_EVENT_11          (0x0001u<<11)
+# define RTOS_EVT_EVENT_11          (RTOS_EVT_LSB<<11)
 #endif
 
+/* The upper events depend on the width of the event vector. The application interrupts
+   and the timers always use the most significant bits. */
+#if RTOS_EVENT_VECTOR_BITS == 16
 /* The name of the next event depends on the configuration of RTuinOS. */
-#if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
+# if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
 /** This event is posted by the application defined ISR 01.
       @remark The expression here is passed on to the assembler as is. It needs to be
     compatible with both, compiler and assembler. Type casts, type post fixes, nested
     macros etc. must not be used. */
-# define RTOS_EVT_ISR_USER_01       (0x0001<<12)
-# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 12
-#  error Too many semaphores and mutexes specified. The limit is 12 when using two application interrupts
-# endif
-#else
-/** General purpose event, posted explicitly by rtos_sendEvent. */
-# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 12
-#  define RTOS_EVT_MUTEX_12         (0x0001u<<12)
+#  define RTOS_EVT_ISR_USER_01       (0x0001<<12)
+#  if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 12
+#   error Too many semaphores and mutexes specified. The limit is 12 when using two application interrupts
+#  endif
 # else
-#  define RTOS_EVT_EVENT_12         (0x0001u<<12)
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+#  if RTOS_NO_SEMAPHORE_EVENTS > 12
+#   define RTOS_EVT_SEMAPHORE_12     (RTOS_EVT_LSB<<12)
+#  elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 12
+#   define RTOS_EVT_MUTEX_12         (RTOS_EVT_LSB<<12)
+#  else
+#   define RTOS_EVT_EVENT_12         (RTOS_EVT_LSB<<12)
+#  endif
 # endif
-#endif
 
 /* The name of the next event depends on the configuration of RTuinOS. */
-#if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
 /** This event is posted by the application defined ISR 00.
       @remark The expression here is passed on to the assembler as is. It needs to be
     compatible with both, compiler and assembler. Type casts, type post fixes, nested
     macros etc. must not be used. */
-# define RTOS_EVT_ISR_USER_00       (0x0001<<13)
-# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 13
-#  error Too many semaphores and mutexes specified. The limit is 13 when using a single application interrupt
+#  define RTOS_EVT_ISR_USER_00       (0x0001<<13)
+#  if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 13
+#   error Too many semaphores and mutexes specified. The limit is 13 when using a single application interrupt
+#  endif
+# else
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+#  if RTOS_NO_SEMAPHORE_EVENTS > 13
+#   define RTOS_EVT_SEMAPHORE_13     (RTOS_EVT_LSB<<13)
+#  elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 13
+#   define RTOS_EVT_MUTEX_13         (RTOS_EVT_LSB<<13)
+#  else
+#   define RTOS_EVT_EVENT_13         (RTOS_EVT_LSB<<13)
+#  endif
 # endif
-#else
+
+# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 14
+#  error Too many semaphores and mutexes specified. The limit is 14 in total
+# endif
+
+/** Real time clock is elapsed for the task. */
+# define RTOS_EVT_ABSOLUTE_TIMER    (RTOS_EVT_LSB<<14)
+/** The relative-to-start clock is elapsed for the task */
+# define RTOS_EVT_DELAY_TIMER       (RTOS_EVT_LSB<<15)
+
+#else /* 32 Bit event vector */
+
 /** General purpose event, posted explicitly by rtos_sendEvent. */
-# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 13
-#  define RTOS_EVT_MUTEX_13         (0x0001u<<13)
+# if RTOS_NO_SEMAPHORE_EVENTS > 12
+#  define RTOS_EVT_SEMAPHORE_12     (RTOS_EVT_LSB<<12)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 12
+#  define RTOS_EVT_MUTEX_12         (RTOS_EVT_LSB<<12)
 # else
-#  define RTOS_EVT_EVENT_13         (0x0001u<<13)
+#  define RTOS_EVT_EVENT_12         (RTOS_EVT_LSB<<12)
 # endif
-#endif
 
-#if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 14
-# error Too many semaphores and mutexes specified. The limit is 14 in total
-#endif
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 13
+#  define RTOS_EVT_SEMAPHORE_13     (RTOS_EVT_LSB<<13)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 13
+#  define RTOS_EVT_MUTEX_13         (RTOS_EVT_LSB<<13)
+# else
+#  define RTOS_EVT_EVENT_13         (RTOS_EVT_LSB<<13)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 14
+#  define RTOS_EVT_SEMAPHORE_14     (RTOS_EVT_LSB<<14)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 14
+#  define RTOS_EVT_MUTEX_14         (RTOS_EVT_LSB<<14)
+# else
+#  define RTOS_EVT_EVENT_14         (RTOS_EVT_LSB<<14)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 15
+#  define RTOS_EVT_SEMAPHORE_15     (RTOS_EVT_LSB<<15)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 15
+#  define RTOS_EVT_MUTEX_15         (RTOS_EVT_LSB<<15)
+# else
+#  define RTOS_EVT_EVENT_15         (RTOS_EVT_LSB<<15)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 16
+#  define RTOS_EVT_SEMAPHORE_16     (RTOS_EVT_LSB<<16)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 16
+#  define RTOS_EVT_MUTEX_16         (RTOS_EVT_LSB<<16)
+# else
+#  define RTOS_EVT_EVENT_16         (RTOS_EVT_LSB<<16)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 17
+#  define RTOS_EVT_SEMAPHORE_17     (RTOS_EVT_LSB<<17)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 17
+#  define RTOS_EVT_MUTEX_17         (RTOS_EVT_LSB<<17)
+# else
+#  define RTOS_EVT_EVENT_17         (RTOS_EVT_LSB<<17)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 18
+#  define RTOS_EVT_SEMAPHORE_18     (RTOS_EVT_LSB<<18)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 18
+#  define RTOS_EVT_MUTEX_18         (RTOS_EVT_LSB<<18)
+# else
+#  define RTOS_EVT_EVENT_18         (RTOS_EVT_LSB<<18)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 19
+#  define RTOS_EVT_SEMAPHORE_19     (RTOS_EVT_LSB<<19)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 19
+#  define RTOS_EVT_MUTEX_19         (RTOS_EVT_LSB<<19)
+# else
+#  define RTOS_EVT_EVENT_19         (RTOS_EVT_LSB<<19)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 20
+#  define RTOS_EVT_SEMAPHORE_20     (RTOS_EVT_LSB<<20)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 20
+#  define RTOS_EVT_MUTEX_20         (RTOS_EVT_LSB<<20)
+# else
+#  define RTOS_EVT_EVENT_20         (RTOS_EVT_LSB<<20)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 21
+#  define RTOS_EVT_SEMAPHORE_21     (RTOS_EVT_LSB<<21)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 21
+#  define RTOS_EVT_MUTEX_21         (RTOS_EVT_LSB<<21)
+# else
+#  define RTOS_EVT_EVENT_21         (RTOS_EVT_LSB<<21)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 22
+#  define RTOS_EVT_SEMAPHORE_22     (RTOS_EVT_LSB<<22)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 22
+#  define RTOS_EVT_MUTEX_22         (RTOS_EVT_LSB<<22)
+# else
+#  define RTOS_EVT_EVENT_22         (RTOS_EVT_LSB<<22)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 23
+#  define RTOS_EVT_SEMAPHORE_23     (RTOS_EVT_LSB<<23)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 23
+#  define RTOS_EVT_MUTEX_23         (RTOS_EVT_LSB<<23)
+# else
+#  define RTOS_EVT_EVENT_23         (RTOS_EVT_LSB<<23)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 24
+#  define RTOS_EVT_SEMAPHORE_24     (RTOS_EVT_LSB<<24)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 24
+#  define RTOS_EVT_MUTEX_24         (RTOS_EVT_LSB<<24)
+# else
+#  define RTOS_EVT_EVENT_24         (RTOS_EVT_LSB<<24)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 25
+#  define RTOS_EVT_SEMAPHORE_25     (RTOS_EVT_LSB<<25)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 25
+#  define RTOS_EVT_MUTEX_25         (RTOS_EVT_LSB<<25)
+# else
+#  define RTOS_EVT_EVENT_25         (RTOS_EVT_LSB<<25)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 26
+#  define RTOS_EVT_SEMAPHORE_26     (RTOS_EVT_LSB<<26)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 26
+#  define RTOS_EVT_MUTEX_26         (RTOS_EVT_LSB<<26)
+# else
+#  define RTOS_EVT_EVENT_26         (RTOS_EVT_LSB<<26)
+# endif
+
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+# if RTOS_NO_SEMAPHORE_EVENTS > 27
+#  define RTOS_EVT_SEMAPHORE_27     (RTOS_EVT_LSB<<27)
+# elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 27
+#  define RTOS_EVT_MUTEX_27         (RTOS_EVT_LSB<<27)
+# else
+#  define RTOS_EVT_EVENT_27         (RTOS_EVT_LSB<<27)
+# endif
+
+/* The name of the next event depends on the configuration of RTuinOS. */
+# if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
+/** This event is posted by the application defined ISR 01.
+      @remark The expression here is passed on to the assembler as is. It needs to be
+    compatible with both, compiler and assembler. Type casts, type post fixes, nested
+    macros etc. must not be used. */
+#  define RTOS_EVT_ISR_USER_01       0x10000000
+#  if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 28
+#   error Too many semaphores and mutexes specified. The limit is 28 when using two application interrupts
+#  endif
+# else
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+#  if RTOS_NO_SEMAPHORE_EVENTS > 28
+#   define RTOS_EVT_SEMAPHORE_28     (RTOS_EVT_LSB<<28)
+#  elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 28
+#   define RTOS_EVT_MUTEX_28         (RTOS_EVT_LSB<<28)
+#  else
+#   define RTOS_EVT_EVENT_28         (RTOS_EVT_LSB<<28)
+#  endif
+# endif
+
+/* The name of the next event depends on the configuration of RTuinOS. */
+# if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+/** This event is posted by the application defined ISR 00.
+      @remark The expression here is passed on to the assembler as is. It needs to be
+    compatible with both, compiler and assembler. Type casts, type post fixes, nested
+    macros etc. must not be used. */
+#  define RTOS_EVT_ISR_USER_00       0x20000000
+#  if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 29
+#   error Too many semaphores and mutexes specified. The limit is 29 when using a single application interrupt
+#  endif
+# else
+/** General purpose event, posted explicitly by rtos_sendEvent. */
+#  if RTOS_NO_SEMAPHORE_EVENTS > 29
+#   define RTOS_EVT_SEMAPHORE_29     (RTOS_EVT_LSB<<29)
+#  elif RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 29
+#   define RTOS_EVT_MUTEX_29         (RTOS_EVT_LSB<<29)
+#  else
+#   define RTOS_EVT_EVENT_29         (RTOS_EVT_LSB<<29)
+#  endif
+# endif
+
+# if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 30
+#  error Too many semaphores and mutexes specified. The limit is 30 in total
+# endif
 
 /** Real time clock is elapsed for the task. */
-#define RTOS_EVT_ABSOLUTE_TIMER     (0x0001u<<14)
+# define RTOS_EVT_ABSOLUTE_TIMER    (RTOS_EVT_LSB<<30)
 /** The relative-to-start clock is elapsed for the task */
-#define RTOS_EVT_DELAY_TIMER        (0x0001u<<15)
+# define RTOS_EVT_DELAY_TIMER       (RTOS_EVT_LSB<<31)
+#endif /* RTOS_EVENT_VECTOR_BITS == 16 */
 
 
 /** The system timer frequency as floating point constant. The unit is Hz.\n
@@ -246,8 +598,13 @@
     body does not require a stack frame or has to set it up himself by some introductory
     inline assembly code.\n
       We use this type decoration for all software interrupts (all API functions which can
-    cause a task switch). */
-#define RTOS_NAKED_FCT __attribute__((naked, noinline))
+    cause a task switch). In the host simulation, these functions are ordinary C
+    functions. */
+#ifdef RTOS_HOST_SIMULATION
+# define RTOS_NAKED_FCT __attribute__((noinline))
+#else
+# define RTOS_NAKED_FCT __attribute__((naked, noinline))
+#endif
 
 /** Function prototype decoration which ensures that a function is generated by the compiler
     as such, but neither inlined nor removed from the code.\n
@@ -262,6 +619,132 @@
     for such declarations. */
 #define RTOS_PROGMEM_SECTION __attribute__((section(".progmem.rtuinos")))
 
+/** Place a string literal in the program memory and get its address. Other than a
+    normal string literal, the string is not copied into RAM by the startup code; it costs
+    neither RAM nor boot time. The string needs to be read with the pgm_read_xxx functions
+    or passed to a function, which expects its argument in the flash ROM, e.g. printf_P,
+    puts_progmem or ser_writeFlashStr. The macro can be used in expressions like PSTR from
+    avr-libc but it avoids the false compiler warnings of PSTR in C++ code, see
+    #RTOS_PROGMEM_SECTION.\n
+      In the host simulation, the string is an ordinary string literal. */
+#ifdef RTOS_HOST_SIMULATION
+# define RTOS_FLASH_STR(str) (str)
+#else
+# define RTOS_FLASH_STR(str)                                                        \
+            (__extension__({ static RTOS_PROGMEM_SECTION const char _flashStr[] = (str); \
+                             &_flashStr[0];                                         \
+                          }))
+#endif
+
+
+/* The interrupt sources, which can cause a task switch, are individually masked by
+   rtos_enterCriticalSection, see #RTOS_MASK_KERNEL_INTERRUPTS. The mask operations of the
+   application interrupts are configured in the application owned rtos.config.h. */
+#ifndef RTOS_MASK_IRQ_TIMER_TIC
+/** Mask the interrupt of the system timer. The default is the overflow interrupt of timer
+    2. An application, which redefines #RTOS_ISR_SYSTEM_TIMER_TIC, needs to redefine the
+    pair of mask operations, too. */
+# define RTOS_MASK_IRQ_TIMER_TIC()      {TIMSK2 &= ~_BV(TOIE2);}
+/** Unmask the interrupt of the system timer, the counterpart of #RTOS_MASK_IRQ_TIMER_TIC. */
+# define RTOS_UNMASK_IRQ_TIMER_TIC()    {TIMSK2 |= _BV(TOIE2);}
+#endif
+
+#if RTOS_USE_APPL_INTERRUPT_00 == RTOS_FEATURE_ON
+# ifndef RTOS_MASK_IRQ_USER_00
+/* The use of #RTOS_MASK_KERNEL_INTERRUPTS requires the application to configure the mask
+   operations of its interrupt. The undeclared function names the missing macro in the
+   compiler error. */
+#  define RTOS_MASK_IRQ_USER_00()       {rtos_config_h_needs_to_define_RTOS_MASK_IRQ_USER_00();}
+#  define RTOS_UNMASK_IRQ_USER_00()     {rtos_config_h_needs_to_define_RTOS_MASK_IRQ_USER_00();}
+# endif
+#else
+# undef RTOS_MASK_IRQ_USER_00
+# undef RTOS_UNMASK_IRQ_USER_00
+# define RTOS_MASK_IRQ_USER_00()        {}
+# define RTOS_UNMASK_IRQ_USER_00()      {}
+#endif
+
+#if RTOS_USE_APPL_INTERRUPT_01 == RTOS_FEATURE_ON
+# ifndef RTOS_MASK_IRQ_USER_01
+#  define RTOS_MASK_IRQ_USER_01()       {rtos_config_h_needs_to_define_RTOS_MASK_IRQ_USER_01();}
+#  define RTOS_UNMASK_IRQ_USER_01()     {rtos_config_h_needs_to_define_RTOS_MASK_IRQ_USER_01();}
+# endif
+#else
+# undef RTOS_MASK_IRQ_USER_01
+# undef RTOS_UNMASK_IRQ_USER_01
+# define RTOS_MASK_IRQ_USER_01()        {}
+# define RTOS_UNMASK_IRQ_USER_01()      {}
+#endif
+
+/* The interrupts of the optional RTuinOS modules post their events by
+   rtos_sendEventFromISR; they can switch tasks, too. */
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+# define RTOS_MASK_IRQ_MODULES_SER()    {UCSR0B &= ~_BV(UDRIE0);}
+# define RTOS_UNMASK_IRQ_MODULES_SER()  {UCSR0B |= _BV(UDRIE0);}
+#else
+# define RTOS_MASK_IRQ_MODULES_SER()    {}
+# define RTOS_UNMASK_IRQ_MODULES_SER()  {}
+#endif
+#if RTOS_USE_ADC_SCAN == RTOS_FEATURE_ON
+# define RTOS_MASK_IRQ_MODULES_ASC()    {ADCSRA &= ~_BV(ADIE);}
+# define RTOS_UNMASK_IRQ_MODULES_ASC()  {ADCSRA |= _BV(ADIE);}
+#else
+# define RTOS_MASK_IRQ_MODULES_ASC()    {}
+# define RTOS_UNMASK_IRQ_MODULES_ASC()  {}
+#endif
+#if RTOS_USE_EVENT_BUS == RTOS_FEATURE_ON
+# define RTOS_MASK_IRQ_MODULES_EBS()    {UCSR1B &= ~(_BV(RXCIE1) | _BV(UDRIE1));}
+# define RTOS_UNMASK_IRQ_MODULES_EBS()  {UCSR1B |= _BV(RXCIE1) | _BV(UDRIE1);}
+#else
+# define RTOS_MASK_IRQ_MODULES_EBS()    {}
+# define RTOS_UNMASK_IRQ_MODULES_EBS()  {}
+#endif
+
+#ifndef RTOS_MASK_APPL_INTERRUPTS
+/** Mask further interrupts of the application, which can switch tasks, e.g. the rows of
+    #RTOS_APPL_INTERRUPT_TABLE or interrupts, which post events by rtos_sendEventFromISR.
+    The default is an empty operation. */
+# define RTOS_MASK_APPL_INTERRUPTS()    {}
+/** Unmask further interrupts of the application, the counterpart of
+    #RTOS_MASK_APPL_INTERRUPTS. */
+# define RTOS_UNMASK_APPL_INTERRUPTS()  {}
+#endif
+
+/** Mask all interrupts, which can cause a task switch, by resetting their individual
+    enable bits: The system timer, the configured application interrupts #RTOS_ISR_USER_00
+    and #RTOS_ISR_USER_01, the interrupts of the enabled RTuinOS modules (serial driver,
+    ADC scan, event bus) and the further application interrupts #RTOS_MASK_APPL_INTERRUPTS.
+    All other interrupts are not affected and keep their latency.\n
+      The macro is the implementation of rtos_enterCriticalSection in
+    rtos.config.template.h. It needs to be called with globally locked interrupts. */
+#define RTOS_MASK_KERNEL_INTERRUPTS()                                                       \
+{                                                                                           \
+    RTOS_MASK_IRQ_TIMER_TIC();                                                              \
+    RTOS_MASK_IRQ_USER_00();                                                                \
+    RTOS_MASK_IRQ_USER_01();                                                                \
+    RTOS_MASK_IRQ_MODULES_SER();                                                            \
+    RTOS_MASK_IRQ_MODULES_ASC();                                                            \
+    RTOS_MASK_IRQ_MODULES_EBS();                                                            \
+    RTOS_MASK_APPL_INTERRUPTS();                                                            \
+}
+
+/** Unmask all interrupts, which can cause a task switch, the counterpart of
+    #RTOS_MASK_KERNEL_INTERRUPTS. The interrupts are unmasked regardless of their state
+    before; it must not be used prior to the start of the kernel, which enables the
+    interrupts of the system timer and the application. The transmit interrupts of serial
+    driver and event bus disable themselves again if there's nothing to send. The macro
+    needs to be called with globally locked interrupts. */
+#define RTOS_UNMASK_KERNEL_INTERRUPTS()                                                     \
+{                                                                                           \
+    RTOS_UNMASK_IRQ_TIMER_TIC();                                                            \
+    RTOS_UNMASK_IRQ_USER_00();                                                              \
+    RTOS_UNMASK_IRQ_USER_01();                                                              \
+    RTOS_UNMASK_IRQ_MODULES_SER();                                                          \
+    RTOS_UNMASK_IRQ_MODULES_ASC();                                                          \
+    RTOS_UNMASK_IRQ_MODULES_EBS();                                                          \
+    RTOS_UNMASK_APPL_INTERRUPTS();                                                          \
+}
+
 
 /**
  * Delay a task without looking at other events. \a rtos_delay(delayTime) is identical to
@@ -323,9 +806,45 @@
                      )
 
 
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+/** Overrun policy of a periodic task, see rtos_setTaskPeriod: The task is resumed in the
+    next tic and its grid is shifted to this point in time. */
+# define RTOS_OVERRUN_POLICY_IMMEDIATE  0
+
+/** Overrun policy of a periodic task, see rtos_setTaskPeriod: The missed activations are
+    dropped and the task is resumed at the next point in time on its grid. */
+# define RTOS_OVERRUN_POLICY_SKIP       1
+
+/** Overrun policy of a periodic task, see rtos_setTaskPeriod: The task is resumed in
+    every tic until it has caught up with its grid; no activation is lost. */
+# define RTOS_OVERRUN_POLICY_CATCH_UP   2
+
+/**
+ * Suspend a periodic task until its next release. The period and the phase offset of the
+ * task have been set by rtos_setTaskPeriod. The call is identical to \a
+ * rtos_waitForEvent(#RTOS_EVT_ABSOLUTE_TIMER, false, 0).
+ *   @return
+ * The event mask of resuming events is returned. This will always be
+ * #RTOS_EVT_ABSOLUTE_TIMER.
+ *   @remark
+ * This method is one of the task suspend commands. It must not be used by the idle task,
+ * which can't be suspended. A crash would be the immediate consequence.
+ *   @remark
+ * This function actually is a macro calling \a rtos_waitForEvent using fixed parameters.
+ *   @see void rtos_setTaskPeriod(uint8_t, uintTime_t, uintTime_t, uint8_t)
+ */
+# define rtos_waitForNextPeriod()                                            \
+    rtos_waitForEvent( /* eventMask */ RTOS_EVT_ABSOLUTE_TIMER              \
+                     , /* all */       false                                \
+                     , /* timeout */   0                                    \
+                     )
+#endif
+
+
 /**
- * Alias of function void rtos_sendEvent(uint16_t). Post a set of events to the suspended
- * tasks. Suspend the current task if the events resume another task of higher priority.
+ * Alias of function void rtos_sendEvent(uintEventVec_t). Post a set of events to the
+ * suspended tasks. Suspend the current task if the events resume another task of higher
+ * priority.
  *   @param eventVec
  * The set of events to be posted.
  *   @remark
@@ -333,21 +852,91 @@
  *   @remark
  * This macro exists for backward compatibility only: The function \a rtos_sendEvent had
  * been named \a rtos_setEvent in the first release of RTuinOS, version 0.9.
- *   @see void rtos_sendEvent(uint16_t)
+ *   @see void rtos_sendEvent(uintEventVec_t)
  */
-#define /* void */ rtos_setEvent(/* uint16_t */ eventVec) rtos_sendEvent(eventVec)
+#define /* void */ rtos_setEvent(/* uintEventVec_t */ eventVec) rtos_sendEvent(eventVec)
 
 
 /*
  * Global type definitions
  */
 
+/** The type of an event vector or event mask. Each bit is related to one event. The width
+    is configured by #RTOS_EVENT_VECTOR_BITS. */
+#if RTOS_EVENT_VECTOR_BITS == 16
+typedef uint16_t uintEventVec_t;
+#else
+typedef uint32_t uintEventVec_t;
+#endif
+
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+/** The type of a vector of notifications. Other than events, the notification bits have a
+    meaning only for the notified task; they are defined by the application. */
+typedef uint16_t uintNotificationVec_t;
+#endif
+
 /** The type of any task.\n
       The function is of type void; it must never return.\n
       The function takes a single parameter. It is the event vector of the very event
     combination which made the task initially run. Typically this is just the delay timer
     event. */
-typedef void (*rtos_taskFunction_t)(uint16_t postedEventVec);
+typedef void (*rtos_taskFunction_t)(uintEventVec_t postedEventVec);
+
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+/** The statistics of a measured duration of a task, see rtos_getTaskTimingStatistics. All
+    times are in microseconds. */
+typedef struct rtos_timingStatistics_t
+{
+    /** The shortest measured duration. */
+    uint32_t tiMin;
+
+    /** The average of the measured durations. */
+    uint32_t tiAvg;
+
+    /** The longest measured duration. */
+    uint32_t tiMax;
+
+    /** The number of measurements the statistics are based on. If it is 0 then all times
+        are 0, too. */
+    uint16_t noSamples;
+
+} rtos_timingStatistics_t;
+#endif
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/** The histogram of the latencies of an application interrupt, see
+    rtos_getIsrLatencyHistogram. All times are in the unit of the clock
+    #RTOS_ISR_LATENCY_TIMESTAMP. */
+typedef struct rtos_isrLatencyHistogram_t
+{
+    /** The number of measured latencies per bucket. Bucket 0 counts the latency 0, bucket
+        i the latencies 2^(i-1) .. 2^i-1 and the last bucket all greater latencies, too.
+        The counters saturate. */
+    uint16_t noSamplesAry[RTOS_ISR_LATENCY_NO_BUCKETS];
+
+    /** The longest measured latency. */
+    uint16_t tiMax;
+
+} rtos_isrLatencyHistogram_t;
+#endif
+
+#ifdef RTOS_TASK_TABLE
+/** The entry of the enumeration of tasks for one row of the table #RTOS_TASK_TABLE. */
+# define RTOS_ENUM_TASK( taskFunction, prioClass, timeRoundRobin, stackSize                 \
+                       , startEventMask, startByAllEvents, startTimeout                     \
+                       )                                                                    \
+    rtos_idxTask_##taskFunction,
+
+/** The tasks, which are configured in table #RTOS_TASK_TABLE, are numbered in the order
+    of the table. The names of the enumerated values are made from the names of the task
+    functions. They are the task indexes, which are expected by the index based API
+    functions, e.g. rtos_getStackReserve. */
+enum
+{
+    RTOS_TASK_TABLE(RTOS_ENUM_TASK)
+    rtos_noTasksInTaskTable
+};
+#endif
 
 
 /*
@@ -374,6 +963,15 @@ extern uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS];
  * Global prototypes
  */
 
+#ifdef RTOS_TASK_TABLE
+/** The declaration of the application supplied task function for one row of the table
+    #RTOS_TASK_TABLE. */
+# define RTOS_DECLARE_TASK_FUNCTION( taskFunction, prioClass, timeRoundRobin, stackSize     \
+                                   , startEventMask, startByAllEvents, startTimeout         \
+                                   )                                                        \
+    extern void taskFunction(uintEventVec_t postedEventVec);
+RTOS_TASK_TABLE(RTOS_DECLARE_TASK_FUNCTION)
+#else
 /* Initialze all application parameters of one task. To be called for each of the tasks in
    setup(). */
 void rtos_initializeTask( uint8_t idxTask
@@ -384,10 +982,32 @@ void rtos_initializeTask( uint8_t idxTask
 #endif
                         , uint8_t * const pStackArea
                         , uint16_t stackSize
-                        , uint16_t startEventMask
+                        , uintEventVec_t startEventMask
                         , boolean startByAllEvents
                         , uintTime_t startTimeout
                         );
+#endif
+
+#if RTOS_USE_PERIODIC_TASKS == RTOS_FEATURE_ON
+/* Declare a task a periodic task with phase offset and overrun policy. To be called in
+   setup(). */
+void rtos_setTaskPeriod( uint8_t idxTask
+                       , uintTime_t period
+                       , uintTime_t phase
+                       , uint8_t overrunPolicy
+                       );
+#endif
+
+#if RTOS_USE_TASK_BUDGET == RTOS_FEATURE_ON
+/* Limit the CPU time a task may consume per replenishment period. To be called in
+   setup(). */
+void rtos_setTaskBudget(uint8_t idxTask, uintTime_t budget, uintTime_t periodReplenish);
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/* Set the maximum time between two check-ins of a task. To be called in setup(). */
+void rtos_setTaskLivenessPeriod(uint8_t idxTask, uintTime_t periodLiveness);
+#endif
 
 /** Configure and enable the interrupt which clocks the system time of RTuinOS. This
     function has a default implementation, the application may but need not to implement
@@ -411,6 +1031,14 @@ extern void rtos_enableIRQUser00(void);
 extern void rtos_enableIRQUser01(void);
 #endif
 
+#ifdef RTOS_APPL_INTERRUPT_TABLE
+/** The declaration of the application supplied callback for one row of the table
+    #RTOS_APPL_INTERRUPT_TABLE. It contains the code to set up the hardware to generate the
+    interrupt. */
+# define RTOS_DECLARE_ENABLE_IRQ(vector, eventVec, enableIRQ)  extern void enableIRQ(void);
+RTOS_APPL_INTERRUPT_TABLE(RTOS_DECLARE_ENABLE_IRQ)
+#endif
+
 /* Initialization of the internal data structures of RTuinOS and start of the timer
    interrupt (see void rtos_enableIRQTimerTic(void)). This function does not return but
    forks into the configured tasks.
@@ -419,10 +1047,36 @@ void rtos_initRTOS(void);
 
 /* Post a set of events to the suspended tasks. Suspend the current task if the events
    resume another task of higher priority. */
-void rtos_sendEvent(uint16_t eventVec);
+void rtos_sendEvent(uintEventVec_t eventVec);
+
+#if RTOS_USE_COOPERATIVE_SCHEDULING == RTOS_FEATURE_ON
+/* Let a task of higher priority become active, which has been made due by an interrupt. */
+void rtos_yield(void);
+#endif
 
 /* Suspend task until a combination of events appears or a timeout elapses. */
-uint16_t rtos_waitForEvent(uint16_t eventMask, boolean all, uintTime_t timeout);
+uintEventVec_t rtos_waitForEvent(uintEventVec_t eventMask, boolean all, uintTime_t timeout);
+
+#if RTOS_USE_SEND_EVENT_AND_WAIT == RTOS_FEATURE_ON
+/* Post a set of events and suspend task until a combination of events appears or a timeout
+   elapses. Both is done in a single kernel call. */
+uintEventVec_t rtos_sendEventAndWait( uintEventVec_t postedEventVec
+                                    , uintEventVec_t eventMask
+                                    , boolean all
+                                    , uintTime_t timeout
+                                    );
+#endif
+
+/* Get the current system time in tics. */
+uintTime_t rtos_getTime(void);
+
+/* Suspend task until a combination of events appears or an absolute deadline is reached.
+   Get the tics, which are left till the deadline. */
+uintEventVec_t rtos_waitForEventTillDeadline( uintEventVec_t eventMask
+                                            , boolean all
+                                            , uintTime_t timeDeadline
+                                            , uintTime_t *pRemainingTime
+                                            );
 
 /* How often could a real time task not be reactivated timely? */
 uint8_t rtos_getTaskOverrunCounter(uint8_t idxTask, boolean doReset);
@@ -430,4 +1084,103 @@ uint8_t rtos_getTaskOverrunCounter(uint8_t idxTask, boolean doReset);
 /* How many bytes of the stack of a task are still unused? */
 uint16_t rtos_getStackReserve(uint8_t idxTask);
 
+#if RTOS_USE_STACK_LOW_WATER_MARK == RTOS_FEATURE_ON
+/* Cheap estimate of the unused bytes of the stack of a task from sampled stack pointers. */
+uint16_t rtos_getStackLowWaterMark(uint8_t idxTask);
+#endif
+
+#if RTOS_USE_STACK_CANARY == RTOS_FEATURE_ON
+/* Callback, which is invoked if a task stack has overflown. The default makes a reset. */
+void rtos_onStackOverflow(uint8_t idxTask);
+#endif
+
+#if RTOS_USE_LIVENESS_MONITOR == RTOS_FEATURE_ON
+/* Let the active task report that it is alive. */
+void rtos_checkInTask(void);
+
+/* Did a task miss its check-in and cause the last reset? */
+boolean rtos_getLivenessFailure(uint8_t *pIdxTask);
+
+/* Callback, which is invoked if a task missed its check-in. The default does nothing, the
+   watchdog makes the reset. */
+void rtos_onLivenessFailure(uint8_t idxTask);
+#endif
+
+/* Which task is currently active? The idle task has index RTOS_NO_TASKS. */
+uint8_t rtos_getIdxActiveTask(void);
+
+#if RTOS_USE_IDLE_SLEEP == RTOS_FEATURE_ON
+/* Let the idle task send the CPU to sleep until the next interrupt. */
+void rtos_idleSleep(void);
+
+/* How long did the idle task sleep? */
+uint32_t rtos_getIdleSleepTime(boolean doReset);
+#endif
+
+#if RTOS_USE_CPU_LOAD_ACCOUNTING == RTOS_FEATURE_ON
+/* How long has a task been the active task? */
+uint32_t rtos_getTaskRuntime(uint8_t idxTask, boolean doReset);
+
+/* Get the CPU load since the last reset of the measurement. */
+uint8_t rtos_getCpuLoad(boolean doReset);
+#endif
+
+#if RTOS_USE_TASK_TIMING_STATISTICS == RTOS_FEATURE_ON
+/* How long does it take till a task starts and completes? */
+void rtos_getTaskTimingStatistics( uint8_t idxTask
+                                 , rtos_timingStatistics_t *pStartLatency
+                                 , rtos_timingStatistics_t *pExecutionTime
+                                 , boolean doReset
+                                 );
+#endif
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/* How long does it take from an application interrupt till the resumed task runs? */
+void rtos_getIsrLatencyHistogram( uint8_t idxInterrupt
+                                , rtos_isrLatencyHistogram_t *pHistogram
+                                , boolean doReset
+                                );
+#endif
+
+#if RTOS_USE_TIMESTAMP == RTOS_FEATURE_ON
+/* Get the time since start of the kernel in microseconds. */
+uint64_t rtos_getTimestamp(void);
+#endif
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+/* Post events from an application interrupt without context switch. */
+void rtos_sendEventFromISR(uintEventVec_t eventVec);
+
+/* Do the deferred context switch at the end of an application interrupt. */
+void rtos_leaveISR(void);
+#endif
+
+#if RTOS_USE_TASK_NOTIFICATION == RTOS_FEATURE_ON
+/* Post notifications to a single task. Suspend the current task if the notified task is
+   resumed and has a higher priority. */
+void rtos_notifyTask(uint8_t idxTask, uintNotificationVec_t notificationVec);
+
+# if RTOS_USE_SEND_EVENT_FROM_ISR == RTOS_FEATURE_ON
+/* Post notifications to a single task from an application interrupt without context
+   switch. */
+void rtos_notifyTaskFromISR(uint8_t idxTask, uintNotificationVec_t notificationVec);
+# endif
+
+/* Suspend task until it is notified or a timeout elapses. */
+uintNotificationVec_t rtos_waitForNotification( uintNotificationVec_t notificationMask
+                                              , uintTime_t timeout
+                                              );
+#endif
+
+#if RTOS_USE_TASK_CONTROL == RTOS_FEATURE_ON
+/* Move a task into another priority class at runtime. */
+void rtos_setTaskPriority(uint8_t idxTask, uint8_t prioClass);
+
+/* Park a task until it is resumed by rtos_resumeTask. */
+void rtos_suspendTask(uint8_t idxTask);
+
+/* Resume a task, which has been parked by rtos_suspendTask. */
+void rtos_resumeTask(uint8_t idxTask);
+#endif
+
 #endif  /* RTOS_INCLUDED */
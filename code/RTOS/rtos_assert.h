@@ -26,26 +26,100 @@
  * Include files
  */
 
+#include "rtos.h"
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+# include "ser_serial.h"
+#endif
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+# include "trc_trace.h"
+#endif
+#if RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON
+# include "crr_crashRecord.h"
+#endif
 
 /*
  * Defines
  */
 #ifdef DEBUG
+# if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+/** If the serial driver of RTuinOS is used, Serial must not be referenced; it would link
+    a second service routine for the same interrupt. The message is then written through
+    the serial driver. It is composed at compile time and placed in the flash ROM; the many
+    assertions of a DEBUG compilation don't consume any RAM. */
+#  define ASSERT_PRINT_MSG(msg)     ser_writeFlashStr(RTOS_FLASH_STR(msg))
+#  define ASSERT_LINE_TO_STR(line)  ASSERT_ARG_TO_STR(line)
+#  define ASSERT_ARG_TO_STR(arg)    #arg
+#  define ASSERT_PRINT_FAILURE()                                                        \
+            ASSERT_PRINT_MSG( "Assertion failed in file " __FILE__ ", line "            \
+                              ASSERT_LINE_TO_STR(__LINE__) "\r\n"                       \
+                            )
+# else
+/** By default the message is written into Serial. The text is taken from the flash ROM,
+    it doesn't consume RAM. */
+#  ifdef RTOS_HOST_SIMULATION
+#   define ASSERT_FLASH_STR(str)    RTOS_FLASH_STR(str)
+#  else
+#   define ASSERT_FLASH_STR(str)    ((const __FlashStringHelper*)RTOS_FLASH_STR(str))
+#  endif
+#  define ASSERT_PRINT_FAILURE()                                                        \
+            {                                                                           \
+                Serial.print(ASSERT_FLASH_STR("Assertion failed in file " __FILE__      \
+                                              ", line "                                 \
+                                             )                                          \
+                            );                                                          \
+                Serial.println(__LINE__);                                               \
+            }
+# endif
+
+/** If the binary trace is configured, ASSERT dumps the history of traced events. */
+# if RTOS_USE_TRACE == RTOS_FEATURE_ON
+#  define ASSERT_DUMP_TRACE()    trc_dump()
+# else
+#  define ASSERT_DUMP_TRACE()
+# endif
+
+/** If the crash record is configured, ASSERT saves the state of the system in RAM, which
+    survives the reset. */
+# if RTOS_USE_CRASH_RECORD == RTOS_FEATURE_ON
+#  define ASSERT_SAVE_CRASH_RECORD()                                                    \
+            crr_saveCrashRecord(RTOS_FLASH_STR(__FILE__), __LINE__)
+# else
+#  define ASSERT_SAVE_CRASH_RECORD()
+# endif
+
+# ifdef RTOS_HOST_SIMULATION
+/** In the host simulation, a failing assertion ends the process with failure. Other than
+    on the board, a reset, which would silently restart the test case, would not be
+    noticed by an automated test. */
+#  define ASSERT(cond)                                                                  \
+    {                                                                                   \
+        if(!(cond))                                                                     \
+        {                                                                               \
+            ASSERT_PRINT_FAILURE();                                                     \
+            exit(EXIT_FAILURE);                                                         \
+        }                                                                               \
+    } /* End of macro ASSERT */
+# else
 /** Implementation of macro ASSERT for the Arduino board. If the assertion fires the code
     attempts to write an error string into the global Serial object (its initialization
-    therefore is a prerequisite of using ASSERT), wait for a while and than makes a reset.\n
+    therefore is a prerequisite of using ASSERT), wait for a while and than makes a reset.
+    If the serial driver ser_serial.c is configured, the error string is written through
+    the driver instead. If the binary trace trc_trace.c is configured, its contents are
+    dumped, too. If the crash record crr_crashRecord.c is configured, it is saved before
+    anything else is done.\n
       If the compilation is not made in DEBUG mode ASSERT expands to nothing. */
-# define ASSERT(cond)                                                                   \
+#  define ASSERT(cond)                                                                  \
     {                                                                                   \
         if(!(cond))                                                                     \
         {                                                                               \
+            ASSERT_SAVE_CRASH_RECORD();                                                 \
             asm volatile                                                                \
             (                                                                           \
                 "sei \n\t"                                                              \
             );                                                                          \
             volatile uint32_t u = 0x400000ul;                                           \
-            Serial.print("Assertion failed in file " __FILE__ ", line ");               \
-            Serial.println(__LINE__);                                                   \
+            ASSERT_PRINT_FAILURE();                                                     \
+            ASSERT_DUMP_TRACE();                                                        \
             while(u>0)                                                                  \
                 -- u;                                                                   \
             asm volatile                                                                \
@@ -54,6 +128,7 @@
             );                                                                          \
         }                                                                               \
     } /* End of macro ASSERT */
+# endif /* RTOS_HOST_SIMULATION */
 #else
 # define ASSERT(cond)
 #endif
@@ -0,0 +1,293 @@
+/**
+ * @file rwl_readWriteLock.c
+ *   Implementation of reader-writer locks. A data structure, which is read by many tasks
+ * but rarely written, is protected by such a lock instead of a mutex: The readers don't
+ * exclude one another, only a writer excludes all other tasks. The lock prefers the
+ * writers; a reader doesn't get the lock as long as a writer is waiting for it. This
+ * ensures that a writer is not starved by a continuous stream of overlapping readers.\n
+ *   The lock uses two normal kernel events, one to resume the waiting readers and one to
+ * resume the waiting writers. A release of the lock resumes all tasks of the preferred
+ * kind by a single kernel call. They become due together and the kernel activates them in
+ * the order of their priority; a writer of higher priority takes the lock first and the
+ * others find it locked and are suspended again.\n
+ *   The check of the state of the lock and the suspension of the task are atomic: They
+ * are done under the global interrupt lock, which is released by the kernel when the task
+ * is suspended. A release of the lock can't be lost.
+ *   @remark
+ * The lock is not recursive. A task, which holds the lock for reading, must not acquire it
+ * a second time: It would wait forever if a writer is waiting in between.
+ *   @remark
+ * The functions of this module must not be called from an interrupt service routine. The
+ * idle task must not acquire a lock.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   rwl_initReadWriteLock
+ *   rwl_lockRead
+ *   rwl_unlockRead
+ *   rwl_lockWrite
+ *   rwl_unlockWrite
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "rwl_readWriteLock.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialize a reader-writer lock. This needs to be done once before the lock is used,
+ * e.g. in setup(). The lock is initially free.
+ *   @param pLock
+ * The lock object to initialize.
+ *   @param evtReaders
+ * The event used to resume the waiting readers. It needs to be a normal, broadcasted
+ * event, neither a semaphore, nor a mutex, nor a timer event. It must not be used for
+ * other purposes.
+ *   @param evtWriters
+ * The event used to resume the waiting writers. The same constraints apply as for \a
+ * evtReaders and it needs to be another event.
+ */
+
+void rwl_initReadWriteLock( rwl_readWriteLock_t * const pLock
+                          , uintEventVec_t evtReaders
+                          , uintEventVec_t evtWriters
+                          )
+{
+    ASSERT(evtReaders != 0  &&  evtWriters != 0  &&  (evtReaders & evtWriters) == 0
+           &&  ((evtReaders | evtWriters) & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER))
+               == 0
+          );
+
+    pLock->noReaders = 0;
+    pLock->isWriterActive = false;
+    pLock->noWaitingReaders = 0;
+    pLock->noWaitingWriters = 0;
+    pLock->evtReaders = evtReaders;
+    pLock->evtWriters = evtWriters;
+
+} /* End of rwl_initReadWriteLock */
+
+
+
+
+/**
+ * Acquire a reader-writer lock for reading. If a writer holds the lock or if a writer is
+ * waiting for it, then the calling task is suspended until all writers have released the
+ * lock or until the timeout elapses. Other readers don't hinder the calling task.
+ *   @return
+ * Get true if the task holds the lock for reading or false in case of a timeout.
+ *   @param pLock
+ * The lock object.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rtos_waitForEvent for the meaning of
+ * the delay timer. The timeout refers to the total time in the function, even if the
+ * task needs to wait several times.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean rwl_lockRead(rwl_readWriteLock_t * const pLock, uintTime_t timeout)
+{
+    const uintTime_t tiStart = rtos_getTime();
+    boolean isWaiting = false;
+
+    for(;;)
+    {
+        const uintTime_t tiElapsed = rtos_getTime() - tiStart;
+
+        /* The check of the lock and the registration as waiting task need to be atomic
+           with respect to the releasing tasks. The global interrupt lock is released by
+           the kernel when the task is suspended. */
+        cli();
+        if(isWaiting)
+            -- pLock->noWaitingReaders;
+
+        if(!pLock->isWriterActive  &&  pLock->noWaitingWriters == 0)
+        {
+            ++ pLock->noReaders;
+            sei();
+            return true;
+        }
+        else if(tiElapsed > timeout)
+        {
+            sei();
+            return false;
+        }
+
+        ++ pLock->noWaitingReaders;
+        isWaiting = true;
+        rtos_waitForEvent( pLock->evtReaders | RTOS_EVT_DELAY_TIMER
+                         , /* all */ false
+                         , /* timeout */ timeout - tiElapsed
+                         );
+    }
+} /* End of rwl_lockRead */
+
+
+
+
+/**
+ * Release a reader-writer lock, which the calling task holds for reading. If this is the
+ * last reader and if writers are waiting for the lock, then they are resumed. If the first
+ * of them has a higher priority than the calling task, it becomes active immediately.
+ *   @param pLock
+ * The lock object.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void rwl_unlockRead(rwl_readWriteLock_t * const pLock)
+{
+    cli();
+    ASSERT(pLock->noReaders > 0);
+    if(--pLock->noReaders == 0  &&  pLock->noWaitingWriters > 0)
+    {
+        /* The kernel call releases the global interrupt lock. */
+        rtos_sendEvent(pLock->evtWriters);
+    }
+    else
+        sei();
+
+} /* End of rwl_unlockRead */
+
+
+
+
+/**
+ * Acquire a reader-writer lock for writing. If any other task holds the lock, then the
+ * calling task is suspended until the lock is released or until the timeout elapses. New
+ * readers don't get the lock as long as the calling task is waiting.
+ *   @return
+ * Get true if the task holds the lock for writing or false in case of a timeout.
+ *   @param pLock
+ * The lock object.
+ *   @param timeout
+ * The maximum time to wait in system timer tics. See rwl_lockRead.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+boolean rwl_lockWrite(rwl_readWriteLock_t * const pLock, uintTime_t timeout)
+{
+    const uintTime_t tiStart = rtos_getTime();
+    boolean isWaiting = false;
+
+    for(;;)
+    {
+        const uintTime_t tiElapsed = rtos_getTime() - tiStart;
+
+        /* See rwl_lockRead for the atomic check and wait. */
+        cli();
+        if(isWaiting)
+            -- pLock->noWaitingWriters;
+
+        if(!pLock->isWriterActive  &&  pLock->noReaders == 0)
+        {
+            pLock->isWriterActive = true;
+            sei();
+            return true;
+        }
+        else if(tiElapsed > timeout)
+        {
+            /* The readers, which have been held off by the calling task, may now join the
+               readers, which hold the lock. */
+            if(!pLock->isWriterActive
+               &&  pLock->noWaitingWriters == 0
+               &&  pLock->noWaitingReaders > 0
+              )
+            {
+                /* The kernel call releases the global interrupt lock. */
+                rtos_sendEvent(pLock->evtReaders);
+            }
+            else
+                sei();
+
+            return false;
+        }
+
+        ++ pLock->noWaitingWriters;
+        isWaiting = true;
+        rtos_waitForEvent( pLock->evtWriters | RTOS_EVT_DELAY_TIMER
+                         , /* all */ false
+                         , /* timeout */ timeout - tiElapsed
+                         );
+    }
+} /* End of rwl_lockWrite */
+
+
+
+
+/**
+ * Release a reader-writer lock, which the calling task holds for writing. If other writers
+ * are waiting for the lock, then they are resumed. Otherwise the waiting readers are
+ * resumed. If the first of the resumed tasks has a higher priority than the calling task,
+ * it becomes active immediately.
+ *   @param pLock
+ * The lock object.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section.
+ */
+
+void rwl_unlockWrite(rwl_readWriteLock_t * const pLock)
+{
+    cli();
+    ASSERT(pLock->isWriterActive);
+    pLock->isWriterActive = false;
+
+    /* The kernel calls release the global interrupt lock. */
+    if(pLock->noWaitingWriters > 0)
+        rtos_sendEvent(pLock->evtWriters);
+    else if(pLock->noWaitingReaders > 0)
+        rtos_sendEvent(pLock->evtReaders);
+    else
+        sei();
+
+} /* End of rwl_unlockWrite */
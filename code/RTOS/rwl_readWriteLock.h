@@ -0,0 +1,95 @@
+#ifndef RWL_READWRITELOCK_INCLUDED
+#define RWL_READWRITELOCK_INCLUDED
+/**
+ * @file rwl_readWriteLock.h
+ * Definition of global interface of module rwl_readWriteLock.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+/** A reader-writer lock. Any number of tasks may hold the lock for reading at the same
+    time but a task, which holds it for writing, is the only one. Waiting writers take
+    precedence over new readers. The object is owned by the application but it must be
+    accessed only through the functions of this module. */
+typedef struct rwl_readWriteLock_t
+{
+    /** The number of tasks, which currently hold the lock for reading. */
+    volatile uint8_t noReaders;
+
+    /** Flag, which is set while a task holds the lock for writing. */
+    volatile boolean isWriterActive;
+
+    /** The number of tasks, which are waiting for the lock for reading. */
+    volatile uint8_t noWaitingReaders;
+
+    /** The number of tasks, which are waiting for the lock for writing. New readers don't
+        get the lock as long as this number is not zero. */
+    volatile uint8_t noWaitingWriters;
+
+    /** The event, which is posted to the waiting readers when they may get the lock. */
+    uintEventVec_t evtReaders;
+
+    /** The event, which is posted to the waiting writers when they may get the lock. */
+    uintEventVec_t evtWriters;
+
+} rwl_readWriteLock_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize a reader-writer lock prior to its first use. */
+void rwl_initReadWriteLock( rwl_readWriteLock_t *pLock
+                          , uintEventVec_t evtReaders
+                          , uintEventVec_t evtWriters
+                          );
+
+/** Acquire the lock for reading, wait if a writer holds or waits for the lock. */
+boolean rwl_lockRead(rwl_readWriteLock_t *pLock, uintTime_t timeout);
+
+/** Release the lock, which had been acquired for reading. */
+void rwl_unlockRead(rwl_readWriteLock_t *pLock);
+
+/** Acquire the lock for writing, wait if any other task holds the lock. */
+boolean rwl_lockWrite(rwl_readWriteLock_t *pLock, uintTime_t timeout);
+
+/** Release the lock, which had been acquired for writing. */
+void rwl_unlockWrite(rwl_readWriteLock_t *pLock);
+
+
+#endif  /* RWL_READWRITELOCK_INCLUDED */
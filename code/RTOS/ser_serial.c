@@ -0,0 +1,348 @@
+/**
+ * @file ser_serial.c
+ *   Interrupt driven output to the serial port USART0 of the ATmega2560 - the port, which
+ * is connected to the USB interface of the Arduino Mega board. The module replaces the
+ * write functions of Arduino's Serial for RTuinOS applications.\n
+ *   The written bytes are copied into a ring buffer. The interrupt "data register empty"
+ * of the USART fetches them one by one and transmits them. If a task finds the buffer
+ * full, it doesn't busy-wait like Serial does but it suspends. It is resumed by the
+ * interrupt as soon as a chunk of #SER_TX_CHUNK_SIZE bytes has been sent, and it copies
+ * the next chunk into the buffer at once. A task of high priority, which produces a lot of
+ * console output, now leaves the CPU to the tasks of lower priority while the characters
+ * are being sent.\n
+ *   The module is compiled only if #RTOS_USE_SERIAL_DRIVER is set. The interrupt posts its
+ * event by rtos_sendEventFromISR, which needs to be enabled by
+ * #RTOS_USE_SEND_EVENT_FROM_ISR. If no task is waiting, the interrupt doesn't involve the
+ * kernel at all.\n
+ *   Several tasks may write to the serial port. The output of different tasks is not
+ * mixed up within a call of ser_write as long as the sequence of bytes fits into a
+ * chunk.
+ *   @remark
+ * The idle task must never suspend. If it finds the buffer full, it busy-waits until
+ * there's space for more output.
+ *   @remark
+ * The module and Arduino's Serial must not be used together. The module defines the
+ * interrupt service routine, which is defined by Serial, too.
+ *   @remark
+ * The interrupt of this module can switch to another task. rtos_enterCriticalSection
+ * should inhibit it, too, by resetting bit UDRIE0 in register UCSR0B. The bit may be set
+ * again by rtos_leaveCriticalSection regardless whether there's pending output.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   ser_init
+ *   ser_write
+ *   ser_putchar
+ *   ser_writeFlashStr
+ *   ser_getNoPendingBytes
+ *   ISR(ISR_USART0_UDRE)
+ * Local functions
+ *   getNoFreeBytes
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "ser_serial.h"
+
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR != RTOS_FEATURE_ON
+# error The serial driver requires RTOS_USE_SEND_EVENT_FROM_ISR to be set to RTOS_FEATURE_ON
+#endif
+
+#if SER_SIZE_OF_TX_BUFFER < 2  ||  SER_SIZE_OF_TX_BUFFER > 128 \
+    ||  (SER_SIZE_OF_TX_BUFFER & (SER_SIZE_OF_TX_BUFFER-1)) != 0
+# error The size of the transmit buffer needs to be a power of two in the range 2..128
+#endif
+#if SER_TX_CHUNK_SIZE < 1  ||  SER_TX_CHUNK_SIZE > SER_SIZE_OF_TX_BUFFER
+# error The chunk size must be in the range 1..SER_SIZE_OF_TX_BUFFER
+#endif
+
+/** The interrupt vector "data register empty" of USART0. The ATmega328P has a single USART
+    and its vector names don't have the index. */
+#ifdef USART0_UDRE_vect
+# define ISR_USART0_UDRE    USART0_UDRE_vect
+#else
+# define ISR_USART0_UDRE    USART_UDRE_vect
+#endif
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The ring buffer of bytes, which are waiting for transmission. */
+static uint8_t _txBufAry[SER_SIZE_OF_TX_BUFFER];
+
+/** The position of the next write into the buffer. The position indexes are cyclically
+    incremented and never wrapped explicitly. The number of pending bytes is their
+    difference. */
+static volatile uint8_t _idxWrite = 0;
+
+/** The position of the next byte to send. Modified by the interrupt only. */
+static volatile uint8_t _idxRead = 0;
+
+/** The event, which is posted by the interrupt to resume the waiting writers. */
+static uintEventVec_t _evtTxSpace = 0;
+
+/** Flag, which is set by a writer before it suspends itself to wait for space in the
+    buffer. The interrupt resets it and posts \a _evtTxSpace. */
+static volatile boolean _isWriterWaiting = false;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the number of bytes, which can be written into the buffer.
+ *   @return
+ * Get the number of free bytes.
+ */
+
+static inline uint8_t getNoFreeBytes(void)
+{
+    return SER_SIZE_OF_TX_BUFFER - (uint8_t)(_idxWrite - _idxRead);
+
+} /* End of getNoFreeBytes */
+
+
+
+
+/**
+ * Initialize the serial port. This needs to be done once before the first output, e.g.
+ * in setup(). The port is configured for 8 data bits, no parity and one stop bit.
+ *   @param baudRate
+ * The Baud rate, e.g. 115200.
+ *   @param evtTxSpace
+ * The event, which is used to resume the writers, which wait for space in the transmit
+ * buffer. It needs to be a normal, broadcasted event, neither a semaphore, nor a mutex,
+ * nor a timer event. The writers must not use it for other purposes.
+ *   @remark
+ * The function must be called before the kernel is started or inside a critical section,
+ * which inhibits the interrupt of this module.
+ */
+
+void ser_init(uint32_t baudRate, uintEventVec_t evtTxSpace)
+{
+    ASSERT(baudRate > 0);
+    ASSERT(evtTxSpace != 0
+           &&  (evtTxSpace & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+
+    _idxWrite = 0;
+    _idxRead = 0;
+    _evtTxSpace = evtTxSpace;
+    _isWriterWaiting = false;
+
+    /* Double speed mode. The divider is rounded to the nearest integer. */
+    UCSR0A = _BV(U2X0);
+    UBRR0 = (uint16_t)(((F_CPU / 4 / baudRate) - 1) / 2);
+
+    /* 8 data bits, no parity, one stop bit. Only the transmitter is enabled. The
+       interrupt is enabled as soon as there's something to send. */
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+    UCSR0B = _BV(TXEN0);
+
+} /* End of ser_init */
+
+
+
+
+/**
+ * Write a sequence of bytes to the serial port. The bytes are copied into the transmit
+ * buffer and the function returns before they have been sent. If the buffer is full, the
+ * calling task is suspended until the next chunk of bytes can be written.
+ *   @param pData
+ * The bytes to write.
+ *   @param noBytes
+ * The number of bytes to write.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section or from an interrupt service routine.
+ */
+
+void ser_write(const void *pData, uint8_t noBytes)
+{
+    const uint8_t *pByte = (const uint8_t*)pData;
+
+    while(noBytes > 0)
+    {
+        /* The check of free space and setting the flag need to be atomic with respect to
+           the interrupt. The global interrupt lock is released by the kernel when the task
+           is suspended. */
+        cli();
+        uint8_t noFree = getNoFreeBytes();
+        if(noFree == 0)
+        {
+            if(rtos_getIdxActiveTask() == RTOS_NO_TASKS)
+            {
+                /* The idle task must not suspend; it busy-waits for the interrupt. */
+                sei();
+            }
+            else
+            {
+                _isWriterWaiting = true;
+                rtos_waitForEvent(_evtTxSpace, /* all */ false, /* timeout */ 0);
+            }
+            continue;
+        }
+
+        /* The bytes are copied with interrupts locked so that concurrent writers can't
+           corrupt the write position. The lock time is bounded by the chunk size. */
+        if(noFree > SER_TX_CHUNK_SIZE)
+            noFree = SER_TX_CHUNK_SIZE;
+        if(noFree > noBytes)
+            noFree = noBytes;
+        noBytes -= noFree;
+
+        uint8_t idxWrite = _idxWrite;
+        do
+        {
+            _txBufAry[idxWrite & (SER_SIZE_OF_TX_BUFFER-1)] = *pByte++;
+            ++ idxWrite;
+        }
+        while(--noFree > 0);
+        _idxWrite = idxWrite;
+
+        /* Start the transmission. If it is already running, this doesn't do any harm. */
+        UCSR0B |= _BV(UDRIE0);
+        sei();
+    }
+} /* End of ser_write */
+
+
+
+
+/**
+ * Write a single character to the serial port. See \a ser_write for details.
+ *   @param c
+ * The character to write.
+ */
+
+void ser_putchar(char c)
+{
+    ser_write(&c, 1);
+
+} /* End of ser_putchar */
+
+
+
+
+/**
+ * Write a zero terminated string, which is located in the flash ROM, to the serial port.
+ * See \a ser_write for details. The string is copied chunk-wise through a small buffer on
+ * the stack, a chunk may contain up to #SER_TX_CHUNK_SIZE characters. The output of
+ * different tasks may be mixed up at the chunk borders.
+ *   @param flashStr
+ * The address of the string in the flash ROM, e.g. got from #RTOS_FLASH_STR.
+ */
+
+void ser_writeFlashStr(const char *flashStr)
+{
+    char chunkAry[SER_TX_CHUNK_SIZE];
+    while(true)
+    {
+        uint8_t noChars = 0;
+        char c;
+        while(noChars < SER_TX_CHUNK_SIZE  &&  (c = pgm_read_byte(flashStr)) != '\0')
+        {
+            chunkAry[noChars++] = c;
+            ++ flashStr;
+        }
+        if(noChars == 0)
+            break;
+
+        ser_write(chunkAry, noChars);
+    }
+} /* End of ser_writeFlashStr */
+
+
+
+
+/**
+ * Get the number of bytes, which are still waiting for transmission.
+ *   @return
+ * The number of bytes in the transmit buffer. The byte, which is currently being shifted
+ * out, doesn't count.
+ */
+
+uint8_t ser_getNoPendingBytes(void)
+{
+    cli();
+    const uint8_t noPendingBytes = (uint8_t)(_idxWrite - _idxRead);
+    sei();
+
+    return noPendingBytes;
+
+} /* End of ser_getNoPendingBytes */
+
+
+
+
+/**
+ * The interrupt "data register empty" of USART0. It transmits the next byte from the
+ * buffer or disables itself if the buffer is empty. When a chunk of bytes has been sent
+ * or the buffer has become empty, the waiting writers are resumed.
+ */
+
+ISR(ISR_USART0_UDRE)
+{
+    const uint8_t idxRead = _idxRead;
+    if(idxRead == _idxWrite)
+    {
+        /* Buffer is empty, stop the interrupt till the next write. */
+        UCSR0B &= ~_BV(UDRIE0);
+    }
+    else
+    {
+        UDR0 = _txBufAry[idxRead & (SER_SIZE_OF_TX_BUFFER-1)];
+        _idxRead = idxRead + 1;
+    }
+
+    if(_isWriterWaiting  &&  getNoFreeBytes() >= SER_TX_CHUNK_SIZE)
+    {
+        _isWriterWaiting = false;
+        rtos_sendEventFromISR(_evtTxSpace);
+    }
+
+    /* If a writer of higher priority has been resumed, then the kernel switches to it
+       now. */
+    rtos_leaveISR();
+
+} /* End of ISR(ISR_USART0_UDRE) */
+
+#endif /* RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON */
@@ -0,0 +1,79 @@
+#ifndef SER_SERIAL_INCLUDED
+#define SER_SERIAL_INCLUDED
+/**
+ * @file ser_serial.h
+ * Definition of global interface of module ser_serial.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The size of the transmit buffer in Byte. It needs to be a power of two in the range
+    2..128. The application may override the default in its rtos.config.h. */
+#ifndef SER_SIZE_OF_TX_BUFFER
+# define SER_SIZE_OF_TX_BUFFER  64
+#endif
+
+/** A writer, which found the transmit buffer full, is resumed only when this number of
+    bytes has been sent, so that it can write the next chunk at once. The number must not
+    exceed the size of the transmit buffer. The application may override the default in
+    its rtos.config.h. */
+#ifndef SER_TX_CHUNK_SIZE
+# define SER_TX_CHUNK_SIZE  (SER_SIZE_OF_TX_BUFFER/4)
+#endif
+
+
+/*
+ * Global type definitions
+ */
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize the serial port prior to its first use. */
+void ser_init(uint32_t baudRate, uintEventVec_t evtTxSpace);
+
+/** Write a sequence of bytes to the serial port, wait while the transmit buffer is full. */
+void ser_write(const void *pData, uint8_t noBytes);
+
+/** Write a single character to the serial port, wait while the transmit buffer is full. */
+void ser_putchar(char c);
+
+/** Write a zero terminated string from the flash ROM to the serial port. */
+void ser_writeFlashStr(const char *flashStr);
+
+/** Get the number of bytes, which are still waiting for transmission. */
+uint8_t ser_getNoPendingBytes(void);
+
+
+#endif  /* SER_SERIAL_INCLUDED */
@@ -0,0 +1,299 @@
+/**
+ * @file tim_softwareTimer.c
+ *   Software timers with callbacks. A periodic or time-triggered activity, which is as
+ * simple as incrementing a clock, needs a task of its own and a stack area, which is sized
+ * for the worst case of the task and the interrupts. Such activities can be implemented
+ * as callbacks of software timers, which share a single task and its stack.\n
+ *   A software timer is an application owned object of type tim_timer_t. It is started
+ * as one-shot timer or as periodic timer with tim_startTimer and stopped with
+ * tim_stopTimer; a one-shot timer stops itself when it elapses. The running timers are
+ * kept in a list, which is sorted by their due time. An ordinary RTuinOS task, the timer
+ * task, implements the timer service. Its task function consists of a single call of
+ * tim_runTimerTask, which never returns. The timer task waits till the first timer in
+ * the list elapses and calls its callback. An elapsing timer costs a list operation and a
+ * function call rather than a context switch. Moreover, the kernel has only one task to
+ * serve in its system timer tic instead of one per activity.\n
+ *   The timer task is scheduled like any other task. Its priority is the priority of all
+ * callbacks. A callback is preempted by tasks of higher priority but never by another
+ * callback. If several timers elapse in the same tic, their callbacks are called in the
+ * order, in which the timers have been started. A periodic timer counts as restarted
+ * when it elapses.
+ *   @remark
+ * A callback must not suspend, neither explicitly, e.g. by rtos_delay, nor implicitly
+ * inside a service like mbx_fetchWait. It would delay all other timers. A callback may
+ * however start and stop timers, including its own one.
+ *   @remark
+ * The timer task needs an event of its own, which is posted when a timer is started and
+ * becomes the first one in the list. The event must not be used by any other task.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   tim_initTimer
+ *   tim_startTimer
+ *   tim_stopTimer
+ *   tim_runTimerTask
+ * Local functions
+ *   linkTimer
+ *   unlinkTimer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "tim_softwareTimer.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The list of running timers, sorted by increasing due time. */
+static tim_timer_t *_pFirstTimer = NULL;
+
+/** The event, which makes the timer task reconsider the list of timers. It is 0 as long
+    as the timer task has not been started. */
+static uintEventVec_t _evtTimerListChanged = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Insert a timer into the sorted list of running timers. It is placed behind all timers,
+ * which elapse at the same time.
+ *   @param pTimer
+ * The timer object. Its due time is set.
+ *   @remark
+ * The function needs to be called with the interrupts disabled.
+ */
+
+static void linkTimer(tim_timer_t * const pTimer)
+{
+    tim_timer_t **ppT = &_pFirstTimer;
+
+    /* The due times are compared relative to each other; all of them are less than half
+       the range of the time data type ahead. */
+    while(*ppT != NULL  &&  (intTime_t)((*ppT)->timeDue - pTimer->timeDue) <= 0)
+        ppT = &(*ppT)->pNext;
+
+    pTimer->pNext = *ppT;
+    *ppT = pTimer;
+    pTimer->isRunning = true;
+
+} /* End of linkTimer */
+
+
+
+
+/**
+ * Take a timer out of the list of running timers.
+ *   @param pTimer
+ * The timer object. It needs to be running.
+ *   @remark
+ * The function needs to be called with the interrupts disabled.
+ */
+
+static void unlinkTimer(tim_timer_t * const pTimer)
+{
+    tim_timer_t **ppT = &_pFirstTimer;
+
+    while(*ppT != pTimer)
+    {
+        ASSERT(*ppT != NULL);
+        ppT = &(*ppT)->pNext;
+    }
+
+    *ppT = pTimer->pNext;
+    pTimer->isRunning = false;
+
+} /* End of unlinkTimer */
+
+
+
+
+/**
+ * Initialize a software timer object. The timer is not running. The function needs to be
+ * called once for each timer object before it is used the first time.
+ *   @param pTimer
+ * The timer object.
+ *   @param callback
+ * The function, which is called in the timer task, whenever the timer elapses.
+ */
+
+void tim_initTimer(tim_timer_t *pTimer, tim_timerCallback_t callback)
+{
+    ASSERT(callback != NULL);
+
+    pTimer->callback = callback;
+    pTimer->timeDue = 0;
+    pTimer->period = 0;
+    pTimer->isRunning = false;
+    pTimer->pNext = NULL;
+
+} /* End of tim_initTimer */
+
+
+
+
+/**
+ * Start a timer. If the timer is already running, it is restarted with the new timing.\n
+ *   The function may be called from setup(), from any task and from the callbacks of the
+ * timers but not from an interrupt service routine.
+ *   @param pTimer
+ * The timer object. It needs to be initialized by tim_initTimer.
+ *   @param delay
+ * The timer elapses the first time in the tic, which is \a delay tics ahead. The real
+ * delay is in the range \a delay-1 .. \a delay tics. If 0 then the callback is called as
+ * soon as the timer task becomes active. The range is 0 .. max(intTime_t).
+ *   @param period
+ * If not 0, the timer is a periodic timer and it elapses again every \a period tics. The
+ * period is kept strictly, it doesn't depend on the time the callbacks take. If the timer
+ * task can't keep up, then the missed callbacks are called one after another. If 0, the
+ * timer is a one-shot timer and it stops after it elapsed. The range is 0 ..
+ * max(intTime_t).
+ */
+
+void tim_startTimer(tim_timer_t *pTimer, uintTime_t delay, uintTime_t period)
+{
+    ASSERT(pTimer->callback != NULL  &&  (intTime_t)delay >= 0  &&  (intTime_t)period >= 0);
+
+    const uintTime_t time = rtos_getTime();
+    boolean isFirstTimer;
+
+    cli();
+    {
+        if(pTimer->isRunning)
+            unlinkTimer(pTimer);
+        pTimer->timeDue = time + delay;
+        pTimer->period = period;
+        linkTimer(pTimer);
+        isFirstTimer = pTimer == _pFirstTimer;
+    }
+    sei();
+
+    /* The timer task needs to wait for another deadline if the new timer elapses first. */
+    if(isFirstTimer  &&  _evtTimerListChanged != 0)
+        rtos_sendEvent(_evtTimerListChanged);
+
+} /* End of tim_startTimer */
+
+
+
+
+/**
+ * Stop a timer. The timer doesn't elapse any more. It's no error to stop a timer, which
+ * is not running.\n
+ *   The function may be called from setup(), from any task and from the callbacks of the
+ * timers but not from an interrupt service routine.
+ *   @param pTimer
+ * The timer object. It needs to be initialized by tim_initTimer.
+ */
+
+void tim_stopTimer(tim_timer_t *pTimer)
+{
+    /* If the timer was the first one then the timer task will wake up without a reason.
+       It doesn't harm and it's not worth a notification. */
+    cli();
+    {
+        if(pTimer->isRunning)
+            unlinkTimer(pTimer);
+    }
+    sei();
+
+} /* End of tim_stopTimer */
+
+
+
+
+/**
+ * The body of the timer task. The function calls the callbacks of the timers as they
+ * elapse. It never returns.
+ *   @param evtTimerListChanged
+ * The event, which is posted by tim_startTimer if the timer task needs to reconsider the
+ * list of timers. It must not be a timer event and it must not be used by any other
+ * task.
+ *   @remark
+ * The function must be called only from the task function of the timer task. The timer
+ * task can be started by any event, e.g. RTOS_EVT_DELAY_TIMER with delay zero.
+ */
+
+void tim_runTimerTask(uintEventVec_t evtTimerListChanged)
+{
+    ASSERT(evtTimerListChanged != 0
+           &&  (evtTimerListChanged & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+    _evtTimerListChanged = evtTimerListChanged;
+
+    while(true)
+    {
+        const uintTime_t time = rtos_getTime();
+
+        /* The list is inspected with the interrupts disabled. They stay disabled till the
+           task is suspended, if no timer has elapsed: No other task can start a timer in
+           between and the notification can't get lost. The suspend functions reenable the
+           interrupts. */
+        cli();
+        tim_timer_t * const pTimer = _pFirstTimer;
+        if(pTimer != NULL  &&  (intTime_t)(pTimer->timeDue - time) <= 0)
+        {
+            /* The first timer has elapsed. A periodic timer is immediately restarted, the
+               callback may still stop it. */
+            _pFirstTimer = pTimer->pNext;
+            pTimer->isRunning = false;
+            if(pTimer->period != 0)
+            {
+                pTimer->timeDue += pTimer->period;
+                linkTimer(pTimer);
+            }
+            sei();
+
+            pTimer->callback(pTimer);
+        }
+        else if(pTimer != NULL)
+        {
+            rtos_waitForEventTillDeadline( evtTimerListChanged
+                                         , /* all */ false
+                                         , /* timeDeadline */ pTimer->timeDue
+                                         , /* pRemainingTime */ NULL
+                                         );
+        }
+        else
+        {
+            rtos_waitForEvent(evtTimerListChanged, /* all */ false, /* timeout */ 0);
+        }
+    }
+} /* End of tim_runTimerTask */
@@ -0,0 +1,91 @@
+#ifndef TIM_SOFTWARE_TIMER_INCLUDED
+#define TIM_SOFTWARE_TIMER_INCLUDED
+/**
+ * @file tim_softwareTimer.h
+ * Definition of global interface of module tim_softwareTimer.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Global type definitions
+ */
+
+struct tim_timer_t;
+
+/** The callback of a software timer. It is called from the timer task when the timer
+    elapses and it needs to return after having done its job. It gets the elapsed timer
+    object. */
+typedef void (*tim_timerCallback_t)(struct tim_timer_t *pTimer);
+
+/** A software timer. The application owns the objects, normally as static data; the
+    timer service links the running timers into its sorted list. The members are private
+    to the timer service. */
+typedef struct tim_timer_t
+{
+    /** The function, which is called when the timer elapses. */
+    tim_timerCallback_t callback;
+
+    /** The point in time, when the timer elapses next time. */
+    uintTime_t timeDue;
+
+    /** The period of a periodic timer in system timer tics or 0 for a one-shot timer. */
+    uintTime_t period;
+
+    /** The timer is currently linked into the list of running timers. */
+    boolean isRunning;
+
+    /** The next running timer in the list, which is sorted by due time. */
+    struct tim_timer_t *pNext;
+
+} tim_timer_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize a software timer object. */
+void tim_initTimer(tim_timer_t *pTimer, tim_timerCallback_t callback);
+
+/** Start or restart a one-shot or periodic timer. */
+void tim_startTimer(tim_timer_t *pTimer, uintTime_t delay, uintTime_t period);
+
+/** Stop a timer. */
+void tim_stopTimer(tim_timer_t *pTimer);
+
+/** Implement the body of the timer task, which runs the callbacks of elapsed timers. */
+void tim_runTimerTask(uintEventVec_t evtTimerListChanged);
+
+
+#endif  /* TIM_SOFTWARE_TIMER_INCLUDED */
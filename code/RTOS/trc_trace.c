@@ -0,0 +1,388 @@
+/**
+ * @file trc_trace.c
+ *   A binary trace of application defined events. An entry of the trace consists of an
+ * event ID, a timestamp and a 16 Bit argument. It is written into a ring buffer in RAM; no
+ * text is formatted at the time the event occurs. Writing an entry takes about 50 CPU
+ * cycles, so that the trace can stay enabled in production builds.\n
+ *   Entries can be written by tasks and interrupt service routines. The buffer doesn't
+ * need a lock: On a single core, a short global interrupt lock of a few instructions makes
+ * the reservation of an entry atomic. If the buffer is full, then the eldest entry is
+ * overwritten; the loss is counted and reported when the entries are read.\n
+ *   The idle task drains the buffer by regularly calling trc_drain. The not yet read
+ * entries are written to the serial port in a compact hexadecimal text format, one line
+ * per entry. The lines can be mixed with other console output. The host tool trcDecode
+ * (see code/tools/trcDecode) turns them back into readable log lines.\n
+ *   If ASSERT fires, the complete buffer is dumped by trc_dump; this shows the history of
+ * events, which led to the failure.\n
+ *   The module is compiled only if #RTOS_USE_TRACE is set.
+ *   @remark
+ * The timestamps are taken from timer 0, which is used by Arduino's micros(). They wrap
+ * around after about 262 ms; the decoder can reconstruct the absolute time only if two
+ * subsequent entries are not further apart.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   trc_trace
+ *   trc_read
+ *   trc_getNewestEntries
+ *   trc_writeEntry
+ *   trc_drain
+ *   trc_dump
+ * Local functions
+ *   getTimestamp
+ *   isEntryInUse
+ *   writeChar
+ *   writeHex
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "trc_trace.h"
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+# include "ser_serial.h"
+#endif
+
+#if RTOS_USE_TRACE == RTOS_FEATURE_ON
+
+/*
+ * Defines
+ */
+
+#if TRC_NO_ENTRIES < 2  ||  TRC_NO_ENTRIES > 128  ||  (TRC_NO_ENTRIES & (TRC_NO_ENTRIES-1)) != 0
+# error The number of trace entries needs to be a power of two in the range 2..128
+#endif
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The counter of overflows of timer 0. It is maintained by Arduino's core library, see
+    wiring.c. */
+extern volatile unsigned long timer0_overflow_count;
+
+/** The ring buffer of trace entries. */
+static trc_entry_t _entryAry[TRC_NO_ENTRIES];
+
+/** The position of the next write into the buffer. The position indexes are cyclically
+    incremented and never wrapped explicitly. The number of unread entries is their
+    difference. */
+static volatile uint8_t _idxWrite = 0;
+
+/** The position of the next entry to read. */
+static volatile uint8_t _idxRead = 0;
+
+/** The number of entries, which have been overwritten before they were read. */
+static volatile uint16_t _noLostEntries = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the current time in units of #TRC_US_PER_TIMESTAMP microseconds. The function
+ * combines the counter of timer 0 with the low byte of Arduino's counter of overflows of
+ * this timer.
+ *   @return
+ * Get the time, which wraps around after 2^16 units.
+ *   @remark
+ * The function must be called with interrupts globally disabled.
+ */
+
+static inline uint16_t getTimestamp(void)
+{
+    uint8_t noOverflows = (uint8_t)timer0_overflow_count;
+    const uint8_t cnt = TCNT0;
+
+    /* The overflow interrupt may already be pending but not served yet. This is the same
+       consideration as made by micros(). */
+    if((TIFR0 & _BV(TOV0)) != 0  &&  cnt < 255)
+        ++ noOverflows;
+
+    return ((uint16_t)noOverflows << 8) | cnt;
+
+} /* End of getTimestamp */
+
+
+
+
+/**
+ * Check if an entry of the buffer has ever been written. At the beginning, before the
+ * buffer has been filled the first time, some entries are still empty.
+ *   @return
+ * Get true if the entry holds a traced event.
+ *   @param pEntry
+ * The entry to check.
+ */
+
+static inline boolean isEntryInUse(const trc_entry_t *pEntry)
+{
+    return pEntry->idEvent != 0  ||  pEntry->timestamp != 0  ||  pEntry->arg != 0;
+
+} /* End of isEntryInUse */
+
+
+
+
+/**
+ * Write an entry into the trace buffer. If the buffer is full, the eldest entry is
+ * overwritten.\n
+ *   The function can be called from any context, including interrupt service routines
+ * and code, which has globally disabled the interrupts. It takes about 50 CPU cycles.
+ *   @param idEvent
+ * The ID of the traced event. The application should use IDs below
+ * #TRC_ID_FIRST_RESERVED.
+ *   @param arg
+ * An argument of the traced event, which is saved in the entry.
+ */
+
+void trc_trace(uint8_t idEvent, uint16_t arg)
+{
+    const uint8_t sreg = SREG;
+    cli();
+
+    const uint8_t idxWrite = _idxWrite;
+    if((uint8_t)(idxWrite - _idxRead) >= TRC_NO_ENTRIES)
+    {
+        /* The buffer is full, drop the eldest entry. */
+        ++ _idxRead;
+        ++ _noLostEntries;
+    }
+
+    trc_entry_t * const pEntry = &_entryAry[idxWrite & (TRC_NO_ENTRIES-1)];
+    pEntry->timestamp = getTimestamp();
+    pEntry->arg = arg;
+    pEntry->idEvent = idEvent;
+    _idxWrite = idxWrite + 1;
+
+    SREG = sreg;
+
+} /* End of trc_trace */
+
+
+
+
+/**
+ * Take the eldest entry, which has not been read yet, from the trace buffer. If entries
+ * had been lost before, then a pseudo entry with ID #TRC_ID_LOST is returned first; its
+ * argument is the number of lost entries.
+ *   @return
+ * Get true if an entry is returned or false if the buffer is empty.
+ *   @param pEntry
+ * The entry is returned by reference.
+ *   @remark
+ * The function must not be called concurrently from different tasks.
+ */
+
+boolean trc_read(trc_entry_t *pEntry)
+{
+    boolean gotEntry = false;
+
+    /* A writer may overwrite the entry while it is copied, so the copy is made under
+       global interrupt lock. */
+    cli();
+    if(_noLostEntries > 0)
+    {
+        pEntry->timestamp = getTimestamp();
+        pEntry->arg = _noLostEntries;
+        pEntry->idEvent = TRC_ID_LOST;
+        _noLostEntries = 0;
+        gotEntry = true;
+    }
+    else if(_idxRead != _idxWrite)
+    {
+        *pEntry = _entryAry[_idxRead & (TRC_NO_ENTRIES-1)];
+        ++ _idxRead;
+        gotEntry = true;
+    }
+    sei();
+
+    return gotEntry;
+
+} /* End of trc_read */
+
+
+
+
+/**
+ * Copy the newest entries of the trace buffer, including those, which have already been
+ * read. The buffer is not modified. The function is used to save the history of events
+ * in the crash record of a failing assertion, see crr_crashRecord.c.
+ *   @return
+ * Get the number of copied entries. It is less than \a maxNoEntries if the buffer doesn't
+ * hold as many entries yet.
+ *   @param entryAry
+ * The entries are copied into this array, from the eldest to the newest one.
+ *   @param maxNoEntries
+ * The size of \a entryAry. The function copies at maximum #TRC_NO_ENTRIES entries.
+ *   @remark
+ * The buffer is not locked while it is copied. If other contexts keep on tracing, then
+ * the copy may contain inconsistent entries. The caller may globally disable the
+ * interrupts before the call.
+ */
+
+uint8_t trc_getNewestEntries(trc_entry_t entryAry[], uint8_t maxNoEntries)
+{
+    if(maxNoEntries > TRC_NO_ENTRIES)
+        maxNoEntries = TRC_NO_ENTRIES;
+
+    /* Find the eldest of the requested entries, which is in use. */
+    const uint8_t idxEnd = _idxWrite;
+    uint8_t idx = idxEnd - maxNoEntries;
+    while(idx != idxEnd  &&  !isEntryInUse(&_entryAry[idx & (TRC_NO_ENTRIES-1)]))
+        ++ idx;
+
+    uint8_t noEntries = 0;
+    while(idx != idxEnd)
+        entryAry[noEntries++] = _entryAry[idx++ & (TRC_NO_ENTRIES-1)];
+
+    return noEntries;
+
+} /* End of trc_getNewestEntries */
+
+
+
+
+/**
+ * Write a character to the serial port. This is the same channel as used by ASSERT.
+ *   @param c
+ * The character.
+ */
+
+static void writeChar(char c)
+{
+#if RTOS_USE_SERIAL_DRIVER == RTOS_FEATURE_ON
+    ser_putchar(c);
+#else
+    Serial.write(c);
+#endif
+} /* End of writeChar */
+
+
+
+
+/**
+ * Write a number as hexadecimal digits to the serial port.
+ *   @param number
+ * The number to write.
+ *   @param noDigits
+ * The number of digits to write, 2 or 4.
+ */
+
+static void writeHex(uint16_t number, uint8_t noDigits)
+{
+    while(noDigits-- > 0)
+    {
+        const uint8_t nibble = (uint8_t)(number >> (4*noDigits)) & 0xf;
+        writeChar(nibble < 10? '0'+nibble: 'a'-10+nibble);
+    }
+} /* End of writeHex */
+
+
+
+
+/**
+ * Write an entry as a line of text to the serial port. The format is a dollar sign,
+ * followed by two hexadecimal digits of the ID and four digits of each, timestamp and
+ * argument. This is the format, which is understood by the host tool trcDecode.
+ *   @param pEntry
+ * The entry to write.
+ */
+
+void trc_writeEntry(const trc_entry_t *pEntry)
+{
+    writeChar('$');
+    writeHex(pEntry->idEvent, 2);
+    writeHex(pEntry->timestamp, 4);
+    writeHex(pEntry->arg, 4);
+    writeChar('\r');
+    writeChar('\n');
+
+} /* End of trc_writeEntry */
+
+
+
+
+/**
+ * Write all entries, which have not been read yet, to the serial port. The function is
+ * intended to be regularly called by the idle task, e.g. from loop().
+ *   @remark
+ * The function must not be called concurrently from different tasks. It globally enables
+ * the interrupts.
+ */
+
+void trc_drain(void)
+{
+    trc_entry_t entry;
+    while(trc_read(&entry))
+        trc_writeEntry(&entry);
+
+} /* End of trc_drain */
+
+
+
+
+/**
+ * Write all entries of the trace buffer to the serial port, including those, which have
+ * already been read. The function is called by ASSERT; it shows the history of events,
+ * which led to the failure. It may be called by the application, too.
+ *   @remark
+ * The buffer is not locked while it is written. If other contexts keep on tracing, then
+ * the dump may contain inconsistent entries.
+ */
+
+void trc_dump(void)
+{
+    static const char msgHead[] PROGMEM = "Trace dump:";
+    const char *pC = msgHead;
+    char c;
+    while((c = pgm_read_byte(pC++)) != '\0')
+        writeChar(c);
+    writeChar('\r');
+    writeChar('\n');
+
+    /* The entries are written from the eldest to the newest one. Empty entries are
+       skipped. */
+    const uint8_t idxEnd = _idxWrite;
+    uint8_t idx = idxEnd - TRC_NO_ENTRIES;
+    do
+    {
+        const trc_entry_t * const pEntry = &_entryAry[idx & (TRC_NO_ENTRIES-1)];
+        if(isEntryInUse(pEntry))
+            trc_writeEntry(pEntry);
+    }
+    while(++idx != idxEnd);
+
+} /* End of trc_dump */
+
+#endif /* RTOS_USE_TRACE == RTOS_FEATURE_ON */
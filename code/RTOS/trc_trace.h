@@ -0,0 +1,120 @@
+#ifndef TRC_TRACE_INCLUDED
+#define TRC_TRACE_INCLUDED
+/**
+ * @file trc_trace.h
+ * Definition of global interface of module trc_trace.c
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of entries of the trace buffer. It needs to be a power of two in the range
+    2..128. Each entry takes five Byte of RAM. The application may override the default in
+    its rtos.config.h. */
+#ifndef TRC_NO_ENTRIES
+# define TRC_NO_ENTRIES     32
+#endif
+
+/** The event IDs from this value on are reserved for RTuinOS. */
+#define TRC_ID_FIRST_RESERVED   0xf0
+
+/** The kernel has switched to another task. The argument holds the index of the left
+    task in the high byte and the index of the new active task in the low byte. The idle
+    task has the index #RTOS_NO_TASKS. Written only if #RTOS_USE_KERNEL_TRACE is set. */
+#define TRC_ID_TASK_SWITCH      0xf0
+
+/** Events have been posted. The argument holds the lower 16 bits of the event vector. */
+#define TRC_ID_SEND_EVENT       0xf1
+
+/** The active task waits for events. The argument holds the lower 16 bits of the event
+    mask. */
+#define TRC_ID_WAIT_FOR_EVENT   0xf2
+
+/** A task is resumed by one of its timers. The argument is the index of the task. */
+#define TRC_ID_TIMEOUT          0xf3
+
+/** A mutex or semaphore is handed over to a task. The argument holds the index of the
+    task in the high byte and the index of the event of the synchronization object in the
+    low byte. */
+#define TRC_ID_SYNC_OBJ_HAND_OVER 0xf4
+
+/** The event ID of the pseudo entry, which reports the number of entries, which had been
+    overwritten before they were read. */
+#define TRC_ID_LOST             0xff
+
+/** The unit of the timestamp of a trace entry in microseconds. */
+#define TRC_US_PER_TIMESTAMP    4
+
+
+/*
+ * Global type definitions
+ */
+
+/** An entry of the trace buffer. */
+typedef struct trc_entry_t
+{
+    /** The time when the entry was written in units of #TRC_US_PER_TIMESTAMP
+        microseconds. The timestamp wraps around after about 262 ms. */
+    uint16_t timestamp;
+
+    /** The application defined argument of the traced event. */
+    uint16_t arg;
+
+    /** The ID of the traced event. IDs from #TRC_ID_FIRST_RESERVED on are reserved. */
+    uint8_t idEvent;
+
+} trc_entry_t;
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+/** Write an entry into the trace buffer. Can be called from tasks and interrupts. */
+void trc_trace(uint8_t idEvent, uint16_t arg);
+
+/** Take the eldest entry from the trace buffer. */
+boolean trc_read(trc_entry_t *pEntry);
+
+/** Copy the newest entries of the trace buffer without modifying it. */
+uint8_t trc_getNewestEntries(trc_entry_t entryAry[], uint8_t maxNoEntries);
+
+/** Write an entry as a line of text to the serial port. */
+void trc_writeEntry(const trc_entry_t *pEntry);
+
+/** Write all entries, which have not been read yet, to the serial port. */
+void trc_drain(void);
+
+/** Write all entries of the trace buffer to the serial port, e.g. after a failure. */
+void trc_dump(void);
+
+
+#endif  /* TRC_TRACE_INCLUDED */
@@ -54,6 +54,16 @@
 /** Pin 13 has an LED connected on most Arduino boards. */
 #define LED 13
  
+/** The assertions on the world time, which is measured with millis(), require a real
+    time system. In the host simulation both, the system timer tic and the delays, depend
+    on the load of the host and the assertions would fire occasionally. They are not
+    checked there. */
+#ifdef RTOS_HOST_SIMULATION
+# define ASSERT_TIMING(cond)    {(void)(cond);}
+#else
+# define ASSERT_TIMING(cond)    ASSERT(cond)
+#endif
+
 /** Stack size of all the tasks. */
 #define STACK_SIZE_TASK00_C0   256
 #define STACK_SIZE_TASK01_C0   256
@@ -165,7 +175,8 @@ void rtos_enableIRQTimerTic(void)
 {
     Serial.println("Overloaded interrupt initialization rtos_enableIRQTimerTic in " __FILE__);
     
-#ifdef __AVR_ATmega2560__
+#if defined(__AVR_ATmega2560__)  ||  defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)  \
+    ||  defined(RTOS_HOST_SIMULATION)
     /* Initialization of the system timer: Arduino (wiring.c, init()) has initialized
        timer2 to count up and down (phase correct PWM mode) with prescaler 64 and no TOP
        value (i.e. it counts from 0 till MAX=255). This leads to a call frequency of
@@ -221,8 +232,8 @@ static void task00_class00(uint16_t initCondition)
         uint32_t ti0 = millis();
         delay(600 /* ms */);
         uint16_t dT = (uint16_t)(millis() - ti0);
-        ASSERT(dT >= 599)
-        ASSERT(dT < 609);
+        ASSERT_TIMING(dT >= 599)
+        ASSERT_TIMING(dT < 609);
 
         /* Wait for an event from the idle task. The idle task is asynchrounous and its
            speed depends on the system load. The behavior is thus not perfectly
@@ -271,8 +282,8 @@ static void task01_class00(uint16_t initCondition)
         uint32_t ti0 = millis();
         delay(8 /* ms */);
         uint16_t dT = (uint16_t)(millis() - ti0);
-        ASSERT(dT >= 7);
-        ASSERT(dT <= 25);
+        ASSERT_TIMING(dT >= 7);
+        ASSERT_TIMING(dT <= 25);
 
         /* Release the high priority task for a single cycle. It should continue operation
            before we leave the suspend function here. Check it. */
@@ -282,7 +293,7 @@ static void task01_class00(uint16_t initCondition)
         ASSERT(u+1 == _noLoopsTask00_C1)
         ASSERT(_noLoopsTask01_C0 == _noLoopsTask00_C1)
         dT = (uint16_t)(millis() - ti0);
-        ASSERT(dT <= 2);
+        ASSERT_TIMING(dT <= 2);
         
         /* The body of this task takes up to about 26 ms (see before). If it suspends here,
            the other round robin task will most often become active and consume the CPU the
@@ -300,7 +311,7 @@ static void task01_class00(uint16_t initCondition)
         uint32_t tiCycleEnd = millis();
         dT = (uint16_t)(tiCycleEnd - tiCycle0);
         tiCycle0 = tiCycleEnd;
-        ASSERT(dT <= 62);
+        ASSERT_TIMING(dT <= 62);
     }
 } /* End of task01_class00 */
 
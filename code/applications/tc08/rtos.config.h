@@ -126,6 +126,12 @@
     doc2549.pdf (see http://www.atmel.com). */
 #define RTOS_ISR_USER_00    TIMER4_OVF_vect
 
+/** The pair of operations, which mask and unmask application interrupt 0 in
+    rtos_enterCriticalSection and rtos_leaveCriticalSection, see
+    #RTOS_MASK_KERNEL_INTERRUPTS. */
+#define RTOS_MASK_IRQ_USER_00()     {TIMSK4 &= ~_BV(TOIE4);}
+#define RTOS_UNMASK_IRQ_USER_00()   {TIMSK4 |= _BV(TOIE4);}
+
 
 /** Enable the application defined interrupt 1. See #RTOS_USE_APPL_INTERRUPT_00 for
     details. */
@@ -135,6 +141,16 @@
     #RTOS_ISR_USER_00 for details. */
 #define RTOS_ISR_USER_01    TIMER5_OVF_vect
 
+/** The pair of operations, which mask and unmask application interrupt 1. */
+#define RTOS_MASK_IRQ_USER_01()     {TIMSK5 &= ~_BV(TOIE5);}
+#define RTOS_UNMASK_IRQ_USER_01()   {TIMSK5 |= _BV(TOIE5);}
+
+
+/** The scheduling code of the kernel runs with open interrupts; only the system timer tic
+    and the two application interrupts are masked meanwhile. The application has no other
+    interrupts, which access the kernel. */
+#define RTOS_USE_NESTED_INTERRUPTS  RTOS_FEATURE_ON
+
 
 /** A macro which expands to the code which defines all types which are related to the
     system timer. We need the unsigned and the related signed type. The macro is applied
@@ -183,9 +199,7 @@
 # define rtos_enterCriticalSection()                                        \
 {                                                                           \
     cli();                                                                  \
-    TIMSK2 &= ~_BV(TOIE2);                                                  \
-    TIMSK4 &= ~_BV(TOIE4);                                                  \
-    TIMSK5 &= ~_BV(TOIE5);                                                  \
+    RTOS_MASK_KERNEL_INTERRUPTS();                                          \
     sei();                                                                  \
                                                                             \
 } /* End of macro rtos_enterCriticalSection */
@@ -204,9 +218,9 @@
  */
 # define rtos_leaveCriticalSection()                                        \
 {                                                                           \
-    TIMSK2 |= _BV(TOIE2);                                                   \
-    TIMSK4 |= _BV(TOIE4);                                                   \
-    TIMSK5 |= _BV(TOIE5);                                                   \
+    cli();                                                                  \
+    RTOS_UNMASK_KERNEL_INTERRUPTS();                                        \
+    sei();                                                                  \
                                                                             \
 } /* End of macro rtos_leaveCriticalSection */
 #else
@@ -144,7 +144,8 @@
     typedef int##noBits##_t intTime_t;
 
 
-#ifdef __AVR_ATmega2560__
+#if defined(__AVR_ATmega2560__)  ||  defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)  \
+    ||  defined(RTOS_HOST_SIMULATION)
 /**
  * This routine in cooperation with rtos_leaveCriticalSection makes the code sequence
  * located between the two functions atomic with respect to operations of the RTuinOS task
@@ -195,7 +196,8 @@
 
 
 
-#ifdef __AVR_ATmega2560__
+#if defined(__AVR_ATmega2560__)  ||  defined(__AVR_ATmega328P__)  ||  defined(__AVR_ATmega1284P__)  \
+    ||  defined(RTOS_HOST_SIMULATION)
 /**
  * This macro is the counterpart of #rtos_enterCriticalSection. Please refer to
  * #rtos_enterCriticalSection for deatils.
@@ -94,6 +94,16 @@
 
 
 
+/** The assertions on the world time, which is measured with millis(), require a real
+    time system. In the host simulation both, the system timer tic and the delays, depend
+    on the load of the host and the assertions would fire occasionally. They are not
+    checked there. */
+#ifdef RTOS_HOST_SIMULATION
+# define ASSERT_TIMING(cond)    {(void)(cond);}
+#else
+# define ASSERT_TIMING(cond)    ASSERT(cond)
+#endif
+
 /** Pin 13 has an LED connected on most Arduino boards. */
 #define LED 13
  
@@ -191,7 +201,7 @@ static void taskT0C0(uint16_t taskCondition)
         tiCycle = millis();
 #ifndef NDEBUG
         float tiCycleRel = (tiCycle-ti) * (1.0/1000.0 / (TIME_IN_MS(TI_CYCLE_MS)/490.1961));
-        ASSERT(tiCycleRel >= 0.9  &&  tiCycleRel <= 1.1);
+        ASSERT_TIMING(tiCycleRel >= 0.9  &&  tiCycleRel <= 1.1);
 #endif
         ti = tiCycle;
     }
@@ -223,7 +233,7 @@ static void taskT0C1(uint16_t taskCondition)
         tiCycle = millis();
 #ifdef DEBUG
         float tiCycleRel = (tiCycle-ti) * (1.0/1000.0 / (TIME_IN_MS(TI_CYCLE_MS)/490.1961));
-        ASSERT(tiCycleRel >= 0.9  &&  tiCycleRel <= 1.1);
+        ASSERT_TIMING(tiCycleRel >= 0.9  &&  tiCycleRel <= 1.1);
 #endif
         rtos_delay(TIME_IN_MS(3));  /* Delay without load. */
         delayMicroseconds(/* tiDelayInuS */ 7 * 1000u); /* 7 of 30 ms, i.e. 23% load. */
@@ -264,7 +274,7 @@ static void taskT0C2(uint16_t taskCondition)
         /* The boundaries for the test need to be wider here; we have a resolution of
            millis() of 1 ms in relation to the cycle time of 10 ms, the basic accuracy of
            the computation itself is thus only 10%. */
-        ASSERT(tiCycleRel >= 0.8  &&  tiCycleRel <= 1.2);
+        ASSERT_TIMING(tiCycleRel >= 0.8  &&  tiCycleRel <= 1.2);
 
         delayMicroseconds(/* tiDelayInuS */ 2 * 1000u); /* 2 of 10 ms, i.e. 20% load. */
         rtos_delay(TIME_IN_MS(2));  /* Delay without load. */
@@ -59,6 +59,40 @@ void integerSineZ_step(void)
   }
 }
 
+/* Model block step function: Computes noSamples consecutive steps of the model in a
+ * tight loop. The outputs are written into the caller's buffer yAry, the external output
+ * integerSineZ_Y.y is set to the last of them. The states are held in local variables
+ * during the loop and written back to integerSineZ_DWork only once. The result is
+ * identical to noSamples calls of integerSineZ_step. */
+void integerSineZ_stepBlock(int16_T yAry[], uint8_T noSamples)
+{
+  /* local copies of the block states */
+  int16_T rtb_sig_z1 = integerSineZ_DWork.UnitDelay_1_DSTATE;
+  int16_T rtb_sig_z2 = integerSineZ_DWork.UnitDelay_2_DSTATE;
+  int16_T rtb_sig_y = integerSineZ_Y.y;
+
+  while (noSamples-- > 0U) {
+    /* Sum: '<Root>/Sum' incorporates:
+     *  Gain: '<Root>/Gain'
+     *  UnitDelay: '<Root>/UnitDelay_1'
+     *  UnitDelay: '<Root>/UnitDelay_2'
+     */
+    rtb_sig_y = ((int16_T)((int32_T)32188 * (int32_T)rtb_sig_z1 >> 15) << 1U) -
+      rtb_sig_z2;
+
+    /* Outport: '<Root>/y' */
+    *yAry++ = rtb_sig_y;
+
+    /* Update for UnitDelay: '<Root>/UnitDelay_2' and '<Root>/UnitDelay_1' */
+    rtb_sig_z2 = rtb_sig_z1;
+    rtb_sig_z1 = rtb_sig_y;
+  }
+
+  integerSineZ_Y.y = rtb_sig_y;
+  integerSineZ_DWork.UnitDelay_2_DSTATE = rtb_sig_z2;
+  integerSineZ_DWork.UnitDelay_1_DSTATE = rtb_sig_z1;
+}
+
 /* Model initialize function */
 void integerSineZ_initialize(void)
 {
@@ -64,6 +64,7 @@ extern ExternalOutputs_integerSineZ integerSineZ_Y;
 /* Model entry point functions */
 extern void integerSineZ_initialize(void);
 extern void integerSineZ_step(void);
+extern void integerSineZ_stepBlock(int16_T yAry[], uint8_T noSamples);
 extern void integerSineZ_terminate(void);
 
 /* Real-time Model object */
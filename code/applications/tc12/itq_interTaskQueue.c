@@ -32,6 +32,7 @@
  */
 /* Module interface
  *   itq_writeElem
+ *   itq_writeElems
  *   itq_readElem
  * Local functions
  */
@@ -129,6 +130,46 @@ void itq_writeElem(int16_t queuedElem)
 
 
 
+/**
+ * Append a block of elements to the queue. The function behaves like \a noElems calls of
+ * itq_writeElem but the elements are copied in a single critical section. Then the related
+ * semaphore is incremented by \a noElems.
+ *   @param queuedElemAry
+ * The values to append to the queue, in the order of the array.
+ *   @param noElems
+ * The number of elements in \a queuedElemAry.
+ *   @see void itq_writeElem(int16_t)
+ */
+
+void itq_writeElems(const int16_t queuedElemAry[], uint8_t noElems)
+{
+    uint8_t u;
+
+    rtos_enterCriticalSection();
+    {
+        uint8_t writePos = _writePos;
+        for(u=0; u<noElems; ++u)
+        {
+            _ringBuf[writePos++] = queuedElemAry[u];
+
+            /* An overrun is a failure in our test case, see itq_writeElem. */
+            ASSERT(writePos != _readPos);
+        }
+        _writePos = writePos;
+    }
+    rtos_leaveCriticalSection();
+
+    /* The semaphore is incremented only after copying all the data; the first resumed
+       consumer will find the complete block. Each call of rtos_sendEvent increments the
+       semaphore by one. */
+    for(u=0; u<noElems; ++u)
+        rtos_sendEvent(EVT_SEMAPHORE_ELEM_IN_QUEUE);
+
+} /* End of itq_writeElems */
+
+
+
+
 /**
  * Read next element from the queue. The caller of the function needs to have the related
  * semaphore acquired; this guarantees the availability of at least one element in the
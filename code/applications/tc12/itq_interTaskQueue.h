@@ -45,6 +45,7 @@
  */
 
 void itq_writeElem(int16_t queuedElem);
+void itq_writeElems(const int16_t queuedElemAry[], uint8_t noElems);
 int16_t itq_readElem();
 
 
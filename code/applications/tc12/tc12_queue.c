@@ -5,9 +5,9 @@
  * is of higher priority, waits for queued data and prints the values to the terminal
  * output. How to build queues on semaphores for safe and polling-free inter-task
  * communication is demonstrated by this code sample.\n
- *   Such an architecture basically leads to a simple pattern. The producer puts one sample
- * into the queue. The consumer gets immediately awaken as he has the higher priority. He
- * consumes the sample and goes sleeping; control returns to the consumer.\n
+ *   Such an architecture basically leads to a simple pattern. The producer puts a block of
+ * samples into the queue. The consumer gets immediately awaken as he has the higher
+ * priority. He consumes the samples and goes sleeping; control returns to the consumer.\n
  *   To make this pattern somewhat more complex and to demonstrate the capability of
  * combining wait-for-event conditions to a more complex resume condition we have defined a
  * second phase of processing. After a predetermined number of the simple producer-consumer
@@ -76,6 +76,10 @@
  
 /** Common stack size of tasks. */
 #define STACK_SIZE   256
+
+/** The producer computes the samples of the sine in blocks of this size; there's one
+    call of the block step function of the model and one write into the queue per block. */
+#define NO_SAMPLES_PER_BLOCK    4
  
  
 /** The number of system timer tics required to implement the time span given in Milli
@@ -136,7 +140,7 @@ uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS] = {0};
 
 /**
  * The function code of the producer task. This function code is regularly called. It
- * unconditionally computes a data sample and puts it into the queue.
+ * unconditionally computes a block of data samples and puts them into the queue.
  */ 
 
 static void taskT0C0_producer()
@@ -164,19 +168,22 @@ static void taskT0C0_producer()
     printf("Producer:\n  Time: %3lu\n  CPU load: %5.1f%%\n", tiNow-tiLastCall_, 0.5*_cpuLoad);
     tiLastCall_ = tiNow;
     
-    /* Produce data. */
-    integerSineZ_step();
-    int16_t nextSampleSine = integerSineZ_Y.y;
-
-    /* Queue the data. This step implicitly increments the related semaphore. A client of
-       the queue gets the notification that a data element is available. In our specific
-       test case, and in the first phase of the test, this will make the consumer shortly
-       due and active: It will just invoke the command to wait for the mutex, which grants
-       access to the Serial object, and then we are back here. */
-    itq_writeElem(nextSampleSine);
+    /* Produce data. A block of samples is computed in a single call of the model. */
+    int16_t sampleSineAry[NO_SAMPLES_PER_BLOCK];
+    integerSineZ_stepBlock(sampleSineAry, NO_SAMPLES_PER_BLOCK);
+
+    /* Queue the data. This step implicitly increments the related semaphore once per
+       sample. A client of the queue gets the notification that data elements are
+       available. In our specific test case, and in the first phase of the test, this will
+       make the consumer shortly due and active: It will just invoke the command to wait
+       for the mutex, which grants access to the Serial object, and then we are back
+       here. */
+    itq_writeElems(sampleSineAry, NO_SAMPLES_PER_BLOCK);
     
     /* Do some more reporting after task switch hence and force. We still own the mutex. */
-    printf("  Queued data sample %8lu = %.6f\n", cnt_++, nextSampleSine/32768.0);
+    uint8_t u;
+    for(u=0; u<NO_SAMPLES_PER_BLOCK; ++u)
+        printf("  Queued data sample %8lu = %.6f\n", cnt_++, sampleSineAry[u]/32768.0);
     
     /* We need to release the mutex, so that the consumer can report its activities. */
     rtos_sendEvent(EVT_MUTEX_SERIAL);
@@ -186,7 +193,8 @@ static void taskT0C0_producer()
 
 
 /**
- * The producer task. It unconditionally computes a data sample and puts it into the queue.
+ * The producer task. It unconditionally computes a block of data samples and puts them
+ * into the queue.
  *   @param initCondition
  * The task gets the vector of events, which made it initially due.
  *   @remark
@@ -196,7 +204,8 @@ static void taskT0C0_producer()
 static void tT0C0(uint16_t initCondition)
 
 {
-#define TASK_TIME  120  /* ms */
+    /* The task period is the duration of a block of samples, 120 ms per sample. */
+#define TASK_TIME  (NO_SAMPLES_PER_BLOCK*120)  /* ms */
 
     /* Initialize the external sinus generator module. */
     integerSineZ_initialize();
@@ -26,17 +26,13 @@
 
 #include <Arduino.h>
 #include "rtos.h"
+#include "asc_adcScan.h"
 
 
 /*
  * Defines
  */
 
-/** Scaling from binary ADC results to voltage (e.g. adc_buttonVoltage) in V. worldValue =
-    #ADC_SCALING_BIN_TO_V(binaryValue) [V]. */
-#define ADC_SCALING_BIN_TO_V(binVal)                                                        \
-            ((ADC_U_REF/(double)(ADC_NO_AVERAGED_SAMPLES)/1024.0)*(double)(binVal))
-
 /** Do not change: The ADC input which the buttons of the LCD shield are connected to. */
 #define ADC_INPUT_LCD_SHIELD_BUTTONS    0
 
@@ -45,29 +41,64 @@
 #define ADC_INPUT_INTERNAL_BAND_GAP 0x1e
 
 /** The number of subsequent ADC conversion results, which are averaged before the mean
-    value is passed to the waiting client tasks. The values 1..64 are possible. The smaller
-    the value the higher the overhead of the task processing. A value greater than about 40
-    leads to a significant degradation of the responsiveness to button down events. */
-#define ADC_NO_AVERAGED_SAMPLES     32
+    value is passed to the waiting client tasks. The number is configured for the ADC scan
+    in rtos.config.h. */
+#define ADC_NO_AVERAGED_SAMPLES     ASC_NO_AVERAGED_SAMPLES
 
 /** Value of ADC register ADMUX/REFS1:0. It selects the reference voltage or full scale
-    value respectively. 1 means Ucc=5V, 2 means 1.1 V and 3 means 2.56 V. The internal
-    references (1.1 V and 2.56 V are related to each other and undergo the same errors. The
-    accuracy of these reference voltages is poor (about 5% deviation), the stabilized
-    operational voltage seems to be more accurate. */
-#define ADC_VAL_ADMUX_REFS    1
+    value respectively. The value is configured for the ADC scan in rtos.config.h. */
+#define ADC_VAL_ADMUX_REFS    ASC_ADC_REFS
 
-/** The reference voltage as floating point value for scaling purpose. */
+/** The reference voltage in mV as integer value for scaling purpose. */
 #if ADC_VAL_ADMUX_REFS == 1
-# define ADC_U_REF 5.0
+# define ADC_U_REF_MV 5000u
 #elif ADC_VAL_ADMUX_REFS == 2
-# define ADC_U_REF 1.1
+# define ADC_U_REF_MV 1100u
 #elif ADC_VAL_ADMUX_REFS == 3
-# define ADC_U_REF 2.56
+# define ADC_U_REF_MV 2560u
 #else
 # error Illegal value for ADMUX/REFS (External reference is not supported)
 #endif
 
+/** The scaling from a sum of \a noSamples binary ADC results to a voltage in mV as
+    fixed-point number with 16 fractional bits (Q16). With literal arguments, the
+    value is computed at compile time; no floating point operation is found in the
+    machine code. The scaling is applied with #ADC_SCALE_BIN_TO_MV. The range of \a
+    noSamples is 1..1000. */
+#define ADC_SCALING_BIN_TO_MV_Q16(noSamples)                                                \
+            ((uint32_t)((((uint64_t)ADC_U_REF_MV << 16) + (noSamples)*512ull)               \
+                        / ((noSamples)*1024ull)                                             \
+                       )                                                                    \
+            )
+
+/** Scaling from a sum of binary ADC results to voltage in mV. The product of the sum of
+    \a noSamples results and the Q16 scaling is always less than ADC_U_REF_MV*2^16, so
+    it fits into 32 Bit. The result is rounded. worldValue =
+    #ADC_SCALE_BIN_TO_MV(binaryValue, #ADC_SCALING_BIN_TO_MV_Q16(noSamples)) [mV]. */
+#define ADC_SCALE_BIN_TO_MV(binVal, scalingQ16)                                             \
+            ((uint16_t)(((uint32_t)(binVal)*(scalingQ16) + 0x8000ul) >> 16))
+
+/** Scaling from binary ADC results as found in e.g. adc_buttonVoltage to voltage in mV.
+    worldValue = #ADC_SCALING_BIN_TO_MV(binaryValue) [mV]. */
+#define ADC_SCALING_BIN_TO_MV(binVal)                                                       \
+            ADC_SCALE_BIN_TO_MV(binVal, ADC_SCALING_BIN_TO_MV_Q16(ADC_NO_AVERAGED_SAMPLES))
+
+/** The inverse scaling: A voltage in mV is converted to the binary value, which is
+    compatible with e.g. adc_buttonVoltage. Used with a literal, the result is a compile
+    time constant for the comparison with measured values. */
+#define ADC_MV_TO_BIN(mV)                                                                   \
+            ((uint16_t)(((uint32_t)(mV)*ADC_NO_AVERAGED_SAMPLES*1024ul + ADC_U_REF_MV/2)    \
+                        / ADC_U_REF_MV                                                      \
+                       )                                                                    \
+            )
+
+/** A ratio of the reference voltage as binary value, which is compatible with e.g.
+    adc_buttonVoltage. The ratio is given as integer fraction \a num / \a den. Used with
+    literals, the result is a compile time constant for the comparison with measured
+    values. */
+#define ADC_RATIO_TO_BIN(num, den)                                                          \
+            ((uint16_t)(((uint32_t)(num)*ADC_NO_AVERAGED_SAMPLES*1024ul + (den)/2) / (den)))
+
 
 /*
  * Global type definitions
@@ -87,8 +118,8 @@ extern volatile uint32_t adc_noAdcResults;
 
 
 /** The voltage measured at analog input #ADC_INPUT_LCD_SHIELD_BUTTONS which the buttons of
-    the LCD shield are connected to. Scaling: worldValue = 5/1024/#ADC_NO_AVERAGED_SAMPLES
-    * \a adc_buttonVoltage [V].
+    the LCD shield are connected to. Scaling: worldValue =
+    #ADC_SCALING_BIN_TO_MV(\a adc_buttonVoltage) [mV].
       @remark The values are written by the ADC task without access synchronization. They
     can be safely read only by tasks of same or lower priority and the latter need a
     critical section to do so. */
@@ -96,7 +127,7 @@ extern volatile uint16_t adc_buttonVoltage;
 
 
 /** The voltage measured at the user selected analog input, see \a adc_userSelectedInput.
-    Scaling: worldValue = 5/1024/#ADC_NO_AVERAGED_SAMPLES * \a adc_inputVoltage [V].
+    Scaling: worldValue = #ADC_SCALING_BIN_TO_MV(\a adc_inputVoltage) [mV].
       @remark The values are written by the ADC task without access synchronization. They
     can be safely read only by tasks of same or lower priority and the latter need a
     critical section to do so. */
@@ -114,8 +145,8 @@ void adc_initAfterPowerUp();
 /** Select the next or previous input for the next conversion. */
 void adc_nextInput(boolean up);
 
-/** Main function of ADC task. Process next conversion result. */
-void adc_onConversionComplete();
+/** Main function of ADC task. Process the next completed frame of conversion results. */
+void adc_onFrameComplete();
 
 
 #endif  /* ADC_ANALOGINPUT_INCLUDED */
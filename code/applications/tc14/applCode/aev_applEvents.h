@@ -39,14 +39,20 @@
     acquire the display for displaying the results of the idle task. */
 #define EVT_TRIGGER_IDLE_FOLLOWER_TASK      (RTOS_EVT_EVENT_01)
 
-/** An ordinary event is used to trigger the button evaluation task. */
+/** An ordinary event is used to trigger the button evaluation task. It is posted by the
+    debouncer of the buttons from the interrupt of the ADC scan. */
 #define EVT_TRIGGER_TASK_BUTTON             (RTOS_EVT_EVENT_02)
 
 /** An ordinary event is used to trigger the ADC result display task. */
 #define EVT_TRIGGER_TASK_DISPLAY_VOLTAGE    (RTOS_EVT_EVENT_03)
 
-/** A simple event is used to signal a new ADC conversion result. */
-#define EVT_ADC_CONVERSION_COMPLETE         (RTOS_EVT_ISR_USER_00)
+/** An ordinary event is posted by the ADC scan to signal a new frame of conversion
+    results. */
+#define EVT_ADC_FRAME_COMPLETE              (RTOS_EVT_EVENT_04)
+
+/** An ordinary event is posted by the LCD driver to resume a task, which waits for space
+    in its queue. */
+#define EVT_LCD_QUEUE_SPACE                 (RTOS_EVT_EVENT_05)
 
 
 /*
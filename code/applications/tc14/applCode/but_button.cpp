@@ -1,7 +1,10 @@
 /**
  * @file but_button.cpp
  *   Evaluate the button status and implement a state machine that represents the user
- * interface.
+ * interface.\n
+ *   The buttons are debounced in the interrupt of the ADC scan by a debouncer object of
+ * RTuinOS, see dbc_debounce.c. The button task is resumed only when a button has been
+ * pressed, released or held down for a while, not for each frame of ADC results.
  *
  * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
  *
@@ -19,9 +22,11 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 /* Module interface
- *   but_onNewButtonVoltage
+ *   but_initAfterPowerUp
+ *   but_onNewButtonVoltageFromISR
+ *   but_onButtonEvent
  * Local functions
- *   decodeLCDButton
+ *   dispatchButton
  */
 
 /*
@@ -30,7 +35,10 @@
 
 #include <Arduino.h>
 
+#include "rtos.h"
 #include "rtos_assert.h"
+#include "dbc_debounce.h"
+#include "aev_applEvents.h"
 #include "adc_analogInput.h"
 #include "clk_clock.h"
 #include "but_button.h"
@@ -40,14 +48,45 @@
  * Defines
  */
 
+/* The thresholds of the button voltages are the means of neighboured voltages. They are
+   compile time constants, which are computed in integer arithmetics. The resistors are
+   given in Ohm. All buttons of the LCD shield shortcut a voltage divider at different
+   resistor values so that the output voltage of the divider depends on the currently
+   pressed button. See e.g.
+   http://sainsmart.com/zen/documents/20-011-901/schematic.pdf. */
+#define R_PULL_UP 2000u
+#define RATIO_0 /* RIGHT  */ 0u
+#define RATIO_1 /* UP     */ ADC_RATIO_TO_BIN(330u, 330u+R_PULL_UP)
+#define RATIO_2 /* DOWN   */ ADC_RATIO_TO_BIN(330u+620u, 330u+620u+R_PULL_UP)
+#define RATIO_3 /* LEFT   */ ADC_RATIO_TO_BIN(330u+620u+1000u, 330u+620u+1000u+R_PULL_UP)
+#define RATIO_4 /* SELECT */ ADC_RATIO_TO_BIN( 330u+620u+1000u+3300u                          \
+                                             , 330u+620u+1000u+3300u+R_PULL_UP              \
+                                             )
+#define RATIO_5 /* NONE   */ ADC_RATIO_TO_BIN(1u, 1u)
+#define THRESHOLD(n,n1) ((uint16_t)(((uint32_t)RATIO_##n1 + RATIO_##n) / 2u))
+
+/** A button is considered pressed or released after the same voltage has been seen in
+    this number of subsequent frames of the ADC scan. A frame takes about 65 ms. The
+    voltage measurement averages the input and the actual button event is in no way
+    synchronized with the averaging time window. Any intermediate voltage can be seen and
+    any wrong, never touched button can be temporarily recognized. */
+#define NO_FRAMES_DEBOUNCE      2
+
+/** A button, which is held down for this number of frames, about one second, is reported
+    as long press. */
+#define NO_FRAMES_LONG_PRESS    15
+
+/** A long press of the buttons up and down adjusts the clock by this number of steps in
+    addition to the single step of the button press. */
+#define NO_STEPS_LONG_PRESS     9
+
 
 /*
  * Local type definitions
  */
 
-/** The buttons are enumerated. */
-typedef enum { btnInvalid
-             , btnRight
+/** The buttons are enumerated. The values are the input states of the debouncer. */
+typedef enum { btnRight
              , btnUp
              , btnDown
              , btnLeft
@@ -65,177 +104,161 @@ typedef enum { btnInvalid
  * Data definitions
  */
 
+/** The thresholds, which separate the voltages of the buttons. A voltage above
+    threshold n and below threshold n+1 belongs to button n+1 of enumButton_t. */
+static const uint16_t _thresholdAry[] = { THRESHOLD(0,1)
+                                        , THRESHOLD(1,2)
+                                        , THRESHOLD(2,3)
+                                        , THRESHOLD(3,4)
+                                        , THRESHOLD(4,5)
+                                        };
+
+/** The debouncer of the button input. */
+static dbc_debouncer_t _debouncer;
+
 
 /*
  * Function implementation
  */
 
 /**
- * Transform the ADC value into the index of the pressed button. All buttons of the LCD
- * shield shortcut a voltage divider at different resistor values so that the output
- * voltage of the divider depends on the currently pressed button. See e.g.
- * http://sainsmart.com/zen/documents/20-011-901/schematic.pdf.
- *   @param adcVal
- * The measured analog value of analog pin 0, which the buttons of the LCD shield are
- * connetced to. The voltage at this pin is determined by the currently pressed button.\n
- *   The passed value is the #ADC_NO_AVERAGED_SAMPLES times accumulated raw ADC value.
+ * Initialize the button evaluation. Needs to be called prior to the start of the ADC
+ * scan.
  */
 
-static enumButton_t decodeLCDButton(uint16_t adcVal)
+void but_initAfterPowerUp()
 {
-#define RATIO_0 /* RIGHT  */ 0.0
-#define RATIO_1 /* UP     */ (330.0/(330.0+2000.0))
-#define RATIO_2 /* DOWN   */ ((330.0+620.0)/(330.0+620.0+2000.0))
-#define RATIO_3 /* LEFT   */ ((330.0+620.0+1000.0)/(330.0+620.0+1000.0+2000.0))
-#define RATIO_4 /* SELECT */ ((330.0+620.0+1000.0+3300.0)/(330.0+620.0+1000.0+3300.0+2000.0))
-#define RATIO_5 /* NONE   */ 1.0
-#define THRESHOLD(n,n1) (uint16_t)(((RATIO_##n1 + RATIO_##n) / 2.0)                         \
-                                   * ADC_NO_AVERAGED_SAMPLES * 0x0400ul)
-
-    if(adcVal > THRESHOLD(4,5))
-        return btnNone;
-    else if(adcVal > THRESHOLD(3,4))
-        return btnSelect;
-    else if(adcVal > THRESHOLD(2,3))
-        return btnLeft;
-    else if(adcVal > THRESHOLD(1,2))
-        return btnDown;
-    else if(adcVal > THRESHOLD(0,1))
-        return btnUp;
-    else
-        return btnRight;
-
-#undef RATIO_0
-#undef RATIO_1
-#undef RATIO_2
-#undef RATIO_3
-#undef RATIO_4
-#undef RATIO_5
-#undef THRESHOLD
-} /* End of decodeLCDButton */
+    dbc_initDebouncer( &_debouncer
+                     , _thresholdAry
+                     , sizeof(_thresholdAry)/sizeof(_thresholdAry[0])
+                     , /* idleState */ btnNone
+                     , NO_FRAMES_DEBOUNCE
+                     , NO_FRAMES_LONG_PRESS
+                     , EVT_TRIGGER_TASK_BUTTON
+                     );
+} /* End of but_initAfterPowerUp */
+
 
 
 
 /**
- * The entry into the state machine that evaluates the buttons and represents the user
- * interface is the notification of the input voltage at the analog input which all buttons
- * are connected to. The buttons shortcut a voltage divider at individual paths and can be
- * indentified because of the resulting voltage. The state machine is required to debounce
- * the voltage changes and to translate them safely into button events like button pressed
- * and button released. Furthermore, this module knows about the clients of the buttons and
- * will notify them accordingly.
+ * The entry into the button evaluation is the notification of the input voltage at the
+ * analog input which all buttons are connected to. The buttons shortcut a voltage divider
+ * at individual paths and can be indentified because of the resulting voltage. The
+ * voltage is classified and debounced and the changes are safely translated into button
+ * events like button pressed, button released and button held down.
+ *   @param buttonVoltage
+ * The measured analog value of analog pin 0, which the buttons of the LCD shield are
+ * connected to. The passed value is the #ADC_NO_AVERAGED_SAMPLES times accumulated raw ADC
+ * value.
  *   @remark
- * This function is trigered by an RTOS event whenever a new voltage input value is
- * available. Therefore it doesn't have a parameter. Instead, it reads its input by side
- * effect from \a adc_buttonVoltage.
+ * This function is called from the interrupt of the ADC scan whenever a frame has been
+ * completed. A button event resumes the button task by posting #EVT_TRIGGER_TASK_BUTTON.
  */
 
-void but_onNewButtonVoltage()
+void but_onNewButtonVoltageFromISR(uint16_t buttonVoltage)
 {
-    /* Get the currently recognized button. The input voltage is written by a task of
-       higher priority and accordingly, we need to apply a critical section to read the
-       value. */
-    cli();
-    uint16_t buttonVoltage = adc_buttonVoltage;
-    sei();
-    enumButton_t btn = decodeLCDButton(buttonVoltage);
-
-    /* Debouncing: The recognized button is unsafe. The voltage measurement averages the
-       input and the actual button event is in no way synchronized with the averaging time
-       window. Any intermediate voltage can be seen and any wrong, never touched button can
-       be temporarily recognized. A recognized button is considered pressed only after we
-       saw the same information a number of times. */
-#define USE_TWO_PAST_VALUES 0
-
-    static enumButton_t btn01_ = btnInvalid;
-#if USE_TWO_PAST_VALUES != 0
-    static enumButton_t btn02_ = btnInvalid;
-#endif
-
-    if(
-#if USE_TWO_PAST_VALUES != 0
-        btn01_ != btn02_  ||
-#endif
-        btn != btn01_
-      )
-    {
-#if USE_TWO_PAST_VALUES != 0
-        btn02_ = btn01_;
-#endif
-        btn01_ = btn;
-        btn    = btnInvalid;
-    }
-#if USE_TWO_PAST_VALUES != 0
-    else
+    dbc_processSampleFromISR(&_debouncer, buttonVoltage);
+
+} /* End of but_onNewButtonVoltageFromISR */
+
+
+
+
+/**
+ * Dispatcher: A button has been pressed or held down. The information is passed to the
+ * client, which is listening to this button.
+ *   @param btn
+ * The button.
+ *   @param noSteps
+ * The number of steps, which are reported to a counting client.
+ */
+
+static void dispatchButton(enumButton_t btn, uint8_t noSteps)
+{
+    switch(btn)
     {
-        btn02_ = btn01_;
+        /* Up and down are used to adjust the real time clock. The number of such events is
+           counted; the RTC code acknowledges by resetting the counts of the events it has
+           considered.
+             The RTC task is running at a lower priority, so we can safely access its
+           global interface without synchronization code. */
+    case btnUp:
+        clk_noButtonEvtsUp += noSteps;
+        break;
+
+    case btnDown:
+        clk_noButtonEvtsDown += noSteps;
+        break;
+
+        /* The buttons right and left are used to switch hence and forth between ADC
+           inputs. */
+    case btnLeft:
+        adc_nextInput(/* up */ false);
+        break;
+
+    case btnRight:
+        adc_nextInput(/* up */ true);
+        break;
+
+        /* The select button is not in use. */
+    case btnSelect:
+        break;
+
+    default:
+        ASSERT(false);
     }
-#endif
+} /* End of dispatchButton */
 
-    /* State machine: If btn is btnInvalid we see an intermediate state which carries
-       no exploitable information and which must not have any impact on our state.
-       Otherwise btn is the validated, current button status. Feed it into the state
-       machine. */
-    if(btn != btnInvalid)
-    {
-        /* The state machine has the following perspective: One button can be pressed at a
-           time and it needs to be released prior to pressing the same or another button.
-           This excludes transitions, which could be generated by first pressing a single
-           button, then another one at the same time and then releasing the first one. The
-           state machine continues to see only the first button pressed until the user
-           really releases all buttons. */
-        static enumButton_t btnLast_ = btnNone;
-
-        /* Look for the button-down-event. */
-        if(btnLast_ == btnNone  &&  btn != btnNone)
-            btnLast_ = btn;
-        else
-        {
-            btnLast_ = btn;
-            btn = btnInvalid;
-        }
-    } /* End if(Stable button status seen?) */
 
-    /* Dispatcher: If btn is not btnInvalid it contains the button, which has been
-       pressed in this instance. The information is passed to the client, which is
-       listening to this button. */
-    if(btn != btnInvalid)
-    {
-        switch(btn)
-        {
-            /* Up and down are used to adjust the real time clock. The number of such
-               events is counted; the RTC code acknowledges by decrementing by the number
-               of events it has considered.
-                 The RTC task is running at a lower priority, so we can safely access its
-               global interface without synchronization code. */
-        case btnUp:
-            ++ clk_noButtonEvtsUp;
-            break;
 
-        case btnDown:
-            ++ clk_noButtonEvtsDown;
-            break;
 
-            /* The buttons right and left are used to switch hence and forth between ADC
-               inputs. */
-        case btnLeft:
-            adc_nextInput(/* up */ false);
+/**
+ * The state machine that represents the user interface. It reads all button events,
+ * which have been queued by the debouncer, and notifies the clients of the buttons.
+ *   @remark
+ * This function is triggered by the RTOS event #EVT_TRIGGER_TASK_BUTTON, which is posted
+ * by the debouncer whenever it has queued a button event.
+ */
+
+void but_onButtonEvent()
+{
+    /* The state machine has the following perspective: One button can be pressed at a time
+       and it needs to be released prior to pressing the same or another button. This
+       excludes transitions, which could be generated by first pressing a single button,
+       then another one at the same time and then releasing the first one. The state
+       machine continues to see only the first button pressed until the user really
+       releases all buttons. */
+    static enumButton_t btnDown_ = btnNone;
+
+    dbc_inputEvent_t evt;
+    while(dbc_readInputEvent(&_debouncer, &evt))
+    {
+        const enumButton_t btn = (enumButton_t)DBC_GET_EVT_STATE(evt);
+        switch(DBC_GET_EVT_KIND(evt))
+        {
+        case DBC_EVT_KIND_PRESS:
+            if(btnDown_ == btnNone)
+            {
+                btnDown_ = btn;
+                dispatchButton(btn, 1);
+            }
             break;
 
-        case btnRight:
-            adc_nextInput(/* up */ true);
+        case DBC_EVT_KIND_LONG_PRESS:
+            /* The long press of a button, which has been pressed while another one was
+               held down, is ignored, too. */
+            if(btn == btnDown_  &&  (btn == btnUp  ||  btn == btnDown))
+                dispatchButton(btn, NO_STEPS_LONG_PRESS);
             break;
 
-            /* The select button is not in use. */
-        case btnSelect:
+        case DBC_EVT_KIND_RELEASE:
+            /* The debouncer reports a release only if no button is pressed any more. */
+            btnDown_ = btnNone;
             break;
 
         default:
             ASSERT(false);
         }
     }
-} /* End of but_onNewButtonVoltage */
-
-
-
-
+} /* End of but_onButtonEvent */
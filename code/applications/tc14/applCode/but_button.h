@@ -46,8 +46,14 @@
  * Global prototypes
  */
 
-/** Callback to notify availability of a new measured input voltage value. */
-void but_onNewButtonVoltage();
+/** Initialize the button evaluation prior to the start of the ADC scan. */
+void but_initAfterPowerUp();
+
+/** Callback from the ADC interrupt to notify a new measured input voltage value. */
+void but_onNewButtonVoltageFromISR(uint16_t buttonVoltage);
+
+/** Evaluate the button events, which have been queued by the debouncer. */
+void but_onButtonEvent();
 
 
 #endif  /* BUT_BUTTON_INCLUDED */
@@ -1,6 +1,10 @@
 /**
  * @file clk_clock.cpp
- *   Implementation of a real time clock for a sample task.
+ *   Implementation of a real time clock for a sample task. The time is not counted by the
+ * task; it is derived on demand from the real time clock of RTuinOS, see
+ * rtc_realTimeClock.c, which computes it from the kernel timestamp with microsecond
+ * resolution. The task only handles the user input to adjust the clock and updates the
+ * display, when the displayed second has changed.
  *
  * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
  *
@@ -18,6 +22,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 /* Module interface
+ *   clk_initClock
+ *   clk_getTime
+ *   clk_taskRTC
  * Local functions
  */
 
@@ -29,6 +36,7 @@
 
 #include "rtos.h"
 #include "rtos_assert.h"
+#include "rtc_realTimeClock.h"
 #include "aev_applEvents.h"
 #include "dpy_display.h"
 #include "clk_clock.h"
@@ -38,21 +46,16 @@
  * Defines
  */
  
-/** The standard RTuinOS clock tic on the Arduino Mega 2560 board is 1/(16MHz/64/510) =
-    51/25000s. We add 51 in each tic and have the next second when we reach 25000. This
-    permits a precise implementation of the real time clock even with 16 Bit integer
-    arithmetics. See #CLOCK_TIC_DENOMINATOR also. */
-#define CLOCK_TIC_NUMERATOR     51
-
-/** Denominator of ratio, which implements the clock's task rate. See #CLOCK_TIC_NUMERATOR
-    for details. */
-#define CLOCK_TIC_DENOMINATOR   (25000-(CLOCK_TIC_DENOMINATOR_TRIM_TERM))
- 
 /** Trim term for clock: By long term observation a correction has been figured out, which
-    makes the clock significantly more accurate. The term is defined as (negative) addend
-    to the denominator #CLOCK_TIC_DENOMINATOR. It is device dependent. Starting point on a
-    new hardware device should be 0. Positive values advance the clock. */
-#define CLOCK_TIC_DENOMINATOR_TRIM_TERM 58
+    makes the clock significantly more accurate. It is device dependent. Starting point on
+    a new hardware device should be 0. Positive values advance the clock. The unit is
+    ppm.\n
+      The value has been taken over from the former implementation of the clock, which
+    counted 51/(25000-58) s per tic instead of the nominal 51/25000 s. */
+#define CLOCK_DRIFT_CORRECTION_PPM  2325
+
+/** The time of day of the clock after reset in s. */
+#define CLOCK_INITIAL_TIME          (20ul*3600ul)
 
 /*
  * Local type definitions
@@ -68,21 +71,6 @@
  * Data definitions
  */
 
-/** Counter of seconds. The value is written without access synchronization code. The time
-    information clk_noHour, clk_noMin, clk_noSec can be safely and consistently read only by
-    a task of same or lower priority and using a critical section. */ 
-volatile uint8_t clk_noSec = 0;
-
-/** Counter of minutes. The value is written without access synchronization code. The time
-    information clk_noHour, clk_noMin, clk_noSec can be safely and consistently read only by
-    a task of same or lower priority and using a critical section. */
-volatile uint8_t clk_noMin = 0;
-
-/** Counter of hours. The value is written without access synchronization code. The time
-    information clk_noHour, clk_noMin, clk_noSec can be safely and consistently read only by
-    a task of same or lower priority and using a critical section.*/ 
-volatile uint8_t clk_noHour = 20;
-
 /** Input to the module: Recognized button-down events, which are used to adjust the clock
     ahead. The value is read/modified using a critical section. */
 volatile uint8_t clk_noButtonEvtsUp = 0;
@@ -92,21 +80,52 @@ volatile uint8_t clk_noButtonEvtsUp = 0;
 volatile uint8_t clk_noButtonEvtsDown = 0;
 
 
-/* Accumulator for task tics which generates a precise one second clock. */
-static uint16_t _noTaskTics = 0;
-
-
 /*
  * Function implementation
  */
 
 /**
- * The regular task function of the real time clock. Has to be called every 100th tic of
- * the RTuinOS system time, which is running in its standard copnfiguration of about 2 ms a
- * tic.
+ * Initialize the clock. To be called once at the beginning of the RTC task: The kernel
+ * timestamp, which the clock is derived from, is valid only when the kernel is running.
+ */
+void clk_initClock()
+{
+    rtc_setDriftCorrection(CLOCK_DRIFT_CORRECTION_PPM);
+    rtc_setTime(CLOCK_INITIAL_TIME, /* noMicroSec */ 0);
+
+} /* End of clk_initClock */
+
+
+
+
+/**
+ * Get the current time. The function can be called from any task and from the idle task.
+ *   @param pHour
+ * The hour, 0..23, is returned in * \a pHour.
+ *   @param pMin
+ * The minute, 0..59, is returned in * \a pMin.
+ *   @param pSec
+ * The second, 0..59, is returned in * \a pSec.
+ */
+void clk_getTime(uint8_t *pHour, uint8_t *pMin, uint8_t *pSec)
+{
+    rtc_getTimeOfDay(pHour, pMin, pSec);
+
+} /* End of clk_getTime */
+
+
+
+
+/**
+ * The regular task function of the real time clock. Has to be called every
+ * #CLK_TASK_TIME_RTUINOS_STANDARD_TICS tics of the RTuinOS system time. The call rate
+ * doesn't influence the accuracy of the clock but only the delay of the display update.
  */
 void clk_taskRTC()
 {
+    /* The second, which has been displayed last time. */
+    static uint8_t lastDisplayedSec_ = 0xff;
+
     /* Global interface of module: Do we have to adjust the time because of a user
        interaction? This code is kept very simple: Any button down event will advance
        or retard the clock by five minutes.
@@ -119,22 +138,23 @@ void clk_taskRTC()
     clk_noButtonEvtsDown = 0;
     sei();
     
+    uint8_t hour, min, sec;
+    clk_getTime(&hour, &min, &sec);
+
     /* Adjust time. */
-    boolean doDisplay = deltaTime != 0;
-    if(doDisplay)
+    if(deltaTime != 0)
     {
         /* Reset the second and fraction of a second counters. */
-        clk_noSec   = 0;
-        _noTaskTics = 0;
+        sec = 0;
         
         while(deltaTime > 0)
         {
             -- deltaTime;
-            if((clk_noMin+=5) > 59)
+            if((min+=5) > 59)
             {
-                clk_noMin -= 60;
-                if(++clk_noHour > 23)
-                    clk_noHour = 0;
+                min -= 60;
+                if(++hour > 23)
+                    hour = 0;
             }
         }
         while(deltaTime < 0)
@@ -145,44 +165,26 @@ void clk_taskRTC()
                auto-repeat the key event after a while, but this is just a simple
                demonstration of RTuinOS, not a high-end application. */
             ++ deltaTime;
-            if((clk_noMin-=4) > 59)
+            if((min-=4) > 59)
             {
-                clk_noMin += 60;
-                if(--clk_noHour > 23)
-                    clk_noHour = 23;
+                min += 60;
+                if(--hour > 23)
+                    hour = 23;
             }
         }
-    }
-    else
-    {
-        /* Advance the clock by one tic. */
-        _noTaskTics += CLK_TASK_TIME_RTUINOS_STANDARD_TICS*CLOCK_TIC_NUMERATOR;
+
+        rtc_setTime(3600ul*hour + 60u*min, /* noMicroSec */ 0);
+
+        /* Force the display of the new time. */
+        lastDisplayedSec_ = 0xff;
 
     } /* if(A button has been touched to adjust the clock?) */    
     
-    /* Carry ripple. */
-    if(_noTaskTics >= CLOCK_TIC_DENOMINATOR)
+    /* We display hh:mm:ss, so a change of the seconds leads to a write into the
+       display. */
+    if(sec != lastDisplayedSec_)    
     {
-        _noTaskTics -= CLOCK_TIC_DENOMINATOR;
-        
-        /* We display hh:mm:ss, so a change of the seconds leads to a write into the
-           display. */
-        doDisplay = true;
-        
-        if(++clk_noSec > 59)
-        {
-            clk_noSec = 0;
-            if(++clk_noMin > 59)
-            {
-                clk_noMin = 0;
-                if(++clk_noHour > 23)
-                    clk_noHour = 0;
-            }
-        }       
-    } /* End if(A second has elapsed?) */
-    
-    /* Display because visible information has changed. */
-    if(doDisplay)    
-        dpy_display.printTime(clk_noHour, clk_noMin, clk_noSec);
-
-} /* End of clk_taskRTC */
\ No newline at end of file
+        lastDisplayedSec_ = sec;
+        dpy_display.printTime(hour, min, sec);
+    }
+} /* End of clk_taskRTC */
@@ -34,11 +34,11 @@
 /** To be used to configure the regular task of the real time clock implementation: The
     task has to be called every #CLK_TASK_TIME_RTUINOS_STANDARD_TICS RTuinOS standard
     system clock tics.
-      @remark The chosen value doesn't strongly matter. It must not be out of the range of
-    the data type of the system time, i.e. not greater than 127. The greater it is the
-    lower is the overhead of the RTOS, but if it gets to large the update of the display
-    might become visibly irregular. We choose a crude value to demonstrate the don't matter
-    character. */
+      @remark The chosen value doesn't strongly matter; the time is not counted by the
+    task. It must not be out of the range of the data type of the system time, i.e. not
+    greater than 127. The greater it is the lower is the overhead of the RTOS, but if it
+    gets to large the update of the display might become visibly irregular. We choose a
+    crude value to demonstrate the don't matter character. */
 #define CLK_TASK_TIME_RTUINOS_STANDARD_TICS 123
 
 
@@ -51,18 +51,6 @@
  * Global data declarations
  */
  
-/** Counter of seconds. The value is modified by the owning module without access
-    synchronization. */
-extern volatile uint8_t clk_noSec;
-
-/** Counter of minutes. The value is modified by the owning module without access
-    synchronization. */
-extern volatile uint8_t clk_noMin;
-
-/** Counter of hours. The value is modified by the owning module without access
-    synchronization. */ 
-extern volatile uint8_t clk_noHour;
-
 /** Input to the module: Recognized button-down events, which are used to adjust the clock
     ahead. The value is modified by the owning module inside a critical section.*/
 extern volatile uint8_t clk_noButtonEvtsUp;
@@ -77,6 +65,12 @@ extern volatile uint8_t clk_noButtonEvtsDown;
  * Global prototypes
  */
 
+/** Initialize the clock when the kernel has been started. */
+void clk_initClock(void);
+
+/** Get the current time of day. */
+void clk_getTime(uint8_t *pHour, uint8_t *pMin, uint8_t *pSec);
+
 /** Regular task function for real time clock support. */
 void clk_taskRTC(void);
 
@@ -4,7 +4,14 @@
  * from different RTuinOS tasks. The display becomes a shared resource.\n
  *   The class only offers some application specific, formatted print functions. No other
  * information than anticpated by these functions can be written to the display. With other
- * words, the entire layout design of the application output is controlled by this module.
+ * words, the entire layout design of the application output is controlled by this module.\n
+ *   The print functions don't write to the LCD. The bus of the LCD is slow, about 40 us
+ * per character. The LCD driver queues the characters and doesn't block the writing task
+ * but its queue is limited and a task could still be blocked by printing a lot of text.
+ * Instead, the print functions update a shadow of the display contents in RAM and mark
+ * the characters, which have actually changed, as dirty. Only this short operation is
+ * protected by the mutex. A task of low priority regularly calls dpy_display_t::flush,
+ * which sends a few of the dirty characters to the LCD each time.
  *
  * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
  *
@@ -23,12 +30,17 @@
  */
 /* Module interface
  *   dpy_display_t::dpy_display_t
+ *   dpy_display_t::initAfterPowerUp
+ *   dpy_display_t::printGreeting
  *   dpy_display_t::printBackground
  *   dpy_display_t::printAdcInput
  *   dpy_display_t::printTime
  *   dpy_display_t::printVoltage
  *   dpy_display_t::printCpuLoad
+ *   dpy_display_t::flush
  * Local functions
+ *   dpy_display_t::updateShadow
+ *   dpy_display_t::writeShadow
  *   dpy_display_t::acquireMutex
  *   dpy_display_t::releaseMutex
  */
@@ -38,11 +50,11 @@
  */
 
 #include <Arduino.h>
-#include <LiquidCrystal.h>
-
 #include "rtos.h"
 #include "rtos_assert.h"
 #include "aev_applEvents.h"
+#include "fmt_format.h"
+#include "lcd_lcdDriver.h"
 #include "dpy_display.h"
 
 
@@ -50,6 +62,12 @@
  * Defines
  */
 
+/** The number of columns of the display. */
+#define NO_COLS     16
+
+/** The number of rows of the display. */
+#define NO_ROWS     2
+
 
 /*
  * Local type definitions
@@ -78,34 +96,59 @@ dpy_display_t dpy_display;
  * Class construtor. Only a single instance of the class must exist in an application,
  * therefore this constructor must never be used.
  *   @remark
- *   The configuration of the underlaying class LiquidCrystal, particularly the supported
- * pins, is done hardcoded in the implementation of this constructor.
+ *   The configuration of the underlaying class lcd_lcdDriver_t, particularly the supported
+ * pins, is done hardcoded in the implementation of this constructor. The LCD itself is
+ * initialized later by initAfterPowerUp.
  */
 
 dpy_display_t::dpy_display_t()
-    : LiquidCrystal(8, 9, 4, 5, 6, 7)
+    : lcd_lcdDriver_t(8, 9, 4, 5, 6, 7)
 {
-    /* Initialize LCD shield. */
-    begin(16, 2);
+    /* The shadow is blank and all of it needs to be sent to the display. */
+    memset(_shadowAry, ' ', sizeof(_shadowAry));
+    uint8_t row;
+    for(row=0; row<NO_ROWS; ++row)
+        _dirtyMaskAry[row] = 0xffff;
 
 } /* End of dpy_display_t::dpy_display_t */
 
 
 
+
+/**
+ * Initialize the LCD shield. The function must be called once before any output is made
+ * and before the RTOS kernel is started, e.g. at the beginning of setup().
+ *   @remark
+ * This can't be done in the constructor: The LCD driver uses timer 4, which is
+ * configured by the Arduino initialization code only after the global constructors have
+ * been run.
+ */
+
+void dpy_display_t::initAfterPowerUp()
+{
+    begin(NO_COLS, NO_ROWS, EVT_LCD_QUEUE_SPACE);
+
+} /* End of dpy_display_t::initAfterPowerUp */
+
+
+
+
 /**
  * Print a standard greeting text. This function should be called immediately after reset.\n
  *   The function must not be called at run time, when concurrent tasks try to access the
- * display. This function will not acquire the mutex for safe access of the display.
+ * display. This function will not acquire the mutex for safe access of the display. It
+ * writes directly to the LCD, bypassing the shadow; the shadow is completely sent to the
+ * display again at the next flushes.
  */
 
 void dpy_display_t::printGreeting()
 {
+    /* The text is taken from the flash ROM, it doesn't occupy RAM. */
     char lcdLine[16+1];
-#ifdef DEBUG
-    int noChars =
-#endif
-    sprintf(lcdLine, "%-16s", "RTuinOS " RTOS_RTUINOS_VERSION);
-    ASSERT(noChars < (int)sizeof(lcdLine));
+    const char * const greeting = RTOS_FLASH_STR("RTuinOS " RTOS_RTUINOS_VERSION);
+    ASSERT(strlen_P(greeting) < sizeof(lcdLine));
+    strcpy_P(lcdLine, greeting);
+    fmt_string(lcdLine+strlen(lcdLine), "", /* minWidth */ 16-strlen(lcdLine));
     setCursor(/* col */ 0, /* row */ 0);
     print(lcdLine);
 
@@ -126,6 +169,10 @@ void dpy_display_t::printGreeting()
     setCursor(/* col */ 0, /* row */ 1);
     print(lcdLine);
 
+    uint8_t row;
+    for(row=0; row<NO_ROWS; ++row)
+        _dirtyMaskAry[row] = 0xffff;
+
 } /* End of dpy_display_t::printGreeting */
 
 
@@ -140,24 +187,18 @@ void dpy_display_t::printGreeting()
 
 void dpy_display_t::printBackground()
 {
+    /* The text is taken from the flash ROM, it doesn't occupy RAM. */
     char lcdLine[16+1];
-#ifdef DEBUG
-    int noChars =
-#endif
     /* @todo "BG" as part of the background is an ugly work around the problem, that we
        don't have a chance to write the actual initial input selection: The call of the
        display function requires to know, what the currently selected input is and this
        information is encapsulated and hidden in module adc. We could add a get function to
        that modules interface ... */
-    sprintf(lcdLine, "ADC: BG         ");
-    ASSERT(noChars < (int)sizeof(lcdLine));
-    setCursor(/* col */ 0, /* row */ 0);
-    print(lcdLine);
+    strcpy_P(lcdLine, RTOS_FLASH_STR("ADC: BG         "));
+    updateShadow(/* col */ 0, /* row */ 0, lcdLine);
 
-    sprintf(lcdLine, "      V        %%");
-    ASSERT(noChars < (int)sizeof(lcdLine));
-    setCursor(/* col */ 0, /* row */ 1);
-    print(lcdLine);
+    strcpy_P(lcdLine, RTOS_FLASH_STR("      V        %"));
+    updateShadow(/* col */ 0, /* row */ 1, lcdLine);
 
 } /* End of dpy_display_t::printBackground */
 
@@ -179,28 +220,11 @@ void dpy_display_t::printAdcInput(int8_t idxInput)
 {
     char lcdString[2+1];
     if(idxInput >= 0  &&  idxInput <= 15)
-    {
-#ifdef DEBUG
-        int noChars =
-#endif
-        sprintf(lcdString, "%02u", idxInput);
-        ASSERT(noChars < (int)sizeof(lcdString));
-    }
+        fmt_uint16(lcdString, (uint16_t)idxInput, /* minWidth */ 2, /* padChar */ '0');
     else
         lcdString[0] = 'B', lcdString[1] = 'G', lcdString[2] = '\0';
 
-    /* Get access to the display, or wait until anybody else has finished respectively. A
-       timeout has been defined which should never elapse, but who knows. In case it
-       should, we simply deny printing. */
-    if(acquireMutex())
-    {
-        setCursor(/* col */ 5, /* row */ 0);
-        print(lcdString);
-
-        /* And release the mutex as soon as possible after writing to the underlaying class has
-           been done. */
-        releaseMutex();
-    }
+    writeShadow(/* col */ 5, /* row */ 0, lcdString);
 } /* End of dpy_display_t::printAdcInput */
 
 
@@ -224,26 +248,17 @@ void dpy_display_t::printAdcInput(int8_t idxInput)
 
 void dpy_display_t::printTime(uint8_t hour, uint8_t min, uint8_t sec)
 {
-    char lcdString[8+1];
-#ifdef DEBUG
-    int noChars =
-#endif
-    sprintf(lcdString, "%02u:%02u:%02u", hour, min, sec);
-    ASSERT(noChars < (int)sizeof(lcdString));
+    ASSERT(hour < 24  &&  min < 60  &&  sec < 60);
 
-    /* Get access to the display, or wait until anybody else has finished respectively. A
-       timeout has been defined which should never elapse, but who knows. In case it
-       should, we simply deny printing. */
-    if(acquireMutex())
-    {
-        /* "16-sizeof" means to display right aligned. */
-        setCursor(/* col */ 16-(sizeof(lcdString)-1), /* row */ 0);
-        print(lcdString);
+    char lcdString[8+1], *pEnd;
+    pEnd = fmt_uint16(lcdString, hour, /* minWidth */ 2, /* padChar */ '0');
+    *pEnd++ = ':';
+    pEnd = fmt_uint16(pEnd, min, /* minWidth */ 2, /* padChar */ '0');
+    *pEnd++ = ':';
+    fmt_uint16(pEnd, sec, /* minWidth */ 2, /* padChar */ '0');
 
-        /* And release the mutex as soon as possible after writing to the underlaying class has
-           been done. */
-        releaseMutex();
-    }
+    /* "16-sizeof" means to display right aligned. */
+    writeShadow(/* col */ 16-(sizeof(lcdString)-1), /* row */ 0, lcdString);
 } /* End of dpy_display_t::printTime */
 
 
@@ -254,32 +269,20 @@ void dpy_display_t::printTime(uint8_t hour, uint8_t min, uint8_t sec)
  *   The function can be called only at run time from an \b RTuinOS task other than the
  * idle task. (It acquires the mutex for safe access of the display, which is forbidden for
  * the idle task.)
- *   @param voltage
- * The value to print. Scaling is 1 V. The range is [0..10). Exceeding the range will lead
- * to a runtime error!
+ *   @param voltageInMV
+ * The value to print. Scaling is 1 mV. The range is [0..10000). Exceeding the range will
+ * lead to a runtime error!
  */
 
-void dpy_display_t::printVoltage(float voltage)
+void dpy_display_t::printVoltage(uint16_t voltageInMV)
 {
-    char lcdString[5+1];
-#ifdef DEBUG
-    int noChars =
-#endif
-    sprintf(lcdString, "%5.3f", (double)voltage);
-    ASSERT(noChars < (int)sizeof(lcdString));
+    ASSERT(voltageInMV < 10000u);
 
-    /* Get access to the display, or wait until anybody else has finished respectively. A
-       timeout has been defined which should never elapse, but who knows. In case it
-       should, we simply deny printing. */
-    if(acquireMutex())
-    {
-        setCursor(/* col */ 0, /* row */ 1);
-        print(lcdString);
+    /* The voltage in mV is a fixed-point number with three decimal places in V. */
+    char lcdString[5+1];
+    fmt_fixPoint(lcdString, voltageInMV, /* noFractionalDigits */ 3, /* minWidth */ 5);
 
-        /* And release the mutex as soon as possible after writing to the underlaying class has
-           been done. */
-        releaseMutex();
-    }
+    writeShadow(/* col */ 0, /* row */ 1, lcdString);
 } /* End of dpy_display_t::printVoltage */
 
 
@@ -297,26 +300,147 @@ void dpy_display_t::printVoltage(float voltage)
 
 void dpy_display_t::printCpuLoad(uint8_t cpuLoad)
 {
+    ASSERT(cpuLoad <= 200);
+
+    /* Five times the load is the load in units of 0.1%. */
     char lcdString[5+1];
-#ifdef DEBUG
-    int noChars =
-#endif
-    sprintf(lcdString, "%5.1f", (double)cpuLoad/2.0);
-    ASSERT(noChars < (int)sizeof(lcdString));
+    fmt_fixPoint( lcdString
+                , 5u*cpuLoad
+                , /* noFractionalDigits */ 1
+                , /* minWidth */ 5
+                );
+
+    writeShadow(/* col */ 10, /* row */ 1, lcdString);
+} /* End of dpy_display_t::printCpuLoad */
+
+
+
+
+
+/**
+ * Send some of the dirty characters of the shadow to the display. The function is called
+ * regularly by a task of low priority; this task is the only one, which accesses the LCD
+ * at run time.\n
+ *   The dirty characters are taken from the shadow under protection of the mutex. The
+ * slow write to the LCD is done after releasing it, so that the print functions are not
+ * blocked by the LCD.
+ *   @param maxNoChars
+ * The maximum number of characters to send, range 1..8. The cursor needs to be
+ * repositioned, if the sent characters are not adjacent; this costs as much as sending
+ * another character.
+ *   @remark
+ * The function must be called only at run time from an \b RTuinOS task other than the
+ * idle task.
+ */
+
+void dpy_display_t::flush(uint8_t maxNoChars)
+{
+    ASSERT(maxNoChars >= 1  &&  maxNoChars <= 8);
+
+    uint8_t colAry[8], rowAry[8];
+    char cAry[8];
+    uint8_t noChars = 0;
+
+    if(acquireMutex())
+    {
+        uint8_t row;
+        for(row=0; row<NO_ROWS  &&  noChars<maxNoChars; ++row)
+        {
+            uint16_t dirtyMask = _dirtyMaskAry[row];
+            uint8_t col;
+            for(col=0; dirtyMask!=0  &&  noChars<maxNoChars; ++col, dirtyMask>>=1)
+            {
+                if((dirtyMask & 1) != 0)
+                {
+                    colAry[noChars] = col;
+                    rowAry[noChars] = row;
+                    cAry[noChars] = _shadowAry[row][col];
+                    ++ noChars;
+                    _dirtyMaskAry[row] &= ~(1u << col);
+                }
+            }
+        }
+        releaseMutex();
+    }
+
+    /* Now the slow part: Queue the characters for the LCD. The task can be suspended
+       here if the queue of the LCD driver is full. */
+    uint8_t u;
+    for(u=0; u<noChars; ++u)
+    {
+        if(u == 0  ||  rowAry[u] != rowAry[u-1]  ||  colAry[u] != colAry[u-1]+1)
+            setCursor(colAry[u], rowAry[u]);
+        write((uint8_t)cAry[u]);
+    }
+} /* End of dpy_display_t::flush */
+
 
+
+
+
+/**
+ * Copy a string into the shadow of the display and mark the changed characters as dirty.
+ *   @param col
+ * The column of the first character.
+ *   @param row
+ * The row of the string.
+ *   @param str
+ * The string. It must not exceed the end of the row.
+ *   @remark
+ * The caller needs to own the mutex or multitasking must not have begun yet.
+ */
+
+void dpy_display_t::updateShadow(uint8_t col, uint8_t row, const char *str)
+{
+    ASSERT(row < NO_ROWS  &&  col + strlen(str) <= NO_COLS);
+
+    char * const pRow = &_shadowAry[row][0];
+    uint16_t dirtyMask = 0;
+    while(*str != '\0')
+    {
+        if(pRow[col] != *str)
+        {
+            pRow[col] = *str;
+            dirtyMask |= 1u << col;
+        }
+        ++ col;
+        ++ str;
+    }
+    _dirtyMaskAry[row] |= dirtyMask;
+
+} /* End of dpy_display_t::updateShadow */
+
+
+
+
+
+/**
+ * Copy a string into the shadow of the display under protection of the mutex. See \a
+ * updateShadow for details.
+ *   @param col
+ * The column of the first character.
+ *   @param row
+ * The row of the string.
+ *   @param str
+ * The string. It must not exceed the end of the row.
+ *   @remark
+ * The function acquires the mutex and must not be called by the idle task.
+ */
+
+void dpy_display_t::writeShadow(uint8_t col, uint8_t row, const char *str)
+{
     /* Get access to the display, or wait until anybody else has finished respectively. A
        timeout has been defined which should never elapse, but who knows. In case it
        should, we simply deny printing. */
     if(acquireMutex())
     {
-        setCursor(/* col */ 10, /* row */ 1);
-        print(lcdString);
+        updateShadow(col, row, str);
 
-        /* And release the mutex as soon as possible after writing to the underlaying class
-           has been done. */
+        /* And release the mutex as soon as possible after writing to the shadow has been
+           done. */
         releaseMutex();
     }
-} /* End of dpy_display_t::printCpuLoad */
+} /* End of dpy_display_t::writeShadow */
 
 
 
@@ -326,7 +450,7 @@ void dpy_display_t::printCpuLoad(uint8_t cpuLoad)
  * At runtime, when the \b RTuinOS tasks compete for the display, strict synchronization is
  * required. All requests to write to the display are serialized by an \b RTuinOS mutex.
  * This private method is called by all the public print methods immediately before the
- * first access to the underlaying class LiquidCrystal.\n
+ * first access to the underlaying class lcd_lcdDriver_t.\n
  *   This method blocks until the mutex is available or the wait timeout elapses.
  *   @return
  * The function uses a timeout when waiting for the mutex. If the mutex was got in the
@@ -348,7 +472,7 @@ inline boolean dpy_display_t::acquireMutex()
                                           , 1 /* unit is 2 ms */
                                           );
 
-    /* Normally, no task will block the display longer than 2ms and the debug compilation
+    /* Normally, no task will block the shadow longer than 2ms and the debug compilation
        double-checks this. Production code can nonetheless be implemented safe; in case it
        can simply skip display operation. */
     ASSERT(gotEvtVec == EVT_MUTEX_LCD);
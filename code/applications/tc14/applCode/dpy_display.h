@@ -25,7 +25,7 @@
  */
 
 #include <Arduino.h>
-#include <LiquidCrystal.h>
+#include "lcd_lcdDriver.h"
 
 
 /*
@@ -37,18 +37,22 @@
  * Global type definitions
  */
 
-/** A single object of this class exists. It encapsulates the functionality of the Arduino
-    standard library LiquidCrystal and reduces it to the printf functions needed for this
+/** A single object of this class exists. It encapsulates the functionality of the LCD
+    driver lcd_lcdDriver_t and reduces it to the printf functions needed for this
     application of the display. Furthermore the print functions implement all needed task
     synchronization: The display is shared by several tasks, which will all write their
-    specific information into the display. */
-class dpy_display_t: private LiquidCrystal
+    specific information into the display. They write into a shadow of the display in RAM,
+    which is incrementally sent to the LCD by \a flush. */
+class dpy_display_t: private lcd_lcdDriver_t
 {
 public:
     /** The constructor. It is not accessible from outside as there is only one instance of
         this class. This single object is plublic, not the constructor to make it. */
     dpy_display_t(void);
 
+    /** Initialize the LCD. To be called once from setup(). */
+    void initAfterPowerUp(void);
+
     /** Print a greeting after reset. */
     void printGreeting();
     
@@ -62,13 +66,25 @@ public:
     /** Formatted printing of current time. */
     void printTime(uint8_t hour, uint8_t min, uint8_t sec);
 
-    /** Formatted printing of voltage. */
-    void printVoltage(float voltage);
+    /** Formatted printing of voltage. Scaling: 1 mV */
+    void printVoltage(uint16_t voltageInMV);
 
     /** Formatted printing of current CPU load. Scaling: 0.5% */
     void printCpuLoad(uint8_t cpuLoad);
 
+    /** Send some of the changed characters to the LCD. */
+    void flush(uint8_t maxNoChars);
+
 private:
+    /** The shadow of the display contents. */
+    char _shadowAry[2][16];
+
+    /** A bit per character of the shadow, which is set if the character has not yet been
+        sent to the LCD. Bit 0 is column 0. */
+    uint16_t _dirtyMaskAry[2];
+
+    void updateShadow(uint8_t col, uint8_t row, const char *str);
+    void writeShadow(uint8_t col, uint8_t row, const char *str);
     inline boolean acquireMutex(void);
     inline void releaseMutex(void);
 
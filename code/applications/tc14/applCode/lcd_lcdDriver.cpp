@@ -0,0 +1,510 @@
+/**
+ * @file lcd_lcdDriver.cpp
+ *   A non-blocking driver for HD44780 compatible LCDs in 4 Bit mode. The Arduino library
+ * LiquidCrystal busy-waits after each nibble until the display has processed it, about
+ * 100 us, and even 2 ms after clearing the display. This driver puts the commands and
+ * characters into a queue instead. The interrupt of timer 4 clocks them out, one per
+ * interrupt. Its period is the execution time of the display, 50 us for most commands and
+ * 2 ms for clear and home; the CPU is free for the application meanwhile. The interrupt
+ * stops itself when the queue is empty.\n
+ *   A task, which finds the queue full, is suspended; the interrupt resumes it with
+ * rtos_sendEventFromISR as soon as half of the queue is free again. The idle task and
+ * code, which runs before the kernel is started, busy-wait instead.\n
+ *   The display pins are written directly to the port registers, which are looked up once
+ * at initialization time. A character costs a few microseconds of CPU time in the
+ * interrupt.
+ *   @remark
+ * The display is write-only; its busy flag is not read. The interrupt period is chosen
+ * with margin.
+ *   @remark
+ * The interrupt of this module can switch to another task. rtos_enterCriticalSection
+ * should inhibit it, too, by resetting bit OCIE4A in register TIMSK4. The bit may be set
+ * again by rtos_leaveCriticalSection regardless whether there's something to send.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   lcd_lcdDriver_t::lcd_lcdDriver_t
+ *   lcd_lcdDriver_t::begin
+ *   lcd_lcdDriver_t::clear
+ *   lcd_lcdDriver_t::setCursor
+ *   lcd_lcdDriver_t::write
+ *   lcd_lcdDriver_t::print
+ *   lcd_lcdDriver_t::getNoPendingBytes
+ *   ISR(TIMER4_COMPA_vect)
+ * Local functions
+ *   setPin
+ *   writeNibble
+ *   writeByte
+ *   lcd_lcdDriver_t::enqueue
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "lcd_lcdDriver.h"
+
+
+/*
+ * Defines
+ */
+
+#if LCD_SIZE_OF_QUEUE < 2  ||  LCD_SIZE_OF_QUEUE > 128 \
+    ||  (LCD_SIZE_OF_QUEUE & (LCD_SIZE_OF_QUEUE-1)) != 0
+# error The size of the queue needs to be a power of two in the range 2..128
+#endif
+
+#if RTOS_USE_SEND_EVENT_FROM_ISR != RTOS_FEATURE_ON
+# error The LCD driver requires RTOS_USE_SEND_EVENT_FROM_ISR to be set to RTOS_FEATURE_ON
+#endif
+
+/** Flag in a queue entry: The byte is a character, not a command. */
+#define ENTRY_IS_DATA       0x100
+
+/** Flag in a queue entry: The command takes up to 1.52 ms. */
+#define ENTRY_IS_SLOW       0x200
+
+/** The interrupt period for ordinary commands and characters in units of 0.5 us. The
+    display requires 37 us. */
+#define TI_FAST_COMMAND     (100-1)
+
+/** The interrupt period after clear and home in units of 0.5 us. The display requires 1.52
+    ms. */
+#define TI_SLOW_COMMAND     (4000-1)
+
+
+/*
+ * Local type definitions
+ */
+
+/** A pin of the display as port register and bit mask. */
+typedef struct pin_t
+{
+    /** The output register of the port. */
+    volatile uint8_t *pPort;
+
+    /** The mask of the bit in the port register. */
+    uint8_t mask;
+
+} pin_t;
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The pins of the display: RS, enable and the data lines D4..D7. */
+static pin_t _pinRs, _pinEnable, _pinDataAry[4];
+
+/** The queue of commands and characters. A character is marked by #ENTRY_IS_DATA. */
+static uint16_t _queueAry[LCD_SIZE_OF_QUEUE];
+
+/** The position of the next write into the queue. The position indexes are cyclically
+    incremented and never wrapped explicitly. The number of pending entries is their
+    difference. */
+static volatile uint8_t _idxWrite = 0;
+
+/** The position of the next entry to send. Modified by the interrupt only. */
+static volatile uint8_t _idxRead = 0;
+
+/** The event, which is posted by the interrupt to resume the waiting writers. */
+static uintEventVec_t _evtQueueSpace = 0;
+
+/** Flag, which is set by a writer before it suspends itself to wait for space in the
+    queue. The interrupt resets it and posts \a _evtQueueSpace. */
+static volatile boolean _isWriterWaiting = false;
+
+/** The addresses of the first character of the rows. */
+static const uint8_t _rowAddrAry[4] = {0x00, 0x40, 0x14, 0x54};
+
+/** The number of rows of the display. */
+static uint8_t _noRows = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Look up the port register and bit mask of an Arduino pin and configure it as output.
+ *   @param pPin
+ * The pin object to set.
+ *   @param arduinoPin
+ * The Arduino pin number.
+ */
+
+static void setPin(pin_t * const pPin, uint8_t arduinoPin)
+{
+    pinMode(arduinoPin, OUTPUT);
+    pPin->pPort = portOutputRegister(digitalPinToPort(arduinoPin));
+    pPin->mask = digitalPinToBitMask(arduinoPin);
+
+} /* End of setPin */
+
+
+
+
+/**
+ * Clock a nibble into the display.
+ *   @param nibble
+ * The nibble in the low bits.
+ *   @remark
+ * The function is called from the interrupt or, before the kernel is started, with the
+ * interrupt not yet enabled. It must not be used concurrently.
+ */
+
+static inline void writeNibble(uint8_t nibble)
+{
+    uint8_t u;
+    for(u=0; u<4; ++u, nibble>>=1)
+    {
+        if((nibble & 1) != 0)
+            *_pinDataAry[u].pPort |= _pinDataAry[u].mask;
+        else
+            *_pinDataAry[u].pPort &= ~_pinDataAry[u].mask;
+    }
+
+    /* The enable pulse needs to be longer than 450 ns. */
+    *_pinEnable.pPort |= _pinEnable.mask;
+    delayMicroseconds(1);
+    *_pinEnable.pPort &= ~_pinEnable.mask;
+
+} /* End of writeNibble */
+
+
+
+
+/**
+ * Send a command or character to the display.
+ *   @param entry
+ * The queue entry, which has the byte in the low bits and the flags.
+ */
+
+static inline void writeByte(uint16_t entry)
+{
+    if((entry & ENTRY_IS_DATA) != 0)
+        *_pinRs.pPort |= _pinRs.mask;
+    else
+        *_pinRs.pPort &= ~_pinRs.mask;
+
+    writeNibble((uint8_t)entry >> 4);
+    writeNibble((uint8_t)entry);
+
+} /* End of writeByte */
+
+
+
+
+/**
+ * Class construtor. Only a single instance of the class must exist in an application.
+ *   @param pinRs
+ * The Arduino pin, which is connected to the register select input of the display.
+ *   @param pinEnable
+ * The Arduino pin, which is connected to the enable input of the display.
+ *   @param pinD4
+ * The Arduino pin, which is connected to data line D4 of the display.
+ *   @param pinD5
+ * The Arduino pin, which is connected to data line D5 of the display.
+ *   @param pinD6
+ * The Arduino pin, which is connected to data line D6 of the display.
+ *   @param pinD7
+ * The Arduino pin, which is connected to data line D7 of the display.
+ */
+
+lcd_lcdDriver_t::lcd_lcdDriver_t( uint8_t pinRs
+                                , uint8_t pinEnable
+                                , uint8_t pinD4
+                                , uint8_t pinD5
+                                , uint8_t pinD6
+                                , uint8_t pinD7
+                                )
+{
+    setPin(&_pinRs, pinRs);
+    setPin(&_pinEnable, pinEnable);
+    setPin(&_pinDataAry[0], pinD4);
+    setPin(&_pinDataAry[1], pinD5);
+    setPin(&_pinDataAry[2], pinD6);
+    setPin(&_pinDataAry[3], pinD7);
+
+} /* End of lcd_lcdDriver_t::lcd_lcdDriver_t */
+
+
+
+
+/**
+ * Initialize the display and the driver. The initialization of the display, which is
+ * specified for the HD44780, is done synchronously: The function blocks for about 60 ms.
+ * Then timer 4 is configured for the driver's interrupt. The display is on and clear,
+ * the cursor is invisible.
+ *   @param noCols
+ * The number of columns of the display.
+ *   @param noRows
+ * The number of rows of the display, 1..4.
+ *   @param evtQueueSpace
+ * The event, which is used to resume the writers, which wait for space in the queue. It
+ * needs to be a normal, broadcasted event, neither a semaphore, nor a mutex, nor a timer
+ * event. The writers must not use it for other purposes.
+ *   @remark
+ * The function must be called before the kernel is started but after Arduino's init(),
+ * which configures timer 4 for PWM, e.g. from setup().
+ */
+
+void lcd_lcdDriver_t::begin(uint8_t noCols, uint8_t noRows, uintEventVec_t evtQueueSpace)
+{
+    ASSERT(noCols >= 1  &&  noRows >= 1  &&  noRows <= 4);
+    ASSERT(evtQueueSpace != 0
+           &&  (evtQueueSpace & (RTOS_EVT_DELAY_TIMER | RTOS_EVT_ABSOLUTE_TIMER)) == 0
+          );
+
+    _idxWrite = 0;
+    _idxRead = 0;
+    _evtQueueSpace = evtQueueSpace;
+    _isWriterWaiting = false;
+    _noRows = noRows;
+
+    /* Switch the display into 4 Bit mode, regardless of its current state. See the
+       initialization by instruction in the data sheet of the HD44780. */
+    delay(50 /* ms */);
+    *_pinRs.pPort &= ~_pinRs.mask;
+    *_pinEnable.pPort &= ~_pinEnable.mask;
+    writeNibble(0x03);
+    delay(5 /* ms */);
+    writeNibble(0x03);
+    delay(5 /* ms */);
+    writeNibble(0x03);
+    delayMicroseconds(150);
+    writeNibble(0x02);
+    delayMicroseconds(100);
+
+    /* Function set: 4 Bit, one or two lines, 5x8 dots. Display on. Clear. Entry mode:
+       increment, no shift. */
+    writeByte(0x20 | (noRows > 1? 0x08: 0x00));
+    delayMicroseconds(100);
+    writeByte(0x0c);
+    delayMicroseconds(100);
+    writeByte(0x01);
+    delayMicroseconds(2000);
+    writeByte(0x06);
+    delayMicroseconds(100);
+
+    /* Timer 4: CTC mode with OCR4A as top, prescaler 8, i.e. 0.5 us per count. The
+       interrupt is enabled as soon as there's something to send. */
+    TIMSK4 &= ~_BV(OCIE4A);
+    TCCR4A = 0;
+    TCCR4B = _BV(WGM42) | _BV(CS41);
+    OCR4A = TI_FAST_COMMAND;
+
+} /* End of lcd_lcdDriver_t::begin */
+
+
+
+
+/**
+ * Queue a command or character. If the queue is full, the calling task is suspended
+ * until there's space again.
+ *   @param byte
+ * The command or character.
+ *   @param isData
+ * True for a character, false for a command.
+ *   @remark
+ * The function globally enables the interrupts. It must not be called inside a critical
+ * section or from an interrupt service routine.
+ */
+
+void lcd_lcdDriver_t::enqueue(uint8_t byte, boolean isData)
+{
+    uint16_t entry = byte;
+    if(isData)
+        entry |= ENTRY_IS_DATA;
+    else if(byte == 0x01  ||  (byte & 0xfe) == 0x02)
+        entry |= ENTRY_IS_SLOW;
+
+    while(true)
+    {
+        /* The check of free space and setting the flag need to be atomic with respect to
+           the interrupt. The global interrupt lock is released by the kernel when the task
+           is suspended. */
+        cli();
+        const uint8_t idxWrite = _idxWrite;
+        if((uint8_t)(idxWrite - _idxRead) < LCD_SIZE_OF_QUEUE)
+        {
+            _queueAry[idxWrite & (LCD_SIZE_OF_QUEUE-1)] = entry;
+            _idxWrite = idxWrite + 1;
+
+            /* Start the interrupt if it is not running. The first entry is sent after a
+               period. */
+            if((TIMSK4 & _BV(OCIE4A)) == 0)
+            {
+                TCNT4 = 0;
+                OCR4A = TI_FAST_COMMAND;
+                TIFR4 = _BV(OCF4A);
+                TIMSK4 |= _BV(OCIE4A);
+            }
+            sei();
+            break;
+        }
+
+        if(rtos_getIdxActiveTask() == RTOS_NO_TASKS)
+        {
+            /* The idle task must not suspend; it busy-waits for the interrupt. */
+            sei();
+        }
+        else
+        {
+            _isWriterWaiting = true;
+            rtos_waitForEvent(_evtQueueSpace, /* all */ false, /* timeout */ 0);
+        }
+    }
+} /* End of lcd_lcdDriver_t::enqueue */
+
+
+
+
+/**
+ * Clear the display and move the cursor home. The display needs 1.52 ms to execute the
+ * command; the calling task is not blocked meanwhile.
+ */
+
+void lcd_lcdDriver_t::clear()
+{
+    enqueue(0x01, /* isData */ false);
+
+} /* End of lcd_lcdDriver_t::clear */
+
+
+
+
+/**
+ * Move the cursor to a position.
+ *   @param col
+ * The column, starting with 0.
+ *   @param row
+ * The row, starting with 0.
+ */
+
+void lcd_lcdDriver_t::setCursor(uint8_t col, uint8_t row)
+{
+    ASSERT(row < _noRows);
+    enqueue(0x80 | (_rowAddrAry[row] + col), /* isData */ false);
+
+} /* End of lcd_lcdDriver_t::setCursor */
+
+
+
+
+/**
+ * Write a character at the cursor position. The cursor advances by one.
+ *   @return
+ * Get the number of written characters, which is always 1.
+ *   @param c
+ * The character.
+ */
+
+size_t lcd_lcdDriver_t::write(uint8_t c)
+{
+    enqueue(c, /* isData */ true);
+    return 1;
+
+} /* End of lcd_lcdDriver_t::write */
+
+
+
+
+/**
+ * Write a string at the cursor position.
+ *   @return
+ * Get the number of written characters.
+ *   @param str
+ * The zero terminated string.
+ */
+
+size_t lcd_lcdDriver_t::print(const char *str)
+{
+    size_t noChars = 0;
+    while(*str != '\0')
+        noChars += write((uint8_t)*str++);
+
+    return noChars;
+
+} /* End of lcd_lcdDriver_t::print */
+
+
+
+
+/**
+ * Get the number of commands and characters, which are still waiting for transmission.
+ *   @return
+ * The number of entries in the queue.
+ */
+
+uint8_t lcd_lcdDriver_t::getNoPendingBytes()
+{
+    cli();
+    const uint8_t noPendingBytes = (uint8_t)(_idxWrite - _idxRead);
+    sei();
+
+    return noPendingBytes;
+
+} /* End of lcd_lcdDriver_t::getNoPendingBytes */
+
+
+
+
+/**
+ * The interrupt compare match A of timer 4. The display has completed the previous
+ * command; the next one is sent and the period till the next interrupt is set according
+ * to its execution time. If the queue is empty, the interrupt disables itself. When half
+ * of the queue is free, the waiting writers are resumed.
+ */
+
+ISR(TIMER4_COMPA_vect)
+{
+    const uint8_t idxRead = _idxRead;
+    if(idxRead == _idxWrite)
+    {
+        /* Queue is empty, stop the interrupt till the next write. */
+        TIMSK4 &= ~_BV(OCIE4A);
+    }
+    else
+    {
+        const uint16_t entry = _queueAry[idxRead & (LCD_SIZE_OF_QUEUE-1)];
+        writeByte(entry);
+        OCR4A = (entry & ENTRY_IS_SLOW) != 0? TI_SLOW_COMMAND: TI_FAST_COMMAND;
+        _idxRead = idxRead + 1;
+    }
+
+    if(_isWriterWaiting
+       &&  (uint8_t)(_idxWrite - _idxRead) <= LCD_SIZE_OF_QUEUE/2
+      )
+    {
+        _isWriterWaiting = false;
+        rtos_sendEventFromISR(_evtQueueSpace);
+    }
+
+    /* If a writer of higher priority has been resumed, then the kernel switches to it
+       now. */
+    rtos_leaveISR();
+
+} /* End of ISR(TIMER4_COMPA_vect) */
@@ -0,0 +1,99 @@
+#ifndef LCD_LCDDRIVER_INCLUDED
+#define LCD_LCDDRIVER_INCLUDED
+/**
+ * @file lcd_lcdDriver.h
+ * Definition of global interface of module lcd_lcdDriver.cpp
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include "rtos.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of commands and characters, which can be queued for the LCD. It needs to be
+    a power of two in the range 2..128. */
+#define LCD_SIZE_OF_QUEUE   32
+
+
+/*
+ * Global type definitions
+ */
+
+/** The driver of an HD44780 compatible LCD in 4 Bit mode. It offers a subset of the
+    interface of the Arduino library LiquidCrystal. Unlike LiquidCrystal, the functions
+    don't wait for the display: Commands and characters are queued and clocked out by the
+    interrupt of timer 4. A task, which finds the queue full, is suspended until there's
+    space again.\n
+      Only a single object of this class must exist, as the interrupt and the queue exist
+    only once. */
+class lcd_lcdDriver_t
+{
+public:
+    /** The constructor, which takes the Arduino pin numbers of the LCD. */
+    lcd_lcdDriver_t( uint8_t pinRs
+                   , uint8_t pinEnable
+                   , uint8_t pinD4
+                   , uint8_t pinD5
+                   , uint8_t pinD6
+                   , uint8_t pinD7
+                   );
+
+    /** Initialize the LCD and the driver prior to the start of the RTuinOS kernel. */
+    void begin(uint8_t noCols, uint8_t noRows, uintEventVec_t evtQueueSpace);
+
+    /** Clear the display and move the cursor home. */
+    void clear(void);
+
+    /** Move the cursor to a position. */
+    void setCursor(uint8_t col, uint8_t row);
+
+    /** Write a character at the cursor position. */
+    size_t write(uint8_t c);
+
+    /** Write a string at the cursor position. */
+    size_t print(const char *str);
+
+    /** Get the number of commands and characters, which are not yet sent to the LCD. */
+    uint8_t getNoPendingBytes(void);
+
+private:
+    void enqueue(uint8_t byte, boolean isData);
+
+}; /* End of class lcd_lcdDriver_t */
+
+
+
+/*
+ * Global data declarations
+ */
+
+
+/*
+ * Global prototypes
+ */
+
+
+
+#endif  /* LCD_LCDDRIVER_INCLUDED */
@@ -39,7 +39,7 @@
 /** Number of tasks in the system. Tasks aren't created dynamically. This number of tasks
     will always be existent and alive. Permitted range is 0..127.\n
       A runtime check is not done. The code will crash in case of a bad setting. */
-#define RTOS_NO_TASKS    5
+#define RTOS_NO_TASKS    6
 
 
 /** Number of distinct priorities of tasks. Since several tasks may share the same
@@ -55,7 +55,7 @@
     structures. Set the value as low as possible. Permitted range is min(1, NO_TASKS)..127,
     but a value greater than NO_TASKS is not reasonable.\n
       A runtime check is not done. The code will crash in case of a bad setting. */
-#define RTOS_MAX_NO_TASKS_IN_PRIO_CLASS 3
+#define RTOS_MAX_NO_TASKS_IN_PRIO_CLASS 4
 
 
 /** The number of events, which behave like semaphores. When posted, they are not
@@ -118,13 +118,14 @@
     interrupt, typically by accessing the interrupt control register of some peripheral.\n
       Now the interrupt is enabled and if it occurs it'll post the event
     #RTOS_EVT_ISR_USER_00. You will probably have a task of high priority which is waiting
-    for this event in order to handle the interrupt when it is resumed by the event. */
-#define RTOS_USE_APPL_INTERRUPT_00 RTOS_FEATURE_ON
+    for this event in order to handle the interrupt when it is resumed by the event.\n
+      The ADC interrupt is owned by the ADC scan, see #RTOS_USE_ADC_SCAN. */
+#define RTOS_USE_APPL_INTERRUPT_00 RTOS_FEATURE_OFF
 
 /** The name of the interrupt vector which is assigned to application interrupt 0. The
     supported vector names can be derived from table 14-1 on page 105 in the CPU manual,
     doc2549.pdf (see http://www.atmel.com). */
-#define RTOS_ISR_USER_00    ADC_vect
+#define RTOS_ISR_USER_00    xxx_vect
 
 
 /** Enable the application defined interrupt 1. See #RTOS_USE_APPL_INTERRUPT_00 for
@@ -136,6 +137,14 @@
 #define RTOS_ISR_USER_01    xxx_vect
 
 
+/** The interrupt of timer 4, which clocks out the queue of the LCD driver, posts its event
+    by rtos_sendEventFromISR. It is inhibited by rtos_enterCriticalSection alongside the
+    kernel interrupts. It may be re-enabled regardless of a pending output; if the queue is
+    empty it disables itself again. */
+#define RTOS_MASK_APPL_INTERRUPTS()     {TIMSK4 &= ~_BV(OCIE4A);}
+#define RTOS_UNMASK_APPL_INTERRUPTS()   {TIMSK4 |= _BV(OCIE4A);}
+
+
 /** A macro which expands to the code which defines all types which are related to the
     system timer. We need the unsigned and the related signed type. The macro is applied
     just once, see below and #RTOS_DEFINE_TYPE_OF_SYSTEM_TIME_DOXYGEN_TAG. */
@@ -176,6 +185,10 @@
  *   @remark
  * This pair of functions is implemented as a macro in the application owned copy of the
  * RTuinOS configuration file. Changing the implementation means to edit this file.
+ *   @remark
+ * In this application, the interrupts of the ADC scan and of the LCD driver can switch
+ * tasks, too. The kernel masks the ADC scan, the LCD driver is added by
+ * #RTOS_MASK_APPL_INTERRUPTS.
  *   @see #RTOS_ISR_SYSTEM_TIMER_TIC
  *   @see #RTOS_USE_APPL_INTERRUPT_00
  *   @see #RTOS_USE_APPL_INTERRUPT_01
@@ -183,8 +196,7 @@
 # define rtos_enterCriticalSection()                                        \
 {                                                                           \
     cli();                                                                  \
-    TIMSK2 &= ~_BV(TOIE2);                                                  \
-    ADCSRA &= ~_BV(ADIE);                                                   \
+    RTOS_MASK_KERNEL_INTERRUPTS();                                          \
     sei();                                                                  \
                                                                             \
 } /* End of macro rtos_enterCriticalSection */
@@ -204,8 +216,7 @@
 # define rtos_leaveCriticalSection()                                        \
 {                                                                           \
     cli();                                                                  \
-    TIMSK2 |= _BV(TOIE2);                                                   \
-    ADCSRA |= _BV(ADIE);                                                    \
+    RTOS_UNMASK_KERNEL_INTERRUPTS();                                        \
     sei();                                                                  \
                                                                             \
 } /* End of macro rtos_leaveCriticalSection */
@@ -294,6 +305,44 @@ RTOS_DEFINE_TYPE_OF_SYSTEM_TIME(8)
 #define RTOS_OVERRUN_TASK_IS_IMMEDIATELY_DUE  RTOS_FEATURE_ON
 
 
+/** The kernel keeps a low-water mark of the stack pointer of each task. The application
+    regularly reports the stack reserve. */
+#define RTOS_USE_STACK_LOW_WATER_MARK   RTOS_FEATURE_ON
+
+
+/** The real time clock is derived from the kernel timestamp, see rtc_realTimeClock.c. */
+#define RTOS_USE_TIMESTAMP  RTOS_FEATURE_ON
+
+
+/** The ADC scan posts its event by rtos_sendEventFromISR. */
+#define RTOS_USE_SEND_EVENT_FROM_ISR    RTOS_FEATURE_ON
+
+
+/** The conversions of the ADC are done by the ADC scan, see asc_adcScan.c. It alternates
+    between the button input and the user selected input and resumes the ADC task once per
+    frame of #ASC_NO_AVERAGED_SAMPLES results per channel. */
+#define RTOS_USE_ADC_SCAN   RTOS_FEATURE_ON
+
+/** The scan list has two channels. */
+#define ASC_MAX_NO_CHANNELS 2
+
+/** The number of subsequent ADC conversion results per channel, which are averaged before
+    the mean value is passed to the waiting client tasks. The values 1..64 are possible. A
+    value greater than about 40 leads to a significant degradation of the responsiveness
+    to button down events. */
+#define ASC_NO_AVERAGED_SAMPLES 32
+
+/** The supply voltage Ucc=5V is the reference voltage. 2 would mean 1.1 V and 3 means
+    2.56 V. The internal references are related to each other and undergo the same errors.
+    The accuracy of these reference voltages is poor (about 5% deviation), the stabilized
+    operational voltage seems to be more accurate. */
+#define ASC_ADC_REFS    1
+
+/** The conversions are triggered by the overflow of timer 0 at 977 Hz, which is configured
+    by Arduino. This minimizes the jitter in conversion timing. */
+#define ASC_ADC_TRIGGER_SOURCE  4
+
+
 #if RTOS_USE_SEMAPHORE == RTOS_FEATURE_ON
 /** The implementation of a semaphore is a simple unsigned integer. The value means the
     number of resources managed by the semaphore. In a resource management system it may be
@@ -5,8 +5,7 @@
 #   The main purpose of this makefile is to demonstrate how the "callback" from RTuinOS'
 # general purpose makefile into the application can be used to support a more complex
 # directory structure to organize the source files. (Most samples just use a flat
-# directory.) Furthermore, this sample requires to link against the floating point library
-# for printf & co.
+# directory.)
 #   Remark: The name of this makefile fragment needs to be identical to the name of the
 # application folder, which is located in RTuinOS/code/applications. The name extension is
 # mk and the makefile needs to be located in the root of the application folder.
@@ -29,11 +28,6 @@
 # You should have received a copy of the GNU Lesser General Public License
 # along with this program. If not, see <http://www.gnu.org/licenses/>.
 
-# This sample requires the floating point support for the standard I/O library (printf in
-# the first place).
-IO_FLOAT_LIB = 1
-$(info tc14.mk: tc14 makes use of the stdio library with floating point support for printf & co)
-
 # The standard list of source code directories is extended by some folders, which have been
 # introduced specifically for this sample. Please note the makefile convention to let path
 # names end on a slash
@@ -1,7 +1,8 @@
 /**
  * @file tc14_adcInput.cpp
- *   Test case 14 of RTuinOS. A user interrupt is applied to pick the results of an analog
- * input channel, which is running in regular, hardware triggered Auto Trigger Mode.\n
+ *   Test case 14 of RTuinOS. The ADC scan of RTuinOS is applied to pick the results of two
+ * analog input channels, which are running in regular, hardware triggered Auto Trigger
+ * Mode.\n
  *   It could seem to be straight forward, to use the timing capabilities of an RTOS to
  * trigger the conversions of an ADC; a regular task would be used to do so. However,
  * signal processing of fluctuating input signals by means of regularly sampling the input
@@ -22,10 +23,11 @@
  * all.\n
  *   This RTuinOS sample application uses timer/counter 0 in the unchanged Arduino standard
  * configuration to trigger the conversions of the ADC. The overflow interrupt is used for
- * this purpose yielding a conversion rate of about 977 Hz. A task of high priority is
- * awaken on each conversion-complete event and reads the conversion result. The read
- * values are down-sampled and passed to a much slower secondary task, which prints them on
- * the Arduino LCD shield (using the LiquidCrystal library).\n
+ * this purpose yielding a conversion rate of about 977 Hz. The interrupt of the ADC scan
+ * accumulates the conversion results of the two channels into a frame. A task of high
+ * priority is awaken on each completed frame and reads the accumulated results. The read
+ * values are passed to much slower secondary tasks, one of them prints them on the
+ * Arduino LCD shield (using a queued, interrupt driven LCD driver).\n
  *   Proper down-sampling is a CPU time consuming operation, which is hard to implement on
  * a tiny eight Bit controller. Here we use the easiest possible to implement filter with
  * rectangular impulse response. It adds the last recent N input values and divides the
@@ -53,18 +55,26 @@
  * is purposely accessed by different tasks, which are asynchronous to one another. To do
  * so, the display has been associated with a mutex and each display writing task will
  * acquire the mutex first. All of this has been encapsulated in the class dpy_display_t and
- * all a task needs to do is calling a simple function printXXX. (Please find more detailed
+ * all a task needs to do is calling a simple function printXXX. The print functions only
+ * update a shadow of the display in RAM; a task of low priority sends the changed
+ * characters to the LCD, a few in each system timer tic. (Please find more detailed
  * considerations about the use of library LiquidCrystal in the RTuinOS manual.)\n
+ * *) An interrupt driven device driver. The LCD driver lcd_lcdDriver_t doesn't wait for
+ * the slow display. The commands are queued and clocked out by the interrupt of timer 4.
+ * A task, which finds the queue full, is suspended until the interrupt reports space by
+ * rtos_sendEventFromISR.\n
  * *) The the input voltage displaying task (taskDisplayVoltage) is regular but not by an
  * RTOS timer operation as usual but because it is associated with the ADC conversion
  * complete interrupt (which is purposely triggered by a regular hardware event). So this
  * part of the application is synchronous to an external event, whereas a concurrent task
  * (taskRTC) is an asynchronous regular task by means of RTuinOS timer operations. Both of
  * these tasks compete for the display without harmful side effects. (The regular timer
- * task implements a real time clock, see clk_clock.cpp.)\n
- * *) A user interface task scans the buttons, which are mounted on the LCD shield. It
- * decodes the buttons and dispatches the information to the different tasks, which are
- * controlled by the buttons. This part of the code demonstrates how to implement safe
+ * task displays a real time clock, see clk_clock.cpp. The time is not counted by the task
+ * but derived on demand from the kernel timestamp, see rtc_realTimeClock.c.)\n
+ * *) A user interface task evaluates the buttons, which are mounted on the LCD shield.
+ * The buttons are decoded and debounced in the interrupt of the ADC scan, see
+ * dbc_debounce.c, and the task is resumed only on a button event. It dispatches the
+ * information to the different tasks, which are controlled by the buttons. This part of the code demonstrates how to implement safe
  * inter-task interfaces, mainly built on broadcasted events and critical sections in
  * conjunction with volatile data objects. The interfaces are implemented in both styles,
  * by global, shared data or as functional interface. Priority considerations avoid having
@@ -103,7 +113,6 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  *
  * Module interface
- *   rtos_enableIRQUser00
  *   setup
  *   loop
  * Local functions
@@ -113,6 +122,7 @@
  *   taskIdleFollower
  *   taskButton
  *   taskDisplayVoltage
+ *   taskDisplayFlush
  */
 
 /*
@@ -129,6 +139,7 @@
 #include "dpy_display.h"
 #include "but_button.h"
 #include "clk_clock.h"
+#include "asc_adcScan.h"
 #include "adc_analogInput.h"
 
 
@@ -139,6 +150,9 @@
 /** Pin 13 has an LED connected on most Arduino boards. */
 #define LED 13
 
+/** The maximum number of characters, which are sent to the LCD in a system timer tic. */
+#define NO_CHARS_PER_FLUSH  4
+
 /** The index to the task objects as needed for requesting the overrun counter or the stack
     usage. */
 enum { idxTaskOnADCComplete
@@ -146,6 +160,7 @@ enum { idxTaskOnADCComplete
      , idxTaskIdleFollower
      , idxTaskButton
      , idxTaskDisplayVoltage
+     , idxTaskDisplayFlush
      , noTasks
      };
 
@@ -171,6 +186,7 @@ static uint8_t _stackTaskRTC[256];
 static uint8_t _stackTaskIdleFollower[256];
 static uint8_t _stackTaskButton[256];
 static uint8_t _stackTaskDisplayVoltage[256];
+static uint8_t _stackTaskDisplayFlush[128];
 
 /* Results of the idle task. */
 volatile uint8_t _cpuLoad = 200;
@@ -206,66 +222,52 @@ static void blink(uint8_t noFlashes)
 
 
 /**
- * The ADC is already configured when this callback is invoked from the RTuinOS kernel
- * initialization code. The callback is just used to release the interrupt on ADC
- * conversion complete - only now the kernel is ready to accept and handle these
- * interrupts.
- */
-
-void rtos_enableIRQUser00()
-{
-    /* Complete the ADC configuration: Enable interrupt. */
-
-    /* The already regularly running conversions trigger interrupts after this register
-       read/modify/write operation.
-         Remark: Writing ADIF to one means to reset a probably already pending interrupt.
-       We must not handle this interrupt as we are not yet in sync with the running
-       conversions. */
-    ADCSRA = ADCSRA
-             | (1 << ADIF)  /* Reset the "conversion-ready" flag by writing a one. */
-             | (1 << ADIE)  /* Allow interrupts on conversion-ready. */
-             ;
-} /* End of rtos_enableIRQUser00 */
-
-
-
-/**
- * This task is triggered one by one by the interrupts triggered by the ADC, when it
- * completes a conversion. The task reads the ADC result register and processes the
- * sequence of values. The processing result is input to a slower, reporting task.
+ * This task is triggered by the ADC scan, whenever it has completed a frame of conversion
+ * results. The task reads the frame and passes the results to slower, reporting tasks.
  *   @param initialResumeCondition
  * The vector of events which made the task due the very first time.
  */
 
 static void taskOnADCComplete(uint16_t initialResumeCondition)
 {
-    ASSERT(initialResumeCondition == EVT_ADC_CONVERSION_COMPLETE);
+    ASSERT(initialResumeCondition == RTOS_EVT_DELAY_TIMER);
+
+    /* Only now the kernel is ready to accept and handle the interrupts of the ADC. */
+    asc_startScan();
 
 #ifdef DEBUG
-    /* Test: Our ADC interrupt should be synchronous with Arduino's TIMER0_OVF (see
-       wiring.c). */
+    /* Test: The conversions of the ADC should be synchronous with Arduino's TIMER0_OVF
+       (see wiring.c). The offset is taken with the first frame. */
     extern volatile unsigned long timer0_overflow_count;
-    uint32_t deltaCnt = timer0_overflow_count;
+    boolean isFirstFrame = true;
+    uint32_t deltaCnt = 0;
 #endif
 
-    do
-    {
-        /* Test: Our ADC interrupt should be synchronous with Arduino's TIMER0_OVF. */
-        ASSERT(adc_noAdcResults + deltaCnt == timer0_overflow_count);
-
-        /* Call the actual interrupt handler code. */
-        adc_onConversionComplete();
-    }
-    while(rtos_waitForEvent( EVT_ADC_CONVERSION_COMPLETE | RTOS_EVT_DELAY_TIMER
+    /* A frame of 2*32 conversions is completed about every 65 ms or 32 tics. */
+    while(rtos_waitForEvent( EVT_ADC_FRAME_COMPLETE | RTOS_EVT_DELAY_TIMER
                            , /* all */ false
-                           , /* timeout */ 1
+                           , /* timeout */ 35
                            )
 #ifdef DEBUG
-          == EVT_ADC_CONVERSION_COMPLETE
+          == EVT_ADC_FRAME_COMPLETE
 #endif
-         );
+         )
+    {
+        /* Call the actual frame handler code. */
+        adc_onFrameComplete();
 
-    /* The following assertion fires if the ADC interrupt isn't timely. The wait condition
+#ifdef DEBUG
+        /* Test: Our ADC conversions should be synchronous with Arduino's TIMER0_OVF. */
+        if(isFirstFrame)
+        {
+            deltaCnt = timer0_overflow_count - adc_noAdcResults;
+            isFirstFrame = false;
+        }
+        ASSERT(adc_noAdcResults + deltaCnt == timer0_overflow_count);
+#endif
+    }
+
+    /* The following assertion fires if the ADC frames aren't timely. The wait condition
        specifies a sharp timeout. True production code would be designed more failure
        tolerant and e.g. not specify a timeout at all. This code would cause a reset in
        case. */
@@ -286,6 +288,9 @@ static void taskRTC(uint16_t initialResumeCondition)
 {
     ASSERT(initialResumeCondition == RTOS_EVT_ABSOLUTE_TIMER);
 
+    /* The clock is derived from the kernel timestamp, which is valid only now. */
+    clk_initClock();
+
     /* Regularly call the RTC implementation at its expected rate: The RTC module exports the
        expected task time by a define. */
     do
@@ -327,9 +332,9 @@ static void taskIdleFollower(uint16_t initialResumeCondition)
 
 
 /**
- * A task, which is triggered by the processing of the ADC conversion results: Whenever it
- * has a new voltage measurement of the analog button input this task is triggered to do
- * the further evaluation, i.e. identification of the pressed button, debouncing, state
+ * A task, which is triggered by the debouncer of the buttons: The button voltage is
+ * classified and debounced in the interrupt of the ADC scan. Whenever a button has been
+ * pressed or released, this task is triggered to do the further evaluation, i.e. state
  * machine and dispatching to the clients.
  *   @param initialResumeCondition
  * The vector of events which made the task due the very first time.
@@ -340,7 +345,7 @@ static void taskButton(uint16_t initialResumeCondition)
     ASSERT(initialResumeCondition == EVT_TRIGGER_TASK_BUTTON);
     do
     {
-        but_onNewButtonVoltage();
+        but_onButtonEvent();
     }
     while(rtos_waitForEvent(EVT_TRIGGER_TASK_BUTTON, /* all */ false, 0));
     ASSERT(false);
@@ -362,7 +367,7 @@ static void taskDisplayVoltage(uint16_t initialResumeCondition)
 {
     ASSERT(initialResumeCondition == EVT_TRIGGER_TASK_DISPLAY_VOLTAGE);
     
-    /* The rate of the result values is about once every 133 ms, which makes the display
+    /* The rate of the result values is about once every 65 ms, which makes the display
        quite nervous. And it would become even faster is the averaging constant
        ADC_NO_AVERAGED_SAMPLES would be lowered. Therefore we average here again to get are
        better readable, more stable display.
@@ -372,10 +377,12 @@ static void taskDisplayVoltage(uint16_t initialResumeCondition)
        here typically consist of some samples from the former input and some from the new
        input. We do no longer see a sharp switch but a kind of cross fading. */
 #define NO_AVERAGED_SAMPLES     5
-#define SCALING_BIN_TO_V(binVal)                                                            \
-        ((ADC_U_REF/(double)((uint32_t)NO_AVERAGED_SAMPLES*ADC_NO_AVERAGED_SAMPLES)/1024.0) \
-         *(double)(binVal)                                                                  \
-        )
+#define SCALING_BIN_TO_MV(binVal)                                                           \
+        ADC_SCALE_BIN_TO_MV( binVal                                                         \
+                           , ADC_SCALING_BIN_TO_MV_Q16( (uint32_t)NO_AVERAGED_SAMPLES       \
+                                                        * ADC_NO_AVERAGED_SAMPLES           \
+                                                      )                                     \
+                           )
 
     static uint32_t accumuatedAdcResult_ = 0;
     static uint8_t noMean_ = NO_AVERAGED_SAMPLES;
@@ -389,7 +396,7 @@ static void taskDisplayVoltage(uint16_t initialResumeCondition)
         
         if(--noMean_ == 0)
         {
-            dpy_display.printVoltage(SCALING_BIN_TO_V(accumuatedAdcResult_));
+            dpy_display.printVoltage(SCALING_BIN_TO_MV(accumuatedAdcResult_));
             
             /* Start next series on averaged samples. */
             noMean_ = NO_AVERAGED_SAMPLES;
@@ -400,13 +407,36 @@ static void taskDisplayVoltage(uint16_t initialResumeCondition)
     ASSERT(false);
     
 #undef NO_AVERAGED_SAMPLES
-#undef SCALING_BIN_TO_V
+#undef SCALING_BIN_TO_MV
 } /* End of taskDisplayVoltage */
 
 
 
 
 
+/**
+ * A regular task of lowest priority, which sends the changed characters of the display
+ * contents to the LCD. It is the only task, which accesses the slow LCD at all.
+ *   @param initialResumeCondition
+ * The vector of events which made the task due the very first time.
+ */
+
+static void taskDisplayFlush(uint16_t initialResumeCondition)
+{
+    ASSERT(initialResumeCondition == RTOS_EVT_ABSOLUTE_TIMER);
+    do
+    {
+        dpy_display.flush(NO_CHARS_PER_FLUSH);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ 1));
+    ASSERT(false);
+
+} /* End of taskDisplayFlush */
+
+
+
+
+
 /**
  * The initalization of the RTOS tasks and general board initialization.
  */
@@ -424,7 +454,8 @@ void setup()
     puts_progmem(rtos_rtuinosStartupMsg);
 #endif
 
-    /* Print greeting on the LCD. */
+    /* Initialize the LCD and print a greeting. */
+    dpy_display.initAfterPowerUp();
     dpy_display.printGreeting();
 
     /* Initialize the digital pin as an output. The LED is used for most basic feedback about
@@ -451,7 +482,7 @@ void setup()
                        , /* prioClass */        RTOS_NO_PRIO_CLASSES-1
                        , /* pStackArea */       &_stackTaskOnADCComplete[0]
                        , /* stackSize */        sizeof(_stackTaskOnADCComplete)
-                       , /* startEventMask */   EVT_ADC_CONVERSION_COMPLETE
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
                        , /* startByAllEvents */ false
                        , /* startTimeout */     0
                        );
@@ -500,8 +531,21 @@ void setup()
                        , /* startByAllEvents */ false
                        , /* startTimeout */     0
                        );
+
+    /* Configure the task, which sends the display contents to the LCD. */
+    rtos_initializeTask( /* idxTask */          idxTaskDisplayFlush
+                       , /* taskFunction */     taskDisplayFlush
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_stackTaskDisplayFlush[0]
+                       , /* stackSize */        sizeof(_stackTaskDisplayFlush)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
     
-    /* Initialize other modules. */
+    /* Initialize other modules. The buttons are debounced in the interrupt of the ADC
+       scan. */
+    but_initAfterPowerUp();
     adc_initAfterPowerUp();
     
 } /* End of setup */
@@ -525,7 +569,7 @@ void loop()
     blink(3);
     
 #ifdef DEBUG
-    printf("\nRTuinOS is idle\n");
+    printf_P(RTOS_FLASH_STR("\nRTuinOS is idle\n"));
 #endif
 
     /* Share result of CPU load computation with the displaying idle follower task. No
@@ -539,24 +583,37 @@ void loop()
     uint16_t adcResult       = adc_inputVoltage;
     uint16_t adcResultButton = adc_buttonVoltage;
     uint32_t noAdcResults = adc_noAdcResults;
-    uint8_t hour = clk_noHour
-          , min  = clk_noMin
-          , sec  = clk_noSec;
     sei();
-
-    printf("At %02u:%02u:%02u:\n", hour, min, sec);
-    printf( "ADC result %7lu at %7.2f s: %.4f V (input), %.4f V (buttons)\n"
-          , noAdcResults
-          , 1e-3*millis()
-          , ADC_SCALING_BIN_TO_V(adcResult)
-          , ADC_SCALING_BIN_TO_V(adcResultButton)
-          );
-    printf("CPU load: %.1f %%\n", (double)_cpuLoad/2.0);
+    uint8_t hour, min, sec;
+    clk_getTime(&hour, &min, &sec);
+
+    /* The time is printed in fixed-point; tc14 doesn't link the floating point support
+       of printf. */
+    const unsigned long tiNow = millis();
+    printf_P(RTOS_FLASH_STR("At %02u:%02u:%02u:\n"), hour, min, sec);
+    printf_P( RTOS_FLASH_STR("ADC result %7lu at %4lu.%02u s: %u mV (input), %u mV"
+                             " (buttons)\n"
+                            )
+            , noAdcResults
+            , tiNow / 1000ul
+            , (unsigned)(tiNow % 1000ul) / 10u
+            , ADC_SCALING_BIN_TO_MV(adcResult)
+            , ADC_SCALING_BIN_TO_MV(adcResultButton)
+            );
+    printf_P(RTOS_FLASH_STR("CPU load: %u.%u %%\n"), _cpuLoad/2u, (_cpuLoad & 1u) * 5u);
     ASSERT(rtos_getTaskOverrunCounter(/* idxTask */ idxTaskRTC, /* doReset */ false) == 0);
     
     uint8_t u;
     for(u=0; u<RTOS_NO_TASKS; ++u)
-        printf("Unused stack area of task %u: %u Byte\n", u, rtos_getStackReserve(u));
+    {
+        printf_P( RTOS_FLASH_STR("Unused stack area of task %u: %u Byte (low-water mark:"
+                                 " %u Byte)\n"
+                                )
+                , u
+                , rtos_getStackReserve(u)
+                , rtos_getStackLowWaterMark(u)
+                );
+    }
 #endif
 
     /* Trigger the follower task, which is capable to safely display the results. */
@@ -0,0 +1,52 @@
+# 
+# Makefile for GNU Make 3.81
+#
+# Included makefile fragment, which specifies some application dependent settings.
+#   The benchmark tc16 is meant to be run in different configurations of the kernel. The
+# configuration is selected on the command line of make. Example:
+#   make APP=tc16 TC16_NO_TASKS=8 TC16_NO_PRIO_CLASSES=3 rebuild upload
+# The supported settings are TC16_NO_TASKS, TC16_NO_PRIO_CLASSES, TC16_NO_SEMAPHORES and
+# TC16_NO_MUTEXES. Optional kernel switches are passed with TC16_DEFINES, e.g.
+#   make APP=tc16 TC16_DEFINES="-DRTOS_USE_TIMER_WHEEL=RTOS_FEATURE_ON" rebuild upload
+# The memory consumption of a set of configurations is reported by target footprint of the
+# shared makefile, see compileLinkAndUpload.mk.
+#   Caution: The dependency files don't know about these settings. Always use target
+# rebuild when changing the configuration.
+#   Remark: The name of this makefile fragment needs to be identical to the name of the
+# application folder, which is located in RTuinOS/code/applications. The name extension is
+# mk and the makefile needs to be located in the root of the application folder.
+#
+# Help on the syntax of this makefile is got at
+# http://www.gnu.org/software/make/manual/make.pdf.
+#
+# Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+#
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU Lesser General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+# for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+# The kernel configuration of the benchmark. The defaults are the same as in rtos.config.h.
+TC16_NO_TASKS ?= 4
+TC16_NO_PRIO_CLASSES ?= 2
+TC16_NO_SEMAPHORES ?= 0
+TC16_NO_MUTEXES ?= 0
+TC16_DEFINES ?=
+cDefinesAppl := -DTC16_NO_TASKS=$(TC16_NO_TASKS) -DTC16_NO_PRIO_CLASSES=$(TC16_NO_PRIO_CLASSES) \
+                -DTC16_NO_SEMAPHORES=$(TC16_NO_SEMAPHORES) -DTC16_NO_MUTEXES=$(TC16_NO_MUTEXES)  \
+                $(TC16_DEFINES)
+$(info tc16.mk: Benchmark configuration: $(cDefinesAppl))
+
+# The sample writes its output with a higher Baud rate than usual and which deviates from
+# the standard setting of the Arduino Serial Monitor. We can apply the makefile
+# capabilities to issue a warning at least.
+$(warning tc16.mk: This test case uses a Baud rate of 115200 bps for communication. \
+Please, adjust the setting of the Arduino Serial Monitor prior to running the test case!)
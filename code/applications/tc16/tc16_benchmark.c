@@ -0,0 +1,556 @@
+/**
+ * @file tc16_benchmark.c
+ *   Test case 16 of RTuinOS. A benchmark of the kernel. The CPU cycles needed by the
+ * basic kernel operations are measured and reported as a table with minimum, average and
+ * maximum. The measured operations are:\n
+ *   - the time from an interrupt request to the first instruction of the task, which is
+ * resumed by the interrupt
+ *   - rtos_sendEvent, if it doesn't cause a task switch
+ *   - rtos_sendEvent, if it resumes a task of higher priority; the time is measured until
+ * the first instruction of the resumed task
+ *   - rtos_waitForEvent; the time is measured until the first instruction of the task,
+ * which becomes active\n
+ *   If the kernel is compiled with RTOS_USE_ISR_LATENCY_HISTOGRAM, then the report
+ * contains the histogram of the interrupt latencies, which is recorded by the kernel
+ * itself. Its latencies are shorter, the kernel takes its time stamps after saving and
+ * before restoring the task contexts.\n
+ *   The measurement is made by reading the counter of timer 1, which is configured to
+ * count CPU clock cycles. The interrupt is the compare match A of the same timer, so that
+ * the point in time of the interrupt request is exactly known.\n
+ *   Two tasks of different priority play ping-pong. The task of lowest priority is the
+ * driver of the benchmark, it triggers the other task and finally reports the results.
+ * All other tasks are ballast tasks, which are suspended most of the time. They wait for
+ * an event, which is never posted and which is OR combined with a long timeout. They
+ * enlarge the lists of suspended tasks the kernel has to handle.\n
+ *   The configuration of the kernel - number of tasks, priority classes, semaphores and
+ * mutexes - is selected at compile time. Please refer to tc16.mk, how to run the benchmark
+ * for a sweep of different configurations.
+ *   @remark The timer tic of the kernel is not synchronized with the benchmark. If it
+ * appears during a measurement the measured time is too large. The maximum values of the
+ * table are affected by these events, average values only slightly.
+ *   @remark This application requires a terminal Baud rate higher then the standard
+ * setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ *   rtos_enableIRQUser00
+ * Local functions
+ *   resetStatistics
+ *   addSample
+ *   printStatistics
+ *   printIsrLatencyHistogram
+ *   printReport
+ *   taskDriver
+ *   taskResponder
+ *   taskBallast
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** The number of system timer tics required to implement the time span given in Milli
+    seconds.
+      @remark
+    The double operations are limited to the compile time if the argument of the macro is a
+    literal. No double operation is then found in the machine code. Never use this macro
+    with runtime expressions! */
+#define TIME_IN_MS(tiInMs) ((uintTime_t)((double)(tiInMs)/RTOS_TIC_MS+0.5))
+
+/** The number of measurement cycles, which are made before the results are reported. */
+#define NO_SAMPLES          1000
+
+/** Stack size of the benchmark driving task, which uses printf. */
+#define STACK_SIZE_DRIVER   256
+
+/** Stack size of the responding task. */
+#define STACK_SIZE_RESPONDER 100
+
+/** Stack size of the ballast tasks. */
+#define STACK_SIZE_BALLAST  80
+
+/** The number of ballast tasks. */
+#define NO_BALLAST_TASKS    (RTOS_NO_TASKS-2)
+
+#if RTOS_NO_TASKS < 2  ||  RTOS_NO_PRIO_CLASSES < 2
+# error The benchmark requires at least two tasks and two priority classes
+#endif
+#if RTOS_NO_SEMAPHORE_EVENTS + RTOS_NO_MUTEX_EVENTS > 9
+# error The benchmark requires three ordinary events; reduce the number of sync objects
+#endif
+
+/** The event, which triggers the responding task. */
+#define EVT_TRIGGER_RESPONDER   (RTOS_EVT_EVENT_11)
+
+/** An event, which no task is waiting for. */
+#define EVT_NOT_AWAITED         (RTOS_EVT_EVENT_10)
+
+/** The event, which the ballast tasks wait for. It is never posted. */
+#define EVT_BALLAST             (RTOS_EVT_EVENT_09)
+
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. The ballast tasks have the remaining indexes. */
+enum {_idxTaskDriver, _idxTaskResponder, _idxTaskBallast};
+
+
+/*
+ * Local type definitions
+ */
+
+/** The statistics of a measured kernel operation. All times are in CPU clock cycles. */
+typedef struct statistics_t
+{
+    /** The minimum of all samples. */
+    uint16_t min;
+
+    /** The maximum of all samples. */
+    uint16_t max;
+
+    /** The sum of all samples. */
+    uint32_t sum;
+
+    /** The number of samples. */
+    uint16_t noSamples;
+
+} statistics_t;
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskDriver(uint16_t initCondition);
+static void taskResponder(uint16_t initCondition);
+static void taskBallast(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackDriver[STACK_SIZE_DRIVER]
+             , _taskStackResponder[STACK_SIZE_RESPONDER];
+#if NO_BALLAST_TASKS > 0
+static uint8_t _taskStackBallastAry[NO_BALLAST_TASKS][STACK_SIZE_BALLAST];
+#endif
+
+#if RTOS_NO_SEMAPHORE_EVENTS > 0
+/** The semaphores aren't used by the benchmark. They are only configured to see their
+    effect on the cost of the kernel functions. */
+uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS];
+#endif
+
+/** The time of the counter of timer 1 at the beginning of a measurement, which ends in
+    another task. */
+static volatile uint16_t _tiStart;
+
+/** The number of cycles needed to get a time stamp. This is subtracted from the measured
+    differences of time stamps. */
+static uint16_t _tiCalibration;
+
+/** Flag, which is set by the responding task when it has got the interrupt. */
+static volatile boolean _isrSampleDone;
+
+/** The statistics of the measured kernel operations. */
+static statistics_t _statIsrToTask
+                  , _statSendEventNoSwitch
+                  , _statSendEventSwitch
+                  , _statWaitForEvent;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * Reset the statistics of a measured kernel operation.
+ *   @param pStat
+ * The statistics object to reset.
+ */
+
+static void resetStatistics(statistics_t * const pStat)
+{
+    pStat->min = 0xffff;
+    pStat->max = 0;
+    pStat->sum = 0;
+    pStat->noSamples = 0;
+
+} /* End of resetStatistics */
+
+
+
+
+/**
+ * Add a sample to the statistics of a measured kernel operation.
+ *   @param pStat
+ * The statistics object.
+ *   @param tiCycles
+ * The measured time in CPU clock cycles.
+ */
+
+static void addSample(statistics_t * const pStat, uint16_t tiCycles)
+{
+    if(tiCycles < pStat->min)
+        pStat->min = tiCycles;
+    if(tiCycles > pStat->max)
+        pStat->max = tiCycles;
+    pStat->sum += tiCycles;
+    ++ pStat->noSamples;
+
+} /* End of addSample */
+
+
+
+
+/**
+ * Print a line of the result table.
+ *   @param title
+ * The name of the kernel operation.
+ *   @param pStat
+ * The statistics object.
+ */
+
+static void printStatistics(const char *title, const statistics_t * const pStat)
+{
+    ASSERT(pStat->noSamples > 0);
+    printf( "%-32s %6u %6u %6u\n"
+          , title
+          , pStat->min
+          , (uint16_t)(pStat->sum / pStat->noSamples)
+          , pStat->max
+          );
+} /* End of printStatistics */
+
+
+
+
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+/**
+ * Print the histogram of the latencies of application interrupt 00, which is recorded by
+ * the kernel. The histogram is reset.
+ */
+
+static void printIsrLatencyHistogram(void)
+{
+    rtos_isrLatencyHistogram_t histogram;
+    uint8_t idxBucket;
+
+    rtos_getIsrLatencyHistogram(/* idxInterrupt */ 0, &histogram, /* doReset */ true);
+    printf("Kernel recorded interrupt latency, max: %u\n", histogram.tiMax);
+    for(idxBucket=0; idxBucket<RTOS_ISR_LATENCY_NO_BUCKETS; ++idxBucket)
+    {
+        /* The last bucket has no upper bound. */
+        if(histogram.noSamplesAry[idxBucket] != 0)
+        {
+            printf( "  %s %5lu: %u\n"
+                  , idxBucket < RTOS_ISR_LATENCY_NO_BUCKETS-1? "< ": ">="
+                  , idxBucket < RTOS_ISR_LATENCY_NO_BUCKETS-1? 1ul << idxBucket
+                                                             : 1ul << (idxBucket-1)
+                  , histogram.noSamplesAry[idxBucket]
+                  );
+        }
+    }
+} /* End of printIsrLatencyHistogram */
+#endif
+
+
+
+
+/**
+ * Print the configuration of the kernel and the table of results.
+ */
+
+static void printReport(void)
+{
+    printf( "\nRTuinOS benchmark, tasks: %u, priority classes: %u, semaphores: %u"
+            ", mutexes: %u\n"
+          , RTOS_NO_TASKS
+          , RTOS_NO_PRIO_CLASSES
+          , RTOS_NO_SEMAPHORE_EVENTS
+          , RTOS_NO_MUTEX_EVENTS
+          );
+    printf( "Kernel options: round robin: %u, prio class bitmap: %u, timer wheel: %u"
+            ", event waiter index: %u, aligned task objects: %u, lazy context save: %u\n"
+          , RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+          , RTOS_USE_PRIO_CLASS_BITMAP == RTOS_FEATURE_ON
+          , RTOS_USE_TIMER_WHEEL == RTOS_FEATURE_ON
+          , RTOS_USE_EVENT_WAITER_INDEX == RTOS_FEATURE_ON
+          , RTOS_ALIGN_TASK_OBJECTS == RTOS_FEATURE_ON
+          , RTOS_USE_LAZY_CONTEXT_SAVE == RTOS_FEATURE_ON
+          );
+    printf("%-32s %6s %6s %6s\n", "CPU clock cycles", "min", "avg", "max");
+    printStatistics("Interrupt to resumed task", &_statIsrToTask);
+    printStatistics("rtos_sendEvent, no task switch", &_statSendEventNoSwitch);
+    printStatistics("rtos_sendEvent, task switch", &_statSendEventSwitch);
+    printStatistics("rtos_waitForEvent", &_statWaitForEvent);
+#if RTOS_USE_ISR_LATENCY_HISTOGRAM == RTOS_FEATURE_ON
+    printIsrLatencyHistogram();
+#endif
+
+} /* End of printReport */
+
+
+
+
+/**
+ * The benchmark driving task. It has the lowest priority. Each cycle of the benchmark it
+ * measures the send event operation without task switch; then it triggers the responding
+ * task and finally waits for the interrupt to happen. After a number of cycles the results
+ * are reported.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskDriver(uint16_t initCondition)
+{
+    uint16_t tiStart, tiEnd;
+    uint16_t u;
+
+    do
+    {
+        resetStatistics(&_statIsrToTask);
+        resetStatistics(&_statSendEventNoSwitch);
+        resetStatistics(&_statSendEventSwitch);
+        resetStatistics(&_statWaitForEvent);
+
+        for(u=0; u<NO_SAMPLES; ++u)
+        {
+            /* Send an event, which doesn't resume any task. */
+            tiStart = TCNT1;
+            rtos_sendEvent(EVT_NOT_AWAITED);
+            tiEnd = TCNT1;
+            addSample(&_statSendEventNoSwitch, tiEnd - tiStart - _tiCalibration);
+
+            /* Resume the responding task. The measurement of the time is completed by the
+               responding task. When we get here again the responding task has suspended
+               and we can complete the measurement of rtos_waitForEvent, which has been
+               started by the responding task. */
+            _isrSampleDone = false;
+            _tiStart = TCNT1;
+            rtos_sendEvent(EVT_TRIGGER_RESPONDER);
+            tiEnd = TCNT1;
+            addSample(&_statWaitForEvent, tiEnd - _tiStart - _tiCalibration);
+
+            /* The responding task waits for the next interrupt. Let's wait for it, too. The
+               timer overflows every 4 ms. */
+            while(!_isrSampleDone)
+                ;
+        }
+
+        printReport();
+    }
+    while(rtos_delay(TIME_IN_MS(2000)) != 0);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskDriver */
+
+
+
+
+/**
+ * The responding task. It has the highest priority. It completes the measurement of the
+ * triggering send event operation and starts the measurement of the wait for event
+ * operation, which suspends it until the next interrupt.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskResponder(uint16_t initCondition)
+{
+    uint16_t tiEnd;
+
+    /* The task is started by the very first trigger event. */
+    do
+    {
+        tiEnd = TCNT1;
+        addSample(&_statSendEventSwitch, tiEnd - _tiStart - _tiCalibration);
+
+        /* Suspend. This resumes the driver task, which completes the measurement. */
+        _tiStart = TCNT1;
+        rtos_waitForEvent(RTOS_EVT_ISR_USER_00, /* all */ false, /* timeout */ 0);
+
+        /* The interrupt request was issued when the counter matched the compare
+           register. */
+        tiEnd = TCNT1;
+        addSample(&_statIsrToTask, tiEnd - OCR1A);
+
+        _isrSampleDone = true;
+    }
+    while(rtos_waitForEvent(EVT_TRIGGER_RESPONDER, /* all */ false, /* timeout */ 0) != 0);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskResponder */
+
+
+
+
+/**
+ * A ballast task. It waits for an event, which is never posted, and is resumed only by
+ * its timeout from time to time.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskBallast(uint16_t initCondition)
+{
+    while(rtos_waitForEvent( EVT_BALLAST | RTOS_EVT_DELAY_TIMER
+                           , /* all */ false
+                           , /* timeout */ (uintTime_t)-2
+                           )
+          != 0
+         )
+        ;
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskBallast */
+
+
+
+
+/**
+ * Callback from RTuinOS: The application interrupt 00 is configured and released. Timer 1
+ * is reconfigured to count the CPU clock cycles.
+ */
+
+void rtos_enableIRQUser00()
+{
+    /* Arduino has put timer 1 into 8 Bit phase correct PWM mode. We need normal mode,
+       WGM1 = %0000, and the undivided CPU clock, CS1 = %001. The compare match A occurs
+       once in a cycle of the counter, i.e. every 4 ms. */
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    OCR1A = 0;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+
+} /* End of rtos_enableIRQUser00 */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    /* Measure the cost of taking a time stamp for the later correction of the results. The
+       timer is not yet configured to its final mode; temporarily, it's simply started at
+       CPU clock. */
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    cli();
+    {
+        uint16_t tiStart = TCNT1;
+        _tiCalibration = TCNT1 - tiStart;
+    }
+    sei();
+
+    /* The benchmark driving task has the lowest priority. It is started immediately. */
+    rtos_initializeTask( /* idxTask */          _idxTaskDriver
+                       , /* taskFunction */     taskDriver
+                       , /* prioClass */        0
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                       , /* timeRoundRobin */   0
+#endif
+                       , /* pStackArea */       &_taskStackDriver[0]
+                       , /* stackSize */        sizeof(_taskStackDriver)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* The responding task has the highest priority. It is started by the first trigger of
+       the driver. */
+    rtos_initializeTask( /* idxTask */          _idxTaskResponder
+                       , /* taskFunction */     taskResponder
+                       , /* prioClass */        RTOS_NO_PRIO_CLASSES-1
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                       , /* timeRoundRobin */   0
+#endif
+                       , /* pStackArea */       &_taskStackResponder[0]
+                       , /* stackSize */        sizeof(_taskStackResponder)
+                       , /* startEventMask */   EVT_TRIGGER_RESPONDER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+#if NO_BALLAST_TASKS > 0
+    /* The ballast tasks are spread across all priority classes. Their timeouts are
+       distributed to avoid that they all become due at the same tic. */
+    uint8_t idxTask;
+    for(idxTask=0; idxTask<NO_BALLAST_TASKS; ++idxTask)
+    {
+        rtos_initializeTask( /* idxTask */          _idxTaskBallast + idxTask
+                           , /* taskFunction */     taskBallast
+                           , /* prioClass */        idxTask % RTOS_NO_PRIO_CLASSES
+#if RTOS_ROUND_ROBIN_MODE_SUPPORTED == RTOS_FEATURE_ON
+                           , /* timeRoundRobin */   0
+#endif
+                           , /* pStackArea */       &_taskStackBallastAry[idxTask][0]
+                           , /* stackSize */        STACK_SIZE_BALLAST
+                           , /* startEventMask */   EVT_BALLAST | RTOS_EVT_DELAY_TIMER
+                           , /* startByAllEvents */ false
+                           , /* startTimeout */     7*idxTask + 3
+                           );
+    }
+#endif
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. Nothing to do.
+ */
+
+void loop(void)
+{
+} /* End of loop */
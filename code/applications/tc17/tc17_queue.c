@@ -0,0 +1,351 @@
+/**
+ * @file tc17_queue.c
+ *   Test case 17 of RTuinOS. A producer task and a consumer task communicate through the
+ * kernel's queue, see que_queue.h.\n
+ *   The producer is a regular task, which is activated at every system timer tic. It
+ * writes a sequence of numbers into the queue, either one by one with que_writeAndSignal
+ * or, every now and then, a block of several numbers at once with que_writeN and
+ * que_signal.\n
+ *   The consumer has the higher priority. It alternates between two phases of operation.
+ * In the first phase it reads the queue element by element with que_readWait; it is
+ * resumed for each sample. In the second phase it waits with que_readNWait until a block
+ * of #BLOCK_SIZE samples has been queued; it is resumed only once per block. In both
+ * phases it double-checks that the received sequence of numbers has no gaps.\n
+ *   The idle task regularly prints the counters of the consumer and the CPU load. The
+ * number of resumes per received sample should be close to one in the first phase and
+ * close to 1/#BLOCK_SIZE in the second phase. The CPU load is lower in the second phase.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_producer
+ *   taskT0C1_consumer
+ *   checkSample
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "gsl_systemLoad.h"
+#include "que_queue.h"
+
+
+/*
+ * Defines
+ */
+
+/** Common stack size of tasks. */
+#define STACK_SIZE   256
+
+/** The capacity of the queue. */
+#define QUEUE_SIZE  32
+
+/** The number of samples the consumer processes at once in its second phase of
+    operation. */
+#define BLOCK_SIZE  16
+
+/** The number of samples the producer writes at once, when using the block write. */
+#define NO_SAMPLES_PER_BLOCK_WRITE  4
+
+/** The number of samples the consumer receives in one phase of operation. */
+#define NO_SAMPLES_PER_PHASE    2000u
+
+/** The event, which is used by the queue to resume the consumer. */
+#define EVT_DATA_IN_QUEUE   (RTOS_EVT_EVENT_00)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_producer(uint16_t initCondition);
+static void taskT0C1_consumer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C1[STACK_SIZE]
+             , _taskStackT0C0[STACK_SIZE];
+
+/** The queue between producer and consumer. */
+static que_queue_t _queue;
+
+/** The memory space of the queue. */
+static uint16_t _queueBuf[QUEUE_SIZE];
+
+/** The number of samples, which could not be written because the queue was full. */
+static volatile uint16_t _noLostSamples = 0;
+
+/** The number of samples, which have been received by the consumer. */
+static volatile uint32_t _noReceivedSamples = 0;
+
+/** The number of times the consumer was resumed from waiting for data. */
+static volatile uint32_t _noResumes = 0;
+
+/** The number of times the consumer has seen a timeout. */
+static volatile uint16_t _noTimeouts = 0;
+
+/** The number of samples, which didn't have the expected value. */
+static volatile uint16_t _noSequenceErrors = 0;
+
+/** The current phase of operation of the consumer: false: reading samples one by one,
+    true: reading blocks of samples. */
+static volatile boolean _isBlockPhase = false;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * Compare a received sample with the expected value.
+ *   @param sample
+ * The received sample.
+ */
+
+static void checkSample(uint16_t sample)
+{
+    static uint16_t expectedSample_ = 0;
+
+    if(sample != expectedSample_)
+    {
+        ++ _noSequenceErrors;
+        expectedSample_ = sample;
+    }
+    ++ expectedSample_;
+
+} /* End of checkSample */
+
+
+
+
+/**
+ * The producer task. It is regularly activated and writes a continuous sequence of
+ * numbers into the queue.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_producer(uint16_t initCondition)
+{
+    uint16_t nextSample = 0;
+    uint8_t cntCycle = 0;
+
+    do
+    {
+        if((++cntCycle & 0x7) == 0)
+        {
+            /* Every eighth cycle we write a block of samples. */
+            uint16_t sampleAry[NO_SAMPLES_PER_BLOCK_WRITE];
+            uint8_t u;
+            for(u=0; u<NO_SAMPLES_PER_BLOCK_WRITE; ++u)
+                sampleAry[u] = nextSample + u;
+
+            const uint8_t noWritten = que_writeN(&_queue, sampleAry, NO_SAMPLES_PER_BLOCK_WRITE);
+            nextSample += NO_SAMPLES_PER_BLOCK_WRITE;
+            _noLostSamples += NO_SAMPLES_PER_BLOCK_WRITE - noWritten;
+            que_signal(&_queue);
+        }
+        else
+        {
+            if(!que_writeAndSignal(&_queue, &nextSample))
+                ++ _noLostSamples;
+            ++ nextSample;
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ 1));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_producer */
+
+
+
+
+/**
+ * The consumer task. It reads the samples from the queue and checks them.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_consumer(uint16_t initCondition)
+{
+    uint16_t noSamplesInPhase = 0;
+
+    while(true)
+    {
+        if(_isBlockPhase)
+        {
+            uint16_t sampleAry[BLOCK_SIZE];
+            const uint8_t noSamples = que_readNWait( &_queue
+                                                  , sampleAry
+                                                  , BLOCK_SIZE
+                                                  , /* timeout */ 2*BLOCK_SIZE
+                                                  );
+            if(noSamples < BLOCK_SIZE)
+                ++ _noTimeouts;
+
+            uint8_t u;
+            for(u=0; u<noSamples; ++u)
+                checkSample(sampleAry[u]);
+            noSamplesInPhase += noSamples;
+            _noReceivedSamples += noSamples;
+        }
+        else
+        {
+            uint16_t sample;
+            if(que_readWait(&_queue, &sample, /* timeout */ 2))
+            {
+                checkSample(sample);
+                ++ noSamplesInPhase;
+                ++ _noReceivedSamples;
+            }
+            else
+                ++ _noTimeouts;
+        }
+        ++ _noResumes;
+
+        if(noSamplesInPhase >= NO_SAMPLES_PER_PHASE)
+        {
+            noSamplesInPhase = 0;
+            _isBlockPhase = !_isBlockPhase;
+        }
+    }
+} /* End of taskT0C1_consumer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    que_initQueue( &_queue
+                 , _queueBuf
+                 , /* sizeOfElem */ sizeof(_queueBuf[0])
+                 , /* maxNoElems */ QUEUE_SIZE
+                 , /* evtData */    EVT_DATA_IN_QUEUE
+                 );
+
+    /* Configure task 0 of priority class 0. The producer has the lower priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     5
+                       );
+
+    /* Configure task 0 of priority class 1. The consumer has the higher priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_consumer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static uint32_t noReceivedSamplesLast_ = 0
+                  , noResumesLast_ = 0;
+
+    /* The system load estimation takes about a second; this is the reporting cycle. */
+    const uint8_t cpuLoad = gsl_getSystemLoad();
+
+    /* Take a consistent snapshot of the counters of the consumer. */
+    uint32_t noReceivedSamples, noResumes;
+    uint16_t noLostSamples, noTimeouts, noSequenceErrors;
+    boolean isBlockPhase;
+    rtos_enterCriticalSection();
+    {
+        noReceivedSamples = _noReceivedSamples;
+        noResumes = _noResumes;
+        noLostSamples = _noLostSamples;
+        noTimeouts = _noTimeouts;
+        noSequenceErrors = _noSequenceErrors;
+        isBlockPhase = _isBlockPhase;
+    }
+    rtos_leaveCriticalSection();
+
+    printf( "%s: %lu samples, %lu resumes, CPU load %u.%u%%\n"
+            "  lost: %u, timeouts: %u, sequence errors: %u\n"
+          , isBlockPhase? "Block read": "Single read"
+          , (unsigned long)(noReceivedSamples - noReceivedSamplesLast_)
+          , (unsigned long)(noResumes - noResumesLast_)
+          , cpuLoad/2, 5*(cpuLoad&1)
+          , noLostSamples, noTimeouts, noSequenceErrors
+          );
+    noReceivedSamplesLast_ = noReceivedSamples;
+    noResumesLast_ = noResumes;
+
+} /* End of loop */
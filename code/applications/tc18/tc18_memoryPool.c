@@ -0,0 +1,336 @@
+/**
+ * @file tc18_memoryPool.c
+ *   Test case 18 of RTuinOS. Message buffers circulate between two tasks without copying
+ * them. The buffers are allocated from a pool of fixed size memory blocks, see
+ * mpl_memoryPool.h, and they are passed from one task to the other one by mailbox, see
+ * mbx_mailbox.h.\n
+ *   The producer is a regular task. It allocates a buffer, fills it with a numbered test
+ * pattern and posts it to the mailbox. If the mailbox still holds the previous message, it
+ * retries in the next tic.\n
+ *   The consumer has the higher priority. It waits for messages and checks the test
+ * pattern. It doesn't free a received buffer immediately but holds the last recent
+ * #NO_HELD_MESSAGES messages and it spends a varying time in processing them. At times,
+ * all blocks of the pool are in use and the producer is suspended in mpl_alloc until the
+ * consumer frees a block.\n
+ *   The idle task regularly prints the counters of both tasks. There must never be a
+ * timeout or a corrupted message.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_producer
+ *   taskT0C1_consumer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "mpl_memoryPool.h"
+#include "mbx_mailbox.h"
+
+
+/*
+ * Defines
+ */
+
+/** Common stack size of tasks. */
+#define STACK_SIZE   256
+
+/** The number of blocks in the memory pool. */
+#define NO_BLOCKS   4
+
+/** The number of received messages the consumer holds before it frees them. */
+#define NO_HELD_MESSAGES    (NO_BLOCKS-1)
+
+/** The size of the test pattern in a message. */
+#define SIZE_OF_PAYLOAD     30
+
+/** The semaphore, which counts the free blocks of the pool. */
+#define EVT_SEMAPHORE_FREE_BLOCKS   (RTOS_EVT_SEMAPHORE_00)
+
+/** The event, which is used by the mailbox to resume the consumer. */
+#define EVT_MESSAGE     (RTOS_EVT_EVENT_01)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+/** The message, which is passed from producer to consumer. */
+typedef struct message_t
+{
+    /** The sequence number of the message. */
+    uint16_t seqNo;
+
+    /** The test pattern. It depends on the sequence number. */
+    uint8_t payloadAry[SIZE_OF_PAYLOAD];
+
+} message_t;
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_producer(uint16_t initCondition);
+static void taskT0C1_consumer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C1[STACK_SIZE]
+             , _taskStackT0C0[STACK_SIZE];
+
+/** The semaphore counter is initialized by the memory pool. */
+uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS];
+
+/** The memory space of the pool. */
+static message_t _messageAry[NO_BLOCKS];
+
+/** The pool of message buffers. */
+static mpl_memoryPool_t _pool;
+
+/** The mailbox from producer to consumer. */
+static mbx_mailbox_t _mailbox;
+
+/** The number of messages, which have been received by the consumer. */
+static volatile uint16_t _noMessages = 0;
+
+/** The number of times the producer found the mailbox still occupied. */
+static volatile uint16_t _noPostRetries = 0;
+
+/** The number of times the producer had to wait for a free block. */
+static volatile uint16_t _noAllocWaits = 0;
+
+/** The number of timeouts seen in either task. */
+static volatile uint16_t _noTimeouts = 0;
+
+/** The number of messages with wrong sequence number or test pattern. */
+static volatile uint16_t _noCorruptMessages = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The producer task. It regularly allocates a message buffer, fills it and posts it to
+ * the consumer.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_producer(uint16_t initCondition)
+{
+    uint16_t seqNo = 0;
+
+    do
+    {
+        /* If the allocation takes longer than a millisecond, then the pool had been empty
+           and the task had been suspended. */
+        const uint32_t tiStart = micros();
+        message_t * const pMsg = (message_t*)mpl_alloc(&_pool, /* timeout */ 100);
+        if(pMsg != NULL)
+        {
+            if(micros() - tiStart > 1000)
+                ++ _noAllocWaits;
+
+            uint8_t u;
+            pMsg->seqNo = seqNo;
+            for(u=0; u<SIZE_OF_PAYLOAD; ++u)
+                pMsg->payloadAry[u] = (uint8_t)(seqNo + u);
+            ++ seqNo;
+
+            while(!mbx_post(&_mailbox, pMsg))
+            {
+                ++ _noPostRetries;
+                rtos_delay(1);
+            }
+        }
+        else
+            ++ _noTimeouts;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ 5));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_producer */
+
+
+
+
+/**
+ * The consumer task. It waits for messages, checks them and frees them after a while.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_consumer(uint16_t initCondition)
+{
+    message_t *pHeldMsgAry[NO_HELD_MESSAGES];
+    uint8_t noHeldMsgs = 0
+          , tiProcessing = 0;
+    uint16_t expectedSeqNo = 0;
+
+    while(true)
+    {
+        message_t * const pMsg = (message_t*)mbx_fetchWait(&_mailbox, /* timeout */ 100);
+        if(pMsg == NULL)
+        {
+            ++ _noTimeouts;
+            continue;
+        }
+
+        /* Check the message. */
+        boolean isCorrupt = pMsg->seqNo != expectedSeqNo;
+        uint8_t u;
+        for(u=0; u<SIZE_OF_PAYLOAD; ++u)
+            if(pMsg->payloadAry[u] != (uint8_t)(pMsg->seqNo + u))
+                isCorrupt = true;
+        if(isCorrupt)
+            ++ _noCorruptMessages;
+        expectedSeqNo = pMsg->seqNo + 1;
+        ++ _noMessages;
+
+        /* Hold the message and free the eldest one. The held messages occupy all blocks but
+           one. */
+        if(noHeldMsgs == NO_HELD_MESSAGES)
+        {
+            mpl_free(&_pool, pHeldMsgAry[0]);
+            for(u=0; u<NO_HELD_MESSAGES-1; ++u)
+                pHeldMsgAry[u] = pHeldMsgAry[u+1];
+            -- noHeldMsgs;
+        }
+        pHeldMsgAry[noHeldMsgs++] = pMsg;
+
+        /* Simulate the processing of the message. The duration varies around the period
+           of the producer so that the pool runs empty at times. */
+        tiProcessing = (tiProcessing + 3) & 0x7;
+        rtos_delay(tiProcessing);
+    }
+} /* End of taskT0C1_consumer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    mpl_initPool( &_pool
+                , _messageAry
+                , /* sizeOfBlock */  sizeof(_messageAry[0])
+                , /* noBlocks */     NO_BLOCKS
+                , /* evtSemaphore */ EVT_SEMAPHORE_FREE_BLOCKS
+                );
+    mbx_initMailbox(&_mailbox, /* evtMsg */ EVT_MESSAGE);
+
+    /* Configure task 0 of priority class 0. The producer has the lower priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     5
+                       );
+
+    /* Configure task 0 of priority class 1. The consumer has the higher priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_consumer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static uint32_t tiNextReport_ = 1000;
+
+    if((int32_t)(millis() - tiNextReport_) >= 0)
+    {
+        uint16_t noMessages, noPostRetries, noAllocWaits, noTimeouts, noCorruptMessages;
+
+        /* Take a consistent snapshot of the counters of the tasks. */
+        rtos_enterCriticalSection();
+        {
+            noMessages = _noMessages;
+            noPostRetries = _noPostRetries;
+            noAllocWaits = _noAllocWaits;
+            noTimeouts = _noTimeouts;
+            noCorruptMessages = _noCorruptMessages;
+        }
+        rtos_leaveCriticalSection();
+
+        printf( "Messages: %u, post retries: %u, waits for block: %u\n"
+                "  timeouts: %u, corrupt messages: %u\n"
+              , noMessages, noPostRetries, noAllocWaits
+              , noTimeouts, noCorruptMessages
+              );
+        tiNextReport_ += 1000;
+    }
+} /* End of loop */
@@ -0,0 +1,323 @@
+/**
+ * @file tc19_priorityInheritance.c
+ *   Test case 19 of RTuinOS. Three tasks of different priority demonstrate the priority
+ * inversion problem and its solution by priority inheritance, see
+ * #RTOS_USE_MUTEX_PRIO_INHERITANCE.\n
+ *   All tasks are regular tasks with same period. The task of low priority becomes due
+ * first. It acquires a mutex and holds it for #TI_HOLD_MUTEX milliseconds of CPU time.
+ * One tic later the task of high priority becomes due and it needs the same mutex; it has
+ * to wait. Another tic later the task of medium priority becomes due. It doesn't use the
+ * mutex but it consumes #TI_MEDIUM_LOAD milliseconds of CPU time.\n
+ *   Without priority inheritance, the task of medium priority preempts the owner of the
+ * mutex and the task of high priority has to wait until both, the task of medium priority
+ * and the owner, have completed. With priority inheritance, the owner runs at high
+ * priority while the other task waits for the mutex; the task of medium priority can't
+ * preempt it and the wait time is bounded by the time the mutex is held.\n
+ *   The idle task regularly prints the maximum time the task of high priority had to wait
+ * for the mutex. It should be somewhat less than #TI_HOLD_MUTEX if priority inheritance
+ * is configured and close to #TI_HOLD_MUTEX plus #TI_MEDIUM_LOAD otherwise.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   consumeCpuTime
+ *   taskT0C0_lowPrio
+ *   taskT0C1_mediumPrio
+ *   taskT0C2_highPrio
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Common stack size of tasks. */
+#define STACK_SIZE   256
+
+/** The period of all tasks in system timer tics. */
+#define TASK_PERIOD     20
+
+/** The time in milliseconds, which the task of low priority holds the mutex. */
+#define TI_HOLD_MUTEX   6
+
+/** The time in milliseconds, which the task of medium priority consumes per cycle. */
+#define TI_MEDIUM_LOAD  16
+
+/** The mutex shared by the tasks of low and high priority. */
+#define EVT_MUTEX       (RTOS_EVT_MUTEX_00)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _idxTaskT0C2, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_lowPrio(uint16_t initCondition);
+static void taskT0C1_mediumPrio(uint16_t initCondition);
+static void taskT0C2_highPrio(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE]
+             , _taskStackT0C1[STACK_SIZE]
+             , _taskStackT0C2[STACK_SIZE];
+
+/** The maximum time in microseconds the task of high priority waited for the mutex since
+    the last report. */
+static volatile uint32_t _tiMaxWaitForMutex = 0;
+
+/** The number of cycles of the task of high priority. */
+static volatile uint16_t _noCycles = 0;
+
+/** The number of times the task of high priority didn't get the mutex in time. */
+static volatile uint16_t _noTimeouts = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * Consume some CPU time. The time counts only while the calling task is active, a
+ * preemption by other tasks prolongs the execution of the function.
+ *   @param tiMs
+ * The CPU time to consume in milliseconds.
+ */
+
+static void consumeCpuTime(uint8_t tiMs)
+{
+    while(tiMs-- > 0)
+        delayMicroseconds(1000);
+
+} /* End of consumeCpuTime */
+
+
+
+
+/**
+ * The task of low priority. It regularly acquires the mutex and holds it for a while.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_lowPrio(uint16_t initCondition)
+{
+    do
+    {
+        rtos_waitForEvent(EVT_MUTEX, /* all */ false, /* timeout */ 0);
+        consumeCpuTime(TI_HOLD_MUTEX);
+        rtos_sendEvent(EVT_MUTEX);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_lowPrio */
+
+
+
+
+/**
+ * The task of medium priority. It doesn't use the mutex but consumes a lot of CPU time.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_mediumPrio(uint16_t initCondition)
+{
+    do
+    {
+        consumeCpuTime(TI_MEDIUM_LOAD);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_mediumPrio */
+
+
+
+
+/**
+ * The task of high priority. It acquires the mutex and measures how long it had to wait
+ * for it.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C2_highPrio(uint16_t initCondition)
+{
+    do
+    {
+        const uint32_t tiStart = micros();
+        if((rtos_waitForEvent( EVT_MUTEX | RTOS_EVT_DELAY_TIMER
+                             , /* all */ false
+                             , /* timeout */ TASK_PERIOD
+                             )
+            & EVT_MUTEX
+           ) != 0
+          )
+        {
+            const uint32_t tiWait = micros() - tiStart;
+            if(tiWait > _tiMaxWaitForMutex)
+                _tiMaxWaitForMutex = tiWait;
+            rtos_sendEvent(EVT_MUTEX);
+        }
+        else
+            ++ _noTimeouts;
+
+        ++ _noCycles;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C2_highPrio */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure task 0 of priority class 0. It is the first one of the tasks to become
+       due. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_lowPrio
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     10
+                       );
+
+    /* Configure task 0 of priority class 1. It becomes due two tics after the task of low
+       priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_mediumPrio
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     12
+                       );
+
+    /* Configure task 0 of priority class 2. It becomes due one tic after the task of low
+       priority, while the mutex is held. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C2
+                       , /* taskFunction */     taskT0C2_highPrio
+                       , /* prioClass */        2
+                       , /* pStackArea */       &_taskStackT0C2[0]
+                       , /* stackSize */        sizeof(_taskStackT0C2)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     11
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static uint32_t tiNextReport_ = 1000;
+
+    if((int32_t)(millis() - tiNextReport_) >= 0)
+    {
+        uint32_t tiMaxWaitForMutex;
+        uint16_t noCycles, noTimeouts;
+
+        /* Take a consistent snapshot of the results of the task of high priority. */
+        rtos_enterCriticalSection();
+        {
+            tiMaxWaitForMutex = _tiMaxWaitForMutex;
+            _tiMaxWaitForMutex = 0;
+            noCycles = _noCycles;
+            noTimeouts = _noTimeouts;
+        }
+        rtos_leaveCriticalSection();
+
+        printf( "Cycles: %u, max. wait for mutex: %lu us, timeouts: %u (priority"
+                " inheritance %s)\n"
+              , noCycles, (unsigned long)tiMaxWaitForMutex, noTimeouts
+#if RTOS_USE_MUTEX_PRIO_INHERITANCE == RTOS_FEATURE_ON
+              , "on"
+#else
+              , "off"
+#endif
+              );
+        tiNextReport_ += 1000;
+    }
+} /* End of loop */
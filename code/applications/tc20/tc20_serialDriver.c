@@ -0,0 +1,228 @@
+/**
+ * @file tc20_serialDriver.c
+ *   Test case 20 of RTuinOS. The console output is written through the interrupt driven
+ * serial driver ser_serial.c. A task of high priority produces bursts of console output,
+ * which are much longer than the transmit buffer of the driver. A task of low priority
+ * permanently counts in a loop.\n
+ *   While the task of high priority waits for space in the transmit buffer, it is
+ * suspended and the task of low priority continues counting. With Arduino's Serial, the
+ * task of high priority would busy-wait until the complete burst has been sent and the
+ * task of low priority would be stalled for most of the time.\n
+ *   The task of high priority starts each burst with the number of loops the task of low
+ * priority has made since the previous burst. It should be only slightly less than the
+ * number, which is seen if the burst is reduced to this single line by #TASK_BURST_SIZE
+ * set to zero. The idle task never gets the CPU.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_counter
+ *   taskT0C1_printer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "ser_serial.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Common stack size of tasks. */
+#define STACK_SIZE   256
+
+/** The period of the task of high priority in system timer tics. */
+#define TASK_PERIOD     100
+
+/** The number of lines, which are printed by the task of high priority in each cycle.
+    Each line has about 60 characters, the transmission of a burst takes about
+    #TASK_BURST_SIZE*5 ms at 115200 Baud. */
+#define TASK_BURST_SIZE 8
+
+/** The event, which is used by the serial driver to resume a task waiting for space in
+    the transmit buffer. */
+#define EVT_TX_SPACE    (RTOS_EVT_EVENT_00)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_counter(uint16_t initCondition);
+static void taskT0C1_printer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE]
+             , _taskStackT0C1[STACK_SIZE];
+
+/** The number of loops of the task of low priority. */
+static volatile uint32_t _noLoops = 0;
+
+/** The number of cycles of the task of high priority. */
+static volatile uint16_t _noBursts = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The task of low priority. It never suspends but permanently counts.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_counter(uint16_t initCondition)
+{
+    while(true)
+    {
+        /* The counter has more than one byte, the increment is not atomic with respect to
+           the task of high priority, which reads it. */
+        rtos_enterCriticalSection();
+        ++ _noLoops;
+        rtos_leaveCriticalSection();
+    }
+} /* End of taskT0C0_counter */
+
+
+
+
+/**
+ * The task of high priority. It regularly prints a burst of lines. The burst is much
+ * longer than the transmit buffer of the serial driver; the task is suspended until the
+ * characters have been sent.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_printer(uint16_t initCondition)
+{
+    uint32_t noLoopsLast = 0;
+
+    do
+    {
+        /* Reading the counter of the task of low priority doesn't require a critical
+           section: The task of high priority can't be interrupted by the other task. */
+        const uint32_t noLoops = _noLoops;
+        printf("Loops of low priority task since last burst: %lu\n", noLoops - noLoopsLast);
+        noLoopsLast = noLoops;
+
+        uint8_t u;
+        for(u=0; u<TASK_BURST_SIZE; ++u)
+        {
+            printf( "Burst %5u, line %u: The quick brown fox jumps over the dog\n"
+                  , _noBursts, u
+                  );
+        }
+        ++ _noBursts;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_printer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial driver and redirect stdout into it. */
+    init_stdout();
+    ser_init(/* baudRate */ 115200, /* evtTxSpace */ EVT_TX_SPACE);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure task 0 of priority class 0. The counter has the lower priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_counter
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure task 0 of priority class 1. The printer has the higher priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_printer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     10
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ *   @remark
+ * The task of low priority never suspends, so the idle task never gets the CPU in this
+ * application.
+ */
+
+void loop(void)
+{
+} /* End of loop */
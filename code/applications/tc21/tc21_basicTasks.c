@@ -0,0 +1,299 @@
+/**
+ * @file tc21_basicTasks.c
+ *   Test case 21 of RTuinOS. Three run-to-completion basic tasks share the stack of a
+ * single host task, see btk_basicTask.h.\n
+ *   A regular task of low priority triggers the basic tasks: It posts event A in every
+ * cycle, events A and B together in every second cycle and the report event in every
+ * 100th cycle. The host task has the higher priority; the basic tasks are run as soon as
+ * their events are posted. Two of them count their activations, the third one reports the
+ * counters and the stack reserve of the host task.\n
+ *   The report is run first in its cycle, before A and B. The counter of basic task A
+ * needs to be one less than the number of cycles of the regular task and the counter of B
+ * one less than half of it. The stack reserve of the host task shows, that a single stack
+ * area of #STACK_SIZE_HOST Byte serves all three basic tasks.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_trigger
+ *   taskT0C1_host
+ *   basicTaskA_count
+ *   basicTaskB_count
+ *   basicTaskC_report
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "btk_basicTask.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the regular task. */
+#define STACK_SIZE_TRIGGER  100
+
+/** Stack size of the host task, which is shared by all basic tasks. */
+#define STACK_SIZE_HOST     256
+
+/** The period of the regular task in system timer tics. */
+#define TASK_PERIOD         5
+
+/** The event, which triggers basic task A. */
+#define EVT_A               (RTOS_EVT_EVENT_00)
+
+/** The event, which triggers basic task B. */
+#define EVT_B               (RTOS_EVT_EVENT_01)
+
+/** The event, which triggers the report. */
+#define EVT_REPORT          (RTOS_EVT_EVENT_02)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_trigger(uint16_t initCondition);
+static void taskT0C1_host(uint16_t initCondition);
+static void basicTaskA_count(uintEventVec_t triggerEventVec);
+static void basicTaskB_count(uintEventVec_t triggerEventVec);
+static void basicTaskC_report(uintEventVec_t triggerEventVec);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_TRIGGER]
+             , _taskStackT0C1[STACK_SIZE_HOST];
+
+/** The basic tasks, which share the stack of the host task. The report has the highest
+    priority. */
+static const btk_basicTask_t _basicTaskAry[] =
+{
+    {basicTaskC_report, EVT_REPORT},
+    {basicTaskA_count, EVT_A},
+    {basicTaskB_count, EVT_B},
+};
+
+/** The number of cycles of the regular task. */
+static volatile uint16_t _noCycles = 0;
+
+/** The number of activations of basic task A. */
+static uint16_t _noActivationsA = 0;
+
+/** The number of activations of basic task B. */
+static uint16_t _noActivationsB = 0;
+
+/** The number of activations with unexpected trigger events. */
+static uint16_t _noErrors = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The regular task, which triggers the basic tasks.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_trigger(uint16_t initCondition)
+{
+    do
+    {
+        /* The counter is incremented first; the basic tasks run immediately when the
+           events are posted and the report should see the current count. */
+        const uint16_t noCycles = ++ _noCycles;
+
+        uintEventVec_t eventVec = EVT_A;
+        if(noCycles % 2 == 0)
+            eventVec |= EVT_B;
+        if(noCycles % 100 == 0)
+            eventVec |= EVT_REPORT;
+        rtos_sendEvent(eventVec);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_trigger */
+
+
+
+
+/**
+ * The host task of the basic tasks.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_host(uint16_t initCondition)
+{
+    btk_runBasicTasks( _basicTaskAry
+                     , /* noBasicTasks */ sizeof(_basicTaskAry)/sizeof(_basicTaskAry[0])
+                     );
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_host */
+
+
+
+
+/**
+ * Basic task A. It counts its activations.
+ *   @param triggerEventVec
+ * The events, which triggered the basic task.
+ */
+
+static void basicTaskA_count(uintEventVec_t triggerEventVec)
+{
+    if(triggerEventVec != EVT_A)
+        ++ _noErrors;
+    ++ _noActivationsA;
+
+} /* End of basicTaskA_count */
+
+
+
+
+/**
+ * Basic task B. It counts its activations.
+ *   @param triggerEventVec
+ * The events, which triggered the basic task.
+ */
+
+static void basicTaskB_count(uintEventVec_t triggerEventVec)
+{
+    if(triggerEventVec != EVT_B)
+        ++ _noErrors;
+    ++ _noActivationsB;
+
+} /* End of basicTaskB_count */
+
+
+
+
+/**
+ * Basic task C. It reports the counters. It has the highest priority of the basic tasks
+ * and is run before A and B in the same cycle.
+ *   @param triggerEventVec
+ * The events, which triggered the basic task.
+ */
+
+static void basicTaskC_report(uintEventVec_t triggerEventVec)
+{
+    if(triggerEventVec != EVT_REPORT)
+        ++ _noErrors;
+
+    /* All basic tasks run in the host task; no critical section is required. The regular
+       task has the lower priority and can't modify its counter now. */
+    printf( "Cycles: %u, activations A: %u, B: %u, errors: %u\n"
+          , _noCycles, _noActivationsA, _noActivationsB, _noErrors
+          );
+    printf( "Unused stack area of host task: %u of %u Byte\n"
+          , rtos_getStackReserve(_idxTaskT0C1), STACK_SIZE_HOST
+          );
+} /* End of basicTaskC_report */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure task 0 of priority class 0. The regular task has the lower priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_trigger
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     TASK_PERIOD
+                       );
+
+    /* Configure task 0 of priority class 1. The host of the basic tasks has the higher
+       priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_host
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,212 @@
+/**
+ * @file tc22_taskTable.c
+ *   Test case 22 of RTuinOS. The tasks are not configured at runtime in setup() but in the
+ * table RTOS_TASK_TABLE in rtos.config.h, which is evaluated at compile time. The task
+ * descriptors are located in flash ROM and the stack areas are allocated by the kernel.\n
+ *   Two regular tasks share priority class 0. A producer posts an event every 5 tics. A
+ * task of higher priority consumes the events and counts them. The second regular task of
+ * class 0 reports the counters and the stack reserve of all tasks every 500 tics; it uses
+ * the task indexes, which are enumerated from the table.\n
+ *   The test case is successful if the number of consumed events equals the number of
+ * produced ones. A change of one of the settings RTOS_NO_TASKS, RTOS_NO_PRIO_CLASSES or
+ * RTOS_MAX_NO_TASKS_IN_PRIO_CLASS, which doesn't match the table, breaks the compilation.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ *   taskT0C0_producer
+ *   taskT1C0_report
+ *   taskT0C1_consumer
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** The period of the producer in system timer tics. */
+#define PERIOD_PRODUCER     5
+
+/** The period of the report in system timer tics. The system time of this application has
+    8 Bit; the period must not exceed 255 tics. */
+#define PERIOD_REPORT       250
+
+/** The event, which is posted by the producer. */
+#define EVT_PRODUCED        (RTOS_EVT_EVENT_00)
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The number of events posted by the producer. */
+static volatile uint16_t _noProduced = 0;
+
+/** The number of events received by the consumer. */
+static volatile uint16_t _noConsumed = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The producer task. The task function is declared by rtos.h, it's taken from the task
+ * table in rtos.config.h.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+void taskT0C0_producer(uintEventVec_t initCondition)
+{
+    do
+    {
+        /* The consumer has the higher priority. The count is incremented first, so that
+           both counters are equal whenever the report task runs. */
+        ++ _noProduced;
+        rtos_sendEvent(EVT_PRODUCED);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_PRODUCER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_producer */
+
+
+
+
+/**
+ * The report task. It shares the priority class with the producer.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+void taskT1C0_report(uintEventVec_t initCondition)
+{
+    do
+    {
+        /* The consumer may interrupt the report; the counters are read atomically. */
+        cli();
+        const uint16_t noProduced = _noProduced
+                     , noConsumed = _noConsumed;
+        sei();
+
+        printf("Produced: %u, consumed: %u\n", noProduced, noConsumed);
+        printf( "Unused stack area of tasks: %u, %u, %u Byte\n"
+              , rtos_getStackReserve(rtos_idxTask_taskT0C0_producer)
+              , rtos_getStackReserve(rtos_idxTask_taskT1C0_report)
+              , rtos_getStackReserve(rtos_idxTask_taskT0C1_consumer)
+              );
+        ASSERT(noProduced == noConsumed);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_REPORT));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT1C0_report */
+
+
+
+
+/**
+ * The consumer task. It is started by the first event of the producer.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+void taskT0C1_consumer(uintEventVec_t initCondition)
+{
+    ASSERT(initCondition == EVT_PRODUCED);
+    ++ _noConsumed;
+
+    while(rtos_waitForEvent(EVT_PRODUCED, /* all */ false, /* timeout */ 0) == EVT_PRODUCED)
+        ++ _noConsumed;
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_consumer */
+
+
+
+
+/**
+ * The general board initialization. The RTOS tasks are configured at compile time and
+ * don't need any initialization code.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(rtos_noTasksInTaskTable == RTOS_NO_TASKS);
+
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,307 @@
+/**
+ * @file tc23_eventGroup.c
+ *   Test case 23 of RTuinOS. A barrier of three producers and one consumer is implemented
+ * with an event group, see evg_eventGroup.h.\n
+ *   Three regular tasks of low priority and with different periods each set their own
+ * flag of the event group. The consumer has the higher priority and waits for all three
+ * flags. It passes the barrier once all producers have set their flag since the last
+ * passage; the flags are cleared on passing. The consumer is resumed only when the last
+ * missing flag is set - not once per producer.\n
+ *   Every 20 passages the consumer reports the number of cycles of the producers, the
+ * number of passages and the number of timeouts. The number of passages is about the
+ * number of cycles of the slowest producer and no timeout should be reported.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   producer
+ *   taskT0C0_producer
+ *   taskT1C0_producer
+ *   taskT2C0_producer
+ *   taskT0C1_consumer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "evg_eventGroup.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the producers. */
+#define STACK_SIZE_PRODUCER 100
+
+/** Stack size of the consumer. */
+#define STACK_SIZE_CONSUMER 256
+
+/** The number of producers. */
+#define NO_PRODUCERS    3
+
+/** The flags of all producers. */
+#define ALL_FLAGS       ((1u<<NO_PRODUCERS)-1)
+
+/** The timeout of the consumer when waiting at the barrier. It's much longer than the
+    period of the slowest producer. */
+#define TIMEOUT_BARRIER 100
+
+/** The kernel event, which is used by the event group to resume the consumer. */
+#define EVT_BARRIER     (RTOS_EVT_EVENT_00)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C0, _idxTaskT2C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_producer(uint16_t initCondition);
+static void taskT1C0_producer(uint16_t initCondition);
+static void taskT2C0_producer(uint16_t initCondition);
+static void taskT0C1_consumer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_PRODUCER]
+             , _taskStackT1C0[STACK_SIZE_PRODUCER]
+             , _taskStackT2C0[STACK_SIZE_PRODUCER]
+             , _taskStackT0C1[STACK_SIZE_CONSUMER];
+
+/** The event group, which implements the barrier. */
+static evg_eventGroup_t _barrier;
+
+/** The periods of the producers in system timer tics. */
+static const uint8_t _periodAry[NO_PRODUCERS] = {3, 5, 7};
+
+/** The number of cycles of the producers. */
+static volatile uint16_t _noCyclesAry[NO_PRODUCERS] = {0, 0, 0};
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The common implementation of all producers. A producer periodically sets its flag.
+ *   @param idxProducer
+ * The index of the producer, 0..#NO_PRODUCERS-1. It's the index of its flag, too.
+ */
+
+static void producer(uint8_t idxProducer)
+{
+    do
+    {
+        ++ _noCyclesAry[idxProducer];
+        evg_setFlags(&_barrier, 1u<<idxProducer);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ _periodAry[idxProducer]));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of producer */
+
+
+
+
+/**
+ * Producer 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_producer(uint16_t initCondition)
+{
+    producer(0);
+
+} /* End of taskT0C0_producer */
+
+
+
+
+/**
+ * Producer 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C0_producer(uint16_t initCondition)
+{
+    producer(1);
+
+} /* End of taskT1C0_producer */
+
+
+
+
+/**
+ * Producer 2.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT2C0_producer(uint16_t initCondition)
+{
+    producer(2);
+
+} /* End of taskT2C0_producer */
+
+
+
+
+/**
+ * The consumer, which repeatedly passes the barrier.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_consumer(uint16_t initCondition)
+{
+    uint16_t noPassages = 0
+           , noTimeouts = 0;
+
+    while(true)
+    {
+        const evg_flagVec_t flagVec = evg_waitForFlags( &_barrier
+                                                      , ALL_FLAGS
+                                                      , /* all */ true
+                                                      , /* clearOnExit */ true
+                                                      , TIMEOUT_BARRIER
+                                                      );
+        if(flagVec == 0)
+            ++ noTimeouts;
+        else if(++noPassages % 20 == 0)
+        {
+            ASSERT(flagVec == ALL_FLAGS);
+
+            /* The producers have the lower priority. They can't change their counters
+               while the consumer is running. */
+            printf( "Cycles: %u, %u, %u, passages: %u, timeouts: %u\n"
+                  , _noCyclesAry[0], _noCyclesAry[1], _noCyclesAry[2]
+                  , noPassages, noTimeouts
+                  );
+        }
+    }
+} /* End of taskT0C1_consumer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    evg_initEventGroup(&_barrier, EVT_BARRIER);
+
+    /* Configure the producers of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C0
+                       , /* taskFunction */     taskT1C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT1C0[0]
+                       , /* stackSize */        sizeof(_taskStackT1C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     2
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT2C0
+                       , /* taskFunction */     taskT2C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT2C0[0]
+                       , /* stackSize */        sizeof(_taskStackT2C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     3
+                       );
+
+    /* Configure the consumer of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_consumer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,254 @@
+/**
+ * @file tc24_edfScheduling.c
+ *   Test case 24 of RTuinOS. Two regular tasks of different periods share priority class
+ * 0, which is scheduled earliest deadline first, see #RTOS_USE_EDF_PRIO_CLASS.\n
+ *   The fast task has a period of two system timer tics and consumes 45% of the CPU time,
+ * the slow task has a period of five tics and consumes 48%. The CPU time of an activation
+ * is measured with the runtime accounting of the kernel. The total load of 93% exceeds the
+ * bound of fixed priorities: If the fast task had the higher priority, the slow one
+ * would need 5.1 tics to complete and miss its deadline. With EDF, both tasks meet all
+ * deadlines.\n
+ *   The idle task reports the number of cycles, the task overruns and the CPU load once a
+ * second. No overrun should be reported. (The host simulation may see a rare overrun,
+ * when the host doesn't deliver the timer signal in time.) Set #RTOS_USE_EDF_PRIO_CLASS to
+ * #RTOS_FEATURE_OFF to see the overruns of the fast task under first come, first served
+ * scheduling: It misses a deadline whenever the slow task is active.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   consumeCpuTime
+ *   taskT0C0_fast
+ *   taskT1C0_slow
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the tasks. */
+#define STACK_SIZE      100
+
+/** The period of the fast task in system timer tics. */
+#define PERIOD_FAST     2
+
+/** The period of the slow task in system timer tics. */
+#define PERIOD_SLOW     5
+
+/** The CPU time of an activation of the fast task in microseconds. */
+#define TI_CPU_FAST     ((uint32_t)(0.9*(RTOS_TIC)*1e6))
+
+/** The CPU time of an activation of the slow task in microseconds. */
+#define TI_CPU_SLOW     ((uint32_t)(2.4*(RTOS_TIC)*1e6))
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C0, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_fast(uint16_t initCondition);
+static void taskT1C0_slow(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE]
+             , _taskStackT1C0[STACK_SIZE];
+
+/** The number of cycles of the fast task. */
+static volatile uint16_t _noCyclesFast = 0;
+
+/** The number of cycles of the slow task. */
+static volatile uint16_t _noCyclesSlow = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * Let the calling task consume some CPU time. The time, which the task is preempted by
+ * another one, is not counted.
+ *   @param idxTask
+ * The index of the calling task.
+ *   @param tiCpu
+ * The CPU time to consume in microseconds.
+ */
+
+static void consumeCpuTime(uint8_t idxTask, uint32_t tiCpu)
+{
+    const uint32_t tiStart = rtos_getTaskRuntime(idxTask, /* doReset */ false);
+    while(rtos_getTaskRuntime(idxTask, /* doReset */ false) - tiStart < tiCpu)
+        ;
+
+} /* End of consumeCpuTime */
+
+
+
+
+/**
+ * The fast regular task.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_fast(uint16_t initCondition)
+{
+    do
+    {
+        consumeCpuTime(_idxTaskT0C0, TI_CPU_FAST);
+        ++ _noCyclesFast;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_FAST));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_fast */
+
+
+
+
+/**
+ * The slow regular task.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C0_slow(uint16_t initCondition)
+{
+    do
+    {
+        consumeCpuTime(_idxTaskT1C0, TI_CPU_SLOW);
+        ++ _noCyclesSlow;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_SLOW));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT1C0_slow */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure both tasks in priority class 0. The first due time is one period after
+       start, so that the kernel derives the correct deadline of the first activation,
+       too. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_fast
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     PERIOD_FAST
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C0
+                       , /* taskFunction */     taskT1C0_slow
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT1C0[0]
+                       , /* stackSize */        sizeof(_taskStackT1C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     PERIOD_SLOW
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.\n
+ *   The cycles and overruns of the tasks are reported once a second.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static unsigned long tiNextReport = 1000;
+
+    if((long)(millis() - tiNextReport) >= 0)
+    {
+        tiNextReport += 1000;
+
+        cli();
+        const uint16_t noCyclesFast = _noCyclesFast
+                     , noCyclesSlow = _noCyclesSlow;
+        sei();
+
+        /* The CPU load has a resolution of 0.5%. */
+        const uint8_t cpuLoad = rtos_getCpuLoad(/* doReset */ true);
+
+        printf( "Cycles: %u, %u, overruns: %u, %u, CPU load: %u.%u%%\n"
+              , noCyclesFast, noCyclesSlow
+              , rtos_getTaskOverrunCounter(_idxTaskT0C0, /* doReset */ false)
+              , rtos_getTaskOverrunCounter(_idxTaskT1C0, /* doReset */ false)
+              , cpuLoad/2, (cpuLoad%2)*5
+              );
+    }
+} /* End of loop */
@@ -0,0 +1,312 @@
+/**
+ * @file tc25_periodicTasks.c
+ *   Test case 25 of RTuinOS. Three periodic tasks, which are declared by
+ * rtos_setTaskPeriod, have the same period but different phase offsets and overrun
+ * policies.\n
+ *   Each task waits for its next release with rtos_waitForNextPeriod; it doesn't state its
+ * timing in the loop. Every tenth activation is made too long by a delay, which exceeds the
+ * period. The three overrun policies react differently: The task with policy catch-up
+ * doesn't lose an activation; its number of cycles is the number of periods, which have
+ * elapsed. The task with policy skip loses one activation per overrun; its number of
+ * cycles is the number of periods less the number of overruns. The task with policy
+ * immediate shifts its grid by the duration of the overrun; it loses a fraction of an
+ * activation per overrun.\n
+ *   A periodic reporting task of higher priority prints the cycles and overruns of the
+ * three tasks and the number of elapsed periods every 500 tics.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   periodicTask
+ *   taskT0C0_immediate
+ *   taskT1C0_skip
+ *   taskT2C0_catchUp
+ *   taskT0C1_report
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the periodic tasks. */
+#define STACK_SIZE_TASK     100
+
+/** Stack size of the reporting task. */
+#define STACK_SIZE_REPORT   256
+
+/** The period of the tested tasks in system timer tics. */
+#define PERIOD              10
+
+/** The duration of every tenth activation of a tested task in system timer tics. */
+#define TI_LONG_ACTIVATION  12
+
+/** The period of the reporting task in system timer tics. */
+#define PERIOD_REPORT       100
+
+/** The report is printed every so many cycles of the reporting task. */
+#define NO_CYCLES_REPORT    5
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C0, _idxTaskT2C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_immediate(uint16_t initCondition);
+static void taskT1C0_skip(uint16_t initCondition);
+static void taskT2C0_catchUp(uint16_t initCondition);
+static void taskT0C1_report(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_TASK]
+             , _taskStackT1C0[STACK_SIZE_TASK]
+             , _taskStackT2C0[STACK_SIZE_TASK]
+             , _taskStackT0C1[STACK_SIZE_REPORT];
+
+/** The number of cycles of the tested tasks. */
+static volatile uint16_t _noCyclesAry[3] = {0, 0, 0};
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The common implementation of the tested tasks.
+ *   @param idxTask
+ * The index of the task, 0..2.
+ */
+
+static void periodicTask(uint8_t idxTask)
+{
+    do
+    {
+        /* The counter is incremented at the beginning of the activation; it counts the
+           releases of the task. */
+        if(++_noCyclesAry[idxTask] % 10 == 0)
+            rtos_delay(TI_LONG_ACTIVATION);
+    }
+    while(rtos_waitForNextPeriod());
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of periodicTask */
+
+
+
+
+/**
+ * The task with overrun policy immediate.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_immediate(uint16_t initCondition)
+{
+    periodicTask(_idxTaskT0C0);
+
+} /* End of taskT0C0_immediate */
+
+
+
+
+/**
+ * The task with overrun policy skip.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C0_skip(uint16_t initCondition)
+{
+    periodicTask(_idxTaskT1C0);
+
+} /* End of taskT1C0_skip */
+
+
+
+
+/**
+ * The task with overrun policy catch-up.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT2C0_catchUp(uint16_t initCondition)
+{
+    periodicTask(_idxTaskT2C0);
+
+} /* End of taskT2C0_catchUp */
+
+
+
+
+/**
+ * The reporting task.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_report(uint16_t initCondition)
+{
+    uint16_t noCycles = 0;
+
+    do
+    {
+        if(++noCycles % NO_CYCLES_REPORT == 0)
+        {
+            /* The tested tasks have the lower priority and all of them have been released
+               in this tic already. They can't change their counters while the report is
+               running. */
+            printf( "Periods: %u, cycles: %u, %u, %u, overruns: %u, %u, %u\n"
+                  , noCycles * (PERIOD_REPORT/PERIOD)
+                  , _noCyclesAry[0], _noCyclesAry[1], _noCyclesAry[2]
+                  , rtos_getTaskOverrunCounter(_idxTaskT0C0, /* doReset */ false)
+                  , rtos_getTaskOverrunCounter(_idxTaskT1C0, /* doReset */ false)
+                  , rtos_getTaskOverrunCounter(_idxTaskT2C0, /* doReset */ false)
+                  );
+        }
+    }
+    while(rtos_waitForNextPeriod());
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_report */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the tested tasks of priority class 0. The start condition doesn't matter;
+       it is replaced by the first release of the periodic task. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_immediate
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C0
+                       , /* taskFunction */     taskT1C0_skip
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT1C0[0]
+                       , /* stackSize */        sizeof(_taskStackT1C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT2C0
+                       , /* taskFunction */     taskT2C0_catchUp
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT2C0[0]
+                       , /* stackSize */        sizeof(_taskStackT2C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the reporting task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_report
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* The phase offsets distribute the tested tasks on the tics. The report is released
+       after the tested tasks of the same period. */
+    rtos_setTaskPeriod(_idxTaskT0C0, PERIOD, /* phase */ 0, RTOS_OVERRUN_POLICY_IMMEDIATE);
+    rtos_setTaskPeriod(_idxTaskT1C0, PERIOD, /* phase */ 3, RTOS_OVERRUN_POLICY_SKIP);
+    rtos_setTaskPeriod(_idxTaskT2C0, PERIOD, /* phase */ 6, RTOS_OVERRUN_POLICY_CATCH_UP);
+    rtos_setTaskPeriod( _idxTaskT0C1
+                      , PERIOD_REPORT
+                      , /* phase */ PERIOD_REPORT-1
+                      , RTOS_OVERRUN_POLICY_IMMEDIATE
+                      );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,299 @@
+/**
+ * @file tc26_phasePlanner.c
+ *   Test case 26 of RTuinOS. The phases of five regular tasks are chosen by the phase
+ * planner, see pha_phasePlanner.h.\n
+ *   The tasks have periods of 2, 4, 5, 10 and 20 tics and different execution times. If
+ * all of them were started in the same tic, then every 20th tic would have to serve the
+ * sum of all execution times, which is 2.6 ms and more than a tic. The planner distributes
+ * the tasks such that the peak work per tic is much lower. The test reports the planned
+ * phases and the peak work with and without planning.\n
+ *   The tasks are then started with their planned phases. Each activation consumes its
+ * execution time by busy waiting. The idle task reports the cycles and the overruns of
+ * the tasks once a second; no overrun should be seen.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   regularTask
+ *   taskT0C0
+ *   taskT1C0
+ *   taskT2C0
+ *   taskT3C0
+ *   taskT4C0
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "pha_phasePlanner.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the tasks. */
+#define STACK_SIZE      100
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C0, _idxTaskT2C0, _idxTaskT3C0, _idxTaskT4C0, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0(uint16_t initCondition);
+static void taskT1C0(uint16_t initCondition);
+static void taskT2C0(uint16_t initCondition);
+static void taskT3C0(uint16_t initCondition);
+static void taskT4C0(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackAryAry[_noTasks][STACK_SIZE];
+
+/** The task functions. */
+static const rtos_taskFunction_t _taskFunctionAry[_noTasks] =
+    {taskT0C0, taskT1C0, taskT2C0, taskT3C0, taskT4C0};
+
+/** The timing of the tasks. The phases are planned in setup(). */
+static pha_taskTiming_t _taskTimingAry[_noTasks] =
+{
+    {/* period */ 2, /* tiExecution */ 500, /* phase */ 0},
+    {/* period */ 4, /* tiExecution */ 400, /* phase */ 0},
+    {/* period */ 5, /* tiExecution */ 600, /* phase */ 0},
+    {/* period */ 10, /* tiExecution */ 800, /* phase */ 0},
+    {/* period */ 20, /* tiExecution */ 300, /* phase */ 0},
+};
+
+/** The number of cycles of the tasks. */
+static volatile uint16_t _noCyclesAry[_noTasks];
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The common implementation of all tasks. Each activation consumes the execution time of
+ * the task.
+ *   @param idxTask
+ * The index of the task.
+ */
+
+static void regularTask(uint8_t idxTask)
+{
+    const pha_taskTiming_t * const pTaskTiming = &_taskTimingAry[idxTask];
+    do
+    {
+        delayMicroseconds(pTaskTiming->tiExecution);
+        ++ _noCyclesAry[idxTask];
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ pTaskTiming->period));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of regularTask */
+
+
+
+
+/**
+ * Task 0 of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0(uint16_t initCondition)
+{
+    regularTask(_idxTaskT0C0);
+
+} /* End of taskT0C0 */
+
+
+
+
+/**
+ * Task 1 of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C0(uint16_t initCondition)
+{
+    regularTask(_idxTaskT1C0);
+
+} /* End of taskT1C0 */
+
+
+
+
+/**
+ * Task 2 of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT2C0(uint16_t initCondition)
+{
+    regularTask(_idxTaskT2C0);
+
+} /* End of taskT2C0 */
+
+
+
+
+/**
+ * Task 3 of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT3C0(uint16_t initCondition)
+{
+    regularTask(_idxTaskT3C0);
+
+} /* End of taskT3C0 */
+
+
+
+
+/**
+ * Task 4 of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT4C0(uint16_t initCondition)
+{
+    regularTask(_idxTaskT4C0);
+
+} /* End of taskT4C0 */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    uint8_t idxTask;
+
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* The peak work if all tasks start in the same tic. The phases are still zero. */
+    const uint16_t tiPeakUnplanned = pha_getPeakLoad(_taskTimingAry, _noTasks);
+    const uint16_t tiPeakPlanned = pha_planPhases(_taskTimingAry, _noTasks);
+    printf( "Peak work per tic: %u us unplanned, %u us planned, tic: %u us\n"
+          , tiPeakUnplanned, tiPeakPlanned, (unsigned)(RTOS_TIC*1e6)
+          );
+
+    /* Configure all tasks in priority class 0. They are started at their planned phase. */
+    for(idxTask=0; idxTask<_noTasks; ++idxTask)
+    {
+        const pha_taskTiming_t * const pTaskTiming = &_taskTimingAry[idxTask];
+        printf( "Task %u: period %u, execution time %u us, phase %u\n"
+              , idxTask, pTaskTiming->period, pTaskTiming->tiExecution, pTaskTiming->phase
+              );
+        rtos_initializeTask( /* idxTask */          idxTask
+                           , /* taskFunction */     _taskFunctionAry[idxTask]
+                           , /* prioClass */        0
+                           , /* pStackArea */       &_taskStackAryAry[idxTask][0]
+                           , /* stackSize */        sizeof(_taskStackAryAry[idxTask])
+                           , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                           , /* startByAllEvents */ false
+                           , /* startTimeout */     pTaskTiming->phase
+                           );
+    }
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.\n
+ *   The cycles and overruns of the tasks are reported once a second.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static unsigned long tiNextReport = 1000;
+
+    if((long)(millis() - tiNextReport) >= 0)
+    {
+        uint8_t idxTask;
+
+        tiNextReport += 1000;
+        for(idxTask=0; idxTask<_noTasks; ++idxTask)
+        {
+            cli();
+            const uint16_t noCycles = _noCyclesAry[idxTask];
+            sei();
+            printf( "Task %u: cycles: %u, overruns: %u\n"
+                  , idxTask
+                  , noCycles
+                  , rtos_getTaskOverrunCounter(idxTask, /* doReset */ false)
+                  );
+        }
+    }
+} /* End of loop */
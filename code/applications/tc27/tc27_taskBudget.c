@@ -0,0 +1,339 @@
+/**
+ * @file tc27_taskBudget.c
+ *   Test case 27 of RTuinOS. A task of high priority is limited by a CPU budget, see
+ * rtos_setTaskBudget.\n
+ *   The task of priority class 2 stands for a server of sporadic requests, which is
+ * flooded with requests: It never suspends. Without a budget it would starve all tasks of
+ * lower priority. Its budget is 5 tics per 10 tics. When it is exhausted, the task is
+ * demoted to class 0 and it continues only with the CPU time, which is left over by the
+ * others.\n
+ *   Class 0 is shared with a background task, which never suspends either. The demoted
+ * server is appended to the due list of class 0; as there's no round robin, the
+ * background task gets all of the left over CPU time and the server gets nothing beyond
+ * its budget. The reporting task checks that the background task makes progress.\n
+ *   A regular task of class 1 has a period of 10 tics and an execution time of about 2.5
+ * tics. In each replenishment period it has to wait at most for the budget of the server
+ * and it still completes in time. A reporting task of class 3 prints the cycles of the
+ * regular task, its overruns and the work done by the server about once a second. The
+ * regular task needs to see one cycle per 10 tics and no overrun.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_background
+ *   taskT0C1_regular
+ *   taskT0C2_server
+ *   taskT0C3_report
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the tasks. */
+#define STACK_SIZE          100
+
+/** Stack size of the reporting task, which calls printf. */
+#define STACK_SIZE_REPORT   256
+
+/** The period of the regular task in system timer tics. */
+#define TASK_PERIOD         10
+
+/** The execution time of the regular task in microseconds. */
+#define TI_EXECUTION        5000
+
+/** The CPU budget of the server in system timer tics per replenishment period. */
+#define SERVER_BUDGET       5
+
+/** The replenishment period of the budget of the server in system timer tics. */
+#define SERVER_PERIOD_REPLENISH 10
+
+/** The period of the reporting task in system timer tics. A report is printed in every
+    #NO_CYCLES_PER_REPORT th cycle. */
+#define REPORT_PERIOD       125
+
+/** The number of cycles of the reporting task between two reports. */
+#define NO_CYCLES_PER_REPORT 4
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _idxTaskT0C2, _idxTaskT0C3, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_background(uint16_t initCondition);
+static void taskT0C1_regular(uint16_t initCondition);
+static void taskT0C2_server(uint16_t initCondition);
+static void taskT0C3_report(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE]
+             , _taskStackT0C1[STACK_SIZE]
+             , _taskStackT0C2[STACK_SIZE]
+             , _taskStackT0C3[STACK_SIZE_REPORT];
+
+/** The number of cycles of the regular task. */
+static volatile uint16_t _noCyclesRegular = 0;
+
+/** The work done by the server in units of 100 us. */
+static volatile uint32_t _noWorkUnitsServer = 0;
+
+/** The work done by the background task in units of 100 us. */
+static volatile uint32_t _noWorkUnitsBackground = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The background task of priority class 0. It never suspends and it shares its class with
+ * the server while the server has exhausted its budget.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_background(uint16_t initCondition)
+{
+    while(true)
+    {
+        delayMicroseconds(100);
+
+        /* The 32 Bit counter is shared with the reporting task; the increment needs to be
+           atomic. */
+        cli();
+        ++ _noWorkUnitsBackground;
+        sei();
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_background */
+
+
+
+
+/**
+ * The regular task of priority class 1. It consumes about a quarter of the CPU time.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_regular(uint16_t initCondition)
+{
+    do
+    {
+        delayMicroseconds(TI_EXECUTION);
+        ++ _noCyclesRegular;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_regular */
+
+
+
+
+/**
+ * The flooded server of priority class 2. It never suspends and only its budget lets the
+ * tasks of lower priority run.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C2_server(uint16_t initCondition)
+{
+    while(true)
+    {
+        delayMicroseconds(100);
+
+        /* The 32 Bit counter is shared with the reporting task; the increment needs to be
+           atomic. */
+        cli();
+        ++ _noWorkUnitsServer;
+        sei();
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C2_server */
+
+
+
+
+/**
+ * The reporting task of priority class 3.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C3_report(uint16_t initCondition)
+{
+    uint8_t cntCycles = 0;
+    uint32_t noWorkUnitsBackgroundLast = 0;
+    do
+    {
+        if(++cntCycles == NO_CYCLES_PER_REPORT)
+        {
+            cntCycles = 0;
+
+            /* The exhausted server is served after the background task in class 0. If it
+               were put ahead, the background task would never run. */
+            ASSERT(_noWorkUnitsBackground != noWorkUnitsBackgroundLast);
+            noWorkUnitsBackgroundLast = _noWorkUnitsBackground;
+
+            /* The other tasks have the lower priority and can't modify their counters
+               now. */
+            printf( "Regular task: cycles: %u, overruns: %u. Server: work: %lu ms."
+                    " Background task: work: %lu ms\n"
+                  , _noCyclesRegular
+                  , rtos_getTaskOverrunCounter(_idxTaskT0C1, /* doReset */ false)
+                  , (unsigned long)(_noWorkUnitsServer / 10)
+                  , (unsigned long)(_noWorkUnitsBackground / 10)
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ REPORT_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C3_report */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the background task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_background
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the regular task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_regular
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     TASK_PERIOD
+                       );
+
+    /* Configure the server of priority class 2 and limit its CPU time. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C2
+                       , /* taskFunction */     taskT0C2_server
+                       , /* prioClass */        2
+                       , /* pStackArea */       &_taskStackT0C2[0]
+                       , /* stackSize */        sizeof(_taskStackT0C2)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_setTaskBudget( _idxTaskT0C2
+                      , /* budget */          SERVER_BUDGET
+                      , /* periodReplenish */ SERVER_PERIOD_REPLENISH
+                      );
+
+    /* Configure the reporting task of priority class 3. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C3
+                       , /* taskFunction */     taskT0C3_report
+                       , /* prioClass */        3
+                       , /* pStackArea */       &_taskStackT0C3[0]
+                       , /* stackSize */        sizeof(_taskStackT0C3)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     REPORT_PERIOD
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due. In this test case, the background task consumes all the time, that is left, and
+ * the idle task is never activated.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,271 @@
+/**
+ * @file tc28_waitTillDeadline.c
+ *   Test case 28 of RTuinOS. A multi-stage protocol is supervised by a single deadline,
+ * see rtos_waitForEventTillDeadline.\n
+ *   A regular task of priority class 1 is the master of the protocol. In each cycle it
+ * sends a request to the task of class 0 and awaits three answers. Each answer is an
+ * event, which makes the master wait again against the same deadline till the last
+ * answer has been received or the deadline is reached.\n
+ *   The task of class 0 responds to a request with three answers, each after a
+ * pseudo-random delay of 1 .. 9 tics. Some protocol runs exceed the timeout. The master
+ * reports the number of completed and timed-out protocol runs and the minimum remaining
+ * time of the completed runs. It double-checks that a timeout is never seen before the
+ * deadline and that no completed run is reported with a time beyond the deadline; the
+ * error counter needs to stay zero.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_responder
+ *   taskT0C1_master
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the responding task. */
+#define STACK_SIZE_RESPONDER    100
+
+/** Stack size of the master, which calls printf. */
+#define STACK_SIZE_MASTER       256
+
+/** The period of the master in system timer tics. */
+#define TASK_PERIOD             40
+
+/** The timeout of a complete protocol run in system timer tics. */
+#define TIMEOUT_PROTOCOL        20
+
+/** The number of answers of a protocol run. */
+#define NO_STAGES               3
+
+/** The master reports the results every #NO_CYCLES_PER_REPORT th cycle. */
+#define NO_CYCLES_PER_REPORT    10
+
+/** The event, which requests a protocol run. */
+#define EVT_REQUEST             (RTOS_EVT_EVENT_00)
+
+/** The event, which is an answer of the responder. */
+#define EVT_ANSWER              (RTOS_EVT_EVENT_01)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_responder(uint16_t initCondition);
+static void taskT0C1_master(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_RESPONDER]
+             , _taskStackT0C1[STACK_SIZE_MASTER];
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The responder of priority class 0. It answers each request with a sequence of answers.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_responder(uint16_t initCondition)
+{
+    /* A linear congruential generator yields the pseudo-random delays. */
+    uint16_t random = 1;
+
+    while(rtos_waitForEvent(EVT_REQUEST, /* all */ false, /* timeout */ 0) == EVT_REQUEST)
+    {
+        uint8_t u;
+        for(u=0; u<NO_STAGES; ++u)
+        {
+            random = random*25173u + 13849u;
+            rtos_delay(1 + (random >> 8) % 9);
+            rtos_sendEvent(EVT_ANSWER);
+        }
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_responder */
+
+
+
+
+/**
+ * The master of the protocol of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_master(uint16_t initCondition)
+{
+    uint16_t noCycles = 0
+           , noCompleted = 0
+           , noTimeouts = 0
+           , noErrors = 0;
+    uintTime_t minRemainingTime = TIMEOUT_PROTOCOL;
+
+    do
+    {
+        const uintTime_t timeDeadline = rtos_getTime() + TIMEOUT_PROTOCOL;
+        uintTime_t remainingTime = TIMEOUT_PROTOCOL;
+        uint8_t noAnswers = 0;
+
+        /* The responder has the lower priority. It doesn't become active before the
+           master waits for the first answer. */
+        rtos_sendEvent(EVT_REQUEST);
+        while(noAnswers < NO_STAGES)
+        {
+            const uintEventVec_t postedEventVec =
+                                rtos_waitForEventTillDeadline( EVT_ANSWER
+                                                             , /* all */ false
+                                                             , timeDeadline
+                                                             , &remainingTime
+                                                             );
+            if(postedEventVec == RTOS_EVT_DELAY_TIMER)
+            {
+                /* The timeout is seen in the tic the deadline is reached in. */
+                if(remainingTime != 0  ||  rtos_getTime() != timeDeadline)
+                    ++ noErrors;
+                break;
+            }
+            else if(postedEventVec == EVT_ANSWER  &&  remainingTime > 0)
+                ++ noAnswers;
+            else
+            {
+                ++ noErrors;
+                break;
+            }
+        }
+
+        if(noAnswers == NO_STAGES)
+        {
+            ++ noCompleted;
+            if(remainingTime < minRemainingTime)
+                minRemainingTime = remainingTime;
+        }
+        else
+            ++ noTimeouts;
+
+        if(++noCycles % NO_CYCLES_PER_REPORT == 0)
+        {
+            printf( "Protocol runs: %u, completed: %u, timeouts: %u, min. remaining time:"
+                    " %u tics, errors: %u\n"
+                  , noCycles, noCompleted, noTimeouts, minRemainingTime, noErrors
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_master */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the responder of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_responder
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the master of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_master
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     5
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
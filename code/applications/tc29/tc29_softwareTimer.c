@@ -0,0 +1,340 @@
+/**
+ * @file tc29_softwareTimer.c
+ *   Test case 29 of RTuinOS. Periodic and one-shot software timers share a single timer
+ * task, see tim_softwareTimer.h.\n
+ *   Three periodic timers are run by the timer task of priority class 1: A fast timer
+ * with a period of 3 tics, a slow timer with a period of 100 tics, which stands for a
+ * clock, and a timer with a period of 120 tics, which reports the results about once a
+ * second. A one-shot timer is used as watchdog: A regular task of class 0 retriggers it
+ * every 7 tics with a delay of 10 tics, so that it never elapses. In each 50th cycle the
+ * task pauses for 15 tics and the watchdog elapses once.\n
+ *   The report compares the counted callbacks with the numbers, which are expected from
+ * the elapsed time. The number of watchdog callbacks and the number of pauses need to be
+ * identical. The stack reserve of the timer task shows that all callbacks share a single
+ * stack area.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_retrigger
+ *   taskT0C1_timer
+ *   onFastTimer
+ *   onClockTimer
+ *   onWatchdogTimer
+ *   onReportTimer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "tim_softwareTimer.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the regular task. */
+#define STACK_SIZE_RETRIGGER    100
+
+/** Stack size of the timer task, which is shared by all callbacks. */
+#define STACK_SIZE_TIMER        256
+
+/** The period of the fast timer in system timer tics. */
+#define PERIOD_FAST             3
+
+/** The period of the clock timer in system timer tics. */
+#define PERIOD_CLOCK            100
+
+/** The period of the report timer in system timer tics. */
+#define PERIOD_REPORT           120
+
+/** The number of callbacks of the report timer between two reports. */
+#define NO_CYCLES_PER_REPORT    4
+
+/** The delay of the watchdog timer in system timer tics. */
+#define DELAY_WATCHDOG          10
+
+/** The period of the regular task, which retriggers the watchdog, in system timer tics. */
+#define PERIOD_RETRIGGER        7
+
+/** The regular task pauses for #DURATION_PAUSE tics once in #NO_CYCLES_PER_PAUSE
+    cycles. */
+#define NO_CYCLES_PER_PAUSE     50
+
+/** The duration of a pause of the regular task in system timer tics. */
+#define DURATION_PAUSE          15
+
+/** The event, which notifies the timer task of a changed list of timers. */
+#define EVT_TIMER_LIST_CHANGED  (RTOS_EVT_EVENT_00)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_retrigger(uint16_t initCondition);
+static void taskT0C1_timer(uint16_t initCondition);
+static void onFastTimer(tim_timer_t *pTimer);
+static void onClockTimer(tim_timer_t *pTimer);
+static void onWatchdogTimer(tim_timer_t *pTimer);
+static void onReportTimer(tim_timer_t *pTimer);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_RETRIGGER]
+             , _taskStackT0C1[STACK_SIZE_TIMER];
+
+/** The software timers. */
+static tim_timer_t _timerFast
+                 , _timerClock
+                 , _timerWatchdog
+                 , _timerReport;
+
+/** The number of callbacks of the fast timer. */
+static uint16_t _noCallbacksFast = 0;
+
+/** The number of callbacks of the clock timer. */
+static uint16_t _noCallbacksClock = 0;
+
+/** The number of callbacks of the watchdog timer. */
+static uint16_t _noCallbacksWatchdog = 0;
+
+/** The number of pauses of the regular task. */
+static volatile uint16_t _noPauses = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The regular task of priority class 0. It retriggers the watchdog timer.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_retrigger(uint16_t initCondition)
+{
+    uint8_t cntCycles = 0;
+    do
+    {
+        tim_startTimer(&_timerWatchdog, DELAY_WATCHDOG, /* period */ 0);
+        if(++cntCycles == NO_CYCLES_PER_PAUSE)
+        {
+            cntCycles = 0;
+            ++ _noPauses;
+            rtos_delay(DURATION_PAUSE);
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_RETRIGGER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_retrigger */
+
+
+
+
+/**
+ * The timer task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_timer(uint16_t initCondition)
+{
+    tim_runTimerTask(EVT_TIMER_LIST_CHANGED);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_timer */
+
+
+
+
+/**
+ * The callback of the fast periodic timer. It counts its calls.
+ *   @param pTimer
+ * The elapsed timer.
+ */
+
+static void onFastTimer(tim_timer_t *pTimer)
+{
+    ASSERT(pTimer == &_timerFast);
+    ++ _noCallbacksFast;
+
+} /* End of onFastTimer */
+
+
+
+
+/**
+ * The callback of the clock timer. It counts its calls.
+ *   @param pTimer
+ * The elapsed timer.
+ */
+
+static void onClockTimer(tim_timer_t *pTimer)
+{
+    ASSERT(pTimer == &_timerClock);
+    ++ _noCallbacksClock;
+
+} /* End of onClockTimer */
+
+
+
+
+/**
+ * The callback of the watchdog timer. It elapses only if the regular task pauses.
+ *   @param pTimer
+ * The elapsed timer.
+ */
+
+static void onWatchdogTimer(tim_timer_t *pTimer)
+{
+    ASSERT(pTimer == &_timerWatchdog);
+    ++ _noCallbacksWatchdog;
+
+} /* End of onWatchdogTimer */
+
+
+
+
+/**
+ * The callback of the report timer. It prints the counters.
+ *   @param pTimer
+ * The elapsed timer.
+ */
+
+static void onReportTimer(tim_timer_t *pTimer)
+{
+    static uint16_t noCycles = 0;
+
+    if(++noCycles % NO_CYCLES_PER_REPORT == 0)
+    {
+        /* All callbacks run in the timer task; no critical section is required for their
+           counters. */
+        const uint32_t noTics = (uint32_t)noCycles * PERIOD_REPORT + 1;
+        printf( "Tics: %lu, fast timer: %u (%lu), clock: %u (%lu), watchdog: %u (%u)\n"
+              , (unsigned long)noTics
+              , _noCallbacksFast, (unsigned long)(noTics/PERIOD_FAST)
+              , _noCallbacksClock, (unsigned long)(noTics/PERIOD_CLOCK)
+              , _noCallbacksWatchdog, _noPauses
+              );
+        printf( "Unused stack area of timer task: %u of %u Byte\n"
+              , rtos_getStackReserve(_idxTaskT0C1), STACK_SIZE_TIMER
+              );
+    }
+} /* End of onReportTimer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* The periodic timers are started before the kernel. They are counted from the first
+       tic on. The report timer elapses in tic 120, 240, etc. and never in the same tic
+       as one of the others; the counters are always up to date in the report. */
+    tim_initTimer(&_timerFast, onFastTimer);
+    tim_initTimer(&_timerClock, onClockTimer);
+    tim_initTimer(&_timerWatchdog, onWatchdogTimer);
+    tim_initTimer(&_timerReport, onReportTimer);
+    tim_startTimer(&_timerFast, /* delay */ PERIOD_FAST, /* period */ PERIOD_FAST);
+    tim_startTimer(&_timerClock, /* delay */ PERIOD_CLOCK, /* period */ PERIOD_CLOCK);
+    tim_startTimer(&_timerReport, /* delay */ PERIOD_REPORT+1, /* period */ PERIOD_REPORT);
+
+    /* Configure the regular task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_retrigger
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the timer task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_timer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,283 @@
+/**
+ * @file tc30_eventBus.c
+ *   Test case 30 of RTuinOS. An event is sent across the event bus ebs_eventBus.c. A task
+ * of low priority regularly posts the event by ebs_sendEvent. The event is mapped to a
+ * node of the bus; it is sent in a frame over USART1 and posted by the receive interrupt
+ * of the destination node, where it resumes a task of high priority. This task measures
+ * the latency from sending to receiving the event.\n
+ *   What do you need? What do you get?\n
+ * The test case runs on a single Arduino Mega board, which is a ring of one node: Connect
+ * the transmitter of USART1, TX1 at pin 18, with its receiver, RX1 at pin 19. The event is
+ * mapped to the own node, it goes once around the ring. Every second, the console shows the
+ * number of sent and received events, the minimum and maximum latency and the diagnostic
+ * counters of the bus. Without the wire, all events are lost.\n
+ *   Two boards can be used, too: Cross-wire TX1 and RX1 of the boards and connect their
+ * ground. Compile the application once with #OWN_NODE_ID 0 and #REMOTE_NODE_ID 1 and once
+ * with the two IDs swapped. Each board resumes the receiving task of the other one; the
+ * latency can't be measured in this configuration and the console shows zero.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_sender
+ *   taskT0C1_receiver
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "ser_serial.h"
+#include "ebs_eventBus.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Common stack size of tasks. */
+#define STACK_SIZE   256
+
+/** The ID of this node on the event bus. */
+#define OWN_NODE_ID     0
+
+/** The ID of the node, which the event is sent to. With the loop back wire, this is the
+    own node. */
+#define REMOTE_NODE_ID  OWN_NODE_ID
+
+/** The Baud rate of the event bus. A frame of 5 Byte takes about 430 us. */
+#define BAUD_RATE_BUS   115200
+
+/** The period of the sending task in system timer tics. */
+#define TASK_PERIOD     10
+
+/** The sending task prints the results once in this number of cycles. */
+#define NO_CYCLES_PER_PRINT 50
+
+/** The event, which is used by the serial driver to resume a task waiting for space in
+    the transmit buffer. */
+#define EVT_TX_SPACE_SERIAL (RTOS_EVT_EVENT_00)
+
+/** The event, which is used by the event bus to resume a task waiting for space in the
+    transmit buffer. */
+#define EVT_TX_SPACE_BUS    (RTOS_EVT_EVENT_01)
+
+/** The event, which is mapped to the remote node. */
+#define EVT_PING            (RTOS_EVT_EVENT_02)
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_sender(uint16_t initCondition);
+static void taskT0C1_receiver(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE]
+             , _taskStackT0C1[STACK_SIZE];
+
+/** The time of sending the latest event in us. */
+static volatile uint32_t _tiSend = 0;
+
+/** The number of events received by the task of high priority. */
+static volatile uint16_t _noEvtsRx = 0;
+
+/** The minimum and maximum latency in us. */
+static volatile uint16_t _tiLatencyMin = UINT16_MAX
+                       , _tiLatencyMax = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The task of low priority. It regularly sends the event to the remote node and prints
+ * the results.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_sender(uint16_t initCondition)
+{
+    uint16_t noEvtsTx = 0;
+    uint8_t noCycles = 0;
+
+    do
+    {
+        /* The receiving task has the higher priority. It can't be resumed before the
+           frame has been received; the time is stored before the frame is sent. */
+        _tiSend = micros();
+        ebs_sendEvent(EVT_PING);
+        ++ noEvtsTx;
+
+        if(++noCycles >= NO_CYCLES_PER_PRINT)
+        {
+            noCycles = 0;
+
+            rtos_enterCriticalSection();
+            const uint16_t noEvtsRx = _noEvtsRx
+                         , tiLatencyMin = _tiLatencyMin
+                         , tiLatencyMax = _tiLatencyMax;
+            rtos_leaveCriticalSection();
+
+            ebs_diagnosis_t diagnosis;
+            ebs_getDiagnosis(&diagnosis);
+
+            printf( "Events sent: %u, received: %u, latency: %u..%u us\n"
+                  "Frames received: %u, forwarded: %u, corrupted: %u, lost: %u\n"
+                  , noEvtsTx, noEvtsRx
+                  , tiLatencyMin <= tiLatencyMax? tiLatencyMin: 0, tiLatencyMax
+                  , diagnosis.noFramesRx, diagnosis.noFramesForwarded
+                  , diagnosis.noFramesCorrupted, diagnosis.noFramesLost
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ TASK_PERIOD));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_sender */
+
+
+
+
+/**
+ * The task of high priority. It is resumed by the receive interrupt of the event bus and
+ * measures the latency.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_receiver(uint16_t initCondition)
+{
+    ASSERT(initCondition == EVT_PING);
+    do
+    {
+        /* The task of high priority can't be interrupted by the other task, no critical
+           section is needed. */
+        ++ _noEvtsRx;
+#if REMOTE_NODE_ID == OWN_NODE_ID
+        const uint32_t tiLatency = micros() - _tiSend;
+        const uint16_t tiLatency16 = tiLatency < UINT16_MAX? (uint16_t)tiLatency: UINT16_MAX;
+        if(tiLatency16 < _tiLatencyMin)
+            _tiLatencyMin = tiLatency16;
+        if(tiLatency16 > _tiLatencyMax)
+            _tiLatencyMax = tiLatency16;
+#endif
+    }
+    while(rtos_waitForEvent(EVT_PING, /* all */ false, /* timeout */ 0));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_receiver */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial driver and redirect stdout into it. */
+    init_stdout();
+    ser_init(/* baudRate */ 115200, /* evtTxSpace */ EVT_TX_SPACE_SERIAL);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    /* Start the event bus. The ping is accepted from the remote node and it is sent to
+       the remote node. */
+    ebs_initAfterPowerUp( OWN_NODE_ID
+                        , BAUD_RATE_BUS
+                        , /* evtAcceptMask */ EVT_PING
+                        , /* evtTxSpace */ EVT_TX_SPACE_BUS
+                        );
+    ebs_mapEvents(EVT_PING, REMOTE_NODE_ID);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure task 0 of priority class 0. The sender has the lower priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_sender
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     10
+                       );
+
+    /* Configure task 0 of priority class 1. The receiver has the higher priority. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_receiver
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   EVT_PING
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
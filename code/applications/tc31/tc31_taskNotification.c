@@ -0,0 +1,278 @@
+/**
+ * @file tc31_taskNotification.c
+ *   Test case 31 of RTuinOS. A producer task resumes a consumer task by direct
+ * notifications rather than by a global event, see rtos_notifyTask.\n
+ *   The producer is a regular task of priority class 0. Every 5 tics it notifies the
+ * consumer of a new sample. The consumer belongs to the higher priority class 1; it is
+ * resumed at once and it has counted the sample before the producer continues. The
+ * consumer waits with a timeout, which is longer than the period of the producer. Once in
+ * a while the producer pauses and the consumer sees exactly one timeout.\n
+ *   The idle task permanently posts another notification, which the consumer doesn't
+ * wait for. It is latched and taken by the consumer once per report without suspending.\n
+ *   The report shows the numbers of sent and received samples, which need to be
+ * identical, and the number of timeouts, which needs to be identical to the number of
+ * pauses of the producer.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_producer
+ *   taskT0C1_consumer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the producer task. */
+#define STACK_SIZE_PRODUCER     100
+
+/** Stack size of the consumer task, which prints the reports. */
+#define STACK_SIZE_CONSUMER     256
+
+/** The period of the producer in system timer tics. */
+#define PERIOD_PRODUCER         5
+
+/** The timeout of the consumer in system timer tics. It needs to be greater than the
+    period of the producer but less than the gap in the notifications, which is caused by a
+    pause of the producer. */
+#define TIMEOUT_CONSUMER        20
+
+/** The producer pauses for #DURATION_PAUSE tics once in #NO_CYCLES_PER_PAUSE cycles. */
+#define NO_CYCLES_PER_PAUSE     50
+
+/** The duration of a pause of the producer in system timer tics. */
+#define DURATION_PAUSE          30
+
+/** The number of received samples between two reports of the consumer. */
+#define NO_SAMPLES_PER_REPORT   200
+
+/** The notification of the consumer, which signals a new sample. */
+#define NTF_NEW_SAMPLE          0x0001u
+
+/** The notification of the consumer, which is permanently posted by the idle task. */
+#define NTF_IDLE                0x0002u
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_producer(uint16_t initCondition);
+static void taskT0C1_consumer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_PRODUCER]
+             , _taskStackT0C1[STACK_SIZE_CONSUMER];
+
+/** The number of samples, which have been notified by the producer. */
+static volatile uint16_t _noSamplesSent = 0;
+
+/** The number of samples, which have been received by the consumer. */
+static volatile uint16_t _noSamplesReceived = 0;
+
+/** The number of pauses of the producer. */
+static volatile uint16_t _noPauses = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The producer, a regular task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_producer(uint16_t initCondition)
+{
+    uint8_t cntCycles = 0;
+    do
+    {
+        ++ _noSamplesSent;
+        rtos_notifyTask(_idxTaskT0C1, NTF_NEW_SAMPLE);
+
+        /* The consumer has the higher priority. It has been activated by the notification
+           and it is suspended again when we get here. */
+        ASSERT(_noSamplesReceived == _noSamplesSent);
+
+        if(++cntCycles == NO_CYCLES_PER_PAUSE)
+        {
+            cntCycles = 0;
+            ++ _noPauses;
+            rtos_delay(DURATION_PAUSE);
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_PRODUCER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_producer */
+
+
+
+
+/**
+ * The consumer, an event task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_consumer(uint16_t initCondition)
+{
+    uint16_t noTimeouts = 0
+           , noIdleNotifications = 0
+           , cntSamples = 0;
+
+    for(;;)
+    {
+        const uintNotificationVec_t notificationVec =
+                        rtos_waitForNotification(NTF_NEW_SAMPLE, TIMEOUT_CONSUMER);
+        if(notificationVec == 0)
+        {
+            ++ noTimeouts;
+            continue;
+        }
+
+        /* The notification of the idle task is latched; it must not resume the task. */
+        ASSERT(notificationVec == NTF_NEW_SAMPLE);
+        ++ _noSamplesReceived;
+
+        if(++cntSamples == NO_SAMPLES_PER_REPORT)
+        {
+            cntSamples = 0;
+
+            /* The idle task has surely posted its notification since the last report. It is
+               taken without suspending the task. */
+            if(rtos_waitForNotification(NTF_IDLE, /* timeout */ 0) == NTF_IDLE)
+                ++ noIdleNotifications;
+
+            /* The producer is suspended; a critical section is not required. */
+            printf( "Samples sent: %u, received: %u, timeouts: %u (%u), idle"
+                    " notifications: %u\n"
+                  , _noSamplesSent, _noSamplesReceived
+                  , noTimeouts, _noPauses
+                  , noIdleNotifications
+                  );
+            printf( "Unused stack area of consumer task: %u of %u Byte\n"
+                  , rtos_getStackReserve(_idxTaskT0C1), STACK_SIZE_CONSUMER
+                  );
+        }
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_consumer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the producer task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_producer
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
+
+    /* Configure the consumer task of priority class 1. It starts before the producer and
+       will wait for the first notification. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_consumer
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.\n
+ *   The idle task permanently notifies the consumer. The consumer doesn't wait for this
+ * notification, it is only latched. The notification doesn't resume the consumer and
+ * doesn't switch the task.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    rtos_notifyTask(_idxTaskT0C1, NTF_IDLE);
+
+} /* End of loop */
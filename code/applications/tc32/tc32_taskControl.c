@@ -0,0 +1,294 @@
+/**
+ * @file tc32_taskControl.c
+ *   Test case 32 of RTuinOS. A supervisor task changes the priority of a worker task at
+ * runtime and parks and resumes it, see rtos_setTaskPriority, rtos_suspendTask and
+ * rtos_resumeTask.\n
+ *   The worker is a task of priority class 0. It is triggered by an event of the
+ * supervisor and it is anyway activated by a timeout. The supervisor belongs to class 1.
+ * It steps cyclically through a sequence of phases and double-checks the effect of each
+ * phase on the worker:\n
+ *   - The worker has the lower priority. The triggered worker doesn't run before the
+ * supervisor suspends\n
+ *   - The worker is raised to class 2. The triggered worker preempts the supervisor\n
+ *   - The waiting worker is parked. It doesn't run although its timeout elapses several
+ * times. The parked worker is raised to class 2 and resumed; it preempts the supervisor\n
+ *   - The worker parks itself. No task is due and the idle task runs. The worker is
+ * resumed in its normal class 0\n
+ *   The report shows the number of cycles of the supervisor and the number of activations
+ * of the worker.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_worker
+ *   taskT1C1_supervisor
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the worker task. */
+#define STACK_SIZE_WORKER       100
+
+/** Stack size of the supervisor task, which prints the reports. */
+#define STACK_SIZE_SUPERVISOR   256
+
+/** The worker is activated by its timeout at latest after this number of system timer
+    tics. */
+#define TIMEOUT_WORKER          3
+
+/** The duration of a phase of the supervisor in system timer tics. It is significantly
+    longer than the timeout of the worker. */
+#define DURATION_PHASE          10
+
+/** The number of cycles of the supervisor between two reports. */
+#define NO_CYCLES_PER_REPORT    50
+
+/** The event, which triggers the worker. */
+#define EVT_TRIGGER_WORKER      RTOS_EVT_EVENT_00
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_worker(uint16_t initCondition);
+static void taskT1C1_supervisor(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_WORKER]
+             , _taskStackT1C1[STACK_SIZE_SUPERVISOR];
+
+/** The number of activations of the worker. */
+static volatile uint16_t _noActivationsWorker = 0;
+
+/** The supervisor requests the worker to park itself. */
+static volatile boolean _doParkWorker = false;
+
+/** The number of times the worker has parked itself. */
+static volatile uint16_t _noSelfParks = 0;
+
+/** The number of calls of the idle task, while the worker has been parked. */
+static volatile uint16_t _noIdleCalls = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The worker, a task of priority class 0, which is triggered by the supervisor or by its
+ * timeout.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_worker(uint16_t initCondition)
+{
+    for(;;)
+    {
+        rtos_waitForEvent( EVT_TRIGGER_WORKER | RTOS_EVT_DELAY_TIMER
+                         , /* all */ false
+                         , /* timeout */ TIMEOUT_WORKER
+                         );
+        ++ _noActivationsWorker;
+
+        if(_doParkWorker)
+        {
+            _doParkWorker = false;
+            ++ _noSelfParks;
+
+            /* The function returns only after the supervisor has resumed this task. */
+            rtos_suspendTask(_idxTaskT0C0);
+        }
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_worker */
+
+
+
+
+/**
+ * The supervisor, a task of priority class 1, which controls the worker.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C1_supervisor(uint16_t initCondition)
+{
+    uint16_t noCycles = 0
+           , noActivations;
+
+    for(;;)
+    {
+        /* The worker has the lower priority. It is triggered but it doesn't run before we
+           suspend. */
+        noActivations = _noActivationsWorker;
+        rtos_sendEvent(EVT_TRIGGER_WORKER);
+        ASSERT(_noActivationsWorker == noActivations);
+        rtos_delay(DURATION_PHASE);
+
+        /* The worker is raised above the supervisor. It runs at once when triggered. */
+        rtos_setTaskPriority(_idxTaskT0C0, /* prioClass */ 2);
+        noActivations = _noActivationsWorker;
+        rtos_sendEvent(EVT_TRIGGER_WORKER);
+        ASSERT(_noActivationsWorker == noActivations+1);
+        rtos_setTaskPriority(_idxTaskT0C0, /* prioClass */ 0);
+        rtos_delay(DURATION_PHASE);
+
+        /* The worker is parked while it is waiting. Its timeout elapses but it is not
+           activated. */
+        rtos_suspendTask(_idxTaskT0C0);
+        noActivations = _noActivationsWorker;
+        rtos_delay(DURATION_PHASE);
+        ASSERT(_noActivationsWorker == noActivations);
+
+        /* The parked worker is raised above the supervisor. It runs at once when resumed,
+           it has already been released by its timeout. */
+        rtos_setTaskPriority(_idxTaskT0C0, /* prioClass */ 2);
+        rtos_resumeTask(_idxTaskT0C0);
+        ASSERT(_noActivationsWorker == noActivations+1);
+        rtos_setTaskPriority(_idxTaskT0C0, /* prioClass */ 0);
+        rtos_delay(DURATION_PHASE);
+
+        /* The worker parks itself in its next activation. No task is due then and the
+           idle task runs, until the worker is resumed in its normal class. */
+        _doParkWorker = true;
+        rtos_sendEvent(EVT_TRIGGER_WORKER);
+        noActivations = _noActivationsWorker;
+        _noIdleCalls = 0;
+        rtos_delay(DURATION_PHASE);
+        ASSERT(_noActivationsWorker == noActivations+1  &&  !_doParkWorker);
+        ASSERT(_noIdleCalls > 0);
+        rtos_resumeTask(_idxTaskT0C0);
+        ASSERT(_noActivationsWorker == noActivations+1);
+        rtos_delay(DURATION_PHASE);
+
+        if(++noCycles % NO_CYCLES_PER_REPORT == 0)
+        {
+            /* The worker has the lower priority; a critical section is not required. */
+            printf( "Cycles: %u, worker activations: %u, self parks: %u\n"
+                  , noCycles, _noActivationsWorker, _noSelfParks
+                  );
+            printf( "Unused stack area of supervisor task: %u of %u Byte\n"
+                  , rtos_getStackReserve(_idxTaskT1C1), STACK_SIZE_SUPERVISOR
+                  );
+        }
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT1C1_supervisor */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the worker task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_worker
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the supervisor task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C1
+                       , /* taskFunction */     taskT1C1_supervisor
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT1C1[0]
+                       , /* stackSize */        sizeof(_taskStackT1C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.\n
+ *   The idle task counts its calls; the supervisor double-checks that it runs while the
+ * worker has parked itself.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    ++ _noIdleCalls;
+
+} /* End of loop */
@@ -0,0 +1,468 @@
+/**
+ * @file tc33_readWriteLock.c
+ *   Test case 33 of RTuinOS. A configuration table is shared by three readers and one
+ * writer. It is protected by a reader-writer lock, see rwl_readWriteLock.h. A monitor task
+ * waits for updates of the table by means of a condition variable, see
+ * cnd_conditionVariable.h.\n
+ *   The readers of priority classes 0 and 1 hold the lock for several tics and overlap
+ * nearly all the time. Each reader double-checks that the table is consistent and that no
+ * writer is active. The maximum number of readers, which have held the lock at the same
+ * time, is recorded.\n
+ *   The writer belongs to class 2. It modifies the table in two steps with a pause in
+ * between. A reader, which had got the lock during the pause, would see an inconsistent
+ * table. Although there's always a reader holding the lock, the writer must not time out:
+ * The waiting writer takes precedence over new readers.\n
+ *   After each update, the writer increments the version of the table, which is protected
+ * by a mutex, and it broadcasts the condition variable. The monitor of class 1 waits for
+ * the condition and reports the number of updates and reads. The number of seen updates
+ * needs to be identical to the number of writes.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   reader
+ *   taskT0C0_reader
+ *   taskT1C0_reader
+ *   taskT2C1_reader
+ *   taskT3C1_monitor
+ *   taskT4C2_writer
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+#include "rwl_readWriteLock.h"
+#include "cnd_conditionVariable.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the readers and the writer. */
+#define STACK_SIZE_TASK         100
+
+/** Stack size of the monitor task, which prints the reports. */
+#define STACK_SIZE_MONITOR      256
+
+/** The number of system timer tics a reader holds the lock. */
+#define DURATION_READ           4
+
+/** The period of the writer in system timer tics. */
+#define PERIOD_WRITER           25
+
+/** The timeout of the writer in system timer tics. It is much longer than a reader holds
+    the lock but much shorter than the time, which is required to wait for a gap between
+    the overlapping readers. */
+#define TIMEOUT_WRITER          (3*DURATION_READ)
+
+/** The timeout of the readers in system timer tics. */
+#define TIMEOUT_READER          20
+
+/** The timeout of the monitor in system timer tics. It is longer than the period of the
+    writer. */
+#define TIMEOUT_MONITOR         (2*PERIOD_WRITER)
+
+/** The number of updates between two reports of the monitor. */
+#define NO_UPDATES_PER_REPORT   20
+
+/** The semaphore of the condition variable, which signals an update of the table. */
+#define EVT_SEMAPHORE_UPDATE    RTOS_EVT_SEMAPHORE_00
+
+/** The mutex, which protects the version of the table. */
+#define EVT_MUTEX_VERSION       RTOS_EVT_MUTEX_01
+
+/** The event, which resumes the waiting readers of the table. */
+#define EVT_READERS             RTOS_EVT_EVENT_02
+
+/** The event, which resumes the waiting writer of the table. */
+#define EVT_WRITERS             RTOS_EVT_EVENT_03
+
+/** The number of entries of the configuration table. */
+#define NO_TABLE_ENTRIES        4
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT1C0, _idxTaskT2C1, _idxTaskT3C1, _idxTaskT4C2, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_reader(uint16_t initCondition);
+static void taskT1C0_reader(uint16_t initCondition);
+static void taskT2C1_reader(uint16_t initCondition);
+static void taskT3C1_monitor(uint16_t initCondition);
+static void taskT4C2_writer(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_TASK]
+             , _taskStackT1C0[STACK_SIZE_TASK]
+             , _taskStackT2C1[STACK_SIZE_TASK]
+             , _taskStackT3C1[STACK_SIZE_MONITOR]
+             , _taskStackT4C2[STACK_SIZE_TASK];
+
+/** The semaphore of the condition variable. It is initialized by cnd_initConditionVariable. */
+uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS];
+
+/** The lock, which protects the configuration table. */
+static rwl_readWriteLock_t _lockTable;
+
+/** The configuration table. All entries have the same value if the table is consistent. */
+static volatile uint16_t _tableAry[NO_TABLE_ENTRIES];
+
+/** Flag, which is set while the writer modifies the table. */
+static volatile boolean _isWriting = false;
+
+/** The number of readers, which currently hold the lock. */
+static volatile uint8_t _noActiveReaders = 0;
+
+/** The maximum number of readers, which held the lock at the same time. */
+static volatile uint8_t _maxNoActiveReaders = 0;
+
+/** The number of completed reads per reader. */
+static volatile uint16_t _noReadsAry[3] = {0, 0, 0};
+
+/** The number of completed writes. */
+static volatile uint16_t _noWrites = 0;
+
+/** The number of timeouts of the writer. */
+static volatile uint16_t _noTimeoutsWriter = 0;
+
+/** The condition variable, which signals an update of the table. */
+static cnd_conditionVariable_t _condUpdate;
+
+/** The version of the table. It is protected by the mutex #EVT_MUTEX_VERSION. */
+static uint16_t _versionTable = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The common implementation of the readers. The reader repeatedly locks the table for
+ * some tics and checks its consistency.
+ *   @param idxReader
+ * The index of the reader, 0..2.
+ *   @param period
+ * The time between two reads in system timer tics.
+ */
+
+static void reader(uint8_t idxReader, uintTime_t period)
+{
+    for(;;)
+    {
+        if(rwl_lockRead(&_lockTable, TIMEOUT_READER))
+        {
+            /* Other readers may be active but not the writer. */
+            cli();
+            {
+                ASSERT(!_isWriting);
+                if(++_noActiveReaders > _maxNoActiveReaders)
+                    _maxNoActiveReaders = _noActiveReaders;
+            }
+            sei();
+
+            /* Keep the lock and let other readers overlap. */
+            rtos_delay(DURATION_READ);
+
+            uint8_t u;
+            for(u=1; u<NO_TABLE_ENTRIES; ++u)
+                ASSERT(_tableAry[u] == _tableAry[0]);
+
+            cli();
+            -- _noActiveReaders;
+            sei();
+            rwl_unlockRead(&_lockTable);
+            ++ _noReadsAry[idxReader];
+        }
+
+        rtos_delay(period);
+    }
+} /* End of reader */
+
+
+
+
+/**
+ * The first reader, a task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_reader(uint16_t initCondition)
+{
+    reader(/* idxReader */ 0, /* period */ 1);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_reader */
+
+
+
+
+/**
+ * The second reader, a task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT1C0_reader(uint16_t initCondition)
+{
+    reader(/* idxReader */ 1, /* period */ 2);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT1C0_reader */
+
+
+
+
+/**
+ * The third reader, a task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT2C1_reader(uint16_t initCondition)
+{
+    reader(/* idxReader */ 2, /* period */ 1);
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT2C1_reader */
+
+
+
+
+/**
+ * The monitor, a task of priority class 1, which waits for updates of the table.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT3C1_monitor(uint16_t initCondition)
+{
+    uint16_t versionSeen = 0
+           , noUpdatesSeen = 0
+           , noTimeouts = 0;
+
+    for(;;)
+    {
+        rtos_waitForEvent(EVT_MUTEX_VERSION, /* all */ false, /* timeout */ 0);
+        while(_versionTable == versionSeen)
+        {
+            if(!cnd_wait(&_condUpdate, EVT_MUTEX_VERSION, TIMEOUT_MONITOR))
+                ++ noTimeouts;
+        }
+
+        /* The writer updates the version once per write; no update is missed. */
+        ASSERT(_versionTable == versionSeen+1);
+        versionSeen = _versionTable;
+        rtos_sendEvent(EVT_MUTEX_VERSION);
+
+        if(++noUpdatesSeen % NO_UPDATES_PER_REPORT == 0)
+        {
+            printf( "Writes: %u, updates seen: %u, reads: %u, %u, %u\n"
+                  , _noWrites, noUpdatesSeen
+                  , _noReadsAry[0], _noReadsAry[1], _noReadsAry[2]
+                  );
+            printf( "Max. concurrent readers: %u, writer timeouts: %u, monitor timeouts: %u\n"
+                  , _maxNoActiveReaders, _noTimeoutsWriter, noTimeouts
+                  );
+            printf( "Unused stack area of monitor task: %u of %u Byte\n"
+                  , rtos_getStackReserve(_idxTaskT3C1), STACK_SIZE_MONITOR
+                  );
+        }
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT3C1_monitor */
+
+
+
+
+/**
+ * The writer, a task of priority class 2, which periodically updates the table.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT4C2_writer(uint16_t initCondition)
+{
+    do
+    {
+        if(rwl_lockWrite(&_lockTable, TIMEOUT_WRITER))
+        {
+            ASSERT(_noActiveReaders == 0);
+            _isWriting = true;
+
+            /* Modify the table in two steps. A reader, which could get the lock in
+               between, would see an inconsistent table. */
+            const uint16_t newValue = _tableAry[0] + 1;
+            uint8_t u;
+            for(u=0; u<NO_TABLE_ENTRIES/2; ++u)
+                _tableAry[u] = newValue;
+            rtos_delay(2);
+            for(; u<NO_TABLE_ENTRIES; ++u)
+                _tableAry[u] = newValue;
+
+            _isWriting = false;
+            rwl_unlockWrite(&_lockTable);
+            ++ _noWrites;
+
+            /* Notify the monitor about the update. */
+            rtos_waitForEvent(EVT_MUTEX_VERSION, /* all */ false, /* timeout */ 0);
+            ++ _versionTable;
+            cnd_broadcast(&_condUpdate);
+            rtos_sendEvent(EVT_MUTEX_VERSION);
+        }
+        else
+            ++ _noTimeoutsWriter;
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_WRITER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT4C2_writer */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    rwl_initReadWriteLock(&_lockTable, EVT_READERS, EVT_WRITERS);
+    cnd_initConditionVariable(&_condUpdate, EVT_SEMAPHORE_UPDATE);
+
+    /* Configure the readers. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_reader
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C0
+                       , /* taskFunction */     taskT1C0_reader
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT1C0[0]
+                       , /* stackSize */        sizeof(_taskStackT1C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT2C1
+                       , /* taskFunction */     taskT2C1_reader
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT2C1[0]
+                       , /* stackSize */        sizeof(_taskStackT2C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     2
+                       );
+
+    /* Configure the monitor. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT3C1
+                       , /* taskFunction */     taskT3C1_monitor
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT3C1[0]
+                       , /* stackSize */        sizeof(_taskStackT3C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the writer. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT4C2
+                       , /* taskFunction */     taskT4C2_writer
+                       , /* prioClass */        2
+                       , /* pStackArea */       &_taskStackT4C2[0]
+                       , /* stackSize */        sizeof(_taskStackT4C2)
+                       , /* startEventMask */   RTOS_EVT_ABSOLUTE_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     PERIOD_WRITER
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
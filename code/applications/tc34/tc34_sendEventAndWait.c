@@ -0,0 +1,321 @@
+/**
+ * @file tc34_sendEventAndWait.c
+ *   Test case 34 of RTuinOS. A client task and a server task play request and response
+ * by the combined kernel call rtos_sendEventAndWait.\n
+ *   The client is a regular task of priority class 0. Every 4 tics it posts a request to
+ * the server and waits for the response in one kernel call. The server belongs to the
+ * higher priority class 1. It is resumed by the request but it becomes active only after
+ * the client has been suspended; its response always reaches the client. The server, too,
+ * posts the response and waits for the next request in one kernel call.\n
+ *   Once in a while the client does the same by two separate calls of rtos_sendEvent and
+ * rtos_waitForEvent. Now the server becomes active already in the first call. Its
+ * response is lost since the client doesn't wait for it yet; the client sees a timeout.\n
+ *   Once in a while the client waits for a semaphore, which is available. The task is not
+ * suspended but still superseded by the server, which is resumed by the posted request.
+ * The client gets the semaphore when it becomes active again.\n
+ *   The report shows the numbers of requests and responses, which need to be identical,
+ * and the numbers of lost responses and acquired semaphores.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_client
+ *   taskT0C1_server
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the client task, which prints the reports. */
+#define STACK_SIZE_CLIENT       256
+
+/** Stack size of the server task. */
+#define STACK_SIZE_SERVER       100
+
+/** The period of the client in system timer tics. */
+#define PERIOD_CLIENT           4
+
+/** The timeout of the client, when waiting for a response, in system timer tics. It needs
+    to be less than the period of the client. */
+#define TIMEOUT_CLIENT          2
+
+/** The client uses the separate kernel calls once in #NO_CYCLES_PER_SEPARATE_CALLS
+    cycles. */
+#define NO_CYCLES_PER_SEPARATE_CALLS    10
+
+/** The client acquires the semaphore once in #NO_CYCLES_PER_SEPARATE_CALLS cycles, in the
+    middle between two separate calls. */
+#define IDX_CYCLE_SEMAPHORE     (NO_CYCLES_PER_SEPARATE_CALLS/2)
+
+/** The number of cycles of the client between two reports. */
+#define NO_CYCLES_PER_REPORT    125
+
+/** The semaphore, which the client acquires once in a while. */
+#define EVT_SEMAPHORE           RTOS_EVT_SEMAPHORE_00
+
+/** The event, which carries a request from the client to the server. */
+#define EVT_REQUEST             RTOS_EVT_EVENT_01
+
+/** The event, which carries the response from the server to the client. */
+#define EVT_RESPONSE            RTOS_EVT_EVENT_02
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_client(uint16_t initCondition);
+static void taskT0C1_server(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+/** The semaphore is initially available. */
+uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS] = {1};
+
+static uint8_t _taskStackT0C0[STACK_SIZE_CLIENT]
+             , _taskStackT0C1[STACK_SIZE_SERVER];
+
+/** The number of requests, which have been received by the server. */
+static volatile uint16_t _noRequests = 0;
+
+/** The number of requests, which the server received while the client held the
+    semaphore. */
+static volatile uint16_t _noRequestsWithSemaphore = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * The client, a regular task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_client(uint16_t initCondition)
+{
+    uint16_t noRequestsSent = 0
+           , noResponses = 0
+           , noLostResponses = 0
+           , noSemaphores = 0
+           , cntCycles = 0;
+    uint8_t idxCycle = 0;
+    uintEventVec_t gotEvtVec;
+
+    do
+    {
+        if(idxCycle == 0)
+        {
+            /* Post the request and wait for the response in two kernel calls. The server
+               has the higher priority, it is activated by the first call and it posts the
+               response before we wait for it. */
+            ++ noRequestsSent;
+            rtos_sendEvent(EVT_REQUEST);
+            ASSERT(_noRequests == noRequestsSent);
+            gotEvtVec = rtos_waitForEvent( EVT_RESPONSE | RTOS_EVT_DELAY_TIMER
+                                         , /* all */ false
+                                         , TIMEOUT_CLIENT
+                                         );
+            ASSERT(gotEvtVec == RTOS_EVT_DELAY_TIMER);
+            ++ noLostResponses;
+        }
+        else if(idxCycle == IDX_CYCLE_SEMAPHORE)
+        {
+            /* Post the request and take the available semaphore. The task doesn't need to
+               wait but the server supersedes it. */
+            ++ noRequestsSent;
+            gotEvtVec = rtos_sendEventAndWait( EVT_REQUEST
+                                             , EVT_SEMAPHORE
+                                             , /* all */ false
+                                             , /* timeout */ 0
+                                             );
+            ASSERT(gotEvtVec == EVT_SEMAPHORE  &&  _noRequests == noRequestsSent);
+            ++ noSemaphores;
+
+            /* Return the semaphore. No task waits for it, there's no task switch. */
+            rtos_sendEvent(EVT_SEMAPHORE);
+            ASSERT(rtos_semaphoreAry[0] == 1);
+        }
+        else
+        {
+            /* Post the request and wait for the response in a single kernel call. The
+               server is resumed but it becomes active only after this task is
+               suspended. */
+            ++ noRequestsSent;
+            gotEvtVec = rtos_sendEventAndWait( EVT_REQUEST
+                                             , EVT_RESPONSE | RTOS_EVT_DELAY_TIMER
+                                             , /* all */ false
+                                             , TIMEOUT_CLIENT
+                                             );
+            ASSERT(gotEvtVec == EVT_RESPONSE  &&  _noRequests == noRequestsSent);
+            ++ noResponses;
+        }
+
+        if(++idxCycle == NO_CYCLES_PER_SEPARATE_CALLS)
+            idxCycle = 0;
+
+        if(++cntCycles == NO_CYCLES_PER_REPORT)
+        {
+            cntCycles = 0;
+
+            /* The server is suspended; a critical section is not required. */
+            printf( "Requests sent: %u, received: %u, responses: %u, lost responses: %u,"
+                    " semaphores: %u (%u)\n"
+                  , noRequestsSent, _noRequests
+                  , noResponses, noLostResponses
+                  , noSemaphores, _noRequestsWithSemaphore
+                  );
+            printf( "Unused stack area of client task: %u of %u Byte\n"
+                  , rtos_getStackReserve(_idxTaskT0C0), STACK_SIZE_CLIENT
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_CLIENT));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_client */
+
+
+
+
+/**
+ * The server, an event task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due. This is the first
+ * request.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_server(uint16_t initCondition)
+{
+    uintEventVec_t gotEvtVec = initCondition;
+
+    for(;;)
+    {
+        ASSERT(gotEvtVec == EVT_REQUEST);
+        ++ _noRequests;
+
+        /* The server is active only if the client is suspended or superseded. If the client
+           took the semaphore then it is superseded inside the kernel call. */
+        if(rtos_semaphoreAry[0] == 0)
+            ++ _noRequestsWithSemaphore;
+
+        /* Respond and wait for the next request. There's no timeout. */
+        gotEvtVec = rtos_sendEventAndWait( EVT_RESPONSE
+                                         , EVT_REQUEST
+                                         , /* all */ false
+                                         , /* timeout */ 0
+                                         );
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_server */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the client task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_client
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     1
+                       );
+
+    /* Configure the server task of priority class 1. It is started by the first
+       request. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_server
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   EVT_REQUEST
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
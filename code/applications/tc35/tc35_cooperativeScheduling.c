@@ -0,0 +1,258 @@
+/**
+ * @file tc35_cooperativeScheduling.c
+ *   Test case 35 of RTuinOS. The kernel is configured for cooperative scheduling, see
+ * #RTOS_USE_COOPERATIVE_SCHEDULING. The system timer tic makes the tasks due, but the
+ * active task is not left before it calls the kernel.\n
+ *   A fast task of priority class 1 is resumed in every tic. A worker task of priority
+ * class 0 computes for more than a tic without calling the kernel; the fast task is due
+ * meanwhile but it doesn't become active. The worker then calls either rtos_yield or
+ * rtos_sendEvent with an event, which no task waits for. Both calls activate the fast task
+ * at once.\n
+ *   The report shows the number of cycles of the worker, each with a deferred activation
+ * of the fast task, and the total number of activations of the fast task.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   computeTillTic
+ *   taskT0C0_worker
+ *   taskT0C1_fast
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the worker task, which prints the reports. */
+#define STACK_SIZE_WORKER       256
+
+/** Stack size of the fast task. */
+#define STACK_SIZE_FAST         100
+
+/** The period of the worker in system timer tics. */
+#define PERIOD_WORKER           10
+
+/** The number of cycles of the worker between two reports. */
+#define NO_CYCLES_PER_REPORT    50
+
+/** An event, which no task waits for. */
+#define EVT_UNUSED              RTOS_EVT_EVENT_00
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_worker(uint16_t initCondition);
+static void taskT0C1_fast(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_WORKER]
+             , _taskStackT0C1[STACK_SIZE_FAST];
+
+/** The number of activations of the fast task. */
+static volatile uint16_t _noActivationsFast = 0;
+
+
+/*
+ * Function implementation
+ */
+
+
+/**
+ * Compute without calling the kernel until at least one system timer tic has been
+ * processed. The fast task is due when the function returns.
+ */
+
+static void computeTillTic(void)
+{
+    const uintTime_t tiStart = rtos_getTime();
+
+    /* The tic, which has been processed at call time, may already have made the fast task
+       due. Two tics are awaited to be sure that the fast task has been due for a while. */
+    while((uintTime_t)(rtos_getTime() - tiStart) < 2)
+        ;
+
+} /* End of computeTillTic */
+
+
+
+
+/**
+ * The worker, a regular task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_worker(uint16_t initCondition)
+{
+    uint16_t noCycles = 0
+           , cntCycles = 0;
+
+    do
+    {
+        /* The fast task has been active while this task was suspended. It waits for the
+           next tic. */
+        const uint16_t noActivationsBefore = _noActivationsFast;
+        computeTillTic();
+
+        /* The fast task is due but not active. */
+        ASSERT(_noActivationsFast == noActivationsBefore);
+
+        /* The next kernel call activates the fast task; it has the higher priority. It is
+           suspended again when we get here. */
+        if((noCycles & 1) == 0)
+            rtos_yield();
+        else
+            rtos_sendEvent(EVT_UNUSED);
+        ASSERT(_noActivationsFast == noActivationsBefore+1);
+
+        ++ noCycles;
+
+        if(++cntCycles == NO_CYCLES_PER_REPORT)
+        {
+            cntCycles = 0;
+
+            /* The fast task doesn't become active before we call the kernel; a critical
+               section is not required. */
+            printf( "Cycles of worker with deferred activation of fast task: %u, all"
+                    " activations of fast task: %u\n"
+                  , noCycles, _noActivationsFast
+                  );
+            printf( "Unused stack area of fast task: %u of %u Byte\n"
+                  , rtos_getStackReserve(_idxTaskT0C1), STACK_SIZE_FAST
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_WORKER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_worker */
+
+
+
+
+/**
+ * The fast task, which is resumed in every system timer tic. It belongs to priority
+ * class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_fast(uint16_t initCondition)
+{
+    for(;;)
+    {
+        ++ _noActivationsFast;
+        rtos_delay(1);
+    }
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_fast */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the worker task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_worker
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     5
+                       );
+
+    /* Configure the fast task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_fast
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. The kernel calls rtos_yield after each return from
+ * this function; this is where the idle task is left in cooperative mode.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,312 @@
+/**
+ * @file tc36_deferredProcedureCall.c
+ *   Test case 36 of RTuinOS. Two interrupt sources share a single task, which runs their
+ * bottom halves as deferred procedure calls, see dpc_deferredProcedureCall.c.\n
+ *   Timer 1 is configured to generate the compare match interrupts A and B with 1 kHz
+ * each, the one half a period after the other. Each interrupt queues the call of its own
+ * procedure with the number of the interrupt as argument. The DPC worker is the task of
+ * highest priority. It runs the procedures in the order of the interrupts; the
+ * procedures double-check that they are called alternatingly and with consecutive
+ * arguments. Every eighth call of procedure B takes more than a millisecond. Meanwhile,
+ * further interrupts queue calls, which are run by the worker without being suspended
+ * and resumed again.\n
+ *   A reporting task of low priority prints the numbers of interrupts and calls of both
+ * sources and the number of lost calls, which should be zero.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   ISR(TIMER1_COMPA_vect)
+ *   ISR(TIMER1_COMPB_vect)
+ *   setup
+ *   loop
+ * Local functions
+ *   procedureA
+ *   procedureB
+ *   taskT0C0_reporter
+ *   taskT0C1_dpcWorker
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "dpc_deferredProcedureCall.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the reporting task. */
+#define STACK_SIZE_REPORTER     256
+
+/** Stack size of the DPC worker. It holds the stack frames of all deferred procedures. */
+#define STACK_SIZE_DPC_WORKER   150
+
+/** The period of the reporting task in system timer tics, about a quarter of a second.
+    The system time of this application has 8 Bit; the period must not exceed 127 tics. */
+#define PERIOD_REPORTER         125
+
+/** The event, which resumes the DPC worker. */
+#define EVT_DPC_QUEUED          RTOS_EVT_EVENT_00
+
+/** The period of the interrupts in units of the timer clock of 2 MHz. */
+#define TIMER1_PERIOD           2000u
+
+/** The duration of the long calls of procedure B in Microseconds. */
+#define DURATION_LONG_CALL      1300u
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_reporter(uint16_t initCondition);
+static void taskT0C1_dpcWorker(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_REPORTER]
+             , _taskStackT0C1[STACK_SIZE_DPC_WORKER];
+
+/** The numbers of interrupts A and B. */
+static volatile uint16_t _noIrqsA = 0
+                       , _noIrqsB = 0;
+
+/** The numbers of calls of the procedures A and B. */
+static volatile uint16_t _noCallsA = 0
+                       , _noCallsB = 0;
+
+/** The procedure, which has been called last. Compare match B is the first interrupt
+    after the timer has been started. */
+static boolean _isLastCallA = true;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * The deferred procedure of compare match interrupt A.
+ *   @param noIrq
+ * The number of the interrupt, which has queued the call.
+ */
+
+static void procedureA(uint16_t noIrq)
+{
+    ASSERT(noIrq == (uint16_t)(_noCallsA+1)  &&  !_isLastCallA);
+    _isLastCallA = true;
+    ++ _noCallsA;
+
+} /* End of procedureA */
+
+
+
+
+/**
+ * The deferred procedure of compare match interrupt B. Every eighth call takes longer than
+ * a period of the interrupts.
+ *   @param noIrq
+ * The number of the interrupt, which has queued the call.
+ */
+
+static void procedureB(uint16_t noIrq)
+{
+    ASSERT(noIrq == (uint16_t)(_noCallsB+1)  &&  _isLastCallA);
+    _isLastCallA = false;
+    ++ _noCallsB;
+
+    /* The interrupts queue further calls meanwhile. */
+    if((noIrq & 7) == 0)
+        delayMicroseconds(DURATION_LONG_CALL);
+
+} /* End of procedureB */
+
+
+
+
+/**
+ * The compare match interrupt A of timer 1. The bottom half is deferred to the DPC
+ * worker.
+ */
+
+ISR(TIMER1_COMPA_vect)
+{
+    dpc_callFromISR(procedureA, ++_noIrqsA);
+
+    /* If the worker has been resumed, then the kernel switches to it now. */
+    rtos_leaveISR();
+
+} /* End of ISR(TIMER1_COMPA_vect) */
+
+
+
+
+/**
+ * The compare match interrupt B of timer 1. The bottom half is deferred to the DPC
+ * worker.
+ */
+
+ISR(TIMER1_COMPB_vect)
+{
+    dpc_callFromISR(procedureB, ++_noIrqsB);
+    rtos_leaveISR();
+
+} /* End of ISR(TIMER1_COMPB_vect) */
+
+
+
+
+/**
+ * The reporting task of priority class 0.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_reporter(uint16_t initCondition)
+{
+    do
+    {
+        /* The critical section inhibits the interrupts and the worker. */
+        rtos_enterCriticalSection();
+        const uint16_t noIrqsA = _noIrqsA
+                     , noIrqsB = _noIrqsB
+                     , noCallsA = _noCallsA
+                     , noCallsB = _noCallsB;
+        rtos_leaveCriticalSection();
+
+        printf( "Interrupts A: %u, B: %u, calls A: %u, B: %u, lost calls: %u\n"
+              , noIrqsA, noIrqsB, noCallsA, noCallsB, dpc_getNoLostCalls()
+              );
+        printf( "Unused stack area of DPC worker: %u of %u Byte\n"
+              , rtos_getStackReserve(_idxTaskT0C1), STACK_SIZE_DPC_WORKER
+              );
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_REPORTER));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_reporter */
+
+
+
+
+/**
+ * The DPC worker, a task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_dpcWorker(uint16_t initCondition)
+{
+    /* Restart timer 1, which has been configured in setup, and enable its interrupts.
+       Compare match B comes first. */
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A) | _BV(OCF1B);
+    TIMSK1 |= _BV(OCIE1A) | _BV(OCIE1B);
+
+    dpc_runWorkerTask(EVT_DPC_QUEUED);
+
+} /* End of taskT0C1_dpcWorker */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Timer 1 counts with 2 MHz in CTC mode; OCR1A determines the period. Compare match B
+       is reached in the middle of the period. The interrupts are enabled by the worker. */
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS11);
+    OCR1A = TIMER1_PERIOD-1;
+    OCR1B = TIMER1_PERIOD/2-1;
+
+    /* Configure the reporting task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_reporter
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     PERIOD_REPORTER
+                       );
+
+    /* Configure the DPC worker of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_dpcWorker
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,281 @@
+/**
+ * @file tc37_livenessMonitor.c
+ *   Test case 37 of RTuinOS. The kernel monitors the liveness of two tasks and it services
+ * the hardware watchdog as long as both tasks check in regularly, see
+ * #RTOS_USE_LIVENESS_MONITOR.\n
+ *   A healthy task of priority class 1 checks in every other tic. A second task of
+ * priority class 0 checks in every 10 tics for a few seconds. Then it gets stuck: It waits
+ * for an event, which is never posted. The kernel recognizes the missed check-in, it
+ * invokes the callback rtos_onLivenessFailure and it stops servicing the watchdog. The
+ * healthy task reports the failure and double-checks, that it has been recognized with the
+ * configured delay. A quarter of a second later, the watchdog resets the CPU. After the
+ * reset, setup() reports the failed task, which has been recorded by the kernel in the RAM
+ * not cleared by the C runtime. The test repeats.\n
+ *   The host simulation has no watchdog. The test continues with the stuck task and no
+ * further failure is reported.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   rtos_onLivenessFailure
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_stalling
+ *   taskT0C1_healthy
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the healthy task, which prints the reports. */
+#define STACK_SIZE_HEALTHY      256
+
+/** Stack size of the stalling task. */
+#define STACK_SIZE_STALLING     100
+
+/** The period of the healthy task in system timer tics. */
+#define PERIOD_HEALTHY          2
+
+/** The maximum time between two check-ins of the healthy task in system timer tics. */
+#define LIVENESS_PERIOD_HEALTHY 5
+
+/** The period of the stalling task in system timer tics. */
+#define PERIOD_STALLING         10
+
+/** The maximum time between two check-ins of the stalling task in system timer tics. */
+#define LIVENESS_PERIOD_STALLING 25
+
+/** The number of cycles of the stalling task before it gets stuck. */
+#define NO_CYCLES_TILL_STALL    150
+
+/** An event, which is never posted. */
+#define EVT_NEVER               RTOS_EVT_EVENT_00
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_stalling(uint16_t initCondition);
+static void taskT0C1_healthy(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_STALLING]
+             , _taskStackT0C1[STACK_SIZE_HEALTHY];
+
+/** The time of the last check-in of the stalling task. */
+static volatile uintTime_t _timeLastCheckInStalling = 0;
+
+/** The stalling task is stuck. */
+static volatile boolean _isStalled = false;
+
+/** Set by the callback of the kernel, when it recognized the missed check-in. */
+static volatile boolean _isLivenessFailure = false;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Callback of the kernel, which is invoked from the system timer tic if a task missed its
+ * check-in. Only the stalling task can fail.
+ *   @param idxTask
+ * The index of the task, which missed its check-in.
+ */
+
+void rtos_onLivenessFailure(uint8_t idxTask)
+{
+    ASSERT(idxTask == _idxTaskT0C0  &&  _isStalled  &&  !_isLivenessFailure);
+    _isLivenessFailure = true;
+
+} /* End of rtos_onLivenessFailure */
+
+
+
+
+/**
+ * The stalling task of priority class 0. It checks in regularly for a while and then it
+ * waits forever.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_stalling(uint16_t initCondition)
+{
+    uint16_t noCycles = 0;
+
+    do
+    {
+        _timeLastCheckInStalling = rtos_getTime();
+        rtos_checkInTask();
+
+        if(++noCycles == NO_CYCLES_TILL_STALL)
+        {
+            /* Get stuck like a task, which waits for a lost response. */
+            _isStalled = true;
+            rtos_waitForEvent(EVT_NEVER, /* all */ false, /* timeout */ 0);
+            ASSERT(false);
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_STALLING));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_stalling */
+
+
+
+
+/**
+ * The healthy task of priority class 1. It checks in in every cycle and it reports the
+ * liveness failure of the other task.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_healthy(uint16_t initCondition)
+{
+    boolean isFailureReported = false;
+
+    do
+    {
+        rtos_checkInTask();
+
+        if(_isLivenessFailure  &&  !isFailureReported)
+        {
+            /* The failure is recognized in the tic, in which the period since the last
+               check-in elapses. We see it at latest one cycle later. */
+            const uintTime_t tiDelay = rtos_getTime() - _timeLastCheckInStalling;
+            ASSERT(tiDelay >= LIVENESS_PERIOD_STALLING
+                   &&  tiDelay <= LIVENESS_PERIOD_STALLING+PERIOD_HEALTHY
+                  );
+            isFailureReported = true;
+            printf( "Task %u missed its check-in, recognized after %u tics. Waiting for"
+                    " the reset by the watchdog\n"
+                  , (unsigned)_idxTaskT0C0, (unsigned)tiDelay
+                  );
+        }
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_HEALTHY));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_healthy */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    /* Report the reason of the last reset. The record is deleted when it is read. */
+    uint8_t idxFailedTask;
+    if(rtos_getLivenessFailure(&idxFailedTask))
+    {
+        ASSERT(idxFailedTask == _idxTaskT0C0);
+        printf("Reset by the watchdog: Task %u missed its check-in\n", (unsigned)idxFailedTask);
+        ASSERT(!rtos_getLivenessFailure(&idxFailedTask));
+    }
+    else
+        printf("No liveness failure recorded\n");
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the stalling task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_stalling
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_setTaskLivenessPeriod(_idxTaskT0C0, LIVENESS_PERIOD_STALLING);
+
+    /* Configure the healthy task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_healthy
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_setTaskLivenessPeriod(_idxTaskT0C1, LIVENESS_PERIOD_HEALTHY);
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
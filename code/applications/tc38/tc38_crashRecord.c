@@ -0,0 +1,246 @@
+/**
+ * @file tc38_crashRecord.c
+ *   Test case 38 of RTuinOS. A failing assertion saves a crash record before it resets the
+ * CPU, see #RTOS_USE_CRASH_RECORD.\n
+ *   A task of priority class 0 writes an entry into the binary trace in every cycle. After
+ * a few seconds it lets an assertion fail. ASSERT saves the record and makes a reset. After
+ * the reset, setup() finds the record and double-checks its contents: The task index, the
+ * source file, the stack pointer, which needs to point into the stack area of the failing
+ * task, and the newest trace entries. The record is not deleted by setup(); the kernel
+ * writes it to the serial port when setup() returns. The failing task checks that the
+ * record has been deleted by then. The test repeats.\n
+ *   A second task of priority class 1 is regularly active; the assertion fails while it is
+ * suspended.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *   @remark
+ * The test case can't be run in the host simulation, where a failing assertion ends the
+ * process.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   taskT0C0_failing
+ *   taskT0C1_fast
+ */
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "trc_trace.h"
+#include "crr_crashRecord.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** Stack size of the failing task. */
+#define STACK_SIZE_FAILING      100
+
+/** Stack size of the fast task. */
+#define STACK_SIZE_FAST         100
+
+/** The period of the failing task in system timer tics. */
+#define PERIOD_FAILING          10
+
+/** The period of the fast task in system timer tics. */
+#define PERIOD_FAST             3
+
+/** The number of cycles of the failing task before the assertion fails. */
+#define NO_CYCLES_TILL_FAILURE  300
+
+/** The ID of the trace entries, which are written by the failing task. */
+#define TRC_ID_CYCLE            0x01
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. */
+enum {_idxTaskT0C0, _idxTaskT0C1, _noTasks};
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_failing(uint16_t initCondition);
+static void taskT0C1_fast(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_FAILING]
+             , _taskStackT0C1[STACK_SIZE_FAST];
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * The failing task of priority class 0. It traces its cycles and lets an assertion fail
+ * after a while.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C0_failing(uint16_t initCondition)
+{
+    /* The kernel has reported and deleted the record after return from setup(). */
+    crr_crashRecord_t record;
+    ASSERT(!crr_getCrashRecord(&record));
+
+    uint16_t noCycles = 0;
+    do
+    {
+        ++ noCycles;
+        trc_trace(TRC_ID_CYCLE, noCycles);
+
+        /* This is the assertion, which intentionally fails. */
+        ASSERT(noCycles < NO_CYCLES_TILL_FAILURE);
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_FAILING));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C0_failing */
+
+
+
+
+/**
+ * The fast task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C1_fast(uint16_t initCondition)
+{
+    do
+    {
+    }
+    while(rtos_suspendTaskTillTime(/* deltaTimeTillResume */ PERIOD_FAST));
+
+    /* A task function must never return; this would cause a reset. */
+    ASSERT(false);
+
+} /* End of taskT0C1_fast */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+
+    /* Double-check the record of the last reset. It is not deleted; the kernel reports it
+       after return from this function. */
+    crr_crashRecord_t record;
+    if(crr_getCrashRecord(&record))
+    {
+        const uint16_t spBottom = (uint16_t)(uintptr_t)&_taskStackT0C0[0];
+        ASSERT(record.idxTask == _idxTaskT0C0
+               &&  strcmp_P(__FILE__, record.fileName) == 0
+               &&  record.sp >= spBottom  &&  record.sp < spBottom+STACK_SIZE_FAILING
+               &&  record.noTraceEntries == CRR_NO_TRACE_ENTRIES
+              );
+
+        /* The newest trace entries have been written by the failing task in its last
+           cycles. */
+        uint8_t u;
+        for(u=0; u<CRR_NO_TRACE_ENTRIES; ++u)
+        {
+            const trc_entry_t * const pEntry = &record.traceEntryAry[u];
+            ASSERT(pEntry->idEvent == TRC_ID_CYCLE
+                   &&  pEntry->arg == NO_CYCLES_TILL_FAILURE-CRR_NO_TRACE_ENTRIES+1+u
+                  );
+        }
+        printf( "Reset by a failing assertion in line %u of task %u\n"
+              , record.line, (unsigned)record.idxTask
+              );
+    }
+    else
+        printf("No crash record found\n");
+
+    ASSERT(_noTasks == RTOS_NO_TASKS);
+
+    /* Configure the failing task of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_failing
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the fast task of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_fast
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. This routine is repeatedly called whenever
+ * there's some execution time left. It's interrupted by any other task when it becomes
+ * due.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+} /* End of loop */
@@ -0,0 +1,899 @@
+/**
+ * @file tc39_soakTest.c
+ *   Test case 39 of RTuinOS. A randomized soak test of the kernel. Other than test case 13,
+ * which executes a fixed sequence of steps, the tasks of this test case choose their
+ * actions from a pseudo random number generator. Over hours of operation, they produce
+ * mixes of events, contention on a mutex and a semaphore, queue traffic and timeouts,
+ * which can't be foreseen in a scripted test.\n
+ *   Four worker tasks belong to the priority classes 0 and 1, two tasks each. In every
+ * cycle, a worker randomly selects one of these actions:\n
+ *   - acquire the mutex with a random timeout, hold it for a while and release it\n
+ *   - acquire the semaphore, which manages #SEMAPHORE_NO_RESOURCES, in the same way\n
+ *   - wait for a broadcasted event with a random timeout\n
+ *   - broadcast the event\n
+ *   - write a burst of sequence numbers into a queue (worker 0) or read from the queue
+ *     with a random timeout (worker 1)\n
+ *   - post an event to the probe task and measure the latency of its activation (worker
+ *     0 only)\n
+ *   - delay for a random number of tics\n
+ * The mix of actions is configured by the weights #SOAK_WEIGHT_MUTEX and following. The
+ * random sequence is reproducible; it is selected by #SOAK_SEED, which can be defined on
+ * the command line of the compiler.\n
+ *   The kernel invariants are checked by assertion continuously: After each kernel call,
+ * the worker checks that it is the active task and that the returned events are
+ * consistent with the request. A timeout must not elapse early. The mutex has never more
+ * than one owner and the semaphore never more than #SEMAPHORE_NO_RESOURCES holders. The
+ * sum of held and available resources never exceeds the initial number. The consumer of
+ * the queue sees the sequence numbers without gaps. The stack reserve of all tasks is
+ * checked by the idle task.\n
+ *   The idle task reports every few seconds the sustained number of operations per second
+ * together with the counts of the different actions and the worst observed latencies:
+ * the time from posting an event to the activation of the task of highest priority in
+ * Microseconds and the longest time a worker waited for the mutex or the semaphore in
+ * system timer tics. The test is successful if it runs for hours without an assertion
+ * firing.
+ *   @remark: This application produces screen output at a terminal Baud rate higher then
+ * the standard setting. Switch the Baud rate in Arduino's Serial Monitor to 115200 Baud.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Module interface
+ *   setup
+ *   loop
+ * Local functions
+ *   getRandom
+ *   selectAction
+ *   checkActiveTask
+ *   checkWaitResult
+ *   acquireResource
+ *   doMutex
+ *   doSemaphore
+ *   doWaitForEvent
+ *   doQueue
+ *   doProbe
+ *   worker
+ *   taskT0C0_worker0
+ *   taskT1C0_worker1
+ *   taskT0C1_worker2
+ *   taskT1C1_worker3
+ *   taskT0C2_probe
+ */
+
+/* This test case makes no sense in PRODUCTION compilation as all results are checked by
+   assertion. */
+#ifndef DEBUG
+# error This test case needs to be compiled in DEBUG configuration only
+#endif
+
+
+/*
+ * Include files
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "rtos.h"
+#include "rtos_assert.h"
+#include "que_queue.h"
+#include "stdout.h"
+
+
+/*
+ * Defines
+ */
+
+/** The seed of the pseudo random number generators. Each seed produces another, but
+    reproducible mix of actions. It can be set on the command line of the compiler. */
+#ifndef SOAK_SEED
+# define SOAK_SEED              1
+#endif
+
+/** The relative frequencies of the actions of the workers. The sum of all weights must not
+    exceed 255. An action can be disabled by setting its weight to zero. */
+#define SOAK_WEIGHT_MUTEX       30
+#define SOAK_WEIGHT_SEMAPHORE   30
+#define SOAK_WEIGHT_WAIT_EVENT  20
+#define SOAK_WEIGHT_SEND_EVENT  20
+#define SOAK_WEIGHT_QUEUE       40
+#define SOAK_WEIGHT_PROBE       20
+#define SOAK_WEIGHT_DELAY       10
+
+/** The maximum timeout of a request in system timer tics. */
+#define MAX_TIMEOUT             8
+
+/** The maximum time a resource is held in system timer tics. */
+#define MAX_HOLD_TIME           3
+
+/** The maximum number of elements written to the queue in a burst. */
+#define MAX_BURST_SIZE          5
+
+/** The number of resources managed by the semaphore. */
+#define SEMAPHORE_NO_RESOURCES  2
+
+/** The capacity of the queue in elements. */
+#define QUEUE_SIZE              8
+
+/** The timeout of the probe task in system timer tics. It's checked when the probe hasn't
+    been posted for this time. */
+#define PROBE_TIMEOUT           50
+
+/** The period of the reports in Milliseconds. */
+#define REPORT_PERIOD_MS        5000ul
+
+/** The stack reserve, which each task needs to keep. */
+#define MIN_STACK_RESERVE       20
+
+/** Common stack size of the workers. */
+#define STACK_SIZE_WORKER       200
+
+/** Stack size of the probe task. */
+#define STACK_SIZE_PROBE        150
+
+/** The number of worker tasks. */
+#define NO_WORKERS              4
+
+/** The mutex, which is contended by all workers. */
+#define EVT_MUTEX               RTOS_EVT_MUTEX_01
+
+/** The semaphore, which is contended by all workers. */
+#define EVT_SEMAPHORE           RTOS_EVT_SEMAPHORE_00
+
+/** The event, which is broadcasted by the workers. */
+#define EVT_BROADCAST           RTOS_EVT_EVENT_02
+
+/** The event, which is posted by worker 0 to the probe task. */
+#define EVT_PROBE               RTOS_EVT_EVENT_03
+
+/** The event, which notifies the consumer of the queue. */
+#define EVT_QUEUE_DATA          RTOS_EVT_EVENT_04
+
+/** The index of a mutex owner, which indicates that the mutex is not owned. */
+#define NO_OWNER                0xff
+
+/** The indexes of the tasks are named to make index based API functions of RTuinOS safely
+    usable. The workers come first. */
+enum { _idxTaskT0C0
+     , _idxTaskT1C0
+     , _idxTaskT0C1
+     , _idxTaskT1C1
+     , _idxTaskT0C2
+     , _noTasks
+     };
+
+
+/*
+ * Local type definitions
+ */
+
+/** The actions of a worker. */
+typedef enum { actionMutex
+             , actionSemaphore
+             , actionWaitForEvent
+             , actionSendEvent
+             , actionQueue
+             , actionProbe
+             , actionDelay
+             , noActions
+             } action_t;
+
+
+/** The state of a worker. */
+typedef struct worker_t
+{
+    /** The state of the pseudo random number generator. */
+    uint16_t random;
+
+    /** The index of the task. */
+    uint8_t idxTask;
+
+    /** The number of operations per action. */
+    uint32_t noOpsAry[noActions];
+
+    /** The number of requests, which timed out. */
+    uint32_t noTimeouts;
+
+} worker_t;
+
+
+/*
+ * Local prototypes
+ */
+
+static void taskT0C0_worker0(uint16_t initCondition);
+static void taskT1C0_worker1(uint16_t initCondition);
+static void taskT0C1_worker2(uint16_t initCondition);
+static void taskT1C1_worker3(uint16_t initCondition);
+static void taskT0C2_probe(uint16_t initCondition);
+
+
+/*
+ * Data definitions
+ */
+
+static uint8_t _taskStackT0C0[STACK_SIZE_WORKER]
+             , _taskStackT1C0[STACK_SIZE_WORKER]
+             , _taskStackT0C1[STACK_SIZE_WORKER]
+             , _taskStackT1C1[STACK_SIZE_WORKER]
+             , _taskStackT0C2[STACK_SIZE_PROBE];
+
+/** The array of semaphores, which is declared extern in rtos.h. */
+uintSemaphore_t rtos_semaphoreAry[RTOS_NO_SEMAPHORE_EVENTS] = {SEMAPHORE_NO_RESOURCES};
+
+/** The relative frequencies of the actions in the order of action_t. */
+static const uint8_t _weightAry[noActions] PROGMEM =
+    { SOAK_WEIGHT_MUTEX
+    , SOAK_WEIGHT_SEMAPHORE
+    , SOAK_WEIGHT_WAIT_EVENT
+    , SOAK_WEIGHT_SEND_EVENT
+    , SOAK_WEIGHT_QUEUE
+    , SOAK_WEIGHT_PROBE
+    , SOAK_WEIGHT_DELAY
+    };
+
+/** The state of the workers. */
+static worker_t _workerAry[NO_WORKERS];
+
+/** The index of the task, which owns the mutex, or #NO_OWNER. */
+static volatile uint8_t _idxOwnerMutex = NO_OWNER;
+
+/** The number of tasks, which hold a resource of the semaphore. */
+static volatile uint8_t _noHoldersSemaphore = 0;
+
+/** The queue between worker 0 and worker 1. */
+static que_queue_t _queue;
+
+/** The ring buffer of the queue. */
+static uint16_t _queueBufAry[QUEUE_SIZE];
+
+/** The next sequence number to write into and to read from the queue, respectively. */
+static uint16_t _seqNoWrite = 0
+              , _seqNoRead = 0;
+
+/** The time, when the probe task has been posted, in Microseconds. */
+static volatile uint32_t _tiPostProbe;
+
+/** The worst observed latency of the probe task in Microseconds. */
+static volatile uint32_t _tiMaxLatencyProbe = 0;
+
+/** The number of activations of the probe task by its event. */
+static volatile uint32_t _noProbes = 0;
+
+/** The longest time a worker waited for the mutex and the semaphore, respectively, in
+    system timer tics. */
+static volatile uintTime_t _tiMaxWaitMutex = 0
+                         , _tiMaxWaitSemaphore = 0;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the next number of the pseudo random number generator of a worker. It's a xorshift
+ * generator with a cycle of 2^16-1.
+ *   @return
+ * Get the random number in the range 1..2^16-1.
+ *   @param pWorker
+ * The worker, which owns the generator.
+ */
+
+static uint16_t getRandom(worker_t *pWorker)
+{
+    uint16_t x = pWorker->random;
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    pWorker->random = x;
+    return x;
+
+} /* End of getRandom */
+
+
+
+
+/**
+ * Select the next action of a worker according to the configured weights.
+ *   @return
+ * Get the action.
+ *   @param pWorker
+ * The worker.
+ */
+
+static action_t selectAction(worker_t *pWorker)
+{
+    static const uint8_t sumOfWeights = SOAK_WEIGHT_MUTEX + SOAK_WEIGHT_SEMAPHORE
+                                        + SOAK_WEIGHT_WAIT_EVENT + SOAK_WEIGHT_SEND_EVENT
+                                        + SOAK_WEIGHT_QUEUE + SOAK_WEIGHT_PROBE
+                                        + SOAK_WEIGHT_DELAY;
+    uint8_t r = getRandom(pWorker) % sumOfWeights;
+    uint8_t action = 0;
+    uint8_t weight;
+    while(r >= (weight = pgm_read_byte(&_weightAry[action])))
+    {
+        r -= weight;
+        ++ action;
+    }
+    return (action_t)action;
+
+} /* End of selectAction */
+
+
+
+
+/**
+ * Double-check that the calling worker is the active task. It is called after each kernel
+ * call, which may have switched the context.
+ *   @param pWorker
+ * The worker.
+ */
+
+static inline void checkActiveTask(const worker_t *pWorker)
+{
+    ASSERT(rtos_getIdxActiveTask() == pWorker->idxTask);
+
+} /* End of checkActiveTask */
+
+
+
+
+/**
+ * Double-check the result of a call of rtos_waitForEvent, which waited for a single event
+ * with timeout.
+ *   @return
+ * Get true if the event has been received or false if the timeout elapsed.
+ *   @param pWorker
+ * The worker.
+ *   @param evt
+ * The requested event.
+ *   @param gotEvtVec
+ * The events returned by rtos_waitForEvent.
+ *   @param timeout
+ * The timeout of the request in tics.
+ *   @param tiWait
+ * The time the worker waited in tics.
+ */
+
+static boolean checkWaitResult( worker_t *pWorker
+                              , uintEventVec_t evt
+                              , uintEventVec_t gotEvtVec
+                              , uintTime_t timeout
+                              , uintTime_t tiWait
+                              )
+{
+    checkActiveTask(pWorker);
+
+    /* Either the event or the timer, not both and nothing else. */
+    ASSERT(gotEvtVec == evt  ||  gotEvtVec == RTOS_EVT_DELAY_TIMER);
+    if(gotEvtVec == RTOS_EVT_DELAY_TIMER)
+    {
+        /* A timeout of n tics elapses after n-1..n tics; it may be late due to tasks of
+           higher priority but never early. */
+        ASSERT(tiWait+1 >= timeout);
+        ++ pWorker->noTimeouts;
+        return false;
+    }
+    else
+        return true;
+
+} /* End of checkWaitResult */
+
+
+
+
+/**
+ * Request the mutex or the semaphore with a random timeout.
+ *   @return
+ * Get true if the resource has been acquired.
+ *   @param pWorker
+ * The worker.
+ *   @param evt
+ * The mutex or semaphore event.
+ *   @param pTiMaxWait
+ * The worst observed waiting time of the resource is updated.
+ */
+
+static boolean acquireResource( worker_t *pWorker
+                              , uintEventVec_t evt
+                              , volatile uintTime_t *pTiMaxWait
+                              )
+{
+    const uintTime_t timeout = 1 + getRandom(pWorker) % MAX_TIMEOUT;
+    const uintTime_t tiStart = rtos_getTime();
+    const uintEventVec_t gotEvtVec = rtos_waitForEvent( evt | RTOS_EVT_DELAY_TIMER
+                                                      , /* all */ false
+                                                      , timeout
+                                                      );
+    const uintTime_t tiWait = rtos_getTime() - tiStart;
+    if(!checkWaitResult(pWorker, evt, gotEvtVec, timeout, tiWait))
+        return false;
+
+    rtos_enterCriticalSection();
+    if(tiWait > *pTiMaxWait)
+        *pTiMaxWait = tiWait;
+    rtos_leaveCriticalSection();
+
+    return true;
+
+} /* End of acquireResource */
+
+
+
+
+/**
+ * Acquire the mutex, hold it for a while and release it.
+ *   @param pWorker
+ * The worker.
+ */
+
+static void doMutex(worker_t *pWorker)
+{
+    if(!acquireResource(pWorker, EVT_MUTEX, &_tiMaxWaitMutex))
+        return;
+
+    ASSERT(_idxOwnerMutex == NO_OWNER);
+    _idxOwnerMutex = pWorker->idxTask;
+
+    /* Hold the mutex, partly computing, partly suspended. Other workers, which request
+       the mutex meanwhile, need to wait. */
+    delayMicroseconds(getRandom(pWorker) % 500);
+    rtos_delay(getRandom(pWorker) % (MAX_HOLD_TIME+1));
+    checkActiveTask(pWorker);
+    ASSERT(_idxOwnerMutex == pWorker->idxTask);
+
+    _idxOwnerMutex = NO_OWNER;
+    rtos_sendEvent(EVT_MUTEX);
+    checkActiveTask(pWorker);
+
+} /* End of doMutex */
+
+
+
+
+/**
+ * Acquire a resource of the semaphore, hold it for a while and release it.
+ *   @param pWorker
+ * The worker.
+ */
+
+static void doSemaphore(worker_t *pWorker)
+{
+    if(!acquireResource(pWorker, EVT_SEMAPHORE, &_tiMaxWaitSemaphore))
+        return;
+
+    rtos_enterCriticalSection();
+    ASSERT(_noHoldersSemaphore < SEMAPHORE_NO_RESOURCES);
+    ++ _noHoldersSemaphore;
+    rtos_leaveCriticalSection();
+
+    delayMicroseconds(getRandom(pWorker) % 500);
+    rtos_delay(getRandom(pWorker) % (MAX_HOLD_TIME+1));
+    checkActiveTask(pWorker);
+
+    rtos_enterCriticalSection();
+    ASSERT(_noHoldersSemaphore > 0);
+    -- _noHoldersSemaphore;
+    rtos_leaveCriticalSection();
+
+    rtos_sendEvent(EVT_SEMAPHORE);
+    checkActiveTask(pWorker);
+
+} /* End of doSemaphore */
+
+
+
+
+/**
+ * Wait for the broadcasted event with a random timeout.
+ *   @param pWorker
+ * The worker.
+ */
+
+static void doWaitForEvent(worker_t *pWorker)
+{
+    const uintTime_t timeout = 1 + getRandom(pWorker) % MAX_TIMEOUT;
+    const uintTime_t tiStart = rtos_getTime();
+    const uintEventVec_t gotEvtVec = rtos_waitForEvent( EVT_BROADCAST | RTOS_EVT_DELAY_TIMER
+                                                      , /* all */ false
+                                                      , timeout
+                                                      );
+    checkWaitResult(pWorker, EVT_BROADCAST, gotEvtVec, timeout, rtos_getTime()-tiStart);
+
+} /* End of doWaitForEvent */
+
+
+
+
+/**
+ * Worker 0 writes a burst of sequence numbers into the queue; worker 1 reads from the
+ * queue with a random timeout and checks the sequence. The other workers only suspend
+ * for a tic.
+ *   @param pWorker
+ * The worker.
+ */
+
+static void doQueue(worker_t *pWorker)
+{
+    if(pWorker->idxTask == _idxTaskT0C0)
+    {
+        uint8_t noElems = 1 + getRandom(pWorker) % MAX_BURST_SIZE;
+        while(noElems-- > 0  &&  que_write(&_queue, &_seqNoWrite))
+            ++ _seqNoWrite;
+
+        que_signal(&_queue);
+        checkActiveTask(pWorker);
+    }
+    else if(pWorker->idxTask == _idxTaskT1C0)
+    {
+        const uintTime_t timeout = 1 + getRandom(pWorker) % MAX_TIMEOUT;
+        uint16_t seqNo;
+        if(que_readWait(&_queue, &seqNo, timeout))
+        {
+            ASSERT(seqNo == _seqNoRead);
+            ++ _seqNoRead;
+        }
+        else
+            ++ pWorker->noTimeouts;
+        checkActiveTask(pWorker);
+    }
+    else
+    {
+        rtos_delay(1);
+        checkActiveTask(pWorker);
+    }
+} /* End of doQueue */
+
+
+
+
+/**
+ * Worker 0 posts the event of the probe task, which preempts it at once. The probe
+ * measures the latency of its activation. The other workers only suspend for a tic.
+ *   @param pWorker
+ * The worker.
+ */
+
+static void doProbe(worker_t *pWorker)
+{
+    if(pWorker->idxTask == _idxTaskT0C0)
+    {
+        const uint32_t noProbesBefore = _noProbes;
+        _tiPostProbe = micros();
+        rtos_sendEvent(EVT_PROBE);
+
+        /* The probe has the highest priority; it has already been executed. */
+        ASSERT(_noProbes == noProbesBefore+1);
+    }
+    else
+        rtos_delay(1);
+
+    checkActiveTask(pWorker);
+
+} /* End of doProbe */
+
+
+
+
+/**
+ * The common task function of all workers.
+ *   @param idxTask
+ * The index of the worker task.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void worker(uint8_t idxTask)
+{
+    worker_t * const pWorker = &_workerAry[idxTask];
+    pWorker->idxTask = idxTask;
+
+    /* The generator must not be seeded with zero. */
+    pWorker->random = (uint16_t)(SOAK_SEED*NO_WORKERS + idxTask) | 0x8000u;
+
+    for(;;)
+    {
+        const action_t action = selectAction(pWorker);
+        switch(action)
+        {
+        case actionMutex:
+            doMutex(pWorker);
+            break;
+
+        case actionSemaphore:
+            doSemaphore(pWorker);
+            break;
+
+        case actionWaitForEvent:
+            doWaitForEvent(pWorker);
+            break;
+
+        case actionSendEvent:
+            rtos_sendEvent(EVT_BROADCAST);
+            checkActiveTask(pWorker);
+            break;
+
+        case actionQueue:
+            doQueue(pWorker);
+            break;
+
+        case actionProbe:
+            doProbe(pWorker);
+            break;
+
+        default:
+            ASSERT(action == actionDelay);
+            rtos_delay(getRandom(pWorker) % MAX_TIMEOUT);
+            checkActiveTask(pWorker);
+        }
+
+        rtos_enterCriticalSection();
+        ++ pWorker->noOpsAry[action];
+        rtos_leaveCriticalSection();
+    }
+} /* End of worker */
+
+
+
+
+/**
+ * Worker 0, a task of priority class 0. It is the producer of the queue and it posts the
+ * probe.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ */
+
+static void taskT0C0_worker0(uint16_t initCondition)
+{
+    worker(_idxTaskT0C0);
+
+} /* End of taskT0C0_worker0 */
+
+
+
+
+/**
+ * Worker 1, a task of priority class 0. It is the consumer of the queue.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ */
+
+static void taskT1C0_worker1(uint16_t initCondition)
+{
+    worker(_idxTaskT1C0);
+
+} /* End of taskT1C0_worker1 */
+
+
+
+
+/**
+ * Worker 2, a task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ */
+
+static void taskT0C1_worker2(uint16_t initCondition)
+{
+    worker(_idxTaskT0C1);
+
+} /* End of taskT0C1_worker2 */
+
+
+
+
+/**
+ * Worker 3, a task of priority class 1.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ */
+
+static void taskT1C1_worker3(uint16_t initCondition)
+{
+    worker(_idxTaskT1C1);
+
+} /* End of taskT1C1_worker3 */
+
+
+
+
+/**
+ * The probe task of priority class 2. It waits for its event and measures the latency of
+ * its activation.
+ *   @param initCondition
+ * The task gets the vector of events, which made it initially due.
+ *   @remark
+ * A task function must never return; this would cause a reset.
+ */
+
+static void taskT0C2_probe(uint16_t initCondition)
+{
+    for(;;)
+    {
+        const uintEventVec_t gotEvtVec = rtos_waitForEvent( EVT_PROBE | RTOS_EVT_DELAY_TIMER
+                                                          , /* all */ false
+                                                          , PROBE_TIMEOUT
+                                                          );
+        ASSERT(rtos_getIdxActiveTask() == _idxTaskT0C2);
+        if(gotEvtVec == EVT_PROBE)
+        {
+            /* This task has the highest priority and it is not preempted. A critical
+               section is not required. */
+            const uint32_t tiLatency = micros() - _tiPostProbe;
+            if(tiLatency > _tiMaxLatencyProbe)
+                _tiMaxLatencyProbe = tiLatency;
+            ++ _noProbes;
+        }
+        else
+            ASSERT(gotEvtVec == RTOS_EVT_DELAY_TIMER);
+    }
+} /* End of taskT0C2_probe */
+
+
+
+
+/**
+ * The initialization of the RTOS tasks and general board initialization.
+ */
+
+void setup(void)
+{
+    /* Start serial port and redirect stdout into Serial. */
+    init_stdout();
+    Serial.begin(115200);
+
+    puts_progmem(rtos_rtuinosStartupMsg);
+    printf("Soak test with seed %u\n", (unsigned)SOAK_SEED);
+
+    ASSERT(_noTasks == RTOS_NO_TASKS  &&  NO_WORKERS == _idxTaskT0C2);
+
+    que_initQueue( &_queue
+                 , _queueBufAry
+                 , /* sizeOfElem */ sizeof(_queueBufAry[0])
+                 , /* maxNoElems */ QUEUE_SIZE
+                 , EVT_QUEUE_DATA
+                 );
+
+    /* Configure the workers of priority class 0. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C0
+                       , /* taskFunction */     taskT0C0_worker0
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT0C0[0]
+                       , /* stackSize */        sizeof(_taskStackT0C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C0
+                       , /* taskFunction */     taskT1C0_worker1
+                       , /* prioClass */        0
+                       , /* pStackArea */       &_taskStackT1C0[0]
+                       , /* stackSize */        sizeof(_taskStackT1C0)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the workers of priority class 1. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C1
+                       , /* taskFunction */     taskT0C1_worker2
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT0C1[0]
+                       , /* stackSize */        sizeof(_taskStackT0C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+    rtos_initializeTask( /* idxTask */          _idxTaskT1C1
+                       , /* taskFunction */     taskT1C1_worker3
+                       , /* prioClass */        1
+                       , /* pStackArea */       &_taskStackT1C1[0]
+                       , /* stackSize */        sizeof(_taskStackT1C1)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+
+    /* Configure the probe task of priority class 2. */
+    rtos_initializeTask( /* idxTask */          _idxTaskT0C2
+                       , /* taskFunction */     taskT0C2_probe
+                       , /* prioClass */        2
+                       , /* pStackArea */       &_taskStackT0C2[0]
+                       , /* stackSize */        sizeof(_taskStackT0C2)
+                       , /* startEventMask */   RTOS_EVT_DELAY_TIMER
+                       , /* startByAllEvents */ false
+                       , /* startTimeout */     0
+                       );
+} /* End of setup */
+
+
+
+
+/**
+ * The application owned part of the idle task. It checks the balance of the resources and
+ * the stack reserves and it regularly reports the throughput and the worst observed
+ * latencies.
+ *   @remark
+ * Different to all other tasks, the idle task routine may and should return. (The task as
+ * such doesn't terminate). This has been designed in accordance with the meaning of the
+ * original Arduino loop function.
+ */
+
+void loop(void)
+{
+    static uint32_t tiLastReport_ = 0
+                  , noOpsLast_ = 0;
+
+    /* The held and the available resources never exceed the initial number. A resource is
+       counted neither held nor available while it is being handed over. */
+    rtos_enterCriticalSection();
+    ASSERT(rtos_semaphoreAry[0] + _noHoldersSemaphore <= SEMAPHORE_NO_RESOURCES);
+    rtos_leaveCriticalSection();
+
+    const uint32_t tiNow = millis();
+    if(tiNow - tiLastReport_ < REPORT_PERIOD_MS)
+        return;
+
+    uint8_t idxTask;
+    for(idxTask=0; idxTask<RTOS_NO_TASKS; ++idxTask)
+        ASSERT(rtos_getStackReserve(idxTask) >= MIN_STACK_RESERVE);
+
+    /* Take a consistent snapshot of the counters. */
+    uint32_t noOpsAry[noActions]
+           , noTimeouts = 0
+           , tiMaxLatencyProbe;
+    uintTime_t tiMaxWaitMutex, tiMaxWaitSemaphore;
+    uint8_t action;
+    for(action=0; action<noActions; ++action)
+        noOpsAry[action] = 0;
+    rtos_enterCriticalSection();
+    {
+        uint8_t idxWorker;
+        for(idxWorker=0; idxWorker<NO_WORKERS; ++idxWorker)
+        {
+            const worker_t * const pWorker = &_workerAry[idxWorker];
+            for(action=0; action<noActions; ++action)
+                noOpsAry[action] += pWorker->noOpsAry[action];
+            noTimeouts += pWorker->noTimeouts;
+        }
+        tiMaxLatencyProbe = _tiMaxLatencyProbe;
+        tiMaxWaitMutex = _tiMaxWaitMutex;
+        tiMaxWaitSemaphore = _tiMaxWaitSemaphore;
+    }
+    rtos_leaveCriticalSection();
+
+    uint32_t noOps = 0;
+    for(action=0; action<noActions; ++action)
+        noOps += noOpsAry[action];
+
+    printf( "%lu s: %lu operations/s\n"
+            "  mutex: %lu, semaphore: %lu, wait: %lu, send: %lu, queue: %lu, probe: %lu,"
+            " delay: %lu, timeouts: %lu\n"
+            "  worst latency of probe: %lu us, worst wait for mutex: %u tics,"
+            " for semaphore: %u tics\n"
+          , (unsigned long)(tiNow/1000)
+          , (unsigned long)((noOps - noOpsLast_)*1000ul / (tiNow - tiLastReport_))
+          , (unsigned long)noOpsAry[actionMutex], (unsigned long)noOpsAry[actionSemaphore]
+          , (unsigned long)noOpsAry[actionWaitForEvent]
+          , (unsigned long)noOpsAry[actionSendEvent], (unsigned long)noOpsAry[actionQueue]
+          , (unsigned long)noOpsAry[actionProbe], (unsigned long)noOpsAry[actionDelay]
+          , (unsigned long)noTimeouts
+          , (unsigned long)tiMaxLatencyProbe
+          , (unsigned)tiMaxWaitMutex, (unsigned)tiMaxWaitSemaphore
+          );
+
+    tiLastReport_ = tiNow;
+    noOpsLast_ = noOps;
+
+} /* End of loop */
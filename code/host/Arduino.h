@@ -0,0 +1,219 @@
+#ifndef HST_ARDUINO_INCLUDED
+#define HST_ARDUINO_INCLUDED
+/**
+ * @file Arduino.h
+ * Definition of global interface of module hst_arduino.c, which emulates the subset of
+ * the Arduino core library, which is used by RTuinOS and its test cases, on the host
+ * machine. The header replaces the original Arduino.h in the host simulation build, see
+ * target simulate of the makefile.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Include files
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef RTOS_HOST_SIMULATION
+# error This header file must be used only in the host simulation of RTuinOS
+#endif
+
+
+/*
+ * Defines
+ */
+
+#define HIGH    0x1
+#define LOW     0x0
+
+#define INPUT   0x0
+#define OUTPUT  0x1
+
+#define DEC     10
+#define HEX     16
+#define OCT     8
+#define BIN     2
+
+/** All data is located in the RAM of the host. The access to the program memory is
+    replaced by normal memory access. */
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define F(s)                    (s)
+#define pgm_read_byte(p)        (*(const uint8_t*)(p))
+#define pgm_read_byte_near(p)   pgm_read_byte(p)
+#define pgm_read_word(p)        (*(const uint16_t*)(p))
+#define pgm_read_dword(p)       (*(const uint32_t*)(p))
+#define memcpy_P                memcpy
+#define strcpy_P                strcpy
+#define strlen_P                strlen
+#define printf_P                printf
+
+#define _BV(bit)                (1 << (bit))
+
+/** The overflow interrupt of timer 2 is emulated by a periodic signal of the host. Its
+    enable bit is the only bit of the timer interrupt mask register, which is modeled. */
+#define TOIE2                   0
+
+/** The service routine of an interrupt is an ordinary function, which is called from the
+    handler of the emulating host signal. The flags of the AVR attribute ISR_NAKED, are
+    ignored. */
+#define ISR(vector, ...)        void vector(void)
+
+/** The name of the function, which implements the service routine of the timer 2 overflow
+    interrupt. */
+#define TIMER2_OVF_vect         hst_isrTimer2Ovf
+
+
+/*
+ * Global type definitions
+ */
+
+/** The Arduino data types. */
+typedef uint8_t boolean;
+typedef uint8_t byte;
+
+/** The emulated timer interrupt mask register of timer 2. Setting bit #TOIE2 enables the
+    system timer interrupt. If the interrupt became pending while it was disabled, it is
+    served as soon as it is enabled again - like the overflow flag of the AVR timer would
+    do. */
+class hst_timerInterruptMaskRegister_t
+{
+public:
+    /** Read the register. */
+    operator uint8_t() const
+        {return _value;}
+
+    /** Write the register. */
+    hst_timerInterruptMaskRegister_t &operator =(uint8_t value);
+
+    /** Set bits in the register. */
+    hst_timerInterruptMaskRegister_t &operator |=(uint8_t bitMask)
+        {return *this = _value | bitMask;}
+
+    /** Clear bits in the register. */
+    hst_timerInterruptMaskRegister_t &operator &=(uint8_t bitMask)
+        {return *this = _value & bitMask;}
+
+private:
+    /** The register contents. */
+    volatile uint8_t _value;
+};
+
+
+/** The emulation of Arduino's Serial. The output is written into the standard output
+    stream of the host process and it is not throttled by the Baud rate. There's no
+    input. */
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baudRate)
+        {}
+    void end(void)
+        {}
+    int available(void)
+        {return 0;}
+    int peek(void)
+        {return -1;}
+    int read(void)
+        {return -1;}
+    void flush(void);
+
+    size_t write(uint8_t c);
+    size_t write(const char *str);
+    size_t write(const uint8_t *buffer, size_t size);
+
+    size_t print(const char str[]);
+    size_t print(char c);
+    size_t print(unsigned char n, int base=DEC);
+    size_t print(int n, int base=DEC);
+    size_t print(unsigned int n, int base=DEC);
+    size_t print(long n, int base=DEC);
+    size_t print(unsigned long n, int base=DEC);
+    size_t print(double number, int digits=2);
+
+    size_t println(const char str[]);
+    size_t println(char c);
+    size_t println(unsigned char n, int base=DEC);
+    size_t println(int n, int base=DEC);
+    size_t println(unsigned int n, int base=DEC);
+    size_t println(long n, int base=DEC);
+    size_t println(unsigned long n, int base=DEC);
+    size_t println(double number, int digits=2);
+    size_t println(void);
+
+private:
+    size_t printNumber(unsigned long n, uint8_t base);
+};
+
+
+/*
+ * Global data declarations
+ */
+
+/** The emulated timer interrupt mask register of timer 2. */
+extern hst_timerInterruptMaskRegister_t TIMSK2;
+
+/** The emulated serial port. */
+extern HardwareSerial Serial;
+
+
+/*
+ * Global prototypes
+ */
+
+/** Initialize the emulation. Called once at the beginning of main. */
+void init(void);
+
+/** Disable the interrupts globally. */
+void cli(void);
+
+/** Enable the interrupts globally. */
+void sei(void);
+
+/** Get the world time in milliseconds. */
+unsigned long millis(void);
+
+/** Get the world time in microseconds. */
+unsigned long micros(void);
+
+/** Busy wait for a number of milliseconds. */
+void delay(unsigned long ms);
+
+/** Busy wait for a number of microseconds. */
+void delayMicroseconds(unsigned int us);
+
+/** There are no pins on the host. The functions have no effect. */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+/** The service routine of the system timer interrupt. It is implemented by the RTuinOS
+    kernel. */
+void hst_isrTimer2Ovf(void);
+
+/** The Arduino application interface. */
+void setup(void);
+void loop(void);
+
+
+#endif  /* HST_ARDUINO_INCLUDED */
@@ -0,0 +1,574 @@
+/**
+ * @file hst_arduino.c
+ *   Emulation of the Arduino core library for the host simulation of RTuinOS. The
+ * RTuinOS kernel and an application can be compiled for and run on a Linux machine. This
+ * permits fast regression tests of the scheduler without flashing a board, see target
+ * simulate of the makefile.\n
+ *   The overflow interrupt of timer 2, which clocks the system time of RTuinOS, is
+ * emulated by the periodic signal SIGALRM of the host process. Disabling the interrupts
+ * globally means blocking this signal. The kernel switches the tasks by means of the
+ * ucontext functions of the host, see rtos.c.\n
+ *   The world time, as returned by millis and micros, is derived from the monotonic clock
+ * of the host. Two environment variables control the simulation:\n
+ *   RTUINOS_SIMULATION_DURATION: If set, the process ends with exit code 0 after the given
+ * number of seconds of simulated world time. By default, the simulation runs forever.\n
+ *   RTUINOS_SIMULATION_SPEEDUP: An integer factor in the range 1..100, by which the world
+ * time of the simulation runs faster than the real time. The system timer tic and the time
+ * functions millis and micros are scaled accordingly. The default is 1.
+ *   @remark
+ * The simulation is not cycle accurate. The scheduling decisions are those of the real
+ * kernel, but the execution times of the task code are those of the host. The output of
+ * a test case may differ from the output on the target if it depends on execution times.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   init
+ *   cli
+ *   sei
+ *   millis
+ *   micros
+ *   delay
+ *   delayMicroseconds
+ *   pinMode
+ *   digitalWrite
+ *   digitalRead
+ *   hst_timerInterruptMaskRegister_t::operator =
+ *   HardwareSerial::flush
+ *   HardwareSerial::write
+ *   HardwareSerial::print
+ *   HardwareSerial::println
+ * Local functions
+ *   getSimulatedTime
+ *   onTimerSignal
+ *   HardwareSerial::printNumber
+ */
+
+/*
+ * Include files
+ */
+
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "Arduino.h"
+
+
+/*
+ * Defines
+ */
+
+/** The period time of the overflow interrupt of timer 2 in microseconds. Arduino
+    configures the timer to run at 16e6Hz/64/510 = 490.1961 Hz. */
+#define TI_PERIOD_TIMER_2_US    2040
+
+/** The maximum speedup of the simulation. The faster the system timer tic the more of the
+    host CPU time is consumed by the signal handling. */
+#define MAX_SPEEDUP             100
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The emulated timer interrupt mask register of timer 2. */
+hst_timerInterruptMaskRegister_t TIMSK2;
+
+/** The emulated serial port. */
+HardwareSerial Serial;
+
+/** The time of the host at start of the simulation. */
+static struct timespec _tiStart;
+
+/** The factor, by which the simulation runs faster than the real time. */
+static unsigned int _speedup = 1;
+
+/** The end of the simulation in microseconds of simulated world time or 0 if the
+    simulation runs forever. */
+static uint64_t _tiEndOfSimulation = 0;
+
+/** The emulated overflow flag of timer 2: The timer signal was received while the
+    interrupt was disabled. */
+static volatile boolean _isTimer2OvfPending = false;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Get the simulated world time.
+ *   @return
+ * Get the time since start of the simulation in microseconds.
+ */
+
+static uint64_t getSimulatedTime(void)
+{
+    struct timespec tiNow;
+    clock_gettime(CLOCK_MONOTONIC, &tiNow);
+
+    const int64_t tiElapsed = (int64_t)(tiNow.tv_sec - _tiStart.tv_sec) * 1000000
+                              + (tiNow.tv_nsec - _tiStart.tv_nsec) / 1000;
+    return (uint64_t)tiElapsed * _speedup;
+
+} /* End of getSimulatedTime */
+
+
+
+
+/**
+ * The handler of the periodic signal, which emulates the overflow of timer 2. It calls
+ * the interrupt service routine if the interrupt is enabled or sets the overflow flag
+ * otherwise. The signal is blocked while the handler executes, which corresponds to the
+ * reset global interrupt flag of the AVR in a service routine.
+ *   @param signal
+ * The signal, always SIGALRM.
+ */
+
+static void onTimerSignal(int signal)
+{
+    if(_tiEndOfSimulation > 0  &&  getSimulatedTime() >= _tiEndOfSimulation)
+    {
+        fflush(stdout);
+        _exit(EXIT_SUCCESS);
+    }
+
+    if((TIMSK2 & _BV(TOIE2)) != 0)
+    {
+        _isTimer2OvfPending = false;
+        hst_isrTimer2Ovf();
+    }
+    else
+        _isTimer2OvfPending = true;
+
+} /* End of onTimerSignal */
+
+
+
+
+/**
+ * Initialize the emulation. The timer signal is started; the interrupt is however still
+ * disabled.
+ */
+
+void init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &_tiStart);
+
+    const char *envVar = getenv("RTUINOS_SIMULATION_SPEEDUP");
+    if(envVar != NULL)
+    {
+        const int speedup = atoi(envVar);
+        if(speedup >= 1  &&  speedup <= MAX_SPEEDUP)
+            _speedup = (unsigned int)speedup;
+    }
+    envVar = getenv("RTUINOS_SIMULATION_DURATION");
+    if(envVar != NULL)
+        _tiEndOfSimulation = (uint64_t)(atof(envVar) * 1e6);
+
+    /* The output of the test cases is inspected line by line, even if it is redirected. */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onTimerSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = TI_PERIOD_TIMER_2_US / _speedup;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+} /* End of init */
+
+
+
+
+/**
+ * Disable all interrupts globally. The timer signal is blocked.
+ */
+
+void cli(void)
+{
+    sigset_t signalSet;
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGALRM);
+    sigprocmask(SIG_BLOCK, &signalSet, NULL);
+
+} /* End of cli */
+
+
+
+
+/**
+ * Enable all interrupts globally. A timer signal, which was received while blocked, is
+ * delivered immediately.
+ */
+
+void sei(void)
+{
+    sigset_t signalSet;
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGALRM);
+    sigprocmask(SIG_UNBLOCK, &signalSet, NULL);
+
+} /* End of sei */
+
+
+
+
+/**
+ * Get the world time in milliseconds. Like on the AVR, the 32 Bit value wraps around
+ * after about 50 days.
+ */
+
+unsigned long millis(void)
+{
+    return (uint32_t)(getSimulatedTime() / 1000);
+
+} /* End of millis */
+
+
+
+
+/**
+ * Get the world time in microseconds. Like on the AVR, the 32 Bit value wraps around
+ * after about 70 minutes.
+ */
+
+unsigned long micros(void)
+{
+    return (uint32_t)getSimulatedTime();
+
+} /* End of micros */
+
+
+
+
+/**
+ * Busy wait for a number of milliseconds.
+ *   @param ms
+ * The time to wait in milliseconds.
+ */
+
+void delay(unsigned long ms)
+{
+    const uint64_t tiEnd = getSimulatedTime() + 1000ull*ms;
+    while(getSimulatedTime() < tiEnd)
+        ;
+} /* End of delay */
+
+
+
+
+/**
+ * Busy wait for a number of microseconds.
+ *   @param us
+ * The time to wait in microseconds.
+ */
+
+void delayMicroseconds(unsigned int us)
+{
+    const uint64_t tiEnd = getSimulatedTime() + us;
+    while(getSimulatedTime() < tiEnd)
+        ;
+} /* End of delayMicroseconds */
+
+
+
+
+/**
+ * No pins exist in the simulation. The function has no effect.
+ */
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+} /* End of pinMode */
+
+
+
+
+/**
+ * No pins exist in the simulation. The function has no effect.
+ */
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+} /* End of digitalWrite */
+
+
+
+
+/**
+ * No pins exist in the simulation. The function always returns LOW.
+ */
+
+int digitalRead(uint8_t pin)
+{
+    return LOW;
+
+} /* End of digitalRead */
+
+
+
+
+/**
+ * Write the emulated timer interrupt mask register. If the timer interrupt is enabled and
+ * the timer signal has been received while it was disabled, then the interrupt is raised
+ * now.
+ *   @return
+ * Get the register.
+ *   @param value
+ * The new value of the register.
+ */
+
+hst_timerInterruptMaskRegister_t &hst_timerInterruptMaskRegister_t::operator =(uint8_t value)
+{
+    _value = value;
+    if((value & _BV(TOIE2)) != 0  &&  _isTimer2OvfPending)
+        raise(SIGALRM);
+
+    return *this;
+
+} /* End of hst_timerInterruptMaskRegister_t::operator = */
+
+
+
+
+/**
+ * Wait until all output has been written.
+ */
+
+void HardwareSerial::flush(void)
+{
+    fflush(stdout);
+
+} /* End of HardwareSerial::flush */
+
+
+
+
+/**
+ * Write a character.
+ *   @return
+ * Get the number of written characters.
+ *   @param c
+ * The character.
+ */
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return putchar(c) == EOF? 0: 1;
+
+} /* End of HardwareSerial::write(uint8_t) */
+
+
+
+
+/**
+ * Write a null terminated string.
+ *   @return
+ * Get the number of written characters.
+ *   @param str
+ * The string.
+ */
+
+size_t HardwareSerial::write(const char *str)
+{
+    return fputs(str, stdout) == EOF? 0: strlen(str);
+
+} /* End of HardwareSerial::write(const char *) */
+
+
+
+
+/**
+ * Write a number of characters.
+ *   @return
+ * Get the number of written characters.
+ *   @param buffer
+ * The characters.
+ *   @param size
+ * The number of characters.
+ */
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+
+} /* End of HardwareSerial::write(const uint8_t *, size_t) */
+
+
+
+
+/**
+ * Print an unsigned number in the given base like Arduino's Print does.
+ *   @return
+ * Get the number of written characters.
+ *   @param n
+ * The number.
+ *   @param base
+ * The base, 2..36.
+ */
+
+size_t HardwareSerial::printNumber(unsigned long n, uint8_t base)
+{
+    char buf[8*sizeof(n) + 1];
+    char *str = &buf[sizeof(buf)-1];
+    *str = '\0';
+
+    if(base < 2)
+        base = 10;
+    do
+    {
+        const char c = n % base;
+        n /= base;
+        *--str = c < 10? c + '0': c + 'A' - 10;
+    }
+    while(n > 0);
+
+    return write(str);
+
+} /* End of HardwareSerial::printNumber */
+
+
+
+
+/**
+ * The family of print functions of Arduino's Print. Integers are printed in the given
+ * base. Only decimal numbers are printed with sign. As on the AVR, other bases show the
+ * 32 Bit two's complement of negative numbers.
+ */
+
+size_t HardwareSerial::print(const char str[])
+{
+    return write(str);
+}
+
+size_t HardwareSerial::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(unsigned char n, int base)
+{
+    return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(int n, int base)
+{
+    return print((long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned int n, int base)
+{
+    return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(long n, int base)
+{
+    if(base == 0)
+        return write((uint8_t)n);
+    else if(base == 10  &&  n < 0)
+        return print('-') + printNumber(-n, 10);
+    else if(base == 10)
+        return printNumber(n, 10);
+    else
+        return printNumber((uint32_t)n, base);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base)
+{
+    if(base == 0)
+        return write((uint8_t)n);
+    else
+        return printNumber(n, base);
+}
+
+size_t HardwareSerial::print(double number, int digits)
+{
+    return printf("%.*f", digits, number);
+
+} /* End of HardwareSerial::print */
+
+
+
+
+/**
+ * The family of println functions of Arduino's Print. They behave like the print
+ * functions and append a line feed.
+ */
+
+size_t HardwareSerial::println(void)
+{
+    return write((uint8_t)'\n');
+}
+
+size_t HardwareSerial::println(const char str[])
+{
+    return print(str) + println();
+}
+
+size_t HardwareSerial::println(char c)
+{
+    return print(c) + println();
+}
+
+size_t HardwareSerial::println(unsigned char n, int base)
+{
+    return print(n, base) + println();
+}
+
+size_t HardwareSerial::println(int n, int base)
+{
+    return print(n, base) + println();
+}
+
+size_t HardwareSerial::println(unsigned int n, int base)
+{
+    return print(n, base) + println();
+}
+
+size_t HardwareSerial::println(long n, int base)
+{
+    return print(n, base) + println();
+}
+
+size_t HardwareSerial::println(unsigned long n, int base)
+{
+    return print(n, base) + println();
+}
+
+size_t HardwareSerial::println(double number, int digits)
+{
+    return print(number, digits) + println();
+
+} /* End of HardwareSerial::println */
@@ -0,0 +1,91 @@
+/**
+ * @file hst_stdout.c
+ *   Replacement of the module stdout.c of the test cases for the host simulation of
+ * RTuinOS. The original module redirects stdout into Serial by means of the stdio
+ * extensions of avr-libc. On the host, stdout is the console of the process already; the
+ * module is excluded from the build and these functions are linked instead.
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   init_stdout
+ *   puts_progmem
+ * Local functions
+ */
+
+/*
+ * Include files
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+
+
+/*
+ * Defines
+ */
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+/* The functions are declared in the header stdout.h of the test cases, which is not
+   available to all of them. */
+void init_stdout();
+int puts_progmem(const char *string);
+
+
+/*
+ * Data definitions
+ */
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Initialization of stdout. Nothing to do on the host.
+ */
+
+void init_stdout()
+{
+} /* End of init_stdout */
+
+
+
+
+/**
+ * Write a null terminated string to stdout. End output with writing a newline character.
+ *   @return
+ * No failure is recognized and the function always returns the non-negative value 0.
+ *   @param string
+ * The string. There's no flash ROM on the host and the string is located in normal
+ * memory.
+ */
+
+int puts_progmem(const char *string)
+{
+    puts(string);
+    return 0;
+
+} /* End of puts_progmem */
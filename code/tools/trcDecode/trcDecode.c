@@ -0,0 +1,434 @@
+/**
+ * @file trcDecode.c
+ *   Host tool, which decodes the binary trace of an RTuinOS application, see
+ * code/RTOS/trc_trace.c. The tool reads the captured console output of the application
+ * from stdin. The lines, which encode a trace entry, are replaced by readable log lines;
+ * all other lines are passed through unchanged.\n
+ *   The timestamps of the entries wrap around after about 262 ms. The tool accumulates
+ * the differences between subsequent entries to an absolute time; this is correct only if
+ * no two subsequent entries are further apart. The time is restarted at a trace dump.\n
+ *   Optionally, a file with names of the event IDs can be passed as command line argument.
+ * Each line of the file contains an ID, either decimal or hexadecimal with prefix 0x, and
+ * the name, separated by blanks. A line "task <index> <name>" names a task.\n
+ *   The entries of the kernel trace (see RTOS_USE_KERNEL_TRACE) are decoded by the tool.
+ * With option -json, the tool writes a timeline instead of the log; each task gets a lane,
+ * which shows when it was active, and all other entries are marked in the lane of the
+ * then active task. The output is in the Trace Event Format, which can be opened with the
+ * trace viewers of the Chrome and Chromium browsers (about:tracing) or with Perfetto
+ * (https://ui.perfetto.dev). Lines of the console output, which are no trace entries, are
+ * not written in this mode.\n
+ *   Compile the tool with any C99 compiler, e.g. gcc -o trcDecode trcDecode.c\n
+ *   Usage: trcDecode [-json] [eventNames.txt] < consoleOutput.txt
+ *
+ * Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Module interface
+ *   main
+ * Local functions
+ *   readNames
+ *   parseEntry
+ *   getTaskName
+ *   writeLogLine
+ *   writeTimelineEntry
+ *   decodeLine
+ */
+
+/*
+ * Include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * Defines
+ */
+
+/** The maximum length of a line of the console output. */
+#define MAX_LINE_LENGTH     1024
+
+/** The unit of the timestamp of a trace entry in microseconds. Needs to be consistent
+    with TRC_US_PER_TIMESTAMP in trc_trace.h. */
+#define US_PER_TIMESTAMP    4
+
+/** The event IDs of the kernel trace. Need to be consistent with trc_trace.h. */
+#define ID_TASK_SWITCH          0xf0
+#define ID_SEND_EVENT           0xf1
+#define ID_WAIT_FOR_EVENT       0xf2
+#define ID_TIMEOUT              0xf3
+#define ID_SYNC_OBJ_HAND_OVER   0xf4
+
+/** The event ID of the pseudo entry, which reports lost entries. See TRC_ID_LOST. */
+#define ID_LOST             0xff
+
+
+/*
+ * Local type definitions
+ */
+
+
+/*
+ * Local prototypes
+ */
+
+
+/*
+ * Data definitions
+ */
+
+/** The names of the event IDs or NULL if no name is known. */
+static char *_nameAry[256];
+
+/** The names of the tasks or NULL if no name is known. */
+static char *_taskNameAry[256];
+
+/** Flag, which selects the timeline output instead of the log. */
+static int _isTimeline = 0;
+
+/** The index of the active task as seen in the trace or -1 as long as it is unknown. */
+static int _idxActiveTask = -1;
+
+/** Flag, which indicates that no timeline entry has been written yet. */
+static int _isFirstTimelineEntry = 1;
+
+/** The timestamp of the previous entry. */
+static unsigned int _lastTimestamp = 0;
+
+/** The accumulated time in microseconds. */
+static unsigned long _time = 0;
+
+/** Flag, which indicates that the next entry starts the time at zero. */
+static int _isFirstEntry = 1;
+
+
+/*
+ * Function implementation
+ */
+
+/**
+ * Read the names of the event IDs from a file.
+ *   @return
+ * Get 0 on success or 1 if the file can't be read.
+ *   @param fileName
+ * The name of the file.
+ */
+
+static int readNames(const char *fileName)
+{
+    FILE *hFile = fopen(fileName, "r");
+    if(hFile == NULL)
+    {
+        fprintf(stderr, "Can't open file %s\n", fileName);
+        return 1;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    while(fgets(line, sizeof(line), hFile) != NULL)
+    {
+        char **nameAry = _nameAry
+           , *pStart = line
+           , *pEnd;
+
+        /* Skip leading blanks. A line "task <index> <name>" names a task. */
+        pStart += strspn(pStart, " \t");
+        if(strncmp(pStart, "task", 4) == 0)
+        {
+            nameAry = _taskNameAry;
+            pStart += 4;
+        }
+
+        const unsigned long id = strtoul(pStart, &pEnd, 0);
+        if(pEnd == pStart  ||  id > 255)
+            continue;
+
+        char name[MAX_LINE_LENGTH];
+        if(sscanf(pEnd, "%s", name) == 1)
+        {
+            free(nameAry[id]);
+            nameAry[id] = malloc(strlen(name)+1);
+            if(nameAry[id] != NULL)
+                strcpy(nameAry[id], name);
+        }
+    }
+
+    fclose(hFile);
+    return 0;
+
+} /* End of readNames */
+
+
+
+
+/**
+ * Parse a line of the console output as trace entry.
+ *   @return
+ * Get 1 if the line is a trace entry or 0 otherwise.
+ *   @param line
+ * The line of console output.
+ *   @param pId
+ *   @param pTimestamp
+ *   @param pArg
+ * The fields of the entry are returned by reference.
+ */
+
+static int parseEntry( const char *line
+                     , unsigned int *pId
+                     , unsigned int *pTimestamp
+                     , unsigned int *pArg
+                     )
+{
+    if(line[0] != '$')
+        return 0;
+
+    /* The format is fixed: Two hexadecimal digits of the ID, four of the timestamp and four
+       of the argument. */
+    unsigned int u;
+    for(u=1; u<=10; ++u)
+    {
+        if(strchr("0123456789abcdefABCDEF", line[u]) == NULL  ||  line[u] == '\0')
+            return 0;
+    }
+    if(line[11] != '\0'  &&  line[11] != '\r'  &&  line[11] != '\n')
+        return 0;
+
+    return sscanf(line+1, "%2x%4x%4x", pId, pTimestamp, pArg) == 3;
+
+} /* End of parseEntry */
+
+
+
+
+/**
+ * Get the name of a task.
+ *   @return
+ * Get the name from the file of names or a generated name. The string is valid until the
+ * next call of the function.
+ *   @param idxTask
+ * The index of the task.
+ */
+
+static const char *getTaskName(unsigned int idxTask)
+{
+    static char name[20];
+
+    if(idxTask < 256  &&  _taskNameAry[idxTask] != NULL)
+        return _taskNameAry[idxTask];
+
+    sprintf(name, "task %u", idxTask);
+    return name;
+
+} /* End of getTaskName */
+
+
+
+
+/**
+ * Write a trace entry as readable line of the log.
+ *   @param id
+ * The event ID of the entry.
+ *   @param arg
+ * The argument of the entry.
+ */
+
+static void writeLogLine(unsigned int id, unsigned int arg)
+{
+    printf("%8lu.%03lu ms  ", _time/1000, _time%1000);
+    if(_nameAry[id] != NULL)
+    {
+        printf("%-24s %5u (0x%04x)\n", _nameAry[id], arg, arg);
+        return;
+    }
+
+    switch(id)
+    {
+    case ID_TASK_SWITCH:
+        printf("Task switch              %s -> ", getTaskName(arg >> 8));
+        printf("%s\n", getTaskName(arg & 0xff));
+        break;
+    case ID_SEND_EVENT:
+        printf("Send event               0x%04x\n", arg);
+        break;
+    case ID_WAIT_FOR_EVENT:
+        printf("Wait for event           0x%04x\n", arg);
+        break;
+    case ID_TIMEOUT:
+        printf("Timeout                  %s\n", getTaskName(arg));
+        break;
+    case ID_SYNC_OBJ_HAND_OVER:
+        printf("Hand over sync object    event %u to %s\n", arg & 0xff, getTaskName(arg >> 8));
+        break;
+    case ID_LOST:
+        printf("*** %u trace entries lost\n", arg);
+        break;
+    default:
+        printf("Event 0x%02x               %5u (0x%04x)\n", id, arg, arg);
+    }
+} /* End of writeLogLine */
+
+
+
+
+/**
+ * Write a trace entry as element of the timeline. A task switch ends the slice of the
+ * left task and begins the slice of the new active task. All other entries are instant
+ * events in the lane of the active task.
+ *   @param id
+ * The event ID of the entry.
+ *   @param arg
+ * The argument of the entry.
+ */
+
+static void writeTimelineEntry(unsigned int id, unsigned int arg)
+{
+    static const char * const kernelNameAry[] =
+        {"task switch", "send event", "wait for event", "timeout", "hand over sync object"};
+    static unsigned char isLaneNamedAry[256];
+
+    /* Every element but the first one is preceded by a comma. */
+    const char *sep = _isFirstTimelineEntry? "": ",";
+    _isFirstTimelineEntry = 0;
+
+    if(id == ID_TASK_SWITCH)
+    {
+        /* The slice of the left task is closed. The task, which had been seen active, is
+           used rather than the argument; they differ only if entries have been lost. */
+        if(_idxActiveTask >= 0)
+        {
+            printf( "%s{\"name\":\"%s\",\"ph\":\"E\",\"ts\":%lu,\"pid\":0,\"tid\":%d}\n"
+                  , sep, getTaskName(_idxActiveTask), _time, _idxActiveTask
+                  );
+            sep = ",";
+        }
+
+        _idxActiveTask = (int)(arg & 0xff);
+        if(!isLaneNamedAry[_idxActiveTask])
+        {
+            isLaneNamedAry[_idxActiveTask] = 1;
+            printf( "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d"
+                    ",\"args\":{\"name\":\"%s\"}}\n"
+                  , sep, _idxActiveTask, getTaskName(_idxActiveTask)
+                  );
+            sep = ",";
+        }
+        printf( "%s{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%lu,\"pid\":0,\"tid\":%d}\n"
+              , sep, getTaskName(_idxActiveTask), _time, _idxActiveTask
+              );
+    }
+    else
+    {
+        char name[32];
+        if(_nameAry[id] != NULL)
+            snprintf(name, sizeof(name), "%s", _nameAry[id]);
+        else if(id >= ID_TASK_SWITCH  &&  id <= ID_SYNC_OBJ_HAND_OVER)
+            snprintf(name, sizeof(name), "%s", kernelNameAry[id - ID_TASK_SWITCH]);
+        else if(id == ID_LOST)
+            snprintf(name, sizeof(name), "entries lost");
+        else
+            snprintf(name, sizeof(name), "event 0x%02x", id);
+
+        printf( "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lu,\"pid\":0"
+                ",\"tid\":%d,\"args\":{\"arg\":%u}}\n"
+              , sep, name, _time, _idxActiveTask >= 0? _idxActiveTask: 0, arg
+              );
+    }
+} /* End of writeTimelineEntry */
+
+
+
+
+/**
+ * Decode a line of the console output and write the result to stdout.
+ *   @param line
+ * The line of console output including the end of line character.
+ */
+
+static void decodeLine(const char *line)
+{
+    unsigned int id, timestamp, arg;
+
+    if(!parseEntry(line, &id, &timestamp, &arg))
+    {
+        /* A dump of the trace buffer repeats entries, which may already have been
+           decoded. The time is restarted. */
+        if(strncmp(line, "Trace dump:", 11) == 0)
+            _isFirstEntry = 1;
+
+        if(!_isTimeline)
+            fputs(line, stdout);
+        return;
+    }
+
+    if(_isFirstEntry)
+    {
+        _isFirstEntry = 0;
+        _time = 0;
+    }
+    else
+        _time += ((timestamp - _lastTimestamp) & 0xffffu) * US_PER_TIMESTAMP;
+    _lastTimestamp = timestamp;
+
+    if(_isTimeline)
+        writeTimelineEntry(id, arg);
+    else
+        writeLogLine(id, arg);
+
+} /* End of decodeLine */
+
+
+
+
+/**
+ * Entry point of the tool.
+ *   @return
+ * Get 0 on success, 1 in case of errors.
+ *   @param argc
+ * The number of command line arguments.
+ *   @param argv
+ * The command line arguments. The optional switch -json and an optional file with names
+ * of the event IDs and tasks.
+ */
+
+int main(int argc, char *argv[])
+{
+    int idxArg = 1;
+    if(idxArg < argc  &&  strcmp(argv[idxArg], "-json") == 0)
+    {
+        _isTimeline = 1;
+        ++ idxArg;
+    }
+    if(argc - idxArg > 1  ||  (idxArg < argc  &&  argv[idxArg][0] == '-'))
+    {
+        fprintf(stderr, "usage: %s [-json] [eventNames.txt] < consoleOutput.txt\n", argv[0]);
+        return 1;
+    }
+    if(idxArg < argc  &&  readNames(argv[idxArg]) != 0)
+        return 1;
+
+    if(_isTimeline)
+        fputs("[\n", stdout);
+
+    char line[MAX_LINE_LENGTH];
+    while(fgets(line, sizeof(line), stdin) != NULL)
+        decodeLine(line);
+
+    if(_isTimeline)
+        fputs("]\n", stdout);
+
+    return 0;
+
+} /* End of main */
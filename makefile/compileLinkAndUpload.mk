@@ -70,11 +70,92 @@
 # default may be adjusted to your environment in the heading part of the code section of
 # this makefile or you may override the variable setting on the make processor's command
 # line by writing e.g. make COM_PORT=\\.\COM3.
+#   MCU: The target micro controller, one out of atmega2560 (default), atmega328p or
+# atmega1284p. The Arduino variant and the upload protocol are chosen accordingly. There's
+# no variant for the ATmega1284P in the Arduino installation, a third party variant needs
+# to be installed and named by option ARDUINO_VARIANT.
 #   IO_FLOAT_LIB: If this flag is 0 the stdio library with reduced floating point support
 # is linked with the RTuinOS application. printf & co do nor recognize floating point
 # format characters like %f. This reduces the size of the code by about 1.5kByte, the RAM
 # size is not affected. By default this falg is set to 1 and full support of printf & co is
 # ensured.
+#   LTO: If this flag is 1 the RTuinOS kernel and the application are compiled and linked
+# with link time optimization. The compiler treats them as one unit and can inline and
+# specialize the kernel functions for the given application. The Arduino core library is
+# compiled as usual. The default is 0. LTO requires avr-gcc 4.8 or newer. The object files
+# of both modes can't be mixed, use target rebuild when switching. Compare the modes with
+# the benchmark tc16, e.g. make APP=tc16 LTO=1 rebuild upload.
+#   COMPILER_CACHE: A compiler cache, which is put in front of the compiler command lines,
+# e.g. COMPILER_CACHE=ccache. The cache is keyed by the preprocessed source code, the
+# compiler and its flags; it avoids the recompilation of the kernel for applications and
+# configurations, which have already been built with identical kernel settings. The
+# default is no cache.
+#   ALL_TESTS_TARGET: The target, which is made by target allTests for each test case,
+# build (default) or simulate.
+#   SIM_DURATION, SIM_SPEEDUP: The simulated world time in seconds, after which target
+# simulate ends the simulation (default 10), and the factor by which the simulation runs
+# faster than real time (default 1).
+#   STACK_ISR_NESTING: The maximum number of interrupts, which can be active at a time on
+# top of a task. Target stackUsage adds the stack usage of the worst interrupt service
+# routine as often to the stack usage of each task (default 1). Consider a greater value if
+# the application enables nested interrupts.
+#
+# Footprint of the Kernel
+# =======================
+#
+# The target footprint builds the benchmark tc16 in a set of kernel configurations and
+# prints a table of the flash and RAM consumption of each of them: the totals, the
+# kernel's share and the size of the main data structures. The configurations are listed
+# in FOOTPRINT_CONFIGS, see the definitions of footprintCounts_<name> and
+# footprintDefines_<name> below. The CPU cycles of the kernel can't be got at build time;
+# flash tc16 in the configuration of interest and read its report, e.g. using
+#   make APP=tc16 TC16_NO_SEMAPHORES=2 rebuild upload
+#
+# Test Cases
+# ==========
+#
+# The target allTests makes all applications code/applications/tc<nn> in sub-make
+# processes. Use option -j to make them in parallel, e.g. make -j8 allTests. The Arduino
+# core library is built once before. The made target is set by ALL_TESTS_TARGET. The
+# test cases, which can't be simulated, are skipped if it is simulate. Some simulated test
+# cases check the consumed CPU time; they can fail if more simulations run in parallel
+# than the host has CPU cores.
+#
+# Host Simulation
+# ===============
+#
+# The targets buildSimulation and simulate compile the RTuinOS kernel and the application
+# with the native compiler for the host machine, a Linux PC. The Arduino installation is
+# not required. The Arduino core library is replaced by an emulation, which is found in
+# code/host, and the tasks are switched with the ucontext functions of the host. A test
+# case can be run in seconds without flashing a board. Test cases, which depend on
+# hardware other than the system timer and the serial output, can't be simulated; the
+# compilation of the kernel reports an error for them.
+#
+# Stack Usage Analysis
+# ====================
+#
+# The target stackUsage reports the worst case stack usage of each task of the
+# application. The compiler states the size of the stack frame of each function in a file
+# obj/<cFileName>.su (option -fstack-usage) and the disassembly of the ELF file yields the
+# call graph. Script stackUsage.awk walks the call tree of each task function, which is
+# passed to rtos_initializeTask, and adds the context frame of the kernel and the stack
+# usage of the interrupts. Indirect calls and recursion can't be resolved; the report names
+# the functions, for which the computed number is a lower bound only. Compare the result
+# with the stack areas of the tasks in the application code, and with the values got at
+# run time from rtos_getStackReserve.
+#   The analysis requires a build without link time optimization, LTO=0.
+#
+# Schedulability Analysis
+# =======================
+#
+# The target schedulability reports the worst case response time and the slack of each
+# task of the application. The priority classes and the periods are taken from the task
+# configuration in the application code. The execution times of the tasks and the
+# overhead of the kernel are stated in file code/applications/<APP>/<APP>.timing, e.g. as
+# measured with rtos_getTaskTimingStatistics and the benchmark tc16. Script
+# schedulability.awk runs the response time analysis and fails if a task can miss its
+# deadline. The Arduino installation is not required.
 #
 # Input Files
 # ===========
@@ -95,6 +176,18 @@
 #   Specify a blank separated list of directories holding source files.
 srcDirList := code/RTOS/ code/applications/$(APP)/
 
+# The host simulation is built from the same sources plus the emulation of the Arduino
+# core. The redirection of stdout of the test cases is replaced by the emulation.
+simSrcDirList = $(srcDirList) code/host/
+simCFileListExcl = $(cFileListExcl) stdout.c
+
+# The targets, which are built without the Arduino installation.
+simTargetList := buildSimulation simulate schedulability
+ifeq ($(ALL_TESTS_TARGET),simulate)
+    simTargetList += allTests all-tests
+endif
+isSimulationOnly := $(if $(MAKECMDGOALS),$(if $(filter-out $(simTargetList),$(MAKECMDGOALS)),,1))
+
 # Exclusion list: Basically all C/C++ source files found in the source directories are
 # compiled and linked. Here, you can specify some particular files, which must not be
 # included in the build.
@@ -103,6 +196,12 @@ srcDirList := code/RTOS/ code/applications/$(APP)/
 # makefile fragment code/applications/$(APP)/$(APP).mk.
 cFileListExcl :=
 
+# Additional preprocessor defines of the application, e.g. -DMY_SWITCH=1. They are passed
+# to the compilation of all RTuinOS and application source files.
+#   The appropriate location to set this variable is the application owned makefile
+# fragment code/applications/$(APP)/$(APP).mk.
+cDefinesAppl :=
+
 # Double-check environment.
 #   The original Arduino code is referenced in the Arduino installation directory. By
 # default the location of this is not known. To run this makefile an environment variable
@@ -110,7 +209,7 @@ cFileListExcl :=
 ifdef ARDUINO_HOME
     # Ensure a trailing slash at the end of this externally set variable.
 	ARDUINO_HOME := $(patsubst %/,%,$(subst \,/,$(ARDUINO_HOME)))/
-else
+else ifndef isSimulationOnly
     $(error Variable ARDUINO_HOME needs to be set prior to running this makefile. It points \
 to the installation directory of the Arduino environment, where arduino.exe is located)
 endif
@@ -130,21 +229,25 @@ include $(sharedMakefilePath)locateTools.mk
 # RTuinOS can't be linked without an application. Select which one. Here, all applications
 # are considered test cases.
 APP ?= TC01
-ifneq ($(origin APP), command line)
-    $(warning Please select an RTuinOS application. Add APP=<myRTuinOSApp> to the command line, otherwise APP=$(APP) will be used)
+ifeq ($(filter allTests all-tests footprint,$(MAKECMDGOALS)),)
+    ifneq ($(origin APP), command line)
+        $(warning Please select an RTuinOS application. Add APP=<myRTuinOSApp> to the command line, otherwise APP=$(APP) will be used)
+    endif
 endif
 
 # Access help as default target or by several names. This target needs to be the first one
 # in this file.
 .PHONY: h help targets usage
 h help targets usage:
-	$(info Usage: make [-s] APP=<myRTuinOSApplication> [CONFIG=<configuration>] [COM_PORT=<portName>] [IO_FLOAT_LIB=1] {<target>})
+	$(info Usage: make [-s] APP=<myRTuinOSApplication> [CONFIG=<configuration>] [COM_PORT=<portName>] [MCU=<controller>] [IO_FLOAT_LIB=1] [LTO=1] {<target>})
 	$(info <myRTuinOSApplication> is the name of the source code folder of your application,)
 	$(info located at code/applications.)
 	$(info <configuration> is one out of DEBUG (default) or PRODUCTION.)
 	$(info <portName> is an a USB port identifying string to be used for the upload. The)
 	$(info default port ($(COM_PORT)) is configured in the makefile. See help of avrdude for)
 	$(info more.)
+	$(info The switch LTO=1 compiles and links the kernel and the application with link time)
+	$(info optimization. Use target rebuild when changing this setting.)
 	$(info The switch IO_FLOAT_LIB=1 may be used to link against the printf library with)
 	$(info floating point support. By default (IO_FLOAT_LIB=0) your application is linked)
 	$(info against the standard Arduino printf library without floating point support.)
@@ -153,8 +256,19 @@ h help targets usage:
 	$(info   - clean: Delete all application files generated by the build process)
 	$(info   - cleanCore: Delete the compilation core.a of the Arduino standard library files)
 	$(info   - rebuild: Same as clean and build together)
+	$(info   - footprint: Build the benchmark tc16 in several kernel configurations and)
+	$(info     report their flash and RAM consumption)
+	$(info   - allTests: Make ALL_TESTS_TARGET, build (default) or simulate, for all test)
+	$(info     cases. Use option -j to make them in parallel)
 	$(info   - bin/<configuration>/obj/<cFileName>.o: Compile a single C(++) module)
 	$(info   - upload: Build first, then flash the device)
+	$(info   - stackUsage: Build first, then report the worst case stack usage of the tasks)
+	$(info     by static analysis of the call graph)
+	$(info   - schedulability: Report the worst case response times of the tasks and)
+	$(info     whether they meet their deadlines)
+	$(info   - buildSimulation: Build the application for the host machine)
+	$(info   - simulate: Build the application for the host machine and run it for)
+	$(info     SIM_DURATION seconds, speeded up by factor SIM_SPEEDUP)
 	$(info   - help: Print this help)
 	$(error)
 
@@ -182,15 +296,23 @@ else
 endif
 #$(info $(CONFIG) $(cDefines))
 
+# The CPU clock frequency in Hz.
+cpuClock := 16000000
+
 # Where to place all generated products?
 targetDir := bin/$(APP)/$(CONFIG)/
-coreDir := bin/core/
+# The Arduino core library doesn't depend on the application and its configuration but
+# on the target micro controller only. It is shared by all applications for the same
+# controller.
+coreDir := bin/core/$(targetMicroController)$(if $(ARDUINO_VARIANT),_$(ARDUINO_VARIANT))/
+simTargetDir := bin/$(APP)/$(CONFIG)/simulation/
 
 # Ensure existence of target directory.
-.PHONY: makeDir
+.PHONY: makeDir makeSimDir
 makeDir: | $(targetDir)obj $(coreDir)obj
+makeSimDir: | $(simTargetDir)obj
 
-$(targetDir)obj $(coreDir)obj:
+$(targetDir)obj $(coreDir)obj $(simTargetDir)obj:
 	-$(mkdir) -p $@
 
 # Determine the list of files to be compiled. Starting point is the list of source file
@@ -215,27 +337,61 @@ objList := $(objList:.c=.o)
 objListWithPath := $(addprefix $(targetDir)obj/, $(objList))
 #$(info objListWithPath := $(objListWithPath))
 
+# The same for the host simulation.
+simCFileList := $(wildcard $(foreach path, $(simSrcDirList), $(addprefix $(path), *.c *.cpp)))
+simCFileList := $(filter-out $(simCFileListExcl), $(notdir $(simCFileList)))
+simObjList := $(simCFileList:.cpp=.o)
+simObjList := $(simObjList:.c=.o)
+simObjListWithPath := $(addprefix $(simTargetDir)obj/, $(simObjList))
+
 # Include the dependency files. Do this with a failure tolerant include operation - the
 # files are not available after a clean.
 -include $(patsubst %.o,%.d,$(objListWithPath))
+-include $(patsubst %.o,%.d,$(simObjListWithPath))
+
+# The Arduino variant, which holds the pin definitions of the board, and the protocol of
+# the boot loader depend on the target micro controller.
+ifeq ($(targetMicroController),atmega2560)
+    arduinoVariant := mega
+    avrdudeProtocol := Wiring
+    sizeOfPC := 3
+else ifeq ($(targetMicroController),atmega328p)
+    arduinoVariant := standard
+    avrdudeProtocol := arduino
+    sizeOfPC := 2
+else ifeq ($(targetMicroController),atmega1284p)
+    arduinoVariant :=
+    avrdudeProtocol := arduino
+    sizeOfPC := 2
+else
+    $(error Target micro controller $(targetMicroController) is not supported by RTuinOS)
+endif
+ifdef ARDUINO_VARIANT
+    arduinoVariant := $(ARDUINO_VARIANT)
+endif
+ifeq ($(arduinoVariant),)
+    $(error Please specify the Arduino variant of your $(targetMicroController) board. Add \
+ARDUINO_VARIANT=<nameOfVariantFolder> to the command line)
+endif
 
 # Blank separated search path for source files and their prerequisites permits to use auto
 # rules for compilation.
 VPATH := $(srcDirList) 																\
+         code/host/                                                                 \
          $(targetDir)                                                               \
          $(ARDUINO_HOME)hardware/arduino/cores/arduino/                             \
          $(ARDUINO_HOME)libraries/LiquidCrystal/
 
 # Pattern rules for compilation of C and C++ source files.
 #   TODO You may need to add more include paths here.
-cFlags =  $(cDefines) -c -Wall -fno-exceptions -ffunction-sections                  \
-          -fdata-sections -mmcu=$(targetMicroController) -DF_CPU=16000000L -MMD     \
+cFlags =  $(cDefines) $(cDefinesAppl) -c -Wall -fno-exceptions -ffunction-sections                  \
+          -fdata-sections -mmcu=$(targetMicroController) -DF_CPU=$(cpuClock)L -MMD  \
           -DUSB_VID=null -DUSB_PID=null -DARDUINO=105                               \
-          -Wa,-a=$(patsubst %.o,%.lst,$@)                                           \
+          -Wa,-a=$(patsubst %.o,%.lst,$@) -fstack-usage                             \
           -Winline                                                                  \
           $(foreach path, $(srcDirList), -I$(path))                                 \
           -I$(ARDUINO_HOME)hardware/arduino/cores/arduino/                          \
-          -I$(ARDUINO_HOME)hardware/arduino/variants/mega/                          \
+          -I$(ARDUINO_HOME)hardware/arduino/variants/$(arduinoVariant)/             \
           -I$(ARDUINO_HOME)libraries/LiquidCrystal/                                 \
           -I$(ARDUINO_HOME)libraries/LiquidCrystal/utility/
 ifeq ($(CONFIG),DEBUG)
@@ -245,20 +401,54 @@ else
 endif
 #$(info cFlags := $(cFlags))
 
+# Link time optimization of kernel and application. The naked functions of the kernel stay
+# intact: They are declared noinline and the ISRs are externally visible. The kernel
+# interrupts jump to assembler labels, which are defined in other functions of rtos.c;
+# all code therefore needs to be generated into a single partition. The optimization flags
+# are repeated at link time, when the code is actually generated. The listing files and
+# the stack usage files are not written for the application files in this mode.
+LTO ?= 0
+ifeq ($(LTO),1)
+    ltoFlags := -flto -flto-partition=one
+    ltoLFlags := $(ltoFlags) $(cDbgFlags)
+else ifeq ($(LTO),0)
+    ltoFlags :=
+    ltoLFlags :=
+else
+    $(error Please set LTO to either 0 or 1)
+endif
+
 $(targetDir)obj/%.o: %.c
 	$(info Compiling C file $<)
-	$(avr-g++) $(cDbgFlags) $(cFlags) -o $@ $<
+	$(COMPILER_CACHE) $(avr-g++) $(cDbgFlags) $(ltoFlags) $(cFlags) -o $@ $<
 
 $(targetDir)obj/%.o: %.cpp
 	$(info Compiling C++ file $<)
-	$(avr-g++) $(cDbgFlags) $(cFlags) -o $@ $<
+	$(COMPILER_CACHE) $(avr-g++) $(cDbgFlags) $(ltoFlags) $(cFlags) -o $@ $<
+
+# Pattern rules for the compilation of the host simulation. The emulation of the Arduino
+# core in code/host replaces the Arduino include directories.
+simCFlags = $(cDefines) $(cDefinesAppl) -DRTOS_HOST_SIMULATION -c -Wall -fno-exceptions  \
+            -DF_CPU=$(cpuClock)L -DARDUINO=105 -MMD                                   \
+            $(foreach path, $(simSrcDirList), -I$(path))
+
+$(simTargetDir)obj/%.o: %.c
+	$(info Compiling C file $< for the host simulation)
+	$(COMPILER_CACHE) $(host-g++) $(cDbgFlags) $(ltoFlags) $(simCFlags) -o $@ $<
+
+$(simTargetDir)obj/%.o: %.cpp
+	$(info Compiling C++ file $< for the host simulation)
+	$(COMPILER_CACHE) $(host-g++) $(cDbgFlags) $(ltoFlags) $(simCFlags) -o $@ $<
 
 
 # Compile and link all (original) Arduino core files into library core.a. Although not
 # subject to any changes the Arduino code is still referenced as source code for reference.
 # Do not replace by a completely anonymous library.
 #   The compilation of the code is implemented configuration independent - the original
-# Arduino code will not know or respect our configuration dependent #defines.
+# Arduino code will not know or respect our configuration dependent #defines. They are
+# removed from the compiler flags so that the library can be shared by all applications
+# and configurations.
+coreCFlags = $(filter-out $(cDefines) $(cDefinesAppl),$(cFlags))
 objListCore = WInterrupts.o wiring.o wiring_analog.o wiring_digital.o wiring_pulse.o    \
               wiring_shift.o CDC.o HardwareSerial.o HID.o IPAddress.o new.o      		\
               Print.o Stream.o Tone.o USBCore.o WMath.o WString.o LiquidCrystal.o
@@ -267,11 +457,11 @@ objListCoreWithPath = $(addprefix $(coreDir)obj/, $(objListCore))
 
 $(coreDir)obj/%.o: %.c
 	$(info Compiling C file $<)
-	$(avr-g++) -g -Os $(cFlags) -o $@ $<
+	$(COMPILER_CACHE) $(avr-g++) -g -Os $(coreCFlags) -o $@ $<
 
 $(coreDir)obj/%.o: %.cpp
 	$(info Compiling C++ file $<)
-	$(avr-g++) -g -Os $(cFlags) -o $@ $<
+	$(COMPILER_CACHE) $(avr-g++) -g -Os $(coreCFlags) -o $@ $<
 
 $(coreDir)core.a: $(objListCoreWithPath)
 	$(info Creating Arduino standard library $@)
@@ -279,7 +469,7 @@ $(coreDir)core.a: $(objListCoreWithPath)
 
 
 # A general rule enforces rebuild if one of the configuration files changes
-$(objListWithPath) $(objListCoreWithPath): GNUmakefile
+$(objListWithPath) $(objListCoreWithPath) $(simObjListWithPath): GNUmakefile
 
 # Let the linker create the binary ELF file.
 lFlags := -Wl,--gc-sections,--relax,--cref -mmcu=$(targetMicroController)		        \
@@ -289,7 +479,7 @@ ifeq ($(IO_FLOAT_LIB),1)
 endif
 $(targetDir)$(project).elf: $(coreDir)core.a $(objListWithPath) 
 	$(info Linking project. Ouput is redirected to $(targetDir)$(project).map)
-	$(avr-gcc) $(lFlags) -o $@ -Wl,--start-group $^ -Wl,--end-group -lm   		        \
+	$(avr-gcc) $(ltoLFlags) $(lFlags) -o $@ -Wl,--start-group $^ -Wl,--end-group -lm   		        \
                -Wl,-M > $(targetDir)$(project).map
 	$(avr-size) -C --mcu=$(targetMicroController) $@ >> $(targetDir)$(project).map
 	$(avr-size) -C --mcu=$(targetMicroController) $@
@@ -307,18 +497,65 @@ $(targetDir)$(project).hex: $(targetDir)$(project).elf
 #   Option -cWiring: The Arduino IDE uses a quite similar protocol which unfortunately
 # requires an additional, preparatory reset command. This protocol can't therefore be
 # applied in an automated process. Here we need to use protocol Wiring instead. Use -c? to
-# get a list of options.
+# get a list of options. The boot loader of the smaller boards (optiboot) is addressed with
+# protocol arduino.
 #   Option -p: Run avrdude with -C... -p? to get a list of supported controllers.
 .PHONY: upload
 upload: makeDir																				\
         $(targetDir)$(project).hex $(targetDir)$(project).elf $(targetDir)$(project).eep	\
         $(ARDUINO_HOME)hardware/tools/avr/etc/avrdude.conf
 	$(avrdude) -C$(ARDUINO_HOME)hardware/tools/avr/etc/avrdude.conf -v                      \
-	        -p$(targetMicroController) -cWiring -P$(COM_PORT) -b115200 -D                   \
+	        -p$(targetMicroController) -c$(avrdudeProtocol) -P$(COM_PORT) -b115200 -D       \
             -Uflash:w:$(targetDir)$(project).hex:i
 	$(avr-size) -C --mcu=$(targetMicroController) $(targetDir)$(project).elf
 
 
+# Static analysis of the stack usage of the tasks. The call graph is taken from the
+# disassembly of the ELF file and the frame sizes from the stack usage files of the
+# compiler, which are written next to the object files. The context frame of the kernel
+# consists of the 32 registers and the status register, see macro PUSH_CONTEXT_ONTO_STACK
+# in rtos.c.
+STACK_ISR_NESTING ?= 1
+$(targetDir)$(project).dis: $(targetDir)$(project).elf
+	$(avr-objdump) -d -C $< > $@
+
+.PHONY: stackUsage
+stackUsage: makeDir $(targetDir)$(project).dis
+	$(awk) -v sizeOfPC=$(sizeOfPC) -v sizeOfContext=33 -v noNestedIsrs=$(STACK_ISR_NESTING) \
+           -f $(sharedMakefilePath)stackUsage.awk                                     \
+           $(wildcard $(addprefix code/applications/$(APP)/, *.c *.cpp))               \
+           $(wildcard $(targetDir)obj/*.su $(coreDir)obj/*.su)                         \
+           $(targetDir)$(project).dis
+
+
+# Response time analysis of the tasks. The timing description of the application is read
+# after the application code.
+timingFile := code/applications/$(APP)/$(APP).timing
+.PHONY: schedulability
+schedulability:
+	$(if $(wildcard $(timingFile)),,$(error Timing description $(timingFile) not found))
+	$(awk) -v cpuClock=$(cpuClock) -f $(sharedMakefilePath)schedulability.awk             \
+           $(wildcard $(addprefix code/applications/$(APP)/, *.h *.c *.cpp))           \
+           $(timingFile)
+
+
+# Link the executable of the host simulation.
+$(simTargetDir)$(project): $(simObjListWithPath)
+	$(info Linking host simulation $@)
+	$(host-g++) $(ltoLFlags) -o $@ $^ -lm
+
+# Build and run the host simulation. The simulation ends after SIM_DURATION seconds of
+# simulated world time with exit code 0 or with a failure code if an assertion fires.
+SIM_DURATION ?= 10
+SIM_SPEEDUP ?= 1
+.PHONY: buildSimulation simulate
+buildSimulation: makeSimDir $(simTargetDir)$(project)
+
+simulate: buildSimulation
+	RTUINOS_SIMULATION_DURATION=$(SIM_DURATION) RTUINOS_SIMULATION_SPEEDUP=$(SIM_SPEEDUP)   \
+    $(simTargetDir)$(project)
+
+
 # Run the complete build process with compilation, linkage and binary file modifications.
 .PHONY: build
 build: makeDir $(targetDir)$(project).eep $(targetDir)$(project).hex
@@ -331,12 +568,72 @@ rebuild: clean build
 .PHONY: compile
 compile: makeDir $(coreDir)core.a $(objListWithPath)
 
+# Build the benchmark in a matrix of kernel configurations and report the memory
+# consumption of each. A configuration <name> is specified by the numbers of tasks, priority
+# classes, semaphores and mutexes, footprintCounts_<name>, and by the kernel switches,
+# which differ from the defaults, footprintDefines_<name>. Each configuration is built in
+# a folder of its own, so that the objects are reused if the kernel is unchanged.
+FOOTPRINT_CONFIGS ?= minimal base roundRobin semaphores mutexes inheritance bitmap          \
+                     timerWheel waiterIdx lazyContext tasks8
+footprintCounts_minimal := TC16_NO_TASKS=2 TC16_NO_PRIO_CLASSES=1
+footprintCounts_base :=
+footprintDefines_roundRobin := -DRTOS_ROUND_ROBIN_MODE_SUPPORTED=RTOS_FEATURE_ON
+footprintCounts_semaphores := TC16_NO_SEMAPHORES=2
+footprintCounts_mutexes := TC16_NO_MUTEXES=2
+footprintCounts_inheritance := TC16_NO_MUTEXES=2
+footprintDefines_inheritance := -DRTOS_USE_MUTEX_PRIO_INHERITANCE=RTOS_FEATURE_ON
+footprintDefines_bitmap := -DRTOS_USE_PRIO_CLASS_BITMAP=RTOS_FEATURE_ON
+footprintDefines_timerWheel := -DRTOS_USE_TIMER_WHEEL=RTOS_FEATURE_ON
+footprintDefines_waiterIdx := -DRTOS_USE_EVENT_WAITER_INDEX=RTOS_FEATURE_ON
+footprintDefines_lazyContext := -DRTOS_USE_LAZY_CONTEXT_SAVE=RTOS_FEATURE_ON
+footprintCounts_tasks8 := TC16_NO_TASKS=8 TC16_NO_PRIO_CLASSES=3
+footprintDir := bin/footprint/
+footprintTable := $(footprintDir)footprint.txt
+kernelObjList := $(patsubst %.c,%.o,$(notdir $(wildcard code/RTOS/*.c)))
+
+define footprintOfConfig
+	$(MAKE) -s APP=tc16 CONFIG=PRODUCTION targetDir=$(footprintDir)$(1)/ COM_PORT=$(COM_PORT) \
+            $(footprintCounts_$(1)) TC16_DEFINES="$(footprintDefines_$(1))" build
+	$(awk) -v configName=$(1) -v kernelObjList="$(kernelObjList)"                           \
+           -f $(sharedMakefilePath)footprint.awk $(footprintDir)$(1)/RTuinOS_tc16.map >> $(2)
+
+endef
+
+.PHONY: footprint
+footprint:
+	-$(mkdir) -p $(footprintDir)
+	$(awk) -v printHeader=1 -f $(sharedMakefilePath)footprint.awk > $(footprintTable)
+	$(foreach config, $(FOOTPRINT_CONFIGS), $(call footprintOfConfig,$(config),$(footprintTable)))
+	$(cat) $(footprintTable)
+
+# Make all test cases. Each one is made by a sub-make process, which can run in parallel
+# to the others. The Arduino core library is shared; it's built before, by the first one.
+ALL_TESTS_TARGET ?= build
+allTestsAppList := $(notdir $(wildcard code/applications/tc*))
+ifeq ($(ALL_TESTS_TARGET),simulate)
+    # The test cases, which depend on hardware other than the system timer and the serial
+    # output, on the word size of the AVR or on a reset of the CPU.
+    allTestsAppList := $(filter-out tc05 tc08 tc12 tc14 tc16 tc20 tc30 tc36 tc38, $(allTestsAppList))
+endif
+.PHONY: allTests all-tests allTestsCore
+allTests all-tests: $(addprefix allTests_, $(allTestsAppList))
+	$(info All test cases made: $(allTestsAppList))
+
+allTestsCore:
+ifneq ($(ALL_TESTS_TARGET),simulate)
+	$(MAKE) APP=$(firstword $(allTestsAppList)) makeDir $(coreDir)core.a
+endif
+
+allTests_%: allTestsCore
+	$(MAKE) APP=$* $(ALL_TESTS_TARGET)
+
 # Delete all application products ignoring (-) the return code from Windows.
 .SILENT: clean
 .PHONY: clean
 clean:
 	-$(rm) -f $(targetDir)$(project).* 2> nul
 	-$(rm) -fr $(targetDir)obj 2> nul
+	-$(rm) -fr $(simTargetDir) 2> nul
 
 # Delete the core compilation (Arduino standard files) ignoring (-) the return code from
 # Windows. This target is not part of clean as rebuilding the Arduino library is usually
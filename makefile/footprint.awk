@@ -0,0 +1,179 @@
+#
+# Flash and RAM Footprint of the RTuinOS Kernel
+#
+# The script evaluates the map file of a linked RTuinOS application and prints one row
+# of a table of the memory consumption. It is run by the makefile target footprint, see
+# compileLinkAndUpload.mk.
+#
+# Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+#
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU Lesser General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+# for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Input Files
+# ===========
+#
+# The map file of the linker, as got with option -Wl,-M. Only the memory map is
+# evaluated; the input sections of the object files are assigned to the output sections
+# they are placed in. Removed sections (--gc-sections) are not counted.
+#
+# Options
+# =======
+#
+# The options are passed as awk variables, -v name=value:
+#   configName: The name of the configuration, which is printed in the first column.
+#   kernelObjList: The blank separated list of the object files of the kernel, without
+# path. Their sections are summed up in the columns of the kernel.
+#   printHeader: If set to 1, the script prints the head of the table and no input file
+# is read.
+#
+
+
+# Add the size of an input section to the sums.
+function addInputSection(name, size, file,        objFile)
+{
+    objFile = file
+    sub(/^.*[\/\\]/, "", objFile)
+    if(outputSection == ".text"  ||  outputSection == ".data")
+    {
+        if(objFile in isKernelObjAry)
+            kernelFlash += size
+    }
+    if(outputSection == ".data"  ||  outputSection == ".bss"  ||  outputSection == ".noinit")
+    {
+        if(objFile in isKernelObjAry)
+            kernelRam += size
+        if(name ~ /_taskAry$/)
+            sizeOfTaskAry += size
+        else if(name ~ /_pDueTaskAryAry$/)
+            sizeOfDueTaskAryAry += size
+    }
+}
+
+
+BEGIN {
+    formatRow = "%-16s %6s %6s %6s %6s %6s %8s %8s %9s %16s\n"
+    if(printHeader == 1)
+    {
+        printf(formatRow, "Configuration", "Flash", "RAM", ".text", ".data", ".bss",
+               "Kernel", "Kernel", "_taskAry", "_pDueTaskAryAry")
+        printf(formatRow, "", "", "", "", "", "", "flash", "RAM", "", "")
+        exit 0
+    }
+
+    noKernelObjs = split(kernelObjList, kernelObjAry, " ")
+    for(idx=1; idx<=noKernelObjs; ++idx)
+        isKernelObjAry[kernelObjAry[idx]] = 1
+
+    isMemoryMap = 0
+    outputSection = ""
+    pendingInputSection = ""
+    sizeOfSectionAry[".text"] = sizeOfSectionAry[".data"] = sizeOfSectionAry[".bss"] = 0
+    sizeOfSectionAry[".noinit"] = 0
+    kernelFlash = kernelRam = sizeOfTaskAry = sizeOfDueTaskAryAry = 0
+}
+
+
+{
+    sub(/\r$/, "")
+}
+
+
+/^Linker script and memory map/ {
+    isMemoryMap = 1
+    next
+}
+
+
+/^Cross Reference Table/ {
+    isMemoryMap = 0
+    next
+}
+
+
+!isMemoryMap {
+    next
+}
+
+
+# An output section: <name> <address> <size>
+/^\.[A-Za-z_.]+[ \t]+0x[0-9a-fA-F]+[ \t]+0x[0-9a-fA-F]+/ {
+    outputSection = $1
+    if(outputSection in sizeOfSectionAry)
+        sizeOfSectionAry[outputSection] = strtonum_($3)
+    pendingInputSection = ""
+    next
+}
+
+
+# An output section with the address and size in the next line.
+/^\.[A-Za-z_.]+[ \t]*$/ {
+    outputSection = $1
+    pendingOutputSection = 1
+    pendingInputSection = ""
+    next
+}
+
+
+# The input sections of an object file: <name> <address> <size> <file>. Long names are
+# followed by a line break.
+/^ [^ *]/ {
+    pendingOutputSection = 0
+    pendingInputSection = ""
+    if(NF >= 4  &&  $2 ~ /^0x/  &&  $3 ~ /^0x/)
+        addInputSection($1, strtonum_($3), $4)
+    else if(NF == 1)
+        pendingInputSection = $1
+    next
+}
+
+
+# The continuation of an output or input section with a long name: <address> <size>
+# [<file>]. The lines, which list the symbols of a section, have no size.
+/^[ \t]+0x[0-9a-fA-F]+[ \t]+0x[0-9a-fA-F]+/ {
+    if(pendingOutputSection)
+    {
+        if(outputSection in sizeOfSectionAry)
+            sizeOfSectionAry[outputSection] = strtonum_($2)
+    }
+    else if(pendingInputSection != ""  &&  NF >= 3)
+        addInputSection(pendingInputSection, strtonum_($2), $3)
+    pendingOutputSection = 0
+    pendingInputSection = ""
+    next
+}
+
+
+END {
+    if(printHeader == 1)
+        exit 0
+
+    flash = sizeOfSectionAry[".text"] + sizeOfSectionAry[".data"]
+    ram = sizeOfSectionAry[".data"] + sizeOfSectionAry[".bss"] + sizeOfSectionAry[".noinit"]
+    printf(formatRow, configName, flash, ram, sizeOfSectionAry[".text"],
+           sizeOfSectionAry[".data"], sizeOfSectionAry[".bss"] + sizeOfSectionAry[".noinit"],
+           kernelFlash, kernelRam, sizeOfTaskAry, sizeOfDueTaskAryAry)
+}
+
+
+# Convert a hexadecimal number 0x... into a number. (strtonum is not available in all
+# awk implementations.)
+function strtonum_(hex,        idx, value)
+{
+    value = 0
+    hex = tolower(hex)
+    sub(/^0x/, "", hex)
+    for(idx=1; idx<=length(hex); ++idx)
+        value = value*16 + index("0123456789abcdef", substr(hex, idx, 1)) - 1
+    return value
+}
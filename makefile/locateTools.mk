@@ -42,6 +42,7 @@ ifeq ($(OS),WINDOWS)
     avr-g++ := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-g++.exe
     avr-ar := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-ar.exe
     avr-objcopy := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-objcopy.exe
+    avr-objdump := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-objdump.exe
     avr-size := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-size.exe
     avrdude := $(ARDUINO_HOME)hardware/tools/avr/bin/avrdude
     avrdude_conf := $(ARDUINO_HOME)hardware/tools/avr/etc/avrdude.conf
@@ -60,7 +61,12 @@ else
     avr-g++ := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-g++
     avr-ar := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-ar
     avr-objcopy := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-objcopy
+    avr-objdump := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-objdump
     avr-size := $(ARDUINO_HOME)hardware/tools/avr/bin/avr-size
     avrdude := $(ARDUINO_HOME)hardware/tools/avrdude
     avrdude_conf := $(ARDUINO_HOME)hardware/tools/avrdude.conf
 endif
+
+# The host simulation of RTuinOS is compiled with the native compiler of the machine, which
+# is found in the search path. The simulation requires a POSIX system, like Linux.
+host-g++ := g++
@@ -0,0 +1,373 @@
+#
+# Schedulability Analysis of an RTuinOS Application
+#
+# The script computes the worst case response time of each task of an RTuinOS application
+# and compares it with the deadline of the task. It is run by the makefile target
+# schedulability, see compileLinkAndUpload.mk.
+#
+# Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+#
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU Lesser General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+# for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Input Files
+# ===========
+#
+# The files are distinguished by their extensions and need to be passed in this order:
+#   *.h, *.c, *.cpp: The configuration and the source files of the application. The
+# priority classes of the tasks are taken from the calls of rtos_initializeTask or from
+# the rows of the task table RTOS_TASK_TABLE. The periods of the tasks are taken from the
+# calls of rtos_setTaskPeriod. The system timer tic is taken from the definition of
+# RTOS_TIC. Arguments, which are no literals, are resolved if they are macros with a
+# literal value, like #define PERIOD 10.
+#   *.timing: The timing description of the application, see below.
+#
+# Timing Description
+# ==================
+#
+# The execution times can't be derived from the source code. They are stated in a text
+# file code/applications/<APP>/<APP>.timing. Empty lines and comments, which start with
+# #, are ignored. The other lines have one of these forms:
+#   ticIsr <cycles>: The execution time of the system timer interrupt in CPU clock cycles.
+# It is charged once per tic.
+#   sendEvent <cycles>: The execution time of the kernel for releasing a task, either by an
+# event or by a timer, in CPU clock cycles. It is charged once per activation of a task.
+#   contextSwitch <cycles>: The execution time of a task switch in CPU clock cycles. It is
+# charged twice per activation of a task of higher priority, once for preempting and once
+# for resuming the analysed task, and once for the analysed task itself.
+#   The kernel overhead can be measured with the benchmark tc16 in the kernel
+# configuration of the application.
+#   tic <us>: The system timer tic in microseconds. Only needed if RTOS_TIC is not found.
+#   task <taskFunction> <us> {<name>=<value>}: The worst case execution time of a task
+# per activation in microseconds. The maximum execution time, which is reported by
+# rtos_getTaskTimingStatistics, is a good estimate if the measurement covered all code
+# paths. The optional settings are:
+#     period=<tics>: The period or, for an event triggered task, the minimum time between
+#   two activations in system timer tics. Overrides the period from rtos_setTaskPeriod.
+#     deadline=<tics>: The relative deadline in system timer tics. The default is the
+#   period.
+#     blocking=<us>: The maximum time the task can be blocked by a task of lower priority,
+#   e.g. by a mutex it owns or a critical section. The default is 0.
+#     prio=<class>: The priority class. Overrides the class from the task configuration.
+#
+# Method
+# ======
+#
+# The analysis is the classic response time analysis of fixed priority preemptive
+# scheduling. The response time R of a task is the fixed point of
+#   R = C + B + sum_j(ceil(R/T_j) * (C_j + E + 2*S)) + ceil(R/Tic) * I
+# with execution time C and blocking time B of the task, execution times C_j and periods
+# T_j of all other tasks of same or higher priority class, kernel overhead E of a release,
+# S of a context switch and I of the system timer interrupt. C includes E and S of the
+# task itself. The tasks of the same class are counted as if they had higher priority,
+# which is pessimistic but holds for both, round robin and first come first served. A task
+# meets its deadline if R is not greater than the deadline. The slack is the difference.
+#
+
+
+# Strip a token from white space, comments, casts and enclosing parenthesis.
+function trim(token)
+{
+    gsub(/\/\*[^*]*\*+([^\/*][^*]*\*+)*\//, "", token)
+    gsub(/[ \t\r]/, "", token)
+    sub(/^&/, "", token)
+    while(token ~ /^\(.*\)$/)
+        token = substr(token, 2, length(token)-2)
+    sub(/^\((u?int[0-9]+_t|unsigned|int|float|double)\)/, "", token)
+    sub(/[uUlL]+$/, "", token)
+    return token
+}
+
+
+# Get the numeric value of an argument: A literal or a macro with a literal value. Get the
+# empty string if the value is not known.
+function resolve(token,        noSteps)
+{
+    token = trim(token)
+    for(noSteps=0; noSteps<10  &&  !(token ~ /^[-+]?[0-9.]+([eE][-+]?[0-9]+)?$/); ++noSteps)
+    {
+        if(!(token in defineAry))
+            return ""
+        token = trim(defineAry[token])
+    }
+    return token ~ /^[-+]?[0-9.]+([eE][-+]?[0-9]+)?$/? token + 0: ""
+}
+
+
+# Register a task, which is found in the configuration of the application.
+function addTask(taskFct)
+{
+    if(!(taskFct in isTaskAry))
+    {
+        isTaskAry[taskFct] = 1
+        taskAry[++noTasks] = taskFct
+    }
+}
+
+
+# Evaluate a complete call of a kernel function, which configures a task.
+function evaluateCall(fctName, argList,        noArgs, argAry, taskFct, idxToken)
+{
+    gsub(/\/\*[^*]*\*+([^\/*][^*]*\*+)*\//, "", argList)
+    noArgs = split(argList, argAry, ",")
+    if(fctName == "rtos_initializeTask"  &&  noArgs >= 3)
+    {
+        taskFct = trim(argAry[2])
+        if(taskFct !~ /^[A-Za-z_][A-Za-z0-9_]*$/)
+            return
+        addTask(taskFct)
+        idxToken = trim(argAry[1])
+        taskOfIdxAry[idxToken] = taskFct
+        if(resolve(idxToken) != "")
+            taskOfIdxAry[resolve(idxToken)] = taskFct
+        if(resolve(argAry[3]) != "")
+            prioAry[taskFct] = resolve(argAry[3])
+    }
+    else if(fctName == "rtos_setTaskPeriod"  &&  noArgs >= 2)
+    {
+        idxToken = trim(argAry[1])
+        periodOfIdxAry[idxToken] = resolve(argAry[2])
+    }
+}
+
+
+BEGIN {
+    if(cpuClock == "")
+        cpuClock = 16000000
+    tiTic = ""
+    ticIsr = sendEvent = contextSwitch = 0
+    noTasks = 0
+    fctName = ""
+    isInTaskTable = 0
+}
+
+
+# Configuration and source files: Collect the macros, the task table and the calls of
+# the configuring kernel functions. The calls may span several lines.
+FILENAME ~ /\.(h|c|cpp)$/ {
+    line = $0
+    if(line ~ /^[ \t]*#[ \t]*define[ \t]+[A-Za-z_][A-Za-z0-9_]*[ \t]+[^ \t]/)
+    {
+        name = line
+        sub(/^[ \t]*#[ \t]*define[ \t]+/, "", name)
+        value = name
+        sub(/[ \t].*$/, "", name)
+        sub(/^[A-Za-z_][A-Za-z0-9_]*[ \t]+/, "", value)
+        sub(/[ \t]*(\/\*.*|\/\/.*)?[ \t\r]*$/, "", value)
+        if(name == "RTOS_TASK_TABLE")
+            isInTaskTable = 1
+        else
+            defineAry[name] = value
+    }
+    else if(line ~ /^[ \t]*#[ \t]*define[ \t]+RTOS_TASK_TABLE\(/)
+        isInTaskTable = 1
+
+    # The rows of the task table: entry(taskFunction, prioClass, ...)
+    if(isInTaskTable)
+    {
+        rest = line
+        while(match(rest, /entry[ \t]*\([^)]*\)/))
+        {
+            row = substr(rest, RSTART, RLENGTH)
+            rest = substr(rest, RSTART+RLENGTH)
+            sub(/^entry[ \t]*\(/, "", row)
+            sub(/\)$/, "", row)
+            split(row, argAry, ",")
+            taskFct = trim(argAry[1])
+            addTask(taskFct)
+            if(resolve(argAry[2]) != "")
+                prioAry[taskFct] = resolve(argAry[2])
+            taskOfIdxAry["rtos_idxTask_" taskFct] = taskFct
+        }
+        if(line !~ /\\[ \t\r]*$/)
+            isInTaskTable = 0
+        next
+    }
+
+    if(fctName == "")
+    {
+        if(!match(line, /rtos_(initializeTask|setTaskPeriod)[ \t]*(\(|$)/))
+            next
+        fctName = substr(line, RSTART, RLENGTH)
+        sub(/[ \t]*\($/, "", fctName)
+        line = substr(line, RSTART+RLENGTH)
+        argList = ""
+        depth = 1
+    }
+    for(idx=1; idx<=length(line); ++idx)
+    {
+        c = substr(line, idx, 1)
+        if(c == "(")
+            ++ depth
+        else if(c == ")"  &&  --depth == 0)
+        {
+            evaluateCall(fctName, argList substr(line, 1, idx-1))
+            fctName = ""
+            next
+        }
+    }
+    argList = argList " " line
+    next
+}
+
+
+# The timing description.
+FILENAME ~ /\.timing$/ {
+    sub(/#.*$/, "")
+    sub(/\r$/, "")
+    if(NF == 0)
+        next
+    if($1 == "ticIsr"  ||  $1 == "sendEvent"  ||  $1 == "contextSwitch")
+        kernelCyclesAry[$1] = $2 + 0
+    else if($1 == "tic")
+        tiTicTimingFile = $2 + 0
+    else if($1 == "task"  &&  NF >= 3)
+    {
+        addTask($2)
+        execTimeAry[$2] = $3 + 0
+        for(idx=4; idx<=NF; ++idx)
+        {
+            split($idx, pairAry, "=")
+            if(pairAry[1] == "period")
+                periodAry[$2] = pairAry[2] + 0
+            else if(pairAry[1] == "deadline")
+                deadlineAry[$2] = pairAry[2] + 0
+            else if(pairAry[1] == "blocking")
+                blockingAry[$2] = pairAry[2] + 0
+            else if(pairAry[1] == "prio")
+                prioAry[$2] = pairAry[2] + 0
+            else
+                printf("%s:%d: Unknown setting %s\n", FILENAME, FNR, $idx)
+        }
+    }
+    else
+        printf("%s:%d: Line not understood: %s\n", FILENAME, FNR, $0)
+    next
+}
+
+
+END {
+    # The system timer tic from the configuration of the application, which states it in s.
+    if(resolve("RTOS_TIC") != "")
+        tiTic = resolve("RTOS_TIC") * 1e6
+    else if(tiTicTimingFile != "")
+        tiTic = tiTicTimingFile
+    else
+    {
+        print "The system timer tic is neither found as RTOS_TIC nor in the timing description"
+        exit 1
+    }
+
+    # The kernel overhead in microseconds.
+    usPerCycle = 1e6 / cpuClock
+    tiTicIsr = kernelCyclesAry["ticIsr"] * usPerCycle
+    tiSendEvent = kernelCyclesAry["sendEvent"] * usPerCycle
+    tiContextSwitch = kernelCyclesAry["contextSwitch"] * usPerCycle
+
+    # The periods, which are configured by rtos_setTaskPeriod and not overridden in the
+    # timing description.
+    for(idxToken in periodOfIdxAry)
+    {
+        if(idxToken in taskOfIdxAry)
+        {
+            taskFct = taskOfIdxAry[idxToken]
+            if(!(taskFct in periodAry)  &&  periodOfIdxAry[idxToken] != "")
+                periodAry[taskFct] = periodOfIdxAry[idxToken]
+        }
+    }
+
+    printf("Schedulability analysis, all times in us\n")
+    printf("  System timer tic: %.1f, tic ISR: %.1f, release: %.1f, context switch: %.1f\n",
+           tiTic, tiTicIsr, tiSendEvent, tiContextSwitch)
+
+    # Check the completeness of the description and compute the load.
+    isComplete = 1
+    load = tiTicIsr / tiTic
+    for(idxTask=1; idxTask<=noTasks; ++idxTask)
+    {
+        task = taskAry[idxTask]
+        if(!(task in prioAry)  ||  !(task in execTimeAry)  ||  !(task in periodAry))
+        {
+            printf("  Task %s: Missing %s%s%s\n", task,
+                   task in prioAry? "": "priority class ",
+                   task in execTimeAry? "": "execution time ",
+                   task in periodAry? "": "period")
+            isComplete = 0
+            continue
+        }
+        if(!(task in deadlineAry))
+            deadlineAry[task] = periodAry[task]
+        costAry[task] = execTimeAry[task] + tiSendEvent + tiContextSwitch
+        load += (costAry[task] + tiContextSwitch) / (periodAry[task] * tiTic)
+    }
+    if(!isComplete)
+    {
+        print "The analysis requires priority class, execution time and period of all tasks"
+        exit 1
+    }
+    printf("  CPU load: %.1f %%\n", load * 100.0)
+
+    printf("%-24s %5s %9s %9s %9s %9s %9s\n",
+           "Task", "Class", "Period", "Deadline", "Exec.", "Response", "Slack")
+    noMisses = 0
+    for(idxTask=1; idxTask<=noTasks; ++idxTask)
+    {
+        task = taskAry[idxTask]
+        tiDeadline = deadlineAry[task] * tiTic
+        tiBase = costAry[task] + blockingAry[task]
+
+        # Iterate to the fixed point. The iteration is stopped as soon as the deadline is
+        # exceeded; the response time is then unbounded if the load is 100% or more.
+        tiResponse = tiBase
+        for(;;)
+        {
+            tiNext = tiBase + ceil(tiResponse / tiTic) * tiTicIsr
+            for(idxOther=1; idxOther<=noTasks; ++idxOther)
+            {
+                other = taskAry[idxOther]
+                if(other != task  &&  prioAry[other] >= prioAry[task])
+                {
+                    noActivations = ceil(tiResponse / (periodAry[other] * tiTic))
+                    tiNext += noActivations * (costAry[other] + tiContextSwitch)
+                }
+            }
+            if(tiNext <= tiResponse  ||  tiNext > tiDeadline)
+                break
+            tiResponse = tiNext
+        }
+        if(tiNext > tiResponse)
+            tiResponse = tiNext
+
+        isMiss = tiResponse > tiDeadline
+        noMisses += isMiss
+        printf("%-24s %5u %9.0f %9.0f %9.0f %9.0f %9.0f%s\n",
+               task, prioAry[task], periodAry[task] * tiTic, tiDeadline, execTimeAry[task],
+               tiResponse, tiDeadline - tiResponse, isMiss? " deadline missed": "")
+    }
+
+    if(noMisses > 0)
+    {
+        printf("%u task(s) can miss the deadline\n", noMisses)
+        exit 1
+    }
+    else
+        print "All tasks meet their deadlines"
+}
+
+
+# Round a positive number up to the next integer.
+function ceil(x,        i)
+{
+    i = int(x)
+    return i < x? i+1: i
+}
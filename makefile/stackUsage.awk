@@ -0,0 +1,336 @@
+#
+# Static Stack Usage Analysis of the RTuinOS Tasks
+#
+# The script computes the worst case stack consumption of each task of an RTuinOS
+# application. It is run by the makefile target stackUsage, see compileLinkAndUpload.mk.
+#
+# Copyright (C) 2013 Peter Vranken (mailto:Peter_Vranken@Yahoo.de)
+#
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU Lesser General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+# for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Input Files
+# ===========
+#
+# The files are distinguished by their extensions and need to be passed in this order:
+#   *.c, *.cpp: The source files of the application. The task functions are found as
+# second argument of all calls of rtos_initializeTask.
+#   *.su: The stack usage files of the compiler, see option -fstack-usage. They state the
+# size of the stack frame of each compiled function.
+#   *.dis: The disassembly of the linked ELF file, as got from avr-objdump -d -C. It
+# yields the call graph of all functions.
+#
+# Options
+# =======
+#
+# The options are passed as awk variables, -v name=value:
+#   sizeOfPC: The number of bytes of a return address on the stack, 3 for the ATmega2560
+# and 2 for the other controllers.
+#   sizeOfContext: The number of bytes, which are saved by macro PUSH_CONTEXT_ONTO_STACK
+# of the kernel, without the program counter.
+#   noNestedIsrs: The maximum number of interrupts, which can be active at a time on top
+# of a task. It is 1 unless the application enables nested interrupts.
+#
+# Method
+# ======
+#
+# The stack usage of a function is its own frame plus the maximum of the stack usage of
+# all functions it calls, each plus the return address. The calls are the instructions
+# call and rcall of the disassembly. Jumps into other functions are considered tail calls
+# without return address. The stack usage of a task is the stack usage of its task
+# function plus its return address, plus the context frame of the kernel, which is saved
+# when the task is suspended, plus the stack usage of the worst interrupt service routine
+# for each level of interrupt nesting. An interrupt service routine saves the complete
+# context, too.
+#   The result is a lower bound only if the call tree of the task contains indirect calls
+# (function pointers, virtual functions), recursion, functions with dynamically sized
+# stack frames or functions without stack usage information. Frequent examples of the
+# latter are the assembler functions of the GCC runtime library; their stack usage is
+# considered zero. The report names these cases.
+#
+
+
+# Normalize a function name from a stack usage file or the disassembly: The return type,
+# the list of formal parameters, the address offset of a jump target and the suffix of a
+# cloned function are removed.
+function normalizeName(name,        idx)
+{
+    sub(/\+0x[0-9a-fA-F]+$/, "", name)
+    sub(/ \[clone [^]]*\]$/, "", name)
+    sub(/\.(constprop|isra|part|clone)\.[0-9.a-z]*$/, "", name)
+    idx = index(name, "(")
+    if(idx > 0)
+        name = substr(name, 1, idx-1)
+    sub(/^.* /, "", name)
+    return name
+}
+
+
+# Determine the stack usage of a function and all functions it calls. The result of each
+# function is stored in stackUsageAry for reuse.
+function getStackUsage(fct,        noCallees, idx, callee, usage, maxUsage)
+{
+    if(fct in stackUsageAry)
+        return stackUsageAry[fct]
+
+    if(fct in isOnCallStackAry)
+    {
+        # The function calls itself directly or indirectly.
+        isRecursiveAry[fct] = 1
+        return 0
+    }
+    isOnCallStackAry[fct] = 1
+
+    if(!(fct in frameSizeAry))
+        isUnknownAry[fct] = 1
+
+    maxUsage = 0
+    noCallees = noCalleesAry[fct] + 0
+    for(idx=1; idx<=noCallees; ++idx)
+    {
+        callee = calleeAry[fct, idx]
+        usage = getStackUsage(callee) + sizeOfReturnAddrAry[fct, idx]
+        if(usage > maxUsage)
+            maxUsage = usage
+    }
+    delete isOnCallStackAry[fct]
+
+    stackUsageAry[fct] = frameSizeAry[fct] + maxUsage
+    return stackUsageAry[fct]
+}
+
+
+# Collect the names of all functions in the call tree of a function and their
+# properties, which make the computed stack usage a lower bound.
+function collectCallTree(fct,        noCallees, idx)
+{
+    if(fct in isVisitedAry)
+        return
+    isVisitedAry[fct] = 1
+
+    if(fct in isRecursiveAry)
+        noteRecursion = noteRecursion " " fct
+    if(fct in isDynamicAry)
+        noteDynamic = noteDynamic " " fct
+    if(fct in hasIndirectCallAry)
+        noteIndirect = noteIndirect " " fct
+    if(fct in isUnknownAry)
+        noteUnknown = noteUnknown " " fct
+
+    noCallees = noCalleesAry[fct] + 0
+    for(idx=1; idx<=noCallees; ++idx)
+        collectCallTree(calleeAry[fct, idx])
+}
+
+
+# Add a call from one function to another one to the call graph. Repeated calls are
+# stored only once.
+function addCall(caller, callee, sizeOfReturnAddr,        idx)
+{
+    if((caller, callee) in idxCallAry)
+    {
+        idx = idxCallAry[caller, callee]
+        if(sizeOfReturnAddr > sizeOfReturnAddrAry[caller, idx])
+            sizeOfReturnAddrAry[caller, idx] = sizeOfReturnAddr
+    }
+    else
+    {
+        idx = ++ noCalleesAry[caller]
+        idxCallAry[caller, callee] = idx
+        calleeAry[caller, idx] = callee
+        sizeOfReturnAddrAry[caller, idx] = sizeOfReturnAddr
+    }
+}
+
+
+BEGIN {
+    if(sizeOfPC == "")
+        sizeOfPC = 3
+    if(sizeOfContext == "")
+        sizeOfContext = 33
+    if(noNestedIsrs == "")
+        noNestedIsrs = 1
+
+    noTasks = 0
+    isInInitCall = 0
+}
+
+
+# Source files: Find the task functions in the calls of rtos_initializeTask. The call
+# may span several lines.
+FILENAME ~ /\.(c|cpp)$/ {
+    line = $0
+    if(!isInInitCall)
+    {
+        idx = index(line, "rtos_initializeTask")
+        if(idx == 0)
+            next
+        line = substr(line, idx + length("rtos_initializeTask"))
+        if(line !~ /^[ \t\r]*(\(|$)/  ||  line ~ /^[ \t\r]*\([ \t\r]*\)/)
+            next
+        isInInitCall = 1
+        argList = ""
+    }
+    argList = argList " " line
+    gsub(/\/\*[^*]*\*+([^\/*][^*]*\*+)*\//, "", argList)
+    if(split(argList, argAry, ",") >= 3)
+    {
+        isInInitCall = 0
+        taskFct = argAry[2]
+        gsub(/[ \t\r&]/, "", taskFct)
+        if(taskFct ~ /^[A-Za-z_][A-Za-z0-9_]*$/  &&  !(taskFct in isTaskAry))
+        {
+            isTaskAry[taskFct] = 1
+            taskAry[++noTasks] = taskFct
+        }
+    }
+    next
+}
+
+
+# Stack usage files: A line has the form <file>:<line>:<column>:<function><TAB><size><TAB>
+# <qualifier>. The qualifier is one out of static, dynamic or dynamic,bounded.
+FILENAME ~ /\.su$/ {
+    noFields = split($0, fieldAry, "\t")
+    if(noFields < 3)
+        next
+    fct = fieldAry[1]
+    sub(/^([A-Za-z]:)?[^:]*:[0-9]+:[0-9]+:/, "", fct)
+    fct = normalizeName(fct)
+    size = fieldAry[2] + 0
+
+    # Functions of same name, e.g. static functions of different modules or overloaded
+    # functions, can't be distinguished. The worst one is taken.
+    if(!(fct in frameSizeAry)  ||  size > frameSizeAry[fct])
+        frameSizeAry[fct] = size
+    if(fieldAry[3] ~ /dynamic/  &&  fieldAry[3] !~ /bounded/)
+        isDynamicAry[fct] = 1
+    next
+}
+
+
+# Disassembly: A function starts with a line <address> <<function>>:. The instructions
+# have the form <address>:<TAB><opcode><TAB><mnemonic><TAB><operands><TAB>; <target>.
+FILENAME ~ /\.dis$/ {
+    if($0 ~ /^[0-9a-fA-F]+ <.*>:[ \t\r]*$/)
+    {
+        fct = $0
+        sub(/^[0-9a-fA-F]+ </, "", fct)
+        sub(/>:[ \t\r]*$/, "", fct)
+        fct = normalizeName(fct)
+        if(fct ~ /^__vector_[0-9]+$/)
+            isIsrAry[fct] = 1
+        next
+    }
+    if(fct == "")
+        next
+
+    noFields = split($0, fieldAry, "\t")
+    if(noFields < 3)
+        next
+    mnemonic = fieldAry[3]
+    gsub(/[ \r]/, "", mnemonic)
+    if(mnemonic == "icall"  ||  mnemonic == "eicall")
+    {
+        hasIndirectCallAry[fct] = 1
+        next
+    }
+    if(mnemonic != "call"  &&  mnemonic != "rcall"  &&  mnemonic != "jmp"  &&  mnemonic != "rjmp")
+        next
+
+    # The target function is named in the comment of the instruction.
+    idx = index($0, "; 0x")
+    if(idx == 0)
+        next
+    target = substr($0, idx)
+    idx = index(target, "<")
+    if(idx == 0)
+        next
+    target = substr(target, idx+1)
+    sub(/>[ \t\r]*$/, "", target)
+    target = normalizeName(target)
+
+    # Jumps inside the function are no calls. A call of the next instruction (rcall .+0)
+    # is a trick of the compiler to allocate stack space, which is already contained in the
+    # frame size.
+    if(target == fct)
+        next
+
+    addCall(fct, target, mnemonic ~ /call/? sizeOfPC: 0)
+    next
+}
+
+
+END {
+    # The worst interrupt service routine. The ISRs of the RTuinOS kernel are naked, they
+    # save the context by inline assembler code, which is not stated in the stack usage
+    # files. The context is added to all of them as a conservative estimate.
+    maxUsageIsr = 0
+    worstIsr = ""
+    for(isr in isIsrAry)
+    {
+        usage = getStackUsage(isr)
+        if(worstIsr == ""  ||  usage > maxUsageIsr)
+        {
+            maxUsageIsr = usage
+            worstIsr = isr
+        }
+    }
+    sizeOfIsrFrame = sizeOfPC + sizeOfContext + maxUsageIsr
+
+    if(noTasks == 0)
+    {
+        print "No task functions found in the calls of rtos_initializeTask"
+        exit 1
+    }
+
+    print "Worst case stack usage of the tasks (all numbers in Byte):"
+    print "  Context frame of the kernel: " sizeOfContext
+    if(worstIsr != "")
+    {
+        print "  Worst interrupt service routine: " worstIsr ", " sizeOfIsrFrame             \
+              " including return address and context"
+    }
+    print "  Levels of interrupt nesting: " noNestedIsrs
+
+    for(idxTask=1; idxTask<=noTasks; ++idxTask)
+    {
+        task = taskAry[idxTask]
+        if(!(task in frameSizeAry)  &&  (noCalleesAry[task] + 0) == 0)
+        {
+            print "Task " task ": Function not found in the stack usage files"
+            continue
+        }
+
+        usageTask = getStackUsage(task)
+        total = sizeOfPC + usageTask + sizeOfContext + noNestedIsrs * sizeOfIsrFrame
+        print "Task " task ": " total " (call tree " usageTask ", return address "            \
+              sizeOfPC ", context " sizeOfContext ", interrupts "                           \
+              noNestedIsrs * sizeOfIsrFrame ")"
+
+        # Report all findings, which make the result a lower bound only.
+        split("", isVisitedAry)
+        noteRecursion = noteIndirect = noteDynamic = noteUnknown = ""
+        collectCallTree(task)
+        if(worstIsr != "")
+            collectCallTree(worstIsr)
+        if(noteRecursion != "")
+            print "  Lower bound only, recursion in:" noteRecursion
+        if(noteIndirect != "")
+            print "  Lower bound only, indirect calls in:" noteIndirect
+        if(noteDynamic != "")
+            print "  Lower bound only, dynamic stack frame in:" noteDynamic
+        if(noteUnknown != "")
+            print "  No stack usage information, considered zero:" noteUnknown
+    }
+}